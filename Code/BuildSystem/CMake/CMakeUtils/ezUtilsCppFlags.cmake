@@ -262,6 +262,11 @@ function(ez_set_build_flags_gcc TARGET_NAME)
 	# Disable warning: multi-character character constant
 	target_compile_options(${TARGET_NAME} PRIVATE -Wno-multichar)
 
+	# Enables C++20 coroutines in C++17 mode (see ezTaskCoroutine)
+	if(CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL 10)
+		target_compile_options(${TARGET_NAME} PRIVATE $<$<COMPILE_LANGUAGE:CXX>:-fcoroutines>)
+	endif()
+
 	if(NOT(CMAKE_CURRENT_SOURCE_DIR MATCHES "Code/ThirdParty"))
 		# Warning / Error settings for ez code
 		# attributes = error if a attribute is placed incorrectly (e.g. EZ_FOUNDATION_DLL)
@@ -17,6 +17,7 @@
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Time/Timestamp.h>
+#include <Foundation/Utilities/Metrics.h>
 #include <Texture/Image/Image.h>
 
 ezGameApplicationBase* ezGameApplicationBase::s_pGameApplicationBaseInstance = nullptr;
@@ -546,6 +547,15 @@ void ezGameApplicationBase::UpdateFrameTime()
   static ezTime tLast = tNow;
   m_FrameTime = tNow - tLast;
   tLast = tNow;
+
+  static const double s_FrameTimeBucketsMS[] = {4.0, 8.0, 11.1, 16.7, 20.0, 25.0, 33.3, 50.0, 66.7, 100.0, 250.0};
+  static const ezMetricHistogram s_FrameTimeMetric = ezMetrics::RegisterHistogram("App/FrameTime[ms]", s_FrameTimeBucketsMS);
+
+  // the very first frame has no predecessor
+  if (m_FrameTime.IsPositive())
+  {
+    s_FrameTimeMetric.AddSample(m_FrameTime.GetMilliseconds());
+  }
 }
 
 EZ_STATICLINK_FILE(Core, Core_GameApplication_Implementation_GameApplicationBase);
@@ -57,10 +57,12 @@ EZ_END_SUBSYSTEM_DECLARATION;
 
 ezResourceTypeLoader* ezResourceManager::GetResourceTypeLoader(const ezRTTI* pRTTI)
 {
-  return s_pState->m_ResourceTypeLoader[pRTTI];
+  // must not insert anything, this is called by the loading tasks without holding the resource mutex
+  // and inserting into the b-tree moves entries, which would break concurrent lookups
+  return s_pState->m_ResourceTypeLoader.GetValueOrDefault(pRTTI, nullptr);
 }
 
-ezMap<const ezRTTI*, ezResourceTypeLoader*>& ezResourceManager::GetResourceTypeLoaders()
+ezBTreeMap<const ezRTTI*, ezResourceTypeLoader*>& ezResourceManager::GetResourceTypeLoaders()
 {
   return s_pState->m_ResourceTypeLoader;
 }
@@ -109,7 +111,7 @@ void ezResourceManager::ExecuteAllResourceCleanupCallbacks()
   EZ_ASSERT_DEV(s_pState->m_ResourceCleanupCallbacks.IsEmpty(), "During resource cleanup, new resource cleanup callbacks were registered.");
 }
 
-ezMap<const ezRTTI*, ezResourcePriority>& ezResourceManager::GetResourceTypePriorities()
+ezBTreeMap<const ezRTTI*, ezResourcePriority>& ezResourceManager::GetResourceTypePriorities()
 {
   return s_pState->m_ResourceTypePriorities;
 }
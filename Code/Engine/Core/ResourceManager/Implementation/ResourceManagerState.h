@@ -30,7 +30,7 @@ private:
   /// \name Resource Priorities
   ///@{
 
-  ezMap<const ezRTTI*, ezResourcePriority> m_ResourceTypePriorities;
+  ezBTreeMap<const ezRTTI*, ezResourcePriority> m_ResourceTypePriorities;
 
   ///@}
 
@@ -72,7 +72,7 @@ private:
 
   // Type Loaders
 
-  ezMap<const ezRTTI*, ezResourceTypeLoader*> m_ResourceTypeLoader;
+  ezBTreeMap<const ezRTTI*, ezResourceTypeLoader*> m_ResourceTypeLoader;
   ezResourceLoaderFromFile m_FileResourceLoader;
   ezResourceTypeLoader* m_pDefaultResourceLoader = &m_FileResourceLoader;
   ezMap<ezResource*, ezUniquePtr<ezResourceTypeLoader>> m_CustomLoaders;
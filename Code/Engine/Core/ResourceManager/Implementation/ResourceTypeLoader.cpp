@@ -8,10 +8,57 @@
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Profiling/Profiling.h>
 
+/// \brief Reads the header that ezResourceLoaderFromFile writes in front of the file content, followed by the memory of a mapped file.
+class FileResourceMappedReader : public ezStreamReader
+{
+public:
+  virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override
+  {
+    const ezUInt64 uiHeaderSize = m_Header.GetCount();
+    const ezUInt64 uiTotalSize = uiHeaderSize + m_Content.GetCount();
+    uiBytesToRead = ezMath::Min(uiBytesToRead, uiTotalSize - m_uiReadPosition);
+
+    ezUInt8* pBuffer = static_cast<ezUInt8*>(pReadBuffer);
+    ezUInt64 uiBytesRead = 0;
+
+    if (m_uiReadPosition < uiHeaderSize)
+    {
+      uiBytesRead = ezMath::Min(uiBytesToRead, uiHeaderSize - m_uiReadPosition);
+      ezMemoryUtils::Copy(pBuffer, m_Header.GetPtr() + m_uiReadPosition, static_cast<size_t>(uiBytesRead));
+    }
+
+    if (uiBytesRead < uiBytesToRead)
+    {
+      const ezUInt64 uiContentOffset = m_uiReadPosition + uiBytesRead - uiHeaderSize;
+      ezMemoryUtils::Copy(pBuffer + uiBytesRead, m_Content.GetPtr() + uiContentOffset, static_cast<size_t>(uiBytesToRead - uiBytesRead));
+    }
+
+    m_uiReadPosition += uiBytesToRead;
+    return uiBytesToRead;
+  }
+
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override
+  {
+    uiBytesToSkip = ezMath::Min(uiBytesToSkip, m_Header.GetCount() + m_Content.GetCount() - m_uiReadPosition);
+    m_uiReadPosition += uiBytesToSkip;
+    return uiBytesToSkip;
+  }
+
+  ezArrayPtr<const ezUInt8> m_Header;
+  ezArrayPtr<const ezUInt8> m_Content;
+
+private:
+  ezUInt64 m_uiReadPosition = 0;
+};
+
 struct FileResourceLoadData
 {
   ezBlob m_Storage;
   ezRawMemoryStreamReader m_Reader;
+
+  // stays open while the resource reads from the file content in memory, see ezFileReaderBase::GetMappedData()
+  ezFileReader m_File;
+  FileResourceMappedReader m_MappedReader;
 };
 
 ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pResource)
@@ -20,9 +67,14 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   ezResourceLoadData res;
 
-  ezFileReader File;
+  FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
+
+  ezFileReader& File = pData->m_File;
   if (File.Open(pResource->GetResourceID().GetData()).Failed())
+  {
+    EZ_DEFAULT_DELETE(pData);
     return res;
+  }
 
   res.m_sResourceDescription = File.GetFilePathRelative().GetData();
 
@@ -35,11 +87,12 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
 #endif
 
-  FileResourceLoadData* pData = EZ_DEFAULT_NEW(FileResourceLoadData);
-
   const ezUInt64 uiFileSize = File.GetFileSize();
+  const ezArrayPtr<const ezUInt8> mappedData = File.GetMappedData();
 
-  const ezUInt64 uiBlobCapacity = uiFileSize + File.GetFilePathAbsolute().GetElementCount() + 8; // +8 for the string overhead
+  // if the file content is directly accessible in memory (e.g. in a memory mapped archive), it is not copied into the blob,
+  // instead the file is kept open until the resource has read the data
+  const ezUInt64 uiBlobCapacity = (mappedData.IsEmpty() ? uiFileSize : 0) + File.GetFilePathAbsolute().GetElementCount() + 8; // +8 for the string overhead
   pData->m_Storage.SetCountUninitialized(uiBlobCapacity);
 
   ezUInt8* pBlobPtr = pData->m_Storage.GetBlobPtr<ezUInt8>().GetPtr();
@@ -51,7 +104,19 @@ ezResourceLoadData ezResourceLoaderFromFile::OpenDataStream(const ezResource* pR
 
   const ezUInt64 uiOffset = w.GetNumWrittenBytes();
 
+  if (!mappedData.IsEmpty())
+  {
+    pData->m_MappedReader.m_Header = ezArrayPtr<const ezUInt8>(pBlobPtr, static_cast<ezUInt32>(uiOffset));
+    pData->m_MappedReader.m_Content = mappedData;
+
+    res.m_pDataStream = &pData->m_MappedReader;
+    res.m_pCustomLoaderData = pData;
+
+    return res;
+  }
+
   File.ReadBytes(pBlobPtr + uiOffset, uiFileSize);
+  File.Close();
 
   pData->m_Reader.Reset(pBlobPtr, w.GetNumWrittenBytes() + uiFileSize);
   res.m_pDataStream = &pData->m_Reader;
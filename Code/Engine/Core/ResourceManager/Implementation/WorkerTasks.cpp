@@ -4,6 +4,10 @@
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Metrics.h>
+
+/// How many of the next resources in the loading queue get their files prefetched, while the current resource is loaded.
+static constexpr ezUInt32 s_uiNumResourcesToPrefetch = 8;
 
 ezResourceManagerWorkerDataLoad::ezResourceManagerWorkerDataLoad() = default;
 ezResourceManagerWorkerDataLoad::~ezResourceManagerWorkerDataLoad() = default;
@@ -12,9 +16,14 @@ void ezResourceManagerWorkerDataLoad::Execute()
 {
   EZ_PROFILE_SCOPE("LoadResourceFromDisk");
 
+  static const double s_LoadTimeBucketsMS[] = {1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0, 200.0, 500.0, 1000.0};
+  static const ezMetricHistogram s_LoadTimeMetric = ezMetrics::RegisterHistogram("Resources/DataLoadTime[ms]", s_LoadTimeBucketsMS);
+  static const ezMetricGauge s_LoadingQueueMetric = ezMetrics::RegisterGauge("Resources/LoadingQueueSize");
+
   ezResource* pResourceToLoad = nullptr;
   ezResourceTypeLoader* pLoader = nullptr;
   ezUniquePtr<ezResourceTypeLoader> pCustomLoader;
+  ezHybridArray<ezString, s_uiNumResourcesToPrefetch> filesToPrefetch;
 
   {
     EZ_LOCK(ezResourceManager::s_ResourceMutex);
@@ -31,6 +40,8 @@ void ezResourceManagerWorkerDataLoad::Execute()
     pResourceToLoad = it.m_pResource;
     ezResourceManager::s_pState->m_LoadingQueue.PopFront();
 
+    s_LoadingQueueMetric.Set(ezResourceManager::s_pState->m_LoadingQueue.GetCount());
+
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
       pCustomLoader = std::move(ezResourceManager::s_pState->m_CustomLoaders[pResourceToLoad]);
@@ -38,6 +49,32 @@ void ezResourceManagerWorkerDataLoad::Execute()
       pResourceToLoad->m_Flags.Remove(ezResourceFlags::HasCustomDataLoader);
       pResourceToLoad->m_Flags.Add(ezResourceFlags::PreventFileReload);
     }
+
+    // Resources are loaded one after another, so every load would wait for the disk on its own. Instead the files of the next resources
+    // are read in the background already, which allows the OS to process many reads at once.
+    auto& queue = ezResourceManager::s_pState->m_LoadingQueue;
+    for (ezUInt32 i = 0; i < ezMath::Min(queue.GetCount(), s_uiNumResourcesToPrefetch); ++i)
+    {
+      ezResource* pResource = queue[i].m_pResource;
+
+      if (queue[i].m_bFilePrefetched || pResource->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
+        continue;
+
+      queue[i].m_bFilePrefetched = true;
+
+      // only the file loader opens the file with the resource ID as its path
+      ezResourceTypeLoader* pNextLoader = ezResourceManager::GetResourceTypeLoader(pResource->GetDynamicRTTI());
+      if (pNextLoader == nullptr)
+        pNextLoader = pResource->GetDefaultResourceTypeLoader();
+
+      if (pNextLoader == &ezResourceManager::s_pState->m_FileResourceLoader)
+        filesToPrefetch.PushBack(pResource->GetResourceID());
+    }
+  }
+
+  for (const ezString& sFile : filesToPrefetch)
+  {
+    ezFileSystem::PrefetchFile(sFile);
   }
 
   if (pLoader == nullptr)
@@ -48,7 +85,9 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
   EZ_ASSERT_DEV(pLoader != nullptr, "No Loader function available for Resource Type '{0}'", pResourceToLoad->GetDynamicRTTI()->GetTypeName());
 
+  const ezTime tLoadStart = ezTime::Now();
   ezResourceLoadData LoaderData = pLoader->OpenDataStream(pResourceToLoad);
+  s_LoadTimeMetric.AddSample((ezTime::Now() - tLoadStart).GetMilliseconds());
 
   // we need this info later to do some work in a lock, all the directly following code is outside the lock
   const bool bResourceIsLoadedOnMainThread = pResourceToLoad->GetBaseResourceFlags().IsAnySet(ezResourceFlags::UpdateOnMainThread);
@@ -5,6 +5,7 @@
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Core/ResourceManager/ResourceTypeLoader.h>
 #include <Foundation/Configuration/Plugin.h>
+#include <Foundation/Containers/BTreeMap.h>
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Threading/LockedObject.h>
 #include <Foundation/Types/UniquePtr.h>
@@ -418,7 +419,7 @@ public:
   }
 
 private:
-  static ezMap<const ezRTTI*, ezResourcePriority>& GetResourceTypePriorities();
+  static ezBTreeMap<const ezRTTI*, ezResourcePriority>& GetResourceTypePriorities();
   ///@}
 
   //////////////////////////////////////////////////////////////////////////
@@ -458,6 +459,7 @@ private:
   {
     float m_fPriority = 0;
     ezResource* m_pResource = nullptr;
+    bool m_bFilePrefetched = false; ///< Whether ezFileSystem::PrefetchFile() was already called for the resource file.
 
     EZ_ALWAYS_INLINE bool operator==(const LoadingInfo& rhs) const { return m_pResource == rhs.m_pResource; }
     EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const { return m_fPriority < rhs.m_fPriority; }
@@ -495,9 +497,11 @@ private:
 
   // Type loaders
 private:
+  /// \brief Returns the custom loader for the given type or nullptr. Never modifies the map, so it may be called without the resource mutex.
   static ezResourceTypeLoader* GetResourceTypeLoader(const ezRTTI* pRTTI);
 
-  static ezMap<const ezRTTI*, ezResourceTypeLoader*>& GetResourceTypeLoaders();
+  /// \brief The map must only be modified while holding s_ResourceMutex.
+  static ezBTreeMap<const ezRTTI*, ezResourceTypeLoader*>& GetResourceTypeLoaders();
 
   // Override / derived resources
 private:
@@ -55,6 +55,8 @@ public:
 ///
 /// The loader will interpret the ezResource 'resource ID' as a path, read that full file into a memory stream.
 /// The file modification data is stored as well.
+/// Files that are stored uncompressed in a memory mapped archive are not copied into memory, the stream reads directly from the mapped
+/// file instead (see ezFileReaderBase::GetMappedData()).
 /// Resources that use this loader can update their data as if they were reading the file directly.
 class EZ_CORE_DLL ezResourceLoaderFromFile : public ezResourceTypeLoader
 {
@@ -337,6 +337,37 @@ struct EZ_CORE_DLL ezOnComponentFinishedAction2
 
 EZ_DECLARE_REFLECTABLE_TYPE(EZ_CORE_DLL, ezOnComponentFinishedAction2);
 
+/// \brief Specifies how the global transforms of dynamic objects are updated once per frame.
+///
+/// \sa ezWorldDesc::m_TransformUpdateMode, ezWorld::SetTransformUpdateMode()
+struct ezTransformUpdateMode
+{
+  using StorageType = ezUInt8;
+
+  enum Enum : StorageType
+  {
+    HierarchyLevels, ///< Updates one hierarchy level after the other. The multi-threaded update has to wait for each level to finish before it can start the next one.
+    Subtrees,        ///< Updates each dynamic subtree from its root down to its leaves at once. Independent subtrees are updated in parallel without waiting for other hierarchy levels.
+    ChangedSubtrees, ///< Same as Subtrees, but only recomputes objects that were moved, re-parented or changed their local bounds since the last update, together with everything below them. Unchanged subtrees are skipped entirely.
+
+    Default = HierarchyLevels
+  };
+};
+
+/// \brief Describes which spatial system is created for a world when ezWorldDesc::m_bAutoCreateSpatialSystem is set.
+struct ezSpatialSystemType
+{
+  using StorageType = ezUInt8;
+
+  enum Enum : StorageType
+  {
+    RegularGrid, ///< ezSpatialSystem_RegularGrid, fast for worlds where most objects have a similar size.
+    BVH,         ///< ezSpatialSystem_BVH, better suited for worlds with a large variance in object sizes.
+
+    Default = RegularGrid
+  };
+};
+
 /// \brief Used as return value of visitor functions to define whether calling function should stop or continue visiting.
 struct ezVisitorExecution
 {
@@ -5,6 +5,7 @@
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Containers/SmallArray.h>
 #include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/AtomicUtils.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Types/TagSet.h>
 
@@ -574,8 +575,30 @@ private:
 
 #if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
     ezUInt32 m_uiLastGlobalTransformUpdateCounter = 0;
+#endif
+
+    struct ChangeState
+    {
+      enum Enum : ezUInt8
+      {
+        Unchanged,
+        Changed,                   ///< Needs to be recomputed in the next transform update.
+        RefreshLastGlobalTransform ///< Was changed in the last transform update and needs to be recomputed once more to refresh the last global transform.
+      };
+    };
+
+    /// \brief Whether the local transform, the local bounds or the parent of this object changed.
+    /// Only maintained for dynamic objects, see ezTransformUpdateMode::ChangedSubtrees.
+    /// MarkTransformChanged() accesses it with relaxed atomics, since different threads may mark objects concurrently.
+    ezUInt8 m_uiTransformState;
+
+    /// \brief Whether any object below this one needs to be recomputed. Kept in a separate byte and also accessed atomically by MarkTransformChanged().
+    ezUInt8 m_uiChildrenState;
+
+#if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
+    ezUInt8 m_uiPadding2[14];
 #else
-    ezUInt32 m_uiPadding2[1];
+    ezUInt8 m_uiPadding2[2];
 #endif
 
     /// \brief Recomputes the local transform from this object's global transform and, if available, the parent's global transform.
@@ -603,6 +626,9 @@ private:
 
     void UpdateLastGlobalTransform(ezUInt32 uiUpdateCounter);
 
+    /// \brief Marks this object as changed and tells all its dynamic parents about it, such that it is recomputed with ezTransformUpdateMode::ChangedSubtrees.
+    void MarkTransformChanged();
+
     void RecreateSpatialData(ezSpatialSystem& ref_spatialSystem);
   };
 
@@ -265,6 +265,12 @@ void ezGameObject::UpdateGlobalTransformAndBoundsRecursive()
     m_pTransformationData->UpdateGlobalBounds();
   }
 
+  if (IsDynamic())
+  {
+    // dynamic children of static objects need another update to refresh their last global transform
+    m_pTransformationData->MarkTransformChanged();
+  }
+
   if (IsStatic() && m_Flags.IsSet(ezObjectFlags::StaticTransformChangesNotifications) && oldGlobalTransform != GetGlobalTransformSimd())
   {
     ezMsgTransformChanged msg;
@@ -735,6 +741,10 @@ void ezGameObject::UpdateLocalBounds()
   {
     m_pTransformationData->UpdateGlobalBounds(pSpatialSystem);
   }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
+  }
 }
 
 void ezGameObject::UpdateGlobalTransformAndBounds()
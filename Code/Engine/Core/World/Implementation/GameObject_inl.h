@@ -272,9 +272,16 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalPosition(const ezSimdVec4f& vPositio
 {
   m_pTransformationData->m_localPosition = vPosition;
 
-  if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+  if (IsStatic())
   {
-    UpdateGlobalTransformAndBoundsRecursive();
+    if (updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+    {
+      UpdateGlobalTransformAndBoundsRecursive();
+    }
+  }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
   }
 }
 
@@ -288,9 +295,16 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalRotation(const ezSimdQuat& qRotation
 {
   m_pTransformationData->m_localRotation = qRotation;
 
-  if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+  if (IsStatic())
   {
-    UpdateGlobalTransformAndBoundsRecursive();
+    if (updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+    {
+      UpdateGlobalTransformAndBoundsRecursive();
+    }
+  }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
   }
 }
 
@@ -306,9 +320,16 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalScaling(const ezSimdVec4f& vScaling,
   m_pTransformationData->m_localScaling = vScaling;
   m_pTransformationData->m_localScaling.SetW(uniformScale);
 
-  if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+  if (IsStatic())
   {
-    UpdateGlobalTransformAndBoundsRecursive();
+    if (updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+    {
+      UpdateGlobalTransformAndBoundsRecursive();
+    }
+  }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
   }
 }
 
@@ -322,9 +343,16 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalUniformScaling(const ezSimdFloat& fS
 {
   m_pTransformationData->m_localScaling.SetW(fScaling);
 
-  if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+  if (IsStatic())
   {
-    UpdateGlobalTransformAndBoundsRecursive();
+    if (updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+    {
+      UpdateGlobalTransformAndBoundsRecursive();
+    }
+  }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
   }
 }
 
@@ -352,6 +380,10 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalPosition(const ezSimdVec4f& vPositi
   {
     UpdateGlobalTransformAndBoundsRecursive();
   }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
+  }
 }
 
 EZ_ALWAYS_INLINE const ezSimdVec4f& ezGameObject::GetGlobalPositionSimd() const
@@ -372,6 +404,10 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalRotation(const ezSimdQuat& qRotatio
   {
     UpdateGlobalTransformAndBoundsRecursive();
   }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
+  }
 }
 
 EZ_ALWAYS_INLINE const ezSimdQuat& ezGameObject::GetGlobalRotationSimd() const
@@ -392,6 +428,10 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalScaling(const ezSimdVec4f& vScaling
   {
     UpdateGlobalTransformAndBoundsRecursive();
   }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
+  }
 }
 
 EZ_ALWAYS_INLINE const ezSimdVec4f& ezGameObject::GetGlobalScalingSimd() const
@@ -416,6 +456,10 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalTransform(const ezSimdTransform& tr
   {
     UpdateGlobalTransformAndBoundsRecursive();
   }
+  else
+  {
+    m_pTransformationData->MarkTransformChanged();
+  }
 }
 
 EZ_ALWAYS_INLINE const ezSimdTransform& ezGameObject::GetGlobalTransformSimd() const
@@ -605,3 +649,22 @@ EZ_ALWAYS_INLINE void ezGameObject::TransformationData::UpdateLastGlobalTransfor
   }
 #endif
 }
+
+EZ_FORCE_INLINE void ezGameObject::TransformationData::MarkTransformChanged()
+{
+  // several threads may mark objects at the same time, e.g. from multi-threaded component updates, and then share the same parents
+  // the states are only ever set to 'Changed' while marking, so relaxed accesses are sufficient
+
+  // if an object is already marked, all its parents know about it
+  if (ezAtomicUtils::ReadRelaxed(m_uiTransformState) == ChangeState::Changed)
+    return;
+
+  ezAtomicUtils::SetRelaxed(m_uiTransformState, ChangeState::Changed);
+
+  TransformationData* pParentData = m_pParentData;
+  while (pParentData != nullptr && ezAtomicUtils::ReadRelaxed(pParentData->m_uiChildrenState) != ChangeState::Changed && pParentData->m_pObject->IsDynamic())
+  {
+    ezAtomicUtils::SetRelaxed(pParentData->m_uiChildrenState, ChangeState::Changed);
+    pParentData = pParentData->m_pParentData;
+  }
+}
@@ -0,0 +1,1191 @@
+#include <Core/CorePCH.h>
+
+#include <Core/World/SpatialSystem_BVH.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Time/Stopwatch.h>
+
+ezCVarFloat cvar_SpatialBVHRebuildThreshold("Spatial.BVH.RebuildThreshold", 1.5f, ezCVarFlags::Default, "Factor by which the surface area cost of the BVH may grow through refitting before it is rebuilt");
+
+namespace
+{
+  constexpr ezUInt32 s_uiInsideFlag = 0x80000000; ///< Set on a node index on the traversal stack if the node is known to be fully inside the query shape.
+  constexpr ezUInt32 s_uiNumBins = 16;
+
+  /// \brief Returns a bitmask with one bit set for every lane that is set in the given comparison result.
+  EZ_ALWAYS_INLINE ezUInt32 GetLaneMask(const ezSimdVec4b& v)
+  {
+    const ezSimdVec4f laneBits(1.0f, 2.0f, 4.0f, 8.0f);
+    return static_cast<ezUInt32>(static_cast<float>(ezSimdVec4f::Select(v, laneBits, ezSimdVec4f::MakeZero()).HorizontalSum<4>()));
+  }
+
+  /// \brief Returns half of the surface area of the given extents, which is all that is needed to compare surface area costs.
+  EZ_ALWAYS_INLINE ezSimdVec4f HalfArea(const ezSimdVec4f& dx, const ezSimdVec4f& dy, const ezSimdVec4f& dz)
+  {
+    return ezSimdVec4f::MulAdd(dx, dy, ezSimdVec4f::MulAdd(dy, dz, dz.CompMul(dx)));
+  }
+
+  EZ_ALWAYS_INLINE float HalfArea(const ezSimdBBox& box)
+  {
+    const ezSimdVec4f e = box.m_Max - box.m_Min;
+    return e.CompMul(e.Get<ezSwizzle::YZXW>()).HorizontalSum<3>();
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_BVH::BuildEntry
+{
+  ezSimdBBox m_Box;
+  ezSimdVec4f m_Center;
+  ezUInt32 m_uiDataIndex;
+  ezUInt32 m_uiCategoryBitmask;
+};
+
+struct ezSpatialSystem_BVH::NodeUtils
+{
+  EZ_ALWAYS_INLINE static bool FilterByTags(const ezTagSet& tags, const ezTagSet& includeTags, const ezTagSet& excludeTags)
+  {
+    if (!excludeTags.IsEmpty() && excludeTags.IsAnySet(tags))
+      return true;
+
+    if (!includeTags.IsEmpty() && !includeTags.IsAnySet(tags))
+      return true;
+
+    return false;
+  }
+
+  /// \brief The bounds of all four slots of a node, loaded into SIMD registers.
+  struct Slots
+  {
+    EZ_ALWAYS_INLINE explicit Slots(const Node& node)
+    {
+      m_MinX.Load<4>(node.m_MinX);
+      m_MinY.Load<4>(node.m_MinY);
+      m_MinZ.Load<4>(node.m_MinZ);
+      m_MaxX.Load<4>(node.m_MaxX);
+      m_MaxY.Load<4>(node.m_MaxY);
+      m_MaxZ.Load<4>(node.m_MaxZ);
+    }
+
+    ezSimdVec4f m_MinX;
+    ezSimdVec4f m_MinY;
+    ezSimdVec4f m_MinZ;
+    ezSimdVec4f m_MaxX;
+    ezSimdVec4f m_MaxY;
+    ezSimdVec4f m_MaxZ;
+  };
+
+  struct FrustumData
+  {
+    explicit FrustumData(const ezFrustum& frustum)
+    {
+      ezSimdVec4f planes[ezFrustum::PLANE_COUNT];
+      for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+      {
+        planes[i] = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(i).m_vNormal.x)));
+
+        m_PlaneX[i] = planes[i].Get<ezSwizzle::XXXX>();
+        m_PlaneY[i] = planes[i].Get<ezSwizzle::YYYY>();
+        m_PlaneZ[i] = planes[i].Get<ezSwizzle::ZZZZ>();
+        m_PlaneW[i] = planes[i].Get<ezSwizzle::WWWW>();
+
+        m_AbsPlaneX[i] = m_PlaneX[i].Abs();
+        m_AbsPlaneY[i] = m_PlaneY[i].Abs();
+        m_AbsPlaneZ[i] = m_PlaneZ[i].Abs();
+      }
+
+      ezSimdMat4f helperMat;
+      helperMat.SetRows(planes[0], planes[1], planes[2], planes[3]);
+
+      m_x0x1x2x3 = helperMat.m_col0;
+      m_y0y1y2y3 = helperMat.m_col1;
+      m_z0z1z2z3 = helperMat.m_col2;
+      m_w0w1w2w3 = helperMat.m_col3;
+
+      helperMat.SetRows(planes[4], planes[5], planes[4], planes[5]);
+
+      m_x4x5x4x5 = helperMat.m_col0;
+      m_y4y5y4y5 = helperMat.m_col1;
+      m_z4z5z4z5 = helperMat.m_col2;
+      m_w4w5w4w5 = helperMat.m_col3;
+    }
+
+    // Every plane splatted into all lanes, to test the four slots of a node at once
+    ezSimdVec4f m_PlaneX[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_PlaneY[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_PlaneZ[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_PlaneW[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_AbsPlaneX[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_AbsPlaneY[ezFrustum::PLANE_COUNT];
+    ezSimdVec4f m_AbsPlaneZ[ezFrustum::PLANE_COUNT];
+
+    // The planes in structure-of-arrays layout, to test a single sphere against all planes at once
+    ezSimdVec4f m_x0x1x2x3;
+    ezSimdVec4f m_y0y1y2y3;
+    ezSimdVec4f m_z0z1z2z3;
+    ezSimdVec4f m_w0w1w2w3;
+
+    ezSimdVec4f m_x4x5x4x5;
+    ezSimdVec4f m_y4y5y4y5;
+    ezSimdVec4f m_z4z5z4z5;
+    ezSimdVec4f m_w4w5w4w5;
+  };
+
+  EZ_ALWAYS_INLINE static ezUInt32 GetCategoryLaneMask(const Node& node, const ezSimdVec4i& queryCategoryBitmask)
+  {
+    ezSimdVec4i categoryBitmasks;
+    categoryBitmasks.Load<4>(reinterpret_cast<const ezInt32*>(node.m_CategoryBitmasks));
+
+    return GetLaneMask((categoryBitmasks & queryCategoryBitmask) != ezSimdVec4i::MakeZero());
+  }
+
+  EZ_ALWAYS_INLINE static ezUInt32 OverlapsBox(const Slots& slots, const ezSimdBBox& box)
+  {
+    const ezSimdVec4b overlapsX = (slots.m_MinX <= ezSimdVec4f(box.m_Max.x())) && (slots.m_MaxX >= ezSimdVec4f(box.m_Min.x()));
+    const ezSimdVec4b overlapsY = (slots.m_MinY <= ezSimdVec4f(box.m_Max.y())) && (slots.m_MaxY >= ezSimdVec4f(box.m_Min.y()));
+    const ezSimdVec4b overlapsZ = (slots.m_MinZ <= ezSimdVec4f(box.m_Max.z())) && (slots.m_MaxZ >= ezSimdVec4f(box.m_Min.z()));
+
+    return GetLaneMask(overlapsX && overlapsY && overlapsZ);
+  }
+
+  EZ_ALWAYS_INLINE static ezUInt32 OverlapsSphere(const Slots& slots, const ezSimdBSphere& sphere)
+  {
+    const ezSimdVec4f centerX(sphere.m_CenterAndRadius.x());
+    const ezSimdVec4f centerY(sphere.m_CenterAndRadius.y());
+    const ezSimdVec4f centerZ(sphere.m_CenterAndRadius.z());
+    const ezSimdVec4f radius(sphere.m_CenterAndRadius.w());
+
+    // distance from the sphere center to the closest point in each box
+    const ezSimdVec4f dx = centerX.CompMax(slots.m_MinX).CompMin(slots.m_MaxX) - centerX;
+    const ezSimdVec4f dy = centerY.CompMax(slots.m_MinY).CompMin(slots.m_MaxY) - centerY;
+    const ezSimdVec4f dz = centerZ.CompMax(slots.m_MinZ).CompMin(slots.m_MaxZ) - centerZ;
+
+    const ezSimdVec4f distSquared = ezSimdVec4f::MulAdd(dx, dx, ezSimdVec4f::MulAdd(dy, dy, dz.CompMul(dz)));
+    return GetLaneMask(distSquared <= radius.CompMul(radius));
+  }
+
+  /// \brief Returns the slots that are not completely outside the frustum. Slots that are completely inside are returned in out_uiInsideMask.
+  EZ_FORCE_INLINE static ezUInt32 OverlapsFrustum(const Slots& slots, const FrustumData& frustumData, ezUInt32& out_uiInsideMask)
+  {
+    const ezSimdVec4f half(0.5f);
+    const ezSimdVec4f centerX = (slots.m_MinX + slots.m_MaxX).CompMul(half);
+    const ezSimdVec4f centerY = (slots.m_MinY + slots.m_MaxY).CompMul(half);
+    const ezSimdVec4f centerZ = (slots.m_MinZ + slots.m_MaxZ).CompMul(half);
+    const ezSimdVec4f extentsX = (slots.m_MaxX - slots.m_MinX).CompMul(half);
+    const ezSimdVec4f extentsY = (slots.m_MaxY - slots.m_MinY).CompMul(half);
+    const ezSimdVec4f extentsZ = (slots.m_MaxZ - slots.m_MinZ).CompMul(half);
+
+    ezSimdVec4b outside(false);
+    ezSimdVec4b intersecting(false);
+
+    for (ezUInt32 i = 0; i < ezFrustum::PLANE_COUNT; ++i)
+    {
+      ezSimdVec4f dist = ezSimdVec4f::MulAdd(centerX, frustumData.m_PlaneX[i], frustumData.m_PlaneW[i]);
+      dist = ezSimdVec4f::MulAdd(centerY, frustumData.m_PlaneY[i], dist);
+      dist = ezSimdVec4f::MulAdd(centerZ, frustumData.m_PlaneZ[i], dist);
+
+      ezSimdVec4f projectedExtents = extentsX.CompMul(frustumData.m_AbsPlaneX[i]);
+      projectedExtents = ezSimdVec4f::MulAdd(extentsY, frustumData.m_AbsPlaneY[i], projectedExtents);
+      projectedExtents = ezSimdVec4f::MulAdd(extentsZ, frustumData.m_AbsPlaneZ[i], projectedExtents);
+
+      outside = outside || (dist > projectedExtents);
+      intersecting = intersecting || (dist > -projectedExtents);
+    }
+
+    out_uiInsideMask = GetLaneMask(!intersecting);
+    return GetLaneMask(!outside);
+  }
+
+  /// \brief Same test as ezSpatialSystem_RegularGrid uses for objects, so both systems agree on the visibility of the objects themselves.
+  EZ_FORCE_INLINE static bool SphereFrustumIntersect(const ezSimdBSphere& sphere, const FrustumData& frustumData)
+  {
+    ezSimdVec4f pos_xxxx(sphere.m_CenterAndRadius.x());
+    ezSimdVec4f pos_yyyy(sphere.m_CenterAndRadius.y());
+    ezSimdVec4f pos_zzzz(sphere.m_CenterAndRadius.z());
+    ezSimdVec4f pos_rrrr(sphere.m_CenterAndRadius.w());
+
+    ezSimdVec4f dot_0123;
+    dot_0123 = ezSimdVec4f::MulAdd(pos_xxxx, frustumData.m_x0x1x2x3, frustumData.m_w0w1w2w3);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_yyyy, frustumData.m_y0y1y2y3, dot_0123);
+    dot_0123 = ezSimdVec4f::MulAdd(pos_zzzz, frustumData.m_z0z1z2z3, dot_0123);
+
+    ezSimdVec4f dot_4545;
+    dot_4545 = ezSimdVec4f::MulAdd(pos_xxxx, frustumData.m_x4x5x4x5, frustumData.m_w4w5w4w5);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_yyyy, frustumData.m_y4y5y4y5, dot_4545);
+    dot_4545 = ezSimdVec4f::MulAdd(pos_zzzz, frustumData.m_z4z5z4z5, dot_4545);
+
+    ezSimdVec4b cmp_0123 = dot_0123 > pos_rrrr;
+    ezSimdVec4b cmp_4545 = dot_4545 > pos_rrrr;
+    return (cmp_0123 || cmp_4545).NoneSet<4>();
+  }
+
+  /// \brief Returns the slot whose bounds grow the least when the given box is added to it. Ties are broken by uiFirstSlot.
+  static ezUInt32 FindCheapestSlot(const Node& node, const ezSimdBBox& box, ezUInt32 uiFirstSlot)
+  {
+    const Slots slots(node);
+
+    const ezSimdVec4f newMinX = slots.m_MinX.CompMin(ezSimdVec4f(box.m_Min.x()));
+    const ezSimdVec4f newMinY = slots.m_MinY.CompMin(ezSimdVec4f(box.m_Min.y()));
+    const ezSimdVec4f newMinZ = slots.m_MinZ.CompMin(ezSimdVec4f(box.m_Min.z()));
+    const ezSimdVec4f newMaxX = slots.m_MaxX.CompMax(ezSimdVec4f(box.m_Max.x()));
+    const ezSimdVec4f newMaxY = slots.m_MaxY.CompMax(ezSimdVec4f(box.m_Max.y()));
+    const ezSimdVec4f newMaxZ = slots.m_MaxZ.CompMax(ezSimdVec4f(box.m_Max.z()));
+
+    const ezSimdVec4f oldArea = HalfArea(slots.m_MaxX - slots.m_MinX, slots.m_MaxY - slots.m_MinY, slots.m_MaxZ - slots.m_MinZ);
+    const ezSimdVec4f newArea = HalfArea(newMaxX - newMinX, newMaxY - newMinY, newMaxZ - newMinZ);
+
+    float fIncrease[NUM_SLOTS];
+    (newArea - oldArea).Store<4>(fIncrease);
+
+    ezUInt32 uiBestSlot = uiFirstSlot % NUM_SLOTS;
+    for (ezUInt32 i = 1; i < NUM_SLOTS; ++i)
+    {
+      const ezUInt32 uiSlot = (uiFirstSlot + i) % NUM_SLOTS;
+      if (fIncrease[uiSlot] < fIncrease[uiBestSlot])
+      {
+        uiBestSlot = uiSlot;
+      }
+    }
+
+    return uiBestSlot;
+  }
+
+  /// \brief Computes the union of the bounds and category bitmasks of all slots of the given node.
+  EZ_FORCE_INLINE static void ComputeBounds(const Node& node, ezSimdBBox& out_box, ezUInt32& out_uiCategoryBitmask)
+  {
+    const Slots slots(node);
+
+    out_box.m_Min = ezSimdVec4f(slots.m_MinX.HorizontalMin<4>(), slots.m_MinY.HorizontalMin<4>(), slots.m_MinZ.HorizontalMin<4>());
+    out_box.m_Max = ezSimdVec4f(slots.m_MaxX.HorizontalMax<4>(), slots.m_MaxY.HorizontalMax<4>(), slots.m_MaxZ.HorizontalMax<4>());
+
+    out_uiCategoryBitmask = node.m_CategoryBitmasks[0] | node.m_CategoryBitmasks[1] | node.m_CategoryBitmasks[2] | node.m_CategoryBitmasks[3];
+  }
+
+  EZ_ALWAYS_INLINE static ezSimdBBox GetSlotBox(const Node& node, ezUInt32 uiSlot)
+  {
+    return ezSimdBBox(ezSimdVec4f(node.m_MinX[uiSlot], node.m_MinY[uiSlot], node.m_MinZ[uiSlot]), ezSimdVec4f(node.m_MaxX[uiSlot], node.m_MaxY[uiSlot], node.m_MaxZ[uiSlot]));
+  }
+
+  EZ_ALWAYS_INLINE static void SetSlotBox(Node& ref_node, ezUInt32 uiSlot, const ezSimdBBox& box)
+  {
+    ref_node.m_MinX[uiSlot] = box.m_Min.x();
+    ref_node.m_MinY[uiSlot] = box.m_Min.y();
+    ref_node.m_MinZ[uiSlot] = box.m_Min.z();
+    ref_node.m_MaxX[uiSlot] = box.m_Max.x();
+    ref_node.m_MaxY[uiSlot] = box.m_Max.y();
+    ref_node.m_MaxZ[uiSlot] = box.m_Max.z();
+  }
+
+  EZ_ALWAYS_INLINE static bool IsSlotEqual(const Node& node, ezUInt32 uiSlot, const ezSimdBBox& box, ezUInt32 uiCategoryBitmask)
+  {
+    return node.m_CategoryBitmasks[uiSlot] == uiCategoryBitmask &&
+           node.m_MinX[uiSlot] == box.m_Min.x() && node.m_MinY[uiSlot] == box.m_Min.y() && node.m_MinZ[uiSlot] == box.m_Min.z() &&
+           node.m_MaxX[uiSlot] == box.m_Max.x() && node.m_MaxY[uiSlot] == box.m_Max.y() && node.m_MaxZ[uiSlot] == box.m_Max.z();
+  }
+
+  EZ_ALWAYS_INLINE static void ClearSlot(Node& ref_node, ezUInt32 uiSlot)
+  {
+    const float fHigh = ezMath::HighValue<float>();
+
+    ref_node.m_MinX[uiSlot] = fHigh;
+    ref_node.m_MinY[uiSlot] = fHigh;
+    ref_node.m_MinZ[uiSlot] = fHigh;
+    ref_node.m_MaxX[uiSlot] = -fHigh;
+    ref_node.m_MaxY[uiSlot] = -fHigh;
+    ref_node.m_MaxZ[uiSlot] = -fHigh;
+    ref_node.m_CategoryBitmasks[uiSlot] = 0;
+    ref_node.m_Children[uiSlot] = ezInvalidIndex;
+  }
+
+  /// \brief Returns the index at which the entries have been partitioned into two halves with a low surface area cost.
+  static ezUInt32 SplitEntries(ezArrayPtr<BuildEntry> entries)
+  {
+    const ezUInt32 uiNumEntries = entries.GetCount();
+
+    ezSimdBBox centerBounds = ezSimdBBox::MakeInvalid();
+    for (const BuildEntry& entry : entries)
+    {
+      centerBounds.ExpandToInclude(entry.m_Center);
+    }
+
+    float fMin[4];
+    float fExtents[4];
+    centerBounds.m_Min.Store<4>(fMin);
+    (centerBounds.m_Max - centerBounds.m_Min).Store<4>(fExtents);
+
+    ezUInt32 uiAxis = 0;
+    if (fExtents[1] > fExtents[uiAxis])
+      uiAxis = 1;
+    if (fExtents[2] > fExtents[uiAxis])
+      uiAxis = 2;
+
+    // All centers are at the same position, any split is as good as another one
+    if (fExtents[uiAxis] <= 0.0f)
+      return uiNumEntries / 2;
+
+    const float fAxisMin = fMin[uiAxis];
+    const float fBinScale = s_uiNumBins / fExtents[uiAxis];
+
+    auto getBin = [&](const BuildEntry& entry)
+    {
+      float fCenter[4];
+      entry.m_Center.Store<4>(fCenter);
+      return ezMath::Min(static_cast<ezUInt32>((fCenter[uiAxis] - fAxisMin) * fBinScale), s_uiNumBins - 1);
+    };
+
+    ezSimdBBox binBounds[s_uiNumBins];
+    ezUInt32 binCounts[s_uiNumBins] = {};
+    for (ezUInt32 i = 0; i < s_uiNumBins; ++i)
+    {
+      binBounds[i] = ezSimdBBox::MakeInvalid();
+    }
+
+    for (const BuildEntry& entry : entries)
+    {
+      const ezUInt32 uiBin = getBin(entry);
+      binBounds[uiBin].ExpandToInclude(entry.m_Box);
+      ++binCounts[uiBin];
+    }
+
+    // Surface area cost of everything to the right of each split position
+    float fRightCosts[s_uiNumBins];
+    {
+      ezSimdBBox rightBounds = ezSimdBBox::MakeInvalid();
+      ezUInt32 uiRightCount = 0;
+      for (ezUInt32 i = s_uiNumBins - 1; i > 0; --i)
+      {
+        rightBounds.ExpandToInclude(binBounds[i]);
+        uiRightCount += binCounts[i];
+        fRightCosts[i] = uiRightCount > 0 ? HalfArea(rightBounds) * uiRightCount : 0.0f;
+      }
+    }
+
+    ezUInt32 uiBestSplitBin = ezInvalidIndex;
+    float fBestCost = ezMath::MaxValue<float>();
+    {
+      ezSimdBBox leftBounds = ezSimdBBox::MakeInvalid();
+      ezUInt32 uiLeftCount = 0;
+      for (ezUInt32 i = 0; i < s_uiNumBins - 1; ++i)
+      {
+        leftBounds.ExpandToInclude(binBounds[i]);
+        uiLeftCount += binCounts[i];
+
+        if (uiLeftCount == 0 || uiLeftCount == uiNumEntries)
+          continue;
+
+        const float fCost = HalfArea(leftBounds) * uiLeftCount + fRightCosts[i + 1];
+        if (fCost < fBestCost)
+        {
+          fBestCost = fCost;
+          uiBestSplitBin = i;
+        }
+      }
+    }
+
+    if (uiBestSplitBin == ezInvalidIndex)
+      return uiNumEntries / 2;
+
+    ezUInt32 uiSplit = 0;
+    for (ezUInt32 i = 0; i < uiNumEntries; ++i)
+    {
+      if (getBin(entries[i]) <= uiBestSplitBin)
+      {
+        ezMath::Swap(entries[i], entries[uiSplit]);
+        ++uiSplit;
+      }
+    }
+
+    EZ_ASSERT_DEBUG(uiSplit > 0 && uiSplit < uiNumEntries, "Implementation error");
+    return uiSplit;
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename NodeTest, typename DataVisitor>
+void ezSpatialSystem_BVH::TraverseTree(ezUInt32 uiCategoryBitmask, NodeTest nodeTest, DataVisitor dataVisitor) const
+{
+  if (m_Nodes.IsEmpty())
+    return;
+
+  const ezSimdVec4i queryCategoryBitmask(static_cast<ezInt32>(uiCategoryBitmask));
+
+  ezHybridArray<ezUInt32, 64> nodeStack;
+  nodeStack.PushBack(0);
+
+  while (!nodeStack.IsEmpty())
+  {
+    const ezUInt32 uiStackEntry = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    const Node& node = m_Nodes[uiStackEntry & ~s_uiInsideFlag];
+
+    ezUInt32 uiSlotMask = NodeUtils::GetCategoryLaneMask(node, queryCategoryBitmask);
+    if (uiSlotMask == 0)
+      continue;
+
+    ezUInt32 uiInsideMask = (uiStackEntry & s_uiInsideFlag) ? 0xF : 0;
+    uiSlotMask &= nodeTest(node, uiInsideMask);
+
+    while (uiSlotMask != 0)
+    {
+      const ezUInt32 uiSlot = ezMath::FirstBitLow(uiSlotMask);
+      uiSlotMask &= uiSlotMask - 1;
+
+      const ezUInt32 uiChild = node.m_Children[uiSlot];
+      const bool bInside = (uiInsideMask & (1u << uiSlot)) != 0;
+
+      if (uiChild & OBJECT_FLAG)
+      {
+        if (dataVisitor(uiChild & ~OBJECT_FLAG, bInside) == ezVisitorExecution::Stop)
+          return;
+      }
+      else
+      {
+        nodeStack.PushBack(bInside ? (uiChild | s_uiInsideFlag) : uiChild);
+      }
+    }
+  }
+}
+
+template <typename Functor>
+ezVisitorExecution::Enum ezSpatialSystem_BVH::ForEachAlwaysVisibleData(const QueryParams& queryParams, Functor func) const
+{
+  for (ezUInt32 uiDataIndex : m_AlwaysVisibleData)
+  {
+    if ((m_DataTable.GetValueUnchecked(uiDataIndex).m_uiCategoryBitmask & queryParams.m_uiCategoryBitmask) == 0)
+      continue;
+
+    if (NodeUtils::FilterByTags(m_DataTags[uiDataIndex], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
+      continue;
+
+    if (func(uiDataIndex) == ezVisitorExecution::Stop)
+      return ezVisitorExecution::Stop;
+  }
+
+  return ezVisitorExecution::Continue;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_BVH, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezSpatialSystem_BVH::ezSpatialSystem_BVH()
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_DataTable(&m_Allocator)
+  , m_DataBounds(&m_AlignedAllocator)
+  , m_DataTags(&m_Allocator)
+  , m_DataLastVisibleFrameIdxAndVisType(&m_Allocator)
+  , m_AlwaysVisibleData(&m_Allocator)
+  , m_Nodes(&m_Allocator)
+  , m_DirtyNodes(&m_Allocator)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(Data) == 24);
+}
+
+ezSpatialSystem_BVH::~ezSpatialSystem_BVH() = default;
+
+void ezSpatialSystem_BVH::GetAllNodeBoxes(ezDynamicArray<ezBoundingBox>& out_boundingBoxes, ezUInt32 uiMaxDepth /*= ezInvalidIndex*/) const
+{
+  if (m_Nodes.IsEmpty())
+    return;
+
+  EnsureRefitted();
+
+  struct StackEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiNodeIndex;
+    ezUInt32 m_uiDepth;
+  };
+
+  ezHybridArray<StackEntry, 64> nodeStack;
+  nodeStack.PushBack({0, 0});
+
+  while (!nodeStack.IsEmpty())
+  {
+    const StackEntry entry = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    if (entry.m_uiDepth >= uiMaxDepth)
+      continue;
+
+    const Node& node = m_Nodes[entry.m_uiNodeIndex];
+    for (ezUInt32 uiSlot = 0; uiSlot < node.m_uiNumChildren; ++uiSlot)
+    {
+      const ezUInt32 uiChild = node.m_Children[uiSlot];
+      if ((uiChild & OBJECT_FLAG) == 0)
+      {
+        out_boundingBoxes.PushBack(ezSimdConversion::ToBBox(NodeUtils::GetSlotBox(node, uiSlot)));
+        nodeStack.PushBack({uiChild, entry.m_uiDepth + 1});
+      }
+    }
+  }
+}
+
+void ezSpatialSystem_BVH::StartNewFrame()
+{
+  SUPER::StartNewFrame();
+
+  EnsureRefitted();
+
+  const ezUInt32 uiNumDataInTree = m_DataTable.GetCount() - m_AlwaysVisibleData.GetCount();
+
+  bool bRebuild = m_uiNumChangesSinceRebuild > ezMath::Max(uiNumDataInTree / 4, 64u) || m_uiNumUnusedNodes > m_Nodes.GetCount() / 2;
+
+  if (!bRebuild && m_bCostCheckNeeded)
+  {
+    EZ_PROFILE_SCOPE("Compute BVH Cost");
+
+    bRebuild = ComputeCost() > m_fCostAfterRebuild * ezMath::Max(cvar_SpatialBVHRebuildThreshold.GetValue(), 1.0f);
+  }
+
+  m_bCostCheckNeeded = false;
+
+  if (bRebuild)
+  {
+    Rebuild();
+  }
+}
+
+ezSpatialDataHandle ezSpatialSystem_BVH::CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  return AddSpatialData(bounds, pObject, uiCategoryBitmask, tags, false);
+}
+
+ezSpatialDataHandle ezSpatialSystem_BVH::CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags)
+{
+  if (uiCategoryBitmask == 0)
+    return ezSpatialDataHandle();
+
+  return AddSpatialData(ezSimdBBoxSphere::MakeInvalid(), pObject, uiCategoryBitmask, tags, true);
+}
+
+void ezSpatialSystem_BVH::DeleteSpatialData(const ezSpatialDataHandle& hData)
+{
+  Data oldData;
+  EZ_VERIFY(m_DataTable.Remove(hData.GetInternalID(), &oldData), "Invalid spatial data handle");
+
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+
+  if (oldData.m_uiNodeIndex == ezInvalidIndex)
+  {
+    m_AlwaysVisibleData.RemoveAndSwap(uiDataIndex);
+  }
+  else
+  {
+    RemoveFromTree(oldData.m_uiNodeIndex, oldData.m_uiSlot);
+    ++m_uiNumChangesSinceRebuild;
+  }
+
+  m_DataTags[uiDataIndex].Clear();
+}
+
+void ezSpatialSystem_BVH::UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds)
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  // No need to update bounds for always visible data
+  if (pData->m_uiNodeIndex == ezInvalidIndex)
+    return;
+
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+  m_DataBounds[uiDataIndex] = bounds;
+
+  NodeUtils::SetSlotBox(m_Nodes[pData->m_uiNodeIndex], pData->m_uiSlot, bounds.GetBox());
+  MarkDirty(pData->m_uiNodeIndex);
+}
+
+void ezSpatialSystem_BVH::UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject)
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  pData->m_pObject = pObject;
+}
+
+void ezSpatialSystem_BVH::FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsInSphere");
+
+  EnsureRefitted();
+
+  const ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+  const bool bUseTagsFilter = queryParams.m_IncludeTags.IsEmpty() == false || queryParams.m_ExcludeTags.IsEmpty() == false;
+
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+
+  auto reportData = [&](ezUInt32 uiDataIndex)
+  {
+    ++uiNumObjectsPassed;
+    return callback(m_DataTable.GetValueUnchecked(uiDataIndex).m_pObject);
+  };
+
+  if (ForEachAlwaysVisibleData(queryParams, reportData) == ezVisitorExecution::Continue)
+  {
+    TraverseTree(
+      queryParams.m_uiCategoryBitmask,
+      [&](const Node& node, ezUInt32& inout_uiInsideMask)
+      { return NodeUtils::OverlapsSphere(NodeUtils::Slots(node), simdSphere); },
+      [&](ezUInt32 uiDataIndex, bool bInside)
+      {
+        ++uiNumObjectsTested;
+
+        if (!simdSphere.Overlaps(m_DataBounds[uiDataIndex].GetSphere()))
+          return ezVisitorExecution::Continue;
+
+        if (bUseTagsFilter && NodeUtils::FilterByTags(m_DataTags[uiDataIndex], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
+          return ezVisitorExecution::Continue;
+
+        return reportData(uiDataIndex);
+      });
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_BVH::FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const
+{
+  EZ_PROFILE_SCOPE("FindObjectsInBox");
+
+  EnsureRefitted();
+
+  const ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+  const bool bUseTagsFilter = queryParams.m_IncludeTags.IsEmpty() == false || queryParams.m_ExcludeTags.IsEmpty() == false;
+
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+
+  auto reportData = [&](ezUInt32 uiDataIndex)
+  {
+    ++uiNumObjectsPassed;
+    return callback(m_DataTable.GetValueUnchecked(uiDataIndex).m_pObject);
+  };
+
+  if (ForEachAlwaysVisibleData(queryParams, reportData) == ezVisitorExecution::Continue)
+  {
+    TraverseTree(
+      queryParams.m_uiCategoryBitmask,
+      [&](const Node& node, ezUInt32& inout_uiInsideMask)
+      { return NodeUtils::OverlapsBox(NodeUtils::Slots(node), simdBox); },
+      [&](ezUInt32 uiDataIndex, bool bInside)
+      {
+        ++uiNumObjectsTested;
+
+        if (!simdBox.Overlaps(m_DataBounds[uiDataIndex].GetSphere()))
+          return ezVisitorExecution::Continue;
+
+        if (bUseTagsFilter && NodeUtils::FilterByTags(m_DataTags[uiDataIndex], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
+          return ezVisitorExecution::Continue;
+
+        return reportData(uiDataIndex);
+      });
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_BVH::FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::IsOccludedFunc IsOccluded, ezVisibilityState visType) const
+{
+  EZ_PROFILE_SCOPE("FindVisibleObjects");
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezStopwatch timer;
+#endif
+
+  EnsureRefitted();
+
+  const NodeUtils::FrustumData frustumData(frustum);
+  const bool bUseTagsFilter = queryParams.m_IncludeTags.IsEmpty() == false || queryParams.m_ExcludeTags.IsEmpty() == false;
+  const ezUInt64 uiFrameIdxAndType = (m_uiFrameCounter << 4) | static_cast<ezUInt64>(visType);
+
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+
+  auto reportData = [&](ezUInt32 uiDataIndex)
+  {
+    m_DataLastVisibleFrameIdxAndVisType[uiDataIndex].Max(uiFrameIdxAndType);
+    out_Objects.PushBack(m_DataTable.GetValueUnchecked(uiDataIndex).m_pObject);
+
+    ++uiNumObjectsPassed;
+    return ezVisitorExecution::Continue;
+  };
+
+  ForEachAlwaysVisibleData(queryParams, reportData);
+
+  TraverseTree(
+    queryParams.m_uiCategoryBitmask,
+    [&](const Node& node, ezUInt32& inout_uiInsideMask)
+    {
+      // Nothing to test if the node itself is already fully inside the frustum
+      ezUInt32 uiSlotMask = inout_uiInsideMask;
+      if (uiSlotMask != 0xF)
+      {
+        uiSlotMask = NodeUtils::OverlapsFrustum(NodeUtils::Slots(node), frustumData, inout_uiInsideMask);
+      }
+
+      if (IsOccluded.IsValid())
+      {
+        ezUInt32 uiNodeSlotMask = uiSlotMask;
+        while (uiNodeSlotMask != 0)
+        {
+          const ezUInt32 uiSlot = ezMath::FirstBitLow(uiNodeSlotMask);
+          uiNodeSlotMask &= uiNodeSlotMask - 1;
+
+          // spatial data is tested individually
+          if ((node.m_Children[uiSlot] & OBJECT_FLAG) == 0 && IsOccluded(NodeUtils::GetSlotBox(node, uiSlot)))
+          {
+            uiSlotMask &= ~(1u << uiSlot);
+          }
+        }
+      }
+
+      return uiSlotMask;
+    },
+    [&](ezUInt32 uiDataIndex, bool bInside)
+    {
+      ++uiNumObjectsTested;
+
+      const ezSimdBBoxSphere& bounds = m_DataBounds[uiDataIndex];
+
+      // The sphere always overlaps the frustum if the box is fully inside
+      if (!bInside && !NodeUtils::SphereFrustumIntersect(bounds.GetSphere(), frustumData))
+        return ezVisitorExecution::Continue;
+
+      if (bUseTagsFilter && NodeUtils::FilterByTags(m_DataTags[uiDataIndex], queryParams.m_IncludeTags, queryParams.m_ExcludeTags))
+        return ezVisitorExecution::Continue;
+
+      if (IsOccluded.IsValid() && IsOccluded(bounds.GetBox()))
+        return ezVisitorExecution::Continue;
+
+      return reportData(uiDataIndex);
+    });
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (queryParams.m_pStats != nullptr)
+  {
+    queryParams.m_pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    queryParams.m_pStats->m_uiNumObjectsTested += uiNumObjectsTested;
+    queryParams.m_pStats->m_uiNumObjectsPassed += uiNumObjectsPassed;
+    queryParams.m_pStats->m_TimeTaken = timer.GetRunningTotal();
+  }
+#endif
+}
+
+ezVisibilityState ezSpatialSystem_BVH::GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const
+{
+  Data* pData = nullptr;
+  EZ_VERIFY(m_DataTable.TryGetValue(hData.GetInternalID(), pData), "Invalid spatial data handle");
+
+  if (pData->m_uiNodeIndex == ezInvalidIndex)
+    return ezVisibilityState::Direct;
+
+  const ezUInt64 uiLastVisibleFrameIdxAndVisType = m_DataLastVisibleFrameIdxAndVisType[hData.GetInternalID().m_InstanceIndex];
+  const ezUInt64 uiLastVisibleFrameIdx = (uiLastVisibleFrameIdxAndVisType >> 4);
+  const ezUInt64 uiLastVisibilityType = (uiLastVisibleFrameIdxAndVisType & static_cast<ezUInt64>(15)); // mask out lower 4 bits
+
+  if (m_uiFrameCounter > uiLastVisibleFrameIdx + uiNumFramesBeforeInvisible)
+    return ezVisibilityState::Invisible;
+
+  return static_cast<ezVisibilityState>(uiLastVisibilityType);
+}
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+void ezSpatialSystem_BVH::GetInternalStats(ezStringBuilder& sb) const
+{
+  EnsureRefitted();
+
+  sb.Clear();
+  sb.AppendFormat("Spatial Data: {} ({} always visible)\n", m_DataTable.GetCount(), m_AlwaysVisibleData.GetCount());
+  sb.AppendFormat("Nodes: {} ({} unused)\n", m_Nodes.GetCount(), m_uiNumUnusedNodes);
+  sb.AppendFormat("Cost: {} (after last rebuild: {})\n", ezArgF(ComputeCost(), 2), ezArgF(m_fCostAfterRebuild, 2));
+  sb.AppendFormat("Rebuilds: {}\n", m_uiNumRebuilds);
+}
+#endif
+
+ezSpatialDataHandle ezSpatialSystem_BVH::AddSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible)
+{
+  Data data;
+  data.m_pObject = pObject;
+  data.m_uiCategoryBitmask = uiCategoryBitmask;
+  data.m_uiNodeIndex = ezInvalidIndex;
+  data.m_uiSlot = 0;
+
+  auto hData = ezSpatialDataHandle(m_DataTable.Insert(data));
+
+  const ezUInt32 uiDataIndex = hData.GetInternalID().m_InstanceIndex;
+  if (uiDataIndex >= m_DataBounds.GetCount())
+  {
+    m_DataBounds.SetCount(uiDataIndex + 1);
+    m_DataTags.SetCount(uiDataIndex + 1);
+    m_DataLastVisibleFrameIdxAndVisType.SetCount(uiDataIndex + 1);
+  }
+
+  m_DataBounds[uiDataIndex] = bounds;
+  m_DataTags[uiDataIndex] = tags;
+  m_DataLastVisibleFrameIdxAndVisType[uiDataIndex] = 0;
+
+  if (bAlwaysVisible)
+  {
+    m_AlwaysVisibleData.PushBack(uiDataIndex);
+  }
+  else
+  {
+    InsertIntoTree(uiDataIndex, uiCategoryBitmask);
+    ++m_uiNumChangesSinceRebuild;
+  }
+
+  return hData;
+}
+
+ezUInt32 ezSpatialSystem_BVH::AllocateNode()
+{
+  const ezUInt32 uiNodeIndex = m_Nodes.GetCount();
+
+  Node& node = m_Nodes.ExpandAndGetRef();
+  for (ezUInt32 uiSlot = 0; uiSlot < NUM_SLOTS; ++uiSlot)
+  {
+    NodeUtils::ClearSlot(node, uiSlot);
+  }
+
+  node.m_uiParentIndex = ezInvalidIndex;
+  node.m_uiParentSlot = 0;
+  node.m_uiNumChildren = 0;
+
+  m_DirtyNodes.SetCount((m_Nodes.GetCount() + 63) / 64);
+
+  return uiNodeIndex;
+}
+
+void ezSpatialSystem_BVH::AttachChild(ezUInt32 uiNodeIndex, ezUInt32 uiSlot, ezUInt32 uiChild)
+{
+  m_Nodes[uiNodeIndex].m_Children[uiSlot] = uiChild;
+
+  if (uiChild & OBJECT_FLAG)
+  {
+    Data& data = m_DataTable.GetValueUnchecked(uiChild & ~OBJECT_FLAG);
+    data.m_uiNodeIndex = uiNodeIndex;
+    data.m_uiSlot = uiSlot;
+  }
+  else
+  {
+    EZ_ASSERT_DEBUG(uiNodeIndex < uiChild, "Parent nodes must be stored before their children");
+
+    Node& childNode = m_Nodes[uiChild];
+    childNode.m_uiParentIndex = uiNodeIndex;
+    childNode.m_uiParentSlot = static_cast<ezUInt8>(uiSlot);
+  }
+}
+
+void ezSpatialSystem_BVH::SetSlot(ezUInt32 uiNodeIndex, ezUInt32 uiSlot, ezUInt32 uiChild, const ezSimdBBox& box, ezUInt32 uiCategoryBitmask)
+{
+  Node& node = m_Nodes[uiNodeIndex];
+  NodeUtils::SetSlotBox(node, uiSlot, box);
+  node.m_CategoryBitmasks[uiSlot] = uiCategoryBitmask;
+
+  AttachChild(uiNodeIndex, uiSlot, uiChild);
+}
+
+void ezSpatialSystem_BVH::MarkDirty(ezUInt32 uiNodeIndex)
+{
+  m_DirtyNodes[uiNodeIndex / 64] |= EZ_BIT(uiNodeIndex % 64);
+  m_bNeedsRefit = true;
+  m_bCostCheckNeeded = true;
+}
+
+void ezSpatialSystem_BVH::InsertIntoTree(ezUInt32 uiDataIndex, ezUInt32 uiCategoryBitmask)
+{
+  const ezSimdBBox box = m_DataBounds[uiDataIndex].GetBox();
+
+  if (m_Nodes.IsEmpty())
+  {
+    AllocateNode();
+  }
+
+  m_bCostCheckNeeded = true;
+
+  ezUInt32 uiNodeIndex = 0;
+  while (true)
+  {
+    Node& node = m_Nodes[uiNodeIndex];
+    if (node.m_uiNumChildren < NUM_SLOTS)
+    {
+      SetSlot(uiNodeIndex, node.m_uiNumChildren, uiDataIndex | OBJECT_FLAG, box, uiCategoryBitmask);
+      ++node.m_uiNumChildren;
+      return;
+    }
+
+    // Descend into the slot that grows the least. Rotating the preferred slot keeps the tree balanced when many objects share the same bounds.
+    const ezUInt32 uiSlot = NodeUtils::FindCheapestSlot(node, box, uiDataIndex);
+
+    ezSimdBBox slotBox = NodeUtils::GetSlotBox(node, uiSlot);
+    slotBox.ExpandToInclude(box);
+    NodeUtils::SetSlotBox(node, uiSlot, slotBox);
+    node.m_CategoryBitmasks[uiSlot] |= uiCategoryBitmask;
+
+    const ezUInt32 uiChild = node.m_Children[uiSlot];
+    if ((uiChild & OBJECT_FLAG) == 0)
+    {
+      uiNodeIndex = uiChild;
+      continue;
+    }
+
+    // Replace the spatial data in the slot with a new node that holds both the old and the new data
+    const ezUInt32 uiOtherDataIndex = uiChild & ~OBJECT_FLAG;
+    const ezUInt32 uiNewNodeIndex = AllocateNode();
+
+    SetSlot(uiNewNodeIndex, 0, uiChild, m_DataBounds[uiOtherDataIndex].GetBox(), m_DataTable.GetValueUnchecked(uiOtherDataIndex).m_uiCategoryBitmask);
+    SetSlot(uiNewNodeIndex, 1, uiDataIndex | OBJECT_FLAG, box, uiCategoryBitmask);
+    m_Nodes[uiNewNodeIndex].m_uiNumChildren = 2;
+
+    AttachChild(uiNodeIndex, uiSlot, uiNewNodeIndex);
+    return;
+  }
+}
+
+void ezSpatialSystem_BVH::RemoveFromTree(ezUInt32 uiNodeIndex, ezUInt32 uiSlot)
+{
+  Node& node = m_Nodes[uiNodeIndex];
+
+  // Keep the used slots packed at the front
+  const ezUInt32 uiLastSlot = --node.m_uiNumChildren;
+  if (uiSlot != uiLastSlot)
+  {
+    SetSlot(uiNodeIndex, uiSlot, node.m_Children[uiLastSlot], NodeUtils::GetSlotBox(node, uiLastSlot), node.m_CategoryBitmasks[uiLastSlot]);
+  }
+
+  NodeUtils::ClearSlot(node, uiLastSlot);
+
+  const ezUInt32 uiParentIndex = node.m_uiParentIndex;
+  if (uiParentIndex == ezInvalidIndex)
+    return;
+
+  const ezUInt32 uiParentSlot = node.m_uiParentSlot;
+
+  if (node.m_uiNumChildren == 0)
+  {
+    node.m_uiParentIndex = ezInvalidIndex;
+    ++m_uiNumUnusedNodes;
+
+    RemoveFromTree(uiParentIndex, uiParentSlot);
+  }
+  else if (node.m_uiNumChildren == 1)
+  {
+    // The remaining child takes the place of the node in the parent
+    SetSlot(uiParentIndex, uiParentSlot, node.m_Children[0], NodeUtils::GetSlotBox(node, 0), node.m_CategoryBitmasks[0]);
+
+    NodeUtils::ClearSlot(node, 0);
+    node.m_uiNumChildren = 0;
+    node.m_uiParentIndex = ezInvalidIndex;
+    ++m_uiNumUnusedNodes;
+
+    MarkDirty(uiParentIndex);
+  }
+  else
+  {
+    MarkDirty(uiNodeIndex);
+  }
+}
+
+void ezSpatialSystem_BVH::EnsureRefitted() const
+{
+  if (!m_bNeedsRefit)
+    return;
+
+  EZ_LOCK(m_RefitMutex);
+
+  if (m_bNeedsRefit)
+  {
+    Refit();
+    m_bNeedsRefit = false;
+  }
+}
+
+void ezSpatialSystem_BVH::Refit() const
+{
+  EZ_PROFILE_SCOPE("Refit BVH");
+
+  // Parents are always stored before their children, so going backwards visits all children of a node before the node itself
+  for (ezUInt32 uiWord = m_DirtyNodes.GetCount(); uiWord-- > 0;)
+  {
+    while (m_DirtyNodes[uiWord] != 0)
+    {
+      const ezUInt32 uiBit = ezMath::FirstBitHigh(m_DirtyNodes[uiWord]);
+      m_DirtyNodes[uiWord] &= ~EZ_BIT(uiBit);
+
+      const ezUInt32 uiNodeIndex = uiWord * 64 + uiBit;
+      const Node& node = m_Nodes[uiNodeIndex];
+
+      const ezUInt32 uiParentIndex = node.m_uiParentIndex;
+      if (uiParentIndex == ezInvalidIndex)
+        continue;
+
+      EZ_ASSERT_DEBUG(uiParentIndex < uiNodeIndex, "Parent nodes must be stored before their children");
+
+      ezSimdBBox box;
+      ezUInt32 uiCategoryBitmask;
+      NodeUtils::ComputeBounds(node, box, uiCategoryBitmask);
+
+      Node& parentNode = m_Nodes[uiParentIndex];
+      if (!NodeUtils::IsSlotEqual(parentNode, node.m_uiParentSlot, box, uiCategoryBitmask))
+      {
+        NodeUtils::SetSlotBox(parentNode, node.m_uiParentSlot, box);
+        parentNode.m_CategoryBitmasks[node.m_uiParentSlot] = uiCategoryBitmask;
+
+        m_DirtyNodes[uiParentIndex / 64] |= EZ_BIT(uiParentIndex % 64);
+      }
+    }
+  }
+}
+
+float ezSpatialSystem_BVH::ComputeCost() const
+{
+  if (m_Nodes.IsEmpty())
+    return 0.0f;
+
+  ezSimdBBox rootBox;
+  ezUInt32 uiRootCategoryBitmask;
+  NodeUtils::ComputeBounds(m_Nodes[0], rootBox, uiRootCategoryBitmask);
+
+  const float fRootArea = HalfArea(rootBox);
+  if (uiRootCategoryBitmask == 0 || fRootArea <= 0.0f)
+    return 0.0f;
+
+  // Sum of the surface areas of all inner nodes relative to the root, which is proportional to the expected number of nodes a random ray visits
+  float fArea = 0.0f;
+  for (const Node& node : m_Nodes)
+  {
+    if (node.m_uiNumChildren == 0)
+      continue;
+
+    const NodeUtils::Slots slots(node);
+
+    float fSlotAreas[NUM_SLOTS];
+    HalfArea(slots.m_MaxX - slots.m_MinX, slots.m_MaxY - slots.m_MinY, slots.m_MaxZ - slots.m_MinZ).Store<4>(fSlotAreas);
+
+    for (ezUInt32 uiSlot = 0; uiSlot < node.m_uiNumChildren; ++uiSlot)
+    {
+      if ((node.m_Children[uiSlot] & OBJECT_FLAG) == 0)
+      {
+        fArea += fSlotAreas[uiSlot];
+      }
+    }
+  }
+
+  return fArea / fRootArea;
+}
+
+void ezSpatialSystem_BVH::Rebuild()
+{
+  EZ_PROFILE_SCOPE("Rebuild BVH");
+
+  ezDynamicArray<BuildEntry> entries(&m_AlignedAllocator);
+  entries.Reserve(m_DataTable.GetCount());
+
+  for (auto it = m_DataTable.GetIterator(); it.IsValid(); ++it)
+  {
+    if (it.Value().m_uiNodeIndex == ezInvalidIndex)
+      continue;
+
+    const ezUInt32 uiDataIndex = it.Id().m_InstanceIndex;
+
+    BuildEntry& entry = entries.ExpandAndGetRef();
+    entry.m_Box = m_DataBounds[uiDataIndex].GetBox();
+    entry.m_Center = m_DataBounds[uiDataIndex].m_CenterAndRadius;
+    entry.m_uiDataIndex = uiDataIndex;
+    entry.m_uiCategoryBitmask = it.Value().m_uiCategoryBitmask;
+  }
+
+  m_Nodes.Clear();
+  m_DirtyNodes.Clear();
+  m_bNeedsRefit = false;
+
+  AllocateNode();
+  if (!entries.IsEmpty())
+  {
+    BuildNode(0, entries.GetArrayPtr());
+  }
+
+  m_uiNumUnusedNodes = 0;
+  m_uiNumChangesSinceRebuild = 0;
+  m_fCostAfterRebuild = ComputeCost();
+  ++m_uiNumRebuilds;
+}
+
+void ezSpatialSystem_BVH::BuildNode(ezUInt32 uiNodeIndex, ezArrayPtr<BuildEntry> entries)
+{
+  // Split the largest group in two until there is one group per slot
+  ezArrayPtr<BuildEntry> groups[NUM_SLOTS];
+  groups[0] = entries;
+  ezUInt32 uiNumGroups = 1;
+
+  while (uiNumGroups < NUM_SLOTS)
+  {
+    ezUInt32 uiLargestGroup = 0;
+    for (ezUInt32 i = 1; i < uiNumGroups; ++i)
+    {
+      if (groups[i].GetCount() > groups[uiLargestGroup].GetCount())
+      {
+        uiLargestGroup = i;
+      }
+    }
+
+    const ezArrayPtr<BuildEntry> group = groups[uiLargestGroup];
+    if (group.GetCount() <= 1)
+      break;
+
+    const ezUInt32 uiSplit = NodeUtils::SplitEntries(group);
+    groups[uiLargestGroup] = group.GetSubArray(0, uiSplit);
+    groups[uiNumGroups] = group.GetSubArray(uiSplit);
+    ++uiNumGroups;
+  }
+
+  for (ezUInt32 uiSlot = 0; uiSlot < uiNumGroups; ++uiSlot)
+  {
+    const ezArrayPtr<BuildEntry> group = groups[uiSlot];
+    if (group.GetCount() == 1)
+    {
+      SetSlot(uiNodeIndex, uiSlot, group[0].m_uiDataIndex | OBJECT_FLAG, group[0].m_Box, group[0].m_uiCategoryBitmask);
+    }
+    else
+    {
+      const ezUInt32 uiChildIndex = AllocateNode();
+      BuildNode(uiChildIndex, group);
+
+      ezSimdBBox box;
+      ezUInt32 uiCategoryBitmask;
+      NodeUtils::ComputeBounds(m_Nodes[uiChildIndex], box, uiCategoryBitmask);
+
+      SetSlot(uiNodeIndex, uiSlot, uiChildIndex, box, uiCategoryBitmask);
+    }
+  }
+
+  m_Nodes[uiNodeIndex].m_uiNumChildren = static_cast<ezUInt8>(uiNumGroups);
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_BVH);
@@ -5,12 +5,15 @@
 #include <Core/World/EventMessageHandlerComponent.h>
 #include <Core/World/World.h>
 #include <Core/World/WorldModule.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Utilities/Stats.h>
 
 ezStaticArray<ezWorld*, ezWorld::GetMaxNumWorlds()> ezWorld::s_Worlds;
 
+ezCVarBool cvar_WorldLogCriticalUpdatePath("World.LogCriticalUpdatePath", false, ezCVarFlags::Default, "Logs the longest chain of dependent update functions of each synchronous update phase once per frame");
+
 static ezGameObjectHandle DefaultGameObjectReferenceResolver(const void* pData, ezComponentHandle hThis, ezStringView sProperty)
 {
   const char* szRef = reinterpret_cast<const char*>(pData);
@@ -207,6 +210,8 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   pTransformationData->m_hSpatialData.Invalidate();
   pTransformationData->m_uiSpatialDataCategoryBitmask = 0;
   pTransformationData->m_uiStableRandomSeed = desc.m_uiStableRandomSeed;
+  pTransformationData->m_uiTransformState = ezGameObject::TransformationData::ChangeState::Unchanged;
+  pTransformationData->m_uiChildrenState = ezGameObject::TransformationData::ChangeState::Unchanged;
 
   // if seed is set to 0xFFFFFFFF, use the parent's seed to create a deterministic value for this object
   if (pTransformationData->m_uiStableRandomSeed == 0xFFFFFFFF && pTransformationData->m_pParentData != nullptr)
@@ -231,6 +236,16 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   // link the transformation data to the game object
   pNewObject->m_pTransformationData = pTransformationData;
 
+  if (bDynamic)
+  {
+    pTransformationData->MarkTransformChanged();
+
+    if (pParentObject != nullptr && pParentObject->IsStatic())
+    {
+      m_Data.m_DynamicSubtreeRootCandidates.Insert(pNewObject->GetHandle());
+    }
+  }
+
   // fix links
   LinkToParent(pNewObject);
 
@@ -393,8 +408,7 @@ void ezWorld::PostMessage(const ezGameObjectHandle& receiverObject, const ezMess
   }
   else
   {
-    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, m_Data.m_StackAllocator.GetCurrentAllocator());
-    m_Data.m_MessageQueues[queueType].Enqueue(pMsgCopy, metaData);
+    m_Data.EnqueueMessage(m_uiIndex, msg, metaData, queueType);
   }
 }
 
@@ -424,8 +438,7 @@ void ezWorld::PostMessage(const ezComponentHandle& hReceiverComponent, const ezM
   }
   else
   {
-    ezMessage* pMsgCopy = pMsgRTTIAllocator->Clone<ezMessage>(&msg, m_Data.m_StackAllocator.GetCurrentAllocator());
-    m_Data.m_MessageQueues[queueType].Enqueue(pMsgCopy, metaData);
+    m_Data.EnqueueMessage(m_uiIndex, msg, metaData, queueType);
   }
 }
 
@@ -494,7 +507,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Pre-Async Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::NextFrame);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PreAsync]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PreAsync);
   }
 
   // async phase
@@ -513,7 +526,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Post-Async Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::PostAsync);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PostAsync]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PostAsync);
   }
 
   // delete dead objects and update the object hierarchy
@@ -533,7 +546,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Post-Transform Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::PostTransform);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PostTransform]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PostTransform);
   }
 
   // Process again so new component can receive render messages, otherwise we introduce a frame delay.
@@ -546,8 +559,22 @@ void ezWorld::Update()
     ProcessQueuedMessages(ezObjectMsgQueueType::AfterInitialized);
   }
 
-  // Swap our double buffered stack allocator
+  // Swap our double buffered stack allocators
   m_Data.m_StackAllocator.Swap();
+  m_Data.SwapThreadMessageBuffers();
+}
+
+void ezWorld::SetTransformUpdateMode(ezTransformUpdateMode::Enum mode)
+{
+  CheckForWriteAccess();
+
+  if (m_Data.m_TransformUpdateMode == ezTransformUpdateMode::HierarchyLevels && mode != ezTransformUpdateMode::HierarchyLevels)
+  {
+    // the subtree roots are not tracked while updating by hierarchy levels
+    m_Data.CollectDynamicSubtreeRootCandidates();
+  }
+
+  m_Data.m_TransformUpdateMode = mode;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -847,6 +874,56 @@ void ezWorld::ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::En
   }
 }
 
+void ezWorld::ProcessQueuedComponentMessages(const ezInternal::WorldData::MessageQueue& queue, ezUInt32 uiFirstEntry, ezUInt32 uiEndEntry)
+{
+  const ezWorldModuleTypeId uiTypeId = ezComponentId(queue[uiFirstEntry].m_MetaData.m_uiReceiverObjectOrComponent).m_TypeId;
+  const ezMessageId msgId = queue[uiFirstEntry].m_pMessage->GetId();
+
+  ezComponentManagerBase* pManager = nullptr;
+  if (uiTypeId < m_Data.m_Modules.GetCount())
+  {
+    pManager = static_cast<ezComponentManagerBase*>(m_Data.m_Modules[uiTypeId]);
+  }
+
+  // all components of one type usually share the same dispatch type, so the handler only needs to be looked up once
+  const ezRTTI* pDispatchType = nullptr;
+  ezAbstractMessageHandler* pHandler = nullptr;
+
+  for (ezUInt32 i = uiFirstEntry; i < uiEndEntry; ++i)
+  {
+    const ezInternal::WorldData::MessageQueue::Entry& entry = queue[i];
+    ezComponentHandle hComponent(ezComponentId(entry.m_MetaData.m_uiReceiverObjectOrComponent));
+
+    ezComponent* pReceiverComponent = nullptr;
+    if (pManager == nullptr || !pManager->TryGetComponent(hComponent, pReceiverComponent))
+    {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+      if (entry.m_pMessage->GetDebugMessageRouting())
+      {
+        ezLog::Warning("ezWorld::ProcessQueuedMessage: Receiver ezComponent for message of type '{0}' does not exist anymore.", entry.m_pMessage->GetId());
+      }
+#endif
+      continue;
+    }
+
+    if (pReceiverComponent->m_pMessageDispatchType != pDispatchType)
+    {
+      pDispatchType = pReceiverComponent->m_pMessageDispatchType;
+      pHandler = pDispatchType != nullptr ? pDispatchType->GetMessageHandler(msgId) : nullptr;
+    }
+
+    if (pHandler != nullptr && pReceiverComponent->IsActiveAndInitialized())
+    {
+      (*pHandler)(pReceiverComponent, *entry.m_pMessage);
+    }
+    else
+    {
+      // takes care of inactive components, unhandled messages and debug output
+      pReceiverComponent->SendMessageInternal(*entry.m_pMessage, true);
+    }
+  }
+}
+
 void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
 {
   EZ_PROFILE_SCOPE("Process Queued Messages");
@@ -885,13 +962,40 @@ void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
 
   // regular messages
   {
+    m_Data.MergeThreadMessageBuffers(queueType);
+
     ezInternal::WorldData::MessageQueue& queue = m_Data.m_MessageQueues[queueType];
     queue.Sort(MessageComparer());
 
     m_Data.m_ProcessingMessageQueue = queueType;
-    for (ezUInt32 i = 0; i < queue.GetCount(); ++i)
+    for (ezUInt32 i = 0; i < queue.GetCount();)
     {
-      ProcessQueuedMessage(queue[i]);
+      const ezInternal::WorldData::MessageQueue::Entry& entry = queue[i];
+
+      // messages to components of the same type are sorted next to each other since the type is part of the receiver id
+      ezUInt32 uiBatchEnd = i + 1;
+      if (entry.m_MetaData.m_uiReceiverIsComponent)
+      {
+        const ezWorldModuleTypeId uiTypeId = ezComponentId(entry.m_MetaData.m_uiReceiverObjectOrComponent).m_TypeId;
+
+        while (uiBatchEnd < queue.GetCount())
+        {
+          const ezInternal::WorldData::MessageQueue::Entry& nextEntry = queue[uiBatchEnd];
+          if (!nextEntry.m_MetaData.m_uiReceiverIsComponent || nextEntry.m_pMessage->GetId() != entry.m_pMessage->GetId() ||
+              ezComponentId(nextEntry.m_MetaData.m_uiReceiverObjectOrComponent).m_TypeId != uiTypeId)
+            break;
+
+          ++uiBatchEnd;
+        }
+
+        ProcessQueuedComponentMessages(queue, i, uiBatchEnd);
+      }
+      else
+      {
+        ProcessQueuedMessage(entry);
+      }
+
+      i = uiBatchEnd;
 
       // no need to deallocate these messages, they are allocated through a frame allocator
     }
@@ -999,6 +1103,21 @@ void ezWorld::FindEventMsgHandlers(World& world, const ezMessage& msg, GameObjec
   }
 }
 
+ezTime ezWorld::GetCriticalUpdatePath(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase, ezDynamicArray<ezHashedString>& out_functionNames) const
+{
+  CheckForReadAccess();
+
+  const ezInternal::WorldData::UpdateGraph& graph = m_Data.m_UpdateGraphs[phase];
+
+  out_functionNames.Clear();
+  for (ezUInt32 uiFunctionIndex : graph.m_CriticalPath)
+  {
+    out_functionNames.PushBack(m_Data.m_UpdateFunctions[phase][uiFunctionIndex].m_sFunctionName);
+  }
+
+  return graph.m_CriticalPathDuration;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void ezWorld::RegisterUpdateFunction(const ezComponentManagerBase::UpdateFunctionDesc& desc)
@@ -1023,6 +1142,7 @@ void ezWorld::DeregisterUpdateFunction(const ezComponentManagerBase::UpdateFunct
     if (updateFunctions[i].m_Function.IsEqualIfComparable(desc.m_Function))
     {
       updateFunctions.RemoveAtAndCopy(i);
+      m_Data.m_UpdateGraphs[desc.m_Phase.GetValue()].m_bIsDirty = true;
     }
   }
 }
@@ -1040,6 +1160,7 @@ void ezWorld::DeregisterUpdateFunctions(ezWorldModule* pModule)
       if (updateFunctions[i].m_Function.GetClassInstance() == pModule)
       {
         updateFunctions.RemoveAtAndCopy(i);
+        m_Data.m_UpdateGraphs[phase].m_bIsDirty = true;
       }
     }
   }
@@ -1057,24 +1178,109 @@ void ezWorld::UpdateFromThread()
   Update();
 }
 
-void ezWorld::UpdateSynchronous(const ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions)
+void ezWorld::UpdateSynchronous(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase)
 {
-  ezWorldModule::UpdateContext context;
-  context.m_uiFirstComponentIndex = 0;
-  context.m_uiComponentCount = ezInvalidIndex;
+  ezInternal::WorldData::UpdateGraph& graph = m_Data.m_UpdateGraphs[phase];
+  if (graph.m_bIsDirty)
+  {
+    m_Data.BuildUpdateGraph(phase);
+  }
 
-  for (auto& updateFunction : updateFunctions)
+  const ezUInt32 uiNumFunctions = graph.m_Nodes.GetCount();
+
+  if (!graph.m_bHasConcurrentFunctions)
   {
-    if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
-      continue;
+    for (ezUInt32 i = 0; i < uiNumFunctions; ++i)
+    {
+      m_Data.ExecuteUpdateFunction(phase, i);
+    }
+  }
+  else
+  {
+    // functions without declared component access split the phase into ranges of functions that can run concurrently
+    ezUInt32 uiFirstFunction = 0;
+    for (ezUInt32 i = 0; i <= uiNumFunctions; ++i)
+    {
+      if (i < uiNumFunctions && !graph.m_Nodes[i].m_bExclusive)
+        continue;
+
+      UpdateConcurrently(phase, uiFirstFunction, i);
 
+      if (i < uiNumFunctions)
+      {
+        m_Data.ExecuteUpdateFunction(phase, i);
+      }
+
+      uiFirstFunction = i + 1;
+    }
+  }
+
+  m_Data.UpdateCriticalPath(phase);
+
+  if (cvar_WorldLogCriticalUpdatePath && !graph.m_CriticalPath.IsEmpty())
+  {
+    static const char* s_szPhaseNames[] = {"Pre-Async", "Async", "Post-Async", "Post-Transform"};
+    static_assert(EZ_ARRAY_SIZE(s_szPhaseNames) == ezWorldModule::UpdateFunctionDesc::Phase::COUNT);
+
+    ezStringBuilder sPath;
+    for (ezUInt32 uiFunctionIndex : graph.m_CriticalPath)
     {
-      EZ_PROFILE_SCOPE(updateFunction.m_sFunctionName);
-      updateFunction.m_Function(context);
+      sPath.AppendWithSeparator(" -> ", m_Data.m_UpdateFunctions[phase][uiFunctionIndex].m_sFunctionName);
+      sPath.AppendFormat(" ({})", graph.m_Nodes[uiFunctionIndex].m_Duration);
     }
+
+    ezLog::Info("World '{}', {} phase: critical path {} of {} total: {}", GetName(), s_szPhaseNames[phase], graph.m_CriticalPathDuration, graph.m_TotalDuration, sPath);
   }
 }
 
+void ezWorld::UpdateConcurrently(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase, ezUInt32 uiFirstFunction, ezUInt32 uiEndFunction)
+{
+  if (uiFirstFunction == uiEndFunction)
+    return;
+
+  if (uiFirstFunction + 1 == uiEndFunction)
+  {
+    m_Data.ExecuteUpdateFunction(phase, uiFirstFunction);
+    return;
+  }
+
+  ezInternal::WorldData::UpdateGraph& graph = m_Data.m_UpdateGraphs[phase];
+
+  ezDynamicArray<ezTaskGroupID> taskGroups(m_Data.m_StackAllocator.GetCurrentAllocator());
+  taskGroups.SetCount(uiEndFunction - uiFirstFunction);
+
+  for (ezUInt32 i = uiFirstFunction; i < uiEndFunction; ++i)
+  {
+    ezTaskGroupID& taskGroupId = taskGroups[i - uiFirstFunction];
+    taskGroupId = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+    ezTaskSystem::AddTaskToGroup(taskGroupId, graph.m_Tasks[i]);
+
+    const ezInternal::WorldData::UpdateGraph::Node& node = graph.m_Nodes[i];
+    for (ezUInt32 d = 0; d < node.m_uiNumDependencies; ++d)
+    {
+      // dependencies before this range have already finished
+      const ezUInt32 uiDependency = graph.m_Dependencies[node.m_uiFirstDependency + d];
+      if (uiDependency >= uiFirstFunction)
+      {
+        ezTaskSystem::AddTaskGroupDependency(taskGroupId, taskGroups[uiDependency - uiFirstFunction]);
+      }
+    }
+  }
+
+  // remove write marker but keep the read marker, the functions have the same restrictions as in the async phase
+  m_Data.m_WriteThreadID = (ezThreadID)0;
+
+  ezTaskSystem::StartTaskGroupBatch(taskGroups);
+
+  for (ezTaskGroupID taskGroupId : taskGroups)
+  {
+    ezTaskSystem::WaitForGroup(taskGroupId);
+  }
+
+  // restore write marker
+  m_Data.m_WriteThreadID = ezThreadUtils::GetCurrentThreadID();
+}
+
 void ezWorld::UpdateAsynchronous()
 {
   ezTaskGroupID taskGroupId = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
@@ -1326,6 +1532,7 @@ ezResult ezWorld::RegisterUpdateFunctionInternal(const ezWorldModule::UpdateFunc
   }
 
   updateFunctions.Insert(newFunction, uiInsertionIndex);
+  m_Data.m_UpdateGraphs[desc.m_Phase.GetValue()].m_bIsDirty = true;
 
   return EZ_SUCCESS;
 }
@@ -1406,6 +1613,18 @@ void ezWorld::PatchHierarchyData(ezGameObject* pObject, ezGameObject::TransformP
 
   pObject->m_pTransformationData->m_pParentData = pParent != nullptr ? pParent->m_pTransformationData : nullptr;
 
+  if (pObject->IsDynamic())
+  {
+    // the object is part of a different subtree now, its new parents need to know that it changed
+    pObject->m_pTransformationData->m_uiTransformState = ezGameObject::TransformationData::ChangeState::Unchanged;
+    pObject->m_pTransformationData->MarkTransformChanged();
+
+    if (pParent != nullptr && pParent->IsStatic())
+    {
+      m_Data.m_DynamicSubtreeRootCandidates.Insert(pObject->GetHandle());
+    }
+  }
+
   if (preserve == ezGameObject::TransformPreservation::PreserveGlobal)
   {
     // SetGlobalTransform will internally trigger bounds update for static objects
@@ -1451,9 +1670,27 @@ void ezWorld::RecreateHierarchyData(ezGameObject* pObject, bool bWasDynamic)
     {
       ezGameObject::TransformationData* pTransformData = it->m_pTransformationData;
       pTransformData->m_pParentData = pNewTransformationData;
+
+      // dynamic children of a static object are the roots of their own subtrees
+      if (!bIsDynamic && it->IsDynamic())
+      {
+        m_Data.m_DynamicSubtreeRootCandidates.Insert(it->GetHandle());
+      }
     }
 
     m_Data.DeleteTransformationData(bWasDynamic, uiOldHierarchyLevel, pOldTransformationData);
+
+    pNewTransformationData->m_uiTransformState = ezGameObject::TransformationData::ChangeState::Unchanged;
+
+    if (bIsDynamic)
+    {
+      pNewTransformationData->MarkTransformChanged();
+
+      if (pParent != nullptr && pParent->IsStatic())
+      {
+        m_Data.m_DynamicSubtreeRootCandidates.Insert(pObject->GetHandle());
+      }
+    }
   }
 }
 
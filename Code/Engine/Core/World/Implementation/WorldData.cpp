@@ -2,6 +2,7 @@
 
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Core/World/Implementation/WorldData.h>
+#include <Core/World/SpatialSystem_BVH.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 
@@ -36,6 +37,20 @@ namespace ezInternal
     m_Function(context);
   }
 
+  void WorldData::UpdateGraphTask::Execute()
+  {
+    m_pData->ExecuteUpdateFunction(m_uiPhase, m_uiFunctionIndex);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  static ezAtomicInteger64 s_iNextThreadMessageBuffersId;
+
+  WorldData::ThreadMessageBuffer::ThreadMessageBuffer(ezStringView sName, ezAllocatorBase* pParent)
+    : m_StackAllocator(sName, pParent)
+  {
+  }
+
   ////////////////////////////////////////////////////////////////////////////////////////////////////
 
   WorldData::WorldData(ezWorldDesc& desc)
@@ -45,6 +60,7 @@ namespace ezInternal
     , m_BlockAllocator(desc.m_sName, &m_Allocator)
     , m_StackAllocator(desc.m_sName, ezFoundation::GetAlignedAllocator())
     , m_ObjectStorage(&m_BlockAllocator, &m_Allocator)
+    , m_TransformUpdateMode(desc.m_TransformUpdateMode)
     , m_MaxInitializationTimePerFrame(desc.m_MaxComponentInitializationTimePerFrame)
     , m_Clock(desc.m_sName)
     , m_WriteThreadID((ezThreadID)0)
@@ -68,7 +84,7 @@ namespace ezInternal
     m_Objects.Insert(nullptr);
 
 #if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
-    EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject::TransformationData) == 240);
+    EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject::TransformationData) == 256);
 #else
     EZ_CHECK_AT_COMPILETIME(sizeof(ezGameObject::TransformationData) == 192);
 #endif
@@ -88,7 +104,14 @@ namespace ezInternal
 
     if (m_pSpatialSystem == nullptr && desc.m_bAutoCreateSpatialSystem)
     {
-      m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid);
+      if (desc.m_SpatialSystemType == ezSpatialSystemType::BVH)
+      {
+        m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_BVH);
+      }
+      else
+      {
+        m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid);
+      }
     }
 
     if (m_pCoordinateSystemProvider == nullptr)
@@ -103,6 +126,8 @@ namespace ezInternal
 
     m_Clock.SetTimeStepSmoothing(m_pTimeStepSmoothing.Borrow());
 
+    m_uiThreadMessageBuffersId = static_cast<ezUInt64>(s_iNextThreadMessageBuffersId.Increment());
+
     ezResourceManager::GetResourceEvents().AddEventHandler(ezMakeDelegate(&WorldData::ResourceEventHandler, this));
   }
 
@@ -163,6 +188,8 @@ namespace ezInternal
       hierarchy.m_Data.Clear();
     }
 
+    m_DynamicSubtreeRootCandidates.Clear();
+
     // delete task storage
     m_UpdateTasks.Clear();
 
@@ -174,6 +201,11 @@ namespace ezInternal
 
         // The messages in this queue are allocated through a frame allocator and thus mustn't (and don't need to be) deallocated
         queue.Clear();
+
+        for (auto& pBuffer : m_ThreadMessageBuffers)
+        {
+          pBuffer->m_Messages[i].Clear();
+        }
       }
 
       {
@@ -359,6 +391,18 @@ namespace ezInternal
       }
     };
 
+    if (m_TransformUpdateMode != ezTransformUpdateMode::HierarchyLevels)
+    {
+      UpdateGlobalTransformsOfSubtrees(m_pSpatialSystem.Borrow());
+      return;
+    }
+
+    // the subtree roots are collected again when switching the update mode
+    if (!m_DynamicSubtreeRootCandidates.IsEmpty())
+    {
+      m_DynamicSubtreeRootCandidates.Clear();
+    }
+
     Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
     if (!hierarchy.m_Data.IsEmpty())
     {
@@ -387,6 +431,357 @@ namespace ezInternal
     }
   }
 
+  void WorldData::CollectDynamicSubtreeRootCandidates()
+  {
+    m_DynamicSubtreeRootCandidates.Clear();
+
+    Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
+    for (ezUInt32 uiHierarchyLevel = 1; uiHierarchyLevel < hierarchy.m_Data.GetCount(); ++uiHierarchyLevel)
+    {
+      for (Hierarchy::DataBlock& block : *hierarchy.m_Data[uiHierarchyLevel])
+      {
+        for (ezUInt32 i = 0; i < block.m_uiCount; ++i)
+        {
+          const ezGameObject::TransformationData& data = block.m_pData[i];
+          if (data.m_pParentData->m_pObject->IsStatic())
+          {
+            m_DynamicSubtreeRootCandidates.Insert(data.m_pObject->GetHandle());
+          }
+        }
+      }
+    }
+  }
+
+  void WorldData::UpdateGlobalTransformsOfSubtrees(ezSpatialSystem* pSpatialSystem)
+  {
+    // The dynamic objects in the first hierarchy level and the dynamic objects with a static parent are the roots of all dynamic subtrees.
+    ezDynamicArray<ezGameObject::TransformationData*> subtreeRoots(m_StackAllocator.GetCurrentAllocator());
+
+    for (auto it = m_DynamicSubtreeRootCandidates.GetIterator(); it.IsValid();)
+    {
+      ezGameObject* pObject = nullptr;
+      if (m_Objects.TryGetValue(it.Key().GetInternalID(), pObject) && pObject->IsDynamic() && pObject->m_pTransformationData->m_pParentData != nullptr &&
+          pObject->m_pTransformationData->m_pParentData->m_pObject->IsStatic())
+      {
+        subtreeRoots.PushBack(pObject->m_pTransformationData);
+        ++it;
+      }
+      else
+      {
+        it = m_DynamicSubtreeRootCandidates.Remove(it);
+      }
+    }
+
+    Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
+    if (hierarchy.m_Data.IsEmpty())
+      return;
+
+    // all blocks except the last one are full
+    Hierarchy::DataBlockArray& firstLevel = *hierarchy.m_Data[0];
+    const ezUInt32 uiNumFirstLevelRoots = firstLevel.IsEmpty() ? 0 : (firstLevel.GetCount() - 1) * TRANSFORMATION_DATA_PER_BLOCK + firstLevel.PeekBack().m_uiCount;
+    const ezUInt32 uiNumRoots = uiNumFirstLevelRoots + subtreeRoots.GetCount();
+
+    const bool bUpdateAll = m_TransformUpdateMode == ezTransformUpdateMode::Subtrees;
+
+    auto updateSubtrees = [this, &firstLevel, &subtreeRoots, pSpatialSystem, uiNumFirstLevelRoots, bUpdateAll](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+    {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        ezGameObject::TransformationData* pRoot = i < uiNumFirstLevelRoots
+                                                    ? firstLevel[i / TRANSFORMATION_DATA_PER_BLOCK].m_pData + (i % TRANSFORMATION_DATA_PER_BLOCK)
+                                                    : subtreeRoots[i - uiNumFirstLevelRoots];
+
+        if (bUpdateAll || pRoot->m_uiTransformState != ezGameObject::TransformationData::ChangeState::Unchanged ||
+            pRoot->m_uiChildrenState != ezGameObject::TransformationData::ChangeState::Unchanged)
+        {
+          UpdateGlobalTransformOfSubtree(pRoot, pSpatialSystem, bUpdateAll);
+        }
+      }
+    };
+
+    // If we have no spatial system, we update the subtrees in parallel as we do not
+    // have to acquire a write lock in the process.
+    if (pSpatialSystem == nullptr)
+    {
+      ezParallelForParams parallelForParams;
+      parallelForParams.m_uiBinSize = 4;
+      parallelForParams.m_Mode = ezParallelForMode::Adaptive; // subtrees can have very different sizes
+      parallelForParams.m_pTaskAllocator = m_StackAllocator.GetCurrentAllocator();
+
+      ezTaskSystem::ParallelForIndexed(0u, uiNumRoots, updateSubtrees, "World Subtree Transform Update", parallelForParams);
+    }
+    else
+    {
+      updateSubtrees(0, uiNumRoots);
+    }
+  }
+
+  bool WorldData::UpdateGlobalTransformOfSubtree(ezGameObject::TransformationData* pData, ezSpatialSystem* pSpatialSystem, bool bParentChanged)
+  {
+    using ChangeState = ezGameObject::TransformationData::ChangeState;
+
+    const bool bChanged = bParentChanged || pData->m_uiTransformState == ChangeState::Changed;
+
+    // only changed objects are recomputed and update their spatial data
+    if (bChanged || pData->m_uiTransformState == ChangeState::RefreshLastGlobalTransform)
+    {
+      pData->UpdateGlobalTransformNonRecursive(m_uiUpdateCounter);
+      pData->UpdateGlobalBounds(pSpatialSystem);
+    }
+
+#if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
+    pData->m_uiTransformState = bChanged ? ChangeState::RefreshLastGlobalTransform : ChangeState::Unchanged;
+#else
+    pData->m_uiTransformState = ChangeState::Unchanged;
+#endif
+
+    bool bChildrenNeedUpdate = false;
+
+    if (bChanged || pData->m_uiChildrenState == ChangeState::Changed)
+    {
+      ezUInt32 uiChildIndex = pData->m_pObject->m_uiFirstChildIndex;
+      while (uiChildIndex != 0)
+      {
+        ezGameObject* pChild = m_Objects.GetValueUnchecked(uiChildIndex);
+        EZ_ASSERT_DEBUG(pChild->IsDynamic(), "Children of dynamic objects must be dynamic as well.");
+
+        bChildrenNeedUpdate |= UpdateGlobalTransformOfSubtree(pChild->m_pTransformationData, pSpatialSystem, bChanged);
+
+        uiChildIndex = pChild->m_uiNextSiblingIndex;
+      }
+    }
+
+    pData->m_uiChildrenState = bChildrenNeedUpdate ? ChangeState::Changed : ChangeState::Unchanged;
+
+    // tells the parent whether this subtree needs to be visited again in the next update
+    return bChildrenNeedUpdate || pData->m_uiTransformState != ChangeState::Unchanged;
+  }
+
+  void WorldData::EnqueueMessage(ezUInt32 uiWorldIndex, const ezMessage& msg, const QueuedMsgMetaData& metaData, ezObjectMsgQueueType::Enum queueType) const
+  {
+    // The buffer of the calling thread for every world. The id detects buffers of worlds that have been destroyed in the meantime.
+    struct BufferCache
+    {
+      ezUInt64 m_BufferIds[ezWorld::GetMaxNumWorlds()] = {};
+      ThreadMessageBuffer* m_Buffers[ezWorld::GetMaxNumWorlds()] = {};
+    };
+
+    static thread_local BufferCache s_BufferCache;
+
+    if (s_BufferCache.m_BufferIds[uiWorldIndex] != m_uiThreadMessageBuffersId)
+    {
+      ezStringBuilder sName(m_sName.GetView(), " Messages");
+
+      EZ_LOCK(m_ThreadMessageBuffersMutex);
+      m_ThreadMessageBuffers.PushBack(EZ_NEW(&m_Allocator, ThreadMessageBuffer, sName, ezFoundation::GetAlignedAllocator()));
+
+      s_BufferCache.m_Buffers[uiWorldIndex] = m_ThreadMessageBuffers.PeekBack().Borrow();
+      s_BufferCache.m_BufferIds[uiWorldIndex] = m_uiThreadMessageBuffersId;
+    }
+
+    ThreadMessageBuffer* pBuffer = s_BufferCache.m_Buffers[uiWorldIndex];
+
+    MessageQueue::Entry& entry = pBuffer->m_Messages[queueType].ExpandAndGetRef();
+    entry.m_pMessage = msg.GetDynamicRTTI()->GetAllocator()->Clone<ezMessage>(&msg, pBuffer->m_StackAllocator.GetCurrentAllocator());
+    entry.m_MetaData = metaData;
+    entry.m_uiMessageHash = 0;
+  }
+
+  void WorldData::MergeThreadMessageBuffers(ezObjectMsgQueueType::Enum queueType)
+  {
+    MessageQueue& queue = m_MessageQueues[queueType];
+
+    EZ_LOCK(queue);
+    EZ_LOCK(m_ThreadMessageBuffersMutex);
+
+    for (auto& pBuffer : m_ThreadMessageBuffers)
+    {
+      ezDynamicArray<MessageQueue::Entry>& messages = pBuffer->m_Messages[queueType];
+
+      for (const MessageQueue::Entry& entry : messages)
+      {
+        queue.Enqueue(entry.m_pMessage, entry.m_MetaData);
+      }
+
+      messages.Clear();
+    }
+  }
+
+  void WorldData::SwapThreadMessageBuffers()
+  {
+    EZ_LOCK(m_ThreadMessageBuffersMutex);
+
+    for (auto& pBuffer : m_ThreadMessageBuffers)
+    {
+      pBuffer->m_StackAllocator.Swap();
+    }
+  }
+
+  static bool AccessOverlaps(const ezHybridArray<const ezRTTI*, 2>& a, const ezHybridArray<const ezRTTI*, 2>& b)
+  {
+    for (const ezRTTI* pTypeA : a)
+    {
+      for (const ezRTTI* pTypeB : b)
+      {
+        if (pTypeA->IsDerivedFrom(pTypeB) || pTypeB->IsDerivedFrom(pTypeA))
+          return true;
+      }
+    }
+
+    return false;
+  }
+
+  void WorldData::BuildUpdateGraph(ezUInt32 uiPhase)
+  {
+    const auto& updateFunctions = m_UpdateFunctions[uiPhase];
+    const ezUInt32 uiNumFunctions = updateFunctions.GetCount();
+
+    UpdateGraph& graph = m_UpdateGraphs[uiPhase];
+    graph.m_Nodes.Clear();
+    graph.m_Nodes.SetCount(uiNumFunctions);
+    graph.m_Dependencies.Clear();
+    graph.m_Tasks.SetCount(uiNumFunctions);
+    graph.m_CriticalPath.Clear();
+    graph.m_bHasConcurrentFunctions = false;
+    graph.m_bIsDirty = false;
+
+    // reaches[i * uiNumFunctions + j] is true if function i (indirectly) depends on function j.
+    // Functions are sorted such that every function only depends on earlier functions.
+    auto mustRunAfter = [](const RegisteredUpdateFunction& function, const RegisteredUpdateFunction& earlierFunction, bool bExclusive)
+    {
+      if (bExclusive || (earlierFunction.m_ReadsComponentTypes.IsEmpty() && earlierFunction.m_WritesComponentTypes.IsEmpty()))
+        return true;
+
+      if (function.m_DependsOn.Contains(earlierFunction.m_sFunctionName))
+        return true;
+
+      return AccessOverlaps(function.m_WritesComponentTypes, earlierFunction.m_WritesComponentTypes) ||
+             AccessOverlaps(function.m_WritesComponentTypes, earlierFunction.m_ReadsComponentTypes) ||
+             AccessOverlaps(function.m_ReadsComponentTypes, earlierFunction.m_WritesComponentTypes);
+    };
+
+    ezDynamicArray<bool> reaches(m_StackAllocator.GetCurrentAllocator());
+    reaches.SetCount(uiNumFunctions * uiNumFunctions);
+
+    for (ezUInt32 i = 0; i < uiNumFunctions; ++i)
+    {
+      const RegisteredUpdateFunction& function = updateFunctions[i];
+
+      UpdateGraph::Node& node = graph.m_Nodes[i];
+      node.m_bExclusive = function.m_ReadsComponentTypes.IsEmpty() && function.m_WritesComponentTypes.IsEmpty();
+      node.m_uiFirstDependency = graph.m_Dependencies.GetCount();
+
+      bool* pReachesFromI = reaches.GetData() + i * uiNumFunctions;
+
+      // visit the closest functions first, dependencies that are already implied by another dependency are skipped
+      for (ezUInt32 j = i; j-- > 0;)
+      {
+        if (pReachesFromI[j] || !mustRunAfter(function, updateFunctions[j], node.m_bExclusive))
+          continue;
+
+        graph.m_Dependencies.PushBack(j);
+
+        const bool* pReachesFromJ = reaches.GetData() + j * uiNumFunctions;
+        pReachesFromI[j] = true;
+        for (ezUInt32 k = 0; k < j; ++k)
+        {
+          pReachesFromI[k] |= pReachesFromJ[k];
+        }
+      }
+
+      node.m_uiNumDependencies = graph.m_Dependencies.GetCount() - node.m_uiFirstDependency;
+
+      // as long as every function depends on its predecessor, there is nothing that could run concurrently
+      if (i > 0 && !pReachesFromI[i - 1])
+      {
+        graph.m_bHasConcurrentFunctions = true;
+      }
+
+      if (graph.m_Tasks[i] == nullptr)
+      {
+        graph.m_Tasks[i] = EZ_NEW(&m_Allocator, UpdateGraphTask);
+      }
+
+      UpdateGraphTask* pTask = graph.m_Tasks[i].Borrow();
+      pTask->ConfigureTask(function.m_sFunctionName, ezTaskNesting::Maybe);
+      pTask->m_pData = this;
+      pTask->m_uiPhase = uiPhase;
+      pTask->m_uiFunctionIndex = i;
+    }
+  }
+
+  void WorldData::ExecuteUpdateFunction(ezUInt32 uiPhase, ezUInt32 uiFunctionIndex)
+  {
+    const RegisteredUpdateFunction& updateFunction = m_UpdateFunctions[uiPhase][uiFunctionIndex];
+    UpdateGraph::Node& node = m_UpdateGraphs[uiPhase].m_Nodes[uiFunctionIndex];
+
+    if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_bSimulateWorld)
+    {
+      node.m_Duration = ezTime::MakeZero();
+      return;
+    }
+
+    ezWorldModule::UpdateContext context;
+    context.m_uiFirstComponentIndex = 0;
+    context.m_uiComponentCount = ezInvalidIndex;
+
+    const ezTime startTime = ezTime::Now();
+
+    {
+      EZ_PROFILE_SCOPE(updateFunction.m_sFunctionName);
+      updateFunction.m_Function(context);
+    }
+
+    node.m_Duration = ezTime::Now() - startTime;
+  }
+
+  void WorldData::UpdateCriticalPath(ezUInt32 uiPhase)
+  {
+    UpdateGraph& graph = m_UpdateGraphs[uiPhase];
+    graph.m_CriticalPath.Clear();
+    graph.m_CriticalPathDuration = ezTime::MakeZero();
+    graph.m_TotalDuration = ezTime::MakeZero();
+
+    ezUInt32 uiLastFunction = ezInvalidIndex;
+
+    for (ezUInt32 i = 0; i < graph.m_Nodes.GetCount(); ++i)
+    {
+      UpdateGraph::Node& node = graph.m_Nodes[i];
+      node.m_PathDuration = ezTime::MakeZero();
+      node.m_uiCriticalDependency = ezInvalidIndex;
+
+      for (ezUInt32 d = 0; d < node.m_uiNumDependencies; ++d)
+      {
+        const ezUInt32 uiDependency = graph.m_Dependencies[node.m_uiFirstDependency + d];
+        if (node.m_uiCriticalDependency == ezInvalidIndex || graph.m_Nodes[uiDependency].m_PathDuration > node.m_PathDuration)
+        {
+          node.m_PathDuration = graph.m_Nodes[uiDependency].m_PathDuration;
+          node.m_uiCriticalDependency = uiDependency;
+        }
+      }
+
+      node.m_PathDuration += node.m_Duration;
+      graph.m_TotalDuration += node.m_Duration;
+
+      if (uiLastFunction == ezInvalidIndex || node.m_PathDuration > graph.m_CriticalPathDuration)
+      {
+        graph.m_CriticalPathDuration = node.m_PathDuration;
+        uiLastFunction = i;
+      }
+    }
+
+    for (ezUInt32 i = uiLastFunction; i != ezInvalidIndex; i = graph.m_Nodes[i].m_uiCriticalDependency)
+    {
+      graph.m_CriticalPath.PushBack(i);
+    }
+
+    // the path was collected from its end
+    for (ezUInt32 i = 0; i < graph.m_CriticalPath.GetCount() / 2; ++i)
+    {
+      ezMath::Swap(graph.m_CriticalPath[i], graph.m_CriticalPath[graph.m_CriticalPath.GetCount() - 1 - i]);
+    }
+  }
+
   void WorldData::ResourceEventHandler(const ezResourceEvent& e)
   {
     if (e.m_Type != ezResourceEvent::Type::ResourceContentUnloading)
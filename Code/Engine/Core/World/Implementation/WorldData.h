@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Communication/MessageQueue.h>
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Math/Random.h>
 #include <Foundation/Memory/FrameAllocator.h>
@@ -118,6 +119,11 @@ namespace ezInternal
 
     Hierarchy m_Hierarchies[HierarchyType::COUNT];
 
+    // Dynamic objects with a static parent are the roots of their own dynamic subtree. May contain outdated entries, which are removed during the
+    // next transform update.
+    ezHashSet<ezGameObjectHandle, ezHashHelper<ezGameObjectHandle>, ezLocalAllocatorWrapper> m_DynamicSubtreeRootCandidates;
+    ezTransformUpdateMode::Enum m_TransformUpdateMode = ezTransformUpdateMode::Default;
+
     static HierarchyType::Enum GetHierarchyType(bool bDynamic);
 
     ezGameObject::TransformationData* CreateTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel);
@@ -141,6 +147,9 @@ namespace ezInternal
     static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, ezUInt32 uiUpdateCounter, ezSpatialSystem& spatialSystem);
 
     void UpdateGlobalTransforms();
+    void CollectDynamicSubtreeRootCandidates();
+    void UpdateGlobalTransformsOfSubtrees(ezSpatialSystem* pSpatialSystem);
+    bool UpdateGlobalTransformOfSubtree(ezGameObject::TransformationData* pData, ezSpatialSystem* pSpatialSystem, bool bParentChanged);
 
     void ResourceEventHandler(const ezResourceEvent& e);
 
@@ -178,6 +187,9 @@ namespace ezInternal
     {
       ezWorldModule::UpdateFunction m_Function;
       ezHashedString m_sFunctionName;
+      ezHybridArray<ezHashedString, 4> m_DependsOn;
+      ezHybridArray<const ezRTTI*, 2> m_ReadsComponentTypes;
+      ezHybridArray<const ezRTTI*, 2> m_WritesComponentTypes;
       float m_fPriority;
       ezUInt16 m_uiGranularity;
       bool m_bOnlyUpdateWhenSimulating;
@@ -200,6 +212,47 @@ namespace ezInternal
 
     ezDynamicArray<ezSharedPtr<UpdateTask>, ezLocalAllocatorWrapper> m_UpdateTasks;
 
+    struct UpdateGraphTask final : public ezTask
+    {
+      virtual void Execute() override;
+
+      WorldData* m_pData = nullptr;
+      ezUInt32 m_uiPhase = 0;
+      ezUInt32 m_uiFunctionIndex = 0;
+    };
+
+    /// \brief Dependencies between the update functions of a synchronous phase. A function depends on all functions it names in
+    /// m_DependsOn and on all earlier functions with conflicting component access. Redundant dependencies are removed.
+    struct UpdateGraph
+    {
+      struct Node
+      {
+        ezUInt32 m_uiFirstDependency = 0;
+        ezUInt32 m_uiNumDependencies = 0;
+        bool m_bExclusive = false;
+
+        ezTime m_Duration;
+        ezTime m_PathDuration; ///< Duration of the longest chain of dependencies that ends with this function.
+        ezUInt32 m_uiCriticalDependency = ezInvalidIndex;
+      };
+
+      ezDynamicArray<Node, ezLocalAllocatorWrapper> m_Nodes;
+      ezDynamicArray<ezUInt32, ezLocalAllocatorWrapper> m_Dependencies;
+      ezDynamicArray<ezSharedPtr<UpdateGraphTask>, ezLocalAllocatorWrapper> m_Tasks;
+      bool m_bIsDirty = true;
+      bool m_bHasConcurrentFunctions = false;
+
+      ezDynamicArray<ezUInt32, ezLocalAllocatorWrapper> m_CriticalPath;
+      ezTime m_CriticalPathDuration;
+      ezTime m_TotalDuration;
+    };
+
+    UpdateGraph m_UpdateGraphs[ezWorldModule::UpdateFunctionDesc::Phase::COUNT];
+
+    void BuildUpdateGraph(ezUInt32 uiPhase);
+    void ExecuteUpdateFunction(ezUInt32 uiPhase, ezUInt32 uiFunctionIndex);
+    void UpdateCriticalPath(ezUInt32 uiPhase);
+
     ezUniquePtr<ezSpatialSystem> m_pSpatialSystem;
     ezSharedPtr<ezCoordinateSystemProvider> m_pCoordinateSystemProvider;
     ezUniquePtr<ezTimeStepSmoothing> m_pTimeStepSmoothing;
@@ -232,8 +285,27 @@ namespace ezInternal
     };
 
     using MessageQueue = ezMessageQueue<QueuedMsgMetaData, ezLocalAllocatorWrapper>;
-    mutable MessageQueue m_MessageQueues[ezObjectMsgQueueType::COUNT];
+    MessageQueue m_MessageQueues[ezObjectMsgQueueType::COUNT];
     mutable MessageQueue m_TimedMessageQueues[ezObjectMsgQueueType::COUNT];
+
+    /// \brief Messages without delay that were posted by one thread. Only the owning thread adds messages, thus no lock is needed.
+    /// The buffers of all threads are merged into m_MessageQueues right before a queue is processed. The queue is sorted by the message
+    /// content afterwards, thus the processing order does not depend on which thread posted a message first.
+    struct ThreadMessageBuffer
+    {
+      ThreadMessageBuffer(ezStringView sName, ezAllocatorBase* pParent);
+
+      ezDoubleBufferedStackAllocator m_StackAllocator;
+      ezDynamicArray<MessageQueue::Entry> m_Messages[ezObjectMsgQueueType::COUNT];
+    };
+
+    void EnqueueMessage(ezUInt32 uiWorldIndex, const ezMessage& msg, const QueuedMsgMetaData& metaData, ezObjectMsgQueueType::Enum queueType) const;
+    void MergeThreadMessageBuffers(ezObjectMsgQueueType::Enum queueType);
+    void SwapThreadMessageBuffers();
+
+    ezUInt64 m_uiThreadMessageBuffersId = 0; ///< Identifies this world instance in the thread local buffer caches.
+    mutable ezMutex m_ThreadMessageBuffersMutex;
+    mutable ezDynamicArray<ezUniquePtr<ThreadMessageBuffer>, ezLocalAllocatorWrapper> m_ThreadMessageBuffers;
     ezObjectMsgQueueType::Enum m_ProcessingMessageQueue = ezObjectMsgQueueType::COUNT;
 
     ezThreadID m_WriteThreadID;
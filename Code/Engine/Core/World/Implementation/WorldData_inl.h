@@ -195,6 +195,9 @@ namespace ezInternal
   {
     m_Function = desc.m_Function;
     m_sFunctionName = desc.m_sFunctionName;
+    m_DependsOn = desc.m_DependsOn;
+    m_ReadsComponentTypes = desc.m_ReadsComponentTypes;
+    m_WritesComponentTypes = desc.m_WritesComponentTypes;
     m_fPriority = desc.m_fPriority;
     m_uiGranularity = desc.m_uiGranularity;
     m_bOnlyUpdateWhenSimulating = desc.m_bOnlyUpdateWhenSimulating;
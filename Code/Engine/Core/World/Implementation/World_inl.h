@@ -398,6 +398,11 @@ EZ_ALWAYS_INLINE ezUInt32 ezWorld::GetUpdateCounter() const
   return m_Data.m_uiUpdateCounter;
 }
 
+EZ_ALWAYS_INLINE ezTransformUpdateMode::Enum ezWorld::GetTransformUpdateMode() const
+{
+  return m_Data.m_TransformUpdateMode;
+}
+
 EZ_FORCE_INLINE ezSpatialSystem* ezWorld::GetSpatialSystem()
 {
   CheckForWriteAccess();
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+#include <Foundation/Containers/IdTable.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+
+/// \brief A spatial system that stores all spatial data in a single bounding volume hierarchy with four children per node.
+///
+/// The bounds of the four children of a node are stored in SIMD friendly structure-of-arrays layout, so every traversal step
+/// tests all four children against the query shape at once. Each child additionally stores the union of the category bitmasks
+/// of everything below it, so queries for a specific category skip unrelated subtrees early.
+///
+/// Moving objects only refit the bounds of the affected nodes, which is deferred and done in one bottom-up pass before the next query.
+/// New objects are inserted incrementally where they increase the surface area the least. Since refitting and incremental insertion degrade
+/// the tree quality over time, the whole tree is rebuilt in StartNewFrame() once its surface area cost has grown by more than 'Spatial.BVH.RebuildThreshold'
+/// compared to the last build, or once a large part of the objects has been added or removed since then.
+///
+/// Unlike ezSpatialSystem_RegularGrid this works without any assumption on object sizes, which makes it a better fit for worlds
+/// where tiny objects are mixed with very large ones.
+class EZ_CORE_DLL ezSpatialSystem_BVH : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_BVH, ezSpatialSystem);
+
+public:
+  ezSpatialSystem_BVH();
+  ~ezSpatialSystem_BVH();
+
+  /// \brief Returns the bounding boxes of all inner nodes of the hierarchy up to the given depth. Useful for debug visualizations.
+  void GetAllNodeBoxes(ezDynamicArray<ezBoundingBox>& out_boundingBoxes, ezUInt32 uiMaxDepth = ezInvalidIndex) const;
+
+  /// \brief Returns how often the tree has been rebuilt from scratch so far.
+  ezUInt32 GetNumRebuilds() const { return m_uiNumRebuilds; }
+
+private:
+  struct NodeUtils;
+  struct BuildEntry;
+
+  // ezSpatialSystem implementation
+  virtual void StartNewFrame() override;
+
+  ezSpatialDataHandle CreateSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+  ezSpatialDataHandle CreateSpatialDataAlwaysVisible(ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags) override;
+
+  void DeleteSpatialData(const ezSpatialDataHandle& hData) override;
+
+  void UpdateSpatialDataBounds(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds) override;
+  void UpdateSpatialDataObject(const ezSpatialDataHandle& hData, ezGameObject* pObject) override;
+
+  void FindObjectsInSphere(const ezBoundingSphere& sphere, const QueryParams& queryParams, QueryCallback callback) const override;
+  void FindObjectsInBox(const ezBoundingBox& box, const QueryParams& queryParams, QueryCallback callback) const override;
+
+  void FindVisibleObjects(const ezFrustum& frustum, const QueryParams& queryParams, ezDynamicArray<const ezGameObject*>& out_Objects, ezSpatialSystem::IsOccludedFunc IsOccluded, ezVisibilityState visType) const override;
+
+  ezVisibilityState GetVisibilityState(const ezSpatialDataHandle& hData, ezUInt32 uiNumFramesBeforeInvisible) const override;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  virtual void GetInternalStats(ezStringBuilder& sb) const override;
+#endif
+
+  enum
+  {
+    NUM_SLOTS = 4,
+    OBJECT_FLAG = 0x80000000, ///< Set on the child index of a slot if it references spatial data instead of another node.
+  };
+
+  /// \brief A node of the hierarchy. Each of the four slots either references another node or spatial data.
+  ///
+  /// Unused slots always come after the used ones, have an inverted bounding box and a category bitmask of zero.
+  struct Node
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_MinX[NUM_SLOTS];
+    float m_MinY[NUM_SLOTS];
+    float m_MinZ[NUM_SLOTS];
+    float m_MaxX[NUM_SLOTS];
+    float m_MaxY[NUM_SLOTS];
+    float m_MaxZ[NUM_SLOTS];
+    ezUInt32 m_CategoryBitmasks[NUM_SLOTS];
+    ezUInt32 m_Children[NUM_SLOTS];
+
+    ezUInt32 m_uiParentIndex; ///< Always smaller than the index of the node itself, which allows to refit the tree in one backwards pass.
+    ezUInt8 m_uiParentSlot;
+    ezUInt8 m_uiNumChildren;
+  };
+
+  struct Data
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezGameObject* m_pObject;
+    ezUInt32 m_uiCategoryBitmask;
+    ezUInt32 m_uiNodeIndex; ///< ezInvalidIndex for always visible data, which is not stored in the tree.
+    ezUInt32 m_uiSlot;
+  };
+
+  ezProxyAllocator m_AlignedAllocator;
+
+  ezIdTable<ezSpatialDataId, Data, ezLocalAllocatorWrapper> m_DataTable;
+
+  // Indexed by the instance index of the spatial data id
+  ezDynamicArray<ezSimdBBoxSphere> m_DataBounds;
+  ezDynamicArray<ezTagSet> m_DataTags;
+  mutable ezDynamicArray<ezAtomicInteger64> m_DataLastVisibleFrameIdxAndVisType;
+
+  ezDynamicArray<ezUInt32> m_AlwaysVisibleData;
+
+  // Both are refitted lazily by the first query after bounds have changed
+  mutable ezDynamicArray<Node> m_Nodes;
+  mutable ezDynamicArray<ezUInt64> m_DirtyNodes; ///< One bit per node whose children changed their bounds since the last refit.
+
+  mutable ezMutex m_RefitMutex;
+  mutable ezAtomicBool m_bNeedsRefit;
+  bool m_bCostCheckNeeded = false;
+
+  ezUInt32 m_uiNumUnusedNodes = 0;
+  ezUInt32 m_uiNumChangesSinceRebuild = 0;
+  ezUInt32 m_uiNumRebuilds = 0;
+  float m_fCostAfterRebuild = 0.0f;
+
+  ezSpatialDataHandle AddSpatialData(const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask, const ezTagSet& tags, bool bAlwaysVisible);
+
+  ezUInt32 AllocateNode();
+  void AttachChild(ezUInt32 uiNodeIndex, ezUInt32 uiSlot, ezUInt32 uiChild);
+  void SetSlot(ezUInt32 uiNodeIndex, ezUInt32 uiSlot, ezUInt32 uiChild, const ezSimdBBox& box, ezUInt32 uiCategoryBitmask);
+  void MarkDirty(ezUInt32 uiNodeIndex);
+
+  void InsertIntoTree(ezUInt32 uiDataIndex, ezUInt32 uiCategoryBitmask);
+  void RemoveFromTree(ezUInt32 uiNodeIndex, ezUInt32 uiSlot);
+
+  void EnsureRefitted() const;
+  void Refit() const;
+
+  float ComputeCost() const;
+  void Rebuild();
+  void BuildNode(ezUInt32 uiNodeIndex, ezArrayPtr<BuildEntry> entries);
+
+  template <typename NodeTest, typename DataVisitor>
+  void TraverseTree(ezUInt32 uiCategoryBitmask, NodeTest nodeTest, DataVisitor dataVisitor) const;
+
+  template <typename Functor>
+  ezVisitorExecution::Enum ForEachAlwaysVisibleData(const QueryParams& queryParams, Functor func) const;
+};
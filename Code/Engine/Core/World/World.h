@@ -18,6 +18,11 @@ class ezEventMessageHandlerComponent;
 /// * Actual deletion of dead objects and components are done now.
 /// * Transform update: The global transformation of dynamic objects is updated.
 /// * Post-transform phase: Another synchronous phase like the pre-async phase after the transformation has been updated.
+///
+/// Synchronous update functions that declare which component types they read and write (see
+/// ezWorldModule::UpdateFunctionDesc::m_ReadsComponentTypes) are executed concurrently with all other functions of the same phase that
+/// they neither depend on nor share written component types with. These functions run under the same restrictions as functions in the
+/// async phase. Functions without declarations still run alone on the updating thread, in the order of their dependencies and priorities.
 class EZ_CORE_DLL ezWorld final
 {
 public:
@@ -248,6 +253,14 @@ public:
   /// \brief If enabled, the full simulation should be executed, otherwise only the rendering related updates should be done
   bool GetWorldSimulationEnabled() const;
 
+  /// \brief Sets how the global transforms of dynamic objects are updated, see ezTransformUpdateMode.
+  ///
+  /// ezTransformUpdateMode::ChangedSubtrees relies on all transform and bounds changes going through the ezGameObject interface.
+  void SetTransformUpdateMode(ezTransformUpdateMode::Enum mode);
+
+  /// \brief Returns how the global transforms of dynamic objects are updated.
+  ezTransformUpdateMode::Enum GetTransformUpdateMode() const;
+
   /// \brief Updates the world by calling the various update methods on the component managers and also updates the transformation data of
   /// the game objects. See ezWorld for a detailed description of the update phases.
   void Update();
@@ -255,6 +268,13 @@ public:
   /// \brief Returns a task implementation that calls Update on this world.
   const ezSharedPtr<ezTask>& GetUpdateTask();
 
+  /// \brief Returns the names of the synchronous update functions of the given phase that formed the longest chain of dependent functions
+  /// in the last update, and the time this chain took.
+  ///
+  /// The chain is the lower bound for the duration of the phase, no matter how many functions are executed concurrently.
+  /// Set the cvar 'World.LogCriticalUpdatePath' to log it for all phases once per frame.
+  ezTime GetCriticalUpdatePath(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase, ezDynamicArray<ezHashedString>& out_functionNames) const;
+
   /// \brief Returns the number of update calls. Can be used to determine whether an operation has already been done during a frame.
   ezUInt32 GetUpdateCounter() const;
 
@@ -380,6 +400,7 @@ private:
 
   void PostMessage(const ezGameObjectHandle& receiverObject, const ezMessage& msg, ezObjectMsgQueueType::Enum queueType, ezTime delay, bool bRecursive) const;
   void ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::Entry& entry);
+  void ProcessQueuedComponentMessages(const ezInternal::WorldData::MessageQueue& queue, ezUInt32 uiFirstEntry, ezUInt32 uiEndEntry);
   void ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType);
 
   template <typename World, typename GameObject, typename Component>
@@ -393,7 +414,8 @@ private:
   void AddComponentToInitialize(ezComponentHandle hComponent);
 
   void UpdateFromThread();
-  void UpdateSynchronous(const ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions);
+  void UpdateSynchronous(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase);
+  void UpdateConcurrently(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase, ezUInt32 uiFirstFunction, ezUInt32 uiEndFunction);
   void UpdateAsynchronous();
 
   // returns if the batch was completely initialized
@@ -21,11 +21,14 @@ struct ezWorldDesc
 
   ezUniquePtr<ezSpatialSystem> m_pSpatialSystem;
   bool m_bAutoCreateSpatialSystem = true; ///< automatically create a default spatial system if none is set
+  ezSpatialSystemType::Enum m_SpatialSystemType = ezSpatialSystemType::Default; ///< the type of spatial system that is created automatically
 
   ezSharedPtr<ezCoordinateSystemProvider> m_pCoordinateSystemProvider;
   ezUniquePtr<ezTimeStepSmoothing> m_pTimeStepSmoothing; ///< if nullptr, ezDefaultTimeStepSmoothing will be used
 
   bool m_bReportErrorWhenStaticObjectMoves = true;
 
+  ezTransformUpdateMode::Enum m_TransformUpdateMode = ezTransformUpdateMode::Default; ///< see ezWorld::SetTransformUpdateMode()
+
   ezTime m_MaxComponentInitializationTimePerFrame = ezTime::MakeFromHours(10000); // max time to spend on component initialization per frame
 };
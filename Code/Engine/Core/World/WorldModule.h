@@ -68,6 +68,9 @@ protected:
                                                   ///< with the correct name.
     ezHybridArray<ezHashedString, 4> m_DependsOn; ///< Array of other functions on which this function depends on. This function will be
                                                   ///< called after all its dependencies have been called.
+    ezHybridArray<const ezRTTI*, 2> m_ReadsComponentTypes;  ///< Component types that this function reads. Only used by the synchronous phases, see ezWorld.
+    ezHybridArray<const ezRTTI*, 2> m_WritesComponentTypes; ///< Component types that this function modifies. If neither reads nor writes are declared,
+                                                            ///< the function is assumed to access the entire world and is never called concurrently.
     ezEnum<Phase> m_Phase;                        ///< The update phase in which this update function should be called. See ezWorld for a description on the
                                                   ///< different phases.
     bool m_bOnlyUpdateWhenSimulating = false;     ///< The update function is only called when the world simulation is enabled.
@@ -0,0 +1,324 @@
+#pragma once
+
+inline ezUInt32 ezParallelSorting::DetermineNumBlocks(ezUInt32 uiCount)
+{
+  // one block per thread (the calling thread helps as well), but keep the blocks large enough to be worth a task
+  const ezUInt32 uiNumThreads = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1;
+  return ezMath::Clamp(uiCount / (PARALLEL_THRESHOLD / 4), 1u, uiNumThreads);
+}
+
+template <typename T, typename Comparer>
+ezUInt32 ezParallelSorting::MergeCoRank(ezUInt32 uiOutputIndex, const T* pLeft, ezUInt32 uiLeftCount, const T* pRight, ezUInt32 uiRightCount, const Comparer& comparer)
+{
+  // Returns how many elements of the left range end up in the first uiOutputIndex elements of the merged result.
+  // Taking i elements from the left is too many, if the last one of them would be placed after the first right element that is not taken.
+  ezUInt32 uiLow = uiOutputIndex > uiRightCount ? uiOutputIndex - uiRightCount : 0;
+  ezUInt32 uiHigh = ezMath::Min(uiOutputIndex, uiLeftCount);
+
+  while (uiLow < uiHigh)
+  {
+    const ezUInt32 i = (uiLow + uiHigh + 1) / 2;
+    const ezUInt32 j = uiOutputIndex - i;
+
+    if (j < uiRightCount && ezSorting::DoCompare(comparer, pRight[j], pLeft[i - 1]))
+      uiHigh = i - 1;
+    else
+      uiLow = i;
+  }
+
+  return uiLow;
+}
+
+template <typename T, typename Comparer>
+void ezParallelSorting::Sort(ezArrayPtr<T>& inout_arrayPtr, const Comparer& comparer, ezAllocatorBase* pTempAllocator)
+{
+  const ezUInt32 uiCount = inout_arrayPtr.GetCount();
+  const ezUInt32 uiNumBlocks = DetermineNumBlocks(uiCount);
+
+  if (uiCount < PARALLEL_THRESHOLD || uiNumBlocks <= 1)
+  {
+    ezSorting::QuickSort(inout_arrayPtr, comparer);
+    return;
+  }
+
+  EZ_PROFILE_SCOPE("ezParallelSorting::Sort");
+
+  ezDynamicArray<T> temp(pTempAllocator != nullptr ? pTempAllocator : ezFoundation::GetDefaultAllocator());
+  temp.SetCount(uiCount);
+
+  struct Context
+  {
+    const Comparer* m_pComparer;
+    T* m_pSource;
+    T* m_pTarget;
+    ezUInt32 m_uiCount;
+    ezUInt32 m_uiRunLength;
+    ezUInt32 m_uiPartsPerMerge;
+  };
+
+  Context ctxt{&comparer, inout_arrayPtr.GetPtr(), temp.GetData(), uiCount, (uiCount + uiNumBlocks - 1) / uiNumBlocks, 1};
+
+  ezParallelForParams params;
+  params.m_uiBinSize = 1;
+  params.m_uiMaxTasksPerThread = 1;
+
+  // sort every block on its own
+  ezTaskSystem::ParallelForIndexed(
+    0u, uiNumBlocks,
+    [pCtxt = &ctxt](ezUInt32 uiFirstBlock, ezUInt32 uiEndBlock)
+    {
+      for (ezUInt32 uiBlock = uiFirstBlock; uiBlock < uiEndBlock; ++uiBlock)
+      {
+        const ezUInt32 uiStart = uiBlock * pCtxt->m_uiRunLength;
+        const ezUInt32 uiEnd = ezMath::Min(uiStart + pCtxt->m_uiRunLength, pCtxt->m_uiCount);
+
+        if (uiStart < uiEnd)
+        {
+          ezArrayPtr<T> block(pCtxt->m_pSource + uiStart, uiEnd - uiStart);
+          ezSorting::QuickSort(block, *pCtxt->m_pComparer);
+        }
+      }
+    },
+    "ParallelSort Blocks", params);
+
+  // merge neighboring runs until there is only one left
+  while (ctxt.m_uiRunLength < uiCount)
+  {
+    const ezUInt32 uiNumMerges = (uiCount + 2 * ctxt.m_uiRunLength - 1) / (2 * ctxt.m_uiRunLength);
+
+    // split every merge into several parts, so that the last merges still keep all threads busy
+    ctxt.m_uiPartsPerMerge = ezMath::Max(1u, uiNumBlocks / uiNumMerges);
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, uiNumMerges * ctxt.m_uiPartsPerMerge,
+      [pCtxt = &ctxt](ezUInt32 uiFirstPart, ezUInt32 uiEndPart)
+      {
+        for (ezUInt32 uiPart = uiFirstPart; uiPart < uiEndPart; ++uiPart)
+        {
+          const ezUInt32 uiMerge = uiPart / pCtxt->m_uiPartsPerMerge;
+          const ezUInt32 uiPartInMerge = uiPart % pCtxt->m_uiPartsPerMerge;
+
+          const ezUInt32 uiStart = uiMerge * 2 * pCtxt->m_uiRunLength;
+          const ezUInt32 uiMiddle = ezMath::Min(uiStart + pCtxt->m_uiRunLength, pCtxt->m_uiCount);
+          const ezUInt32 uiEnd = ezMath::Min(uiMiddle + pCtxt->m_uiRunLength, pCtxt->m_uiCount);
+
+          T* pLeft = pCtxt->m_pSource + uiStart;
+          T* pRight = pCtxt->m_pSource + uiMiddle;
+          const ezUInt32 uiLeftCount = uiMiddle - uiStart;
+          const ezUInt32 uiRightCount = uiEnd - uiMiddle;
+          const ezUInt32 uiMergedCount = uiEnd - uiStart;
+
+          const ezUInt32 uiOutStart = (ezUInt32)((ezUInt64)uiMergedCount * uiPartInMerge / pCtxt->m_uiPartsPerMerge);
+          const ezUInt32 uiOutEnd = (ezUInt32)((ezUInt64)uiMergedCount * (uiPartInMerge + 1) / pCtxt->m_uiPartsPerMerge);
+
+          ezUInt32 i = MergeCoRank(uiOutStart, pLeft, uiLeftCount, pRight, uiRightCount, *pCtxt->m_pComparer);
+          ezUInt32 j = uiOutStart - i;
+          const ezUInt32 uiLeftEnd = MergeCoRank(uiOutEnd, pLeft, uiLeftCount, pRight, uiRightCount, *pCtxt->m_pComparer);
+          const ezUInt32 uiRightEnd = uiOutEnd - uiLeftEnd;
+
+          T* pTarget = pCtxt->m_pTarget + uiStart + uiOutStart;
+
+          while (i < uiLeftEnd && j < uiRightEnd)
+          {
+            if (ezSorting::DoCompare(*pCtxt->m_pComparer, pRight[j], pLeft[i]))
+              *pTarget++ = std::move(pRight[j++]);
+            else
+              *pTarget++ = std::move(pLeft[i++]);
+          }
+
+          while (i < uiLeftEnd)
+            *pTarget++ = std::move(pLeft[i++]);
+
+          while (j < uiRightEnd)
+            *pTarget++ = std::move(pRight[j++]);
+        }
+      },
+      "ParallelSort Merge", params);
+
+    ezMath::Swap(ctxt.m_pSource, ctxt.m_pTarget);
+    ctxt.m_uiRunLength *= 2;
+  }
+
+  if (ctxt.m_pSource != inout_arrayPtr.GetPtr())
+  {
+    ezTaskSystem::ParallelForIndexed(
+      0u, uiCount,
+      [pCtxt = &ctxt](ezUInt32 uiStart, ezUInt32 uiEnd)
+      {
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          pCtxt->m_pTarget[i] = std::move(pCtxt->m_pSource[i]);
+        }
+      },
+      "ParallelSort Copy");
+  }
+}
+
+template <typename T, typename KeyFunc>
+void ezParallelSorting::RadixSort(ezArrayPtr<T>& inout_arrayPtr, KeyFunc getKey, ezAllocatorBase* pTempAllocator)
+{
+  using KeyType = std::decay_t<decltype(getKey(*inout_arrayPtr.GetPtr()))>;
+  static_assert(std::is_unsigned<KeyType>::value, "The radix sort key must be an unsigned integer. Use ezSorting::ToRadixKey() to convert other types.");
+  static_assert(ezGetTypeClass<T>::value != ezTypeIsClass::value, "RadixSort moves elements as raw memory, T must be a POD or memory relocatable type.");
+
+  const ezUInt32 uiCount = inout_arrayPtr.GetCount();
+  if (uiCount <= 1)
+    return;
+
+  ezAllocatorBase* pAllocator = pTempAllocator != nullptr ? pTempAllocator : ezFoundation::GetDefaultAllocator();
+  T* pTemp = EZ_NEW_RAW_BUFFER(pAllocator, T, uiCount);
+  EZ_SCOPE_EXIT(EZ_DELETE_RAW_BUFFER(pAllocator, pTemp));
+
+  const ezUInt32 uiNumBlocks = DetermineNumBlocks(uiCount);
+
+  if (uiCount < PARALLEL_THRESHOLD || uiNumBlocks <= 1)
+  {
+    ezSorting::RadixSort(inout_arrayPtr, ezMakeArrayPtr(pTemp, uiCount), getKey);
+    return;
+  }
+
+  EZ_PROFILE_SCOPE("ezParallelSorting::RadixSort");
+
+  constexpr ezUInt32 uiNumDigits = sizeof(KeyType);
+
+  struct Context
+  {
+    KeyFunc* m_pGetKey;
+    T* m_pData;
+    T* m_pTemp;
+    ezUInt32 m_uiCount;
+    ezUInt32 m_uiItemsPerBlock;
+    ezUInt32 m_uiShift;
+    ezUInt32* m_pHistograms; ///< 256 counters per digit and block.
+    ezUInt32 m_BucketStart[257];
+  };
+
+  ezDynamicArray<ezUInt32> histograms(pAllocator);
+  histograms.SetCount(uiNumBlocks * uiNumDigits * 256);
+
+  Context ctxt;
+  ctxt.m_pGetKey = &getKey;
+  ctxt.m_pData = inout_arrayPtr.GetPtr();
+  ctxt.m_pTemp = pTemp;
+  ctxt.m_uiCount = uiCount;
+  ctxt.m_uiItemsPerBlock = (uiCount + uiNumBlocks - 1) / uiNumBlocks;
+  ctxt.m_uiShift = 0;
+  ctxt.m_pHistograms = histograms.GetData();
+
+  ezParallelForParams params;
+  params.m_uiBinSize = 1;
+  params.m_uiMaxTasksPerThread = 1;
+
+  // histograms of all digits, per block
+  ezTaskSystem::ParallelForIndexed(
+    0u, uiNumBlocks,
+    [pCtxt = &ctxt](ezUInt32 uiFirstBlock, ezUInt32 uiEndBlock)
+    {
+      for (ezUInt32 uiBlock = uiFirstBlock; uiBlock < uiEndBlock; ++uiBlock)
+      {
+        const ezUInt32 uiStart = uiBlock * pCtxt->m_uiItemsPerBlock;
+        const ezUInt32 uiEnd = ezMath::Min(uiStart + pCtxt->m_uiItemsPerBlock, pCtxt->m_uiCount);
+        ezUInt32* pHistogram = pCtxt->m_pHistograms + uiBlock * uiNumDigits * 256;
+
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          const KeyType key = (*pCtxt->m_pGetKey)(pCtxt->m_pData[i]);
+
+          for (ezUInt32 uiDigit = 0; uiDigit < uiNumDigits; ++uiDigit)
+          {
+            ++pHistogram[uiDigit * 256 + ((key >> (uiDigit * 8)) & 0xFF)];
+          }
+        }
+      }
+    },
+    "ParallelRadixSort Histogram", params);
+
+  // find the most significant digit in which the keys differ
+  const KeyType firstKey = getKey(inout_arrayPtr[0]);
+  ezInt32 iMsdDigit = uiNumDigits - 1;
+  for (; iMsdDigit >= 0; --iMsdDigit)
+  {
+    const ezUInt32 uiFirstBucket = (firstKey >> (iMsdDigit * 8)) & 0xFF;
+
+    ezUInt32 uiBucketCount = 0;
+    for (ezUInt32 uiBlock = 0; uiBlock < uiNumBlocks; ++uiBlock)
+    {
+      uiBucketCount += histograms[(uiBlock * uiNumDigits + iMsdDigit) * 256 + uiFirstBucket];
+    }
+
+    if (uiBucketCount != uiCount)
+      break;
+  }
+
+  // all keys are identical
+  if (iMsdDigit < 0)
+    return;
+
+  // turn the block histograms of the MSD into scatter offsets, blocks with a lower index go first to keep the sort stable
+  ctxt.m_uiShift = iMsdDigit * 8;
+  ezUInt32 uiOffset = 0;
+  for (ezUInt32 uiBucket = 0; uiBucket < 256; ++uiBucket)
+  {
+    ctxt.m_BucketStart[uiBucket] = uiOffset;
+
+    for (ezUInt32 uiBlock = 0; uiBlock < uiNumBlocks; ++uiBlock)
+    {
+      ezUInt32& uiBlockCount = histograms[(uiBlock * uiNumDigits + iMsdDigit) * 256 + uiBucket];
+      const ezUInt32 uiBlockBucketSize = uiBlockCount;
+      uiBlockCount = uiOffset;
+      uiOffset += uiBlockBucketSize;
+    }
+  }
+  ctxt.m_BucketStart[256] = uiOffset;
+
+  ezTaskSystem::ParallelForIndexed(
+    0u, uiNumBlocks,
+    [pCtxt = &ctxt, iMsdDigit](ezUInt32 uiFirstBlock, ezUInt32 uiEndBlock)
+    {
+      for (ezUInt32 uiBlock = uiFirstBlock; uiBlock < uiEndBlock; ++uiBlock)
+      {
+        const ezUInt32 uiStart = uiBlock * pCtxt->m_uiItemsPerBlock;
+        const ezUInt32 uiEnd = ezMath::Min(uiStart + pCtxt->m_uiItemsPerBlock, pCtxt->m_uiCount);
+        ezUInt32* pOffsets = pCtxt->m_pHistograms + (uiBlock * uiNumDigits + iMsdDigit) * 256;
+
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          const ezUInt32 uiBucket = ((*pCtxt->m_pGetKey)(pCtxt->m_pData[i]) >> pCtxt->m_uiShift) & 0xFF;
+          ezMemoryUtils::RawByteCopy(pCtxt->m_pTemp + pOffsets[uiBucket]++, pCtxt->m_pData + i, sizeof(T));
+        }
+      }
+    },
+    "ParallelRadixSort Scatter", params);
+
+  // the buckets can be very different in size, so allow more tasks for better balancing
+  ezParallelForParams bucketParams;
+  bucketParams.m_uiBinSize = 1;
+  bucketParams.m_uiMaxTasksPerThread = 4;
+
+  ezTaskSystem::ParallelForIndexed(
+    0u, 256u,
+    [pCtxt = &ctxt](ezUInt32 uiFirstBucket, ezUInt32 uiEndBucket)
+    {
+      for (ezUInt32 uiBucket = uiFirstBucket; uiBucket < uiEndBucket; ++uiBucket)
+      {
+        const ezUInt32 uiStart = pCtxt->m_BucketStart[uiBucket];
+        const ezUInt32 uiBucketSize = pCtxt->m_BucketStart[uiBucket + 1] - uiStart;
+
+        if (uiBucketSize == 0)
+          continue;
+
+        // the remaining digits are sorted in the temp storage, the original array serves as scratch memory
+        ezArrayPtr<T> bucket(pCtxt->m_pTemp + uiStart, uiBucketSize);
+        ezSorting::RadixSort(bucket, ezArrayPtr<T>(pCtxt->m_pData + uiStart, uiBucketSize), *pCtxt->m_pGetKey);
+
+        ezMemoryUtils::RawByteCopy(pCtxt->m_pData + uiStart, pCtxt->m_pTemp + uiStart, uiBucketSize * sizeof(T));
+      }
+    },
+    "ParallelRadixSort Buckets", bucketParams);
+}
+
+template <typename T>
+void ezParallelSorting::RadixSort(ezArrayPtr<T>& inout_arrayPtr, ezAllocatorBase* pTempAllocator)
+{
+  RadixSort(inout_arrayPtr, [](const T& value) { return ezSorting::ToRadixKey(value); }, pTempAllocator);
+}
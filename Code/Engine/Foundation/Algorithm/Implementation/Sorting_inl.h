@@ -35,6 +35,102 @@ void ezSorting::InsertionSort(ezArrayPtr<T>& inout_arrayPtr, const Comparer& com
   InsertionSort(inout_arrayPtr, 0, inout_arrayPtr.GetCount() - 1, comparer);
 }
 
+template <typename T, typename KeyFunc>
+void ezSorting::RadixSort(ezArrayPtr<T>& inout_arrayPtr, ezArrayPtr<T> tempStorage, KeyFunc getKey)
+{
+  using KeyType = std::decay_t<decltype(getKey(*inout_arrayPtr.GetPtr()))>;
+  static_assert(std::is_unsigned<KeyType>::value, "The radix sort key must be an unsigned integer. Use ezSorting::ToRadixKey() to convert other types.");
+  static_assert(ezGetTypeClass<T>::value != ezTypeIsClass::value, "RadixSort moves elements as raw memory, T must be a POD or memory relocatable type.");
+
+  const ezUInt32 uiCount = inout_arrayPtr.GetCount();
+  if (uiCount <= 1)
+    return;
+
+  EZ_ASSERT_DEV(tempStorage.GetCount() >= uiCount, "The temp storage needs to hold at least {0} elements, but only has room for {1}", uiCount, tempStorage.GetCount());
+
+  constexpr ezUInt32 uiNumDigits = sizeof(KeyType);
+
+  T* pSrc = inout_arrayPtr.GetPtr();
+  T* pDst = tempStorage.GetPtr();
+
+  // build the histograms for all digits in one go, to only read the data once
+  ezUInt32 histograms[uiNumDigits][256] = {};
+  for (ezUInt32 i = 0; i < uiCount; ++i)
+  {
+    const KeyType key = getKey(pSrc[i]);
+
+    for (ezUInt32 uiDigit = 0; uiDigit < uiNumDigits; ++uiDigit)
+    {
+      ++histograms[uiDigit][(key >> (uiDigit * 8)) & 0xFF];
+    }
+  }
+
+  for (ezUInt32 uiDigit = 0; uiDigit < uiNumDigits; ++uiDigit)
+  {
+    ezUInt32* pOffsets = histograms[uiDigit];
+    const ezUInt32 uiShift = uiDigit * 8;
+
+    // all keys have the same value in this digit, a pass would not change anything
+    if (pOffsets[(getKey(pSrc[0]) >> uiShift) & 0xFF] == uiCount)
+      continue;
+
+    ezUInt32 uiOffset = 0;
+    for (ezUInt32 uiBucket = 0; uiBucket < 256; ++uiBucket)
+    {
+      const ezUInt32 uiBucketSize = pOffsets[uiBucket];
+      pOffsets[uiBucket] = uiOffset;
+      uiOffset += uiBucketSize;
+    }
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      const ezUInt32 uiBucket = (getKey(pSrc[i]) >> uiShift) & 0xFF;
+      ezMemoryUtils::RawByteCopy(pDst + pOffsets[uiBucket]++, pSrc + i, sizeof(T));
+    }
+
+    ezMath::Swap(pSrc, pDst);
+  }
+
+  if (pSrc != inout_arrayPtr.GetPtr())
+  {
+    ezMemoryUtils::RawByteCopy(inout_arrayPtr.GetPtr(), pSrc, uiCount * sizeof(T));
+  }
+}
+
+template <typename T>
+void ezSorting::RadixSort(ezArrayPtr<T>& inout_arrayPtr, ezArrayPtr<T> tempStorage)
+{
+  RadixSort(inout_arrayPtr, tempStorage, [](const T& value) { return ToRadixKey(value); });
+}
+
+inline ezUInt32 ezSorting::ToRadixKey(ezInt32 iValue)
+{
+  // flipping the sign bit moves the negative numbers in front of the positive ones
+  return static_cast<ezUInt32>(iValue) ^ 0x80000000u;
+}
+
+inline ezUInt64 ezSorting::ToRadixKey(ezInt64 iValue)
+{
+  return static_cast<ezUInt64>(iValue) ^ 0x8000000000000000ull;
+}
+
+inline ezUInt32 ezSorting::ToRadixKey(float fValue)
+{
+  ezUInt32 uiBits;
+  ezMemoryUtils::RawByteCopy(&uiBits, &fValue, sizeof(uiBits));
+
+  // positive floats sort like integers once the sign bit is set, negative ones need all bits flipped to reverse their order
+  return (uiBits & 0x80000000u) ? ~uiBits : (uiBits | 0x80000000u);
+}
+
+inline ezUInt64 ezSorting::ToRadixKey(double fValue)
+{
+  ezUInt64 uiBits;
+  ezMemoryUtils::RawByteCopy(&uiBits, &fValue, sizeof(uiBits));
+
+  return (uiBits & 0x8000000000000000ull) ? ~uiBits : (uiBits | 0x8000000000000000ull);
+}
+
 template <typename Container, typename Comparer>
 void ezSorting::QuickSort(Container& inout_container, ezUInt32 uiStartIndex, ezUInt32 uiEndIndex, const Comparer& in_comparer)
 {
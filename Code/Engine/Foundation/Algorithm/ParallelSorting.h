@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Foundation/Algorithm/Sorting.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Types/ScopeExit.h>
+
+/// \brief Sorting algorithms that distribute the work across the worker threads of the ezTaskSystem.
+///
+/// Arrays with fewer than PARALLEL_THRESHOLD elements are sorted on the calling thread with the corresponding ezSorting function,
+/// since the overhead of scheduling tasks would outweigh the gain.
+class ezParallelSorting
+{
+public:
+  /// \brief Sorts the elements in the array with a comparison sort, in parallel (not stable).
+  ///
+  /// The array is split into one block per worker thread, the blocks are quick sorted in parallel and then merged pairwise.
+  /// Every merge is split into independent parts as well, so all threads are busy until the last merge is done.
+  /// Temporary storage for all elements is allocated from \a pTempAllocator (the default allocator, if null),
+  /// so T needs to be default constructible.
+  template <typename T, typename Comparer>
+  static void Sort(ezArrayPtr<T>& inout_arrayPtr, const Comparer& comparer = Comparer(), ezAllocatorBase* pTempAllocator = nullptr); // [tested]
+
+  /// \brief Sorts the elements in the array by an unsigned integer key, using a parallel radix sort (stable).
+  ///
+  /// \see ezSorting::RadixSort() for the requirements on \a getKey and T.
+  /// The first pass distributes all elements into 256 buckets by the most significant byte in which the keys differ. Histograms and
+  /// scattering are computed per block in parallel. Afterwards the buckets are sorted independently of each other with a LSD radix sort,
+  /// which again runs in parallel and works on cache-friendly small ranges.
+  template <typename T, typename KeyFunc>
+  static void RadixSort(ezArrayPtr<T>& inout_arrayPtr, KeyFunc getKey, ezAllocatorBase* pTempAllocator = nullptr); // [tested]
+
+  /// \brief Sorts an array of integers or floating point values in ascending order, using a parallel radix sort.
+  template <typename T>
+  static void RadixSort(ezArrayPtr<T>& inout_arrayPtr, ezAllocatorBase* pTempAllocator = nullptr); // [tested]
+
+  enum
+  {
+    PARALLEL_THRESHOLD = 16 * 1024, ///< Arrays with fewer elements are sorted on the calling thread.
+  };
+
+private:
+  static ezUInt32 DetermineNumBlocks(ezUInt32 uiCount);
+
+  template <typename T, typename Comparer>
+  static ezUInt32 MergeCoRank(ezUInt32 uiOutputIndex, const T* pLeft, ezUInt32 uiLeftCount, const T* pRight, ezUInt32 uiRightCount, const Comparer& comparer);
+};
+
+#include <Foundation/Algorithm/Implementation/ParallelSorting_inl.h>
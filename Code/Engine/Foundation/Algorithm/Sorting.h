@@ -27,7 +27,31 @@ public:
   template <typename T, typename Comparer>
   static void InsertionSort(ezArrayPtr<T>& inout_arrayPtr, const Comparer& comparer = Comparer()); // [tested]
 
+  /// \brief Sorts the elements in the array by an unsigned integer key, using a LSD radix sort (stable, O(n)).
+  ///
+  /// \a getKey is called as 'KeyType getKey(const T& element)' and must return an unsigned integer type (e.g. ezUInt32 or ezUInt64).
+  /// Signed integers and floating point values can be mapped to such keys with ToRadixKey().
+  /// \a tempStorage must provide at least as many elements as \a inout_arrayPtr. Elements are moved around as raw memory,
+  /// so T must be a POD or memory relocatable type.
+  /// Bytes of the key that are identical for all elements are skipped, so keys that only use a small range need fewer passes.
+  template <typename T, typename KeyFunc>
+  static void RadixSort(ezArrayPtr<T>& inout_arrayPtr, ezArrayPtr<T> tempStorage, KeyFunc getKey); // [tested]
+
+  /// \brief Sorts an array of integers or floating point values in ascending order, using a LSD radix sort.
+  template <typename T>
+  static void RadixSort(ezArrayPtr<T>& inout_arrayPtr, ezArrayPtr<T> tempStorage); // [tested]
+
+  /// \brief Maps the value to an unsigned integer with the same sort order, for use as a RadixSort key.
+  static ezUInt32 ToRadixKey(ezUInt32 uiValue) { return uiValue; }
+  static ezUInt64 ToRadixKey(ezUInt64 uiValue) { return uiValue; }
+  static ezUInt32 ToRadixKey(ezInt32 iValue);
+  static ezUInt64 ToRadixKey(ezInt64 iValue);
+  static ezUInt32 ToRadixKey(float fValue);
+  static ezUInt64 ToRadixKey(double fValue);
+
 private:
+  friend class ezParallelSorting;
+
   enum
   {
     INSERTION_THRESHOLD = 16
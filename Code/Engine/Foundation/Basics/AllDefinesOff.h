@@ -70,6 +70,8 @@
 #define EZ_USE_ALLOCATION_TRACKING EZ_OFF
 #define EZ_USE_ALLOCATION_STACK_TRACING EZ_OFF
 #define EZ_USE_GUARDED_ALLOCATIONS EZ_OFF
+/// \brief Uses ezThreadCachingAllocator for the default and aligned heaps. Ignored when guarded allocations are enabled.
+#define EZ_USE_THREAD_CACHING_ALLOCATIONS EZ_OFF
 
 // Other Features
 #define EZ_USE_PROFILING EZ_OFF
@@ -6,6 +6,10 @@
 using DefaultHeapType = ezGuardedAllocator;
 using DefaultAlignedHeapType = ezGuardedAllocator;
 using DefaultStaticHeapType = ezGuardedAllocator;
+#elif EZ_ENABLED(EZ_USE_THREAD_CACHING_ALLOCATIONS)
+using DefaultHeapType = ezThreadCachingAllocator;
+using DefaultAlignedHeapType = ezThreadCachingAllocator;
+using DefaultStaticHeapType = ezHeapAllocator;
 #else
 using DefaultHeapType = ezHeapAllocator;
 using DefaultAlignedHeapType = ezAlignedHeapAllocator;
@@ -15,11 +19,12 @@ using DefaultStaticHeapType = ezHeapAllocator;
 enum
 {
   HEAP_ALLOCATOR_BUFFER_SIZE = sizeof(DefaultHeapType),
-  ALIGNED_ALLOCATOR_BUFFER_SIZE = sizeof(DefaultAlignedHeapType)
+  ALIGNED_ALLOCATOR_BUFFER_SIZE = sizeof(DefaultAlignedHeapType),
+  STATIC_ALLOCATOR_BUFFER_SIZE = sizeof(DefaultStaticHeapType)
 };
 
 alignas(EZ_ALIGNMENT_MINIMUM) static ezUInt8 s_DefaultAllocatorBuffer[HEAP_ALLOCATOR_BUFFER_SIZE];
-alignas(EZ_ALIGNMENT_MINIMUM) static ezUInt8 s_StaticAllocatorBuffer[HEAP_ALLOCATOR_BUFFER_SIZE];
+alignas(EZ_ALIGNMENT_MINIMUM) static ezUInt8 s_StaticAllocatorBuffer[STATIC_ALLOCATOR_BUFFER_SIZE];
 
 alignas(EZ_ALIGNMENT_MINIMUM) static ezUInt8 s_AlignedAllocatorBuffer[ALIGNED_ALLOCATOR_BUFFER_SIZE];
 
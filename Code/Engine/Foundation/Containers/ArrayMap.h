@@ -9,6 +9,10 @@
 /// you do not need to store iterators to elements and require them to stay valid when the container is modified.
 ///
 /// ezArrayMapBase also allows to store multiple values under the same key (like a multi-map).
+///
+/// Insertions are appended without sorting. The map only remembers how many elements at the front are already sorted, and the next
+/// lookup sorts just the new elements and merges them into the sorted part. So inserting a batch of elements followed by lookups costs
+/// O(k log k + n) for k new elements, instead of re-sorting the whole array.
 template <typename KEY, typename VALUE>
 class ezArrayMapBase
 {
@@ -51,6 +55,8 @@ public:
   ezUInt32 Insert(CompatibleKeyType&& key, CompatibleValueType&& value); // [tested]
 
   /// \brief Ensures the internal data structure is sorted. This is done automatically every time a lookup needs to be made.
+  ///
+  /// Only the elements that were inserted since the last call are sorted, and then merged with the previously sorted elements.
   void Sort() const; // [tested]
 
   /// \brief Returns an index to one element with the given key. If the key is inserted multiple times, there is no guarantee which one is returned.
@@ -141,7 +147,7 @@ public:
   using reverse_iterator = typename ezDynamicArray<Pair>::reverse_iterator;
 
 private:
-  mutable bool m_bSorted;
+  mutable ezUInt32 m_uiSortedCount = 0; ///< The number of elements at the start of m_Data that are known to be sorted.
   mutable ezDynamicArray<Pair> m_Data;
 };
 
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <Foundation/Algorithm/Comparer.h>
+#include <Foundation/Memory/AllocatorWrapper.h>
+
+/// \brief An associative container with the same interface as ezMap, implemented as a B+ tree.
+///
+/// ezMap allocates one node per element, so lookups and iteration jump through memory with one cache miss per level.
+/// ezBTreeMap stores many sorted keys per node instead (node sizes are chosen to span a few cache lines), which makes
+/// the tree very shallow and lets lookups and ordered iteration run over contiguous memory.
+/// All key/value pairs are stored in the leaves, which are linked to each other for fast forward and backward iteration.
+/// Inner nodes store copies of keys as separators, so KeyType must be copy-constructible.
+///
+/// All insertion/erasure/lookup functions take O(log n) time. Inserting keys in ascending order fills up the leaves
+/// completely, which makes building a map from sorted data fast and memory efficient.
+///
+/// In contrast to ezMap, any insertion or erasure may move elements to other nodes, which invalidates all iterators
+/// and pointers to values, except for the iterator returned by the modifying function.
+template <typename KeyType, typename ValueType, typename Comparer>
+class ezBTreeMapBase
+{
+private:
+  enum
+  {
+    NODE_SIZE = 512, ///< Targeted size of a node in bytes.
+    LEAF_CAPACITY_CALC = (NODE_SIZE - 4 * sizeof(void*)) / (sizeof(KeyType) + sizeof(ValueType)),
+    LEAF_CAPACITY = LEAF_CAPACITY_CALC < 8 ? 8 : (LEAF_CAPACITY_CALC > 255 ? 255 : LEAF_CAPACITY_CALC),
+    INNER_CAPACITY_CALC = (NODE_SIZE - 2 * sizeof(void*)) / (sizeof(KeyType) + sizeof(void*)),
+    INNER_CAPACITY = INNER_CAPACITY_CALC < 8 ? 8 : (INNER_CAPACITY_CALC > 255 ? 255 : INNER_CAPACITY_CALC),
+    LEAF_MIN_COUNT = LEAF_CAPACITY / 2,
+    INNER_MIN_COUNT = (INNER_CAPACITY - 1) / 2,
+  };
+
+  struct Node
+  {
+    ezUInt16 m_uiCount = 0; ///< Number of keys in this node.
+    bool m_bIsLeaf = false;
+  };
+
+  /// \brief Stores up to LEAF_CAPACITY sorted key/value pairs. The arrays are uninitialized beyond m_uiCount.
+  struct LeafNode : public Node
+  {
+    LeafNode* m_pPrev = nullptr;
+    LeafNode* m_pNext = nullptr;
+
+    EZ_ALWAYS_INLINE KeyType* Keys() { return reinterpret_cast<KeyType*>(m_KeyStorage); }
+    EZ_ALWAYS_INLINE ValueType* Values() { return reinterpret_cast<ValueType*>(m_ValueStorage); }
+
+    alignas(KeyType) ezUInt8 m_KeyStorage[LEAF_CAPACITY * sizeof(KeyType)];
+    alignas(ValueType) ezUInt8 m_ValueStorage[LEAF_CAPACITY * sizeof(ValueType)];
+  };
+
+  /// \brief Stores up to INNER_CAPACITY separator keys and one child more than it has keys.
+  ///
+  /// All keys in child i are smaller than separator i and equal or larger than separator i-1.
+  struct InnerNode : public Node
+  {
+    EZ_ALWAYS_INLINE KeyType* Keys() { return reinterpret_cast<KeyType*>(m_KeyStorage); }
+
+    Node* m_pChildren[INNER_CAPACITY + 1];
+    alignas(KeyType) ezUInt8 m_KeyStorage[INNER_CAPACITY * sizeof(KeyType)];
+  };
+
+public:
+  /// \brief Base class for all iterators.
+  struct ConstIterator
+  {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ConstIterator;
+    using difference_type = ptrdiff_t;
+    using pointer = ConstIterator*;
+    using reference = ConstIterator&;
+
+    EZ_DECLARE_POD_TYPE();
+
+    /// \brief Constructs an invalid iterator.
+    EZ_ALWAYS_INLINE ConstIterator() = default; // [tested]
+
+    /// \brief Checks whether this iterator points to a valid element.
+    EZ_ALWAYS_INLINE bool IsValid() const { return (m_pLeaf != nullptr); } // [tested]
+
+    /// \brief Checks whether the two iterators point to the same element.
+    EZ_ALWAYS_INLINE bool operator==(const typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator& it2) const
+    {
+      return m_pLeaf == it2.m_pLeaf && m_uiIndex == it2.m_uiIndex;
+    }
+
+    /// \brief Checks whether the two iterators point to the same element.
+    EZ_ALWAYS_INLINE bool operator!=(const typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator& it2) const { return !(*this == it2); }
+
+    /// \brief Returns the 'key' of the element that this iterator points to.
+    EZ_FORCE_INLINE const KeyType& Key() const
+    {
+      EZ_ASSERT_DEBUG(IsValid(), "Cannot access the 'key' of an invalid iterator.");
+      return m_pLeaf->Keys()[m_uiIndex];
+    } // [tested]
+
+    /// \brief Returns the 'value' of the element that this iterator points to.
+    EZ_FORCE_INLINE const ValueType& Value() const
+    {
+      EZ_ASSERT_DEBUG(IsValid(), "Cannot access the 'value' of an invalid iterator.");
+      return m_pLeaf->Values()[m_uiIndex];
+    } // [tested]
+
+    /// \brief Returns '*this' to enable foreach
+    EZ_ALWAYS_INLINE ConstIterator& operator*() { return *this; } // [tested]
+
+    /// \brief Advances the iterator to the next element in the map. The iterator will not be valid anymore, if the end is reached.
+    void Next(); // [tested]
+
+    /// \brief Advances the iterator to the previous element in the map. The iterator will not be valid anymore, if the end is reached.
+    void Prev(); // [tested]
+
+    /// \brief Shorthand for 'Next'
+    EZ_ALWAYS_INLINE void operator++() { Next(); } // [tested]
+
+    /// \brief Shorthand for 'Prev'
+    EZ_ALWAYS_INLINE void operator--() { Prev(); } // [tested]
+
+  protected:
+    friend class ezBTreeMapBase<KeyType, ValueType, Comparer>;
+
+    EZ_ALWAYS_INLINE ConstIterator(LeafNode* pLeaf, ezUInt32 uiIndex)
+      : m_pLeaf(pLeaf)
+      , m_uiIndex(uiIndex)
+    {
+    }
+
+    LeafNode* m_pLeaf = nullptr;
+    ezUInt32 m_uiIndex = 0;
+  };
+
+  /// \brief Forward Iterator to iterate over all elements in sorted order.
+  struct Iterator : public ConstIterator
+  {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Iterator;
+    using difference_type = ptrdiff_t;
+    using pointer = Iterator*;
+    using reference = Iterator&;
+
+    // this is required to pull in the const version of this function
+    using ConstIterator::Value;
+
+    EZ_DECLARE_POD_TYPE();
+
+    /// \brief Constructs an invalid iterator.
+    EZ_ALWAYS_INLINE Iterator() = default;
+
+    /// \brief Returns the 'value' of the element that this iterator points to.
+    EZ_FORCE_INLINE ValueType& Value()
+    {
+      EZ_ASSERT_DEBUG(this->IsValid(), "Cannot access the 'value' of an invalid iterator.");
+      return this->m_pLeaf->Values()[this->m_uiIndex];
+    }
+
+    /// \brief Returns '*this' to enable foreach
+    EZ_ALWAYS_INLINE Iterator& operator*() { return *this; } // [tested]
+
+  private:
+    friend class ezBTreeMapBase<KeyType, ValueType, Comparer>;
+
+    EZ_ALWAYS_INLINE Iterator(LeafNode* pLeaf, ezUInt32 uiIndex)
+      : ConstIterator(pLeaf, uiIndex)
+    {
+    }
+  };
+
+protected:
+  /// \brief Initializes the map to be empty.
+  ezBTreeMapBase(const Comparer& comparer, ezAllocatorBase* pAllocator); // [tested]
+
+  /// \brief Copies all key/value pairs from the given map into this one.
+  ezBTreeMapBase(const ezBTreeMapBase<KeyType, ValueType, Comparer>& cc, ezAllocatorBase* pAllocator); // [tested]
+
+  /// \brief Destroys all elements from the map.
+  ~ezBTreeMapBase(); // [tested]
+
+  /// \brief Copies all key/value pairs from the given map into this one.
+  void operator=(const ezBTreeMapBase<KeyType, ValueType, Comparer>& rhs);
+
+public:
+  /// \brief Returns whether there are no elements in the map. O(1) operation.
+  bool IsEmpty() const; // [tested]
+
+  /// \brief Returns the number of elements currently stored in the map. O(1) operation.
+  ezUInt32 GetCount() const; // [tested]
+
+  /// \brief Destroys all elements in the map and resets its size to zero.
+  void Clear(); // [tested]
+
+  /// \brief Returns an Iterator to the very first element.
+  Iterator GetIterator(); // [tested]
+
+  /// \brief Returns a constant Iterator to the very first element.
+  ConstIterator GetIterator() const; // [tested]
+
+  /// \brief Returns an Iterator to the very last element. For reverse traversal.
+  Iterator GetLastIterator(); // [tested]
+
+  /// \brief Returns a constant Iterator to the very last element. For reverse traversal.
+  ConstIterator GetLastIterator() const; // [tested]
+
+  /// \brief Inserts the key/value pair into the tree and returns an Iterator to it. Replaces the value, if the key already exists.
+  /// O(log n) operation.
+  template <typename CompatibleKeyType, typename CompatibleValueType>
+  Iterator Insert(CompatibleKeyType&& key, CompatibleValueType&& value); // [tested]
+
+  /// \brief Erases the key/value pair with the given key, if it exists. O(log n) operation.
+  template <typename CompatibleKeyType>
+  bool Remove(const CompatibleKeyType& key); // [tested]
+
+  /// \brief Erases the key/value pair at the given Iterator. O(log n) operation. Returns an iterator to the element after the given
+  /// iterator.
+  Iterator Remove(const Iterator& pos); // [tested]
+
+  /// \brief Searches for the given key and returns an iterator to it. If it did not exist yet, it is default-created. \a bExisted is set to
+  /// true, if the key was found, false if it needed to be created.
+  template <typename CompatibleKeyType>
+  Iterator FindOrAdd(CompatibleKeyType&& key, bool* out_pExisted = nullptr); // [tested]
+
+  /// \brief Allows read/write access to the value stored under the given key. If there is no such key, a new element is
+  /// default-constructed.
+  template <typename CompatibleKeyType>
+  ValueType& operator[](const CompatibleKeyType& key); // [tested]
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the corresponding value to out_value.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, ValueType& out_value) const; // [tested]
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the pointer to the corresponding value to out_pValue.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, const ValueType*& out_pValue) const; // [tested]
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the pointer to the corresponding value to out_pValue.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, ValueType*& out_pValue) const; // [tested]
+
+  /// \brief Returns a pointer to the value of the entry with the given key if found, otherwise returns nullptr.
+  template <typename CompatibleKeyType>
+  const ValueType* GetValue(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Returns a pointer to the value of the entry with the given key if found, otherwise returns nullptr.
+  template <typename CompatibleKeyType>
+  ValueType* GetValue(const CompatibleKeyType& key); // [tested]
+
+  /// \brief Either returns the value of the entry with the given key, if found, or the provided default value.
+  template <typename CompatibleKeyType>
+  const ValueType& GetValueOrDefault(const CompatibleKeyType& key, const ValueType& defaultValue) const; // [tested]
+
+  /// \brief Searches for key, returns an Iterator to it or an invalid iterator, if no such key is found. O(log n) operation.
+  template <typename CompatibleKeyType>
+  Iterator Find(const CompatibleKeyType& key); // [tested]
+
+  /// \brief Returns an Iterator to the element with a key equal or larger than the given key. Returns an invalid iterator, if there is no
+  /// such element.
+  template <typename CompatibleKeyType>
+  Iterator LowerBound(const CompatibleKeyType& key); // [tested]
+
+  /// \brief Returns an Iterator to the element with a key that is LARGER than the given key. Returns an invalid iterator, if there is no
+  /// such element.
+  template <typename CompatibleKeyType>
+  Iterator UpperBound(const CompatibleKeyType& key); // [tested]
+
+  /// \brief Searches for key, returns an Iterator to it or an invalid iterator, if no such key is found. O(log n) operation.
+  template <typename CompatibleKeyType>
+  ConstIterator Find(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Checks whether the given key is in the container.
+  template <typename CompatibleKeyType>
+  bool Contains(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Returns an Iterator to the element with a key equal or larger than the given key. Returns an invalid iterator, if there is no
+  /// such element.
+  template <typename CompatibleKeyType>
+  ConstIterator LowerBound(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Returns an Iterator to the element with a key that is LARGER than the given key. Returns an invalid iterator, if there is no
+  /// such element.
+  template <typename CompatibleKeyType>
+  ConstIterator UpperBound(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Returns the allocator that is used by this instance.
+  ezAllocatorBase* GetAllocator() const { return m_pAllocator; }
+
+  /// \brief Comparison operator
+  bool operator==(const ezBTreeMapBase<KeyType, ValueType, Comparer>& rhs) const; // [tested]
+
+  /// \brief Comparison operator
+  bool operator!=(const ezBTreeMapBase<KeyType, ValueType, Comparer>& rhs) const; // [tested]
+
+  /// \brief Returns the amount of bytes that are currently allocated on the heap.
+  ezUInt64 GetHeapMemoryUsage() const; // [tested]
+
+  /// \brief Swaps this map with the other one.
+  void Swap(ezBTreeMapBase<KeyType, ValueType, Comparer>& other); // [tested]
+
+private:
+  template <typename CompatibleKeyType>
+  ezUInt32 LowerBoundInLeaf(LeafNode* pLeaf, const CompatibleKeyType& key) const;
+  template <typename CompatibleKeyType>
+  ezUInt32 UpperBoundInLeaf(LeafNode* pLeaf, const CompatibleKeyType& key) const;
+  template <typename CompatibleKeyType>
+  ezUInt32 FindChild(InnerNode* pInner, const CompatibleKeyType& key) const;
+  template <typename CompatibleKeyType>
+  LeafNode* FindLeaf(const CompatibleKeyType& key) const;
+
+  template <typename CompatibleKeyType>
+  ConstIterator Internal_Find(const CompatibleKeyType& key) const;
+  template <typename CompatibleKeyType>
+  ConstIterator Internal_LowerBound(const CompatibleKeyType& key) const;
+  template <typename CompatibleKeyType>
+  ConstIterator Internal_UpperBound(const CompatibleKeyType& key) const;
+
+  /// \brief Returns the leaf and the index at which the key is stored or has to be inserted. Splits all full nodes along the way.
+  template <typename CompatibleKeyType>
+  LeafNode* PrepareInsert(const CompatibleKeyType& key, ezUInt32& out_uiIndex, bool& out_bExisted);
+
+  /// \brief Splits the full child at the given index of the (non-full) parent.
+  template <typename CompatibleKeyType>
+  void SplitChild(InnerNode* pParent, ezUInt32 uiChildIndex, const CompatibleKeyType& insertKey);
+
+  /// \brief Makes sure that the child at the given index can lose one element, by borrowing from or merging with a sibling.
+  /// Returns the index of the child that now covers the key range of the original child.
+  ezUInt32 FixUnderflow(InnerNode* pParent, ezUInt32 uiChildIndex);
+
+  template <typename CompatibleKeyType>
+  bool Internal_Remove(const CompatibleKeyType& key);
+
+  LeafNode* AllocateLeaf();
+  InnerNode* AllocateInner();
+  void FreeNode(Node* pNode, bool bDestructContent);
+
+  Node* m_pRoot = nullptr;
+  LeafNode* m_pFirstLeaf = nullptr;
+  LeafNode* m_pLastLeaf = nullptr;
+  ezUInt32 m_uiCount = 0;
+  ezUInt32 m_uiNumLeafNodes = 0;
+  ezUInt32 m_uiNumInnerNodes = 0;
+  ezAllocatorBase* m_pAllocator = nullptr;
+  Comparer m_Comparer;
+};
+
+
+/// \brief \see ezBTreeMapBase
+template <typename KeyType, typename ValueType, typename Comparer = ezCompareHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper>
+class ezBTreeMap : public ezBTreeMapBase<KeyType, ValueType, Comparer>
+{
+public:
+  ezBTreeMap();
+  explicit ezBTreeMap(ezAllocatorBase* pAllocator);
+  ezBTreeMap(const Comparer& comparer, ezAllocatorBase* pAllocator);
+
+  ezBTreeMap(const ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>& other);
+  ezBTreeMap(const ezBTreeMapBase<KeyType, ValueType, Comparer>& other);
+
+  void operator=(const ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>& rhs);
+  void operator=(const ezBTreeMapBase<KeyType, ValueType, Comparer>& rhs);
+};
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator begin(ezBTreeMapBase<KeyType, ValueType, Comparer>& ref_container)
+{
+  return ref_container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator begin(const ezBTreeMapBase<KeyType, ValueType, Comparer>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator cbegin(const ezBTreeMapBase<KeyType, ValueType, Comparer>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator end(ezBTreeMapBase<KeyType, ValueType, Comparer>& ref_container)
+{
+  return typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator end(const ezBTreeMapBase<KeyType, ValueType, Comparer>& container)
+{
+  return typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator cend(const ezBTreeMapBase<KeyType, ValueType, Comparer>& container)
+{
+  return typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator();
+}
+
+#include <Foundation/Containers/Implementation/BTreeMap_inl.h>
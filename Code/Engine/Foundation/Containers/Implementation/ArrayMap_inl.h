@@ -4,12 +4,12 @@ template <typename KEY, typename VALUE>
 inline ezArrayMapBase<KEY, VALUE>::ezArrayMapBase(ezAllocatorBase* pAllocator)
   : m_Data(pAllocator)
 {
-  m_bSorted = true;
+  m_uiSortedCount = 0;
 }
 
 template <typename KEY, typename VALUE>
 inline ezArrayMapBase<KEY, VALUE>::ezArrayMapBase(const ezArrayMapBase& rhs, ezAllocatorBase* pAllocator)
-  : m_bSorted(rhs.m_bSorted)
+  : m_uiSortedCount(rhs.m_uiSortedCount)
   , m_Data(pAllocator)
 {
   m_Data = rhs.m_Data;
@@ -18,7 +18,7 @@ inline ezArrayMapBase<KEY, VALUE>::ezArrayMapBase(const ezArrayMapBase& rhs, ezA
 template <typename KEY, typename VALUE>
 inline void ezArrayMapBase<KEY, VALUE>::operator=(const ezArrayMapBase& rhs)
 {
-  m_bSorted = rhs.m_bSorted;
+  m_uiSortedCount = rhs.m_uiSortedCount;
   m_Data = rhs.m_Data;
 }
 
@@ -37,7 +37,7 @@ EZ_ALWAYS_INLINE bool ezArrayMapBase<KEY, VALUE>::IsEmpty() const
 template <typename KEY, typename VALUE>
 inline void ezArrayMapBase<KEY, VALUE>::Clear()
 {
-  m_bSorted = true;
+  m_uiSortedCount = 0;
   m_Data.Clear();
 }
 
@@ -48,28 +48,65 @@ inline ezUInt32 ezArrayMapBase<KEY, VALUE>::Insert(CompatibleKeyType&& key, Comp
   Pair& ref = m_Data.ExpandAndGetRef();
   ref.key = std::forward<CompatibleKeyType>(key);
   ref.value = std::forward<CompatibleValueType>(value);
-  m_bSorted = false;
   return m_Data.GetCount() - 1;
 }
 
 template <typename KEY, typename VALUE>
 inline void ezArrayMapBase<KEY, VALUE>::Sort() const
 {
-  if (m_bSorted)
+  const ezUInt32 uiCount = m_Data.GetCount();
+  const ezUInt32 uiSortedCount = m_uiSortedCount;
+
+  if (uiSortedCount == uiCount)
     return;
 
-  m_bSorted = true;
-  m_Data.Sort();
+  m_uiSortedCount = uiCount;
+
+  if (uiSortedCount == 0)
+  {
+    m_Data.Sort();
+    return;
+  }
+
+  // Only the elements that were inserted since the last sort need to be sorted, afterwards they are merged into the already sorted part.
+  ezArrayPtr<Pair> newElements = m_Data.GetArrayPtr().GetSubArray(uiSortedCount);
+  ezSorting::QuickSort(newElements, ezCompareHelper<Pair>());
+
+  // nothing to merge if all new elements go to the end
+  if (!(newElements[0] < m_Data[uiSortedCount - 1]))
+    return;
+
+  ezDynamicArray<Pair> tmp(m_Data.GetAllocator());
+  tmp.Reserve(newElements.GetCount());
+  for (Pair& pair : newElements)
+  {
+    tmp.PushBack(std::move(pair));
+  }
+
+  // merge from the back, so that every element is moved at most once
+  Pair* pData = m_Data.GetData();
+  ezInt64 iSorted = (ezInt64)uiSortedCount - 1;
+  ezInt64 iNew = (ezInt64)tmp.GetCount() - 1;
+  ezInt64 iTarget = (ezInt64)uiCount - 1;
+
+  while (iNew >= 0)
+  {
+    if (iSorted >= 0 && tmp[(ezUInt32)iNew] < pData[iSorted])
+    {
+      pData[iTarget--] = std::move(pData[iSorted--]);
+    }
+    else
+    {
+      pData[iTarget--] = std::move(tmp[(ezUInt32)iNew--]);
+    }
+  }
 }
 
 template <typename KEY, typename VALUE>
 template <typename CompatibleKeyType>
 ezUInt32 ezArrayMapBase<KEY, VALUE>::Find(const CompatibleKeyType& key) const
 {
-  if (!m_bSorted)
-  {
-    m_Data.Sort();
-  }
+  Sort();
 
   ezUInt32 lb = 0;
   ezUInt32 ub = m_Data.GetCount();
@@ -99,10 +136,7 @@ template <typename KEY, typename VALUE>
 template <typename CompatibleKeyType>
 ezUInt32 ezArrayMapBase<KEY, VALUE>::LowerBound(const CompatibleKeyType& key) const
 {
-  if (!m_bSorted)
-  {
-    m_Data.Sort();
-  }
+  Sort();
 
   ezUInt32 lb = 0;
   ezUInt32 ub = m_Data.GetCount();
@@ -131,10 +165,7 @@ template <typename KEY, typename VALUE>
 template <typename CompatibleKeyType>
 ezUInt32 ezArrayMapBase<KEY, VALUE>::UpperBound(const CompatibleKeyType& key) const
 {
-  if (!m_bSorted)
-  {
-    m_Data.Sort();
-  }
+  Sort();
 
   ezUInt32 lb = 0;
   ezUInt32 ub = m_Data.GetCount();
@@ -180,7 +211,7 @@ VALUE& ezArrayMapBase<KEY, VALUE>::GetValue(ezUInt32 uiIndex)
 template <typename KEY, typename VALUE>
 EZ_ALWAYS_INLINE ezDynamicArray<typename ezArrayMapBase<KEY, VALUE>::Pair>& ezArrayMapBase<KEY, VALUE>::GetData()
 {
-  m_bSorted = false;
+  m_uiSortedCount = 0;
   return m_Data;
 }
 
@@ -223,14 +254,17 @@ EZ_ALWAYS_INLINE const typename ezArrayMapBase<KEY, VALUE>::Pair& ezArrayMapBase
 template <typename KEY, typename VALUE>
 void ezArrayMapBase<KEY, VALUE>::RemoveAtAndCopy(ezUInt32 uiIndex, bool bKeepSorted)
 {
-  if (bKeepSorted && m_bSorted)
+  if (bKeepSorted)
   {
     m_Data.RemoveAtAndCopy(uiIndex);
+
+    if (uiIndex < m_uiSortedCount)
+      --m_uiSortedCount;
   }
   else
   {
     m_Data.RemoveAtAndSwap(uiIndex);
-    m_bSorted = false;
+    m_uiSortedCount = ezMath::Min(m_uiSortedCount, uiIndex);
   }
 }
 
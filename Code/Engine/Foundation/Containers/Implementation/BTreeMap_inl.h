@@ -0,0 +1,940 @@
+#pragma once
+
+namespace ezInternal
+{
+  /// \brief Moves \a uiCount objects from \a pSource to the uninitialized \a pDestination and leaves \a pSource uninitialized.
+  /// The two ranges may overlap.
+  template <typename T>
+  void BTreeRelocate(T* pDestination, T* pSource, ezUInt32 uiCount)
+  {
+    if (uiCount == 0 || pDestination == pSource)
+      return;
+
+    if constexpr (ezGetTypeClass<T>::value != ezTypeIsClass::value)
+    {
+      memmove(static_cast<void*>(pDestination), static_cast<const void*>(pSource), uiCount * sizeof(T));
+    }
+    else if (pDestination < pSource)
+    {
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        ezMemoryUtils::MoveConstruct(pDestination + i, std::move(pSource[i]));
+        ezMemoryUtils::Destruct(pSource + i, 1);
+      }
+    }
+    else
+    {
+      for (ezUInt32 i = uiCount; i > 0; --i)
+      {
+        ezMemoryUtils::MoveConstruct(pDestination + i - 1, std::move(pSource[i - 1]));
+        ezMemoryUtils::Destruct(pSource + i - 1, 1);
+      }
+    }
+  }
+} // namespace ezInternal
+
+// ***** Iterators *****
+
+template <typename KeyType, typename ValueType, typename Comparer>
+void ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator::Next()
+{
+  if (m_pLeaf == nullptr)
+    return;
+
+  ++m_uiIndex;
+
+  if (m_uiIndex >= m_pLeaf->m_uiCount)
+  {
+    m_pLeaf = m_pLeaf->m_pNext;
+    m_uiIndex = 0;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+void ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator::Prev()
+{
+  if (m_pLeaf == nullptr)
+    return;
+
+  if (m_uiIndex > 0)
+  {
+    --m_uiIndex;
+    return;
+  }
+
+  m_pLeaf = m_pLeaf->m_pPrev;
+  m_uiIndex = (m_pLeaf != nullptr) ? m_pLeaf->m_uiCount - 1u : 0u;
+}
+
+// ***** ezBTreeMapBase *****
+
+template <typename KeyType, typename ValueType, typename Comparer>
+ezBTreeMapBase<KeyType, ValueType, Comparer>::ezBTreeMapBase(const Comparer& comparer, ezAllocatorBase* pAllocator)
+  : m_pAllocator(pAllocator)
+  , m_Comparer(comparer)
+{
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+ezBTreeMapBase<KeyType, ValueType, Comparer>::ezBTreeMapBase(const ezBTreeMapBase<KeyType, ValueType, Comparer>& cc, ezAllocatorBase* pAllocator)
+  : m_pAllocator(pAllocator)
+  , m_Comparer(cc.m_Comparer)
+{
+  operator=(cc);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+ezBTreeMapBase<KeyType, ValueType, Comparer>::~ezBTreeMapBase()
+{
+  Clear();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+void ezBTreeMapBase<KeyType, ValueType, Comparer>::operator=(const ezBTreeMapBase<KeyType, ValueType, Comparer>& rhs)
+{
+  if (this == &rhs)
+    return;
+
+  Clear();
+
+  // the keys arrive in ascending order, which fills every leaf completely
+  for (ConstIterator it = rhs.GetIterator(); it.IsValid(); ++it)
+  {
+    Insert(it.Key(), it.Value());
+  }
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+EZ_ALWAYS_INLINE bool ezBTreeMapBase<KeyType, ValueType, Comparer>::IsEmpty() const
+{
+  return m_uiCount == 0;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+EZ_ALWAYS_INLINE ezUInt32 ezBTreeMapBase<KeyType, ValueType, Comparer>::GetCount() const
+{
+  return m_uiCount;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+void ezBTreeMapBase<KeyType, ValueType, Comparer>::Clear()
+{
+  if (m_pRoot != nullptr)
+  {
+    FreeNode(m_pRoot, true);
+  }
+
+  m_pRoot = nullptr;
+  m_pFirstLeaf = nullptr;
+  m_pLastLeaf = nullptr;
+  m_uiCount = 0;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator ezBTreeMapBase<KeyType, ValueType, Comparer>::GetIterator()
+{
+  return Iterator(m_pFirstLeaf, 0);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator ezBTreeMapBase<KeyType, ValueType, Comparer>::GetIterator() const
+{
+  return ConstIterator(m_pFirstLeaf, 0);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator ezBTreeMapBase<KeyType, ValueType, Comparer>::GetLastIterator()
+{
+  return Iterator(m_pLastLeaf, m_pLastLeaf != nullptr ? m_pLastLeaf->m_uiCount - 1u : 0u);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator ezBTreeMapBase<KeyType, ValueType, Comparer>::GetLastIterator() const
+{
+  return ConstIterator(m_pLastLeaf, m_pLastLeaf != nullptr ? m_pLastLeaf->m_uiCount - 1u : 0u);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType, typename CompatibleValueType>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator ezBTreeMapBase<KeyType, ValueType, Comparer>::Insert(CompatibleKeyType&& key, CompatibleValueType&& value)
+{
+  ezUInt32 uiIndex = 0;
+  bool bExisted = false;
+  LeafNode* pLeaf = PrepareInsert(key, uiIndex, bExisted);
+
+  if (bExisted)
+  {
+    pLeaf->Values()[uiIndex] = std::forward<CompatibleValueType>(value);
+  }
+  else
+  {
+    ezMemoryUtils::CopyOrMoveConstruct<KeyType>(pLeaf->Keys() + uiIndex, std::forward<CompatibleKeyType>(key));
+    ezMemoryUtils::CopyOrMoveConstruct<ValueType>(pLeaf->Values() + uiIndex, std::forward<CompatibleValueType>(value));
+  }
+
+  return Iterator(pLeaf, uiIndex);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE bool ezBTreeMapBase<KeyType, ValueType, Comparer>::Remove(const CompatibleKeyType& key)
+{
+  return Internal_Remove(key);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator ezBTreeMapBase<KeyType, ValueType, Comparer>::Remove(const Iterator& pos)
+{
+  EZ_ASSERT_DEBUG(pos.IsValid(), "The Iterator is invalid.");
+
+  LeafNode* pLeaf = pos.m_pLeaf;
+  const ezUInt32 uiIndex = pos.m_uiIndex;
+
+  if (pLeaf == m_pRoot || pLeaf->m_uiCount > LEAF_MIN_COUNT)
+  {
+    // the leaf can lose an element without rebalancing the tree, so the iterator can simply stay in place
+    ezMemoryUtils::Destruct(pLeaf->Keys() + uiIndex, 1);
+    ezMemoryUtils::Destruct(pLeaf->Values() + uiIndex, 1);
+    ezInternal::BTreeRelocate(pLeaf->Keys() + uiIndex, pLeaf->Keys() + uiIndex + 1, pLeaf->m_uiCount - uiIndex - 1);
+    ezInternal::BTreeRelocate(pLeaf->Values() + uiIndex, pLeaf->Values() + uiIndex + 1, pLeaf->m_uiCount - uiIndex - 1);
+    --pLeaf->m_uiCount;
+    --m_uiCount;
+
+    if (pLeaf->m_uiCount == 0)
+    {
+      Clear();
+      return Iterator();
+    }
+
+    if (uiIndex < pLeaf->m_uiCount)
+      return Iterator(pLeaf, uiIndex);
+
+    return Iterator(pLeaf->m_pNext, 0);
+  }
+
+  // rebalancing may move the following element to another node, so it has to be searched again
+  const KeyType key = pLeaf->Keys()[uiIndex];
+  Internal_Remove(key);
+
+  const ConstIterator it = Internal_LowerBound(key);
+  return Iterator(it.m_pLeaf, it.m_uiIndex);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator ezBTreeMapBase<KeyType, ValueType, Comparer>::FindOrAdd(CompatibleKeyType&& key, bool* out_pExisted)
+{
+  ezUInt32 uiIndex = 0;
+  bool bExisted = false;
+  LeafNode* pLeaf = PrepareInsert(key, uiIndex, bExisted);
+
+  if (!bExisted)
+  {
+    ezMemoryUtils::CopyOrMoveConstruct<KeyType>(pLeaf->Keys() + uiIndex, std::forward<CompatibleKeyType>(key));
+    ezMemoryUtils::DefaultConstruct(pLeaf->Values() + uiIndex, 1);
+  }
+
+  if (out_pExisted)
+    *out_pExisted = bExisted;
+
+  return Iterator(pLeaf, uiIndex);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE ValueType& ezBTreeMapBase<KeyType, ValueType, Comparer>::operator[](const CompatibleKeyType& key)
+{
+  return FindOrAdd(key).Value();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+bool ezBTreeMapBase<KeyType, ValueType, Comparer>::TryGetValue(const CompatibleKeyType& key, ValueType& out_value) const
+{
+  const ConstIterator it = Internal_Find(key);
+  if (it.IsValid())
+  {
+    out_value = it.Value();
+    return true;
+  }
+
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+bool ezBTreeMapBase<KeyType, ValueType, Comparer>::TryGetValue(const CompatibleKeyType& key, const ValueType*& out_pValue) const
+{
+  const ConstIterator it = Internal_Find(key);
+  if (it.IsValid())
+  {
+    out_pValue = &it.Value();
+    return true;
+  }
+
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+bool ezBTreeMapBase<KeyType, ValueType, Comparer>::TryGetValue(const CompatibleKeyType& key, ValueType*& out_pValue) const
+{
+  const ConstIterator it = Internal_Find(key);
+  if (it.IsValid())
+  {
+    out_pValue = it.m_pLeaf->Values() + it.m_uiIndex;
+    return true;
+  }
+
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+const ValueType* ezBTreeMapBase<KeyType, ValueType, Comparer>::GetValue(const CompatibleKeyType& key) const
+{
+  const ConstIterator it = Internal_Find(key);
+  return it.IsValid() ? &it.Value() : nullptr;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+ValueType* ezBTreeMapBase<KeyType, ValueType, Comparer>::GetValue(const CompatibleKeyType& key)
+{
+  const ConstIterator it = Internal_Find(key);
+  return it.IsValid() ? it.m_pLeaf->Values() + it.m_uiIndex : nullptr;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+const ValueType& ezBTreeMapBase<KeyType, ValueType, Comparer>::GetValueOrDefault(const CompatibleKeyType& key, const ValueType& defaultValue) const
+{
+  const ConstIterator it = Internal_Find(key);
+  return it.IsValid() ? it.Value() : defaultValue;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator ezBTreeMapBase<KeyType, ValueType, Comparer>::Find(const CompatibleKeyType& key)
+{
+  const ConstIterator it = Internal_Find(key);
+  return Iterator(it.m_pLeaf, it.m_uiIndex);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator ezBTreeMapBase<KeyType, ValueType, Comparer>::LowerBound(const CompatibleKeyType& key)
+{
+  const ConstIterator it = Internal_LowerBound(key);
+  return Iterator(it.m_pLeaf, it.m_uiIndex);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::Iterator ezBTreeMapBase<KeyType, ValueType, Comparer>::UpperBound(const CompatibleKeyType& key)
+{
+  const ConstIterator it = Internal_UpperBound(key);
+  return Iterator(it.m_pLeaf, it.m_uiIndex);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator ezBTreeMapBase<KeyType, ValueType, Comparer>::Find(const CompatibleKeyType& key) const
+{
+  return Internal_Find(key);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE bool ezBTreeMapBase<KeyType, ValueType, Comparer>::Contains(const CompatibleKeyType& key) const
+{
+  return Internal_Find(key).IsValid();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator ezBTreeMapBase<KeyType, ValueType, Comparer>::LowerBound(const CompatibleKeyType& key) const
+{
+  return Internal_LowerBound(key);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator ezBTreeMapBase<KeyType, ValueType, Comparer>::UpperBound(const CompatibleKeyType& key) const
+{
+  return Internal_UpperBound(key);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+bool ezBTreeMapBase<KeyType, ValueType, Comparer>::operator==(const ezBTreeMapBase<KeyType, ValueType, Comparer>& rhs) const
+{
+  if (GetCount() != rhs.GetCount())
+    return false;
+
+  auto itLhs = GetIterator();
+  auto itRhs = rhs.GetIterator();
+
+  while (itLhs.IsValid())
+  {
+    if (!m_Comparer.Equal(itLhs.Key(), itRhs.Key()))
+      return false;
+
+    if (itLhs.Value() != itRhs.Value())
+      return false;
+
+    ++itLhs;
+    ++itRhs;
+  }
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+EZ_ALWAYS_INLINE bool ezBTreeMapBase<KeyType, ValueType, Comparer>::operator!=(const ezBTreeMapBase<KeyType, ValueType, Comparer>& rhs) const
+{
+  return !operator==(rhs);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+ezUInt64 ezBTreeMapBase<KeyType, ValueType, Comparer>::GetHeapMemoryUsage() const
+{
+  return (ezUInt64)m_uiNumLeafNodes * sizeof(LeafNode) + (ezUInt64)m_uiNumInnerNodes * sizeof(InnerNode);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+void ezBTreeMapBase<KeyType, ValueType, Comparer>::Swap(ezBTreeMapBase<KeyType, ValueType, Comparer>& other)
+{
+  ezMath::Swap(m_pRoot, other.m_pRoot);
+  ezMath::Swap(m_pFirstLeaf, other.m_pFirstLeaf);
+  ezMath::Swap(m_pLastLeaf, other.m_pLastLeaf);
+  ezMath::Swap(m_uiCount, other.m_uiCount);
+  ezMath::Swap(m_uiNumLeafNodes, other.m_uiNumLeafNodes);
+  ezMath::Swap(m_uiNumInnerNodes, other.m_uiNumInnerNodes);
+  ezMath::Swap(m_pAllocator, other.m_pAllocator);
+  ezMath::Swap(m_Comparer, other.m_Comparer);
+}
+
+// ***** private methods *****
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE ezUInt32 ezBTreeMapBase<KeyType, ValueType, Comparer>::LowerBoundInLeaf(LeafNode* pLeaf, const CompatibleKeyType& key) const
+{
+  const KeyType* pKeys = pLeaf->Keys();
+  ezUInt32 lb = 0;
+  ezUInt32 ub = pLeaf->m_uiCount;
+
+  while (lb < ub)
+  {
+    const ezUInt32 middle = lb + ((ub - lb) >> 1);
+
+    if (m_Comparer.Less(pKeys[middle], key))
+      lb = middle + 1;
+    else
+      ub = middle;
+  }
+
+  return lb;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE ezUInt32 ezBTreeMapBase<KeyType, ValueType, Comparer>::UpperBoundInLeaf(LeafNode* pLeaf, const CompatibleKeyType& key) const
+{
+  const KeyType* pKeys = pLeaf->Keys();
+  ezUInt32 lb = 0;
+  ezUInt32 ub = pLeaf->m_uiCount;
+
+  while (lb < ub)
+  {
+    const ezUInt32 middle = lb + ((ub - lb) >> 1);
+
+    if (m_Comparer.Less(key, pKeys[middle]))
+      ub = middle;
+    else
+      lb = middle + 1;
+  }
+
+  return lb;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE ezUInt32 ezBTreeMapBase<KeyType, ValueType, Comparer>::FindChild(InnerNode* pInner, const CompatibleKeyType& key) const
+{
+  // keys equal to a separator are stored in the child to the right of it
+  const KeyType* pKeys = pInner->Keys();
+  ezUInt32 lb = 0;
+  ezUInt32 ub = pInner->m_uiCount;
+
+  while (lb < ub)
+  {
+    const ezUInt32 middle = lb + ((ub - lb) >> 1);
+
+    if (m_Comparer.Less(key, pKeys[middle]))
+      ub = middle;
+    else
+      lb = middle + 1;
+  }
+
+  return lb;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::LeafNode* ezBTreeMapBase<KeyType, ValueType, Comparer>::FindLeaf(const CompatibleKeyType& key) const
+{
+  Node* pNode = m_pRoot;
+
+  while (!pNode->m_bIsLeaf)
+  {
+    InnerNode* pInner = static_cast<InnerNode*>(pNode);
+    pNode = pInner->m_pChildren[FindChild(pInner, key)];
+  }
+
+  return static_cast<LeafNode*>(pNode);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator ezBTreeMapBase<KeyType, ValueType, Comparer>::Internal_Find(const CompatibleKeyType& key) const
+{
+  if (m_pRoot == nullptr)
+    return ConstIterator();
+
+  LeafNode* pLeaf = FindLeaf(key);
+  const ezUInt32 uiIndex = LowerBoundInLeaf(pLeaf, key);
+
+  if (uiIndex < pLeaf->m_uiCount && !m_Comparer.Less(key, pLeaf->Keys()[uiIndex]))
+    return ConstIterator(pLeaf, uiIndex);
+
+  return ConstIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator ezBTreeMapBase<KeyType, ValueType, Comparer>::Internal_LowerBound(const CompatibleKeyType& key) const
+{
+  if (m_pRoot == nullptr)
+    return ConstIterator();
+
+  LeafNode* pLeaf = FindLeaf(key);
+  const ezUInt32 uiIndex = LowerBoundInLeaf(pLeaf, key);
+
+  // all keys in the following leaf are larger than the separator that led us here, which is larger than the key
+  if (uiIndex == pLeaf->m_uiCount)
+    return ConstIterator(pLeaf->m_pNext, 0);
+
+  return ConstIterator(pLeaf, uiIndex);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::ConstIterator ezBTreeMapBase<KeyType, ValueType, Comparer>::Internal_UpperBound(const CompatibleKeyType& key) const
+{
+  if (m_pRoot == nullptr)
+    return ConstIterator();
+
+  LeafNode* pLeaf = FindLeaf(key);
+  const ezUInt32 uiIndex = UpperBoundInLeaf(pLeaf, key);
+
+  if (uiIndex == pLeaf->m_uiCount)
+    return ConstIterator(pLeaf->m_pNext, 0);
+
+  return ConstIterator(pLeaf, uiIndex);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::LeafNode* ezBTreeMapBase<KeyType, ValueType, Comparer>::PrepareInsert(const CompatibleKeyType& key, ezUInt32& out_uiIndex, bool& out_bExisted)
+{
+  if (m_pRoot == nullptr)
+  {
+    LeafNode* pLeaf = AllocateLeaf();
+    m_pRoot = pLeaf;
+    m_pFirstLeaf = pLeaf;
+    m_pLastLeaf = pLeaf;
+  }
+
+  // Full nodes are split on the way down, so every split only needs to insert a separator into a parent that has room for it.
+  const ezUInt32 uiRootCapacity = m_pRoot->m_bIsLeaf ? LEAF_CAPACITY : INNER_CAPACITY;
+  if (m_pRoot->m_uiCount == uiRootCapacity)
+  {
+    InnerNode* pNewRoot = AllocateInner();
+    pNewRoot->m_pChildren[0] = m_pRoot;
+    m_pRoot = pNewRoot;
+    SplitChild(pNewRoot, 0, key);
+  }
+
+  Node* pNode = m_pRoot;
+  while (!pNode->m_bIsLeaf)
+  {
+    InnerNode* pInner = static_cast<InnerNode*>(pNode);
+    ezUInt32 uiChild = FindChild(pInner, key);
+
+    Node* pChild = pInner->m_pChildren[uiChild];
+    if (pChild->m_uiCount == (pChild->m_bIsLeaf ? LEAF_CAPACITY : INNER_CAPACITY))
+    {
+      SplitChild(pInner, uiChild, key);
+
+      if (!m_Comparer.Less(key, pInner->Keys()[uiChild]))
+        ++uiChild;
+    }
+
+    pNode = pInner->m_pChildren[uiChild];
+  }
+
+  LeafNode* pLeaf = static_cast<LeafNode*>(pNode);
+  out_uiIndex = LowerBoundInLeaf(pLeaf, key);
+  out_bExisted = out_uiIndex < pLeaf->m_uiCount && !m_Comparer.Less(key, pLeaf->Keys()[out_uiIndex]);
+
+  if (!out_bExisted)
+  {
+    // make room for the new element, the caller constructs it
+    ezInternal::BTreeRelocate(pLeaf->Keys() + out_uiIndex + 1, pLeaf->Keys() + out_uiIndex, pLeaf->m_uiCount - out_uiIndex);
+    ezInternal::BTreeRelocate(pLeaf->Values() + out_uiIndex + 1, pLeaf->Values() + out_uiIndex, pLeaf->m_uiCount - out_uiIndex);
+    ++pLeaf->m_uiCount;
+    ++m_uiCount;
+  }
+
+  return pLeaf;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+void ezBTreeMapBase<KeyType, ValueType, Comparer>::SplitChild(InnerNode* pParent, ezUInt32 uiChildIndex, const CompatibleKeyType& insertKey)
+{
+  EZ_ASSERT_DEBUG(pParent->m_uiCount < INNER_CAPACITY, "Implementation error: parent node must not be full");
+
+  // make room for the separator and the new child in the parent
+  ezInternal::BTreeRelocate(pParent->Keys() + uiChildIndex + 1, pParent->Keys() + uiChildIndex, pParent->m_uiCount - uiChildIndex);
+  ezMemoryUtils::CopyOverlapped(pParent->m_pChildren + uiChildIndex + 2, pParent->m_pChildren + uiChildIndex + 1, pParent->m_uiCount - uiChildIndex);
+
+  Node* pChild = pParent->m_pChildren[uiChildIndex];
+
+  if (pChild->m_bIsLeaf)
+  {
+    LeafNode* pLeft = static_cast<LeafNode*>(pChild);
+    LeafNode* pRight = AllocateLeaf();
+
+    // When appending to the very end, leave the full leaf as it is and start a new one. This way sequential insertion
+    // produces completely filled leaves instead of half empty ones.
+    const bool bAppend = (pLeft == m_pLastLeaf) && m_Comparer.Less(pLeft->Keys()[pLeft->m_uiCount - 1], insertKey);
+    const ezUInt32 uiSplit = bAppend ? pLeft->m_uiCount : (ezUInt32)LEAF_CAPACITY / 2;
+    const ezUInt32 uiMoveCount = pLeft->m_uiCount - uiSplit;
+
+    ezInternal::BTreeRelocate(pRight->Keys(), pLeft->Keys() + uiSplit, uiMoveCount);
+    ezInternal::BTreeRelocate(pRight->Values(), pLeft->Values() + uiSplit, uiMoveCount);
+    pRight->m_uiCount = static_cast<ezUInt16>(uiMoveCount);
+    pLeft->m_uiCount = static_cast<ezUInt16>(uiSplit);
+
+    pRight->m_pPrev = pLeft;
+    pRight->m_pNext = pLeft->m_pNext;
+    if (pLeft->m_pNext != nullptr)
+      pLeft->m_pNext->m_pPrev = pRight;
+    else
+      m_pLastLeaf = pRight;
+    pLeft->m_pNext = pRight;
+
+    if (bAppend)
+      ezMemoryUtils::CopyConstruct<KeyType>(pParent->Keys() + uiChildIndex, insertKey, 1);
+    else
+      ezMemoryUtils::CopyConstruct<KeyType>(pParent->Keys() + uiChildIndex, pRight->Keys()[0], 1);
+
+    pParent->m_pChildren[uiChildIndex + 1] = pRight;
+  }
+  else
+  {
+    InnerNode* pLeft = static_cast<InnerNode*>(pChild);
+    InnerNode* pRight = AllocateInner();
+
+    // the middle key moves up into the parent
+    const ezUInt32 uiMiddle = pLeft->m_uiCount / 2;
+    const ezUInt32 uiMoveCount = pLeft->m_uiCount - uiMiddle - 1;
+
+    ezInternal::BTreeRelocate(pRight->Keys(), pLeft->Keys() + uiMiddle + 1, uiMoveCount);
+    ezMemoryUtils::Copy(pRight->m_pChildren, pLeft->m_pChildren + uiMiddle + 1, uiMoveCount + 1);
+    ezInternal::BTreeRelocate(pParent->Keys() + uiChildIndex, pLeft->Keys() + uiMiddle, 1);
+
+    pRight->m_uiCount = static_cast<ezUInt16>(uiMoveCount);
+    pLeft->m_uiCount = static_cast<ezUInt16>(uiMiddle);
+
+    pParent->m_pChildren[uiChildIndex + 1] = pRight;
+  }
+
+  ++pParent->m_uiCount;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+ezUInt32 ezBTreeMapBase<KeyType, ValueType, Comparer>::FixUnderflow(InnerNode* pParent, ezUInt32 uiChildIndex)
+{
+  Node* pChild = pParent->m_pChildren[uiChildIndex];
+  Node* pLeftNode = uiChildIndex > 0 ? pParent->m_pChildren[uiChildIndex - 1] : nullptr;
+  Node* pRightNode = uiChildIndex < pParent->m_uiCount ? pParent->m_pChildren[uiChildIndex + 1] : nullptr;
+
+  // merging removes one separator and one child from the parent
+  auto RemoveFromParent = [pParent](ezUInt32 uiSeparator) {
+    ezInternal::BTreeRelocate(pParent->Keys() + uiSeparator, pParent->Keys() + uiSeparator + 1, pParent->m_uiCount - uiSeparator - 1);
+    ezMemoryUtils::CopyOverlapped(pParent->m_pChildren + uiSeparator + 1, pParent->m_pChildren + uiSeparator + 2, pParent->m_uiCount - uiSeparator - 1);
+    --pParent->m_uiCount;
+  };
+
+  if (pChild->m_bIsLeaf)
+  {
+    LeafNode* pNode = static_cast<LeafNode*>(pChild);
+    LeafNode* pLeft = static_cast<LeafNode*>(pLeftNode);
+    LeafNode* pRight = static_cast<LeafNode*>(pRightNode);
+
+    if (pLeft != nullptr && pLeft->m_uiCount > LEAF_MIN_COUNT)
+    {
+      ezInternal::BTreeRelocate(pNode->Keys() + 1, pNode->Keys(), pNode->m_uiCount);
+      ezInternal::BTreeRelocate(pNode->Values() + 1, pNode->Values(), pNode->m_uiCount);
+      ezInternal::BTreeRelocate(pNode->Keys(), pLeft->Keys() + pLeft->m_uiCount - 1, 1);
+      ezInternal::BTreeRelocate(pNode->Values(), pLeft->Values() + pLeft->m_uiCount - 1, 1);
+      --pLeft->m_uiCount;
+      ++pNode->m_uiCount;
+
+      pParent->Keys()[uiChildIndex - 1] = pNode->Keys()[0];
+      return uiChildIndex;
+    }
+
+    if (pRight != nullptr && pRight->m_uiCount > LEAF_MIN_COUNT)
+    {
+      ezInternal::BTreeRelocate(pNode->Keys() + pNode->m_uiCount, pRight->Keys(), 1);
+      ezInternal::BTreeRelocate(pNode->Values() + pNode->m_uiCount, pRight->Values(), 1);
+      ezInternal::BTreeRelocate(pRight->Keys(), pRight->Keys() + 1, pRight->m_uiCount - 1);
+      ezInternal::BTreeRelocate(pRight->Values(), pRight->Values() + 1, pRight->m_uiCount - 1);
+      --pRight->m_uiCount;
+      ++pNode->m_uiCount;
+
+      pParent->Keys()[uiChildIndex] = pRight->Keys()[0];
+      return uiChildIndex;
+    }
+
+    // merge with a sibling, the right one of the two nodes gets deleted
+    ezUInt32 uiSeparator = uiChildIndex;
+    if (pLeft != nullptr)
+    {
+      pRight = pNode;
+      pNode = pLeft;
+      uiSeparator = uiChildIndex - 1;
+    }
+
+    ezInternal::BTreeRelocate(pNode->Keys() + pNode->m_uiCount, pRight->Keys(), pRight->m_uiCount);
+    ezInternal::BTreeRelocate(pNode->Values() + pNode->m_uiCount, pRight->Values(), pRight->m_uiCount);
+    pNode->m_uiCount += pRight->m_uiCount;
+    pRight->m_uiCount = 0;
+
+    pNode->m_pNext = pRight->m_pNext;
+    if (pRight->m_pNext != nullptr)
+      pRight->m_pNext->m_pPrev = pNode;
+    else
+      m_pLastLeaf = pNode;
+
+    FreeNode(pRight, false);
+
+    ezMemoryUtils::Destruct(pParent->Keys() + uiSeparator, 1);
+    RemoveFromParent(uiSeparator);
+    return uiSeparator;
+  }
+  else
+  {
+    InnerNode* pNode = static_cast<InnerNode*>(pChild);
+    InnerNode* pLeft = static_cast<InnerNode*>(pLeftNode);
+    InnerNode* pRight = static_cast<InnerNode*>(pRightNode);
+
+    if (pLeft != nullptr && pLeft->m_uiCount > INNER_MIN_COUNT)
+    {
+      // rotate the separator down into this node and the last key of the left sibling up into the parent
+      ezInternal::BTreeRelocate(pNode->Keys() + 1, pNode->Keys(), pNode->m_uiCount);
+      ezMemoryUtils::CopyOverlapped(pNode->m_pChildren + 1, pNode->m_pChildren, pNode->m_uiCount + 1);
+      ezInternal::BTreeRelocate(pNode->Keys(), pParent->Keys() + uiChildIndex - 1, 1);
+      pNode->m_pChildren[0] = pLeft->m_pChildren[pLeft->m_uiCount];
+      ezInternal::BTreeRelocate(pParent->Keys() + uiChildIndex - 1, pLeft->Keys() + pLeft->m_uiCount - 1, 1);
+      --pLeft->m_uiCount;
+      ++pNode->m_uiCount;
+      return uiChildIndex;
+    }
+
+    if (pRight != nullptr && pRight->m_uiCount > INNER_MIN_COUNT)
+    {
+      ezInternal::BTreeRelocate(pNode->Keys() + pNode->m_uiCount, pParent->Keys() + uiChildIndex, 1);
+      pNode->m_pChildren[pNode->m_uiCount + 1] = pRight->m_pChildren[0];
+      ezInternal::BTreeRelocate(pParent->Keys() + uiChildIndex, pRight->Keys(), 1);
+      ezInternal::BTreeRelocate(pRight->Keys(), pRight->Keys() + 1, pRight->m_uiCount - 1);
+      ezMemoryUtils::CopyOverlapped(pRight->m_pChildren, pRight->m_pChildren + 1, pRight->m_uiCount);
+      --pRight->m_uiCount;
+      ++pNode->m_uiCount;
+      return uiChildIndex;
+    }
+
+    ezUInt32 uiSeparator = uiChildIndex;
+    if (pLeft != nullptr)
+    {
+      pRight = pNode;
+      pNode = pLeft;
+      uiSeparator = uiChildIndex - 1;
+    }
+
+    // the separator moves down between the keys of both nodes
+    ezInternal::BTreeRelocate(pNode->Keys() + pNode->m_uiCount, pParent->Keys() + uiSeparator, 1);
+    ezInternal::BTreeRelocate(pNode->Keys() + pNode->m_uiCount + 1, pRight->Keys(), pRight->m_uiCount);
+    ezMemoryUtils::Copy(pNode->m_pChildren + pNode->m_uiCount + 1, pRight->m_pChildren, pRight->m_uiCount + 1);
+    pNode->m_uiCount += pRight->m_uiCount + 1;
+    pRight->m_uiCount = 0;
+
+    FreeNode(pRight, false);
+
+    RemoveFromParent(uiSeparator);
+    return uiSeparator;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+template <typename CompatibleKeyType>
+bool ezBTreeMapBase<KeyType, ValueType, Comparer>::Internal_Remove(const CompatibleKeyType& key)
+{
+  if (m_pRoot == nullptr)
+    return false;
+
+  // Nodes with the minimum number of keys are refilled on the way down, so removing from the leaf never needs to walk back up.
+  Node* pNode = m_pRoot;
+  while (!pNode->m_bIsLeaf)
+  {
+    InnerNode* pInner = static_cast<InnerNode*>(pNode);
+    ezUInt32 uiChild = FindChild(pInner, key);
+
+    Node* pChild = pInner->m_pChildren[uiChild];
+    if (pChild->m_uiCount <= (pChild->m_bIsLeaf ? LEAF_MIN_COUNT : INNER_MIN_COUNT))
+    {
+      uiChild = FixUnderflow(pInner, uiChild);
+      pChild = pInner->m_pChildren[uiChild];
+    }
+
+    if (pInner->m_uiCount == 0)
+    {
+      // only the root can run empty, the tree shrinks by one level
+      EZ_ASSERT_DEBUG(pInner == m_pRoot, "Implementation error: inner node ran empty");
+      m_pRoot = pChild;
+      FreeNode(pInner, false);
+    }
+
+    pNode = pChild;
+  }
+
+  LeafNode* pLeaf = static_cast<LeafNode*>(pNode);
+  const ezUInt32 uiIndex = LowerBoundInLeaf(pLeaf, key);
+
+  if (uiIndex == pLeaf->m_uiCount || m_Comparer.Less(key, pLeaf->Keys()[uiIndex]))
+    return false;
+
+  ezMemoryUtils::Destruct(pLeaf->Keys() + uiIndex, 1);
+  ezMemoryUtils::Destruct(pLeaf->Values() + uiIndex, 1);
+  ezInternal::BTreeRelocate(pLeaf->Keys() + uiIndex, pLeaf->Keys() + uiIndex + 1, pLeaf->m_uiCount - uiIndex - 1);
+  ezInternal::BTreeRelocate(pLeaf->Values() + uiIndex, pLeaf->Values() + uiIndex + 1, pLeaf->m_uiCount - uiIndex - 1);
+  --pLeaf->m_uiCount;
+  --m_uiCount;
+
+  if (m_uiCount == 0)
+  {
+    Clear();
+  }
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::LeafNode* ezBTreeMapBase<KeyType, ValueType, Comparer>::AllocateLeaf()
+{
+  LeafNode* pLeaf = EZ_NEW(m_pAllocator, LeafNode);
+  pLeaf->m_bIsLeaf = true;
+  ++m_uiNumLeafNodes;
+  return pLeaf;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+typename ezBTreeMapBase<KeyType, ValueType, Comparer>::InnerNode* ezBTreeMapBase<KeyType, ValueType, Comparer>::AllocateInner()
+{
+  InnerNode* pInner = EZ_NEW(m_pAllocator, InnerNode);
+  pInner->m_bIsLeaf = false;
+  ++m_uiNumInnerNodes;
+  return pInner;
+}
+
+template <typename KeyType, typename ValueType, typename Comparer>
+void ezBTreeMapBase<KeyType, ValueType, Comparer>::FreeNode(Node* pNode, bool bDestructContent)
+{
+  if (pNode->m_bIsLeaf)
+  {
+    LeafNode* pLeaf = static_cast<LeafNode*>(pNode);
+
+    if (bDestructContent)
+    {
+      ezMemoryUtils::Destruct(pLeaf->Keys(), pLeaf->m_uiCount);
+      ezMemoryUtils::Destruct(pLeaf->Values(), pLeaf->m_uiCount);
+    }
+
+    EZ_DELETE(m_pAllocator, pLeaf);
+    --m_uiNumLeafNodes;
+  }
+  else
+  {
+    InnerNode* pInner = static_cast<InnerNode*>(pNode);
+
+    if (bDestructContent)
+    {
+      for (ezUInt32 i = 0; i <= pInner->m_uiCount; ++i)
+      {
+        FreeNode(pInner->m_pChildren[i], true);
+      }
+
+      ezMemoryUtils::Destruct(pInner->Keys(), pInner->m_uiCount);
+    }
+
+    EZ_DELETE(m_pAllocator, pInner);
+    --m_uiNumInnerNodes;
+  }
+}
+
+
+template <typename KeyType, typename ValueType, typename Comparer, typename AllocatorWrapper>
+ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>::ezBTreeMap()
+  : ezBTreeMapBase<KeyType, ValueType, Comparer>(Comparer(), AllocatorWrapper::GetAllocator())
+{
+}
+
+template <typename KeyType, typename ValueType, typename Comparer, typename AllocatorWrapper>
+ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>::ezBTreeMap(ezAllocatorBase* pAllocator)
+  : ezBTreeMapBase<KeyType, ValueType, Comparer>(Comparer(), pAllocator)
+{
+}
+
+template <typename KeyType, typename ValueType, typename Comparer, typename AllocatorWrapper>
+ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>::ezBTreeMap(const Comparer& comparer, ezAllocatorBase* pAllocator)
+  : ezBTreeMapBase<KeyType, ValueType, Comparer>(comparer, pAllocator)
+{
+}
+
+template <typename KeyType, typename ValueType, typename Comparer, typename AllocatorWrapper>
+ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>::ezBTreeMap(const ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>& other)
+  : ezBTreeMapBase<KeyType, ValueType, Comparer>(other, AllocatorWrapper::GetAllocator())
+{
+}
+
+template <typename KeyType, typename ValueType, typename Comparer, typename AllocatorWrapper>
+ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>::ezBTreeMap(const ezBTreeMapBase<KeyType, ValueType, Comparer>& other)
+  : ezBTreeMapBase<KeyType, ValueType, Comparer>(other, AllocatorWrapper::GetAllocator())
+{
+}
+
+template <typename KeyType, typename ValueType, typename Comparer, typename AllocatorWrapper>
+void ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>::operator=(const ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>& rhs)
+{
+  ezBTreeMapBase<KeyType, ValueType, Comparer>::operator=(rhs);
+}
+
+template <typename KeyType, typename ValueType, typename Comparer, typename AllocatorWrapper>
+void ezBTreeMap<KeyType, ValueType, Comparer, AllocatorWrapper>::operator=(const ezBTreeMapBase<KeyType, ValueType, Comparer>& rhs)
+{
+  ezBTreeMapBase<KeyType, ValueType, Comparer>::operator=(rhs);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+template <typename KeyType, typename Comparer>
+ezBTreeSetBase<KeyType, Comparer>::ezBTreeSetBase(const Comparer& comparer, ezAllocatorBase* pAllocator)
+  : TreeType(comparer, pAllocator)
+{
+}
+
+template <typename KeyType, typename Comparer>
+ezBTreeSetBase<KeyType, Comparer>::ezBTreeSetBase(const ezBTreeSetBase<KeyType, Comparer>& cc, ezAllocatorBase* pAllocator)
+  : TreeType(cc, pAllocator)
+{
+}
+
+template <typename KeyType, typename Comparer>
+void ezBTreeSetBase<KeyType, Comparer>::operator=(const ezBTreeSetBase<KeyType, Comparer>& rhs)
+{
+  TreeType::operator=(rhs);
+}
+
+template <typename KeyType, typename Comparer>
+template <typename CompatibleKeyType>
+typename ezBTreeSetBase<KeyType, Comparer>::Iterator ezBTreeSetBase<KeyType, Comparer>::Insert(CompatibleKeyType&& key)
+{
+  return Iterator(TreeType::FindOrAdd(std::forward<CompatibleKeyType>(key)));
+}
+
+template <typename KeyType, typename Comparer>
+typename ezBTreeSetBase<KeyType, Comparer>::Iterator ezBTreeSetBase<KeyType, Comparer>::Remove(const Iterator& pos)
+{
+  EZ_ASSERT_DEBUG(pos.IsValid(), "The Iterator is invalid.");
+
+  return Iterator(TreeType::Remove(TreeType::Find(pos.Key())));
+}
+
+
+template <typename KeyType, typename Comparer, typename AllocatorWrapper>
+ezBTreeSet<KeyType, Comparer, AllocatorWrapper>::ezBTreeSet()
+  : ezBTreeSetBase<KeyType, Comparer>(Comparer(), AllocatorWrapper::GetAllocator())
+{
+}
+
+template <typename KeyType, typename Comparer, typename AllocatorWrapper>
+ezBTreeSet<KeyType, Comparer, AllocatorWrapper>::ezBTreeSet(ezAllocatorBase* pAllocator)
+  : ezBTreeSetBase<KeyType, Comparer>(Comparer(), pAllocator)
+{
+}
+
+template <typename KeyType, typename Comparer, typename AllocatorWrapper>
+ezBTreeSet<KeyType, Comparer, AllocatorWrapper>::ezBTreeSet(const Comparer& comparer, ezAllocatorBase* pAllocator)
+  : ezBTreeSetBase<KeyType, Comparer>(comparer, pAllocator)
+{
+}
+
+template <typename KeyType, typename Comparer, typename AllocatorWrapper>
+ezBTreeSet<KeyType, Comparer, AllocatorWrapper>::ezBTreeSet(const ezBTreeSet<KeyType, Comparer, AllocatorWrapper>& other)
+  : ezBTreeSetBase<KeyType, Comparer>(other, AllocatorWrapper::GetAllocator())
+{
+}
+
+template <typename KeyType, typename Comparer, typename AllocatorWrapper>
+ezBTreeSet<KeyType, Comparer, AllocatorWrapper>::ezBTreeSet(const ezBTreeSetBase<KeyType, Comparer>& other)
+  : ezBTreeSetBase<KeyType, Comparer>(other, AllocatorWrapper::GetAllocator())
+{
+}
+
+template <typename KeyType, typename Comparer, typename AllocatorWrapper>
+void ezBTreeSet<KeyType, Comparer, AllocatorWrapper>::operator=(const ezBTreeSet<KeyType, Comparer, AllocatorWrapper>& rhs)
+{
+  ezBTreeSetBase<KeyType, Comparer>::operator=(rhs);
+}
+
+template <typename KeyType, typename Comparer, typename AllocatorWrapper>
+void ezBTreeSet<KeyType, Comparer, AllocatorWrapper>::operator=(const ezBTreeSetBase<KeyType, Comparer>& rhs)
+{
+  ezBTreeSetBase<KeyType, Comparer>::operator=(rhs);
+}
@@ -0,0 +1,876 @@
+
+/// \brief Value used by containers for indices to indicate an invalid index.
+#ifndef ezInvalidIndex
+#  define ezInvalidIndex 0xFFFFFFFF
+#endif
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+#  include <emmintrin.h>
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace ezInternal
+{
+  /// \brief Loads the 16 control bytes of one ezSwissHashTable group and compares them all at once.
+  ///
+  /// The match functions return a bitmask with one set bit per matching control byte. With NEON there is no movemask
+  /// instruction, so every control byte maps to a nibble of a 64 bit mask of which only the highest bit is kept.
+  struct SwissHashTableGroup
+  {
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+    using Mask = ezUInt32;
+    static constexpr ezUInt32 MaskShift = 0;
+
+    EZ_ALWAYS_INLINE explicit SwissHashTableGroup(const ezUInt8* pControlBytes)
+      : m_Control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pControlBytes)))
+    {
+    }
+
+    EZ_ALWAYS_INLINE Mask Match(ezUInt8 uiFragment) const
+    {
+      return static_cast<Mask>(_mm_movemask_epi8(_mm_cmpeq_epi8(m_Control, _mm_set1_epi8(static_cast<char>(uiFragment)))));
+    }
+
+    // 'empty' and 'deleted' are the only control bytes with the highest bit set
+    EZ_ALWAYS_INLINE Mask MatchEmptyOrDeleted() const { return static_cast<Mask>(_mm_movemask_epi8(m_Control)); }
+
+    __m128i m_Control;
+
+#elif EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_NEON
+    using Mask = ezUInt64;
+    static constexpr ezUInt32 MaskShift = 2;
+
+    EZ_ALWAYS_INLINE explicit SwissHashTableGroup(const ezUInt8* pControlBytes)
+      : m_Control(vld1q_u8(pControlBytes))
+    {
+    }
+
+    EZ_ALWAYS_INLINE static Mask ToMask(uint8x16_t comparison)
+    {
+      const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(comparison), 4);
+      return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ull;
+    }
+
+    EZ_ALWAYS_INLINE Mask Match(ezUInt8 uiFragment) const { return ToMask(vceqq_u8(m_Control, vdupq_n_u8(uiFragment))); }
+
+    // 'empty' and 'deleted' are the only control bytes with the highest bit set
+    EZ_ALWAYS_INLINE Mask MatchEmptyOrDeleted() const { return ToMask(vcltq_s8(vreinterpretq_s8_u8(m_Control), vdupq_n_s8(0))); }
+
+    uint8x16_t m_Control;
+
+#else
+    using Mask = ezUInt32;
+    static constexpr ezUInt32 MaskShift = 0;
+
+    EZ_ALWAYS_INLINE explicit SwissHashTableGroup(const ezUInt8* pControlBytes)
+      : m_pControl(pControlBytes)
+    {
+    }
+
+    EZ_FORCE_INLINE Mask Match(ezUInt8 uiFragment) const
+    {
+      Mask mask = 0;
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        mask |= static_cast<Mask>(m_pControl[i] == uiFragment) << i;
+      }
+      return mask;
+    }
+
+    EZ_FORCE_INLINE Mask MatchEmptyOrDeleted() const
+    {
+      Mask mask = 0;
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        mask |= static_cast<Mask>(m_pControl[i] >> 7) << i;
+      }
+      return mask;
+    }
+
+    const ezUInt8* m_pControl;
+#endif
+
+    EZ_ALWAYS_INLINE Mask MatchEmpty() const { return Match(0x80); }
+
+    /// \brief Returns the index within the group of the lowest set bit in the mask.
+    EZ_ALWAYS_INLINE static ezUInt32 GetLowestIndex(Mask mask) { return ezMath::CountTrailingZeros(mask) >> MaskShift; }
+
+    EZ_ALWAYS_INLINE static Mask ClearLowest(Mask mask) { return mask & (mask - 1); }
+  };
+} // namespace ezInternal
+
+// ***** Const Iterator *****
+
+template <typename K, typename V, typename H>
+ezSwissHashTableBase<K, V, H>::ConstIterator::ConstIterator(const ezSwissHashTableBase<K, V, H>& hashTable)
+  : m_pHashTable(&hashTable)
+{
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::ConstIterator::SetToBegin()
+{
+  if (m_pHashTable->IsEmpty())
+  {
+    m_uiCurrentIndex = m_pHashTable->m_uiCapacity;
+    return;
+  }
+  while (!m_pHashTable->IsValidEntry(m_uiCurrentIndex))
+  {
+    ++m_uiCurrentIndex;
+  }
+}
+
+template <typename K, typename V, typename H>
+inline void ezSwissHashTableBase<K, V, H>::ConstIterator::SetToEnd()
+{
+  m_uiCurrentCount = m_pHashTable->m_uiCount;
+  m_uiCurrentIndex = m_pHashTable->m_uiCapacity;
+}
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE bool ezSwissHashTableBase<K, V, H>::ConstIterator::IsValid() const
+{
+  return m_uiCurrentCount < m_pHashTable->m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE bool ezSwissHashTableBase<K, V, H>::ConstIterator::operator==(const typename ezSwissHashTableBase<K, V, H>::ConstIterator& rhs) const
+{
+  return m_uiCurrentIndex == rhs.m_uiCurrentIndex && m_pHashTable->m_pEntries == rhs.m_pHashTable->m_pEntries;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezSwissHashTableBase<K, V, H>::ConstIterator::operator!=(const typename ezSwissHashTableBase<K, V, H>::ConstIterator& rhs) const
+{
+  return !(*this == rhs);
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE const K& ezSwissHashTableBase<K, V, H>::ConstIterator::Key() const
+{
+  return m_pHashTable->m_pEntries[m_uiCurrentIndex].key;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE const V& ezSwissHashTableBase<K, V, H>::ConstIterator::Value() const
+{
+  return m_pHashTable->m_pEntries[m_uiCurrentIndex].value;
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::ConstIterator::Next()
+{
+  // if we already iterated over the amount of valid elements that the hash-table stores, early out
+  if (m_uiCurrentCount >= m_pHashTable->m_uiCount)
+    return;
+
+  ++m_uiCurrentCount;
+  ++m_uiCurrentIndex;
+
+  while (m_uiCurrentIndex < m_pHashTable->m_uiCapacity)
+  {
+    if (m_pHashTable->IsValidEntry(m_uiCurrentIndex))
+      return;
+
+    ++m_uiCurrentIndex;
+  }
+
+  // reached the end, make 'IsValid' return 'false'
+  m_uiCurrentCount = m_pHashTable->m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezSwissHashTableBase<K, V, H>::ConstIterator::operator++()
+{
+  Next();
+}
+
+
+// ***** Iterator *****
+
+template <typename K, typename V, typename H>
+ezSwissHashTableBase<K, V, H>::Iterator::Iterator(const ezSwissHashTableBase<K, V, H>& hashTable)
+  : ConstIterator(hashTable)
+{
+}
+
+template <typename K, typename V, typename H>
+ezSwissHashTableBase<K, V, H>::Iterator::Iterator(const typename ezSwissHashTableBase<K, V, H>::Iterator& rhs)
+  : ConstIterator(*rhs.m_pHashTable)
+{
+  this->m_uiCurrentIndex = rhs.m_uiCurrentIndex;
+  this->m_uiCurrentCount = rhs.m_uiCurrentCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE void ezSwissHashTableBase<K, V, H>::Iterator::operator=(const Iterator& rhs)
+{
+  this->m_pHashTable = rhs.m_pHashTable;
+  this->m_uiCurrentIndex = rhs.m_uiCurrentIndex;
+  this->m_uiCurrentCount = rhs.m_uiCurrentCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE V& ezSwissHashTableBase<K, V, H>::Iterator::Value()
+{
+  return this->m_pHashTable->m_pEntries[this->m_uiCurrentIndex].value;
+}
+
+
+// ***** ezSwissHashTableBase *****
+
+template <typename K, typename V, typename H>
+ezSwissHashTableBase<K, V, H>::ezSwissHashTableBase(ezAllocatorBase* pAllocator)
+{
+  m_pEntries = nullptr;
+  m_pControlBytes = nullptr;
+  m_uiCount = 0;
+  m_uiCapacity = 0;
+  m_uiGrowthLeft = 0;
+  m_pAllocator = pAllocator;
+}
+
+template <typename K, typename V, typename H>
+ezSwissHashTableBase<K, V, H>::ezSwissHashTableBase(const ezSwissHashTableBase<K, V, H>& other, ezAllocatorBase* pAllocator)
+  : ezSwissHashTableBase(pAllocator)
+{
+  *this = other;
+}
+
+template <typename K, typename V, typename H>
+ezSwissHashTableBase<K, V, H>::ezSwissHashTableBase(ezSwissHashTableBase<K, V, H>&& other, ezAllocatorBase* pAllocator)
+  : ezSwissHashTableBase(pAllocator)
+{
+  *this = std::move(other);
+}
+
+template <typename K, typename V, typename H>
+ezSwissHashTableBase<K, V, H>::~ezSwissHashTableBase()
+{
+  Clear();
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControlBytes);
+  m_uiCapacity = 0;
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::operator=(const ezSwissHashTableBase<K, V, H>& rhs)
+{
+  Clear();
+  Reserve(rhs.GetCount());
+
+  ezUInt32 uiCopied = 0;
+  for (ezUInt32 i = 0; uiCopied < rhs.GetCount(); ++i)
+  {
+    if (rhs.IsValidEntry(i))
+    {
+      Insert(rhs.m_pEntries[i].key, rhs.m_pEntries[i].value);
+      ++uiCopied;
+    }
+  }
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::operator=(ezSwissHashTableBase<K, V, H>&& rhs)
+{
+  // Clear any existing data (calls destructors if necessary)
+  Clear();
+
+  if (m_pAllocator != rhs.m_pAllocator)
+  {
+    Reserve(rhs.GetCount());
+
+    ezUInt32 uiCopied = 0;
+    for (ezUInt32 i = 0; uiCopied < rhs.GetCount(); ++i)
+    {
+      if (rhs.IsValidEntry(i))
+      {
+        Insert(std::move(rhs.m_pEntries[i].key), std::move(rhs.m_pEntries[i].value));
+        ++uiCopied;
+      }
+    }
+
+    rhs.Clear();
+  }
+  else
+  {
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControlBytes);
+
+    // Move all data over.
+    m_pEntries = rhs.m_pEntries;
+    m_pControlBytes = rhs.m_pControlBytes;
+    m_uiCount = rhs.m_uiCount;
+    m_uiCapacity = rhs.m_uiCapacity;
+    m_uiGrowthLeft = rhs.m_uiGrowthLeft;
+
+    // Temp copy forgets all its state.
+    rhs.m_pEntries = nullptr;
+    rhs.m_pControlBytes = nullptr;
+    rhs.m_uiCount = 0;
+    rhs.m_uiCapacity = 0;
+    rhs.m_uiGrowthLeft = 0;
+  }
+}
+
+template <typename K, typename V, typename H>
+bool ezSwissHashTableBase<K, V, H>::operator==(const ezSwissHashTableBase<K, V, H>& rhs) const
+{
+  if (m_uiCount != rhs.m_uiCount)
+    return false;
+
+  ezUInt32 uiCompared = 0;
+  for (ezUInt32 i = 0; uiCompared < m_uiCount; ++i)
+  {
+    if (IsValidEntry(i))
+    {
+      const V* pRhsValue = nullptr;
+      if (!rhs.TryGetValue(m_pEntries[i].key, pRhsValue))
+        return false;
+
+      if (m_pEntries[i].value != *pRhsValue)
+        return false;
+
+      ++uiCompared;
+    }
+  }
+
+  return true;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezSwissHashTableBase<K, V, H>::operator!=(const ezSwissHashTableBase<K, V, H>& rhs) const
+{
+  return !(*this == rhs);
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::Reserve(ezUInt32 uiCapacity)
+{
+  if (GetMaxLoad(m_uiCapacity) >= uiCapacity)
+    return;
+
+  SetCapacity(GetRequiredCapacity(uiCapacity));
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::Compact()
+{
+  if (IsEmpty())
+  {
+    // completely deallocate all data, if the table is empty.
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pEntries);
+    EZ_DELETE_RAW_BUFFER(m_pAllocator, m_pControlBytes);
+    m_uiCapacity = 0;
+    m_uiGrowthLeft = 0;
+  }
+  else
+  {
+    // always rehash, even with an unchanged capacity this gets rid of all 'deleted' markers
+    SetCapacity(GetRequiredCapacity(m_uiCount));
+  }
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezUInt32 ezSwissHashTableBase<K, V, H>::GetCount() const
+{
+  return m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE bool ezSwissHashTableBase<K, V, H>::IsEmpty() const
+{
+  return m_uiCount == 0;
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::Clear()
+{
+  if (!std::is_trivially_destructible<Entry>::value)
+  {
+    for (ezUInt32 i = 0; i < m_uiCapacity; ++i)
+    {
+      if (IsValidEntry(i))
+      {
+        ezMemoryUtils::Destruct(&m_pEntries[i].key, 1);
+        ezMemoryUtils::Destruct(&m_pEntries[i].value, 1);
+      }
+    }
+  }
+
+  ezMemoryUtils::PatternFill(m_pControlBytes, static_cast<ezUInt8>(CONTROL_EMPTY), m_uiCapacity);
+  m_uiCount = 0;
+  m_uiGrowthLeft = GetMaxLoad(m_uiCapacity);
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType, typename CompatibleValueType>
+bool ezSwissHashTableBase<K, V, H>::Insert(CompatibleKeyType&& key, CompatibleValueType&& value, V* out_pOldValue /*= nullptr*/)
+{
+  const ezUInt32 uiHash = H::Hash(key);
+  ezUInt32 uiIndex = FindEntry(uiHash, key);
+
+  if (uiIndex != ezInvalidIndex)
+  {
+    if (out_pOldValue != nullptr)
+      *out_pOldValue = std::move(m_pEntries[uiIndex].value);
+
+    m_pEntries[uiIndex].value = std::forward<CompatibleValueType>(value); // Either move or copy assignment.
+    return true;
+  }
+
+  uiIndex = PrepareInsert(uiHash);
+
+  // Both constructions might either be a move or a copy.
+  ezMemoryUtils::CopyOrMoveConstruct(&m_pEntries[uiIndex].key, std::forward<CompatibleKeyType>(key));
+  ezMemoryUtils::CopyOrMoveConstruct(&m_pEntries[uiIndex].value, std::forward<CompatibleValueType>(value));
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+bool ezSwissHashTableBase<K, V, H>::Remove(const CompatibleKeyType& key, V* out_pOldValue /*= nullptr*/)
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    if (out_pOldValue != nullptr)
+      *out_pOldValue = std::move(m_pEntries[uiIndex].value);
+
+    RemoveInternal(uiIndex);
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+typename ezSwissHashTableBase<K, V, H>::Iterator ezSwissHashTableBase<K, V, H>::Remove(const typename ezSwissHashTableBase<K, V, H>::Iterator& pos)
+{
+  EZ_ASSERT_DEBUG(pos.m_pHashTable == this, "Iterator from wrong hashtable");
+  Iterator it = pos;
+  ezUInt32 uiIndex = pos.m_uiCurrentIndex;
+  ++it;
+  --it.m_uiCurrentCount;
+  RemoveInternal(uiIndex);
+  return it;
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::RemoveInternal(ezUInt32 uiIndex)
+{
+  ezMemoryUtils::Destruct(&m_pEntries[uiIndex].key, 1);
+  ezMemoryUtils::Destruct(&m_pEntries[uiIndex].value, 1);
+
+  // A probe sequence stops at the first group that contains an empty entry. If this group already has one,
+  // no probe sequence can continue past it and the entry can become empty again instead of leaving a 'deleted' marker.
+  const ezInternal::SwissHashTableGroup group(m_pControlBytes + (uiIndex & ~(GROUP_SIZE - 1)));
+  if (group.MatchEmpty() != 0)
+  {
+    m_pControlBytes[uiIndex] = CONTROL_EMPTY;
+    ++m_uiGrowthLeft;
+  }
+  else
+  {
+    m_pControlBytes[uiIndex] = CONTROL_DELETED;
+  }
+
+  --m_uiCount;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezSwissHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, V& out_value) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    EZ_ASSERT_DEBUG(m_pEntries != nullptr, "No entries present"); // To fix static analysis
+    out_value = m_pEntries[uiIndex].value;
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezSwissHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, const V*& out_pValue) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    out_pValue = &m_pEntries[uiIndex].value;
+    EZ_ANALYSIS_ASSUME(out_pValue != nullptr);
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline bool ezSwissHashTableBase<K, V, H>::TryGetValue(const CompatibleKeyType& key, V*& out_pValue) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex != ezInvalidIndex)
+  {
+    out_pValue = &m_pEntries[uiIndex].value;
+    EZ_ANALYSIS_ASSUME(out_pValue != nullptr);
+    return true;
+  }
+
+  return false;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline typename ezSwissHashTableBase<K, V, H>::ConstIterator ezSwissHashTableBase<K, V, H>::Find(const CompatibleKeyType& key) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex == ezInvalidIndex)
+  {
+    return GetEndIterator();
+  }
+
+  ConstIterator it(*this);
+  it.m_uiCurrentIndex = uiIndex;
+  it.m_uiCurrentCount = 0; // we do not know the 'count' (which is used as an optimization), so we just use 0
+
+  return it;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline typename ezSwissHashTableBase<K, V, H>::Iterator ezSwissHashTableBase<K, V, H>::Find(const CompatibleKeyType& key)
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  if (uiIndex == ezInvalidIndex)
+  {
+    return GetEndIterator();
+  }
+
+  Iterator it(*this);
+  it.m_uiCurrentIndex = uiIndex;
+  it.m_uiCurrentCount = 0; // we do not know the 'count' (which is used as an optimization), so we just use 0
+  return it;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline const V* ezSwissHashTableBase<K, V, H>::GetValue(const CompatibleKeyType& key) const
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  return (uiIndex != ezInvalidIndex) ? &m_pEntries[uiIndex].value : nullptr;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline V* ezSwissHashTableBase<K, V, H>::GetValue(const CompatibleKeyType& key)
+{
+  ezUInt32 uiIndex = FindEntry(key);
+  return (uiIndex != ezInvalidIndex) ? &m_pEntries[uiIndex].value : nullptr;
+}
+
+template <typename K, typename V, typename H>
+inline V& ezSwissHashTableBase<K, V, H>::operator[](const K& key)
+{
+  return FindOrAdd(key, nullptr);
+}
+
+template <typename K, typename V, typename H>
+V& ezSwissHashTableBase<K, V, H>::FindOrAdd(const K& key, bool* out_pExisted)
+{
+  const ezUInt32 uiHash = H::Hash(key);
+  ezUInt32 uiIndex = FindEntry(uiHash, key);
+
+  if (out_pExisted)
+  {
+    *out_pExisted = uiIndex != ezInvalidIndex;
+  }
+
+  if (uiIndex == ezInvalidIndex)
+  {
+    uiIndex = PrepareInsert(uiHash);
+
+    ezMemoryUtils::CopyConstruct(&m_pEntries[uiIndex].key, key, 1);
+    ezMemoryUtils::DefaultConstruct(&m_pEntries[uiIndex].value, 1);
+  }
+
+  EZ_ASSERT_DEBUG(m_pEntries != nullptr, "Entries should be present");
+  return m_pEntries[uiIndex].value;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+EZ_FORCE_INLINE bool ezSwissHashTableBase<K, V, H>::Contains(const CompatibleKeyType& key) const
+{
+  return FindEntry(key) != ezInvalidIndex;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezSwissHashTableBase<K, V, H>::Iterator ezSwissHashTableBase<K, V, H>::GetIterator()
+{
+  Iterator iterator(*this);
+  iterator.SetToBegin();
+  return iterator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezSwissHashTableBase<K, V, H>::Iterator ezSwissHashTableBase<K, V, H>::GetEndIterator()
+{
+  Iterator iterator(*this);
+  iterator.SetToEnd();
+  return iterator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezSwissHashTableBase<K, V, H>::ConstIterator ezSwissHashTableBase<K, V, H>::GetIterator() const
+{
+  ConstIterator iterator(*this);
+  iterator.SetToBegin();
+  return iterator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE typename ezSwissHashTableBase<K, V, H>::ConstIterator ezSwissHashTableBase<K, V, H>::GetEndIterator() const
+{
+  ConstIterator iterator(*this);
+  iterator.SetToEnd();
+  return iterator;
+}
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezAllocatorBase* ezSwissHashTableBase<K, V, H>::GetAllocator() const
+{
+  return m_pAllocator;
+}
+
+template <typename K, typename V, typename H>
+ezUInt64 ezSwissHashTableBase<K, V, H>::GetHeapMemoryUsage() const
+{
+  return (ezUInt64)m_uiCapacity * (sizeof(Entry) + sizeof(ezUInt8));
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::Swap(ezSwissHashTableBase<K, V, H>& other)
+{
+  ezMath::Swap(this->m_pEntries, other.m_pEntries);
+  ezMath::Swap(this->m_pControlBytes, other.m_pControlBytes);
+  ezMath::Swap(this->m_uiCount, other.m_uiCount);
+  ezMath::Swap(this->m_uiCapacity, other.m_uiCapacity);
+  ezMath::Swap(this->m_uiGrowthLeft, other.m_uiGrowthLeft);
+  ezMath::Swap(this->m_pAllocator, other.m_pAllocator);
+}
+
+// private methods
+
+template <typename K, typename V, typename H>
+EZ_ALWAYS_INLINE ezUInt32 ezSwissHashTableBase<K, V, H>::GetMaxLoad(ezUInt32 uiCapacity)
+{
+  // 87.5%
+  return uiCapacity - uiCapacity / 8;
+}
+
+template <typename K, typename V, typename H>
+ezUInt32 ezSwissHashTableBase<K, V, H>::GetRequiredCapacity(ezUInt32 uiCount)
+{
+  const ezUInt64 uiCount64 = static_cast<ezUInt64>(uiCount);
+  ezUInt64 uiCapacity64 = uiCount64 + (uiCount64 + 6) / 7; // inverse of GetMaxLoad
+
+  uiCapacity64 = ezMath::Min<ezUInt64>(uiCapacity64, 0x80000000llu); // the largest power-of-two in 32 bit
+  EZ_ASSERT_DEBUG(uiCount <= GetMaxLoad(static_cast<ezUInt32>(uiCapacity64)) || uiCapacity64 < MIN_CAPACITY, "ezSwissHashTable does not support that many entries.");
+
+  return ezMath::Max<ezUInt32>(ezMath::PowerOfTwo_Ceil(static_cast<ezUInt32>(uiCapacity64)), MIN_CAPACITY);
+}
+
+template <typename K, typename V, typename H>
+void ezSwissHashTableBase<K, V, H>::SetCapacity(ezUInt32 uiCapacity)
+{
+  EZ_ASSERT_DEBUG(ezMath::IsPowerOf2(uiCapacity) && uiCapacity >= MIN_CAPACITY, "uiCapacity must be a power of two and hold at least one group.");
+  const ezUInt32 uiOldCapacity = m_uiCapacity;
+
+  Entry* pOldEntries = m_pEntries;
+  ezUInt8* pOldControlBytes = m_pControlBytes;
+
+  m_uiCapacity = uiCapacity;
+  m_pEntries = EZ_NEW_RAW_BUFFER(m_pAllocator, Entry, m_uiCapacity);
+  m_pControlBytes = EZ_NEW_RAW_BUFFER(m_pAllocator, ezUInt8, m_uiCapacity);
+  ezMemoryUtils::PatternFill(m_pControlBytes, static_cast<ezUInt8>(CONTROL_EMPTY), m_uiCapacity);
+
+  // all keys are unique, so they can be placed into the first free entry without comparing them
+  for (ezUInt32 i = 0; i < uiOldCapacity; ++i)
+  {
+    if (pOldControlBytes[i] < CONTROL_EMPTY)
+    {
+      const ezUInt32 uiHash = H::Hash(pOldEntries[i].key);
+      const ezUInt32 uiIndex = FindFreeEntry(uiHash);
+      m_pControlBytes[uiIndex] = static_cast<ezUInt8>(uiHash & FRAGMENT_MASK);
+
+      ezMemoryUtils::RelocateConstruct(&m_pEntries[uiIndex].key, &pOldEntries[i].key, 1);
+      ezMemoryUtils::RelocateConstruct(&m_pEntries[uiIndex].value, &pOldEntries[i].value, 1);
+    }
+  }
+
+  m_uiGrowthLeft = GetMaxLoad(m_uiCapacity) - m_uiCount;
+
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldEntries);
+  EZ_DELETE_RAW_BUFFER(m_pAllocator, pOldControlBytes);
+}
+
+template <typename K, typename V, typename H>
+ezUInt32 ezSwissHashTableBase<K, V, H>::FindFreeEntry(ezUInt32 uiHash) const
+{
+  const ezUInt32 uiGroupMask = (m_uiCapacity / GROUP_SIZE) - 1;
+  ezUInt32 uiGroup = (uiHash >> FRAGMENT_BITS) & uiGroupMask;
+
+  // triangular probing visits every group exactly once, since the number of groups is a power of two
+  for (ezUInt32 uiProbe = 1;; ++uiProbe)
+  {
+    const ezInternal::SwissHashTableGroup group(m_pControlBytes + uiGroup * GROUP_SIZE);
+    const auto mask = group.MatchEmptyOrDeleted();
+    if (mask != 0)
+      return uiGroup * GROUP_SIZE + ezInternal::SwissHashTableGroup::GetLowestIndex(mask);
+
+    EZ_ASSERT_DEBUG(uiProbe <= uiGroupMask, "Implementation error: hashtable has no free entry");
+    uiGroup = (uiGroup + uiProbe) & uiGroupMask;
+  }
+}
+
+template <typename K, typename V, typename H>
+ezUInt32 ezSwissHashTableBase<K, V, H>::PrepareInsert(ezUInt32 uiHash)
+{
+  ezUInt32 uiIndex = m_uiCapacity > 0 ? FindFreeEntry(uiHash) : ezInvalidIndex;
+
+  // re-using a 'deleted' entry does not increase the load, filling an empty one does
+  if (uiIndex == ezInvalidIndex || (m_uiGrowthLeft == 0 && m_pControlBytes[uiIndex] == CONTROL_EMPTY))
+  {
+    // if many entries are only marked as 'deleted', rehashing at the same capacity is enough to free them up
+    if (m_uiCapacity > 0 && m_uiCount < GetMaxLoad(m_uiCapacity) / 2)
+      SetCapacity(m_uiCapacity);
+    else
+      SetCapacity(GetRequiredCapacity(ezMath::Max<ezUInt32>(m_uiCount + 1, m_uiCapacity)));
+
+    uiIndex = FindFreeEntry(uiHash);
+  }
+
+  if (m_pControlBytes[uiIndex] == CONTROL_EMPTY)
+    --m_uiGrowthLeft;
+
+  m_pControlBytes[uiIndex] = static_cast<ezUInt8>(uiHash & FRAGMENT_MASK);
+  ++m_uiCount;
+
+  return uiIndex;
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+EZ_ALWAYS_INLINE ezUInt32 ezSwissHashTableBase<K, V, H>::FindEntry(const CompatibleKeyType& key) const
+{
+  return FindEntry(H::Hash(key), key);
+}
+
+template <typename K, typename V, typename H>
+template <typename CompatibleKeyType>
+inline ezUInt32 ezSwissHashTableBase<K, V, H>::FindEntry(ezUInt32 uiHash, const CompatibleKeyType& key) const
+{
+  if (m_uiCapacity == 0)
+    return ezInvalidIndex;
+
+  const ezUInt8 uiFragment = static_cast<ezUInt8>(uiHash & FRAGMENT_MASK);
+  const ezUInt32 uiGroupMask = (m_uiCapacity / GROUP_SIZE) - 1;
+  ezUInt32 uiGroup = (uiHash >> FRAGMENT_BITS) & uiGroupMask;
+
+  for (ezUInt32 uiProbe = 1; uiProbe <= uiGroupMask + 1; ++uiProbe)
+  {
+    const ezUInt32 uiGroupStart = uiGroup * GROUP_SIZE;
+    const ezInternal::SwissHashTableGroup group(m_pControlBytes + uiGroupStart);
+
+    for (auto mask = group.Match(uiFragment); mask != 0; mask = ezInternal::SwissHashTableGroup::ClearLowest(mask))
+    {
+      const ezUInt32 uiIndex = uiGroupStart + ezInternal::SwissHashTableGroup::GetLowestIndex(mask);
+      if (H::Equal(m_pEntries[uiIndex].key, key))
+        return uiIndex;
+    }
+
+    // the key would have been inserted into this group, if it had any empty entry
+    if (group.MatchEmpty() != 0)
+      break;
+
+    uiGroup = (uiGroup + uiProbe) & uiGroupMask;
+  }
+
+  // not found
+  return ezInvalidIndex;
+}
+
+template <typename K, typename V, typename H>
+EZ_FORCE_INLINE bool ezSwissHashTableBase<K, V, H>::IsValidEntry(ezUInt32 uiEntryIndex) const
+{
+  // full entries store a 7-bit hash fragment, 'empty' and 'deleted' have the highest bit set
+  return m_pControlBytes[uiEntryIndex] < CONTROL_EMPTY;
+}
+
+
+template <typename K, typename V, typename H, typename A>
+ezSwissHashTable<K, V, H, A>::ezSwissHashTable()
+  : ezSwissHashTableBase<K, V, H>(A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezSwissHashTable<K, V, H, A>::ezSwissHashTable(ezAllocatorBase* pAllocator)
+  : ezSwissHashTableBase<K, V, H>(pAllocator)
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezSwissHashTable<K, V, H, A>::ezSwissHashTable(const ezSwissHashTable<K, V, H, A>& other)
+  : ezSwissHashTableBase<K, V, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezSwissHashTable<K, V, H, A>::ezSwissHashTable(const ezSwissHashTableBase<K, V, H>& other)
+  : ezSwissHashTableBase<K, V, H>(other, A::GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezSwissHashTable<K, V, H, A>::ezSwissHashTable(ezSwissHashTable<K, V, H, A>&& other)
+  : ezSwissHashTableBase<K, V, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+ezSwissHashTable<K, V, H, A>::ezSwissHashTable(ezSwissHashTableBase<K, V, H>&& other)
+  : ezSwissHashTableBase<K, V, H>(std::move(other), other.GetAllocator())
+{
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezSwissHashTable<K, V, H, A>::operator=(const ezSwissHashTable<K, V, H, A>& rhs)
+{
+  ezSwissHashTableBase<K, V, H>::operator=(rhs);
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezSwissHashTable<K, V, H, A>::operator=(const ezSwissHashTableBase<K, V, H>& rhs)
+{
+  ezSwissHashTableBase<K, V, H>::operator=(rhs);
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezSwissHashTable<K, V, H, A>::operator=(ezSwissHashTable<K, V, H, A>&& rhs)
+{
+  ezSwissHashTableBase<K, V, H>::operator=(std::move(rhs));
+}
+
+template <typename K, typename V, typename H, typename A>
+void ezSwissHashTable<K, V, H, A>::operator=(ezSwissHashTableBase<K, V, H>&& rhs)
+{
+  ezSwissHashTableBase<K, V, H>::operator=(std::move(rhs));
+}
@@ -0,0 +1,78 @@
+#include <Foundation/Memory/PageAllocator.h>
+#include <Foundation/System/SystemInformation.h>
+
+template <typename T>
+ezVirtualArray<T>::ezVirtualArray(ezUInt32 uiMaxCapacity)
+  : m_uiMaxCapacity(uiMaxCapacity)
+{
+  EZ_CHECK_AT_COMPILETIME_MSG(EZ_ALIGNMENT_OF(T) <= 4096, "Elements must not need a larger alignment than a memory page");
+
+  const size_t uiPageSize = ezSystemInformation::Get().GetMemoryPageSize();
+  m_uiReservedBytes = ezMemoryUtils::AlignSize<size_t>(static_cast<size_t>(uiMaxCapacity) * sizeof(T), uiPageSize);
+
+  if (m_uiReservedBytes > 0)
+  {
+    this->m_pElements = static_cast<T*>(ezPageAllocator::ReserveAddressSpace(m_uiReservedBytes));
+
+    if (this->m_pElements == nullptr)
+    {
+      m_uiReservedBytes = 0;
+      m_uiMaxCapacity = 0;
+    }
+  }
+}
+
+template <typename T>
+ezVirtualArray<T>::~ezVirtualArray()
+{
+  this->Clear();
+
+  if (this->m_pElements != nullptr)
+  {
+    ezPageAllocator::ReleaseAddressSpace(this->m_pElements, m_uiReservedBytes);
+  }
+
+  this->m_uiCapacity = 0;
+  this->m_pElements = nullptr;
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE void ezVirtualArray<T>::operator=(const ezArrayPtr<const T>& rhs)
+{
+  ezArrayBase<T, ezVirtualArray<T>>::operator=(rhs);
+}
+
+template <typename T>
+void ezVirtualArray<T>::Reserve(ezUInt32 uiCapacity)
+{
+  if (this->m_uiCapacity >= uiCapacity)
+    return;
+
+  EZ_ASSERT_ALWAYS(this->m_pElements != nullptr, "The virtual array could not reserve its address space, cannot reserve {0} elements.", uiCapacity);
+  EZ_ASSERT_DEV(uiCapacity <= m_uiMaxCapacity, "The virtual array has a maximum capacity of {0}, cannot reserve {1} elements.", m_uiMaxCapacity, uiCapacity);
+
+  // grow by 50% like ezDynamicArray, growing is cheap but every commit is a system call
+  size_t uiNewCommittedBytes = ezMath::Max<size_t>(static_cast<size_t>(uiCapacity) * sizeof(T), m_uiCommittedBytes + m_uiCommittedBytes / 2);
+  uiNewCommittedBytes = ezMemoryUtils::AlignSize<size_t>(uiNewCommittedBytes, COMMIT_GRANULARITY);
+  uiNewCommittedBytes = ezMath::Min(uiNewCommittedBytes, m_uiReservedBytes);
+
+  ezPageAllocator::CommitPages(ezMemoryUtils::AddByteOffset(this->m_pElements, m_uiCommittedBytes), uiNewCommittedBytes - m_uiCommittedBytes);
+
+  m_uiCommittedBytes = uiNewCommittedBytes;
+  this->m_uiCapacity = static_cast<ezUInt32>(ezMath::Min<size_t>(m_uiCommittedBytes / sizeof(T), m_uiMaxCapacity));
+}
+
+template <typename T>
+void ezVirtualArray<T>::Compact()
+{
+  const size_t uiPageSize = ezSystemInformation::Get().GetMemoryPageSize();
+  const size_t uiNeededBytes = ezMemoryUtils::AlignSize<size_t>(static_cast<size_t>(this->m_uiCount) * sizeof(T), uiPageSize);
+
+  if (uiNeededBytes >= m_uiCommittedBytes)
+    return;
+
+  ezPageAllocator::DecommitPages(ezMemoryUtils::AddByteOffset(this->m_pElements, uiNeededBytes), m_uiCommittedBytes - uiNeededBytes);
+
+  m_uiCommittedBytes = uiNeededBytes;
+  this->m_uiCapacity = static_cast<ezUInt32>(ezMath::Min<size_t>(m_uiCommittedBytes / sizeof(T), m_uiMaxCapacity));
+}
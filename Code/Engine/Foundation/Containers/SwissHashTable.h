@@ -0,0 +1,320 @@
+#pragma once
+
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Math/Math.h>
+#include <Foundation/Memory/AllocatorWrapper.h>
+
+/// \brief Open-addressing hashtable that stores key/value pairs and probes groups of entries with SIMD instructions.
+///
+/// Every entry has one control byte which is either 'empty', 'deleted' or holds the lower 7 bits of the key's hash.
+/// The upper bits of the hash select a group of 16 entries, whose control bytes are compared against the 7-bit fragment
+/// in a single SSE / NEON operation. Only entries with a matching fragment are compared with the actual key, which makes
+/// lookups touch the control bytes and, usually, a single entry.
+/// Since probing is cheap, the table is only expanded when the load gets greater than 87.5%.
+///
+/// The interface and the Hasher concept are identical to ezHashTable, so both can be exchanged freely.
+/// Entries are never moved by Remove(), but any insertion may reallocate and thus invalidates pointers and iterators.
+/// \see ezHashTableBase
+template <typename KeyType, typename ValueType, typename Hasher>
+class ezSwissHashTableBase
+{
+public:
+  /// \brief Const iterator.
+  struct ConstIterator
+  {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ConstIterator;
+    using difference_type = ptrdiff_t;
+    using pointer = ConstIterator*;
+    using reference = ConstIterator&;
+
+    EZ_DECLARE_POD_TYPE();
+
+    /// \brief Checks whether this iterator points to a valid element.
+    bool IsValid() const; // [tested]
+
+    /// \brief Checks whether the two iterators point to the same element.
+    bool operator==(const typename ezSwissHashTableBase<KeyType, ValueType, Hasher>::ConstIterator& rhs) const;
+
+    /// \brief Checks whether the two iterators point to the same element.
+    bool operator!=(const typename ezSwissHashTableBase<KeyType, ValueType, Hasher>::ConstIterator& rhs) const;
+
+    /// \brief Returns the 'key' of the element that this iterator points to.
+    const KeyType& Key() const; // [tested]
+
+    /// \brief Returns the 'value' of the element that this iterator points to.
+    const ValueType& Value() const; // [tested]
+
+    /// \brief Advances the iterator to the next element in the map. The iterator will not be valid anymore, if the end is reached.
+    void Next(); // [tested]
+
+    /// \brief Shorthand for 'Next'
+    void operator++(); // [tested]
+
+    /// \brief Returns '*this' to enable foreach
+    EZ_ALWAYS_INLINE ConstIterator& operator*() { return *this; } // [tested]
+
+  protected:
+    friend class ezSwissHashTableBase<KeyType, ValueType, Hasher>;
+
+    explicit ConstIterator(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& hashTable);
+    void SetToBegin();
+    void SetToEnd();
+
+    const ezSwissHashTableBase<KeyType, ValueType, Hasher>* m_pHashTable = nullptr;
+    ezUInt32 m_uiCurrentIndex = 0; // current element index that this iterator points to.
+    ezUInt32 m_uiCurrentCount = 0; // current number of valid elements that this iterator has found so far.
+  };
+
+  /// \brief Iterator with write access.
+  struct Iterator : public ConstIterator
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    /// \brief Creates a new iterator from another.
+    EZ_ALWAYS_INLINE Iterator(const Iterator& rhs); // [tested]
+
+    /// \brief Assigns one iterator no another.
+    EZ_ALWAYS_INLINE void operator=(const Iterator& rhs); // [tested]
+
+    // this is required to pull in the const version of this function
+    using ConstIterator::Value;
+
+    /// \brief Returns the 'value' of the element that this iterator points to.
+    EZ_FORCE_INLINE ValueType& Value(); // [tested]
+
+    /// \brief Returns '*this' to enable foreach
+    EZ_ALWAYS_INLINE Iterator& operator*() { return *this; } // [tested]
+
+  private:
+    friend class ezSwissHashTableBase<KeyType, ValueType, Hasher>;
+
+    explicit Iterator(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& hashTable);
+  };
+
+protected:
+  /// \brief Creates an empty hashtable. Does not allocate any data yet.
+  explicit ezSwissHashTableBase(ezAllocatorBase* pAllocator); // [tested]
+
+  /// \brief Creates a copy of the given hashtable.
+  ezSwissHashTableBase(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& rhs, ezAllocatorBase* pAllocator); // [tested]
+
+  /// \brief Moves data from an existing hashtable into this one.
+  ezSwissHashTableBase(ezSwissHashTableBase<KeyType, ValueType, Hasher>&& rhs, ezAllocatorBase* pAllocator); // [tested]
+
+  /// \brief Destructor.
+  ~ezSwissHashTableBase(); // [tested]
+
+  /// \brief Copies the data from another hashtable into this one.
+  void operator=(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& rhs); // [tested]
+
+  /// \brief Moves data from an existing hashtable into this one.
+  void operator=(ezSwissHashTableBase<KeyType, ValueType, Hasher>&& rhs); // [tested]
+
+public:
+  /// \brief Compares this table to another table.
+  bool operator==(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& rhs) const; // [tested]
+
+  /// \brief Compares this table to another table.
+  bool operator!=(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& rhs) const; // [tested]
+
+  /// \brief Expands the hashtable so that the given number of entries can be inserted without exceeding a load of 87.5%.
+  void Reserve(ezUInt32 uiCapacity); // [tested]
+
+  /// \brief Tries to compact the hashtable to avoid wasting memory. Also removes all 'deleted' markers.
+  ///
+  /// The resulting capacity is at least 'GetCount' (no elements get removed).
+  /// Will deallocate all data, if the hashtable is empty.
+  void Compact(); // [tested]
+
+  /// \brief Returns the number of active entries in the table.
+  ezUInt32 GetCount() const; // [tested]
+
+  /// \brief Returns true, if the hashtable does not contain any elements.
+  bool IsEmpty() const; // [tested]
+
+  /// \brief Clears the table.
+  void Clear(); // [tested]
+
+  /// \brief Inserts the key value pair or replaces value if an entry with the given key already exists.
+  ///
+  /// Returns true if an existing value was replaced and optionally writes out the old value to out_oldValue.
+  template <typename CompatibleKeyType, typename CompatibleValueType>
+  bool Insert(CompatibleKeyType&& key, CompatibleValueType&& value, ValueType* out_pOldValue = nullptr); // [tested]
+
+  /// \brief Removes the entry with the given key. Returns whether an entry was removed and optionally writes out the old value to out_oldValue.
+  template <typename CompatibleKeyType>
+  bool Remove(const CompatibleKeyType& key, ValueType* out_pOldValue = nullptr); // [tested]
+
+  /// \brief Erases the key/value pair at the given Iterator. Returns an iterator to the element after the given iterator.
+  Iterator Remove(const Iterator& pos); // [tested]
+
+  /// \brief Cannot remove an element with just a ConstIterator
+  void Remove(const ConstIterator& pos) = delete;
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the corresponding value to out_value.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, ValueType& out_value) const; // [tested]
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the pointer to the corresponding value to out_pValue.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, const ValueType*& out_pValue) const; // [tested]
+
+  /// \brief Returns whether an entry with the given key was found and if found writes out the pointer to the corresponding value to out_pValue.
+  template <typename CompatibleKeyType>
+  bool TryGetValue(const CompatibleKeyType& key, ValueType*& out_pValue) const; // [tested]
+
+  /// \brief Searches for key, returns a ConstIterator to it or an invalid iterator, if no such key is found. O(1) operation.
+  template <typename CompatibleKeyType>
+  ConstIterator Find(const CompatibleKeyType& key) const;
+
+  /// \brief Searches for key, returns an Iterator to it or an invalid iterator, if no such key is found. O(1) operation.
+  template <typename CompatibleKeyType>
+  Iterator Find(const CompatibleKeyType& key);
+
+  /// \brief Returns a pointer to the value of the entry with the given key if found, otherwise returns nullptr.
+  template <typename CompatibleKeyType>
+  const ValueType* GetValue(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Returns a pointer to the value of the entry with the given key if found, otherwise returns nullptr.
+  template <typename CompatibleKeyType>
+  ValueType* GetValue(const CompatibleKeyType& key); // [tested]
+
+  /// \brief Returns the value to the given key if found or creates a new entry with the given key and a default constructed value.
+  ValueType& operator[](const KeyType& key); // [tested]
+
+  /// \brief Returns the value stored at the given key. If none exists, one is created. \a bExisted indicates whether an element needed to be created.
+  ValueType& FindOrAdd(const KeyType& key, bool* out_pExisted); // [tested]
+
+  /// \brief Returns if an entry with given key exists in the table.
+  template <typename CompatibleKeyType>
+  bool Contains(const CompatibleKeyType& key) const; // [tested]
+
+  /// \brief Returns an Iterator to the very first element.
+  Iterator GetIterator(); // [tested]
+
+  /// \brief Returns an Iterator to the first element that is not part of the hash-table. Needed to support range based for loops.
+  Iterator GetEndIterator(); // [tested]
+
+  /// \brief Returns a constant Iterator to the very first element.
+  ConstIterator GetIterator() const; // [tested]
+
+  /// \brief Returns a ConstIterator to the first element that is not part of the hash-table. Needed to support range based for loops.
+  ConstIterator GetEndIterator() const; // [tested]
+
+  /// \brief Returns the allocator that is used by this instance.
+  ezAllocatorBase* GetAllocator() const;
+
+  /// \brief Returns the amount of bytes that are currently allocated on the heap.
+  ezUInt64 GetHeapMemoryUsage() const; // [tested]
+
+  /// \brief Swaps this map with the other one.
+  void Swap(ezSwissHashTableBase<KeyType, ValueType, Hasher>& other); // [tested]
+
+private:
+  struct Entry
+  {
+    KeyType key;
+    ValueType value;
+  };
+
+  Entry* m_pEntries;
+  ezUInt8* m_pControlBytes;
+
+  ezUInt32 m_uiCount;
+  ezUInt32 m_uiCapacity;
+  ezUInt32 m_uiGrowthLeft; // number of 'empty' entries that may still be filled before the maximum load is reached
+
+  ezAllocatorBase* m_pAllocator;
+
+  enum
+  {
+    CONTROL_EMPTY = 0x80,
+    CONTROL_DELETED = 0xFE,
+    FRAGMENT_BITS = 7,
+    FRAGMENT_MASK = (1 << FRAGMENT_BITS) - 1,
+    GROUP_SIZE = 16,
+    MIN_CAPACITY = GROUP_SIZE
+  };
+
+  static ezUInt32 GetMaxLoad(ezUInt32 uiCapacity);
+  static ezUInt32 GetRequiredCapacity(ezUInt32 uiCount);
+
+  void SetCapacity(ezUInt32 uiCapacity);
+
+  ezUInt32 FindFreeEntry(ezUInt32 uiHash) const;
+  ezUInt32 PrepareInsert(ezUInt32 uiHash);
+
+  void RemoveInternal(ezUInt32 uiIndex);
+
+  template <typename CompatibleKeyType>
+  ezUInt32 FindEntry(const CompatibleKeyType& key) const;
+
+  template <typename CompatibleKeyType>
+  ezUInt32 FindEntry(ezUInt32 uiHash, const CompatibleKeyType& key) const;
+
+  bool IsValidEntry(ezUInt32 uiEntryIndex) const;
+};
+
+/// \brief \see ezSwissHashTableBase
+template <typename KeyType, typename ValueType, typename Hasher = ezHashHelper<KeyType>, typename AllocatorWrapper = ezDefaultAllocatorWrapper>
+class ezSwissHashTable : public ezSwissHashTableBase<KeyType, ValueType, Hasher>
+{
+public:
+  ezSwissHashTable();
+  explicit ezSwissHashTable(ezAllocatorBase* pAllocator);
+
+  ezSwissHashTable(const ezSwissHashTable<KeyType, ValueType, Hasher, AllocatorWrapper>& other);
+  ezSwissHashTable(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& other);
+
+  ezSwissHashTable(ezSwissHashTable<KeyType, ValueType, Hasher, AllocatorWrapper>&& other);
+  ezSwissHashTable(ezSwissHashTableBase<KeyType, ValueType, Hasher>&& other);
+
+
+  void operator=(const ezSwissHashTable<KeyType, ValueType, Hasher, AllocatorWrapper>& rhs);
+  void operator=(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& rhs);
+
+  void operator=(ezSwissHashTable<KeyType, ValueType, Hasher, AllocatorWrapper>&& rhs);
+  void operator=(ezSwissHashTableBase<KeyType, ValueType, Hasher>&& rhs);
+};
+
+//////////////////////////////////////////////////////////////////////////
+// begin() /end() for range-based for-loop support
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezSwissHashTableBase<KeyType, ValueType, Hasher>::Iterator begin(ezSwissHashTableBase<KeyType, ValueType, Hasher>& ref_container)
+{
+  return ref_container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezSwissHashTableBase<KeyType, ValueType, Hasher>::ConstIterator begin(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezSwissHashTableBase<KeyType, ValueType, Hasher>::ConstIterator cbegin(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezSwissHashTableBase<KeyType, ValueType, Hasher>::Iterator end(ezSwissHashTableBase<KeyType, ValueType, Hasher>& ref_container)
+{
+  return ref_container.GetEndIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezSwissHashTableBase<KeyType, ValueType, Hasher>::ConstIterator end(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetEndIterator();
+}
+
+template <typename KeyType, typename ValueType, typename Hasher>
+typename ezSwissHashTableBase<KeyType, ValueType, Hasher>::ConstIterator cend(const ezSwissHashTableBase<KeyType, ValueType, Hasher>& container)
+{
+  return container.GetEndIterator();
+}
+
+#include <Foundation/Containers/Implementation/SwissHashTable_inl.h>
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Foundation/Containers/ArrayBase.h>
+
+/// \brief An array that reserves address space for its maximum capacity up front and backs it with memory only as it grows.
+///
+/// Since the address space never changes, growing the array never moves or copies any elements, and pointers to elements stay valid
+/// until the elements themselves are removed or moved by operations like Insert() or RemoveAtAndCopy().
+/// This makes it suitable for very large tables that are filled incrementally, where ezDynamicArray would have to copy everything on growth.
+///
+/// The maximum capacity is fixed at construction. Reserving address space is cheap, so it can be chosen generously,
+/// only the pages that are actually used are committed.
+template <typename T>
+class ezVirtualArray : public ezArrayBase<T, ezVirtualArray<T>>
+{
+public:
+  /// \brief Reserves address space for uiMaxCapacity elements. Does not commit any memory yet.
+  ///
+  /// If the address space can't be reserved, GetMaxCapacity() returns zero and the array can't grow.
+  explicit ezVirtualArray(ezUInt32 uiMaxCapacity); // [tested]
+
+  /// \brief Destroys all elements and releases the reserved address space.
+  ~ezVirtualArray(); // [tested]
+
+  ezVirtualArray(const ezVirtualArray<T>& other) = delete;
+  void operator=(const ezVirtualArray<T>& rhs) = delete;
+
+  /// \brief Copies the data from some other contiguous array into this one.
+  void operator=(const ezArrayPtr<const T>& rhs); // [tested]
+
+  /// \brief Commits memory so that the array can store at least the given number of elements. Never moves any elements.
+  void Reserve(ezUInt32 uiCapacity); // [tested]
+
+  /// \brief Decommits all pages that are not needed to store the current elements.
+  void Compact(); // [tested]
+
+  /// \brief Returns the number of elements that the array can hold at most.
+  ezUInt32 GetMaxCapacity() const { return m_uiMaxCapacity; } // [tested]
+
+  /// \brief Returns the amount of bytes that are currently committed.
+  ezUInt64 GetHeapMemoryUsage() const { return m_uiCommittedBytes; } // [tested]
+
+protected:
+  T* GetElementsPtr() { return this->m_pElements; }
+  const T* GetElementsPtr() const { return this->m_pElements; }
+
+  friend class ezArrayBase<T, ezVirtualArray<T>>;
+
+private:
+  enum
+  {
+    COMMIT_GRANULARITY = 64 * 1024 ///< Memory is committed in steps of at least this size to reduce the number of system calls.
+  };
+
+  ezUInt32 m_uiMaxCapacity = 0;
+  size_t m_uiReservedBytes = 0;
+  size_t m_uiCommittedBytes = 0;
+};
+
+#include <Foundation/Containers/Implementation/VirtualArray_inl.h>
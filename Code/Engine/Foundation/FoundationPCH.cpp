@@ -71,6 +71,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_DataProcessing_Stream_Implementation_ProcessingStreamGroup);
   EZ_STATICLINK_REFERENCE(Foundation_DataProcessing_Stream_Implementation_ProcessingStreamProcessor);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_Archive);
+  EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveBlockCompressedReader);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveBuilder);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveReader);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Archive_Implementation_ArchiveUtils);
@@ -81,6 +82,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_IO_FileSystem_Implementation_FileReader);
   EZ_STATICLINK_REFERENCE(Foundation_IO_FileSystem_Implementation_FileSystem);
   EZ_STATICLINK_REFERENCE(Foundation_IO_FileSystem_Implementation_FileWriter);
+  EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_AsyncFileIO);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_ChunkStream);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_CompressedStreamZstd);
   EZ_STATICLINK_REFERENCE(Foundation_IO_Implementation_DeduplicationContext);
@@ -125,6 +127,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_MemoryUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_PageAllocator);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_GuardedAllocation);
+  EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_ThreadCachingAllocation);
   EZ_STATICLINK_REFERENCE(Foundation_Profiling_Implementation_Profiling);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_DynamicRTTI);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyAttributes);
@@ -172,6 +175,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemGroups);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemTasks);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemThreads);
+  EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemWorkStealing);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkerThread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_Thread);
@@ -199,6 +203,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_ConversionUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_DGMLWriter);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_GraphicsUtils);
+  EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_Metrics);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_Progress);
   EZ_STATICLINK_REFERENCE(Foundation_Utilities_Implementation_Stats);
 }
@@ -12,8 +12,11 @@ enum class ezArchiveCompressionMode : ezUInt8
   Uncompressed,
   Compressed_zstd,
   Compressed_zip,
+  Compressed_zstd_blocks, ///< Independently compressed blocks with a seek table, allows random access. \see ezArchiveBlockCompressedReader
 };
 
+EZ_DEFINE_AS_POD_TYPE(ezArchiveCompressionMode);
+
 /// \brief Data for a single file entry in an ezArchive file
 class EZ_FOUNDATION_DLL ezArchiveEntry
 {
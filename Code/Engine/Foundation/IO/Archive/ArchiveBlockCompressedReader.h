@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/IO/Stream.h>
+#include <Foundation/Types/Delegate.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+/// \brief Reads the data of an ezArchive entry that was stored with ezArchiveCompressionMode::Compressed_zstd_blocks.
+///
+/// Such entries are split into blocks of a fixed (uncompressed) size, which are compressed independently of each other, followed by a
+/// seek table with the offset of every block. This allows to jump to any position in the data and only decompress the blocks that are
+/// actually needed, e.g. to read just the tail of a large file. Skipping bytes does not decompress anything.
+///
+/// Reads that span several complete blocks decompress them directly into the target buffer, distributed across the ezTaskSystem worker
+/// threads. The data of a partially read block is cached, so reading small pieces sequentially only decompresses every block once.
+class EZ_FOUNDATION_DLL ezArchiveBlockCompressedReader : public ezStreamReader
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezArchiveBlockCompressedReader);
+
+public:
+  ezArchiveBlockCompressedReader();
+  ~ezArchiveBlockCompressedReader();
+
+  /// \brief Configures the reader to read from the given stored entry data and resets the read position.
+  ///
+  /// Returns EZ_FAILURE, if the data does not have a valid seek table. The data must stay valid as long as the reader uses it.
+  ezResult SetInputData(const void* pStoredData, ezUInt64 uiStoredDataSize, ezUInt64 uiUncompressedDataSize); // [tested]
+
+  /// \brief Reads either uiBytesToRead or the amount of remaining bytes in the stream into pReadBuffer.
+  ///
+  /// If pReadBuffer is nullptr, the read position is only advanced, without decompressing anything.
+  virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override; // [tested]
+
+  /// \brief Advances the read position without decompressing any data.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override; // [tested]
+
+  /// \brief Sets the position in the uncompressed data from which the next read starts.
+  void SetReadPosition(ezUInt64 uiReadPosition); // [tested]
+
+  /// \brief Returns the position in the uncompressed data from which the next read starts.
+  ezUInt64 GetReadPosition() const { return m_uiReadPosition; } // [tested]
+
+  /// \brief Returns the size of the entire uncompressed data.
+  ezUInt64 GetUncompressedSize() const { return m_uiUncompressedSize; } // [tested]
+
+  /// \brief Returns the uncompressed size of all blocks, except for the last one, which may be smaller.
+  ezUInt32 GetBlockSize() const { return m_uiBlockSize; }
+
+  /// \brief Returns the number of independently compressed blocks.
+  ezUInt32 GetNumBlocks() const { return m_uiNumBlocks; }
+
+  /// \brief Writes everything that can be read from \a inout_source into \a inout_stream in the format that this reader expects.
+  ///
+  /// The data is compressed in batches of several blocks, every batch is compressed in parallel.
+  /// Returns the number of bytes written to \a inout_stream in \a out_uiStoredSize.
+  /// The progress callback is called with the number of bytes consumed so far and \a uiTotalSize. Returning false cancels the operation.
+  static ezResult WriteBlocks(ezStreamReader& inout_source, ezStreamWriter& inout_stream, ezInt32 iCompressionLevel, ezUInt64& out_uiUncompressedSize, ezUInt64& out_uiStoredSize, ezUInt64 uiTotalSize = 0, ezDelegate<bool(ezUInt64, ezUInt64)> progress = {});
+
+  enum
+  {
+    DefaultBlockSize = 256 * 1024, ///< The uncompressed size of the blocks written by WriteBlocks().
+  };
+
+private:
+  ezUInt64 GetBlockOffset(ezUInt32 uiBlock) const;
+  ezUInt32 GetUncompressedBlockSize(ezUInt32 uiBlock) const;
+  bool DecompressBlock(ezUInt32 uiBlock, void* pTarget);
+  bool DecompressBlocksParallel(ezUInt32 uiFirstBlock, ezUInt32 uiNumBlocks, ezUInt8* pTarget) const;
+
+  const ezUInt8* m_pData = nullptr;
+  const ezUInt8* m_pSeekTable = nullptr;
+  ezUInt64 m_uiUncompressedSize = 0;
+  ezUInt64 m_uiReadPosition = 0;
+  ezUInt32 m_uiBlockSize = 0;
+  ezUInt32 m_uiNumBlocks = 0;
+
+  ezUInt32 m_uiCachedBlock = ezInvalidIndex;
+  ezDynamicArray<ezUInt8> m_CachedBlockData;
+  /*ZSTD_DCtx*/ void* m_pZstdDCtx = nullptr;
+};
+
+#endif // BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -31,6 +31,7 @@ public:
     Compress_zstd_average, ///< Add the file and try out compression. If compression does not help, the file will end up uncompressed in the archive.
     Compress_zstd_high,    ///< Add the file and try out compression. If compression does not help, the file will end up uncompressed in the archive.
     Compress_zstd_highest, ///< Add the file and try out compression. If compression does not help, the file will end up uncompressed in the archive.
+    Compress_zstd_blocks,  ///< Like Compress_zstd_fast, but compresses the file in independent blocks, which allows to read parts of it without decompressing everything before.
   };
 
   /// \brief Custom decider whether to include a file into the archive
@@ -4,6 +4,7 @@
 #include <Foundation/IO/MemoryMappedFile.h>
 #include <Foundation/Types/UniquePtr.h>
 
+class ezArchiveBlockCompressedReader;
 class ezRawMemoryStreamReader;
 class ezStreamReader;
 
@@ -30,9 +31,24 @@ public:
   /// \brief Sets up \a memReader for reading the raw (potentially compressed) data that is stored for the given entry in the archive.
   void ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawMemoryStreamReader& ref_memReader) const;
 
+  /// \brief Returns the data of the given entry directly from the memory mapped archive, if it is stored uncompressed.
+  ///
+  /// Returns an empty array for compressed entries. The memory stays valid as long as the archive is open, which allows to use the data
+  /// without copying it first.
+  ezArrayPtr<const ezUInt8> GetUncompressedEntryData(ezUInt32 uiEntryIdx) const;
+
   /// \brief Creates a reader that will decompress the given file entry.
   ezUniquePtr<ezStreamReader> CreateEntryReader(ezUInt32 uiEntryIdx) const;
 
+  /// \brief Sets up \a ref_reader for random access to an entry that is stored with ezArchiveCompressionMode::Compressed_zstd_blocks.
+  void ConfigureBlockCompressedReader(ezUInt32 uiEntryIdx, ezArchiveBlockCompressedReader& ref_reader) const;
+
+  /// \brief Reads up to \a uiBytesToRead bytes of the uncompressed entry data, starting at \a uiStartOffset. Returns the number of bytes read.
+  ///
+  /// Uncompressed and block compressed entries only access the requested range. Large reads from block compressed entries are decompressed
+  /// in parallel. Entries that are stored as one compressed stream have to be decompressed from the start up to \a uiStartOffset.
+  ezUInt64 ReadEntryData(ezUInt32 uiEntryIdx, ezUInt64 uiStartOffset, void* pBuffer, ezUInt64 uiBytesToRead) const;
+
 protected:
   /// \brief Called by ExtractAllFiles() for progress reporting. Return false to abort.
   virtual bool ExtractNextFileCallback(ezUInt32 uiCurEntry, ezUInt32 uiMaxEntries, ezStringView sSourceFile) const;
@@ -26,7 +26,9 @@ namespace ezArchiveUtils
   EZ_FOUNDATION_DLL bool IsAcceptedArchiveFileExtensions(ezStringView sExtension);
 
   /// \brief Writes the header that identifies the ezArchive file and version to the stream
-  EZ_FOUNDATION_DLL ezResult WriteHeader(ezStreamWriter& inout_stream);
+  ///
+  /// Version 5 is only written if the archive contains block compressed entries, otherwise version 4 is used.
+  EZ_FOUNDATION_DLL ezResult WriteHeader(ezStreamWriter& inout_stream, bool bHasBlockCompressedEntries = false);
 
   /// \brief Reads the ezArchive header. Returns success and the version, if the stream is a valid ezArchive file.
   EZ_FOUNDATION_DLL ezResult ReadHeader(ezStreamReader& inout_stream, ezUInt8& out_uiVersion);
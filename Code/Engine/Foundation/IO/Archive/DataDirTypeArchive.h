@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/IO/Archive/ArchiveBlockCompressedReader.h>
 #include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
@@ -13,6 +14,7 @@ namespace ezDataDirectory
 {
   class ArchiveReaderUncompressed;
   class ArchiveReaderZstd;
+  class ArchiveReaderZstdBlocks;
   class ArchiveReaderZip;
 
   class EZ_FOUNDATION_DLL ArchiveType : public ezDataDirectoryType
@@ -50,6 +52,8 @@ namespace ezDataDirectory
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
     ezHybridArray<ezUniquePtr<ArchiveReaderZstd>, 4> m_ReadersZstd;
     ezHybridArray<ArchiveReaderZstd*, 4> m_FreeReadersZstd;
+    ezHybridArray<ezUniquePtr<ArchiveReaderZstdBlocks>, 4> m_ReadersZstdBlocks;
+    ezHybridArray<ArchiveReaderZstdBlocks*, 4> m_FreeReadersZstdBlocks;
 #endif
   };
 
@@ -63,6 +67,7 @@ namespace ezDataDirectory
 
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
     virtual ezUInt64 GetFileSize() const override;
+    virtual ezArrayPtr<const ezUInt8> GetMappedData() const override { return m_MappedData; }
 
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
@@ -73,6 +78,7 @@ namespace ezDataDirectory
     ezUInt64 m_uiUncompressedSize = 0;
     ezUInt64 m_uiCompressedSize = 0;
     ezRawMemoryStreamReader m_MemStreamReader;
+    ezArrayPtr<const ezUInt8> m_MappedData; ///< Only set for entries that are stored uncompressed.
   };
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -93,6 +99,24 @@ namespace ezDataDirectory
 
     ezCompressedStreamReaderZstd m_CompressedStreamReader;
   };
+
+  /// \brief Reads block compressed entries. Skipping through the file does not decompress the skipped blocks.
+  class EZ_FOUNDATION_DLL ArchiveReaderZstdBlocks : public ArchiveReaderUncompressed
+  {
+    EZ_DISALLOW_COPY_AND_ASSIGN(ArchiveReaderZstdBlocks);
+
+  public:
+    ArchiveReaderZstdBlocks(ezInt32 iDataDirUserData);
+    ~ArchiveReaderZstdBlocks();
+
+    virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
+    virtual ezUInt64 SkipBytes(ezUInt64 uiBytes) override;
+
+  protected:
+    friend class ArchiveType;
+
+    ezArchiveBlockCompressedReader m_BlockReader;
+  };
 #endif
 
 
@@ -82,7 +82,7 @@ struct ezHashHelper<ezOldTempHashedString>
 
 ezResult ezArchiveTOC::Deserialize(ezStreamReader& inout_stream, ezUInt8 uiArchiveVersion)
 {
-  EZ_ASSERT_ALWAYS(uiArchiveVersion <= 4, "Unsupported archive version {}", uiArchiveVersion);
+  EZ_ASSERT_ALWAYS(uiArchiveVersion <= 5, "Unsupported archive version {}", uiArchiveVersion);
 
   // we don't use the TOC version anymore, but the archive version instead
   const ezTypeVersion version = inout_stream.ReadVersion(2);
@@ -0,0 +1,378 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/IO/Archive/ArchiveBlockCompressedReader.h>
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+
+#  include <Foundation/Logging/Log.h>
+#  include <Foundation/Threading/TaskSystem.h>
+#  include <zstd/zstd.h>
+
+// Layout of the stored data:
+//   [compressed block 0] ... [compressed block N-1]
+//   [ezUInt64 offset of block 0] ... [ezUInt64 offset of block N-1] [ezUInt64 end of block data]
+//   [ezUInt32 block size] [ezUInt32 N]
+static constexpr ezUInt64 s_uiFooterSize = sizeof(ezUInt32) * 2;
+
+ezArchiveBlockCompressedReader::ezArchiveBlockCompressedReader() = default;
+
+ezArchiveBlockCompressedReader::~ezArchiveBlockCompressedReader()
+{
+  if (m_pZstdDCtx != nullptr)
+  {
+    ZSTD_freeDCtx(reinterpret_cast<ZSTD_DCtx*>(m_pZstdDCtx));
+    m_pZstdDCtx = nullptr;
+  }
+}
+
+ezResult ezArchiveBlockCompressedReader::SetInputData(const void* pStoredData, ezUInt64 uiStoredDataSize, ezUInt64 uiUncompressedDataSize)
+{
+  m_pData = nullptr;
+  m_pSeekTable = nullptr;
+  m_uiUncompressedSize = 0;
+  m_uiReadPosition = 0;
+  m_uiBlockSize = 0;
+  m_uiNumBlocks = 0;
+  m_uiCachedBlock = ezInvalidIndex;
+
+  if (uiStoredDataSize < s_uiFooterSize + sizeof(ezUInt64))
+  {
+    ezLog::Error("Block compressed data is corrupt. The seek table is missing.");
+    return EZ_FAILURE;
+  }
+
+  const ezUInt8* pData = static_cast<const ezUInt8*>(pStoredData);
+
+  ezUInt32 uiBlockSize = 0;
+  ezUInt32 uiNumBlocks = 0;
+  ezMemoryUtils::RawByteCopy(&uiBlockSize, pData + uiStoredDataSize - s_uiFooterSize, sizeof(ezUInt32));
+  ezMemoryUtils::RawByteCopy(&uiNumBlocks, pData + uiStoredDataSize - sizeof(ezUInt32), sizeof(ezUInt32));
+
+  const ezUInt64 uiSeekTableSize = (static_cast<ezUInt64>(uiNumBlocks) + 1) * sizeof(ezUInt64);
+
+  if (uiBlockSize == 0 || uiNumBlocks != (uiUncompressedDataSize + uiBlockSize - 1) / uiBlockSize || uiSeekTableSize + s_uiFooterSize > uiStoredDataSize)
+  {
+    ezLog::Error("Block compressed data is corrupt. Invalid block count.");
+    return EZ_FAILURE;
+  }
+
+  m_pData = pData;
+  m_pSeekTable = pData + uiStoredDataSize - s_uiFooterSize - uiSeekTableSize;
+  m_uiBlockSize = uiBlockSize;
+  m_uiNumBlocks = uiNumBlocks;
+  m_uiUncompressedSize = uiUncompressedDataSize;
+
+  bool bValid = GetBlockOffset(0) == 0 && GetBlockOffset(uiNumBlocks) == static_cast<ezUInt64>(m_pSeekTable - m_pData);
+
+  for (ezUInt32 uiBlock = 0; bValid && uiBlock < uiNumBlocks; ++uiBlock)
+  {
+    bValid = GetBlockOffset(uiBlock) < GetBlockOffset(uiBlock + 1);
+  }
+
+  if (!bValid)
+  {
+    ezLog::Error("Block compressed data is corrupt. Invalid seek table.");
+
+    m_pData = nullptr;
+    m_pSeekTable = nullptr;
+    m_uiUncompressedSize = 0;
+    m_uiBlockSize = 0;
+    m_uiNumBlocks = 0;
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezUInt64 ezArchiveBlockCompressedReader::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
+{
+  uiBytesToRead = ezMath::Min(uiBytesToRead, m_uiUncompressedSize - m_uiReadPosition);
+
+  if (pReadBuffer == nullptr)
+  {
+    m_uiReadPosition += uiBytesToRead;
+    return uiBytesToRead;
+  }
+
+  ezUInt8* pTarget = static_cast<ezUInt8*>(pReadBuffer);
+  ezUInt64 uiBytesRead = 0;
+
+  while (uiBytesRead < uiBytesToRead)
+  {
+    const ezUInt32 uiBlock = static_cast<ezUInt32>(m_uiReadPosition / m_uiBlockSize);
+    const ezUInt32 uiOffsetInBlock = static_cast<ezUInt32>(m_uiReadPosition % m_uiBlockSize);
+    const ezUInt64 uiRemaining = uiBytesToRead - uiBytesRead;
+
+    if (uiOffsetInBlock == 0 && uiRemaining >= GetUncompressedBlockSize(uiBlock))
+    {
+      // complete blocks are decompressed directly into the target buffer
+      ezUInt32 uiNumFullBlocks = 0;
+      ezUInt64 uiFullBlockBytes = 0;
+
+      while (uiBlock + uiNumFullBlocks < m_uiNumBlocks && uiFullBlockBytes + GetUncompressedBlockSize(uiBlock + uiNumFullBlocks) <= uiRemaining)
+      {
+        uiFullBlockBytes += GetUncompressedBlockSize(uiBlock + uiNumFullBlocks);
+        ++uiNumFullBlocks;
+      }
+
+      const bool bSuccess = (uiNumFullBlocks == 1) ? DecompressBlock(uiBlock, pTarget + uiBytesRead) : DecompressBlocksParallel(uiBlock, uiNumFullBlocks, pTarget + uiBytesRead);
+
+      if (!bSuccess)
+        return uiBytesRead;
+
+      uiBytesRead += uiFullBlockBytes;
+      m_uiReadPosition += uiFullBlockBytes;
+      continue;
+    }
+
+    // partial blocks go through the cache
+    if (m_uiCachedBlock != uiBlock)
+    {
+      m_CachedBlockData.SetCountUninitialized(m_uiBlockSize);
+
+      if (!DecompressBlock(uiBlock, m_CachedBlockData.GetData()))
+        return uiBytesRead;
+
+      m_uiCachedBlock = uiBlock;
+    }
+
+    const ezUInt32 uiBytesFromBlock = static_cast<ezUInt32>(ezMath::Min<ezUInt64>(uiRemaining, GetUncompressedBlockSize(uiBlock) - uiOffsetInBlock));
+    ezMemoryUtils::Copy(pTarget + uiBytesRead, m_CachedBlockData.GetData() + uiOffsetInBlock, uiBytesFromBlock);
+
+    uiBytesRead += uiBytesFromBlock;
+    m_uiReadPosition += uiBytesFromBlock;
+  }
+
+  return uiBytesRead;
+}
+
+ezUInt64 ezArchiveBlockCompressedReader::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  return ReadBytes(nullptr, uiBytesToSkip);
+}
+
+void ezArchiveBlockCompressedReader::SetReadPosition(ezUInt64 uiReadPosition)
+{
+  EZ_ASSERT_DEV(uiReadPosition <= m_uiUncompressedSize, "Read position {} is outside the data (size {})", uiReadPosition, m_uiUncompressedSize);
+
+  m_uiReadPosition = uiReadPosition;
+}
+
+ezUInt64 ezArchiveBlockCompressedReader::GetBlockOffset(ezUInt32 uiBlock) const
+{
+  ezUInt64 uiOffset;
+  ezMemoryUtils::RawByteCopy(&uiOffset, m_pSeekTable + uiBlock * sizeof(ezUInt64), sizeof(ezUInt64));
+  return uiOffset;
+}
+
+ezUInt32 ezArchiveBlockCompressedReader::GetUncompressedBlockSize(ezUInt32 uiBlock) const
+{
+  const ezUInt64 uiBlockStart = static_cast<ezUInt64>(uiBlock) * m_uiBlockSize;
+  return static_cast<ezUInt32>(ezMath::Min<ezUInt64>(m_uiBlockSize, m_uiUncompressedSize - uiBlockStart));
+}
+
+bool ezArchiveBlockCompressedReader::DecompressBlock(ezUInt32 uiBlock, void* pTarget)
+{
+  if (m_pZstdDCtx == nullptr)
+  {
+    m_pZstdDCtx = ZSTD_createDCtx();
+  }
+
+  const ezUInt64 uiStart = GetBlockOffset(uiBlock);
+  const ezUInt32 uiExpectedSize = GetUncompressedBlockSize(uiBlock);
+
+  const size_t res = ZSTD_decompressDCtx(reinterpret_cast<ZSTD_DCtx*>(m_pZstdDCtx), pTarget, uiExpectedSize, m_pData + uiStart, static_cast<size_t>(GetBlockOffset(uiBlock + 1) - uiStart));
+  if (ZSTD_isError(res) || res != uiExpectedSize)
+  {
+    ezLog::Error("Block compressed data is corrupt. Decompressing block {} failed: '{}'", uiBlock, ZSTD_isError(res) ? ZSTD_getErrorName(res) : "unexpected size");
+    return false;
+  }
+
+  return true;
+}
+
+bool ezArchiveBlockCompressedReader::DecompressBlocksParallel(ezUInt32 uiFirstBlock, ezUInt32 uiNumBlocks, ezUInt8* pTarget) const
+{
+  struct Context
+  {
+    const ezArchiveBlockCompressedReader* m_pReader;
+    ezUInt32 m_uiFirstBlock;
+    ezUInt8* m_pTarget;
+    ezAtomicInteger32 m_iFailures;
+  };
+
+  Context ctxt;
+  ctxt.m_pReader = this;
+  ctxt.m_uiFirstBlock = uiFirstBlock;
+  ctxt.m_pTarget = pTarget;
+
+  ezParallelForParams params;
+  params.m_uiBinSize = 1;
+  params.m_uiMaxTasksPerThread = 2;
+
+  ezTaskSystem::ParallelForIndexed(
+    0u, uiNumBlocks,
+    [pCtxt = &ctxt](ezUInt32 uiStart, ezUInt32 uiEnd)
+    {
+      const ezArchiveBlockCompressedReader* pReader = pCtxt->m_pReader;
+      ZSTD_DCtx* pDCtx = ZSTD_createDCtx();
+
+      for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+      {
+        const ezUInt32 uiBlock = pCtxt->m_uiFirstBlock + i;
+        const ezUInt64 uiBlockStart = pReader->GetBlockOffset(uiBlock);
+        const ezUInt32 uiExpectedSize = pReader->GetUncompressedBlockSize(uiBlock);
+        ezUInt8* pBlockTarget = pCtxt->m_pTarget + static_cast<ezUInt64>(i) * pReader->m_uiBlockSize;
+
+        const size_t res = ZSTD_decompressDCtx(pDCtx, pBlockTarget, uiExpectedSize, pReader->m_pData + uiBlockStart, static_cast<size_t>(pReader->GetBlockOffset(uiBlock + 1) - uiBlockStart));
+
+        if (ZSTD_isError(res) || res != uiExpectedSize)
+        {
+          pCtxt->m_iFailures.Increment();
+        }
+      }
+
+      ZSTD_freeDCtx(pDCtx);
+    },
+    "DecompressArchiveBlocks", params);
+
+  if (ctxt.m_iFailures != 0)
+  {
+    ezLog::Error("Block compressed data is corrupt. Decompressing {} blocks failed.", (ezInt32)ctxt.m_iFailures);
+    return false;
+  }
+
+  return true;
+}
+
+ezResult ezArchiveBlockCompressedReader::WriteBlocks(ezStreamReader& inout_source, ezStreamWriter& inout_stream, ezInt32 iCompressionLevel, ezUInt64& out_uiUncompressedSize, ezUInt64& out_uiStoredSize, ezUInt64 uiTotalSize, ezDelegate<bool(ezUInt64, ezUInt64)> progress)
+{
+  constexpr ezUInt32 uiBlockSize = DefaultBlockSize;
+  const ezUInt32 uiMaxCompressedBlockSize = static_cast<ezUInt32>(ZSTD_compressBound(uiBlockSize));
+
+  // enough blocks per batch to give every thread a couple of them
+  const ezUInt32 uiBlocksPerBatch = (ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1) * 2;
+
+  ezDynamicArray<ezUInt8> uncompressed;
+  uncompressed.SetCountUninitialized(uiBlocksPerBatch * uiBlockSize);
+
+  ezDynamicArray<ezUInt8> compressed;
+  compressed.SetCountUninitialized(uiBlocksPerBatch * uiMaxCompressedBlockSize);
+
+  ezDynamicArray<ezUInt32> compressedSizes;
+  compressedSizes.SetCount(uiBlocksPerBatch);
+
+  ezDynamicArray<ezUInt64> blockOffsets;
+
+  out_uiUncompressedSize = 0;
+  out_uiStoredSize = 0;
+
+  struct Context
+  {
+    const ezUInt8* m_pUncompressed;
+    ezUInt8* m_pCompressed;
+    ezUInt32* m_pCompressedSizes;
+    ezUInt32 m_uiBytesInBatch;
+    ezUInt32 m_uiMaxCompressedBlockSize;
+    ezInt32 m_iCompressionLevel;
+    ezAtomicInteger32 m_iFailures;
+  };
+
+  Context ctxt;
+  ctxt.m_pUncompressed = uncompressed.GetData();
+  ctxt.m_pCompressed = compressed.GetData();
+  ctxt.m_pCompressedSizes = compressedSizes.GetData();
+  ctxt.m_uiMaxCompressedBlockSize = uiMaxCompressedBlockSize;
+  ctxt.m_iCompressionLevel = iCompressionLevel;
+
+  ezParallelForParams params;
+  params.m_uiBinSize = 1;
+  params.m_uiMaxTasksPerThread = 2;
+
+  while (true)
+  {
+    // fill the batch
+    ezUInt64 uiBytesInBatch = 0;
+    while (uiBytesInBatch < uncompressed.GetCount())
+    {
+      const ezUInt64 uiRead = inout_source.ReadBytes(uncompressed.GetData() + uiBytesInBatch, uncompressed.GetCount() - uiBytesInBatch);
+
+      if (uiRead == 0)
+        break;
+
+      uiBytesInBatch += uiRead;
+    }
+
+    if (uiBytesInBatch == 0)
+      break;
+
+    ctxt.m_uiBytesInBatch = static_cast<ezUInt32>(uiBytesInBatch);
+    const ezUInt32 uiBlocksInBatch = static_cast<ezUInt32>((uiBytesInBatch + uiBlockSize - 1) / uiBlockSize);
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, uiBlocksInBatch,
+      [pCtxt = &ctxt](ezUInt32 uiStart, ezUInt32 uiEnd)
+      {
+        ZSTD_CCtx* pCCtx = ZSTD_createCCtx();
+
+        for (ezUInt32 uiBlock = uiStart; uiBlock < uiEnd; ++uiBlock)
+        {
+          const ezUInt32 uiBlockStart = uiBlock * uiBlockSize;
+          const ezUInt32 uiBytes = ezMath::Min(uiBlockSize, pCtxt->m_uiBytesInBatch - uiBlockStart);
+
+          const size_t res = ZSTD_compressCCtx(pCCtx, pCtxt->m_pCompressed + uiBlock * pCtxt->m_uiMaxCompressedBlockSize, pCtxt->m_uiMaxCompressedBlockSize, pCtxt->m_pUncompressed + uiBlockStart, uiBytes, pCtxt->m_iCompressionLevel);
+
+          if (ZSTD_isError(res))
+          {
+            pCtxt->m_iFailures.Increment();
+            pCtxt->m_pCompressedSizes[uiBlock] = 0;
+          }
+          else
+          {
+            pCtxt->m_pCompressedSizes[uiBlock] = static_cast<ezUInt32>(res);
+          }
+        }
+
+        ZSTD_freeCCtx(pCCtx);
+      },
+      "CompressArchiveBlocks", params);
+
+    if (ctxt.m_iFailures > 0)
+    {
+      ezLog::Error("Compressing archive blocks failed.");
+      return EZ_FAILURE;
+    }
+
+    for (ezUInt32 uiBlock = 0; uiBlock < uiBlocksInBatch; ++uiBlock)
+    {
+      blockOffsets.PushBack(out_uiStoredSize);
+
+      EZ_SUCCEED_OR_RETURN(inout_stream.WriteBytes(compressed.GetData() + uiBlock * uiMaxCompressedBlockSize, compressedSizes[uiBlock]));
+      out_uiStoredSize += compressedSizes[uiBlock];
+    }
+
+    out_uiUncompressedSize += uiBytesInBatch;
+
+    if (progress.IsValid() && !progress(out_uiUncompressedSize, uiTotalSize))
+      return EZ_FAILURE;
+
+    if (uiBytesInBatch < uncompressed.GetCount())
+      break;
+  }
+
+  // the seek table
+  blockOffsets.PushBack(out_uiStoredSize);
+  EZ_SUCCEED_OR_RETURN(inout_stream.WriteBytes(blockOffsets.GetData(), blockOffsets.GetCount() * sizeof(ezUInt64)));
+
+  const ezUInt32 uiNumBlocks = blockOffsets.GetCount() - 1;
+  inout_stream << uiBlockSize;
+  inout_stream << uiNumBlocks;
+
+  out_uiStoredSize += blockOffsets.GetCount() * sizeof(ezUInt64) + s_uiFooterSize;
+
+  return EZ_SUCCESS;
+}
+
+#endif
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Archive_Implementation_ArchiveBlockCompressedReader);
@@ -4,6 +4,7 @@
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Time/Stopwatch.h>
@@ -62,6 +63,10 @@ void ezArchiveBuilder::AddFolder(ezStringView sAbsFolderPath, ezArchiveCompressi
             compression = ezArchiveCompressionMode::Compressed_zstd;
             iCompressionLevel = static_cast<ezInt32>(ezCompressedStreamWriterZstd::Compression::Highest);
             break;
+          case InclusionMode::Compress_zstd_blocks:
+            compression = ezArchiveCompressionMode::Compressed_zstd_blocks;
+            iCompressionLevel = static_cast<ezInt32>(ezCompressedStreamWriterZstd::Compression::Fast);
+            break;
         }
       }
 
@@ -94,14 +99,49 @@ ezResult ezArchiveBuilder::WriteArchive(ezStringView sFile) const
 
 ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& inout_stream) const
 {
-  EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteHeader(inout_stream));
+  const ezUInt32 uiNumEntries = m_Entries.GetCount();
+
+  ezDynamicArray<ezArchiveCompressionMode> compressionModes;
+  compressionModes.Reserve(uiNumEntries);
+
+  for (const SourceEntry& e : m_Entries)
+  {
+    compressionModes.PushBack(e.m_CompressionMode);
+  }
+
+  // version 5 must only be written, if an entry really ends up block compressed, but WriteEntryOptimal() stores entries uncompressed when
+  // compression doesn't pay off, so this is only known after compressing them
+  // entries that fall back are then written uncompressed right away, the data of the first one that doesn't is kept and written as is
+  ezUInt32 uiFirstBlockEntry = ezInvalidIndex;
+  ezArchiveEntry firstBlockEntry;
+  ezDefaultMemoryStreamStorage firstBlockEntryData;
+
+  for (ezUInt32 i = 0; i < uiNumEntries && uiFirstBlockEntry == ezInvalidIndex; ++i)
+  {
+    if (compressionModes[i] != ezArchiveCompressionMode::Compressed_zstd_blocks)
+      continue;
+
+    firstBlockEntryData.Clear();
+    ezMemoryStreamWriter writer(&firstBlockEntryData);
+
+    ezUInt64 uiEntryStreamSize = 0;
+    EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(writer, m_Entries[i].m_sAbsSourcePath, 0, compressionModes[i], m_Entries[i].m_iCompressionLevel, firstBlockEntry, uiEntryStreamSize));
+
+    compressionModes[i] = firstBlockEntry.m_CompressionMode;
+
+    if (firstBlockEntry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_blocks)
+    {
+      uiFirstBlockEntry = i;
+    }
+  }
+
+  EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteHeader(inout_stream, uiFirstBlockEntry != ezInvalidIndex));
 
   ezArchiveTOC toc;
 
   ezStringBuilder sHashablePath;
 
   ezUInt64 uiStreamSize = 0;
-  const ezUInt32 uiNumEntries = m_Entries.GetCount();
 
   ezStopwatch sw;
 
@@ -122,7 +162,21 @@ ezResult ezArchiveBuilder::WriteArchive(ezStreamWriter& inout_stream) const
 
     ezArchiveEntry& tocEntry = toc.m_Entries.ExpandAndGetRef();
 
-    EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(inout_stream, e.m_sAbsSourcePath, uiPathStringOffset, e.m_CompressionMode, e.m_iCompressionLevel, tocEntry, uiStreamSize, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this)));
+    if (i == uiFirstBlockEntry)
+    {
+      tocEntry = firstBlockEntry;
+      tocEntry.m_uiPathStringOffset = uiPathStringOffset;
+      tocEntry.m_uiDataStartOffset = uiStreamSize;
+
+      EZ_SUCCEED_OR_RETURN(firstBlockEntryData.CopyToStream(inout_stream));
+      uiStreamSize += tocEntry.m_uiStoredDataSize;
+
+      firstBlockEntryData.Clear();
+    }
+    else
+    {
+      EZ_SUCCEED_OR_RETURN(ezArchiveUtils::WriteEntryOptimal(inout_stream, e.m_sAbsSourcePath, uiPathStringOffset, compressionModes[i], e.m_iCompressionLevel, tocEntry, uiStreamSize, ezMakeDelegate(&ezArchiveBuilder::WriteFileProgressCallback, this)));
+    }
 
     WriteFileResultCallback(i + 1, uiNumEntries, e.m_sAbsSourcePath, tocEntry.m_uiUncompressedDataSize, tocEntry.m_uiStoredDataSize, sw.Checkpoint());
   }
@@ -1,5 +1,6 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/IO/Archive/ArchiveBlockCompressedReader.h>
 #include <Foundation/IO/Archive/ArchiveReader.h>
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 
@@ -65,6 +66,14 @@ ezResult ezArchiveReader::OpenArchive(ezStringView sPath)
         ezLog::Error("Archive is corrupt. Invalid entry path-string offset.");
         return EZ_FAILURE;
       }
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+      if (e.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_blocks)
+      {
+        ezArchiveBlockCompressedReader blockReader;
+        EZ_SUCCEED_OR_RETURN(blockReader.SetInputData(ezMemoryUtils::AddByteOffset(m_pDataStart, static_cast<ptrdiff_t>(e.m_uiDataStartOffset)), e.m_uiStoredDataSize, e.m_uiUncompressedDataSize));
+      }
+#endif
     }
   }
 
@@ -104,11 +113,75 @@ void ezArchiveReader::ConfigureRawMemoryStreamReader(ezUInt32 uiEntryIdx, ezRawM
   ezArchiveUtils::ConfigureRawMemoryStreamReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart, ref_memReader);
 }
 
+ezArrayPtr<const ezUInt8> ezArchiveReader::GetUncompressedEntryData(ezUInt32 uiEntryIdx) const
+{
+  const ezArchiveEntry& entry = m_ArchiveTOC.m_Entries[uiEntryIdx];
+
+  // ezArrayPtr can't represent entries of 4 GB or more, those have to be read through a stream
+  if (entry.m_CompressionMode != ezArchiveCompressionMode::Uncompressed || entry.m_uiStoredDataSize > ezMath::MaxValue<ezUInt32>())
+    return {};
+
+  const ezUInt8* pData = static_cast<const ezUInt8*>(ezMemoryUtils::AddByteOffset(m_pDataStart, static_cast<ptrdiff_t>(entry.m_uiDataStartOffset)));
+  return ezArrayPtr<const ezUInt8>(pData, static_cast<ezUInt32>(entry.m_uiStoredDataSize));
+}
+
 ezUniquePtr<ezStreamReader> ezArchiveReader::CreateEntryReader(ezUInt32 uiEntryIdx) const
 {
   return ezArchiveUtils::CreateEntryReader(m_ArchiveTOC.m_Entries[uiEntryIdx], m_pDataStart);
 }
 
+void ezArchiveReader::ConfigureBlockCompressedReader(ezUInt32 uiEntryIdx, ezArchiveBlockCompressedReader& ref_reader) const
+{
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  const ezArchiveEntry& entry = m_ArchiveTOC.m_Entries[uiEntryIdx];
+  EZ_ASSERT_DEV(entry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_blocks, "Archive entry {} is not block compressed.", uiEntryIdx);
+
+  // the seek table was already validated when opening the archive
+  ref_reader.SetInputData(ezMemoryUtils::AddByteOffset(m_pDataStart, static_cast<ptrdiff_t>(entry.m_uiDataStartOffset)), entry.m_uiStoredDataSize, entry.m_uiUncompressedDataSize).AssertSuccess();
+#else
+  EZ_REPORT_FAILURE("Block compressed archive entries require zstd support.");
+#endif
+}
+
+ezUInt64 ezArchiveReader::ReadEntryData(ezUInt32 uiEntryIdx, ezUInt64 uiStartOffset, void* pBuffer, ezUInt64 uiBytesToRead) const
+{
+  const ezArchiveEntry& entry = m_ArchiveTOC.m_Entries[uiEntryIdx];
+
+  if (uiStartOffset >= entry.m_uiUncompressedDataSize)
+    return 0;
+
+  switch (entry.m_CompressionMode)
+  {
+    case ezArchiveCompressionMode::Uncompressed:
+    {
+      ezRawMemoryStreamReader reader;
+      ConfigureRawMemoryStreamReader(uiEntryIdx, reader);
+      reader.SetReadPosition(uiStartOffset);
+      return reader.ReadBytes(pBuffer, uiBytesToRead);
+    }
+
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    case ezArchiveCompressionMode::Compressed_zstd_blocks:
+    {
+      ezArchiveBlockCompressedReader reader;
+      ConfigureBlockCompressedReader(uiEntryIdx, reader);
+      reader.SetReadPosition(uiStartOffset);
+      return reader.ReadBytes(pBuffer, uiBytesToRead);
+    }
+#endif
+
+    default:
+    {
+      ezUniquePtr<ezStreamReader> pReader = CreateEntryReader(uiEntryIdx);
+
+      if (pReader == nullptr || pReader->SkipBytes(uiStartOffset) != uiStartOffset)
+        return 0;
+
+      return pReader->ReadBytes(pBuffer, uiBytesToRead);
+    }
+  }
+}
+
 ezResult ezArchiveReader::ExtractFile(ezUInt32 uiEntryIdx, ezStringView sTargetFolder) const
 {
   ezStringView sFilePath = m_ArchiveTOC.GetEntryPathString(uiEntryIdx);
@@ -3,6 +3,7 @@
 #include <Foundation/IO/Archive/ArchiveUtils.h>
 
 #include <Foundation/Algorithm/HashStream.h>
+#include <Foundation/IO/Archive/ArchiveBlockCompressedReader.h>
 #include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/MemoryMappedFile.h>
@@ -32,16 +33,18 @@ bool ezArchiveUtils::IsAcceptedArchiveFileExtensions(ezStringView sExtension)
   return false;
 }
 
-ezResult ezArchiveUtils::WriteHeader(ezStreamWriter& inout_stream)
+ezResult ezArchiveUtils::WriteHeader(ezStreamWriter& inout_stream, bool bHasBlockCompressedEntries /*= false*/)
 {
   const char* szTag = "EZARCHIVE";
   EZ_SUCCEED_OR_RETURN(inout_stream.WriteBytes(szTag, 10));
 
-  const ezUInt8 uiArchiveVersion = 4;
+  // older readers can still open archives that don't use any version 5 features
+  const ezUInt8 uiArchiveVersion = bHasBlockCompressedEntries ? 5 : 4;
 
   // Version 2: Added end-of-file marker for file corruption (cutoff) detection
   // Version 3: HashedStrings changed from MurmurHash to xxHash
   // Version 4: use 64 Bit string hashes
+  // Version 5: added block compressed entries (ezArchiveCompressionMode::Compressed_zstd_blocks)
   inout_stream << uiArchiveVersion;
 
   const ezUInt8 uiPadding[5] = {0, 0, 0, 0, 0};
@@ -62,7 +65,7 @@ ezResult ezArchiveUtils::ReadHeader(ezStreamReader& inout_stream, ezUInt8& out_u
   out_uiVersion = 0;
   inout_stream >> out_uiVersion;
 
-  if (out_uiVersion != 1 && out_uiVersion != 2 && out_uiVersion != 3 && out_uiVersion != 4)
+  if (out_uiVersion != 1 && out_uiVersion != 2 && out_uiVersion != 3 && out_uiVersion != 4 && out_uiVersion != 5)
   {
     ezLog::Error("Unsupported archive version '{}'.", out_uiVersion);
     return EZ_FAILURE;
@@ -101,6 +104,18 @@ ezResult ezArchiveUtils::WriteEntry(
   inout_tocEntry.m_uiDataStartOffset = inout_uiCurrentStreamPosition;
   inout_tocEntry.m_uiUncompressedDataSize = 0;
 
+#ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+  if (compression == ezArchiveCompressionMode::Compressed_zstd_blocks)
+  {
+    inout_tocEntry.m_CompressionMode = compression;
+
+    EZ_SUCCEED_OR_RETURN(ezArchiveBlockCompressedReader::WriteBlocks(file, inout_stream, iCompressionLevel, inout_tocEntry.m_uiUncompressedDataSize, inout_tocEntry.m_uiStoredDataSize, uiMaxBytes, progress));
+
+    inout_uiCurrentStreamPosition += inout_tocEntry.m_uiStoredDataSize;
+    return EZ_SUCCESS;
+  }
+#endif
+
   ezStreamWriter* pWriter = &inout_stream;
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
@@ -232,6 +247,14 @@ ezUniquePtr<ezStreamReader> ezArchiveUtils::CreateEntryReader(const ezArchiveEnt
       pRawReader->SetInputStream(&pRawReader->m_Source);
       break;
     }
+
+    case ezArchiveCompressionMode::Compressed_zstd_blocks:
+    {
+      reader = EZ_DEFAULT_NEW(ezArchiveBlockCompressedReader);
+      ezArchiveBlockCompressedReader* pBlockReader = static_cast<ezArchiveBlockCompressedReader*>(reader.Borrow());
+      EZ_VERIFY(pBlockReader->SetInputData(ezMemoryUtils::AddByteOffset(pStartOfArchiveData, static_cast<ptrdiff_t>(entry.m_uiDataStartOffset)), entry.m_uiStoredDataSize, entry.m_uiUncompressedDataSize).Succeeded(), "Invalid block compressed archive entry.");
+      break;
+    }
 #endif
 
     default:
@@ -86,6 +86,26 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(ezStringView
         }
         break;
       }
+
+      case ezArchiveCompressionMode::Compressed_zstd_blocks:
+      {
+        ArchiveReaderZstdBlocks* pBlockReader = nullptr;
+
+        if (!m_FreeReadersZstdBlocks.IsEmpty())
+        {
+          pBlockReader = m_FreeReadersZstdBlocks.PeekBack();
+          m_FreeReadersZstdBlocks.PopBack();
+        }
+        else
+        {
+          m_ReadersZstdBlocks.PushBack(EZ_DEFAULT_NEW(ArchiveReaderZstdBlocks, 2));
+          pBlockReader = m_ReadersZstdBlocks.PeekBack().Borrow();
+        }
+
+        m_ArchiveReader.ConfigureBlockCompressedReader(uiEntryIndex, pBlockReader->m_BlockReader);
+        pReader = pBlockReader;
+        break;
+      }
 #endif
 
       default:
@@ -98,6 +118,7 @@ ezDataDirectoryReader* ezDataDirectory::ArchiveType::OpenFileToRead(ezStringView
   pReader->m_uiCompressedSize = pEntry->m_uiStoredDataSize;
 
   m_ArchiveReader.ConfigureRawMemoryStreamReader(uiEntryIndex, pReader->m_MemStreamReader);
+  pReader->m_MappedData = m_ArchiveReader.GetUncompressedEntryData(uiEntryIndex);
 
   if (pReader->Open(sArchivePath, this, FileShareMode).Failed())
   {
@@ -220,6 +241,12 @@ void ezDataDirectory::ArchiveType::OnReaderWriterClose(ezDataDirectoryReaderWrit
     m_FreeReadersZstd.PushBack(static_cast<ArchiveReaderZstd*>(pClosed));
     return;
   }
+
+  if (pClosed->GetDataDirUserData() == 2)
+  {
+    m_FreeReadersZstdBlocks.PushBack(static_cast<ArchiveReaderZstdBlocks*>(pClosed));
+    return;
+  }
 #endif
 
 
@@ -282,6 +309,25 @@ ezResult ezDataDirectory::ArchiveReaderZstd::InternalOpen(ezFileShareMode::Enum
   return EZ_SUCCESS;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+ezDataDirectory::ArchiveReaderZstdBlocks::ArchiveReaderZstdBlocks(ezInt32 iDataDirUserData)
+  : ArchiveReaderUncompressed(iDataDirUserData)
+{
+}
+
+ezDataDirectory::ArchiveReaderZstdBlocks::~ArchiveReaderZstdBlocks() = default;
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdBlocks::Read(void* pBuffer, ezUInt64 uiBytes)
+{
+  return m_BlockReader.ReadBytes(pBuffer, uiBytes);
+}
+
+ezUInt64 ezDataDirectory::ArchiveReaderZstdBlocks::SkipBytes(ezUInt64 uiBytes)
+{
+  return m_BlockReader.SkipBytes(uiBytes);
+}
+
 #endif
 
 //////////////////////////////////////////////////////////////////////////
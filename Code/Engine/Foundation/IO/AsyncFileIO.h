@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Strings/String.h>
+#include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Types/Delegate.h>
+
+/// \brief Selects how ezAsyncFileIO executes file reads.
+struct ezAsyncFileIOBackend
+{
+  enum Enum : ezUInt8
+  {
+    ThreadPool, ///< Every read is a blocking read inside a long running task of the ezTaskSystem. Available on all platforms.
+    IoUring,    ///< All reads are submitted to a Linux io_uring from one dedicated thread, so many reads can be outstanding at the same time.
+
+    Default, ///< Uses IoUring where the kernel supports it and falls back to ThreadPool everywhere else.
+  };
+};
+
+/// \brief The result of a read that was started with ezAsyncFileIO::ReadFile(). Passed to the completion callback.
+struct ezAsyncFileReadResult
+{
+  ezString m_sFile;                ///< The path of the file, as it was passed to ezAsyncFileIO::ReadFile().
+  ezResult m_Result = EZ_FAILURE;  ///< Whether the entire file could be read.
+  ezDynamicArray<ezUInt8> m_Data;  ///< The entire file content. The callback may take it, e.g. by swapping it with another array.
+  void* m_pUserData = nullptr;     ///< The user data that was passed to ezAsyncFileIO::ReadFile().
+};
+
+/// \brief Reads entire files from disk without blocking the calling thread.
+///
+/// All functions work on OS file paths (like ezOSFile), not on paths inside the ezFileSystem data directories.
+/// See ezFileSystem::PrefetchFile() for reading files of mounted data directories ahead of time.
+///
+/// With the io_uring backend, one thread submits the reads of all requested files to the kernel at once, so loading thousands of
+/// small files is not limited by the latency of every single read. Once a file was read, the completion callback is executed
+/// as a task of the ezTaskSystem.
+class EZ_FOUNDATION_DLL ezAsyncFileIO
+{
+public:
+  using Callback = ezDelegate<void(ezAsyncFileReadResult&)>;
+
+  /// \brief Starts reading the entire file and returns immediately.
+  ///
+  /// \a onFinished is called exactly once, from a task with the given priority, also when the file could not be read.
+  static void ReadFile(ezStringView sAbsolutePath, Callback onFinished, void* pUserData = nullptr, ezTaskPriority::Enum callbackPriority = ezTaskPriority::ThisFrame); // [tested]
+
+  /// \brief Blocks until all reads are finished and their callbacks have been executed. Executes other tasks in the mean time.
+  static void WaitForAllReads(); // [tested]
+
+  /// \brief Returns the number of reads whose callbacks have not been executed yet.
+  static ezUInt32 GetNumPendingReads(); // [tested]
+
+  /// \brief Selects the backend for all following reads.
+  ///
+  /// Reads that were started before are still finished by the previous backend. This function returns once their data was read,
+  /// their callbacks may still be pending.
+  ///
+  /// If the requested backend is not available on this system, ThreadPool is used instead.
+  static void SetBackend(ezAsyncFileIOBackend::Enum backend); // [tested]
+
+  /// \brief Returns the backend that is used for reading, never ezAsyncFileIOBackend::Default.
+  static ezAsyncFileIOBackend::Enum GetBackend(); // [tested]
+
+private:
+  EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, AsyncFileIO);
+
+  static void Shutdown();
+};
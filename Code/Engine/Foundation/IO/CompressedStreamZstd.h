@@ -7,6 +7,8 @@
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
 
+class ezCompressionDictionaryZstd;
+
 /// \brief A stream reader that will decompress data that was stored using the ezCompressedStreamWriterZstd.
 ///
 /// The reader takes another reader as its source for the compressed data (e.g. a file or a memory stream).
@@ -26,6 +28,12 @@ public:
   /// one.
   void SetInputStream(ezStreamReader* pInputStream); // [tested]
 
+  /// \brief Sets the dictionary that was used to compress the data.
+  ///
+  /// Must be called before the first byte is read from the current input stream. The dictionary stays active for all following input
+  /// streams, until it is reset by passing nullptr. The dictionary object must stay alive as long as it is in use by the reader.
+  void SetDictionary(const ezCompressionDictionaryZstd* pDictionary); // [tested]
+
   /// \brief Reads either uiBytesToRead or the amount of remaining bytes in the stream into pReadBuffer.
   ///
   /// It is valid to pass nullptr for pReadBuffer, in this case the memory stream position is only advanced by the given number of bytes.
@@ -46,6 +54,7 @@ private:
   bool m_bReachedEnd = false;
   ezDynamicArray<ezUInt8> m_CompressedCache;
   ezStreamReader* m_pInputStream = nullptr;
+  const ezCompressionDictionaryZstd* m_pDictionary = nullptr;
   /*ZSTD_DStream*/ void* m_pZstdDStream = nullptr;
   /*ZSTD_inBuffer*/ InBufferImpl m_InBuffer;
 };
@@ -92,6 +101,10 @@ public:
   /// another stream. This can prevent internal allocations, if one wants to use compression on multiple streams consecutively. It also
   /// allows to create a compressor stream early, but decide at a later pointer whether or with which stream to use it, and it will only
   /// allocate internal structures once that final decision is made.
+  ///
+  /// If \a uiMaxNumWorkerThreads is larger than zero, zstd compresses the data on up to that many worker threads (limited by the number of
+  /// CPU cores). The data is then compressed in jobs of about 1 MB, so that even moderately sized data is distributed across the threads.
+  /// Writing to the stream returns immediately in this mode, while compression happens in the background.
   void SetOutputStream(ezStreamWriter* pOutputStream, ezUInt32 uiMaxNumWorkerThreads, Compression ratio = Compression::Default, ezUInt32 uiCompressionCacheSizeKB = 4); // [tested]
 
   /// \brief Compresses \a uiBytesToWrite from \a pWriteBuffer.
@@ -99,6 +112,14 @@ public:
   /// Will output bursts of 256 bytes to the output stream every once in a while.
   virtual ezResult WriteBytes(const void* pWriteBuffer, ezUInt64 uiBytesToWrite) override; // [tested]
 
+  /// \brief Sets a dictionary to compress the data with.
+  ///
+  /// Must be called before the first byte is written to the current output stream. The dictionary stays active for all following output
+  /// streams, until it is reset by passing nullptr. The dictionary object must stay alive as long as it is in use by the writer.
+  /// The compression level of the dictionary takes precedence over the one passed to SetOutputStream().
+  /// \note The data can only be decompressed by an ezCompressedStreamReaderZstd that uses the very same dictionary.
+  void SetDictionary(const ezCompressionDictionaryZstd* pDictionary); // [tested]
+
   /// \brief Finishes the stream and writes all remaining data to the output stream.
   ///
   /// After calling this function, no more data can be written to the stream. GetCompressedSize() will return the final compressed size
@@ -134,6 +155,7 @@ public:
 
 private:
   ezResult FlushWriteCache();
+  void ApplyDictionary();
 
   ezUInt64 m_uiUncompressedSize = 0;
   ezUInt64 m_uiCompressedSize = 0;
@@ -148,10 +170,57 @@ private:
   };
 
   ezStreamWriter* m_pOutputStream = nullptr;
+  const ezCompressionDictionaryZstd* m_pDictionary = nullptr;
   /*ZSTD_CStream*/ void* m_pZstdCStream = nullptr;
   /*ZSTD_outBuffer*/ OutBufferImpl m_OutBuffer;
 
   ezDynamicArray<ezUInt8> m_CompressedCache;
 };
 
+/// \brief A dictionary that can be shared between ezCompressedStreamWriterZstd and ezCompressedStreamReaderZstd.
+///
+/// Small pieces of data, such as individually serialized components or small assets, compress badly, because the compressor has no
+/// history of previous data to refer to. A dictionary provides such a history up front, which drastically improves the compression ratio
+/// and speed for many small pieces of similar data.
+///
+/// The dictionary is not stored in the compressed data, so the exact same dictionary has to be used for decompression.
+/// Store the result of GetData() alongside the compressed data and recreate the dictionary with CreateFromData() before reading.
+/// Once created, a dictionary can be used by any number of readers and writers on different threads at the same time.
+class EZ_FOUNDATION_DLL ezCompressionDictionaryZstd
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezCompressionDictionaryZstd);
+
+public:
+  ezCompressionDictionaryZstd();
+  ~ezCompressionDictionaryZstd();
+
+  /// \brief Builds a dictionary of at most \a uiMaxDictionarySize bytes out of the most common byte sequences in the given samples.
+  ///
+  /// The samples should be representative of the data that is going to be compressed, e.g. a couple of hundred serialized components.
+  /// In total they should be several times larger than the dictionary, otherwise all of the sample data is used as the dictionary.
+  void CreateFromSamples(ezArrayPtr<const ezArrayPtr<const ezUInt8>> samples, ezUInt32 uiMaxDictionarySize = 16 * 1024, ezCompressedStreamWriterZstd::Compression ratio = ezCompressedStreamWriterZstd::Compression::Default); // [tested]
+
+  /// \brief Creates the dictionary from data previously returned by GetData().
+  ///
+  /// This may also be a dictionary that was trained with the zstd command line tool.
+  void CreateFromData(ezArrayPtr<const ezUInt8> data, ezCompressedStreamWriterZstd::Compression ratio = ezCompressedStreamWriterZstd::Compression::Default); // [tested]
+
+  /// \brief Releases all data.
+  void Clear();
+
+  /// \brief Whether the dictionary has been created.
+  bool IsValid() const { return m_pCDict != nullptr; } // [tested]
+
+  /// \brief Returns the raw dictionary data, which can be stored and later passed to CreateFromData().
+  ezArrayPtr<const ezUInt8> GetData() const { return m_Data; } // [tested]
+
+private:
+  friend class ezCompressedStreamReaderZstd;
+  friend class ezCompressedStreamWriterZstd;
+
+  ezDynamicArray<ezUInt8> m_Data;
+  /*ZSTD_CDict*/ void* m_pCDict = nullptr;
+  /*ZSTD_DDict*/ void* m_pDDict = nullptr;
+};
+
 #endif // BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
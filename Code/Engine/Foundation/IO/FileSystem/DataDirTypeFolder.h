@@ -1,10 +1,16 @@
 #pragma once
 
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Containers/Map.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/Implementation/DataDirType.h>
 #include <Foundation/IO/OSFile.h>
+#include <Foundation/Time/Time.h>
+#include <Foundation/Types/SharedPtr.h>
+
+class ezDirectoryWatcher;
+struct ezAsyncFileReadResult;
 
 namespace ezDataDirectory
 {
@@ -34,6 +40,22 @@ namespace ezDataDirectory
     /// access.
     static ezString s_sRedirectionPrefix;
 
+    /// If enabled, each folder data directory remembers which files exist in it and which don't. Files that are searched in all
+    /// data directories are then usually only looked up in the data directory that actually contains them, instead of asking the
+    /// OS for every mounted folder.
+    ///
+    /// Changes to the folder are detected with an ezDirectoryWatcher, so this only has an effect on platforms that support directory
+    /// watchers, and only for data directories that are mounted after this was enabled. Since watching a folder recursively has a cost
+    /// of its own, this is disabled by default and should be enabled for folders with many files that are accessed often, e.g. at level load.
+    static bool s_bCacheFileExistence;
+
+    /// Files that were prefetched through ezFileSystem::PrefetchFile() but were not opened within this time are discarded, so that they
+    /// don't keep memory alive and don't return outdated content.
+    static ezTime s_PrefetchTimeout;
+
+    /// The maximum number of files that are prefetched at the same time per data directory. Further prefetch requests are ignored.
+    static ezUInt32 s_uiMaxPrefetchedFiles;
+
     /// \brief When s_sRedirectionFile and s_sRedirectionPrefix are used to enable file redirection, this will reload those config files.
     virtual void ReloadExternalConfigs() override;
 
@@ -49,6 +71,7 @@ namespace ezDataDirectory
     virtual void RemoveDataDirectory() override;
     virtual void DeleteFile(ezStringView sFile) override;
     virtual bool ExistsFile(ezStringView sFile, bool bOneSpecificDataDir) override;
+    virtual bool PrefetchFile(ezStringView sFile, bool bOneSpecificDataDir) override;
     virtual ezResult GetFileStats(ezStringView sFileOrFolder, bool bOneSpecificDataDir, ezFileStats& out_Stats) override;
     virtual FolderReader* CreateFolderReader() const;
     virtual FolderWriter* CreateFolderWriter() const;
@@ -61,6 +84,34 @@ namespace ezDataDirectory
 
     void LoadRedirectionFile();
 
+    enum class CachedExistence : ezUInt8
+    {
+      Unknown,
+      Exists,
+      Missing,
+    };
+
+    /// \brief Returns what the existence cache knows about the given file. Applies all changes that the directory watcher reported so far.
+    ///
+    /// out_uiGeneration has to be passed to SetCachedExistence(), so that a result is not stored, if the file was changed in between.
+    CachedExistence GetCachedExistence(ezStringView sFile, ezUInt32& out_uiGeneration);
+    void SetCachedExistence(ezStringView sFile, bool bExists, ezUInt32 uiGeneration);
+    void InvalidateCachedExistence(ezStringView sFile);
+
+    struct PrefetchedFile : public ezRefCounted
+    {
+      ezAtomicBool m_bFinished;
+      ezResult m_Result = EZ_FAILURE;
+      ezDynamicArray<ezUInt8> m_Data;
+      ezTime m_RequestTime;
+    };
+
+    static void OnPrefetchFinished(ezAsyncFileReadResult& ref_result);
+
+    /// \brief Removes the prefetched data for the given file, if any, and returns it. Waits for the read, if it is still in progress.
+    ezSharedPtr<PrefetchedFile> TakePrefetchedFile(ezStringView sFile);
+    void DiscardPrefetchedFile(ezStringView sFile);
+
     mutable ezMutex m_ReaderWriterMutex; ///< Locks m_Readers / m_Writers as well as the m_bIsInUse flag of each reader / writer.
     ezHybridArray<ezDataDirectory::FolderReader*, 4> m_Readers;
     ezHybridArray<ezDataDirectory::FolderWriter*, 4> m_Writers;
@@ -68,6 +119,14 @@ namespace ezDataDirectory
     mutable ezMutex m_RedirectionMutex;
     ezMap<ezString, ezString> m_FileRedirection;
     ezString128 m_sRedirectedDataDirPath;
+
+    mutable ezMutex m_ExistenceCacheMutex;             ///< Locks m_ExistenceCache and m_pExistenceWatcher.
+    ezDirectoryWatcher* m_pExistenceWatcher = nullptr; ///< Only set if s_bCacheFileExistence was enabled when the folder was mounted.
+    ezHashTable<ezString, bool> m_ExistenceCache;      ///< Maps a clean, data directory relative path to whether the file exists.
+    ezUInt32 m_uiExistenceCacheGeneration = 0;         ///< Incremented whenever an entry of the existence cache is invalidated.
+
+    mutable ezMutex m_PrefetchMutex;
+    ezHashTable<ezString, ezSharedPtr<PrefetchedFile>> m_PrefetchedFiles; ///< Uses the same keys as m_ExistenceCache.
   };
 
 
@@ -86,6 +145,9 @@ namespace ezDataDirectory
     virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) override;
     virtual ezUInt64 GetFileSize() const override;
 
+    /// \brief Returns the file content, if the file was prefetched through ezFileSystem::PrefetchFile() before it was opened.
+    virtual ezArrayPtr<const ezUInt8> GetMappedData() const override;
+
   protected:
     virtual ezResult InternalOpen(ezFileShareMode::Enum FileShareMode) override;
     virtual void InternalClose() override;
@@ -94,6 +156,10 @@ namespace ezDataDirectory
 
     bool m_bIsInUse;
     ezOSFile m_File;
+
+    bool m_bUsePrefetchedData = false; ///< If set, all reads are served from m_PrefetchedData instead of m_File.
+    ezUInt64 m_uiPrefetchedReadPosition = 0;
+    ezDynamicArray<ezUInt8> m_PrefetchedData;
   };
 
   /// \brief Handles writing to ordinary files.
@@ -23,6 +23,9 @@ public:
 
   /// \brief Opens the given file for reading. Returns EZ_SUCCESS if the file could be opened. A cache is created to speed up small reads.
   ///
+  /// If the data directory provides the file content directly in memory (see GetMappedData()), no cache is allocated and all reads copy
+  /// straight from that memory.
+  ///
   /// You should typically not disable bAllowFileEvents, unless you need to prevent recursive file events,
   /// which is only the case, if you are doing file accesses from within a File Event Handler.
   ezResult Open(ezStringView sFile, ezUInt32 uiCacheSize = 1024 * 64, ezFileShareMode::Enum fileShareMode = ezFileShareMode::Default,
@@ -34,7 +37,12 @@ public:
   /// \brief Attempts to read the given number of bytes into the buffer. Returns the actual number of bytes read.
   virtual ezUInt64 ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead) override;
 
+  /// \brief Skips bytes in the stream. Files that are mapped into memory only advance the read position, otherwise the data directory
+  /// reader decides how to skip the bytes that are not cached, see ezDataDirectoryReader::SkipBytes().
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytesToSkip) override;
+
 private:
+  ezArrayPtr<const ezUInt8> m_MappedData;
   ezUInt64 m_uiBytesCached = 0;
   ezUInt64 m_uiCacheReadPosition = 0;
   ezDynamicArray<ezUInt8> m_Cache;
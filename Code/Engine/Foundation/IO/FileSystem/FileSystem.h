@@ -7,6 +7,8 @@
 #include <Foundation/IO/OSFile.h>
 #include <Foundation/Threading/Mutex.h>
 
+#include <atomic>
+
 /// \brief The ezFileSystem provides high-level functionality to manage files in a virtual file system.
 ///
 /// There are two sides at which the file system can be extended:
@@ -34,11 +36,12 @@
 /// This allows to hook into the system and implement stuff like automatic asset transformations before/after certain
 /// file accesses, checking out files from revision control systems, or simply logging all file activity.
 ///
-/// All operations that go through the ezFileSystem are protected by a mutex, which means that opening, closing, deleting
-/// files, as well as adding or removing data directories etc. will be synchronized and cannot happen in parallel.
-/// Reading/writing file streams can happen in parallel, only the administrative tasks need to be protected.
+/// Adding or removing data directories is protected by a mutex. The list of mounted data directories is an immutable snapshot,
+/// which is replaced as a whole whenever a data directory is added or removed. All other operations (opening, deleting or
+/// checking for files, resolving paths etc.) only read the current snapshot and don't take any lock, so many threads can
+/// resolve paths and open files in parallel. Reading/writing file streams can happen in parallel as well.
 /// File events are broadcast as they occur, that means they will be executed on whichever thread triggered them.
-/// Since they are executed from within the filesystem mutex, they cannot occur in parallel.
+/// The event itself is protected by its own mutex, so handlers are never executed in parallel.
 class EZ_FOUNDATION_DLL ezFileSystem
 {
 public:
@@ -65,8 +68,12 @@ public:
 
   /// \name Data Directory Modifications
   ///
-  /// All functions that add / remove data directories are not thread safe and require that this is done
-  /// on a single thread with no other thread accessing anything in ezFileSystem simultaneously.
+  /// All functions that add / remove data directories are synchronized with each other. Other threads may access files
+  /// at the same time, they will either still see the previous set of data directories or already the new one.
+  /// Removing a data directory does not wait for other threads. The data directory is only destroyed (through
+  /// ezDataDirectoryType::RemoveDataDirectory()) once no thread is resolving a path anymore. That is done either by the next
+  /// modification of the data directories, or by the last thread that finishes resolving a path, which may be any thread,
+  /// e.g. a task system worker. Data directory types therefore must not expect to be destroyed on the thread that removed them.
   ///@{
 
   /// \brief This factory creates a data directory type, if it can handle the given data directory. Otherwise it returns nullptr.
@@ -187,8 +194,9 @@ public:
   /// \name Misc
   ///@{
 
-  /// \brief Returns the (recursive) mutex that is used internally by the file system which can be used to guard bundled operations on the file
-  /// system.
+  /// \brief Returns the (recursive) mutex that is used internally by the file system to synchronize adding and removing data directories.
+  ///
+  /// Locking it prevents that the set of data directories changes, it does not block other threads from accessing files.
   static ezMutex& GetMutex();
 
 #if EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS)
@@ -217,6 +225,13 @@ public:
   /// retrieving all data (e.g. GetFileStats on folders might not always work).
   static ezResult GetFileStats(ezStringView sFileOrFolder, ezFileStats& out_stats);
 
+  /// \brief Tells the data directory that contains the given file, that it will be opened soon. Returns false, if the file doesn't exist.
+  ///
+  /// Folder data directories start reading the entire file in the background through ezAsyncFileIO, so that opening it later does not
+  /// need to wait for the disk. This allows to issue the reads of many files at once, e.g. for all resources in the loading queue.
+  /// Prefetched files that are not opened within a few seconds are discarded again.
+  static bool PrefetchFile(ezStringView sFile); // [tested]
+
   /// \brief Tries to resolve the given path and returns the absolute and relative path to the final file.
   ///
   /// If the given path is a rooted path, for instance something like ":appdata/UserData.txt", (which is necessary for writing to files),
@@ -307,22 +322,51 @@ private:
     ezDataDirFactory m_Factory;
   };
 
+  /// \brief An immutable list of the mounted data directories. Readers access it without any lock, see ReadScope.
+  struct DataDirSnapshot
+  {
+    ezHybridArray<DataDirectory, 16> m_DataDirectories;
+  };
+
   struct FileSystemData
   {
     ezHybridArray<Factory, 4> m_DataDirFactories;
-    ezHybridArray<DataDirectory, 16> m_DataDirectories;
+
+    /// The currently published snapshot. Only replaced while m_FsMutex is locked.
+    std::atomic<DataDirSnapshot*> m_pDataDirs{nullptr};
+
+    /// The number of threads that currently read any snapshot.
+    std::atomic<ezInt32> m_iActiveReaders{0};
+
+    /// Snapshots that were replaced, but may still be used by readers. Protected by m_FsMutex.
+    ezHybridArray<DataDirSnapshot*, 4> m_RetiredDataDirs;
+    /// Data directories that were removed, but may still be used by readers through a retired snapshot. Protected by m_FsMutex.
+    ezHybridArray<ezDataDirectoryType*, 4> m_RetiredDataDirectories;
+    std::atomic<bool> m_bHasRetiredDataDirs{false};
 
     ezEvent<const FileEvent&, ezMutex> m_Event;
     ezMutex m_FsMutex;
   };
 
+  /// \brief Keeps the current data directory snapshot alive while a path is resolved.
+  struct ReadScope;
+
+  /// \brief Publishes a new data directory list. The previous snapshot and the removed data directories are retired
+  /// and deleted once no reader uses them anymore. Must be called with m_FsMutex locked.
+  static void PublishDataDirs(DataDirSnapshot* pNewDataDirs, ezArrayPtr<ezDataDirectoryType* const> removedDataDirs = {});
+
+  /// \brief Deletes all retired snapshots and data directories, if no reader is active. Must be called with m_FsMutex locked.
+  ///
+  /// If readers are still active, the last one of them calls this again.
+  static void DeleteRetiredDataDirs();
+
   /// \brief Returns a list of data directory categories that were embedded in the path.
   static ezStringView ExtractRootName(ezStringView sFile, ezString& rootName);
 
   /// \brief Returns the given path relative to its data directory. The path must be inside the given data directory.
-  static ezStringView GetDataDirRelativePath(ezStringView sFile, ezUInt32 uiDataDir);
+  static ezStringView GetDataDirRelativePath(ezStringView sFile, const DataDirectory& dataDir);
 
-  static DataDirectory* GetDataDirForRoot(const ezString& sRoot);
+  static const DataDirectory* GetDataDirForRoot(const DataDirSnapshot& dataDirs, const ezString& sRoot);
 
   static void CleanUpRootName(ezStringBuilder& sRoot);
 
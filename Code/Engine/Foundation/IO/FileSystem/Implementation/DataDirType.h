@@ -75,6 +75,12 @@ protected:
   /// An optimized implementation might look this information up in some hash-map.
   virtual bool ExistsFile(ezStringView sFile, bool bOneSpecificDataDir);
 
+  /// \brief Called by ezFileSystem::PrefetchFile() to start loading the given file in the background, because it will be opened soon.
+  ///
+  /// Returns true, if the file is handled by this data directory, so that the remaining data directories don't need to be asked.
+  /// The default implementation does not load anything ahead of time and only returns whether the file exists.
+  virtual bool PrefetchFile(ezStringView sFile, bool bOneSpecificDataDir) { return ExistsFile(sFile, bOneSpecificDataDir); }
+
   /// \brief Upon success returns the ezFileStats for a file in this data directory.
   virtual ezResult GetFileStats(ezStringView sFileOrFolder, bool bOneSpecificDataDir, ezFileStats& out_Stats) = 0;
 
@@ -163,6 +169,18 @@ public:
   }
 
   virtual ezUInt64 Read(void* pBuffer, ezUInt64 uiBytes) = 0;
+
+  /// \brief Advances the read position by up to \a uiBytes and returns by how much it was advanced.
+  ///
+  /// The default implementation reads the data and discards it. Readers that can move their read position without producing the skipped
+  /// data, for example without decompressing it, should override this.
+  virtual ezUInt64 SkipBytes(ezUInt64 uiBytes);
+
+  /// \brief Returns the entire file content, if the data directory can provide it directly in memory, without copying or decompressing it.
+  ///
+  /// This is the case for files that are stored uncompressed inside a memory mapped archive. The memory stays valid until the reader is
+  /// closed and is independent of the current read position. Returns an empty array, if the data can only be accessed through Read().
+  virtual ezArrayPtr<const ezUInt8> GetMappedData() const { return {}; }
 };
 
 /// \brief A base class for writers that handle writing to a (virtual) file inside a data directory.
@@ -1,8 +1,12 @@
 #include <Foundation/FoundationPCH.h>
 
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/IO/AsyncFileIO.h>
+#include <Foundation/IO/DirectoryWatcher.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 // clang-format off
 EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, FolderDataDirectory)
@@ -19,13 +23,36 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, FolderDataDirectory)
 EZ_END_SUBSYSTEM_DECLARATION;
 // clang-format on
 
+namespace
+{
+  /// The existence cache of a folder is cleared entirely, once it contains this many entries.
+  constexpr ezUInt32 s_uiMaxExistenceCacheEntries = 64 * 1024;
+
+  void MakeExistenceCacheKey(ezStringView sFile, ezStringBuilder& out_sKey)
+  {
+    out_sKey = sFile;
+    out_sKey.MakeCleanPath();
+
+#if EZ_ENABLED(EZ_SUPPORTS_CASE_INSENSITIVE_PATHS)
+    out_sKey.ToLower();
+#endif
+  }
+} // namespace
+
 namespace ezDataDirectory
 {
   ezString FolderType::s_sRedirectionFile;
   ezString FolderType::s_sRedirectionPrefix;
+  bool FolderType::s_bCacheFileExistence = false;
+  ezTime FolderType::s_PrefetchTimeout = ezTime::Seconds(10);
+  ezUInt32 FolderType::s_uiMaxPrefetchedFiles = 64;
 
   ezResult FolderReader::InternalOpen(ezFileShareMode::Enum FileShareMode)
   {
+    // the file was read entirely by FolderType::PrefetchFile() already
+    if (m_bUsePrefetchedData)
+      return EZ_SUCCESS;
+
     ezStringBuilder sPath = ((ezDataDirectory::FolderType*)GetDataDirectory())->GetRedirectedDataDirectoryPath();
     sPath.AppendPath(GetFilePath());
 
@@ -34,19 +61,48 @@ namespace ezDataDirectory
 
   void FolderReader::InternalClose()
   {
+    if (m_bUsePrefetchedData)
+    {
+      // the reader is pooled, so don't keep the memory of the file alive
+      m_bUsePrefetchedData = false;
+      m_uiPrefetchedReadPosition = 0;
+      m_PrefetchedData.Clear();
+      m_PrefetchedData.Compact();
+      return;
+    }
+
     m_File.Close();
   }
 
   ezUInt64 FolderReader::Read(void* pBuffer, ezUInt64 uiBytes)
   {
+    if (m_bUsePrefetchedData)
+    {
+      const ezUInt64 uiBytesToRead = ezMath::Min<ezUInt64>(uiBytes, m_PrefetchedData.GetCount() - m_uiPrefetchedReadPosition);
+      ezMemoryUtils::Copy(static_cast<ezUInt8*>(pBuffer), m_PrefetchedData.GetData() + m_uiPrefetchedReadPosition, static_cast<size_t>(uiBytesToRead));
+      m_uiPrefetchedReadPosition += uiBytesToRead;
+      return uiBytesToRead;
+    }
+
     return m_File.Read(pBuffer, uiBytes);
   }
 
   ezUInt64 FolderReader::GetFileSize() const
   {
+    if (m_bUsePrefetchedData)
+      return m_PrefetchedData.GetCount();
+
     return m_File.GetFileSize();
   }
 
+  ezArrayPtr<const ezUInt8> FolderReader::GetMappedData() const
+  {
+    if (m_bUsePrefetchedData)
+      return m_PrefetchedData.GetArrayPtr();
+
+    return {};
+  }
+
   ezResult FolderWriter::InternalOpen(ezFileShareMode::Enum FileShareMode)
   {
     ezStringBuilder sPath = ((ezDataDirectory::FolderType*)GetDataDirectory())->GetRedirectedDataDirectoryPath();
@@ -101,6 +157,9 @@ namespace ezDataDirectory
 
   void FolderType::DeleteFile(ezStringView sFile)
   {
+    InvalidateCachedExistence(sFile);
+    DiscardPrefetchedFile(sFile);
+
     ezStringBuilder sPath = GetRedirectedDataDirectoryPath();
     sPath.AppendPath(sFile);
 
@@ -115,6 +174,10 @@ namespace ezDataDirectory
 
     for (ezUInt32 i = 0; i < m_Writers.GetCount(); ++i)
       EZ_DEFAULT_DELETE(m_Writers[i]);
+
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER)
+    EZ_DEFAULT_DELETE(m_pExistenceWatcher);
+#endif
   }
 
   void FolderType::ReloadExternalConfigs()
@@ -185,9 +248,23 @@ namespace ezDataDirectory
     ezStringBuilder sRedirectedAsset;
     ResolveAssetRedirection(sFile, sRedirectedAsset);
 
+    ezUInt32 uiGeneration = 0;
+    switch (GetCachedExistence(sRedirectedAsset, uiGeneration))
+    {
+      case CachedExistence::Exists:
+        return true;
+      case CachedExistence::Missing:
+        return false;
+      default:
+        break;
+    }
+
     ezStringBuilder sPath = GetRedirectedDataDirectoryPath();
     sPath.AppendPath(sRedirectedAsset);
-    return ezOSFile::ExistsFile(sPath);
+
+    const bool bExists = ezOSFile::ExistsFile(sPath);
+    SetCachedExistence(sRedirectedAsset, bExists, uiGeneration);
+    return bExists;
   }
 
   ezResult FolderType::GetFileStats(ezStringView sFileOrFolder, bool bOneSpecificDataDir, ezFileStats& out_Stats)
@@ -232,6 +309,24 @@ namespace ezDataDirectory
     if (!ezOSFile::ExistsDirectory(m_sRedirectedDataDirPath))
       return EZ_FAILURE;
 
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER)
+    if (s_bCacheFileExistence)
+    {
+      ezDirectoryWatcher* pWatcher = EZ_DEFAULT_NEW(ezDirectoryWatcher);
+
+      if (pWatcher->OpenDirectory(m_sRedirectedDataDirPath, ezDirectoryWatcher::Watch::Creates | ezDirectoryWatcher::Watch::Deletes | ezDirectoryWatcher::Watch::Renames | ezDirectoryWatcher::Watch::Subdirectories).Succeeded())
+      {
+        m_pExistenceWatcher = pWatcher;
+      }
+      else
+      {
+        // without change notifications the cache could return outdated results
+        ezLog::Warning("Could not watch data directory '{0}'. File existence will not be cached.", m_sRedirectedDataDirPath.GetView());
+        EZ_DEFAULT_DELETE(pWatcher);
+      }
+    }
+#endif
+
     ReloadExternalConfigs();
 
     return EZ_SUCCESS;
@@ -271,6 +366,12 @@ namespace ezDataDirectory
     if (ezConversionUtils::IsStringUuid(sFileToOpen))
       return nullptr;
 
+    ezUInt32 uiGeneration = 0;
+    if (GetCachedExistence(sFileToOpen, uiGeneration) == CachedExistence::Missing)
+      return nullptr;
+
+    ezSharedPtr<PrefetchedFile> pPrefetched = TakePrefetchedFile(sFileToOpen);
+
     FolderReader* pReader = nullptr;
     {
       EZ_LOCK(m_ReaderWriterMutex);
@@ -288,14 +389,34 @@ namespace ezDataDirectory
       pReader->m_bIsInUse = true;
     }
 
+    if (pPrefetched != nullptr)
+    {
+      pReader->m_PrefetchedData.Swap(pPrefetched->m_Data);
+      pReader->m_bUsePrefetchedData = true;
+    }
+
     // if opening the file fails, the reader's m_bIsInUse needs to be reset.
     if (pReader->Open(sFileToOpen, this, FileShareMode) == EZ_FAILURE)
     {
+      if (m_pExistenceWatcher != nullptr)
+      {
+        // opening can also fail for files that exist, e.g. when they are locked
+        ezStringBuilder sPath = GetRedirectedDataDirectoryPath();
+        sPath.AppendPath(sFileToOpen);
+
+        if (!ezOSFile::ExistsFile(sPath))
+        {
+          SetCachedExistence(sFileToOpen, false, uiGeneration);
+        }
+      }
+
       EZ_LOCK(m_ReaderWriterMutex);
       pReader->m_bIsInUse = false;
       return nullptr;
     }
 
+    SetCachedExistence(sFileToOpen, true, uiGeneration);
+
     // if it succeeds, we return the reader
     return pReader;
   }
@@ -331,6 +452,10 @@ namespace ezDataDirectory
 
   ezDataDirectoryWriter* FolderType::OpenFileToWrite(ezStringView sFile, ezFileShareMode::Enum FileShareMode)
   {
+    // don't wait for the directory watcher to report the new file
+    InvalidateCachedExistence(sFile);
+    DiscardPrefetchedFile(sFile);
+
     FolderWriter* pWriter = nullptr;
 
     {
@@ -359,6 +484,194 @@ namespace ezDataDirectory
     // if it succeeds, we return the reader
     return pWriter;
   }
+
+  FolderType::CachedExistence FolderType::GetCachedExistence(ezStringView sFile, ezUInt32& out_uiGeneration)
+  {
+    out_uiGeneration = 0;
+
+    if (m_pExistenceWatcher == nullptr)
+      return CachedExistence::Unknown;
+
+    ezStringBuilder sKey;
+    MakeExistenceCacheKey(sFile, sKey);
+
+    EZ_LOCK(m_ExistenceCacheMutex);
+
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER)
+    m_pExistenceWatcher->EnumerateChanges([this](ezStringView sPath, ezDirectoryWatcherAction action, ezDirectoryWatcherType type)
+      {
+        if (action == ezDirectoryWatcherAction::Modified)
+          return;
+
+        ++m_uiExistenceCacheGeneration;
+
+        ezStringBuilder sRelPath = sPath;
+        if (type == ezDirectoryWatcherType::Directory || sRelPath.MakeRelativeTo(m_sRedirectedDataDirPath).Failed())
+        {
+          // a renamed or deleted directory affects all files inside it
+          m_ExistenceCache.Clear();
+          return;
+        }
+
+        ezStringBuilder sChangedKey;
+        MakeExistenceCacheKey(sRelPath, sChangedKey);
+        m_ExistenceCache.Remove(sChangedKey); });
+#endif
+
+    out_uiGeneration = m_uiExistenceCacheGeneration;
+
+    bool bExists = false;
+    if (!m_ExistenceCache.TryGetValue(sKey, bExists))
+      return CachedExistence::Unknown;
+
+    return bExists ? CachedExistence::Exists : CachedExistence::Missing;
+  }
+
+  void FolderType::SetCachedExistence(ezStringView sFile, bool bExists, ezUInt32 uiGeneration)
+  {
+    if (m_pExistenceWatcher == nullptr)
+      return;
+
+    ezStringBuilder sKey;
+    MakeExistenceCacheKey(sFile, sKey);
+
+    EZ_LOCK(m_ExistenceCacheMutex);
+
+    // something changed since the file was looked up, the result might not be valid anymore
+    if (uiGeneration != m_uiExistenceCacheGeneration)
+      return;
+
+    if (m_ExistenceCache.GetCount() >= s_uiMaxExistenceCacheEntries)
+      m_ExistenceCache.Clear();
+
+    m_ExistenceCache.Insert(sKey, bExists);
+  }
+
+  bool FolderType::PrefetchFile(ezStringView sFile, bool bOneSpecificDataDir)
+  {
+    ezStringBuilder sRedirectedAsset;
+    ResolveAssetRedirection(sFile, sRedirectedAsset);
+
+    if (ezConversionUtils::IsStringUuid(sRedirectedAsset))
+      return false;
+
+    ezStringBuilder sKey;
+    MakeExistenceCacheKey(sRedirectedAsset, sKey);
+
+    {
+      EZ_LOCK(m_PrefetchMutex);
+      if (m_PrefetchedFiles.Contains(sKey))
+        return true;
+    }
+
+    // data directories with a lower priority may contain the file instead
+    if (!ExistsFile(sFile, bOneSpecificDataDir))
+      return false;
+
+    ezSharedPtr<PrefetchedFile> pFile = EZ_DEFAULT_NEW(PrefetchedFile);
+    pFile->m_RequestTime = ezTime::Now();
+
+    {
+      EZ_LOCK(m_PrefetchMutex);
+
+      // drop all files that were prefetched but never opened
+      for (auto it = m_PrefetchedFiles.GetIterator(); it.IsValid();)
+      {
+        if (it.Value()->m_bFinished && pFile->m_RequestTime - it.Value()->m_RequestTime > s_PrefetchTimeout)
+          it = m_PrefetchedFiles.Remove(it);
+        else
+          ++it;
+      }
+
+      if (m_PrefetchedFiles.GetCount() >= s_uiMaxPrefetchedFiles || m_PrefetchedFiles.Contains(sKey))
+        return true;
+
+      m_PrefetchedFiles.Insert(sKey, pFile);
+    }
+
+    ezStringBuilder sPath = GetRedirectedDataDirectoryPath();
+    sPath.AppendPath(sRedirectedAsset);
+
+    // the reference is released by OnPrefetchFinished(), which therefore doesn't need this data directory to still exist
+    pFile->AddRef();
+    ezAsyncFileIO::ReadFile(sPath, ezMakeDelegate(&FolderType::OnPrefetchFinished), pFile.Borrow());
+
+    return true;
+  }
+
+  void FolderType::OnPrefetchFinished(ezAsyncFileReadResult& ref_result)
+  {
+    PrefetchedFile* pFile = static_cast<PrefetchedFile*>(ref_result.m_pUserData);
+    pFile->m_Result = ref_result.m_Result;
+    pFile->m_Data.Swap(ref_result.m_Data);
+    pFile->m_bFinished = true;
+
+    if (pFile->ReleaseRef() == 0)
+    {
+      EZ_DEFAULT_DELETE(pFile);
+    }
+  }
+
+  ezSharedPtr<FolderType::PrefetchedFile> FolderType::TakePrefetchedFile(ezStringView sFile)
+  {
+    {
+      EZ_LOCK(m_PrefetchMutex);
+      if (m_PrefetchedFiles.IsEmpty())
+        return nullptr;
+    }
+
+    ezStringBuilder sKey;
+    MakeExistenceCacheKey(sFile, sKey);
+
+    ezSharedPtr<PrefetchedFile> pFile;
+    {
+      EZ_LOCK(m_PrefetchMutex);
+      if (!m_PrefetchedFiles.Remove(sKey, &pFile))
+        return nullptr;
+    }
+
+    if (!pFile->m_bFinished)
+    {
+      EZ_PROFILE_SCOPE("WaitForPrefetchedFile");
+      ezTaskSystem::WaitForCondition([&]()
+        { return static_cast<bool>(pFile->m_bFinished); });
+    }
+
+    if (pFile->m_Result.Failed() || ezTime::Now() - pFile->m_RequestTime > s_PrefetchTimeout)
+      return nullptr;
+
+    return pFile;
+  }
+
+  void FolderType::DiscardPrefetchedFile(ezStringView sFile)
+  {
+    EZ_LOCK(m_PrefetchMutex);
+
+    if (m_PrefetchedFiles.IsEmpty())
+      return;
+
+    ezStringBuilder sRedirectedAsset;
+    ResolveAssetRedirection(sFile, sRedirectedAsset);
+
+    ezStringBuilder sKey;
+    MakeExistenceCacheKey(sRedirectedAsset, sKey);
+
+    m_PrefetchedFiles.Remove(sKey);
+  }
+
+  void FolderType::InvalidateCachedExistence(ezStringView sFile)
+  {
+    if (m_pExistenceWatcher == nullptr)
+      return;
+
+    ezStringBuilder sKey;
+    MakeExistenceCacheKey(sFile, sKey);
+
+    EZ_LOCK(m_ExistenceCacheMutex);
+
+    ++m_uiExistenceCacheGeneration;
+    m_ExistenceCache.Remove(sKey);
+  }
 } // namespace ezDataDirectory
 
 
@@ -14,6 +14,17 @@ ezResult ezFileReader::Open(ezStringView sFile, ezUInt32 uiCacheSize /*= 1024 *
   if (!m_pDataDirReader)
     return EZ_FAILURE;
 
+  m_MappedData = m_pDataDirReader->GetMappedData();
+
+  if (!m_MappedData.IsEmpty())
+  {
+    // the entire file is already in memory, there is no need to copy it into a cache first
+    m_uiCacheReadPosition = 0;
+    m_uiBytesCached = m_MappedData.GetCount();
+    m_bEOF = false;
+    return EZ_SUCCESS;
+  }
+
   m_Cache.SetCountUninitialized(uiCacheSize);
 
   m_uiCacheReadPosition = 0;
@@ -29,6 +40,7 @@ void ezFileReader::Close()
     m_pDataDirReader->Close();
 
   m_pDataDirReader = nullptr;
+  m_MappedData.Clear();
   m_bEOF = true;
 }
 
@@ -38,6 +50,15 @@ ezUInt64 ezFileReader::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
   if (m_bEOF)
     return 0;
 
+  if (!m_MappedData.IsEmpty())
+  {
+    const ezUInt64 uiBytesToCopy = ezMath::Min(uiBytesToRead, m_uiBytesCached - m_uiCacheReadPosition);
+    ezMemoryUtils::Copy(static_cast<ezUInt8*>(pReadBuffer), m_MappedData.GetPtr() + m_uiCacheReadPosition, static_cast<size_t>(uiBytesToCopy));
+    m_uiCacheReadPosition += uiBytesToCopy;
+    m_bEOF = m_uiCacheReadPosition >= m_uiBytesCached;
+    return uiBytesToCopy;
+  }
+
   ezUInt64 uiBufferPosition = 0; // how much was read, yet
   ezUInt8* pBuffer = (ezUInt8*)pReadBuffer;
 
@@ -111,6 +132,36 @@ ezUInt64 ezFileReader::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
   return uiBufferPosition;
 }
 
+ezUInt64 ezFileReader::SkipBytes(ezUInt64 uiBytesToSkip)
+{
+  EZ_ASSERT_DEV(m_pDataDirReader != nullptr, "The file has not been opened (successfully).");
+
+  if (m_bEOF)
+    return 0;
+
+  const ezUInt64 uiBytesToAdvance = ezMath::Min(uiBytesToSkip, m_uiBytesCached - m_uiCacheReadPosition);
+  m_uiCacheReadPosition += uiBytesToAdvance;
+
+  if (!m_MappedData.IsEmpty())
+  {
+    m_bEOF = m_uiCacheReadPosition >= m_uiBytesCached;
+    return uiBytesToAdvance;
+  }
+
+  if (uiBytesToAdvance == uiBytesToSkip)
+    return uiBytesToAdvance;
+
+  // the cache is used up, let the data directory skip the rest, which may not need to read it at all
+  const ezUInt64 uiBytesToSkipInFile = uiBytesToSkip - uiBytesToAdvance;
+  const ezUInt64 uiBytesSkippedInFile = m_pDataDirReader->SkipBytes(uiBytesToSkipInFile);
+
+  m_uiBytesCached = 0;
+  m_uiCacheReadPosition = 0;
+  m_bEOF = uiBytesSkippedInFile < uiBytesToSkipInFile;
+
+  return uiBytesToAdvance + uiBytesSkippedInFile;
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_IO_FileSystem_Implementation_FileReader);
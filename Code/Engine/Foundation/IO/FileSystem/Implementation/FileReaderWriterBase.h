@@ -36,6 +36,12 @@ public:
   /// \brief Returns the current total size of the file.
   ezUInt64 GetFileSize() const { return m_pDataDirReader->GetFileSize(); }
 
+  /// \brief Returns the entire file content without copying it, if the data directory keeps it in memory, e.g. for uncompressed archive entries.
+  ///
+  /// The memory stays valid until the file is closed. Returns an empty array, if the file can only be accessed by reading from the stream.
+  /// \see ezDataDirectoryReader::GetMappedData()
+  ezArrayPtr<const ezUInt8> GetMappedData() const { return m_pDataDirReader->GetMappedData(); }
+
 protected:
   ezDataDirectoryReader* GetFileReader(ezStringView sFile, ezFileShareMode::Enum FileShareMode, bool bAllowFileEvents)
   {
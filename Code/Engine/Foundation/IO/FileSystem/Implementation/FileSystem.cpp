@@ -6,6 +6,7 @@
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Strings/Implementation/StringIterator.h>
 #include <Foundation/Strings/StringView.h>
+#include <Foundation/Threading/ThreadUtils.h>
 
 // clang-format off
 EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, FileSystem)
@@ -27,6 +28,74 @@ ezFileSystem::FileSystemData* ezFileSystem::s_pData = nullptr;
 ezString ezFileSystem::s_sSdkRootDir;
 ezMap<ezString, ezString> ezFileSystem::s_SpecialDirectories;
 
+struct ezFileSystem::ReadScope
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ReadScope);
+
+  ReadScope()
+  {
+    // the increment must be visible before the pointer is read, otherwise a writer could delete the snapshot in between
+    s_pData->m_iActiveReaders.fetch_add(1);
+    m_pDataDirs = s_pData->m_pDataDirs.load();
+  }
+
+  ~ReadScope()
+  {
+    if (s_pData->m_iActiveReaders.fetch_sub(1) == 1 && s_pData->m_bHasRetiredDataDirs.load(std::memory_order_relaxed))
+    {
+      // the last reader cleans up snapshots and data directories that could not be deleted when they were replaced
+      // if a writer is active right now, it will do that itself
+      if (s_pData->m_FsMutex.TryLock().Succeeded())
+      {
+        DeleteRetiredDataDirs();
+        s_pData->m_FsMutex.Unlock();
+      }
+    }
+  }
+
+  const DataDirSnapshot& GetDataDirs() const { return *m_pDataDirs; }
+
+private:
+  const DataDirSnapshot* m_pDataDirs = nullptr;
+};
+
+void ezFileSystem::PublishDataDirs(DataDirSnapshot* pNewDataDirs, ezArrayPtr<ezDataDirectoryType* const> removedDataDirs)
+{
+  DataDirSnapshot* pOldDataDirs = s_pData->m_pDataDirs.exchange(pNewDataDirs);
+
+  if (pOldDataDirs != nullptr)
+  {
+    s_pData->m_RetiredDataDirs.PushBack(pOldDataDirs);
+    s_pData->m_bHasRetiredDataDirs = true;
+  }
+
+  // other threads may still access the removed data directories through the previous snapshot
+  s_pData->m_RetiredDataDirectories.PushBackRange(removedDataDirs);
+
+  DeleteRetiredDataDirs();
+}
+
+void ezFileSystem::DeleteRetiredDataDirs()
+{
+  // all retired snapshots were replaced before this check, so readers that start afterwards can only see the current one
+  if (s_pData->m_RetiredDataDirs.IsEmpty() || s_pData->m_iActiveReaders.load() != 0)
+    return;
+
+  for (DataDirSnapshot* pDataDirs : s_pData->m_RetiredDataDirs)
+  {
+    EZ_DEFAULT_DELETE(pDataDirs);
+  }
+
+  s_pData->m_RetiredDataDirs.Clear();
+  s_pData->m_bHasRetiredDataDirs = false;
+
+  for (ezDataDirectoryType* pDataDir : s_pData->m_RetiredDataDirectories)
+  {
+    pDataDir->RemoveDataDirectory();
+  }
+
+  s_pData->m_RetiredDataDirectories.Clear();
+}
 
 void ezFileSystem::RegisterDataDirectoryFactory(ezDataDirFactory factory, float fPriority /*= 0*/)
 {
@@ -108,13 +177,16 @@ ezResult ezFileSystem::AddDataDirectory(ezStringView sDataDirectory, ezStringVie
 
       if (pDataDir != nullptr)
       {
-        DataDirectory dd;
+        DataDirSnapshot* pNewDataDirs = EZ_DEFAULT_NEW(DataDirSnapshot);
+        pNewDataDirs->m_DataDirectories = s_pData->m_pDataDirs.load()->m_DataDirectories;
+
+        DataDirectory& dd = pNewDataDirs->m_DataDirectories.ExpandAndGetRef();
         dd.m_Usage = usage;
         dd.m_pDataDirectory = pDataDir;
         dd.m_sRootName = sCleanRootName;
         dd.m_sGroup = sGroup;
 
-        s_pData->m_DataDirectories.PushBack(dd);
+        PublishDataDirs(pNewDataDirs);
 
         {
           // Broadcast that a data directory was added
@@ -152,9 +224,11 @@ bool ezFileSystem::RemoveDataDirectory(ezStringView sRootName)
 
   EZ_LOCK(s_pData->m_FsMutex);
 
-  for (ezUInt32 i = 0; i < s_pData->m_DataDirectories.GetCount();)
+  const DataDirSnapshot* pDataDirs = s_pData->m_pDataDirs.load();
+
+  for (ezUInt32 i = 0; i < pDataDirs->m_DataDirectories.GetCount(); ++i)
   {
-    const auto& directory = s_pData->m_DataDirectories[i];
+    const auto& directory = pDataDirs->m_DataDirectories[i];
 
     if (directory.m_sRootName == sCleanRootName)
     {
@@ -168,13 +242,15 @@ bool ezFileSystem::RemoveDataDirectory(ezStringView sRootName)
         s_pData->m_Event.Broadcast(fe);
       }
 
-      directory.m_pDataDirectory->RemoveDataDirectory();
-      s_pData->m_DataDirectories.RemoveAtAndCopy(i);
+      ezDataDirectoryType* pRemovedDataDir = directory.m_pDataDirectory;
 
+      DataDirSnapshot* pNewDataDirs = EZ_DEFAULT_NEW(DataDirSnapshot);
+      pNewDataDirs->m_DataDirectories = pDataDirs->m_DataDirectories;
+      pNewDataDirs->m_DataDirectories.RemoveAtAndCopy(i);
+
+      PublishDataDirs(pNewDataDirs, ezMakeArrayPtr(&pRemovedDataDir, 1));
       return true;
     }
-    else
-      ++i;
   }
 
   return false;
@@ -187,32 +263,42 @@ ezUInt32 ezFileSystem::RemoveDataDirectoryGroup(ezStringView sGroup)
 
   EZ_LOCK(s_pData->m_FsMutex);
 
-  ezUInt32 uiRemoved = 0;
+  const DataDirSnapshot* pDataDirs = s_pData->m_pDataDirs.load();
+
+  DataDirSnapshot* pNewDataDirs = EZ_DEFAULT_NEW(DataDirSnapshot);
+  ezHybridArray<ezDataDirectoryType*, 16> removedDataDirs;
 
-  for (ezUInt32 i = 0; i < s_pData->m_DataDirectories.GetCount();)
+  for (const auto& directory : pDataDirs->m_DataDirectories)
   {
-    if (s_pData->m_DataDirectories[i].m_sGroup == sGroup)
+    if (directory.m_sGroup == sGroup)
     {
       {
         // Broadcast that a data directory is about to be removed
         FileEvent fe;
         fe.m_EventType = FileEventType::RemoveDataDirectory;
-        fe.m_sFileOrDirectory = s_pData->m_DataDirectories[i].m_pDataDirectory->GetDataDirectoryPath();
-        fe.m_sOther = s_pData->m_DataDirectories[i].m_sRootName;
-        fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+        fe.m_sFileOrDirectory = directory.m_pDataDirectory->GetDataDirectoryPath();
+        fe.m_sOther = directory.m_sRootName;
+        fe.m_pDataDir = directory.m_pDataDirectory;
         s_pData->m_Event.Broadcast(fe);
       }
 
-      ++uiRemoved;
-
-      s_pData->m_DataDirectories[i].m_pDataDirectory->RemoveDataDirectory();
-      s_pData->m_DataDirectories.RemoveAtAndCopy(i);
+      removedDataDirs.PushBack(directory.m_pDataDirectory);
     }
     else
-      ++i;
+    {
+      pNewDataDirs->m_DataDirectories.PushBack(directory);
+    }
   }
 
-  return uiRemoved;
+  if (removedDataDirs.IsEmpty())
+  {
+    EZ_DEFAULT_DELETE(pNewDataDirs);
+    return 0;
+  }
+
+  PublishDataDirs(pNewDataDirs, removedDataDirs);
+
+  return removedDataDirs.GetCount();
 }
 
 void ezFileSystem::ClearAllDataDirectories()
@@ -221,22 +307,29 @@ void ezFileSystem::ClearAllDataDirectories()
 
   EZ_LOCK(s_pData->m_FsMutex);
 
-  for (ezInt32 i = s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  const DataDirSnapshot* pDataDirs = s_pData->m_pDataDirs.load();
+
+  if (pDataDirs->m_DataDirectories.IsEmpty())
+    return;
+
+  for (ezInt32 i = pDataDirs->m_DataDirectories.GetCount() - 1; i >= 0; --i)
   {
-    {
-      // Broadcast that a data directory is about to be removed
-      FileEvent fe;
-      fe.m_EventType = FileEventType::RemoveDataDirectory;
-      fe.m_sFileOrDirectory = s_pData->m_DataDirectories[i].m_pDataDirectory->GetDataDirectoryPath();
-      fe.m_sOther = s_pData->m_DataDirectories[i].m_sRootName;
-      fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
-      s_pData->m_Event.Broadcast(fe);
-    }
+    // Broadcast that a data directory is about to be removed
+    FileEvent fe;
+    fe.m_EventType = FileEventType::RemoveDataDirectory;
+    fe.m_sFileOrDirectory = pDataDirs->m_DataDirectories[i].m_pDataDirectory->GetDataDirectoryPath();
+    fe.m_sOther = pDataDirs->m_DataDirectories[i].m_sRootName;
+    fe.m_pDataDir = pDataDirs->m_DataDirectories[i].m_pDataDirectory;
+    s_pData->m_Event.Broadcast(fe);
+  }
 
-    s_pData->m_DataDirectories[i].m_pDataDirectory->RemoveDataDirectory();
+  ezHybridArray<ezDataDirectoryType*, 16> removedDataDirs;
+  for (ezInt32 i = pDataDirs->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  {
+    removedDataDirs.PushBack(pDataDirs->m_DataDirectories[i].m_pDataDirectory);
   }
 
-  s_pData->m_DataDirectories.Clear();
+  PublishDataDirs(EZ_DEFAULT_NEW(DataDirSnapshot), removedDataDirs);
 }
 
 ezDataDirectoryType* ezFileSystem::FindDataDirectoryWithRoot(ezStringView sRootName)
@@ -244,9 +337,9 @@ ezDataDirectoryType* ezFileSystem::FindDataDirectoryWithRoot(ezStringView sRootN
   if (sRootName.IsEmpty())
     return nullptr;
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
 
-  for (const auto& dd : s_pData->m_DataDirectories)
+  for (const auto& dd : scope.GetDataDirs().m_DataDirectories)
   {
     if (dd.m_sRootName.IsEqual_NoCase(sRootName))
     {
@@ -261,26 +354,26 @@ ezUInt32 ezFileSystem::GetNumDataDirectories()
 {
   EZ_ASSERT_DEV(s_pData != nullptr, "FileSystem is not initialized.");
 
-  return s_pData->m_DataDirectories.GetCount();
+  ReadScope scope;
+  return scope.GetDataDirs().m_DataDirectories.GetCount();
 }
 
 ezDataDirectoryType* ezFileSystem::GetDataDirectory(ezUInt32 uiDataDirIndex)
 {
   EZ_ASSERT_DEV(s_pData != nullptr, "FileSystem is not initialized.");
 
-  return s_pData->m_DataDirectories[uiDataDirIndex].m_pDataDirectory;
+  ReadScope scope;
+  return scope.GetDataDirs().m_DataDirectories[uiDataDirIndex].m_pDataDirectory;
 }
 
-ezStringView ezFileSystem::GetDataDirRelativePath(ezStringView sPath, ezUInt32 uiDataDir)
+ezStringView ezFileSystem::GetDataDirRelativePath(ezStringView sPath, const DataDirectory& dataDir)
 {
-  EZ_LOCK(s_pData->m_FsMutex);
-
   // if an absolute path is given, this will check whether the absolute path would fall into this data directory
   // if yes, the prefix path is removed and then only the relative path is given to the data directory type
   // otherwise the data directory would prepend its own path and thus create an invalid path to work with
 
   // first check the redirected directory
-  const ezString128& sRedDirPath = s_pData->m_DataDirectories[uiDataDir].m_pDataDirectory->GetRedirectedDataDirectoryPath();
+  const ezString128& sRedDirPath = dataDir.m_pDataDirectory->GetRedirectedDataDirectoryPath();
 
   if (!sRedDirPath.IsEmpty() && sPath.StartsWith_NoCase(sRedDirPath))
   {
@@ -296,7 +389,7 @@ ezStringView ezFileSystem::GetDataDirRelativePath(ezStringView sPath, ezUInt32 u
   }
 
   // then check the original mount path
-  const ezString128& sDirPath = s_pData->m_DataDirectories[uiDataDir].m_pDataDirectory->GetDataDirectoryPath();
+  const ezString128& sDirPath = dataDir.m_pDataDirectory->GetDataDirectoryPath();
 
   // If the data dir is empty we return the paths as is or the code below would remove the '/' in front of an
   // absolute path.
@@ -317,14 +410,12 @@ ezStringView ezFileSystem::GetDataDirRelativePath(ezStringView sPath, ezUInt32 u
 }
 
 
-ezFileSystem::DataDirectory* ezFileSystem::GetDataDirForRoot(const ezString& sRoot)
+const ezFileSystem::DataDirectory* ezFileSystem::GetDataDirForRoot(const DataDirSnapshot& dataDirs, const ezString& sRoot)
 {
-  EZ_LOCK(s_pData->m_FsMutex);
-
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  for (ezInt32 i = (ezInt32)dataDirs.m_DataDirectories.GetCount() - 1; i >= 0; --i)
   {
-    if (s_pData->m_DataDirectories[i].m_sRootName == sRoot)
-      return &s_pData->m_DataDirectories[i];
+    if (dataDirs.m_DataDirectories[i].m_sRootName == sRoot)
+      return &dataDirs.m_DataDirectories[i];
   }
 
   return nullptr;
@@ -349,18 +440,19 @@ void ezFileSystem::DeleteFile(ezStringView sFile)
   if (sRootName.IsEmpty())
     return;
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  for (ezInt32 i = (ezInt32)dataDirs.GetCount() - 1; i >= 0; --i)
   {
     // do not delete data from directories that are mounted as read only
-    if (s_pData->m_DataDirectories[i].m_Usage != AllowWrites)
+    if (dataDirs[i].m_Usage != AllowWrites)
       continue;
 
-    if (s_pData->m_DataDirectories[i].m_sRootName != sRootName)
+    if (dataDirs[i].m_sRootName != sRootName)
       continue;
 
-    ezStringView sRelPath = GetDataDirRelativePath(sFile, i);
+    ezStringView sRelPath = GetDataDirRelativePath(sFile, dataDirs[i]);
 
     {
       // Broadcast that a file is about to be deleted
@@ -368,12 +460,12 @@ void ezFileSystem::DeleteFile(ezStringView sFile)
       FileEvent fe;
       fe.m_EventType = FileEventType::DeleteFile;
       fe.m_sFileOrDirectory = sRelPath;
-      fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dataDirs[i].m_pDataDirectory;
       fe.m_sOther = sRootName;
       s_pData->m_Event.Broadcast(fe);
     }
 
-    s_pData->m_DataDirectories[i].m_pDataDirectory->DeleteFile(sRelPath);
+    dataDirs[i].m_pDataDirectory->DeleteFile(sRelPath);
   }
 }
 
@@ -386,16 +478,17 @@ bool ezFileSystem::ExistsFile(ezStringView sFile)
 
   const bool bOneSpecificDataDir = !sRootName.IsEmpty();
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  for (ezInt32 i = (ezInt32)dataDirs.GetCount() - 1; i >= 0; --i)
   {
-    if (!sRootName.IsEmpty() && s_pData->m_DataDirectories[i].m_sRootName != sRootName)
+    if (!sRootName.IsEmpty() && dataDirs[i].m_sRootName != sRootName)
       continue;
 
-    ezStringView sRelPath = GetDataDirRelativePath(sFile, i);
+    ezStringView sRelPath = GetDataDirRelativePath(sFile, dataDirs[i]);
 
-    if (s_pData->m_DataDirectories[i].m_pDataDirectory->ExistsFile(sRelPath, bOneSpecificDataDir))
+    if (dataDirs[i].m_pDataDirectory->ExistsFile(sRelPath, bOneSpecificDataDir))
       return true;
   }
 
@@ -407,27 +500,61 @@ ezResult ezFileSystem::GetFileStats(ezStringView sFileOrFolder, ezFileStats& out
 {
   EZ_ASSERT_DEV(s_pData != nullptr, "FileSystem is not initialized.");
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
   ezString sRootName;
   sFileOrFolder = ExtractRootName(sFileOrFolder, sRootName);
 
   const bool bOneSpecificDataDir = !sRootName.IsEmpty();
 
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  for (ezInt32 i = (ezInt32)dataDirs.GetCount() - 1; i >= 0; --i)
   {
-    if (!sRootName.IsEmpty() && s_pData->m_DataDirectories[i].m_sRootName != sRootName)
+    if (!sRootName.IsEmpty() && dataDirs[i].m_sRootName != sRootName)
       continue;
 
-    ezStringView sRelPath = GetDataDirRelativePath(sFileOrFolder, i);
+    ezStringView sRelPath = GetDataDirRelativePath(sFileOrFolder, dataDirs[i]);
 
-    if (s_pData->m_DataDirectories[i].m_pDataDirectory->GetFileStats(sRelPath, bOneSpecificDataDir, out_stats).Succeeded())
+    if (dataDirs[i].m_pDataDirectory->GetFileStats(sRelPath, bOneSpecificDataDir, out_stats).Succeeded())
       return EZ_SUCCESS;
   }
 
   return EZ_FAILURE;
 }
 
+bool ezFileSystem::PrefetchFile(ezStringView sFile)
+{
+  EZ_ASSERT_DEV(s_pData != nullptr, "FileSystem is not initialized.");
+
+  if (sFile.IsEmpty())
+    return false;
+
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
+
+  ezString sRootName;
+  sFile = ExtractRootName(sFile, sRootName);
+
+  // same lookup as in GetFileReader(), so that the file is prefetched from the data directory that will open it
+  ezStringBuilder sPath = sFile;
+  sPath.MakeCleanPath();
+
+  const bool bOneSpecificDataDir = !sRootName.IsEmpty();
+
+  for (ezInt32 i = (ezInt32)dataDirs.GetCount() - 1; i >= 0; --i)
+  {
+    if (bOneSpecificDataDir && dataDirs[i].m_sRootName != sRootName)
+      continue;
+
+    ezStringView sRelPath = GetDataDirRelativePath(sPath, dataDirs[i]);
+
+    if (dataDirs[i].m_pDataDirectory->PrefetchFile(sRelPath, bOneSpecificDataDir))
+      return true;
+  }
+
+  return false;
+}
+
 ezStringView ezFileSystem::ExtractRootName(ezStringView sPath, ezString& rootName)
 {
   rootName.Clear();
@@ -462,7 +589,8 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(ezStringView sFile, ezFileSha
   if (sFile.IsEmpty())
     return nullptr;
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
   ezString sRootName;
   sFile = ExtractRootName(sFile, sRootName);
@@ -474,13 +602,13 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(ezStringView sFile, ezFileSha
   const bool bOneSpecificDataDir = !sRootName.IsEmpty();
 
   // the last added data directory has the highest priority
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  for (ezInt32 i = (ezInt32)dataDirs.GetCount() - 1; i >= 0; --i)
   {
     // if a root is used, ignore all directories that do not have the same root name
-    if (bOneSpecificDataDir && s_pData->m_DataDirectories[i].m_sRootName != sRootName)
+    if (bOneSpecificDataDir && dataDirs[i].m_sRootName != sRootName)
       continue;
 
-    ezStringView sRelPath = GetDataDirRelativePath(sPath, i);
+    ezStringView sRelPath = GetDataDirRelativePath(sPath, dataDirs[i]);
 
     if (bAllowFileEvents)
     {
@@ -490,12 +618,12 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(ezStringView sFile, ezFileSha
       fe.m_EventType = FileEventType::OpenFileAttempt;
       fe.m_sFileOrDirectory = sRelPath;
       fe.m_sOther = sRootName;
-      fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dataDirs[i].m_pDataDirectory;
       s_pData->m_Event.Broadcast(fe);
     }
 
     // Let the data directory try to open the file.
-    ezDataDirectoryReader* pReader = s_pData->m_DataDirectories[i].m_pDataDirectory->OpenFileToRead(sRelPath, FileShareMode, bOneSpecificDataDir);
+    ezDataDirectoryReader* pReader = dataDirs[i].m_pDataDirectory->OpenFileToRead(sRelPath, FileShareMode, bOneSpecificDataDir);
 
     if (bAllowFileEvents && pReader != nullptr)
     {
@@ -504,7 +632,7 @@ ezDataDirectoryReader* ezFileSystem::GetFileReader(ezStringView sFile, ezFileSha
       fe.m_EventType = FileEventType::OpenFileSucceeded;
       fe.m_sFileOrDirectory = sRelPath;
       fe.m_sOther = sRootName;
-      fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dataDirs[i].m_pDataDirectory;
       s_pData->m_Event.Broadcast(fe);
 
       return pReader;
@@ -530,7 +658,8 @@ ezDataDirectoryWriter* ezFileSystem::GetFileWriter(ezStringView sFile, ezFileSha
   if (sFile.IsEmpty())
     return nullptr;
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
   ezString sRootName;
 
@@ -548,16 +677,16 @@ ezDataDirectoryWriter* ezFileSystem::GetFileWriter(ezStringView sFile, ezFileSha
   sPath.MakeCleanPath();
 
   // the last added data directory has the highest priority
-  for (ezInt32 i = (ezInt32)s_pData->m_DataDirectories.GetCount() - 1; i >= 0; --i)
+  for (ezInt32 i = (ezInt32)dataDirs.GetCount() - 1; i >= 0; --i)
   {
-    if (s_pData->m_DataDirectories[i].m_Usage != AllowWrites)
+    if (dataDirs[i].m_Usage != AllowWrites)
       continue;
 
     // ignore all directories that have not the category that is currently requested
-    if (s_pData->m_DataDirectories[i].m_sRootName != sRootName)
+    if (dataDirs[i].m_sRootName != sRootName)
       continue;
 
-    ezStringView sRelPath = GetDataDirRelativePath(sPath, i);
+    ezStringView sRelPath = GetDataDirRelativePath(sPath, dataDirs[i]);
 
     if (bAllowFileEvents)
     {
@@ -567,11 +696,11 @@ ezDataDirectoryWriter* ezFileSystem::GetFileWriter(ezStringView sFile, ezFileSha
       fe.m_EventType = FileEventType::CreateFileAttempt;
       fe.m_sFileOrDirectory = sRelPath;
       fe.m_sOther = sRootName;
-      fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dataDirs[i].m_pDataDirectory;
       s_pData->m_Event.Broadcast(fe);
     }
 
-    ezDataDirectoryWriter* pWriter = s_pData->m_DataDirectories[i].m_pDataDirectory->OpenFileToWrite(sRelPath, FileShareMode);
+    ezDataDirectoryWriter* pWriter = dataDirs[i].m_pDataDirectory->OpenFileToWrite(sRelPath, FileShareMode);
 
     if (bAllowFileEvents && pWriter != nullptr)
     {
@@ -580,7 +709,7 @@ ezDataDirectoryWriter* ezFileSystem::GetFileWriter(ezStringView sFile, ezFileSha
       fe.m_EventType = FileEventType::CreateFileSucceeded;
       fe.m_sFileOrDirectory = sRelPath;
       fe.m_sOther = sRootName;
-      fe.m_pDataDir = s_pData->m_DataDirectories[i].m_pDataDirectory;
+      fe.m_pDataDir = dataDirs[i].m_pDataDirectory;
       s_pData->m_Event.Broadcast(fe);
 
       return pWriter;
@@ -603,7 +732,8 @@ ezResult ezFileSystem::ResolvePath(ezStringView sPath, ezStringBuilder* out_pAbs
 {
   EZ_ASSERT_DEV(s_pData != nullptr, "FileSystem is not initialized.");
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
   ezStringBuilder absPath, relPath;
 
@@ -613,7 +743,7 @@ ezResult ezFileSystem::ResolvePath(ezStringView sPath, ezStringBuilder* out_pAbs
     ezString sRootName;
     ExtractRootName(sPath, sRootName);
 
-    DataDirectory* pDataDir = GetDataDirForRoot(sRootName);
+    const DataDirectory* pDataDir = GetDataDirForRoot(scope.GetDataDirs(), sRootName);
 
     if (pDataDir == nullptr)
       return EZ_FAILURE;
@@ -631,9 +761,9 @@ ezResult ezFileSystem::ResolvePath(ezStringView sPath, ezStringBuilder* out_pAbs
     absPath = sPath;
     absPath.MakeCleanPath();
 
-    for (ezUInt32 dd = s_pData->m_DataDirectories.GetCount(); dd > 0; --dd)
+    for (ezUInt32 dd = dataDirs.GetCount(); dd > 0; --dd)
     {
-      auto& dir = s_pData->m_DataDirectories[dd - 1];
+      auto& dir = dataDirs[dd - 1];
 
       if (ezPathUtils::IsSubPath(dir.m_pDataDirectory->GetRedirectedDataDirectoryPath(), absPath))
       {
@@ -762,9 +892,10 @@ ezResult ezFileSystem::FindFolderWithSubPath(ezStringBuilder& out_sResult, ezStr
 
 bool ezFileSystem::ResolveAssetRedirection(ezStringView sPathOrAssetGuid, ezStringBuilder& out_sRedirection)
 {
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
-  for (auto& dd : s_pData->m_DataDirectories)
+  for (auto& dd : dataDirs)
   {
     if (dd.m_pDataDirectory->ResolveAssetRedirection(sPathOrAssetGuid, out_sRedirection))
       return true;
@@ -820,9 +951,10 @@ void ezFileSystem::ReloadAllExternalDataDirectoryConfigs()
 {
   EZ_LOG_BLOCK("ReloadAllExternalDataDirectoryConfigs");
 
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
-  for (auto& dd : s_pData->m_DataDirectories)
+  for (auto& dd : dataDirs)
   {
     dd.m_pDataDirectory->ReloadExternalConfigs();
   }
@@ -831,6 +963,7 @@ void ezFileSystem::ReloadAllExternalDataDirectoryConfigs()
 void ezFileSystem::Startup()
 {
   s_pData = EZ_DEFAULT_NEW(FileSystemData);
+  s_pData->m_pDataDirs = EZ_DEFAULT_NEW(DataDirSnapshot);
 }
 
 void ezFileSystem::Shutdown()
@@ -841,6 +974,12 @@ void ezFileSystem::Shutdown()
     s_pData->m_DataDirFactories.Clear();
 
     ClearAllDataDirectories();
+
+    EZ_ASSERT_DEV(s_pData->m_iActiveReaders == 0, "The file system is shut down while it is still in use.");
+    DeleteRetiredDataDirs();
+
+    DataDirSnapshot* pDataDirs = s_pData->m_pDataDirs.exchange(nullptr);
+    EZ_DEFAULT_DELETE(pDataDirs);
   }
 
   EZ_DEFAULT_DELETE(s_pData);
@@ -979,12 +1118,13 @@ ezMutex& ezFileSystem::GetMutex()
 
 void ezFileSystem::StartSearch(ezFileSystemIterator& ref_iterator, ezStringView sSearchTerm, ezBitflags<ezFileSystemIteratorFlags> flags /*= ezFileSystemIteratorFlags::Default*/)
 {
-  EZ_LOCK(s_pData->m_FsMutex);
+  ReadScope scope;
+  const auto& dataDirs = scope.GetDataDirs().m_DataDirectories;
 
   ezHybridArray<ezString, 16> folders;
   ezStringBuilder sDdPath;
 
-  for (const auto& dd : s_pData->m_DataDirectories)
+  for (const auto& dd : dataDirs)
   {
     sDdPath = dd.m_pDataDirectory->GetRedirectedDataDirectoryPath();
 
@@ -0,0 +1,224 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/IO/AsyncFileIO.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Types/UniquePtr.h>
+
+// clang-format off
+EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, AsyncFileIO)
+
+  BEGIN_SUBSYSTEM_DEPENDENCIES
+    "TaskSystem"
+  END_SUBSYSTEM_DEPENDENCIES
+
+  ON_CORESYSTEMS_SHUTDOWN
+  {
+    ezAsyncFileIO::Shutdown();
+  }
+
+EZ_END_SUBSYSTEM_DECLARATION;
+// clang-format on
+
+namespace ezAsyncFileIOInternal
+{
+  struct ReadRequest
+  {
+    ezAsyncFileReadResult m_Result;
+    ezAsyncFileIO::Callback m_OnFinished;
+    ezTaskPriority::Enum m_CallbackPriority = ezTaskPriority::ThisFrame;
+  };
+
+  /// \brief Executes the reads. Every submitted request has to be passed to FinishRead() eventually, also when the backend is destroyed.
+  class Backend
+  {
+  public:
+    virtual ~Backend() = default;
+
+    virtual void Submit(ezUniquePtr<ReadRequest>&& pRequest) = 0;
+  };
+
+  static ezMutex s_BackendMutex;
+  static ezUniquePtr<Backend> s_pBackend;
+  static ezAsyncFileIOBackend::Enum s_RequestedBackend = ezAsyncFileIOBackend::Default;
+  static ezAsyncFileIOBackend::Enum s_ActiveBackend = ezAsyncFileIOBackend::ThreadPool;
+  static ezAtomicInteger32 s_iPendingReads;
+
+  class CallbackTask final : public ezTask
+  {
+  public:
+    CallbackTask(ezUniquePtr<ReadRequest>&& pRequest)
+      : m_pRequest(std::move(pRequest))
+    {
+      ConfigureTask("ezAsyncFileIO Callback", ezTaskNesting::Maybe);
+    }
+
+  private:
+    virtual void Execute() override
+    {
+      m_pRequest->m_OnFinished(m_pRequest->m_Result);
+      m_pRequest.Clear();
+
+      s_iPendingReads.Decrement();
+    }
+
+    ezUniquePtr<ReadRequest> m_pRequest;
+  };
+
+  /// \brief Called by the backends once a file was read (or reading failed). Hands the result over to the callback task.
+  static void FinishRead(ezUniquePtr<ReadRequest>&& pRequest)
+  {
+    const ezTaskPriority::Enum priority = pRequest->m_CallbackPriority;
+    ezTaskSystem::StartSingleTask(EZ_DEFAULT_NEW(CallbackTask, std::move(pRequest)), priority);
+  }
+
+  class ThreadPoolReadTask final : public ezTask
+  {
+  public:
+    ThreadPoolReadTask(ezUniquePtr<ReadRequest>&& pRequest)
+      : m_pRequest(std::move(pRequest))
+    {
+      ConfigureTask("ezAsyncFileIO Read", ezTaskNesting::Never);
+    }
+
+  private:
+    virtual void Execute() override
+    {
+      ezAsyncFileReadResult& result = m_pRequest->m_Result;
+
+      ezOSFile file;
+      if (file.Open(result.m_sFile, ezFileOpenMode::Read).Succeeded())
+      {
+        const ezUInt64 uiFileSize = file.GetFileSize();
+
+        if (uiFileSize <= ezMath::MaxValue<ezUInt32>())
+        {
+          result.m_Data.SetCountUninitialized(static_cast<ezUInt32>(uiFileSize));
+          result.m_Result = (uiFileSize == 0 || file.Read(result.m_Data.GetData(), uiFileSize) == uiFileSize) ? EZ_SUCCESS : EZ_FAILURE;
+        }
+      }
+
+      FinishRead(std::move(m_pRequest));
+    }
+
+    ezUniquePtr<ReadRequest> m_pRequest;
+  };
+
+  /// \brief Executes the read as a blocking read in a long running task. Also used by other backends when they can't execute a read themselves.
+  static void ReadOnThreadPool(ezUniquePtr<ReadRequest>&& pRequest)
+  {
+    ezTaskSystem::StartSingleTask(EZ_DEFAULT_NEW(ThreadPoolReadTask, std::move(pRequest)), ezTaskPriority::LongRunning);
+  }
+
+  /// \brief Executes every read as a blocking read in a long running task.
+  class ThreadPoolBackend final : public Backend
+  {
+  public:
+    virtual void Submit(ezUniquePtr<ReadRequest>&& pRequest) override
+    {
+      ReadOnThreadPool(std::move(pRequest));
+    }
+  };
+
+  static ezUniquePtr<Backend> CreateIoUringBackend();
+
+} // namespace ezAsyncFileIOInternal
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+#  include <Foundation/IO/Implementation/Linux/AsyncFileIO_uring_linux.h>
+#else
+namespace ezAsyncFileIOInternal
+{
+  static ezUniquePtr<Backend> CreateIoUringBackend()
+  {
+    return nullptr;
+  }
+} // namespace ezAsyncFileIOInternal
+#endif
+
+using namespace ezAsyncFileIOInternal;
+
+static void EnsureBackend()
+{
+  EZ_ASSERT_DEBUG(s_BackendMutex.IsLocked(), "");
+
+  if (s_pBackend != nullptr)
+    return;
+
+  if (s_RequestedBackend == ezAsyncFileIOBackend::IoUring || s_RequestedBackend == ezAsyncFileIOBackend::Default)
+  {
+    s_pBackend = CreateIoUringBackend();
+    s_ActiveBackend = ezAsyncFileIOBackend::IoUring;
+  }
+
+  if (s_pBackend == nullptr)
+  {
+    s_pBackend = EZ_DEFAULT_NEW(ThreadPoolBackend);
+    s_ActiveBackend = ezAsyncFileIOBackend::ThreadPool;
+  }
+}
+
+void ezAsyncFileIO::ReadFile(ezStringView sAbsolutePath, Callback onFinished, void* pUserData, ezTaskPriority::Enum callbackPriority)
+{
+  EZ_ASSERT_DEV(onFinished.IsValid(), "A completion callback is required.");
+
+  ezUniquePtr<ReadRequest> pRequest = EZ_DEFAULT_NEW(ReadRequest);
+  pRequest->m_Result.m_sFile = sAbsolutePath;
+  pRequest->m_Result.m_pUserData = pUserData;
+  pRequest->m_OnFinished = onFinished;
+  pRequest->m_CallbackPriority = callbackPriority;
+
+  s_iPendingReads.Increment();
+
+  EZ_LOCK(s_BackendMutex);
+  EnsureBackend();
+  s_pBackend->Submit(std::move(pRequest));
+}
+
+void ezAsyncFileIO::WaitForAllReads()
+{
+  ezTaskSystem::WaitForCondition([]()
+    { return s_iPendingReads == 0; });
+}
+
+ezUInt32 ezAsyncFileIO::GetNumPendingReads()
+{
+  return static_cast<ezUInt32>(s_iPendingReads);
+}
+
+void ezAsyncFileIO::SetBackend(ezAsyncFileIOBackend::Enum backend)
+{
+  ezUniquePtr<Backend> pOldBackend;
+
+  {
+    EZ_LOCK(s_BackendMutex);
+    pOldBackend = std::move(s_pBackend);
+    s_RequestedBackend = backend;
+  }
+
+  // new reads already go to the new backend, destroying the old one finishes the reads that were submitted to it
+  pOldBackend.Clear();
+}
+
+ezAsyncFileIOBackend::Enum ezAsyncFileIO::GetBackend()
+{
+  EZ_LOCK(s_BackendMutex);
+  EnsureBackend();
+  return s_ActiveBackend;
+}
+
+void ezAsyncFileIO::Shutdown()
+{
+  ezUniquePtr<Backend> pOldBackend;
+
+  {
+    EZ_LOCK(s_BackendMutex);
+    pOldBackend = std::move(s_pBackend);
+  }
+
+  pOldBackend.Clear();
+  WaitForAllReads();
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_IO_Implementation_AsyncFileIO);
@@ -4,6 +4,8 @@
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
 
+#  include <Foundation/Algorithm/Sorting.h>
+#  include <Foundation/Containers/HashTable.h>
 #  include <Foundation/System/SystemInformation.h>
 #  include <zstd/zstd.h>
 
@@ -36,6 +38,25 @@ void ezCompressedStreamReaderZstd::SetInputStream(ezStreamReader* pInputStream)
   }
 
   ZSTD_initDStream(reinterpret_cast<ZSTD_DStream*>(m_pZstdDStream));
+
+  if (m_pDictionary != nullptr)
+  {
+    ZSTD_DCtx_refDDict(reinterpret_cast<ZSTD_DStream*>(m_pZstdDStream), reinterpret_cast<const ZSTD_DDict*>(m_pDictionary->m_pDDict));
+  }
+}
+
+void ezCompressedStreamReaderZstd::SetDictionary(const ezCompressionDictionaryZstd* pDictionary)
+{
+  EZ_ASSERT_DEV(pDictionary == nullptr || pDictionary->IsValid(), "The dictionary has not been created.");
+
+  m_pDictionary = pDictionary;
+
+  if (m_pZstdDStream != nullptr)
+  {
+    EZ_ASSERT_DEV(m_InBuffer.size == 0, "The dictionary must be set before reading from the stream.");
+
+    ZSTD_DCtx_refDDict(reinterpret_cast<ZSTD_DStream*>(m_pZstdDStream), pDictionary != nullptr ? reinterpret_cast<const ZSTD_DDict*>(pDictionary->m_pDDict) : nullptr);
+  }
 }
 
 ezUInt64 ezCompressedStreamReaderZstd::ReadBytes(void* pReadBuffer, ezUInt64 uiBytesToRead)
@@ -186,10 +207,17 @@ void ezCompressedStreamWriterZstd::SetOutputStream(ezStreamWriter* pOutputStream
     const ezUInt32 uiCoreCount = (uiMaxNumWorkerThreads > 0) ? ezMath::Clamp(ezSystemInformation::Get().GetCPUCoreCount(), 1u, uiMaxNumWorkerThreads) : 0u;
 
     ZSTD_CCtx_reset(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), ZSTD_reset_session_only);
-    ZSTD_CCtx_refCDict(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), nullptr);
     ZSTD_CCtx_setParameter(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), ZSTD_c_compressionLevel, (int)ratio);
     ZSTD_CCtx_setParameter(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), ZSTD_c_nbWorkers, uiCoreCount);
 
+    if (uiCoreCount > 0)
+    {
+      // by default the job size is a multiple of the window size, which can be several MB, so smaller data would not be compressed in parallel at all
+      ZSTD_CCtx_setParameter(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), ZSTD_c_jobSize, 1024 * 1024);
+    }
+
+    ApplyDictionary();
+
     m_CompressedCache.SetCountUninitialized(ezMath::Max(1U, uiCompressionCacheSizeKB) * 1024);
 
     m_OutBuffer.dst = m_CompressedCache.GetData();
@@ -198,6 +226,27 @@ void ezCompressedStreamWriterZstd::SetOutputStream(ezStreamWriter* pOutputStream
   }
 }
 
+void ezCompressedStreamWriterZstd::SetDictionary(const ezCompressionDictionaryZstd* pDictionary)
+{
+  EZ_ASSERT_DEV(pDictionary == nullptr || pDictionary->IsValid(), "The dictionary has not been created.");
+  m_pDictionary = pDictionary;
+
+  if (m_pOutputStream != nullptr)
+  {
+    EZ_ASSERT_DEV(m_uiUncompressedSize == 0, "The dictionary must be set before writing to the stream.");
+
+    ApplyDictionary();
+  }
+}
+
+void ezCompressedStreamWriterZstd::ApplyDictionary()
+{
+  ZSTD_CCtx_refCDict(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), m_pDictionary != nullptr ? reinterpret_cast<const ZSTD_CDict*>(m_pDictionary->m_pCDict) : nullptr);
+
+  // decompressing with the wrong dictionary would silently produce garbage, the checksum turns that into an error
+  ZSTD_CCtx_setParameter(reinterpret_cast<ZSTD_CStream*>(m_pZstdCStream), ZSTD_c_checksumFlag, m_pDictionary != nullptr ? 1 : 0);
+}
+
 ezResult ezCompressedStreamWriterZstd::FinishCompressedStream()
 {
   if (m_pOutputStream == nullptr)
@@ -303,6 +352,229 @@ ezResult ezCompressedStreamWriterZstd::WriteBytes(const void* pWriteBuffer, ezUI
   return EZ_SUCCESS;
 }
 
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  // The dictionary is built with a simplified version of the COVER algorithm from zstd's dictionary builder:
+  // Every 8 byte sequence (dmer) is rated by the number of samples that contain it. The data is split into epochs and from every epoch
+  // the segment with the highest sum of the ratings of its distinct dmers is taken into the dictionary. Dmers that are already covered
+  // by the dictionary don't count anymore for later segments.
+  constexpr ezUInt32 s_uiDmerSize = 8;
+  constexpr ezUInt32 s_uiSegmentSize = 64;
+  constexpr ezUInt32 s_uiInvalidDmer = 0xFFFFFFFF;
+
+  struct DictionarySegment
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiStart;
+    ezUInt32 m_uiSize;
+    ezUInt64 m_uiScore;
+  };
+} // namespace
+
+ezCompressionDictionaryZstd::ezCompressionDictionaryZstd() = default;
+
+ezCompressionDictionaryZstd::~ezCompressionDictionaryZstd()
+{
+  Clear();
+}
+
+void ezCompressionDictionaryZstd::CreateFromSamples(ezArrayPtr<const ezArrayPtr<const ezUInt8>> samples, ezUInt32 uiMaxDictionarySize, ezCompressedStreamWriterZstd::Compression ratio)
+{
+  uiMaxDictionarySize = ezMath::Max(uiMaxDictionarySize, s_uiSegmentSize);
+
+  ezDynamicArray<ezUInt8> allData;
+  for (const auto& sample : samples)
+  {
+    allData.PushBackRange(sample);
+  }
+
+  const ezUInt32 uiTotalSize = allData.GetCount();
+
+  if (uiTotalSize <= uiMaxDictionarySize)
+  {
+    CreateFromData(allData, ratio);
+    return;
+  }
+
+  // map every dmer to a dense index and count in how many samples it occurs
+  ezDynamicArray<ezUInt32> dmerAtPos;
+  dmerAtPos.SetCountUninitialized(uiTotalSize);
+
+  ezDynamicArray<ezUInt32> dmerFrequency;
+  ezDynamicArray<ezUInt32> dmerLastSample;
+
+  {
+    ezHashTable<ezUInt64, ezUInt32> dmerIndices;
+    dmerIndices.Reserve(uiTotalSize / 4);
+
+    ezUInt32 uiSampleStart = 0;
+    for (ezUInt32 uiSample = 0; uiSample < samples.GetCount(); ++uiSample)
+    {
+      const ezUInt32 uiSampleEnd = uiSampleStart + samples[uiSample].GetCount();
+
+      for (ezUInt32 uiPos = uiSampleStart; uiPos < uiSampleEnd; ++uiPos)
+      {
+        if (uiPos + s_uiDmerSize > uiSampleEnd)
+        {
+          dmerAtPos[uiPos] = s_uiInvalidDmer;
+          continue;
+        }
+
+        ezUInt64 uiDmer;
+        ezMemoryUtils::RawByteCopy(&uiDmer, &allData[uiPos], sizeof(uiDmer));
+
+        bool bExisted = false;
+        ezUInt32& uiIndex = dmerIndices.FindOrAdd(uiDmer, &bExisted);
+
+        if (!bExisted)
+        {
+          uiIndex = dmerFrequency.GetCount();
+          dmerFrequency.PushBack(0);
+          dmerLastSample.PushBack(s_uiInvalidDmer);
+        }
+
+        dmerAtPos[uiPos] = uiIndex;
+
+        if (dmerLastSample[uiIndex] != uiSample)
+        {
+          dmerLastSample[uiIndex] = uiSample;
+          ++dmerFrequency[uiIndex];
+        }
+      }
+
+      uiSampleStart = uiSampleEnd;
+    }
+  }
+
+  ezDynamicArray<ezUInt32> dmerActive;
+  dmerActive.SetCount(dmerFrequency.GetCount());
+
+  ezDynamicArray<DictionarySegment> segments;
+
+  const ezUInt32 uiNumEpochs = ezMath::Max(1u, uiMaxDictionarySize / s_uiSegmentSize);
+  const ezUInt32 uiEpochSize = uiTotalSize / uiNumEpochs;
+  constexpr ezUInt32 uiDmersPerSegment = s_uiSegmentSize - s_uiDmerSize + 1;
+
+  for (ezUInt32 uiEpoch = 0; uiEpoch < uiNumEpochs; ++uiEpoch)
+  {
+    const ezUInt32 uiEpochStart = uiEpoch * uiEpochSize;
+    const ezUInt32 uiEpochEnd = (uiEpoch + 1 == uiNumEpochs) ? uiTotalSize : uiEpochStart + uiEpochSize;
+
+    // slide a window over the dmers of the epoch and track the score of the distinct dmers inside it
+    DictionarySegment best = {uiEpochStart, 0, 0};
+    ezUInt64 uiScore = 0;
+
+    for (ezUInt32 uiPos = uiEpochStart; uiPos < uiEpochEnd; ++uiPos)
+    {
+      const ezUInt32 uiDmer = dmerAtPos[uiPos];
+      if (uiDmer != s_uiInvalidDmer && dmerActive[uiDmer]++ == 0)
+      {
+        uiScore += dmerFrequency[uiDmer];
+      }
+
+      if (uiPos + 1 >= uiEpochStart + uiDmersPerSegment)
+      {
+        const ezUInt32 uiWindowStart = uiPos + 1 - uiDmersPerSegment;
+
+        if (uiScore > best.m_uiScore)
+        {
+          best.m_uiStart = uiWindowStart;
+          best.m_uiScore = uiScore;
+        }
+
+        const ezUInt32 uiOldDmer = dmerAtPos[uiWindowStart];
+        if (uiOldDmer != s_uiInvalidDmer && --dmerActive[uiOldDmer] == 0)
+        {
+          uiScore -= dmerFrequency[uiOldDmer];
+        }
+      }
+    }
+
+    for (ezUInt32 uiPos = uiEpochStart; uiPos < uiEpochEnd; ++uiPos)
+    {
+      if (dmerAtPos[uiPos] != s_uiInvalidDmer)
+        dmerActive[dmerAtPos[uiPos]] = 0;
+    }
+
+    if (best.m_uiScore == 0)
+      continue;
+
+    best.m_uiSize = ezMath::Min(s_uiSegmentSize, uiTotalSize - best.m_uiStart);
+
+    for (ezUInt32 uiPos = best.m_uiStart; uiPos < best.m_uiStart + best.m_uiSize; ++uiPos)
+    {
+      if (dmerAtPos[uiPos] != s_uiInvalidDmer)
+        dmerFrequency[dmerAtPos[uiPos]] = 0;
+    }
+
+    segments.PushBack(best);
+  }
+
+  // zstd can reference data at the end of the dictionary with smaller offsets, so the most valuable segments go last
+  segments.Sort([](const DictionarySegment& a, const DictionarySegment& b) { return a.m_uiScore < b.m_uiScore; });
+
+  ezDynamicArray<ezUInt8> dictionary;
+  dictionary.Reserve(uiMaxDictionarySize);
+
+  for (const DictionarySegment& segment : segments)
+  {
+    dictionary.PushBackRange(allData.GetArrayPtr().GetSubArray(segment.m_uiStart, segment.m_uiSize));
+  }
+
+  // raw content that happens to start with the dictionary magic number would be mistaken for a zstd dictionary
+  ezUInt32 uiMagic = 0;
+  if (dictionary.GetCount() >= sizeof(uiMagic))
+  {
+    ezMemoryUtils::RawByteCopy(&uiMagic, dictionary.GetData(), sizeof(uiMagic));
+  }
+
+  if (uiMagic == ZSTD_MAGIC_DICTIONARY)
+  {
+    dictionary.Insert(0, 0);
+  }
+
+  CreateFromData(dictionary, ratio);
+}
+
+void ezCompressionDictionaryZstd::CreateFromData(ezArrayPtr<const ezUInt8> data, ezCompressedStreamWriterZstd::Compression ratio)
+{
+  Clear();
+
+  if (data.IsEmpty())
+    return;
+
+  m_Data = data;
+
+  m_pCDict = ZSTD_createCDict(m_Data.GetData(), m_Data.GetCount(), (int)ratio);
+  m_pDDict = ZSTD_createDDict(m_Data.GetData(), m_Data.GetCount());
+
+  EZ_ASSERT_DEV(m_pCDict != nullptr && m_pDDict != nullptr, "Creating the zstd dictionary failed.");
+}
+
+void ezCompressionDictionaryZstd::Clear()
+{
+  if (m_pCDict != nullptr)
+  {
+    ZSTD_freeCDict(reinterpret_cast<ZSTD_CDict*>(m_pCDict));
+    m_pCDict = nullptr;
+  }
+
+  if (m_pDDict != nullptr)
+  {
+    ZSTD_freeDDict(reinterpret_cast<ZSTD_DDict*>(m_pDDict));
+    m_pDDict = nullptr;
+  }
+
+  m_Data.Clear();
+}
+
 #endif
 
 
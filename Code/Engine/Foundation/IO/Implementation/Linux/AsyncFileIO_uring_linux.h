@@ -0,0 +1,454 @@
+#pragma once
+
+#include <Foundation/FoundationInternal.h>
+EZ_FOUNDATION_INTERNAL_HEADER
+
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace ezAsyncFileIOInternal
+{
+  /// \brief Submits all reads to an io_uring from one dedicated thread.
+  ///
+  /// New requests are handed over to the thread through a queue and an eventfd, which the ring polls as well. Files are opened on the
+  /// thread, all reads are then submitted together and are in flight at the same time, up to QueueDepth of them.
+  /// If the ring stops working, all pending and following requests are read on the thread pool instead.
+  class IoUringBackend final : public Backend, public ezThread
+  {
+  public:
+    enum
+    {
+      QueueDepth = 64,
+      MaxReadSize = 1024 * 1024 * 1024, ///< Larger files are read in several parts.
+    };
+
+    IoUringBackend()
+      : ezThread("ezAsyncFileIO io_uring")
+    {
+    }
+
+    ~IoUringBackend()
+    {
+      // the thread finishes all pending reads before it stops, it may also have stopped already after the ring failed
+      if (m_bStarted)
+      {
+        m_bStop = true;
+        WakeUp();
+        Join();
+      }
+
+      EZ_ASSERT_DEV(m_Incoming.IsEmpty() && m_uiNumInFlight == 0, "The io_uring backend was destroyed while reads were still pending.");
+
+      if (m_pSqes != nullptr)
+        munmap(m_pSqes, m_uiSqesSize);
+      if (m_pCqRing != nullptr && m_pCqRing != m_pSqRing)
+        munmap(m_pCqRing, m_uiCqRingSize);
+      if (m_pSqRing != nullptr)
+        munmap(m_pSqRing, m_uiSqRingSize);
+      if (m_iEventFd >= 0)
+        close(m_iEventFd);
+      if (m_iRingFd >= 0)
+        close(m_iRingFd);
+    }
+
+    ezResult Setup()
+    {
+      io_uring_params params = {};
+      m_iRingFd = static_cast<int>(syscall(__NR_io_uring_setup, QueueDepth, &params));
+
+      // not supported by the kernel or forbidden by a sandbox
+      if (m_iRingFd < 0)
+        return EZ_FAILURE;
+
+      m_uiSqRingSize = params.sq_off.array + params.sq_entries * sizeof(ezUInt32);
+      m_uiCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+      m_uiSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+      const bool bSingleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if (bSingleMap)
+      {
+        m_uiSqRingSize = ezMath::Max(m_uiSqRingSize, m_uiCqRingSize);
+        m_uiCqRingSize = m_uiSqRingSize;
+      }
+
+      m_pSqRing = MapRing(m_uiSqRingSize, IORING_OFF_SQ_RING);
+      m_pCqRing = bSingleMap ? m_pSqRing : MapRing(m_uiCqRingSize, IORING_OFF_CQ_RING);
+      m_pSqes = static_cast<io_uring_sqe*>(MapRing(m_uiSqesSize, IORING_OFF_SQES));
+
+      if (m_pSqRing == nullptr || m_pCqRing == nullptr || m_pSqes == nullptr)
+        return EZ_FAILURE;
+
+      ezUInt8* pSq = static_cast<ezUInt8*>(m_pSqRing);
+      m_pSqTail = reinterpret_cast<ezUInt32*>(pSq + params.sq_off.tail);
+      m_pSqMask = reinterpret_cast<ezUInt32*>(pSq + params.sq_off.ring_mask);
+      m_pSqArray = reinterpret_cast<ezUInt32*>(pSq + params.sq_off.array);
+
+      ezUInt8* pCq = static_cast<ezUInt8*>(m_pCqRing);
+      m_pCqHead = reinterpret_cast<ezUInt32*>(pCq + params.cq_off.head);
+      m_pCqTail = reinterpret_cast<ezUInt32*>(pCq + params.cq_off.tail);
+      m_pCqMask = reinterpret_cast<ezUInt32*>(pCq + params.cq_off.ring_mask);
+      m_pCqes = reinterpret_cast<io_uring_cqe*>(pCq + params.cq_off.cqes);
+
+      m_iEventFd = eventfd(0, EFD_CLOEXEC);
+      if (m_iEventFd < 0)
+        return EZ_FAILURE;
+
+      // the eventfd is polled through the ring, so that the thread wakes up for new requests and for finished reads alike
+      PushPollEventFd();
+      if (Enter(0).Failed())
+        return EZ_FAILURE;
+
+      Start();
+      m_bStarted = true;
+      return EZ_SUCCESS;
+    }
+
+    virtual void Submit(ezUniquePtr<ReadRequest>&& pRequest) override
+    {
+      {
+        EZ_LOCK(m_IncomingMutex);
+
+        if (!m_bFailed)
+        {
+          m_Incoming.PushBack(std::move(pRequest));
+        }
+      }
+
+      if (pRequest == nullptr)
+      {
+        WakeUp();
+        return;
+      }
+
+      ReadOnThreadPool(std::move(pRequest));
+    }
+
+  private:
+    struct InFlightRead
+    {
+      ezUniquePtr<ReadRequest> m_pRequest;
+      int m_iFile = -1;
+      ezUInt64 m_uiBytesRead = 0;
+      iovec m_Buffer;
+    };
+
+    static constexpr ezUInt64 EventFdUserData = 0;
+
+    void* MapRing(size_t uiSize, ezUInt64 uiOffset)
+    {
+      void* pMemory = mmap(nullptr, uiSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_iRingFd, static_cast<off_t>(uiOffset));
+      return pMemory != MAP_FAILED ? pMemory : nullptr;
+    }
+
+    void WakeUp()
+    {
+      const ezUInt64 uiValue = 1;
+      [[maybe_unused]] ssize_t res = write(m_iEventFd, &uiValue, sizeof(uiValue));
+    }
+
+    io_uring_sqe* PushSqe()
+    {
+      // the kernel consumes all entries on every Enter(), so there is always room for the reads that are in flight
+      const ezUInt32 uiTail = *m_pSqTail;
+      const ezUInt32 uiIndex = uiTail & *m_pSqMask;
+
+      io_uring_sqe* pSqe = &m_pSqes[uiIndex];
+      ezMemoryUtils::ZeroFill(pSqe, 1);
+      m_pSqArray[uiIndex] = uiIndex;
+
+      __atomic_store_n(m_pSqTail, uiTail + 1, __ATOMIC_RELEASE);
+      ++m_uiNumToSubmit;
+      return pSqe;
+    }
+
+    void PushPollEventFd()
+    {
+      io_uring_sqe* pSqe = PushSqe();
+      pSqe->opcode = IORING_OP_POLL_ADD;
+      pSqe->fd = m_iEventFd;
+      pSqe->poll_events = POLLIN;
+      pSqe->user_data = EventFdUserData;
+    }
+
+    void PushRead(InFlightRead* pRead)
+    {
+      const ezUInt64 uiRemaining = pRead->m_pRequest->m_Result.m_Data.GetCount() - pRead->m_uiBytesRead;
+
+      pRead->m_Buffer.iov_base = pRead->m_pRequest->m_Result.m_Data.GetData() + pRead->m_uiBytesRead;
+      pRead->m_Buffer.iov_len = static_cast<size_t>(ezMath::Min<ezUInt64>(uiRemaining, MaxReadSize));
+
+      io_uring_sqe* pSqe = PushSqe();
+      pSqe->opcode = IORING_OP_READV;
+      pSqe->fd = pRead->m_iFile;
+      pSqe->addr = reinterpret_cast<ezUInt64>(&pRead->m_Buffer);
+      pSqe->len = 1;
+      pSqe->off = pRead->m_uiBytesRead;
+      pSqe->user_data = reinterpret_cast<ezUInt64>(pRead);
+    }
+
+    ezResult Enter(ezUInt32 uiMinComplete)
+    {
+      while (true)
+      {
+        const int res = static_cast<int>(syscall(__NR_io_uring_enter, m_iRingFd, m_uiNumToSubmit, uiMinComplete, uiMinComplete > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+
+        if (res >= 0)
+        {
+          m_uiNumToSubmit -= ezMath::Min<ezUInt32>(m_uiNumToSubmit, static_cast<ezUInt32>(res));
+
+          if (m_uiNumToSubmit == 0)
+            return EZ_SUCCESS;
+
+          // only part of the entries was consumed, submit the rest without waiting
+          uiMinComplete = 0;
+          continue;
+        }
+
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+          return EZ_FAILURE;
+      }
+    }
+
+    void FinishInFlight(InFlightRead* pRead, ezResult result)
+    {
+      if (pRead->m_iFile >= 0)
+        close(pRead->m_iFile);
+
+      pRead->m_pRequest->m_Result.m_Result = result;
+      FinishRead(std::move(pRead->m_pRequest));
+
+      EZ_DEFAULT_DELETE(pRead);
+      --m_uiNumInFlight;
+    }
+
+    /// \brief Reads the whole file again on the thread pool, used once the ring can't be used anymore.
+    void RestartOnThreadPool(InFlightRead* pRead)
+    {
+      if (pRead->m_iFile >= 0)
+        close(pRead->m_iFile);
+
+      ReadOnThreadPool(std::move(pRead->m_pRequest));
+
+      EZ_DEFAULT_DELETE(pRead);
+      --m_uiNumInFlight;
+    }
+
+    void ContinueRead(InFlightRead* pRead)
+    {
+      if (m_bFailed)
+        RestartOnThreadPool(pRead);
+      else
+        PushRead(pRead);
+    }
+
+    /// \brief Opens the file and queues the first read. Requests that can be answered right away are finished immediately.
+    void StartRead(ezUniquePtr<ReadRequest>&& pRequest)
+    {
+      InFlightRead* pRead = EZ_DEFAULT_NEW(InFlightRead);
+      pRead->m_pRequest = std::move(pRequest);
+      ++m_uiNumInFlight;
+
+      ezAsyncFileReadResult& result = pRead->m_pRequest->m_Result;
+
+      pRead->m_iFile = open(result.m_sFile.GetData(), O_RDONLY | O_CLOEXEC);
+      if (pRead->m_iFile < 0)
+      {
+        FinishInFlight(pRead, EZ_FAILURE);
+        return;
+      }
+
+      struct stat fileStats;
+      if (fstat(pRead->m_iFile, &fileStats) != 0 || !S_ISREG(fileStats.st_mode) || static_cast<ezUInt64>(fileStats.st_size) > ezMath::MaxValue<ezUInt32>())
+      {
+        FinishInFlight(pRead, EZ_FAILURE);
+        return;
+      }
+
+      result.m_Data.SetCountUninitialized(static_cast<ezUInt32>(fileStats.st_size));
+
+      if (result.m_Data.IsEmpty())
+      {
+        FinishInFlight(pRead, EZ_SUCCESS);
+        return;
+      }
+
+      PushRead(pRead);
+    }
+
+    void ProcessCompletions()
+    {
+      ezUInt32 uiHead = *m_pCqHead;
+      const ezUInt32 uiTail = __atomic_load_n(m_pCqTail, __ATOMIC_ACQUIRE);
+
+      for (; uiHead != uiTail; ++uiHead)
+      {
+        const io_uring_cqe& cqe = m_pCqes[uiHead & *m_pCqMask];
+
+        if (cqe.user_data == EventFdUserData)
+        {
+          ezUInt64 uiValue = 0;
+          [[maybe_unused]] ssize_t res = read(m_iEventFd, &uiValue, sizeof(uiValue));
+
+          if (!m_bFailed)
+            PushPollEventFd();
+
+          continue;
+        }
+
+        InFlightRead* pRead = reinterpret_cast<InFlightRead*>(cqe.user_data);
+
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+        {
+          ContinueRead(pRead);
+        }
+        else if (cqe.res <= 0)
+        {
+          // an error, or the file got shorter since it was opened
+          FinishInFlight(pRead, EZ_FAILURE);
+        }
+        else
+        {
+          pRead->m_uiBytesRead += static_cast<ezUInt64>(cqe.res);
+
+          if (pRead->m_uiBytesRead < pRead->m_pRequest->m_Result.m_Data.GetCount())
+            ContinueRead(pRead);
+          else
+            FinishInFlight(pRead, EZ_SUCCESS);
+        }
+      }
+
+      __atomic_store_n(m_pCqHead, uiHead, __ATOMIC_RELEASE);
+    }
+
+    /// \brief Hands all requests that were not submitted to the kernel over to the thread pool and waits for the ones that were.
+    void FallBackToThreadPool()
+    {
+      {
+        EZ_LOCK(m_IncomingMutex);
+        m_bFailed = true;
+
+        while (!m_Incoming.IsEmpty())
+        {
+          ReadOnThreadPool(std::move(m_Incoming.PeekFront()));
+          m_Incoming.PopFront();
+        }
+      }
+
+      // the kernel has not seen the entries that were not submitted yet, take them back
+      const ezUInt32 uiTail = *m_pSqTail;
+      const ezUInt32 uiFirstUnsubmitted = uiTail - m_uiNumToSubmit;
+
+      for (ezUInt32 i = uiFirstUnsubmitted; i != uiTail; ++i)
+      {
+        const ezUInt64 uiUserData = m_pSqes[i & *m_pSqMask].user_data;
+
+        if (uiUserData != EventFdUserData)
+          RestartOnThreadPool(reinterpret_cast<InFlightRead*>(uiUserData));
+      }
+
+      __atomic_store_n(m_pSqTail, uiFirstUnsubmitted, __ATOMIC_RELEASE);
+      m_uiNumToSubmit = 0;
+
+      // the kernel still writes into the buffers of the submitted reads, so they can't be abandoned
+      while (m_uiNumInFlight > 0)
+      {
+        ProcessCompletions();
+
+        if (m_uiNumInFlight > 0)
+          ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(1));
+      }
+    }
+
+    virtual ezUInt32 Run() override
+    {
+      ezHybridArray<ezUniquePtr<ReadRequest>, QueueDepth> newRequests;
+
+      while (true)
+      {
+        {
+          EZ_LOCK(m_IncomingMutex);
+
+          // pending reads are always finished, even when the backend is about to be destroyed
+          if (m_bStop && m_Incoming.IsEmpty() && m_uiNumInFlight == 0)
+            break;
+
+          // one entry is reserved for polling the eventfd
+          while (!m_Incoming.IsEmpty() && m_uiNumInFlight + newRequests.GetCount() < QueueDepth - 1)
+          {
+            newRequests.PushBack(std::move(m_Incoming.PeekFront()));
+            m_Incoming.PopFront();
+          }
+        }
+
+        for (auto& pRequest : newRequests)
+        {
+          StartRead(std::move(pRequest));
+        }
+
+        newRequests.Clear();
+
+        // submits all new reads and sleeps until at least one read finished or a new request arrived
+        if (Enter(1).Failed())
+        {
+          ezLog::Error("io_uring_enter failed with error {}, reading on the thread pool from now on", errno);
+          FallBackToThreadPool();
+          break;
+        }
+
+        ProcessCompletions();
+      }
+
+      return 0;
+    }
+
+    int m_iRingFd = -1;
+    int m_iEventFd = -1;
+
+    void* m_pSqRing = nullptr;
+    void* m_pCqRing = nullptr;
+    io_uring_sqe* m_pSqes = nullptr;
+    size_t m_uiSqRingSize = 0;
+    size_t m_uiCqRingSize = 0;
+    size_t m_uiSqesSize = 0;
+
+    ezUInt32* m_pSqTail = nullptr;
+    ezUInt32* m_pSqMask = nullptr;
+    ezUInt32* m_pSqArray = nullptr;
+    ezUInt32* m_pCqHead = nullptr;
+    ezUInt32* m_pCqTail = nullptr;
+    ezUInt32* m_pCqMask = nullptr;
+    io_uring_cqe* m_pCqes = nullptr;
+
+    ezUInt32 m_uiNumToSubmit = 0;
+    ezUInt32 m_uiNumInFlight = 0; ///< Only accessed by the thread.
+    bool m_bStarted = false;
+    ezAtomicBool m_bStop;
+
+    ezMutex m_IncomingMutex;
+    bool m_bFailed = false; ///< Set by the thread once the ring can't be used anymore, Submit() reads it while holding m_IncomingMutex.
+    ezDeque<ezUniquePtr<ReadRequest>> m_Incoming;
+  };
+
+  static ezUniquePtr<Backend> CreateIoUringBackend()
+  {
+    ezUniquePtr<IoUringBackend> pBackend = EZ_DEFAULT_NEW(IoUringBackend);
+
+    if (pBackend->Setup().Failed())
+      return nullptr;
+
+    return pBackend;
+  }
+} // namespace ezAsyncFileIOInternal
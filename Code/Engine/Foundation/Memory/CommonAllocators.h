@@ -9,6 +9,7 @@
 #include <Foundation/Memory/Policies/GuardedAllocation.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Memory/Policies/ProxyAllocation.h>
+#include <Foundation/Memory/Policies/ThreadCachingAllocation.h>
 
 
 /// \brief Default heap allocator
@@ -22,3 +23,6 @@ using ezGuardedAllocator = ezAllocator<ezMemoryPolicies::ezGuardedAllocation>;
 
 /// \brief Proxy allocator
 using ezProxyAllocator = ezAllocator<ezMemoryPolicies::ezProxyAllocation>;
+
+/// \brief Allocator that serves small allocations from per-thread caches
+using ezThreadCachingAllocator = ezAllocator<ezMemoryPolicies::ezThreadCachingAllocation>;
@@ -73,7 +73,8 @@ void* ezInternal::ezAllocatorImpl<A, TrackingFlags>::Allocate(size_t uiSize, siz
 
   EZ_ASSERT_DEBUG(ezMath::IsPowerOf2((ezUInt32)uiAlign), "Alignment must be power of two");
 
-  ezTime fAllocationTime = ezTime::Now();
+  // only query the time when it is needed, allocators without tracking are used on hot paths
+  const ezTime fAllocationTime = (TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0 ? ezTime::Now() : ezTime::MakeZero();
 
   void* ptr = m_allocator.Allocate(uiSize, uiAlign);
   EZ_ASSERT_DEV(ptr != nullptr, "Could not allocate {0} bytes. Out of memory?", uiSize);
@@ -154,7 +155,7 @@ void* ezInternal::ezAllocatorMixinReallocate<A, TrackingFlags, true>::Reallocate
     ezMemoryTracker::RemoveAllocation(this->m_Id, pPtr);
   }
 
-  ezTime fAllocationTime = ezTime::Now();
+  const ezTime fAllocationTime = (TrackingFlags & ezMemoryTrackingFlags::EnableAllocationTracking) != 0 ? ezTime::Now() : ezTime::MakeZero();
 
   void* pNewMem = this->m_allocator.Reallocate(pPtr, uiCurrentSize, uiNewSize, uiAlign);
 
@@ -1,5 +1,7 @@
 #include <Foundation/FoundationPCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Logging/Log.h>
@@ -26,19 +28,67 @@ namespace
     EZ_ALWAYS_INLINE static ezAllocatorBase* GetAllocator() { return s_pTrackerDataAllocator; }
   };
 
+  // allocation counts are accumulated in fixed point, since in sampling mode a single tracked allocation stands for a fractional number of allocations
+  constexpr ezInt64 s_iCountScale = 1 << 16;
+
+  constexpr ezUInt32 s_uiShardBits = 4;
+  constexpr ezUInt32 s_uiNumShards = 1 << s_uiShardBits;
+  constexpr ezUInt32 s_uiDirectoryPageSize = 4096;
+  constexpr ezUInt32 s_uiDirectorySize = (1 << 24) / s_uiDirectoryPageSize;
+
+  struct TrackedAllocation
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezMemoryTracker::AllocationInfo m_Info;
+    ezUInt64 m_uiEstimatedSize = 0;
+    ezInt64 m_iEstimatedCount = 0;
+  };
+
+  struct AllocationShard
+  {
+    ezMutex m_Mutex;
+    ezHashTable<const void*, TrackedAllocation, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
+  };
 
   struct AllocatorData
   {
     EZ_ALWAYS_INLINE AllocatorData() = default;
 
+    EZ_ALWAYS_INLINE AllocationShard& GetShard(const void* pPtr)
+    {
+      // the lower bits of an address are mostly determined by the alignment, fibonacci hashing mixes them into the top bits
+      const ezUInt64 uiHash = (static_cast<ezUInt64>(reinterpret_cast<size_t>(pPtr)) >> 4) * 0x9E3779B97F4A7C15ull;
+      return m_Shards[uiHash >> (64 - s_uiShardBits)];
+    }
+
+    ezAllocatorBase::Stats GetStats() const
+    {
+      ezAllocatorBase::Stats stats;
+      stats.m_uiNumAllocations = static_cast<ezUInt64>((m_iNumAllocations + s_iCountScale / 2) / s_iCountScale);
+      stats.m_uiNumDeallocations = static_cast<ezUInt64>((m_iNumDeallocations + s_iCountScale / 2) / s_iCountScale);
+      stats.m_uiAllocationSize = static_cast<ezUInt64>(static_cast<ezInt64>(m_iAllocationSize));
+      stats.m_uiPerFrameAllocationSize = static_cast<ezUInt64>(static_cast<ezInt64>(m_iPerFrameAllocationSize));
+      stats.m_PerFrameAllocationTime = ezTime::MakeFromNanoseconds(static_cast<double>(static_cast<ezInt64>(m_iPerFrameAllocationTimeNs)));
+      return stats;
+    }
+
     ezHybridString<32, TrackerDataAllocatorWrapper> m_sName;
     ezBitflags<ezMemoryTrackingFlags> m_Flags;
 
+    ezAllocatorId m_Id;
     ezAllocatorId m_ParentId;
 
-    ezAllocatorBase::Stats m_Stats;
+    ezAtomicInteger64 m_iNumAllocations;
+    ezAtomicInteger64 m_iNumDeallocations;
+    ezAtomicInteger64 m_iAllocationSize;
+    ezAtomicInteger64 m_iPerFrameAllocationSize;
+    ezAtomicInteger64 m_iPerFrameAllocationTimeNs;
 
-    ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
+    // allocations that were skipped in sampling mode and were not deallocated yet, as far as this can be known
+    ezAtomicInteger64 m_iNumUntrackedAllocations;
+
+    AllocationShard m_Shards[s_uiNumShards];
   };
 
   struct TrackerData
@@ -46,12 +96,19 @@ namespace
     EZ_ALWAYS_INLINE void Lock() { m_Mutex.Lock(); }
     EZ_ALWAYS_INLINE void Unlock() { m_Mutex.Unlock(); }
 
+    // only protects registration of allocators, the allocations themselves are protected by the shards of each allocator
     ezMutex m_Mutex;
 
-    using AllocatorTable = ezIdTable<ezAllocatorId, AllocatorData, TrackerDataAllocatorWrapper>;
+    using AllocatorTable = ezIdTable<ezAllocatorId, AllocatorData*, TrackerDataAllocatorWrapper>;
     AllocatorTable m_AllocatorData;
 
+    // Maps the instance index of an allocator id to its data without taking the lock.
+    // Pages are only ever added, so a lookup never sees memory that is moved or freed by a concurrent registration.
+    AllocatorData** m_AllocatorDirectory[s_uiDirectorySize] = {};
+
     ezAllocatorId m_StaticAllocatorId;
+
+    ezAtomicInteger32 m_iSamplingInterval;
   };
 
   static TrackerData* s_pTrackerData;
@@ -84,6 +141,47 @@ namespace
     s_bIsInitializing = false;
   }
 
+  EZ_ALWAYS_INLINE AllocatorData& GetAllocatorData(ezAllocatorId allocatorId)
+  {
+    AllocatorData** pPage = s_pTrackerData->m_AllocatorDirectory[allocatorId.m_InstanceIndex / s_uiDirectoryPageSize];
+    EZ_ASSERT_DEBUG(pPage != nullptr, "Invalid allocator id");
+
+    AllocatorData* pData = pPage[allocatorId.m_InstanceIndex % s_uiDirectoryPageSize];
+    EZ_ASSERT_DEBUG(pData != nullptr && pData->m_Id == allocatorId, "Invalid allocator id");
+    return *pData;
+  }
+
+  struct SamplingState
+  {
+    ezInt64 m_iBytesUntilNextSample;
+    ezUInt64 m_uiRandomState;
+    ezInt32 m_iSamplingInterval;
+  };
+
+  // trivially constructible, so that allocations during thread shutdown can still use it
+  thread_local SamplingState t_SamplingState;
+
+  /// Draws the distance to the next sampled byte from an exponential distribution with the sampling interval as mean.
+  /// Since the distribution is memoryless every byte has the same chance to be sampled, regardless of how the allocations are sized.
+  static ezInt64 DrawBytesUntilNextSample(SamplingState& ref_state)
+  {
+    if (ref_state.m_uiRandomState == 0)
+    {
+      ref_state.m_uiRandomState = (static_cast<ezUInt64>(reinterpret_cast<size_t>(&ref_state)) * 0x9E3779B97F4A7C15ull) | 1;
+    }
+
+    // xorshift64*
+    ezUInt64 x = ref_state.m_uiRandomState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    ref_state.m_uiRandomState = x;
+
+    // uniform in (0, 1]
+    const double fRandom = static_cast<double>(((x * 0x2545F4914F6CDD1Dull) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    return static_cast<ezInt64>(-std::log(fRandom) * ref_state.m_iSamplingInterval) + 1;
+  }
+
   static void DumpLeak(const ezMemoryTracker::AllocationInfo& info, const char* szAllocatorName)
   {
     char szBuffer[512];
@@ -111,17 +209,17 @@ ezAllocatorId ezMemoryTracker::Iterator::Id() const
 
 ezStringView ezMemoryTracker::Iterator::Name() const
 {
-  return CAST_ITER(m_pData)->Value().m_sName;
+  return CAST_ITER(m_pData)->Value()->m_sName;
 }
 
 ezAllocatorId ezMemoryTracker::Iterator::ParentId() const
 {
-  return CAST_ITER(m_pData)->Value().m_ParentId;
+  return CAST_ITER(m_pData)->Value()->m_ParentId;
 }
 
-const ezAllocatorBase::Stats& ezMemoryTracker::Iterator::Stats() const
+ezAllocatorBase::Stats ezMemoryTracker::Iterator::Stats() const
 {
-  return CAST_ITER(m_pData)->Value().m_Stats;
+  return CAST_ITER(m_pData)->Value()->GetStats();
 }
 
 void ezMemoryTracker::Iterator::Next()
@@ -149,14 +247,25 @@ ezAllocatorId ezMemoryTracker::RegisterAllocator(ezStringView sName, ezBitflags<
 
   EZ_LOCK(*s_pTrackerData);
 
-  AllocatorData data;
-  data.m_sName = sName;
-  data.m_Flags = flags;
-  data.m_ParentId = parentId;
+  AllocatorData* pData = EZ_NEW(s_pTrackerDataAllocator, AllocatorData);
+  pData->m_sName = sName;
+  pData->m_Flags = flags;
+  pData->m_ParentId = parentId;
+
+  ezAllocatorId id = s_pTrackerData->m_AllocatorData.Insert(pData);
+  pData->m_Id = id;
+
+  AllocatorData**& pPage = s_pTrackerData->m_AllocatorDirectory[id.m_InstanceIndex / s_uiDirectoryPageSize];
+  if (pPage == nullptr)
+  {
+    AllocatorData** pNewPage = EZ_NEW_RAW_BUFFER(s_pTrackerDataAllocator, AllocatorData*, s_uiDirectoryPageSize);
+    ezMemoryUtils::ZeroFill(pNewPage, s_uiDirectoryPageSize);
+    pPage = pNewPage;
+  }
 
-  ezAllocatorId id = s_pTrackerData->m_AllocatorData.Insert(data);
+  pPage[id.m_InstanceIndex % s_uiDirectoryPageSize] = pData;
 
-  if (data.m_sName == EZ_STATIC_ALLOCATOR_NAME)
+  if (pData->m_sName == EZ_STATIC_ALLOCATOR_NAME)
   {
     s_pTrackerData->m_StaticAllocatorId = id;
   }
@@ -169,20 +278,31 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+  AllocatorData* pData = &GetAllocatorData(allocatorId);
 
-  ezUInt32 uiLiveAllocations = data.m_Allocations.GetCount();
-  if (uiLiveAllocations != 0)
+  ezUInt32 uiLiveAllocations = 0;
+  for (AllocationShard& shard : pData->m_Shards)
   {
-    for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
+    EZ_LOCK(shard.m_Mutex);
+
+    for (auto it = shard.m_Allocations.GetIterator(); it.IsValid(); ++it)
     {
-      DumpLeak(it.Value(), data.m_sName.GetData());
+      DumpLeak(it.Value().m_Info, pData->m_sName.GetData());
+      EZ_DELETE_ARRAY(s_pTrackerDataAllocator, it.Value().m_Info.GetStackTrace());
     }
 
-    EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", data.m_sName.GetData(), uiLiveAllocations);
+    uiLiveAllocations += shard.m_Allocations.GetCount();
+  }
+
+  if (uiLiveAllocations != 0)
+  {
+    EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", pData->m_sName.GetData(), uiLiveAllocations);
   }
 
+  s_pTrackerData->m_AllocatorDirectory[allocatorId.m_InstanceIndex / s_uiDirectoryPageSize][allocatorId.m_InstanceIndex % s_uiDirectoryPageSize] = nullptr;
   s_pTrackerData->m_AllocatorData.Remove(allocatorId);
+
+  EZ_DELETE(s_pTrackerDataAllocator, pData);
 }
 
 // static
@@ -192,6 +312,36 @@ void ezMemoryTracker::AddAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemo
 
   EZ_ASSERT_DEV(uiAlign < 0xFFFF, "Alignment too big");
 
+  ezUInt64 uiEstimatedSize = uiSize;
+  ezInt64 iEstimatedCount = s_iCountScale;
+
+  const ezInt32 iSamplingInterval = s_pTrackerData->m_iSamplingInterval;
+  if (iSamplingInterval != 0)
+  {
+    SamplingState& state = t_SamplingState;
+    if (state.m_iSamplingInterval != iSamplingInterval)
+    {
+      state.m_iSamplingInterval = iSamplingInterval;
+      state.m_iBytesUntilNextSample = DrawBytesUntilNextSample(state);
+    }
+
+    state.m_iBytesUntilNextSample -= static_cast<ezInt64>(uiSize);
+    if (state.m_iBytesUntilNextSample > 0)
+    {
+      GetAllocatorData(allocatorId).m_iNumUntrackedAllocations.Increment();
+      return;
+    }
+
+    state.m_iBytesUntilNextSample = DrawBytesUntilNextSample(state);
+
+    // Every byte is sampled with the same probability, so an allocation is sampled with 1 - e^(-size / interval).
+    // Weighting the sampled allocations with the inverse of that probability makes the sums unbiased estimates of the real values.
+    const double fProbability = -std::expm1(-static_cast<double>(uiSize) / iSamplingInterval);
+    uiEstimatedSize = static_cast<ezUInt64>(uiSize / fProbability + 0.5);
+    iEstimatedCount = static_cast<ezInt64>(s_iCountScale / fProbability + 0.5);
+    allocationTime = allocationTime * (1.0 / fProbability);
+  }
+
   ezArrayPtr<void*> stackTrace;
   if (flags.IsSet(ezMemoryTrackingFlags::EnableStackTrace))
   {
@@ -203,72 +353,98 @@ void ezMemoryTracker::AddAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemo
     ezMemoryUtils::Copy(stackTrace.GetPtr(), pBuffer, uiNumTraces);
   }
 
-  {
-    EZ_LOCK(*s_pTrackerData);
+  AllocatorData& data = GetAllocatorData(allocatorId);
+  EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
 
-    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-    data.m_Stats.m_uiNumAllocations++;
-    data.m_Stats.m_uiAllocationSize += uiSize;
-    data.m_Stats.m_uiPerFrameAllocationSize += uiSize;
-    data.m_Stats.m_PerFrameAllocationTime += allocationTime;
+  data.m_iNumAllocations.Add(iEstimatedCount);
+  data.m_iAllocationSize.Add(static_cast<ezInt64>(uiEstimatedSize));
+  data.m_iPerFrameAllocationSize.Add(static_cast<ezInt64>(uiEstimatedSize));
+  data.m_iPerFrameAllocationTimeNs.Add(static_cast<ezInt64>(allocationTime.GetNanoseconds()));
 
-    EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
-    auto pInfo = &data.m_Allocations[pPtr];
-    pInfo->m_uiSize = uiSize;
-    pInfo->m_uiAlignment = (ezUInt16)uiAlign;
-    pInfo->SetStackTrace(stackTrace);
+  {
+    AllocationShard& shard = data.GetShard(pPtr);
+    EZ_LOCK(shard.m_Mutex);
+
+    auto pAllocation = &shard.m_Allocations[pPtr];
+    pAllocation->m_Info.m_uiSize = uiSize;
+    pAllocation->m_Info.m_uiAlignment = (ezUInt16)uiAlign;
+    pAllocation->m_Info.SetStackTrace(stackTrace);
+    pAllocation->m_uiEstimatedSize = uiEstimatedSize;
+    pAllocation->m_iEstimatedCount = iEstimatedCount;
   }
 }
 
 // static
 void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pPtr)
 {
-  ezArrayPtr<void*> stackTrace;
+  AllocatorData& data = GetAllocatorData(allocatorId);
+
+  TrackedAllocation allocation;
+  bool bFound = false;
 
   {
-    EZ_LOCK(*s_pTrackerData);
+    AllocationShard& shard = data.GetShard(pPtr);
+    EZ_LOCK(shard.m_Mutex);
 
-    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+    bFound = shard.m_Allocations.Remove(pPtr, &allocation);
+  }
 
-    AllocationInfo info;
-    if (data.m_Allocations.Remove(pPtr, &info))
-    {
-      data.m_Stats.m_uiNumDeallocations++;
-      data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
+  if (bFound)
+  {
+    data.m_iNumDeallocations.Add(allocation.m_iEstimatedCount);
+    data.m_iAllocationSize.Subtract(static_cast<ezInt64>(allocation.m_uiEstimatedSize));
 
-      stackTrace = info.GetStackTrace();
+    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, allocation.m_Info.GetStackTrace());
+  }
+  else
+  {
+    // an unknown pointer is only fine as long as there are allocations that were skipped in sampling mode and not yet deallocated
+    // once all of them are gone, invalid deallocations are detected again
+    ezInt64 iNumUntracked = data.m_iNumUntrackedAllocations;
+    while (iNumUntracked > 0 && !data.m_iNumUntrackedAllocations.TestAndSet(iNumUntracked, iNumUntracked - 1))
+    {
+      iNumUntracked = data.m_iNumUntrackedAllocations;
     }
-    else
+
+    if (iNumUntracked <= 0)
     {
       EZ_REPORT_FAILURE("Invalid Allocation '{0}'. Memory corruption?", ezArgP(pPtr));
     }
   }
-
-  EZ_DELETE_ARRAY(s_pTrackerDataAllocator, stackTrace);
 }
 
 // static
 void ezMemoryTracker::RemoveAllAllocations(ezAllocatorId allocatorId)
 {
-  EZ_LOCK(*s_pTrackerData);
-  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-  for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
+  AllocatorData& data = GetAllocatorData(allocatorId);
+
+  for (AllocationShard& shard : data.m_Shards)
   {
-    auto& info = it.Value();
-    data.m_Stats.m_uiNumDeallocations++;
-    data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
+    EZ_LOCK(shard.m_Mutex);
 
-    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, info.GetStackTrace());
+    for (auto it = shard.m_Allocations.GetIterator(); it.IsValid(); ++it)
+    {
+      auto& allocation = it.Value();
+      data.m_iNumDeallocations.Add(allocation.m_iEstimatedCount);
+      data.m_iAllocationSize.Subtract(static_cast<ezInt64>(allocation.m_uiEstimatedSize));
+
+      EZ_DELETE_ARRAY(s_pTrackerDataAllocator, allocation.m_Info.GetStackTrace());
+    }
+    shard.m_Allocations.Clear();
   }
-  data.m_Allocations.Clear();
+
+  data.m_iNumUntrackedAllocations = 0;
 }
 
 // static
 void ezMemoryTracker::SetAllocatorStats(ezAllocatorId allocatorId, const ezAllocatorBase::Stats& stats)
 {
-  EZ_LOCK(*s_pTrackerData);
-
-  s_pTrackerData->m_AllocatorData[allocatorId].m_Stats = stats;
+  AllocatorData& data = GetAllocatorData(allocatorId);
+  data.m_iNumAllocations = static_cast<ezInt64>(stats.m_uiNumAllocations) * s_iCountScale;
+  data.m_iNumDeallocations = static_cast<ezInt64>(stats.m_uiNumDeallocations) * s_iCountScale;
+  data.m_iAllocationSize = static_cast<ezInt64>(stats.m_uiAllocationSize);
+  data.m_iPerFrameAllocationSize = static_cast<ezInt64>(stats.m_uiPerFrameAllocationSize);
+  data.m_iPerFrameAllocationTimeNs = static_cast<ezInt64>(stats.m_PerFrameAllocationTime.GetNanoseconds());
 }
 
 // static
@@ -278,61 +454,79 @@ void ezMemoryTracker::ResetPerFrameAllocatorStats()
 
   for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
   {
-    AllocatorData& data = it.Value();
-    data.m_Stats.m_uiPerFrameAllocationSize = 0;
-    data.m_Stats.m_PerFrameAllocationTime = ezTime::MakeZero();
+    AllocatorData* pData = it.Value();
+    pData->m_iPerFrameAllocationSize = 0;
+    pData->m_iPerFrameAllocationTimeNs = 0;
   }
 }
 
 // static
 ezStringView ezMemoryTracker::GetAllocatorName(ezAllocatorId allocatorId)
 {
-  EZ_LOCK(*s_pTrackerData);
-
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_sName;
+  return GetAllocatorData(allocatorId).m_sName;
 }
 
 // static
-const ezAllocatorBase::Stats& ezMemoryTracker::GetAllocatorStats(ezAllocatorId allocatorId)
+ezAllocatorBase::Stats ezMemoryTracker::GetAllocatorStats(ezAllocatorId allocatorId)
 {
-  EZ_LOCK(*s_pTrackerData);
-
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_Stats;
+  return GetAllocatorData(allocatorId).GetStats();
 }
 
 // static
 ezAllocatorId ezMemoryTracker::GetAllocatorParentId(ezAllocatorId allocatorId)
 {
-  EZ_LOCK(*s_pTrackerData);
-
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_ParentId;
+  return GetAllocatorData(allocatorId).m_ParentId;
 }
 
 // static
 const ezMemoryTracker::AllocationInfo& ezMemoryTracker::GetAllocationInfo(ezAllocatorId allocatorId, const void* pPtr)
 {
-  EZ_LOCK(*s_pTrackerData);
+  AllocatorData& data = GetAllocatorData(allocatorId);
+  AllocationShard& shard = data.GetShard(pPtr);
+  EZ_LOCK(shard.m_Mutex);
 
-  const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-  const AllocationInfo* info = nullptr;
-  if (data.m_Allocations.TryGetValue(pPtr, info))
+  const TrackedAllocation* pAllocation = nullptr;
+  if (shard.m_Allocations.TryGetValue(pPtr, pAllocation))
   {
-    return *info;
+    return pAllocation->m_Info;
   }
 
   static AllocationInfo invalidInfo;
 
-  EZ_REPORT_FAILURE("Could not find info for allocation {0}", ezArgP(pPtr));
+  if (data.m_iNumUntrackedAllocations == 0)
+  {
+    EZ_REPORT_FAILURE("Could not find info for allocation {0}", ezArgP(pPtr));
+  }
+
   return invalidInfo;
 }
 
+// static
+void ezMemoryTracker::SetSamplingInterval(ezUInt32 uiAverageBytesBetweenSamples)
+{
+  Initialize();
+
+  EZ_ASSERT_DEV(uiAverageBytesBetweenSamples <= 0x7FFFFFFF, "Sampling interval is too large");
+
+  s_pTrackerData->m_iSamplingInterval = static_cast<ezInt32>(uiAverageBytesBetweenSamples);
+}
+
+// static
+ezUInt32 ezMemoryTracker::GetSamplingInterval()
+{
+  if (s_pTrackerData == nullptr)
+    return 0;
+
+  return static_cast<ezUInt32>(s_pTrackerData->m_iSamplingInterval);
+}
+
 
 struct LeakInfo
 {
   EZ_DECLARE_POD_TYPE();
 
   ezAllocatorId m_AllocatorId;
-  size_t m_uiSize = 0;
+  ezMemoryTracker::AllocationInfo m_Info;
   const void* m_pParentLeak = nullptr;
 
   EZ_ALWAYS_INLINE bool IsRootLeak() const { return m_pParentLeak == nullptr && m_AllocatorId != s_pTrackerData->m_StaticAllocatorId; }
@@ -351,15 +545,19 @@ void ezMemoryTracker::DumpMemoryLeaks()
   // first collect all leaks
   for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
   {
-    const AllocatorData& data = it.Value();
-    for (auto it2 = data.m_Allocations.GetIterator(); it2.IsValid(); ++it2)
+    for (AllocationShard& shard : it.Value()->m_Shards)
     {
-      LeakInfo leak;
-      leak.m_AllocatorId = it.Id();
-      leak.m_uiSize = it2.Value().m_uiSize;
-      leak.m_pParentLeak = nullptr;
+      EZ_LOCK(shard.m_Mutex);
+
+      for (auto it2 = shard.m_Allocations.GetIterator(); it2.IsValid(); ++it2)
+      {
+        LeakInfo leak;
+        leak.m_AllocatorId = it.Id();
+        leak.m_Info = it2.Value().m_Info;
+        leak.m_pParentLeak = nullptr;
 
-      leakTable.Insert(it2.Key(), leak);
+        leakTable.Insert(it2.Key(), leak);
+      }
     }
   }
 
@@ -370,7 +568,7 @@ void ezMemoryTracker::DumpMemoryLeaks()
     const LeakInfo& leak = it.Value();
 
     const void* curPtr = ptr;
-    const void* endPtr = ezMemoryUtils::AddByteOffset(ptr, leak.m_uiSize);
+    const void* endPtr = ezMemoryUtils::AddByteOffset(ptr, leak.m_Info.m_uiSize);
 
     while (curPtr < endPtr)
     {
@@ -391,7 +589,6 @@ void ezMemoryTracker::DumpMemoryLeaks()
 
   for (auto it = leakTable.GetIterator(); it.IsValid(); ++it)
   {
-    const void* ptr = it.Key();
     const LeakInfo& leak = it.Value();
 
     if (leak.IsRootLeak())
@@ -403,11 +600,7 @@ void ezMemoryTracker::DumpMemoryLeaks()
                      "\n--------------------------------------------------------------------\n\n");
       }
 
-      const AllocatorData& data = s_pTrackerData->m_AllocatorData[leak.m_AllocatorId];
-      ezMemoryTracker::AllocationInfo info;
-      data.m_Allocations.TryGetValue(ptr, info);
-
-      DumpLeak(info, data.m_sName.GetData());
+      DumpLeak(leak.m_Info, GetAllocatorData(leak.m_AllocatorId).m_sName.GetData());
 
       ++uiNumLeaks;
     }
@@ -424,6 +617,131 @@ void ezMemoryTracker::DumpMemoryLeaks()
   }
 }
 
+
+struct HeapReportCallStack
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezAllocatorId m_AllocatorId;
+  ezUInt32 m_uiFirstFrame = 0;
+  ezUInt32 m_uiNumFrames = 0;
+  ezUInt64 m_uiEstimatedSize = 0;
+  ezInt64 m_iEstimatedCount = 0;
+};
+
+struct HeapReportCallStackComparer
+{
+  EZ_ALWAYS_INLINE bool Less(const HeapReportCallStack& a, const HeapReportCallStack& b) const { return a.m_uiEstimatedSize > b.m_uiEstimatedSize; }
+};
+
+// static
+void ezMemoryTracker::DumpHeapReport(ezUInt32 uiMaxCallStacks)
+{
+  if (s_pTrackerData == nullptr)
+    return;
+  EZ_LOCK(*s_pTrackerData);
+
+  const ezUInt32 uiSamplingInterval = GetSamplingInterval();
+
+  ezLog::Print("\n\n--------------------------------------------------------------------\n"
+               "Heap Report:"
+               "\n--------------------------------------------------------------------\n\n");
+
+  if (uiSamplingInterval != 0)
+  {
+    ezLog::Printf("Sampling one allocation per %u bytes, all numbers are estimates.\n\n", uiSamplingInterval);
+  }
+
+  // live memory per allocator
+  ezUInt64 uiTotalSize = 0;
+  for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
+  {
+    const AllocatorData* pData = it.Value();
+    const ezAllocatorBase::Stats stats = pData->GetStats();
+    if (stats.m_uiAllocationSize == 0)
+      continue;
+
+    ezLog::Printf("%-40s %14llu bytes in %10llu allocation(s)\n", pData->m_sName.GetData(), stats.m_uiAllocationSize,
+      stats.m_uiNumAllocations - stats.m_uiNumDeallocations);
+
+    uiTotalSize += stats.m_uiAllocationSize;
+  }
+
+  ezLog::Printf("\nTotal: %llu bytes\n\n", uiTotalSize);
+
+  if (uiMaxCallStacks == 0)
+    return;
+
+  // group the tracked allocations by allocator and call stack, the frames are copied so that no shard has to stay locked while printing
+  static ezHashTable<ezUInt64, HeapReportCallStack, ezHashHelper<ezUInt64>, TrackerDataAllocatorWrapper> callStackTable;
+  static ezDynamicArray<void*, TrackerDataAllocatorWrapper> frames;
+  callStackTable.Clear();
+  frames.Clear();
+
+  for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
+  {
+    const ezAllocatorId allocatorId = it.Id();
+
+    for (AllocationShard& shard : it.Value()->m_Shards)
+    {
+      EZ_LOCK(shard.m_Mutex);
+
+      for (auto it2 = shard.m_Allocations.GetIterator(); it2.IsValid(); ++it2)
+      {
+        const TrackedAllocation& allocation = it2.Value();
+        const ezArrayPtr<void*> stackTrace = allocation.m_Info.GetStackTrace();
+        if (stackTrace.IsEmpty())
+          continue;
+
+        const ezUInt64 uiHash = ezHashingUtils::xxHash64(stackTrace.GetPtr(), stackTrace.GetCount() * sizeof(void*), allocatorId.m_Data);
+
+        bool bExisted = false;
+        HeapReportCallStack& callStack = callStackTable.FindOrAdd(uiHash, &bExisted);
+        if (!bExisted)
+        {
+          callStack.m_AllocatorId = allocatorId;
+          callStack.m_uiFirstFrame = frames.GetCount();
+          callStack.m_uiNumFrames = stackTrace.GetCount();
+          frames.PushBackRange(stackTrace);
+        }
+
+        callStack.m_uiEstimatedSize += allocation.m_uiEstimatedSize;
+        callStack.m_iEstimatedCount += allocation.m_iEstimatedCount;
+      }
+    }
+  }
+
+  if (callStackTable.IsEmpty())
+  {
+    ezLog::Print("No call stacks recorded, use ezMemoryTrackingFlags::EnableStackTrace to get them.\n\n");
+    return;
+  }
+
+  static ezDynamicArray<HeapReportCallStack, TrackerDataAllocatorWrapper> callStacks;
+  callStacks.Clear();
+  for (auto it = callStackTable.GetIterator(); it.IsValid(); ++it)
+  {
+    callStacks.PushBack(it.Value());
+  }
+
+  callStacks.Sort(HeapReportCallStackComparer());
+
+  const ezUInt32 uiNumCallStacks = ezMath::Min(uiMaxCallStacks, callStacks.GetCount());
+  ezLog::Printf("Top %u of %u call stack(s):\n\n", uiNumCallStacks, callStacks.GetCount());
+
+  for (ezUInt32 i = 0; i < uiNumCallStacks; ++i)
+  {
+    const HeapReportCallStack& callStack = callStacks[i];
+
+    ezLog::Printf("%llu bytes in %lld allocation(s) by '%s'\n", callStack.m_uiEstimatedSize, (callStack.m_iEstimatedCount + s_iCountScale / 2) / s_iCountScale,
+      GetAllocatorData(callStack.m_AllocatorId).m_sName.GetData());
+
+    ezStackTracer::ResolveStackTrace(frames.GetArrayPtr().GetSubArray(callStack.m_uiFirstFrame, callStack.m_uiNumFrames), &ezLog::Print);
+
+    ezLog::Print("--------------------------------------------------------------------\n\n");
+  }
+}
+
 // static
 ezMemoryTracker::Iterator ezMemoryTracker::GetIterator()
 {
@@ -1,6 +1,9 @@
 
 #include <Foundation/Time/Time.h>
 
+#include <errno.h>
+#include <sys/mman.h>
+
 // static
 void* ezPageAllocator::AllocatePage(size_t uiSize)
 {
@@ -32,3 +35,39 @@ void ezPageAllocator::DeallocatePage(void* ptr)
 
   free(ptr);
 }
+
+// static
+void* ezPageAllocator::ReserveAddressSpace(size_t uiSize)
+{
+  EZ_ASSERT_DEBUG(uiSize % ezSystemInformation::Get().GetMemoryPageSize() == 0, "Size must be a multiple of the page size");
+
+  void* ptr = mmap(nullptr, uiSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (ptr == MAP_FAILED)
+    return nullptr;
+
+  return ptr;
+}
+
+// static
+void ezPageAllocator::ReleaseAddressSpace(void* pPtr, size_t uiSize)
+{
+  EZ_VERIFY(munmap(pPtr, uiSize) == 0, "Could not release address space. Error Code '{0}'", errno);
+}
+
+// static
+void ezPageAllocator::CommitPages(void* pPtr, size_t uiSize)
+{
+  EZ_CHECK_ALIGNMENT(pPtr, ezSystemInformation::Get().GetMemoryPageSize());
+
+  EZ_VERIFY(mprotect(pPtr, uiSize, PROT_READ | PROT_WRITE) == 0, "Could not commit memory pages. Error Code '{0}'", errno);
+}
+
+// static
+void ezPageAllocator::DecommitPages(void* pPtr, size_t uiSize)
+{
+  EZ_CHECK_ALIGNMENT(pPtr, ezSystemInformation::Get().GetMemoryPageSize());
+
+  // MADV_DONTNEED hands the physical pages back immediately and guarantees zero filled pages when they are committed again
+  EZ_VERIFY(madvise(pPtr, uiSize, MADV_DONTNEED) == 0, "Could not decommit memory pages. Error Code '{0}'", errno);
+  EZ_VERIFY(mprotect(pPtr, uiSize, PROT_NONE) == 0, "Could not decommit memory pages. Error Code '{0}'", errno);
+}
@@ -0,0 +1,230 @@
+#include <Foundation/Memory/PageAllocator.h>
+#include <Foundation/System/SystemInformation.h>
+
+template <typename T>
+EZ_FORCE_INLINE ezVirtualPool<T>::ConstIterator::ConstIterator(const ezVirtualPool<T>& pool)
+  : m_Pool(pool)
+{
+  while (m_uiCurrentIndex < m_Pool.m_uiUsedSlots && !m_Pool.m_UsedEntries.IsBitSet(m_uiCurrentIndex))
+  {
+    ++m_uiCurrentIndex;
+  }
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE T& ezVirtualPool<T>::ConstIterator::CurrentElement() const
+{
+  return *m_Pool.GetSlot(m_uiCurrentIndex);
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE const T& ezVirtualPool<T>::ConstIterator::operator*() const
+{
+  return CurrentElement();
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE const T* ezVirtualPool<T>::ConstIterator::operator->() const
+{
+  return &CurrentElement();
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE ezVirtualPool<T>::ConstIterator::operator const T*() const
+{
+  return &CurrentElement();
+}
+
+template <typename T>
+EZ_FORCE_INLINE void ezVirtualPool<T>::ConstIterator::Next()
+{
+  ++m_uiCurrentIndex;
+
+  while (m_uiCurrentIndex < m_Pool.m_uiUsedSlots && !m_Pool.m_UsedEntries.IsBitSet(m_uiCurrentIndex))
+  {
+    ++m_uiCurrentIndex;
+  }
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE bool ezVirtualPool<T>::ConstIterator::IsValid() const
+{
+  return m_uiCurrentIndex < m_Pool.m_uiUsedSlots;
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE void ezVirtualPool<T>::ConstIterator::operator++()
+{
+  Next();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+EZ_FORCE_INLINE ezVirtualPool<T>::Iterator::Iterator(const ezVirtualPool<T>& pool)
+  : ConstIterator(pool)
+{
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE T& ezVirtualPool<T>::Iterator::operator*()
+{
+  return this->CurrentElement();
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE T* ezVirtualPool<T>::Iterator::operator->()
+{
+  return &this->CurrentElement();
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE ezVirtualPool<T>::Iterator::operator T*()
+{
+  return &this->CurrentElement();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+ezVirtualPool<T>::ezVirtualPool(ezUInt32 uiMaxCount)
+  : m_uiMaxCount(uiMaxCount)
+{
+  EZ_CHECK_AT_COMPILETIME_MSG(EZ_ALIGNMENT_OF(T) <= 4096, "Objects must not need a larger alignment than a memory page");
+
+  const size_t uiPageSize = ezSystemInformation::Get().GetMemoryPageSize();
+  m_uiReservedBytes = ezMemoryUtils::AlignSize<size_t>(static_cast<size_t>(uiMaxCount) * SlotSize, uiPageSize);
+
+  if (m_uiReservedBytes > 0)
+  {
+    m_pSlots = static_cast<ezUInt8*>(ezPageAllocator::ReserveAddressSpace(m_uiReservedBytes));
+
+    if (m_pSlots == nullptr)
+    {
+      m_uiReservedBytes = 0;
+      m_uiMaxCount = 0;
+    }
+  }
+}
+
+template <typename T>
+ezVirtualPool<T>::~ezVirtualPool()
+{
+  Clear();
+
+  if (m_pSlots != nullptr)
+  {
+    ezPageAllocator::ReleaseAddressSpace(m_pSlots, m_uiReservedBytes);
+    m_pSlots = nullptr;
+  }
+}
+
+template <typename T>
+void ezVirtualPool<T>::Clear()
+{
+  for (auto it = GetIterator(); it.IsValid(); ++it)
+  {
+    ezMemoryUtils::Destruct(&(*it), 1);
+  }
+
+  m_uiCount = 0;
+  m_uiUsedSlots = 0;
+  m_uiFreelistStart = ezInvalidIndex;
+  m_UsedEntries.Clear();
+}
+
+template <typename T>
+template <typename... Args>
+T* ezVirtualPool<T>::Create(Args&&... args)
+{
+  ezUInt32 uiIndex = m_uiFreelistStart;
+
+  if (uiIndex != ezInvalidIndex)
+  {
+    m_uiFreelistStart = GetNextFreeSlot(uiIndex);
+  }
+  else
+  {
+    EZ_ASSERT_ALWAYS(m_pSlots != nullptr, "The virtual pool could not reserve its address space, cannot create any objects.");
+    EZ_ASSERT_DEV(m_uiUsedSlots < m_uiMaxCount, "The virtual pool has a maximum capacity of {0} objects.", m_uiMaxCount);
+
+    uiIndex = m_uiUsedSlots++;
+
+    const size_t uiNeededBytes = static_cast<size_t>(m_uiUsedSlots) * SlotSize;
+    if (uiNeededBytes > m_uiCommittedBytes)
+    {
+      size_t uiNewCommittedBytes = ezMemoryUtils::AlignSize<size_t>(uiNeededBytes, COMMIT_GRANULARITY);
+      uiNewCommittedBytes = ezMath::Min(uiNewCommittedBytes, m_uiReservedBytes);
+
+      ezPageAllocator::CommitPages(m_pSlots + m_uiCommittedBytes, uiNewCommittedBytes - m_uiCommittedBytes);
+      m_uiCommittedBytes = uiNewCommittedBytes;
+    }
+
+    m_UsedEntries.SetCount(m_uiUsedSlots);
+  }
+
+  m_UsedEntries.SetBit(uiIndex);
+  ++m_uiCount;
+
+  return new (GetSlot(uiIndex)) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void ezVirtualPool<T>::Delete(T* pObject)
+{
+  const ezUInt32 uiIndex = GetIndex(pObject);
+  EZ_ASSERT_DEV(m_UsedEntries.IsBitSet(uiIndex), "Object was already deleted");
+
+  ezMemoryUtils::Destruct(pObject, 1);
+
+  m_UsedEntries.ClearBit(uiIndex);
+  GetNextFreeSlot(uiIndex) = m_uiFreelistStart;
+  m_uiFreelistStart = uiIndex;
+
+  --m_uiCount;
+}
+
+template <typename T>
+EZ_FORCE_INLINE ezUInt32 ezVirtualPool<T>::GetIndex(const T* pObject) const
+{
+  const size_t uiOffset = reinterpret_cast<const ezUInt8*>(pObject) - m_pSlots;
+  EZ_ASSERT_DEBUG(reinterpret_cast<const ezUInt8*>(pObject) >= m_pSlots && uiOffset < m_uiUsedSlots * SlotSize && uiOffset % SlotSize == 0, "Object is not part of this pool");
+
+  return static_cast<ezUInt32>(uiOffset / SlotSize);
+}
+
+template <typename T>
+EZ_FORCE_INLINE T* ezVirtualPool<T>::GetObject(ezUInt32 uiIndex)
+{
+  return uiIndex < m_uiUsedSlots && m_UsedEntries.IsBitSet(uiIndex) ? GetSlot(uiIndex) : nullptr;
+}
+
+template <typename T>
+EZ_FORCE_INLINE const T* ezVirtualPool<T>::GetObject(ezUInt32 uiIndex) const
+{
+  return uiIndex < m_uiUsedSlots && m_UsedEntries.IsBitSet(uiIndex) ? GetSlot(uiIndex) : nullptr;
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE typename ezVirtualPool<T>::Iterator ezVirtualPool<T>::GetIterator()
+{
+  return Iterator(*this);
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE typename ezVirtualPool<T>::ConstIterator ezVirtualPool<T>::GetIterator() const
+{
+  return ConstIterator(*this);
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE T* ezVirtualPool<T>::GetSlot(ezUInt32 uiIndex) const
+{
+  return reinterpret_cast<T*>(m_pSlots + static_cast<size_t>(uiIndex) * SlotSize);
+}
+
+template <typename T>
+EZ_ALWAYS_INLINE ezUInt32& ezVirtualPool<T>::GetNextFreeSlot(ezUInt32 uiIndex)
+{
+  return *reinterpret_cast<ezUInt32*>(m_pSlots + static_cast<size_t>(uiIndex) * SlotSize);
+}
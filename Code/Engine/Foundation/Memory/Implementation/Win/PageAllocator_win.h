@@ -33,3 +33,34 @@ void ezPageAllocator::DeallocatePage(void* pPtr)
 
   EZ_VERIFY(::VirtualFree(pPtr, 0, MEM_RELEASE), "Could not free memory pages. Error Code '{0}'", ezArgErrorCode(::GetLastError()));
 }
+
+// static
+void* ezPageAllocator::ReserveAddressSpace(size_t uiSize)
+{
+  EZ_ASSERT_DEBUG(uiSize % ezSystemInformation::Get().GetMemoryPageSize() == 0, "Size must be a multiple of the page size");
+
+  return ::VirtualAlloc(nullptr, uiSize, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+// static
+void ezPageAllocator::ReleaseAddressSpace(void* pPtr, size_t uiSize)
+{
+  EZ_IGNORE_UNUSED(uiSize);
+  EZ_VERIFY(::VirtualFree(pPtr, 0, MEM_RELEASE), "Could not release address space. Error Code '{0}'", ezArgErrorCode(::GetLastError()));
+}
+
+// static
+void ezPageAllocator::CommitPages(void* pPtr, size_t uiSize)
+{
+  EZ_CHECK_ALIGNMENT(pPtr, ezSystemInformation::Get().GetMemoryPageSize());
+
+  EZ_VERIFY(::VirtualAlloc(pPtr, uiSize, MEM_COMMIT, PAGE_READWRITE) != nullptr, "Could not commit memory pages. Error Code '{0}'", ezArgErrorCode(::GetLastError()));
+}
+
+// static
+void ezPageAllocator::DecommitPages(void* pPtr, size_t uiSize)
+{
+  EZ_CHECK_ALIGNMENT(pPtr, ezSystemInformation::Get().GetMemoryPageSize());
+
+  EZ_VERIFY(::VirtualFree(pPtr, uiSize, MEM_DECOMMIT), "Could not decommit memory pages. Error Code '{0}'", ezArgErrorCode(::GetLastError()));
+}
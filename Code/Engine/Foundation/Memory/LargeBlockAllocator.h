@@ -53,7 +53,7 @@ public:
 
   ezAllocatorId GetId() const;
 
-  const ezAllocatorBase::Stats& GetStats() const;
+  ezAllocatorBase::Stats GetStats() const;
 
 private:
   void* Allocate(size_t uiAlign);
@@ -40,6 +40,14 @@ struct ezMemoryTrackingFlags
 #define EZ_STATIC_ALLOCATOR_NAME "Statics"
 
 /// \brief Memory tracker which keeps track of all allocations and constructions
+///
+/// Live allocations are distributed over several independently locked shards by their address, and the per allocator stats are
+/// updated with atomic operations, so allocations on different threads rarely have to wait for each other.
+///
+/// By default every allocation is tracked. With SetSamplingInterval() the tracker switches to a statistical mode in which only
+/// about one allocation per given number of bytes is recorded, including its stack trace. Every sampled allocation then stands in for
+/// all the allocations that were skipped in between: The stats of an allocator and the heap report contain unbiased estimates
+/// of the real numbers instead of exact values. This makes it cheap enough to leave allocation tracking enabled permanently.
 class EZ_FOUNDATION_DLL ezMemoryTracker
 {
 public:
@@ -76,7 +84,7 @@ public:
     ezAllocatorId Id() const;
     ezStringView Name() const;
     ezAllocatorId ParentId() const;
-    const ezAllocatorBase::Stats& Stats() const;
+    ezAllocatorBase::Stats Stats() const;
 
     void Next();
     bool IsValid() const;
@@ -106,11 +114,27 @@ public:
   static void ResetPerFrameAllocatorStats();
 
   static ezStringView GetAllocatorName(ezAllocatorId allocatorId);
-  static const ezAllocatorBase::Stats& GetAllocatorStats(ezAllocatorId allocatorId);
+  static ezAllocatorBase::Stats GetAllocatorStats(ezAllocatorId allocatorId);
   static ezAllocatorId GetAllocatorParentId(ezAllocatorId allocatorId);
   static const AllocationInfo& GetAllocationInfo(ezAllocatorId allocatorId, const void* pPtr);
 
   static void DumpMemoryLeaks();
 
+  /// \brief Prints the live memory of all allocators and the call stacks that hold on to the most memory.
+  ///
+  /// Call stacks are only available for allocators that use ezMemoryTrackingFlags::EnableStackTrace.
+  /// In sampling mode all numbers are estimates.
+  static void DumpHeapReport(ezUInt32 uiMaxCallStacks = 10);
+
+  /// \brief Switches between tracking every allocation (0, the default) and tracking on average one allocation per the given number of bytes.
+  ///
+  /// Allocations that are not sampled only update a thread local byte counter and a per allocator counter, no stack trace is captured and nothing is locked.
+  /// Allocations that were not tracked can't be queried with GetAllocationInfo() and can't be reported as leaks, so this is meant for long running
+  /// profiling sessions rather than for leak checks. Invalid deallocations are only detected again once all untracked allocations of an allocator were freed.
+  static void SetSamplingInterval(ezUInt32 uiAverageBytesBetweenSamples);
+
+  /// \brief Returns the value that was passed to SetSamplingInterval(). Zero, if every allocation is tracked.
+  static ezUInt32 GetSamplingInterval();
+
   static Iterator GetIterator();
 };
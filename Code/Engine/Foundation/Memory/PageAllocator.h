@@ -3,11 +3,30 @@
 #include <Foundation/Basics.h>
 
 /// \brief This helper class can reserve and allocate whole memory pages.
+///
+/// Besides allocating committed pages, it can reserve a range of address space up front and back parts of it with memory later.
+/// Containers built on top of that, like ezVirtualArray and ezVirtualPool, can grow without ever moving their elements.
 class EZ_FOUNDATION_DLL ezPageAllocator
 {
 public:
   static void* AllocatePage(size_t uiSize);
   static void DeallocatePage(void* pPtr);
 
+  /// \brief Reserves a contiguous range of address space without backing it with memory.
+  ///
+  /// The size must be a multiple of the memory page size. The range can't be accessed until parts of it have been committed with CommitPages().
+  /// Reserved address space is not reported to the memory tracker, since it doesn't occupy any memory by itself.
+  /// Returns nullptr if the address space could not be reserved, e.g. because the process is running out of it.
+  static void* ReserveAddressSpace(size_t uiSize);
+
+  /// \brief Releases a range that was reserved with ReserveAddressSpace(), including all its committed pages.
+  static void ReleaseAddressSpace(void* pPtr, size_t uiSize);
+
+  /// \brief Backs the given page aligned part of a reserved range with zero initialized, readable and writable memory.
+  static void CommitPages(void* pPtr, size_t uiSize);
+
+  /// \brief Returns the memory of the given page aligned part of a reserved range to the OS. The address range itself stays reserved.
+  static void DecommitPages(void* pPtr, size_t uiSize);
+
   static ezAllocatorId GetId();
 };
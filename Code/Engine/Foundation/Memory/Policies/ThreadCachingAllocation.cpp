@@ -0,0 +1,446 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Memory/Policies/AlignedHeapAllocation.h>
+#include <Foundation/Memory/Policies/ThreadCachingAllocation.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+
+#include <atomic>
+
+namespace
+{
+  // Size classes: 16 byte steps up to 256 bytes, 64 byte steps up to 1 KB and 512 byte steps up to 8 KB.
+  constexpr ezUInt32 TC_NUM_SIZE_CLASSES = 16 + 12 + 14;
+  static_assert(ezMemoryPolicies::ezThreadCachingAllocation::MaxSmallSize == 8192, "The size classes need to be adjusted.");
+
+  constexpr ezUInt32 TC_SPAN_SIZE_SHIFT = 16;
+  constexpr size_t TC_SPAN_SIZE = size_t(1) << TC_SPAN_SIZE_SHIFT;
+
+  /// Spans are cut out of chunks of this many spans, which are requested from the heap at once.
+  constexpr size_t TC_SPANS_PER_CHUNK = 32;
+
+  /// Roughly how many bytes are moved between a thread cache and a central heap at once.
+  constexpr size_t TC_BATCH_BYTES = 16 * 1024;
+
+  EZ_ALWAYS_INLINE ezUInt32 TcGetSizeClass(size_t uiSize)
+  {
+    if (uiSize <= 256)
+      return static_cast<ezUInt32>((uiSize - 1) >> 4);
+
+    if (uiSize <= 1024)
+      return 16 + static_cast<ezUInt32>((uiSize - 257) >> 6);
+
+    return 28 + static_cast<ezUInt32>((uiSize - 1025) >> 9);
+  }
+
+  constexpr size_t TcGetClassSize(ezUInt32 uiSizeClass)
+  {
+    return uiSizeClass < 16 ? (uiSizeClass + 1) * 16 : (uiSizeClass < 28 ? 256 + (uiSizeClass - 15) * 64 : 1024 + (uiSizeClass - 27) * 512);
+  }
+
+  static_assert(TcGetClassSize(TC_NUM_SIZE_CLASSES - 1) == ezMemoryPolicies::ezThreadCachingAllocation::MaxSmallSize, "Invalid size classes.");
+
+  /// The number of blocks that are moved between a thread cache and a central heap at once.
+  constexpr ezUInt32 TcGetBatchCount(ezUInt32 uiSizeClass)
+  {
+    const size_t uiCount = TC_BATCH_BYTES / TcGetClassSize(uiSizeClass);
+
+    if (uiCount < 2)
+      return 2;
+
+    if (uiCount > 64)
+      return 64;
+
+    return static_cast<ezUInt32>(uiCount);
+  }
+
+  // Free blocks are linked through their first pointer. The first block of a batch additionally links to the next batch
+  // through its second pointer, which is why the smallest size class has to be able to hold two pointers.
+  static_assert(TcGetClassSize(0) >= 2 * sizeof(void*), "The smallest size class is too small.");
+
+  EZ_ALWAYS_INLINE void*& TcNext(void* pBlock)
+  {
+    return static_cast<void**>(pBlock)[0];
+  }
+
+  EZ_ALWAYS_INLINE void*& TcNextBatch(void* pBlock)
+  {
+    return static_cast<void**>(pBlock)[1];
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Page map
+
+  // Maps every span sized region of the address space to the size class of the span that occupies it.
+  // This way Deallocate() can tell spans and large allocations apart, without storing a header in front of every allocation.
+  constexpr ezUInt32 TC_ADDRESS_BITS = sizeof(void*) == 8 ? 48 : 32;
+  constexpr ezUInt32 TC_PAGEMAP_LEAF_BITS = 16;
+  constexpr ezUInt32 TC_PAGEMAP_ROOT_BITS = TC_ADDRESS_BITS - TC_SPAN_SIZE_SHIFT - TC_PAGEMAP_LEAF_BITS;
+
+  struct TcPageMapLeaf
+  {
+    /// The size class plus one for every span in the address range of the leaf. Zero for memory that doesn't belong to a span.
+    ezUInt8 m_SizeClass[size_t(1) << TC_PAGEMAP_LEAF_BITS];
+  };
+
+  // zero initialized, leaves are created on demand and never freed
+  std::atomic<TcPageMapLeaf*> s_TcPageMap[size_t(1) << TC_PAGEMAP_ROOT_BITS];
+
+  /// Returns the size class plus one, if the pointer belongs to a span, or zero otherwise.
+  EZ_ALWAYS_INLINE ezUInt32 TcLookupSizeClass(const void* pPtr)
+  {
+    const size_t uiRegion = reinterpret_cast<size_t>(pPtr) >> TC_SPAN_SIZE_SHIFT;
+    const size_t uiRoot = uiRegion >> TC_PAGEMAP_LEAF_BITS;
+
+    if (uiRoot >= EZ_ARRAY_SIZE(s_TcPageMap))
+      return 0;
+
+    const TcPageMapLeaf* pLeaf = s_TcPageMap[uiRoot].load(std::memory_order_acquire);
+
+    if (pLeaf == nullptr)
+      return 0;
+
+    return pLeaf->m_SizeClass[uiRegion & ((size_t(1) << TC_PAGEMAP_LEAF_BITS) - 1)];
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Central heaps
+
+  struct alignas(64) TcCentralHeap
+  {
+    ezMutex m_Mutex;
+    void* m_pFullBatches = nullptr; ///< Chains of exactly TcGetBatchCount() blocks.
+    void* m_pLooseBlocks = nullptr; ///< A chain of any length, e.g. from flushed thread caches.
+    ezUInt8* m_pSpanPos = nullptr;  ///< The part of the current span that has not been carved into blocks yet.
+    ezUInt8* m_pSpanEnd = nullptr;
+  };
+
+  struct TcCentralData
+  {
+    TcCentralHeap m_Heaps[TC_NUM_SIZE_CLASSES];
+
+    ezMutex m_ChunkMutex;
+    ezUInt8* m_pChunkPos = nullptr; ///< The spans of the current chunk that have not been handed out yet.
+    ezUInt8* m_pChunkEnd = nullptr;
+  };
+
+  TcCentralData& TcGetCentralData()
+  {
+    // never destroyed, blocks may still be freed while the process shuts down
+    alignas(TcCentralData) static ezUInt8 s_CentralDataBuffer[sizeof(TcCentralData)];
+    static TcCentralData* s_pCentralData = new (s_CentralDataBuffer) TcCentralData();
+
+    return *s_pCentralData;
+  }
+
+  /// Returns a new span for the given size class and registers it in the page map. Returns nullptr, if no memory is available.
+  ezUInt8* TcAllocateSpan(TcCentralData& ref_data, ezUInt32 uiSizeClass)
+  {
+    EZ_LOCK(ref_data.m_ChunkMutex);
+
+    if (ref_data.m_pChunkPos == ref_data.m_pChunkEnd)
+    {
+      // Chunks are internal to the policy and never freed, so they are taken from the untracked heap instead of ezPageAllocator.
+      // The allocations served from them are tracked by the ezAllocator that uses this policy.
+      const size_t uiChunkSize = TC_SPANS_PER_CHUNK * TC_SPAN_SIZE;
+      ezUInt8* pChunk = static_cast<ezUInt8*>(ezMemoryPolicies::ezAlignedHeapAllocation(nullptr).Allocate(uiChunkSize, TC_SPAN_SIZE));
+
+      if (pChunk == nullptr)
+        return nullptr;
+
+      if (((reinterpret_cast<size_t>(pChunk) + uiChunkSize - 1) >> (TC_SPAN_SIZE_SHIFT + TC_PAGEMAP_LEAF_BITS)) >= EZ_ARRAY_SIZE(s_TcPageMap))
+      {
+        // outside of the address range that the page map covers
+        ezMemoryPolicies::ezAlignedHeapAllocation(nullptr).Deallocate(pChunk);
+        return nullptr;
+      }
+
+      ref_data.m_pChunkPos = pChunk;
+      ref_data.m_pChunkEnd = pChunk + uiChunkSize;
+    }
+
+    ezUInt8* pSpan = ref_data.m_pChunkPos;
+    ref_data.m_pChunkPos += TC_SPAN_SIZE;
+
+    const size_t uiRegion = reinterpret_cast<size_t>(pSpan) >> TC_SPAN_SIZE_SHIFT;
+    std::atomic<TcPageMapLeaf*>& leafPtr = s_TcPageMap[uiRegion >> TC_PAGEMAP_LEAF_BITS];
+
+    // leaves are only created while m_ChunkMutex is locked
+    TcPageMapLeaf* pLeaf = leafPtr.load(std::memory_order_relaxed);
+    if (pLeaf == nullptr)
+    {
+      pLeaf = static_cast<TcPageMapLeaf*>(ezMemoryPolicies::ezAlignedHeapAllocation(nullptr).Allocate(sizeof(TcPageMapLeaf), EZ_ALIGNMENT_OF(TcPageMapLeaf)));
+
+      if (pLeaf == nullptr)
+        return nullptr;
+
+      ezMemoryUtils::ZeroFill(pLeaf, 1);
+      leafPtr.store(pLeaf, std::memory_order_release);
+    }
+
+    // the blocks of the span are handed out after this, so every thread that gets to see a block also sees its entry
+    pLeaf->m_SizeClass[uiRegion & ((size_t(1) << TC_PAGEMAP_LEAF_BITS) - 1)] = static_cast<ezUInt8>(uiSizeClass + 1);
+
+    return pSpan;
+  }
+
+  /// Takes up to one batch of blocks from the central heap. Returns the number of blocks in out_pBlocks.
+  ezUInt32 TcFetchBlocks(ezUInt32 uiSizeClass, void*& out_pBlocks)
+  {
+    TcCentralData& data = TcGetCentralData();
+    TcCentralHeap& heap = data.m_Heaps[uiSizeClass];
+    const ezUInt32 uiBatchCount = TcGetBatchCount(uiSizeClass);
+
+    EZ_LOCK(heap.m_Mutex);
+
+    if (heap.m_pFullBatches != nullptr)
+    {
+      out_pBlocks = heap.m_pFullBatches;
+      heap.m_pFullBatches = TcNextBatch(out_pBlocks);
+      return uiBatchCount;
+    }
+
+    out_pBlocks = nullptr;
+    void** ppTail = &out_pBlocks;
+    ezUInt32 uiCount = 0;
+
+    while (heap.m_pLooseBlocks != nullptr && uiCount < uiBatchCount)
+    {
+      void* pBlock = heap.m_pLooseBlocks;
+      heap.m_pLooseBlocks = TcNext(pBlock);
+
+      *ppTail = pBlock;
+      ppTail = &TcNext(pBlock);
+      ++uiCount;
+    }
+
+    const size_t uiClassSize = TcGetClassSize(uiSizeClass);
+
+    while (uiCount < uiBatchCount)
+    {
+      if (static_cast<size_t>(heap.m_pSpanEnd - heap.m_pSpanPos) < uiClassSize)
+      {
+        ezUInt8* pSpan = TcAllocateSpan(data, uiSizeClass);
+
+        if (pSpan == nullptr)
+          break;
+
+        heap.m_pSpanPos = pSpan;
+        heap.m_pSpanEnd = pSpan + TC_SPAN_SIZE;
+      }
+
+      void* pBlock = heap.m_pSpanPos;
+      heap.m_pSpanPos += uiClassSize;
+
+      *ppTail = pBlock;
+      ppTail = &TcNext(pBlock);
+      ++uiCount;
+    }
+
+    *ppTail = nullptr;
+    return uiCount;
+  }
+
+  /// Hands a chain of exactly TcGetBatchCount() blocks over to the central heap.
+  void TcReleaseBatch(ezUInt32 uiSizeClass, void* pBatch)
+  {
+    TcCentralHeap& heap = TcGetCentralData().m_Heaps[uiSizeClass];
+
+    EZ_LOCK(heap.m_Mutex);
+    TcNextBatch(pBatch) = heap.m_pFullBatches;
+    heap.m_pFullBatches = pBatch;
+  }
+
+  /// Hands a chain of any length over to the central heap.
+  void TcReleaseBlocks(ezUInt32 uiSizeClass, void* pFirst, void* pLast)
+  {
+    TcCentralHeap& heap = TcGetCentralData().m_Heaps[uiSizeClass];
+
+    EZ_LOCK(heap.m_Mutex);
+    TcNext(pLast) = heap.m_pLooseBlocks;
+    heap.m_pLooseBlocks = pFirst;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Thread caches
+
+  struct TcThreadCache
+  {
+    void* m_pFreeBlocks[TC_NUM_SIZE_CLASSES];
+    ezUInt32 m_uiNumFreeBlocks[TC_NUM_SIZE_CLASSES];
+    bool m_bRegistered; ///< Whether the releaser is set up for this thread.
+    bool m_bReleased;   ///< Set when the thread terminates. Afterwards all blocks go directly to the central heaps.
+  };
+
+  // trivially destructible, so that it can still be accessed while other thread_local objects are destroyed
+  thread_local TcThreadCache t_TcThreadCache;
+
+  /// Removes one batch from the front of the thread's list and hands it over to the central heap.
+  void TcReleaseBatchFromCache(TcThreadCache& ref_cache, ezUInt32 uiSizeClass)
+  {
+    const ezUInt32 uiBatchCount = TcGetBatchCount(uiSizeClass);
+
+    void* pBatch = ref_cache.m_pFreeBlocks[uiSizeClass];
+    void* pLast = pBatch;
+    for (ezUInt32 i = 1; i < uiBatchCount; ++i)
+    {
+      pLast = TcNext(pLast);
+    }
+
+    ref_cache.m_pFreeBlocks[uiSizeClass] = TcNext(pLast);
+    ref_cache.m_uiNumFreeBlocks[uiSizeClass] -= uiBatchCount;
+
+    TcNext(pLast) = nullptr;
+    TcReleaseBatch(uiSizeClass, pBatch);
+  }
+
+  /// Gives all cached blocks back to the central heaps when the thread terminates.
+  struct TcThreadCacheReleaser
+  {
+    bool m_bActive = false;
+
+    ~TcThreadCacheReleaser()
+    {
+      if (!m_bActive)
+        return;
+
+      ezMemoryPolicies::ezThreadCachingAllocation::FlushThreadCache();
+      t_TcThreadCache.m_bReleased = true;
+    }
+  };
+
+  // separate from t_TcThreadCache, so that accessing the cache doesn't have to go through the initialization check for thread_local objects with destructors
+  thread_local TcThreadCacheReleaser t_TcThreadCacheReleaser;
+
+  EZ_ALWAYS_INLINE void* TcAllocateLarge(size_t uiSize, size_t uiAlign)
+  {
+    return ezMemoryPolicies::ezAlignedHeapAllocation(nullptr).Allocate(uiSize, uiAlign);
+  }
+
+  /// The slow path of Allocate(), kept separate so that the fast path stays small. Fetches a batch of blocks from the central heap and returns the first one.
+  void* TcRefillAndAllocate(TcThreadCache& ref_cache, ezUInt32 uiSizeClass, size_t uiSize, size_t uiAlign)
+  {
+    if (!ref_cache.m_bRegistered)
+    {
+      ref_cache.m_bRegistered = true;
+      t_TcThreadCacheReleaser.m_bActive = true;
+    }
+
+    void* pBlock = nullptr;
+    const ezUInt32 uiNumBlocks = TcFetchBlocks(uiSizeClass, pBlock);
+
+    if (uiNumBlocks == 0)
+      return TcAllocateLarge(uiSize, uiAlign);
+
+    if (ref_cache.m_bReleased)
+    {
+      // the thread is terminating, don't keep anything in its cache
+      if (uiNumBlocks > 1)
+      {
+        void* pLast = TcNext(pBlock);
+        while (TcNext(pLast) != nullptr)
+        {
+          pLast = TcNext(pLast);
+        }
+
+        TcReleaseBlocks(uiSizeClass, TcNext(pBlock), pLast);
+      }
+
+      return pBlock;
+    }
+
+    ref_cache.m_pFreeBlocks[uiSizeClass] = TcNext(pBlock);
+    ref_cache.m_uiNumFreeBlocks[uiSizeClass] = uiNumBlocks - 1;
+
+    return pBlock;
+  }
+} // namespace
+
+namespace ezMemoryPolicies
+{
+  void* ezThreadCachingAllocation::Allocate(size_t uiSize, size_t uiAlign)
+  {
+    if (uiSize > MaxSmallSize || uiAlign > MaxSmallAlignment)
+      return TcAllocateLarge(uiSize, uiAlign);
+
+    const ezUInt32 uiSizeClass = TcGetSizeClass(uiSize);
+    TcThreadCache& cache = t_TcThreadCache;
+
+    void* pBlock = cache.m_pFreeBlocks[uiSizeClass];
+
+    if (pBlock == nullptr)
+      return TcRefillAndAllocate(cache, uiSizeClass, uiSize, uiAlign);
+
+    cache.m_pFreeBlocks[uiSizeClass] = TcNext(pBlock);
+    --cache.m_uiNumFreeBlocks[uiSizeClass];
+
+    return pBlock;
+  }
+
+  void ezThreadCachingAllocation::Deallocate(void* pPtr)
+  {
+    const ezUInt32 uiSizeClassPlusOne = TcLookupSizeClass(pPtr);
+
+    if (uiSizeClassPlusOne == 0)
+    {
+      ezAlignedHeapAllocation(nullptr).Deallocate(pPtr);
+      return;
+    }
+
+    const ezUInt32 uiSizeClass = uiSizeClassPlusOne - 1;
+    TcThreadCache& cache = t_TcThreadCache;
+
+    if (cache.m_bReleased)
+    {
+      TcReleaseBlocks(uiSizeClass, pPtr, pPtr);
+      return;
+    }
+
+    if (!cache.m_bRegistered)
+    {
+      // threads that only free memory need to give it back as well
+      cache.m_bRegistered = true;
+      t_TcThreadCacheReleaser.m_bActive = true;
+    }
+
+    TcNext(pPtr) = cache.m_pFreeBlocks[uiSizeClass];
+    cache.m_pFreeBlocks[uiSizeClass] = pPtr;
+
+    // keep up to two batches, so that alternating allocations and deallocations don't move the same batch back and forth
+    if (++cache.m_uiNumFreeBlocks[uiSizeClass] > 2 * TcGetBatchCount(uiSizeClass))
+    {
+      TcReleaseBatchFromCache(cache, uiSizeClass);
+    }
+  }
+
+  void ezThreadCachingAllocation::FlushThreadCache()
+  {
+    TcThreadCache& cache = t_TcThreadCache;
+
+    for (ezUInt32 uiSizeClass = 0; uiSizeClass < TC_NUM_SIZE_CLASSES; ++uiSizeClass)
+    {
+      while (cache.m_uiNumFreeBlocks[uiSizeClass] >= TcGetBatchCount(uiSizeClass))
+      {
+        TcReleaseBatchFromCache(cache, uiSizeClass);
+      }
+
+      void* pFirst = cache.m_pFreeBlocks[uiSizeClass];
+
+      if (pFirst != nullptr)
+      {
+        void* pLast = pFirst;
+        while (TcNext(pLast) != nullptr)
+        {
+          pLast = TcNext(pLast);
+        }
+
+        TcReleaseBlocks(uiSizeClass, pFirst, pLast);
+      }
+
+      cache.m_pFreeBlocks[uiSizeClass] = nullptr;
+      cache.m_uiNumFreeBlocks[uiSizeClass] = 0;
+    }
+  }
+} // namespace ezMemoryPolicies
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Policies_ThreadCachingAllocation);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+
+namespace ezMemoryPolicies
+{
+  /// \brief Allocation policy that serves small allocations from per-thread caches.
+  ///
+  /// Allocations of up to MaxSmallSize bytes and up to MaxSmallAlignment alignment are rounded up to one of a fixed set of size classes.
+  /// Every thread keeps a list of free blocks for each size class, so most allocations and deallocations don't need any synchronization.
+  /// When the list of a thread runs empty or grows too long, blocks are moved in batches from or to the central heap of the size class,
+  /// which carves new blocks out of 64 KB spans.
+  /// Freed blocks always go to the cache of the freeing thread, so memory can be deallocated on a different thread than it was allocated on.
+  /// Larger allocations are passed through to ezAlignedHeapAllocation.
+  ///
+  /// All instances of this policy share the same caches and spans. Memory in spans is kept for reuse, it is only returned to the OS when the
+  /// process terminates.
+  ///
+  /// \see ezAllocator
+  class EZ_FOUNDATION_DLL ezThreadCachingAllocation
+  {
+  public:
+    /// \brief The largest allocation size that is served from the thread caches.
+    static constexpr size_t MaxSmallSize = 8192;
+
+    /// \brief The largest alignment that is supported by the thread caches. Allocations with larger alignment are passed through to the heap.
+    static constexpr size_t MaxSmallAlignment = 16;
+
+    EZ_ALWAYS_INLINE ezThreadCachingAllocation(ezAllocatorBase* pParent) {}
+    EZ_ALWAYS_INLINE ~ezThreadCachingAllocation() = default;
+
+    void* Allocate(size_t uiSize, size_t uiAlign);
+    void Deallocate(void* pPtr);
+
+    EZ_ALWAYS_INLINE ezAllocatorBase* GetParent() const { return nullptr; }
+
+    /// \brief Moves all blocks that are cached by the calling thread back to the central heaps.
+    ///
+    /// This happens automatically when a thread terminates. Long running threads can call this after a burst of allocations,
+    /// to make the memory available to other threads.
+    static void FlushThreadCache();
+  };
+} // namespace ezMemoryPolicies
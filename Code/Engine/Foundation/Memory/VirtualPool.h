@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Foundation/Containers/Bitfield.h>
+
+/// \brief An object pool that reserves address space for its maximum number of objects up front and backs it with memory only as it grows.
+///
+/// Objects never move, so pointers to them stay valid until they are deleted, and growing the pool never copies anything.
+/// Each object also has a fixed index that can be used as a compact handle, see GetIndex() and GetObject().
+/// Deleted slots are reused before new memory is committed.
+template <typename T>
+class ezVirtualPool
+{
+public:
+  class ConstIterator
+  {
+  public:
+    const T& operator*() const;
+    const T* operator->() const;
+
+    operator const T*() const;
+
+    void Next();
+    bool IsValid() const;
+
+    void operator++();
+
+  protected:
+    friend class ezVirtualPool<T>;
+
+    explicit ConstIterator(const ezVirtualPool<T>& pool);
+
+    T& CurrentElement() const;
+
+    const ezVirtualPool<T>& m_Pool;
+    ezUInt32 m_uiCurrentIndex = 0;
+  };
+
+  class Iterator : public ConstIterator
+  {
+  public:
+    T& operator*();
+    T* operator->();
+
+    operator T*();
+
+  private:
+    friend class ezVirtualPool<T>;
+
+    explicit Iterator(const ezVirtualPool<T>& pool);
+  };
+
+  /// \brief Reserves address space for uiMaxCount objects. Does not commit any memory yet.
+  ///
+  /// If the address space can't be reserved, GetMaxCount() returns zero and no objects can be created.
+  explicit ezVirtualPool(ezUInt32 uiMaxCount); // [tested]
+
+  /// \brief Destroys all remaining objects and releases the reserved address space.
+  ~ezVirtualPool(); // [tested]
+
+  ezVirtualPool(const ezVirtualPool<T>& other) = delete;
+  void operator=(const ezVirtualPool<T>& rhs) = delete;
+
+  /// \brief Destroys all objects. The committed memory is kept for reuse.
+  void Clear(); // [tested]
+
+  /// \brief Constructs a new object with the given arguments.
+  template <typename... Args>
+  T* Create(Args&&... args); // [tested]
+
+  /// \brief Destroys the given object. Its slot is reused by the next call to Create().
+  void Delete(T* pObject); // [tested]
+
+  /// \brief Returns the fixed index of the given object.
+  ezUInt32 GetIndex(const T* pObject) const; // [tested]
+
+  /// \brief Returns the object with the given index or nullptr, if that slot is not in use.
+  T* GetObject(ezUInt32 uiIndex); // [tested]
+
+  /// \brief Returns the object with the given index or nullptr, if that slot is not in use.
+  const T* GetObject(ezUInt32 uiIndex) const; // [tested]
+
+  /// \brief Returns the number of live objects.
+  ezUInt32 GetCount() const { return m_uiCount; } // [tested]
+
+  /// \brief Returns the number of objects that the pool can hold at most.
+  ezUInt32 GetMaxCount() const { return m_uiMaxCount; } // [tested]
+
+  /// \brief Returns the amount of bytes that are currently committed.
+  ezUInt64 GetHeapMemoryUsage() const { return m_uiCommittedBytes; } // [tested]
+
+  Iterator GetIterator(); // [tested]
+  ConstIterator GetIterator() const; // [tested]
+
+private:
+  enum
+  {
+    COMMIT_GRANULARITY = 64 * 1024, ///< Memory is committed in steps of at least this size to reduce the number of system calls.
+  };
+
+  // free slots store the index of the next free slot in their first bytes
+  static constexpr size_t SlotAlignment = EZ_ALIGNMENT_OF(T) > sizeof(ezUInt32) ? EZ_ALIGNMENT_OF(T) : sizeof(ezUInt32);
+  static constexpr size_t SlotSize = ((sizeof(T) > sizeof(ezUInt32) ? sizeof(T) : sizeof(ezUInt32)) + SlotAlignment - 1) & ~(SlotAlignment - 1);
+
+  T* GetSlot(ezUInt32 uiIndex) const;
+  ezUInt32& GetNextFreeSlot(ezUInt32 uiIndex);
+
+  ezUInt8* m_pSlots = nullptr;
+  ezUInt32 m_uiMaxCount = 0;
+  ezUInt32 m_uiCount = 0;
+  ezUInt32 m_uiUsedSlots = 0; ///< Number of slots that have been handed out at least once.
+  ezUInt32 m_uiFreelistStart = ezInvalidIndex;
+
+  size_t m_uiReservedBytes = 0;
+  size_t m_uiCommittedBytes = 0;
+
+  ezDynamicBitfield m_UsedEntries;
+};
+
+#include <Foundation/Memory/Implementation/VirtualPool_inl.h>
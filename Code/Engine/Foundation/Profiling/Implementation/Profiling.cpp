@@ -4,13 +4,20 @@
 #include <Foundation/Communication/DataTransfer.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/IdTable.h>
 #include <Foundation/Containers/StaticRingBuffer.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/IO/JSONWriter.h>
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Threading/ThreadSignal.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
+#include <atomic>
+
 #if EZ_ENABLED(EZ_USE_PROFILING)
 
 class ezProfileCaptureDataTransfer : public ezDataTransfer
@@ -40,8 +47,14 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(Foundation, ProfilingSystem)
     ezProfilingSystem::Initialize();
     s_ProfileCaptureDataTransfer.EnableDataTransfer("Profiling Capture");
   }
+  ON_CORESYSTEMS_STARTUP
+  {
+    ezProfilingSystem::StartCollector();
+  }
   ON_CORESYSTEMS_SHUTDOWN
   {
+    ezProfilingSystem::StopStreaming();
+    ezProfilingSystem::StopCollector();
     s_ProfileCaptureDataTransfer.DisableDataTransfer();
     ezProfilingSystem::Reset();
   }
@@ -62,8 +75,89 @@ namespace
     BUFFER_SIZE_FRAMES = 120 * 60,
   };
 
+  enum
+  {
+    HANDOVER_QUEUE_SIZE = 4096, ///< Number of scopes that a thread can record until the collector picks them up, must be a power of two
+    SCOPE_NAME_CACHE_SIZE = 64,      ///< Number of entries in the per-thread cache of interned scope names, must be a power of two
+    MAX_INTERNED_SCOPE_NAMES = 4096, ///< Names beyond this (e.g. names built at runtime) are copied into each scope instead of being interned
+  };
+
+  enum
+  {
+    STREAMING_BUFFER_SIZE_GPU = 4096,   ///< Number of GPU scopes that are held until they are written to the streaming file
+    STREAMING_BUFFER_SIZE_FRAMES = 256, ///< Number of frame markers that are held until they are written to the streaming file
+    STREAMING_MAX_GPUS = 16,            ///< Thread IDs are shifted by this amount, to reserve the fake IDs 1..STREAMING_MAX_GPUS for the GPUs
+  };
+
+  /// \brief A CPU scope that has been collected, but not yet written to the streaming file.
+  struct StreamedScope
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezProfilingSystem::CPUScope m_Scope;
+    ezUInt64 m_uiTrackId; ///< The 'tid' in the trace file
+  };
+
+  struct StreamedGpuScope
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezProfilingSystem::GPUScope m_Scope;
+    ezUInt32 m_uiGpuIndex;
+  };
+
+  struct StreamedFrame
+  {
+    ezUInt64 m_uiFrameIndex;
+    ezTime m_StartTime;
+  };
+
   using GPUScopesBuffer = ezStaticRingBuffer<ezProfilingSystem::GPUScope, BUFFER_SIZE_OTHER_THREAD / sizeof(ezProfilingSystem::GPUScope)>;
 
+  /// \brief Lock-free single producer / single consumer queue, through which a thread hands its scopes over to the collector.
+  ///
+  /// Only the thread that owns the queue pushes scopes into it, and only whoever holds s_CollectorMutex pops them.
+  class ScopeHandoverQueue
+  {
+  public:
+    /// \brief Called by the owning thread. Fails if the queue is full.
+    bool TryPush(const ezProfilingSystem::CPUScope& scope)
+    {
+      const ezUInt32 uiWriteIndex = m_uiWriteIndex.load(std::memory_order_relaxed);
+
+      if (uiWriteIndex - m_uiReadIndex.load(std::memory_order_acquire) == HANDOVER_QUEUE_SIZE)
+        return false;
+
+      m_Scopes[uiWriteIndex & (HANDOVER_QUEUE_SIZE - 1)] = scope;
+      m_uiWriteIndex.store(uiWriteIndex + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// \brief Only an estimate, if called while the other side is active.
+    ezUInt32 GetCount() const { return m_uiWriteIndex.load(std::memory_order_relaxed) - m_uiReadIndex.load(std::memory_order_relaxed); }
+
+    /// \brief Calls the callback for all scopes in the queue and removes them. Must only be called while holding s_CollectorMutex.
+    template <typename Callback>
+    void PopAll(Callback callback)
+    {
+      const ezUInt32 uiReadIndex = m_uiReadIndex.load(std::memory_order_relaxed);
+      const ezUInt32 uiWriteIndex = m_uiWriteIndex.load(std::memory_order_acquire);
+
+      for (ezUInt32 i = uiReadIndex; i != uiWriteIndex; ++i)
+      {
+        callback(m_Scopes[i & (HANDOVER_QUEUE_SIZE - 1)]);
+      }
+
+      m_uiReadIndex.store(uiWriteIndex, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<ezUInt32> m_uiWriteIndex{0};
+    ezUInt8 m_Padding[60]; // the producer and the consumer should not invalidate each other's cache line
+    std::atomic<ezUInt32> m_uiReadIndex{0};
+    ezProfilingSystem::CPUScope m_Scopes[HANDOVER_QUEUE_SIZE];
+  };
+
   static ezUInt64 s_MainThreadId = 0;
 
   struct CpuScopesBufferBase
@@ -72,27 +166,39 @@ namespace
 
     ezUInt64 m_uiThreadId = 0;
     bool IsMainThread() const { return m_uiThreadId == s_MainThreadId; }
+
+    /// Filled by the owning thread, emptied by the collector, which moves the scopes into the history.
+    ScopeHandoverQueue m_HandoverQueue;
+
+    // The history holds the most recent scopes for Capture(). It is only accessed while holding s_CollectorMutex.
+    virtual void AddToHistory(const ezProfilingSystem::CPUScope& scope) = 0;
+    virtual ezUInt32 GetHistoryCount() const = 0;
+    virtual const ezProfilingSystem::CPUScope& GetHistoryScope(ezUInt32 uiIndex) const = 0;
+    virtual void ClearHistory() = 0;
   };
 
   template <ezUInt32 SizeInBytes>
   struct CpuScopesBuffer : public CpuScopesBufferBase
   {
-    ezStaticRingBuffer<ezProfilingSystem::CPUScope, SizeInBytes / sizeof(ezProfilingSystem::CPUScope)> m_Data;
-  };
+    virtual void AddToHistory(const ezProfilingSystem::CPUScope& scope) override
+    {
+      if (!m_Data.CanAppend())
+      {
+        m_Data.PopFront();
+      }
 
-  CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>* CastToMainThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
-  {
-    EZ_ASSERT_DEV(pEventBuffer->IsMainThread(), "Implementation error");
-    return static_cast<CpuScopesBuffer<BUFFER_SIZE_MAIN_THREAD>*>(pEventBuffer);
-  }
+      m_Data.PushBack(scope);
+    }
 
-  CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>* CastToOtherThreadEventBuffer(CpuScopesBufferBase* pEventBuffer)
-  {
-    EZ_ASSERT_DEV(!pEventBuffer->IsMainThread(), "Implementation error");
-    return static_cast<CpuScopesBuffer<BUFFER_SIZE_OTHER_THREAD>*>(pEventBuffer);
-  }
+    virtual ezUInt32 GetHistoryCount() const override { return m_Data.GetCount(); }
+    virtual const ezProfilingSystem::CPUScope& GetHistoryScope(ezUInt32 uiIndex) const override { return m_Data[uiIndex]; }
+    virtual void ClearHistory() override { m_Data.Clear(); }
+
+    ezStaticRingBuffer<ezProfilingSystem::CPUScope, SizeInBytes / sizeof(ezProfilingSystem::CPUScope)> m_Data;
+  };
 
   ezCVarFloat cvar_ProfilingDiscardThresholdMS("Profiling.DiscardThresholdMS", 0.1f, ezCVarFlags::Default, "Discard profiling scopes if their duration is shorter than this in milliseconds.");
+  ezCVarFloat cvar_ProfilingCollectorIntervalMS("Profiling.CollectorIntervalMS", 50.0f, ezCVarFlags::Default, "How often the recorded profiling scopes of all threads are collected (and streamed to file), in milliseconds.");
 
   ezStaticRingBuffer<ezTime, BUFFER_SIZE_FRAMES> s_FrameStartTimes;
   ezUInt64 s_uiFrameCount = 0;
@@ -102,7 +208,7 @@ namespace
   static ezMutex s_ThreadInfosMutex;
 
 #  if EZ_ENABLED(EZ_PLATFORM_64BIT)
-  EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::CPUScope) == 64);
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::CPUScope) == 72);
   EZ_CHECK_AT_COMPILETIME(sizeof(ezProfilingSystem::GPUScope) == 64);
 #  endif
 
@@ -113,9 +219,392 @@ namespace
 
   static ezDynamicArray<ezUniquePtr<GPUScopesBuffer>> s_GPUScopes;
 
+  //////////////////////////////////////////////////////////////////////////
+  // Scope name interning
+
+  struct ScopeNameCacheEntry
+  {
+    ezUInt64 m_uiHash;
+    const char* m_szName;
+    ezUInt32 m_uiLength;
+    ezUInt32 m_uiNameId;
+  };
+
+  /// Maps the names that a thread passes into AddCPUScope() to name IDs, without taking any lock.
+  /// Keyed by the content and not the pointer, so that names built at runtime (e.g. in a string builder) are found as well.
+  static thread_local ScopeNameCacheEntry s_ScopeNameCache[SCOPE_NAME_CACHE_SIZE];
+
+  static ezMutex s_ScopeNamesMutex;
+  static ezDeque<ezString> s_ScopeNames; ///< A deque never moves its elements, so the name pointers in the caches stay valid.
+  static ezHashTable<ezString, ezUInt32> s_ScopeNameIds;
+  static ezAtomicBool s_bScopeNamesFull; ///< Once set, the names are never modified again and can be looked up without the lock.
+
+  /// \brief Returns the ID of the given name, which is registered once and never removed. ID 0 is the empty name.
+  ///
+  /// Returns ezInvalidIndex if the name is not interned, because the maximum number of interned names has been reached.
+  ezUInt32 InternScopeName(ezStringView sName)
+  {
+    const ezUInt32 uiLength = sName.GetElementCount();
+    if (uiLength == 0)
+      return 0;
+
+    // scopes are only recorded if they take longer than the discard threshold, so hashing the name is negligible
+    const ezUInt64 uiHash = ezHashingUtils::StringHash(sName);
+    ScopeNameCacheEntry& entry = s_ScopeNameCache[uiHash & (SCOPE_NAME_CACHE_SIZE - 1)];
+
+    if (entry.m_uiHash == uiHash && entry.m_uiLength == uiLength && ezMemoryUtils::RawByteCompare(entry.m_szName, sName.GetStartPointer(), uiLength) == 0)
+      return entry.m_uiNameId;
+
+    ezUInt32 uiNameId = 0;
+
+    if (s_bScopeNamesFull)
+    {
+      if (!s_ScopeNameIds.TryGetValue(sName, uiNameId))
+        return ezInvalidIndex;
+    }
+    else
+    {
+      EZ_LOCK(s_ScopeNamesMutex);
+
+      if (s_ScopeNames.IsEmpty())
+      {
+        s_ScopeNames.PushBack(ezString());
+      }
+
+      if (!s_ScopeNameIds.TryGetValue(sName, uiNameId))
+      {
+        if (s_ScopeNames.GetCount() >= MAX_INTERNED_SCOPE_NAMES)
+        {
+          s_bScopeNamesFull = true;
+          return ezInvalidIndex;
+        }
+
+        uiNameId = s_ScopeNames.GetCount();
+        s_ScopeNames.PushBack(sName);
+        s_ScopeNameIds.Insert(sName, uiNameId);
+      }
+    }
+
+    entry.m_uiHash = uiHash;
+    entry.m_szName = s_ScopeNames[uiNameId].GetData();
+    entry.m_uiLength = uiLength;
+    entry.m_uiNameId = uiNameId;
+    return uiNameId;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // Streaming
+
+  static ezAtomicBool s_bStreaming;
+  static ezAtomicInteger64 s_iNumDroppedScopes;
+
+  /// Protects the streamed GPU scopes and frame markers, which are not recorded per thread.
+  static ezMutex s_StreamingMutex;
+  using StreamedGpuScopesBuffer = ezStaticRingBuffer<StreamedGpuScope, STREAMING_BUFFER_SIZE_GPU>;
+  static ezUniquePtr<StreamedGpuScopesBuffer> s_pStreamedGpuScopes;
+  static ezStaticRingBuffer<StreamedFrame, STREAMING_BUFFER_SIZE_FRAMES> s_StreamedFrames;
+
+  /// \brief Appends all collected profiling data to the streaming file.
+  ///
+  /// All data is written as one JSON array of trace events. Scopes are written as complete events ('X'), which do not need to be in any
+  /// particular order. Thus every batch can be appended right away, without having to hold back any data.
+  class ProfilingStreamWriter
+  {
+  public:
+    ezResult Open(ezStringView sFilePath)
+    {
+      if (m_File.Open(sFilePath).Failed())
+        return EZ_FAILURE;
+
+#  if EZ_ENABLED(EZ_SUPPORTS_PROCESSES)
+      m_uiProcessID = static_cast<ezUInt32>(ezProcess::GetCurrentProcessID());
+#  endif
+
+      m_Writer.SetWhitespaceMode(ezJSONWriter::WhitespaceMode::None);
+      m_Writer.SetOutputStream(&m_File);
+      m_Writer.BeginArray();
+
+      m_Writer.BeginObject();
+      {
+        m_Writer.AddVariableString("name", "process_name");
+        m_Writer.AddVariableString("cat", "__metadata");
+        m_Writer.AddVariableUInt32("pid", m_uiProcessID);
+        m_Writer.AddVariableString("ph", "M");
+
+        m_Writer.BeginObject("args");
+        m_Writer.AddVariableString("name", ezApplication::GetApplicationInstance() ? ezApplication::GetApplicationInstance()->GetApplicationName().GetData() : "ezEngine");
+        m_Writer.EndObject();
+      }
+      m_Writer.EndObject();
+
+      WriteTrackMetadata(0, "Frames", -1);
+
+      return EZ_SUCCESS;
+    }
+
+    void Close()
+    {
+      m_Writer.EndArray();
+      m_File.Close();
+    }
+
+    /// \brief Writes the pending scopes and all other data that was recorded since the last call. Must only be called while holding s_CollectorMutex.
+    void WriteOutstandingData()
+    {
+      {
+        EZ_LOCK(s_ThreadInfosMutex);
+
+        for (const ezProfilingSystem::ThreadInfo& info : s_ThreadInfos)
+        {
+          if (!m_KnownThreadIDs.Contains(info.m_uiThreadId))
+          {
+            m_KnownThreadIDs.PushBack(info.m_uiThreadId);
+            m_NewThreadInfos.PushBack(info);
+          }
+        }
+      }
+
+      {
+        EZ_LOCK(s_StreamingMutex);
+
+        if (s_pStreamedGpuScopes != nullptr)
+        {
+          for (ezUInt32 i = 0; i < s_pStreamedGpuScopes->GetCount(); ++i)
+          {
+            m_PendingGpuScopes.PushBack((*s_pStreamedGpuScopes)[i]);
+          }
+          s_pStreamedGpuScopes->Clear();
+        }
+
+        for (ezUInt32 i = 0; i < s_StreamedFrames.GetCount(); ++i)
+        {
+          m_PendingFrames.PushBack(s_StreamedFrames[i]);
+        }
+        s_StreamedFrames.Clear();
+      }
+
+      // the names themselves never move, but the deque that holds them may be modified concurrently
+      {
+        EZ_LOCK(s_ScopeNamesMutex);
+
+        m_PendingScopeNames.SetCountUninitialized(m_PendingScopes.GetCount());
+        for (ezUInt32 i = 0; i < m_PendingScopes.GetCount(); ++i)
+        {
+          const ezProfilingSystem::CPUScope& scope = m_PendingScopes[i].m_Scope;
+          m_PendingScopeNames[i] = (scope.m_uiNameId != 0 && scope.m_uiNameId < s_ScopeNames.GetCount()) ? s_ScopeNames[scope.m_uiNameId].GetData() : scope.m_szName;
+        }
+      }
+
+      for (const ezProfilingSystem::ThreadInfo& info : m_NewThreadInfos)
+      {
+        WriteTrackMetadata(info.m_uiThreadId + STREAMING_MAX_GPUS + 1, info.m_sName, m_KnownThreadIDs.IndexOf(info.m_uiThreadId));
+      }
+      m_NewThreadInfos.Clear();
+
+      for (ezUInt32 i = 0; i < m_PendingScopes.GetCount(); ++i)
+      {
+        const StreamedScope& scope = m_PendingScopes[i];
+        WriteScope(m_PendingScopeNames[i], scope.m_Scope.m_szFunctionName, scope.m_Scope.m_BeginTime, scope.m_Scope.m_EndTime, scope.m_uiTrackId);
+      }
+      m_PendingScopes.Clear();
+
+      // GPUs use the fake thread IDs 1..STREAMING_MAX_GPUS
+      for (const StreamedGpuScope& scope : m_PendingGpuScopes)
+      {
+        while (m_uiNumKnownGpus <= scope.m_uiGpuIndex)
+        {
+          ezStringBuilder sGpuName;
+          sGpuName.Format("GPU {}", m_uiNumKnownGpus);
+          ++m_uiNumKnownGpus;
+
+          WriteTrackMetadata(m_uiNumKnownGpus, sGpuName, -2);
+        }
+
+        WriteScope(scope.m_Scope.m_szName, nullptr, scope.m_Scope.m_BeginTime, scope.m_Scope.m_EndTime, scope.m_uiGpuIndex + 1);
+      }
+      m_PendingGpuScopes.Clear();
+
+      ezStringBuilder sFrameName;
+      for (const StreamedFrame& frame : m_PendingFrames)
+      {
+        if (m_LastFrame.m_uiFrameIndex != 0)
+        {
+          sFrameName.Format("Frame {}", m_LastFrame.m_uiFrameIndex);
+          WriteScope(sFrameName, nullptr, m_LastFrame.m_StartTime, frame.m_StartTime, 0);
+        }
+
+        m_LastFrame = frame;
+      }
+      m_PendingFrames.Clear();
+
+      if (m_File.Flush().Failed() || m_Writer.HadWriteError())
+      {
+        if (!m_bWriteErrorReported)
+        {
+          m_bWriteErrorReported = true;
+          ezLog::Error("Failed to write streamed profiling data to '{}'.", m_File.GetFilePathAbsolute().GetView());
+        }
+      }
+    }
+
+    /// Filled by the collector.
+    ezDynamicArray<StreamedScope> m_PendingScopes;
+
+  private:
+    void WriteTrackMetadata(ezUInt64 uiTrackId, ezStringView sName, ezInt32 iSortIndex)
+    {
+      m_Writer.BeginObject();
+      {
+        m_Writer.AddVariableString("name", "thread_name");
+        m_Writer.AddVariableString("cat", "__metadata");
+        m_Writer.AddVariableUInt32("pid", m_uiProcessID);
+        m_Writer.AddVariableUInt64("tid", uiTrackId);
+        m_Writer.AddVariableString("ph", "M");
+
+        m_Writer.BeginObject("args");
+        m_Writer.AddVariableString("name", sName);
+        m_Writer.EndObject();
+      }
+      m_Writer.EndObject();
+
+      m_Writer.BeginObject();
+      {
+        m_Writer.AddVariableString("name", "thread_sort_index");
+        m_Writer.AddVariableString("cat", "__metadata");
+        m_Writer.AddVariableUInt32("pid", m_uiProcessID);
+        m_Writer.AddVariableUInt64("tid", uiTrackId);
+        m_Writer.AddVariableString("ph", "M");
+
+        m_Writer.BeginObject("args");
+        m_Writer.AddVariableInt32("sort_index", iSortIndex);
+        m_Writer.EndObject();
+      }
+      m_Writer.EndObject();
+    }
+
+    void WriteScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezUInt64 uiTrackId)
+    {
+      m_Writer.BeginObject();
+      m_Writer.AddVariableString("name", sName);
+      m_Writer.AddVariableUInt32("pid", m_uiProcessID);
+      m_Writer.AddVariableUInt64("tid", uiTrackId);
+      m_Writer.AddVariableUInt64("ts", static_cast<ezUInt64>(beginTime.GetMicroseconds()));
+      m_Writer.AddVariableUInt64("dur", static_cast<ezUInt64>((endTime - beginTime).GetMicroseconds()));
+      m_Writer.AddVariableString("ph", "X");
+
+      if (szFunctionName != nullptr)
+      {
+        m_Writer.BeginObject("args");
+        m_Writer.AddVariableString("function", szFunctionName);
+        m_Writer.EndObject();
+      }
+
+      m_Writer.EndObject();
+    }
+
+    ezFileWriter m_File;
+    ezStandardJSONWriter m_Writer;
+    ezUInt32 m_uiProcessID = 0;
+    bool m_bWriteErrorReported = false;
+
+    ezHybridArray<ezUInt64, 16> m_KnownThreadIDs;
+    ezHybridArray<ezProfilingSystem::ThreadInfo, 16> m_NewThreadInfos;
+    ezUInt32 m_uiNumKnownGpus = 0;
+    StreamedFrame m_LastFrame = {0, ezTime::MakeZero()};
+
+    ezDynamicArray<const char*> m_PendingScopeNames;
+    ezDynamicArray<StreamedGpuScope> m_PendingGpuScopes;
+    ezDynamicArray<StreamedFrame> m_PendingFrames;
+  };
+
+  //////////////////////////////////////////////////////////////////////////
+  // Collector
+
+  /// Whoever holds this mutex is the consumer of all handover queues and owns the histories and the stream writer.
+  static ezMutex s_CollectorMutex;
+  static bool s_bCollecting = false;
+  static ezThreadSignal s_CollectorWakeUp;
+  static ezUniquePtr<ProfilingStreamWriter> s_pStreamWriter;
+
+  /// \brief Moves all scopes from the thread's handover queue into its history. The caller has to hold s_CollectorMutex.
+  void CollectScopes(CpuScopesBufferBase& ref_buffer)
+  {
+    ref_buffer.m_HandoverQueue.PopAll([&](const ezProfilingSystem::CPUScope& scope) {
+      ref_buffer.AddToHistory(scope);
+
+      if (s_pStreamWriter != nullptr)
+      {
+        s_pStreamWriter->m_PendingScopes.PushBack({scope, ref_buffer.m_uiThreadId + STREAMING_MAX_GPUS + 1});
+      }
+    });
+  }
+
+  /// \brief Collects the scopes of all threads and appends them to the streaming file. The caller has to hold s_CollectorMutex.
+  void CollectAllScopes()
+  {
+    // the collecting thread may add scopes itself, which must not collect recursively
+    s_bCollecting = true;
+
+    {
+      EZ_LOCK(s_AllCpuScopesMutex);
+
+      for (CpuScopesBufferBase* pEventBuffer : s_AllCpuScopes)
+      {
+        CollectScopes(*pEventBuffer);
+      }
+    }
+
+    if (s_pStreamWriter != nullptr)
+    {
+      s_pStreamWriter->WriteOutstandingData();
+    }
+
+    s_bCollecting = false;
+  }
+
+  /// \brief Regularly empties the handover queues of all threads, so that they don't run full.
+  class ProfilingCollectorThread : public ezThread
+  {
+  public:
+    ProfilingCollectorThread()
+      : ezThread("Profiling Collector")
+    {
+    }
+
+    void RequestStop()
+    {
+      m_bStopRequested = true;
+      s_CollectorWakeUp.RaiseSignal();
+    }
+
+  private:
+    virtual ezUInt32 Run() override
+    {
+      while (!m_bStopRequested)
+      {
+        s_CollectorWakeUp.WaitForSignal(ezTime::MakeFromMilliseconds(cvar_ProfilingCollectorIntervalMS));
+
+        EZ_LOCK(s_CollectorMutex);
+        CollectAllScopes();
+      }
+
+      return 0;
+    }
+
+    ezAtomicBool m_bStopRequested;
+  };
+
+  static ezUniquePtr<ProfilingCollectorThread> s_pCollectorThread;
+
   static ezEventSubscriptionID s_PluginEventSubscription = 0;
   void PluginEvent(const ezPluginEvent& e)
   {
+    if (e.m_EventType == ezPluginEvent::BeforeUnloading)
+    {
+      // Streamed scopes may point to function names in the plugin, so they have to be written while those still exist.
+      ezProfilingSystem::FlushStreaming();
+    }
+
     if (e.m_EventType == ezPluginEvent::AfterUnloading)
     {
       // When a plugin is unloaded we need to clear all profiling data
@@ -132,6 +621,7 @@ void ezProfilingSystem::ProfilingData::Clear()
   m_uiFrameCount = 0;
 
   m_AllEventBuffers.Clear();
+  m_ScopeNames.Clear();
   m_FrameStartTimes.Clear();
   m_GPUScopes.Clear();
   m_ThreadInfos.Clear();
@@ -194,6 +684,32 @@ void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_merged, ezArrayP
     }
   }
 
+  // merge m_ScopeNames, every input gets a table that maps its name IDs to the merged ones
+  ezHybridArray<ezDynamicArray<ezUInt32>, 4> nameIdRemapping;
+  {
+    ezHashTable<ezString, ezUInt32> mergedNameIds;
+
+    nameIdRemapping.SetCount(inputs.GetCount());
+    for (ezUInt32 uiInput = 0; uiInput < inputs.GetCount(); ++uiInput)
+    {
+      const ezDynamicArray<ezString>& scopeNames = inputs[uiInput]->m_ScopeNames;
+      nameIdRemapping[uiInput].SetCountUninitialized(scopeNames.GetCount());
+
+      for (ezUInt32 uiNameId = 0; uiNameId < scopeNames.GetCount(); ++uiNameId)
+      {
+        ezUInt32 uiMergedNameId = 0;
+        if (!mergedNameIds.TryGetValue(scopeNames[uiNameId], uiMergedNameId))
+        {
+          uiMergedNameId = out_merged.m_ScopeNames.GetCount();
+          out_merged.m_ScopeNames.PushBack(scopeNames[uiNameId]);
+          mergedNameIds.Insert(scopeNames[uiNameId], uiMergedNameId);
+        }
+
+        nameIdRemapping[uiInput][uiNameId] = uiMergedNameId;
+      }
+    }
+  }
+
   // merge m_AllEventBuffers
   {
     struct CountAndIndex
@@ -229,13 +745,21 @@ void ezProfilingSystem::ProfilingData::Merge(ProfilingData& out_merged, ezArrayP
     }
 
     // fill the output array
-    for (const auto& pd : inputs)
+    for (ezUInt32 uiInput = 0; uiInput < inputs.GetCount(); ++uiInput)
     {
-      for (const auto& eb : pd->m_AllEventBuffers)
+      const ezDynamicArray<ezUInt32>& remapping = nameIdRemapping[uiInput];
+
+      for (const auto& eb : inputs[uiInput]->m_AllEventBuffers)
       {
         const auto& ebInfo = eventBufferInfos[eb.m_uiThreadId];
+        auto& targetData = out_merged.m_AllEventBuffers[ebInfo.m_uiIndex].m_Data;
 
-        out_merged.m_AllEventBuffers[ebInfo.m_uiIndex].m_Data.PushBackRange(eb.m_Data);
+        for (const CPUScope& scope : eb.m_Data)
+        {
+          CPUScope& mergedScope = targetData.ExpandAndGetRef();
+          mergedScope = scope;
+          mergedScope.m_uiNameId = scope.m_uiNameId < remapping.GetCount() ? remapping[scope.m_uiNameId] : 0;
+        }
       }
     }
   }
@@ -415,8 +939,10 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& ref_outputStrea
 
       for (const CPUScope& e : sortedScopes)
       {
+        const ezStringView sName = e.m_uiNameId < m_ScopeNames.GetCount() ? m_ScopeNames[e.m_uiNameId].GetView() : ezStringView();
+
         writer.BeginObject();
-        writer.AddVariableString("name", static_cast<const char*>(e.m_szName));
+        writer.AddVariableString("name", sName);
         writer.AddVariableUInt32("pid", m_uiProcessID);
         writer.AddVariableUInt64("tid", uiThreadId);
         writer.AddVariableUInt64("ts", static_cast<ezUInt64>(e.m_BeginTime.GetMicroseconds()));
@@ -434,7 +960,7 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& ref_outputStrea
         if (e.m_EndTime.IsPositive())
         {
           writer.BeginObject();
-          writer.AddVariableString("name", static_cast<const char*>(e.m_szName));
+          writer.AddVariableString("name", sName);
           writer.AddVariableUInt32("pid", m_uiProcessID);
           writer.AddVariableUInt64("tid", uiThreadId);
           writer.AddVariableUInt64("ts", static_cast<ezUInt64>(e.m_EndTime.GetMicroseconds()));
@@ -533,17 +1059,18 @@ ezResult ezProfilingSystem::ProfilingData::Write(ezStreamWriter& ref_outputStrea
 void ezProfilingSystem::Clear()
 {
   {
+    EZ_LOCK(s_CollectorMutex);
     EZ_LOCK(s_AllCpuScopesMutex);
+
     for (auto pEventBuffer : s_AllCpuScopes)
     {
-      if (pEventBuffer->IsMainThread())
-      {
-        CastToMainThreadEventBuffer(pEventBuffer)->m_Data.Clear();
-      }
-      else
-      {
-        CastToOtherThreadEventBuffer(pEventBuffer)->m_Data.Clear();
-      }
+      pEventBuffer->m_HandoverQueue.PopAll([](const CPUScope&) {});
+      pEventBuffer->ClearHistory();
+    }
+
+    if (s_pStreamWriter != nullptr)
+    {
+      s_pStreamWriter->m_PendingScopes.Clear();
     }
   }
 
@@ -584,6 +1111,9 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& ref_profilingD
   }
 
   {
+    EZ_LOCK(s_CollectorMutex);
+    CollectAllScopes();
+
     EZ_LOCK(s_AllCpuScopesMutex);
 
     ref_profilingData.m_AllEventBuffers.Reserve(s_AllCpuScopes.GetCount());
@@ -594,17 +1124,46 @@ void ezProfilingSystem::Capture(ezProfilingSystem::ProfilingData& ref_profilingD
 
       targetEventBuffer.m_uiThreadId = sourceEventBuffer->m_uiThreadId;
 
-      ezUInt32 uiSourceCount = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount() : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data.GetCount();
+      const ezUInt32 uiSourceCount = sourceEventBuffer->GetHistoryCount();
       targetEventBuffer.m_Data.SetCountUninitialized(uiSourceCount);
       for (ezUInt32 j = 0; j < uiSourceCount; ++j)
       {
-        const CPUScope& sourceEvent = sourceEventBuffer->IsMainThread() ? CastToMainThreadEventBuffer(sourceEventBuffer)->m_Data[j] : CastToOtherThreadEventBuffer(sourceEventBuffer)->m_Data[j];
+        targetEventBuffer.m_Data[j] = sourceEventBuffer->GetHistoryScope(j);
+      }
+    }
+  }
+
+  {
+    EZ_LOCK(s_ScopeNamesMutex);
+
+    ref_profilingData.m_ScopeNames.Reserve(ezMath::Max(s_ScopeNames.GetCount(), 1u));
+    ref_profilingData.m_ScopeNames.PushBack(ezString());
+    for (ezUInt32 i = 1; i < s_ScopeNames.GetCount(); ++i)
+    {
+      ref_profilingData.m_ScopeNames.PushBack(s_ScopeNames[i]);
+    }
+  }
+
+  // names that were not interned are only stored in the scopes themselves, give them IDs local to this capture
+  {
+    ezHashTable<ezString, ezUInt32> localNameIds;
+
+    for (CPUScopesBufferFlat& eventBuffer : ref_profilingData.m_AllEventBuffers)
+    {
+      for (CPUScope& scope : eventBuffer.m_Data)
+      {
+        if (scope.m_uiNameId != 0 || scope.m_szName[0] == '\0')
+          continue;
+
+        ezUInt32 uiNameId = 0;
+        if (!localNameIds.TryGetValue(scope.m_szName, uiNameId))
+        {
+          uiNameId = ref_profilingData.m_ScopeNames.GetCount();
+          ref_profilingData.m_ScopeNames.PushBack(scope.m_szName);
+          localNameIds.Insert(scope.m_szName, uiNameId);
+        }
 
-        CPUScope& copiedEvent = targetEventBuffer.m_Data[j];
-        copiedEvent.m_szFunctionName = sourceEvent.m_szFunctionName;
-        copiedEvent.m_BeginTime = sourceEvent.m_BeginTime;
-        copiedEvent.m_EndTime = sourceEvent.m_EndTime;
-        ezStringUtils::Copy(copiedEvent.m_szName, CPUScope::NAME_SIZE, sourceEvent.m_szName);
+        scope.m_uiNameId = uiNameId;
       }
     }
   }
@@ -661,17 +1220,108 @@ ezUInt64 ezProfilingSystem::GetFrameCount()
   return s_uiFrameCount;
 }
 
+// static
+ezResult ezProfilingSystem::StartStreaming(ezStringView sFilePath)
+{
+  EZ_LOCK(s_CollectorMutex);
+
+  if (s_pStreamWriter != nullptr)
+  {
+    ezLog::Error("Profiling data is already being streamed.");
+    return EZ_FAILURE;
+  }
+
+  ezUniquePtr<ProfilingStreamWriter> pWriter = EZ_DEFAULT_NEW(ProfilingStreamWriter);
+  if (pWriter->Open(sFilePath).Failed())
+  {
+    ezLog::Error("Could not open '{}' for streaming profiling data.", sFilePath);
+    return EZ_FAILURE;
+  }
+
+  // everything that was recorded before only goes into the history
+  CollectAllScopes();
+
+  {
+    EZ_LOCK(s_StreamingMutex);
+    s_StreamedFrames.Clear();
+    s_pStreamedGpuScopes = EZ_DEFAULT_NEW(StreamedGpuScopesBuffer);
+  }
+
+  s_pStreamWriter = std::move(pWriter);
+  s_iNumDroppedScopes = 0;
+  s_bStreaming = true;
+
+  return EZ_SUCCESS;
+}
+
+// static
+void ezProfilingSystem::StopStreaming()
+{
+  EZ_LOCK(s_CollectorMutex);
+
+  if (s_pStreamWriter == nullptr)
+    return;
+
+  s_bStreaming = false;
+
+  CollectAllScopes();
+
+  s_pStreamWriter->Close();
+  s_pStreamWriter.Clear();
+
+  {
+    EZ_LOCK(s_StreamingMutex);
+    s_pStreamedGpuScopes.Clear();
+  }
+
+  if (s_iNumDroppedScopes > 0)
+  {
+    ezLog::Warning("{} profiling scopes were dropped while streaming, because they were recorded faster than they could be collected.", (ezInt64)s_iNumDroppedScopes);
+  }
+}
+
+// static
+bool ezProfilingSystem::IsStreaming()
+{
+  return s_bStreaming;
+}
+
+// static
+void ezProfilingSystem::FlushStreaming()
+{
+  EZ_LOCK(s_CollectorMutex);
+
+  if (s_pStreamWriter != nullptr)
+  {
+    CollectAllScopes();
+  }
+}
+
 // static
 void ezProfilingSystem::StartNewFrame()
 {
   ++s_uiFrameCount;
 
+  const ezTime now = ezTime::Now();
+
   if (!s_FrameStartTimes.CanAppend())
   {
     s_FrameStartTimes.PopFront();
   }
 
-  s_FrameStartTimes.PushBack(ezTime::Now());
+  s_FrameStartTimes.PushBack(now);
+
+  if (s_bStreaming)
+  {
+    EZ_LOCK(s_StreamingMutex);
+
+    if (!s_StreamedFrames.CanAppend())
+    {
+      s_StreamedFrames.PopFront();
+    }
+
+    s_StreamedFrames.PushBack({s_uiFrameCount, now});
+  }
 }
 
 // static
@@ -709,27 +1359,37 @@ void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionNa
   scope.m_szFunctionName = szFunctionName;
   scope.m_BeginTime = beginTime;
   scope.m_EndTime = endTime;
-  ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), sName.GetStartPointer(), sName.GetEndPointer());
+  scope.m_uiNameId = InternScopeName(sName);
+  scope.m_szName[0] = '\0';
 
-  if (ezThreadUtils::IsMainThread())
+  if (scope.m_uiNameId == ezInvalidIndex)
   {
-    auto pMainThreadBuffer = CastToMainThreadEventBuffer(pScopes);
-    if (!pMainThreadBuffer->m_Data.CanAppend())
-    {
-      pMainThreadBuffer->m_Data.PopFront();
-    }
-
-    pMainThreadBuffer->m_Data.PushBack(scope);
+    scope.m_uiNameId = 0;
+    ezStringUtils::Copy(scope.m_szName, CPUScope::NAME_SIZE, sName.GetStartPointer(), sName.GetEndPointer());
   }
-  else
+
+  if (!pScopes->m_HandoverQueue.TryPush(scope))
   {
-    auto pOtherThreadBuffer = CastToOtherThreadEventBuffer(pScopes);
-    if (!pOtherThreadBuffer->m_Data.CanAppend())
+    // the collector can't keep up (or doesn't run at all), so make room by collecting the scopes of this thread right here
+    if (s_CollectorMutex.TryLock().Succeeded())
     {
-      pOtherThreadBuffer->m_Data.PopFront();
+      if (!s_bCollecting)
+      {
+        CollectScopes(*pScopes);
+      }
+
+      s_CollectorMutex.Unlock();
     }
 
-    pOtherThreadBuffer->m_Data.PushBack(scope);
+    if (!pScopes->m_HandoverQueue.TryPush(scope))
+    {
+      s_iNumDroppedScopes.Increment();
+    }
+  }
+  else if (pScopes->m_HandoverQueue.GetCount() == HANDOVER_QUEUE_SIZE / 2)
+  {
+    // don't wait for the next interval, if the queue is filling up quickly
+    s_CollectorWakeUp.RaiseSignal();
   }
 
   if (scopeTimeout.IsPositive() && duration > scopeTimeout && s_ScopeTimeoutCallback.IsValid())
@@ -738,6 +1398,27 @@ void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionNa
   }
 }
 
+// static
+void ezProfilingSystem::StartCollector()
+{
+  if (s_pCollectorThread == nullptr)
+  {
+    s_pCollectorThread = EZ_DEFAULT_NEW(ProfilingCollectorThread);
+    s_pCollectorThread->Start();
+  }
+}
+
+// static
+void ezProfilingSystem::StopCollector()
+{
+  if (s_pCollectorThread != nullptr)
+  {
+    s_pCollectorThread->RequestStop();
+    s_pCollectorThread->Join();
+    s_pCollectorThread.Clear();
+  }
+}
+
 // static
 void ezProfilingSystem::Initialize()
 {
@@ -751,6 +1432,7 @@ void ezProfilingSystem::Initialize()
 // static
 void ezProfilingSystem::Reset()
 {
+  EZ_LOCK(s_CollectorMutex);
   EZ_LOCK(s_ThreadInfosMutex);
   EZ_LOCK(s_AllCpuScopesMutex);
   for (ezUInt32 i = 0; i < s_DeadThreadIDs.GetCount(); i++)
@@ -835,6 +1517,22 @@ void ezProfilingSystem::AddGPUScope(ezStringView sName, ezTime beginTime, ezTime
   ezStringUtils::Copy(scope.m_szName, EZ_ARRAY_SIZE(scope.m_szName), sName.GetStartPointer(), sName.GetEndPointer());
 
   s_GPUScopes[uiGpuIndex]->PushBack(scope);
+
+  if (s_bStreaming && uiGpuIndex < STREAMING_MAX_GPUS)
+  {
+    EZ_LOCK(s_StreamingMutex);
+
+    if (s_pStreamedGpuScopes != nullptr)
+    {
+      if (!s_pStreamedGpuScopes->CanAppend())
+      {
+        s_pStreamedGpuScopes->PopFront();
+        s_iNumDroppedScopes.Increment();
+      }
+
+      s_pStreamedGpuScopes->PushBack({scope, uiGpuIndex});
+    }
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -903,10 +1601,28 @@ void ezProfilingSystem::SetDiscardThreshold(ezTime threshold) {}
 
 void ezProfilingSystem::StartNewFrame() {}
 
+ezResult ezProfilingSystem::StartStreaming(ezStringView sFilePath)
+{
+  return EZ_FAILURE;
+}
+
+void ezProfilingSystem::StopStreaming() {}
+
+bool ezProfilingSystem::IsStreaming()
+{
+  return false;
+}
+
+void ezProfilingSystem::FlushStreaming() {}
+
 void ezProfilingSystem::AddCPUScope(ezStringView sName, const char* szFunctionName, ezTime beginTime, ezTime endTime, ezTime scopeTimeout) {}
 
 void ezProfilingSystem::Initialize() {}
 
+void ezProfilingSystem::StartCollector() {}
+
+void ezProfilingSystem::StopCollector() {}
+
 void ezProfilingSystem::Reset() {}
 
 void ezProfilingSystem::SetThreadName(ezStringView sThreadName) {}
@@ -65,16 +65,22 @@ public:
     ezString m_sName;
   };
 
+  /// \brief Helper struct to hold CPU profiling data.
+  ///
+  /// Scope names are interned, so every name is stored only once and the scopes just reference it by ID.
+  /// The number of interned names is limited though, once that limit is reached, new names are copied into the scope instead.
   struct CPUScope
   {
     EZ_DECLARE_POD_TYPE();
 
-    static constexpr ezUInt32 NAME_SIZE = 40;
+    /// The name ID grew the struct beyond 64 bytes anyway, so the name buffer fills the remaining padding instead of getting shorter.
+    static constexpr ezUInt32 NAME_SIZE = 44;
 
     const char* m_szFunctionName;
     ezTime m_BeginTime;
     ezTime m_EndTime;
-    char m_szName[NAME_SIZE];
+    ezUInt32 m_uiNameId;     ///< Index into ProfilingData::m_ScopeNames.
+    char m_szName[NAME_SIZE]; ///< Only used while recording, for names that were not interned (m_uiNameId is zero then). Always resolved to an ID in ProfilingData.
   };
 
   struct CPUScopesBufferFlat
@@ -105,6 +111,9 @@ public:
 
     ezDynamicArray<CPUScopesBufferFlat> m_AllEventBuffers;
 
+    /// \brief The names of all CPU scopes, indexed by CPUScope::m_uiNameId. Index 0 is always the empty name.
+    ezDynamicArray<ezString> m_ScopeNames;
+
     ezUInt64 m_uiFrameCount = 0;
     ezDynamicArray<ezTime> m_FrameStartTimes;
 
@@ -141,6 +150,26 @@ public:
   /// \brief Get current frame counter
   static ezUInt64 GetFrameCount();
 
+  /// \brief Starts writing all CPU and GPU scopes, thread names and frame markers continuously to the given file.
+  ///
+  /// The file uses the JSON array flavor of the Chrome trace event format, which can be opened in chrome://tracing and ui.perfetto.dev,
+  /// even if the application terminates before StopStreaming() is called.
+  /// Every thread hands its scopes over to a background thread through a small, bounded, lock-free queue. The background thread regularly
+  /// collects all queues and appends their content to the file. Thus the memory consumption stays constant, no matter how long the session
+  /// runs. If a thread records scopes faster than they can be collected, its newest scopes get dropped.
+  ///
+  /// Capture() keeps working as usual while streaming.
+  static ezResult StartStreaming(ezStringView sFilePath);
+
+  /// \brief Writes all outstanding data and closes the file that was opened by StartStreaming().
+  static void StopStreaming();
+
+  /// \brief Returns whether StartStreaming() is currently active.
+  static bool IsStreaming();
+
+  /// \brief Writes all data that has been collected so far to the streaming file right away, instead of waiting for the background thread.
+  static void FlushStreaming();
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ProfilingSystem);
   friend ezUInt32 RunThread(ezThread* pThread);
@@ -149,6 +178,10 @@ private:
   /// \brief Removes profiling data of dead threads.
   static void Reset();
 
+  /// \brief Starts the background thread that regularly collects the scopes of all threads.
+  static void StartCollector();
+  static void StopCollector();
+
   /// \brief Sets the name of the current thread.
   static void SetThreadName(ezStringView sThreadName);
   /// \brief Removes the current thread from the profiling system.
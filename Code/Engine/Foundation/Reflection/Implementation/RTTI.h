@@ -143,6 +143,17 @@ public:
     return uiIndex < m_DynamicMessageHandlers.GetCount() && m_DynamicMessageHandlers.GetData()[uiIndex] != nullptr;
   }
 
+  /// \brief Returns the message handler for the message type with the given id, or nullptr if this type cannot handle it.
+  ///
+  /// Allows to dispatch many messages of the same type to instances of this type without looking up the handler every time.
+  inline ezAbstractMessageHandler* GetMessageHandler(ezMessageId id) const
+  {
+    EZ_ASSERT_DEBUG(m_uiMsgIdOffset != ezSmallInvalidIndex, "Message handler table should have been gathered at this point.");
+
+    const ezUInt32 uiIndex = id - m_uiMsgIdOffset;
+    return uiIndex < m_DynamicMessageHandlers.GetCount() ? m_DynamicMessageHandlers.GetData()[uiIndex] : nullptr;
+  }
+
   EZ_ALWAYS_INLINE const ezArrayPtr<ezMessageSenderInfo>& GetMessageSender() const { return m_MessageSenders; }
 
   struct ForEachOptions
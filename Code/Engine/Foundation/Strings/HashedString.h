@@ -14,7 +14,9 @@ class ezTempHashedString;
 /// (it's a pointer comparison).\n
 /// Copying ezHashedString objects around and assigning between them is very fast as well.\n
 /// \n
-/// Assigning from some other string type is rather slow though, as it requires thread synchronization.\n
+/// Assigning from some other string type is slower, as it requires hashing the string and looking it up in the central storage.
+/// The storage is split into many independently locked shards and strings that already exist are found without taking any lock,
+/// so many threads can assign hashed strings concurrently.\n
 /// You can also get access to the actual string data via GetString().\n
 /// \n
 /// You should use ezHashedString whenever the size of the encapsulating object is important and when changes to the string itself
@@ -29,12 +31,12 @@ public:
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
     ezAtomicInteger32 m_iRefCount;
 #endif
+    ezUInt64 m_uiHash = 0;
     ezString m_sString;
   };
 
-  // Do NOT use a hash-table! The map does not relocate memory when it resizes, which is a vital aspect for the hashed strings to work.
-  using StringStorage = ezMap<ezUInt64, HashedData, ezCompareHelper<ezUInt64>, ezStaticAllocatorWrapper>;
-  using HashedType = StringStorage::Iterator;
+  /// \brief Points to the string's entry in the central storage. Entries never move in memory, so this pointer stays valid.
+  using HashedType = HashedData*;
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
   /// \brief This will remove all hashed strings from the central storage, that are not referenced anymore.
@@ -81,7 +83,7 @@ public:
   template <size_t N>
   void Assign(char (&string)[N]) = delete;
 
-  /// \brief Assigning a new string from a non-hashed string is a very slow operation, this should be used rarely.
+  /// \brief Assigning a new string from a non-hashed string is a slow operation, this should be used rarely.
   ///
   /// If you need to create an object to compare ezHashedString objects against, prefer to use ezTempHashedString. It will only compute
   /// the strings hash value, but does not require any thread synchronization.
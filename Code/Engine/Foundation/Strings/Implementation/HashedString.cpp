@@ -1,19 +1,156 @@
 #include <Foundation/FoundationPCH.h>
 
 #include <Foundation/Logging/Log.h>
+#include <Foundation/Memory/AllocatorWrapper.h>
 #include <Foundation/Strings/HashedString.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
-struct HashedStringData
+#include <atomic>
+
+namespace
 {
-  ezMutex m_Mutex;
-  ezHashedString::StringStorage m_Storage;
-  ezHashedString::HashedType m_Empty;
-};
+  enum HashedStringStorageConstants
+  {
+    HASHED_STRING_SHARD_BITS = 6,
+    HASHED_STRING_NUM_SHARDS = 1 << HASHED_STRING_SHARD_BITS,
+    HASHED_STRING_INITIAL_TABLE_SIZE = 32,  // must be a power of two
+    HASHED_STRING_INITIAL_ARENA_CHUNK = 16, // number of entries in the first arena chunk of a shard
+    HASHED_STRING_MAX_ARENA_CHUNK = 1024,
+  };
+
+  /// Open-addressed hash table with linear probing. The slots only store pointers to the entries, so the table can be grown
+  /// without moving any strings.
+  struct HashedStringTable
+  {
+    ezUInt32 m_uiCapacity = 0; // always a power of two and kept at least twice as large as the number of entries
+    std::atomic<ezHashedString::HashedData*>* m_pSlots = nullptr;
+
+    // tables that were replaced by this one, they are kept alive, because other threads may still be reading them without a lock
+    HashedStringTable* m_pPreviousTable = nullptr;
+  };
+
+  /// Part of the central string storage. Every string goes into the shard that is selected by the top bits of its hash.
+  ///
+  /// Looking up an existing string only reads m_pTable and the slots, which is done without a lock.
+  /// Inserting a new string and growing the table is done while holding m_Mutex.
+  /// Each shard starts on its own cache line, so threads that work on different shards don't interfere.
+  struct alignas(64) HashedStringShard
+  {
+    ezMutex m_Mutex;
+    std::atomic<HashedStringTable*> m_pTable = {nullptr};
+    ezUInt32 m_uiNumEntries = 0;
+
+    // entries are allocated in chunks that are never freed, so their addresses stay stable
+    ezHashedString::HashedData* m_pArenaChunk = nullptr;
+    ezUInt32 m_uiArenaChunkSize = 0;
+    ezUInt32 m_uiArenaChunkUsed = 0;
+
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    // entries that were removed by ClearUnusedStrings() and can be reused
+    ezDynamicArray<ezHashedString::HashedData*, ezStaticAllocatorWrapper> m_FreeEntries;
+#endif
+  };
+
+  HashedStringTable* CreateHashedStringTable(ezUInt32 uiCapacity)
+  {
+    // the storage is never deallocated, so don't track its memory
+    ezAllocatorBase* pAllocator = ezStaticAllocatorWrapper::GetAllocator();
+
+    HashedStringTable* pTable = EZ_NEW(pAllocator, HashedStringTable);
+    pTable->m_uiCapacity = uiCapacity;
+    pTable->m_pSlots = EZ_NEW_RAW_BUFFER(pAllocator, std::atomic<ezHashedString::HashedData*>, uiCapacity);
+
+    for (ezUInt32 i = 0; i < uiCapacity; ++i)
+    {
+      pTable->m_pSlots[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    return pTable;
+  }
+
+  EZ_ALWAYS_INLINE HashedStringShard& GetHashedStringShard(HashedStringShard* pShards, ezUInt64 uiHash)
+  {
+    return pShards[uiHash >> (64 - HASHED_STRING_SHARD_BITS)];
+  }
+
+  /// Can be called concurrently with insertions. Every entry that is reachable through a slot is fully initialized.
+  ezHashedString::HashedData* FindHashedString(const HashedStringTable* pTable, ezUInt64 uiHash)
+  {
+    const ezUInt32 uiMask = pTable->m_uiCapacity - 1;
+
+    // the table is never full, so there is always an empty slot that ends the search
+    for (ezUInt32 uiSlot = static_cast<ezUInt32>(uiHash) & uiMask;; uiSlot = (uiSlot + 1) & uiMask)
+    {
+      ezHashedString::HashedData* pEntry = pTable->m_pSlots[uiSlot].load(std::memory_order_acquire);
+
+      if (pEntry == nullptr || pEntry->m_uiHash == uiHash)
+        return pEntry;
+    }
+  }
+
+  /// Must be called with the shard mutex locked.
+  void InsertHashedString(HashedStringTable* pTable, ezHashedString::HashedData* pEntry)
+  {
+    const ezUInt32 uiMask = pTable->m_uiCapacity - 1;
+
+    ezUInt32 uiSlot = static_cast<ezUInt32>(pEntry->m_uiHash) & uiMask;
+    while (pTable->m_pSlots[uiSlot].load(std::memory_order_relaxed) != nullptr)
+    {
+      uiSlot = (uiSlot + 1) & uiMask;
+    }
+
+    // publishes the fully initialized entry to threads that search the table without a lock
+    pTable->m_pSlots[uiSlot].store(pEntry, std::memory_order_release);
+  }
+
+  /// Must be called with the shard mutex locked.
+  ezHashedString::HashedData* AllocateHashedStringEntry(HashedStringShard& shard)
+  {
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+    if (!shard.m_FreeEntries.IsEmpty())
+    {
+      ezHashedString::HashedData* pEntry = shard.m_FreeEntries.PeekBack();
+      shard.m_FreeEntries.PopBack();
+      return new (pEntry) ezHashedString::HashedData();
+    }
+#endif
+
+    if (shard.m_uiArenaChunkUsed == shard.m_uiArenaChunkSize)
+    {
+      // start small, most shards only hold a few strings
+      shard.m_uiArenaChunkSize = ezMath::Clamp<ezUInt32>(shard.m_uiArenaChunkSize * 2, HASHED_STRING_INITIAL_ARENA_CHUNK, HASHED_STRING_MAX_ARENA_CHUNK);
+      shard.m_pArenaChunk = EZ_NEW_RAW_BUFFER(ezStaticAllocatorWrapper::GetAllocator(), ezHashedString::HashedData, shard.m_uiArenaChunkSize);
+      shard.m_uiArenaChunkUsed = 0;
+    }
+
+    return new (&shard.m_pArenaChunk[shard.m_uiArenaChunkUsed++]) ezHashedString::HashedData();
+  }
+
+  struct HashedStringData
+  {
+    HashedStringShard m_Shards[HASHED_STRING_NUM_SHARDS];
+    ezHashedString::HashedType m_Empty = nullptr;
+  };
+} // namespace
 
 static HashedStringData* s_pHSData;
 
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+static void CheckHashCollision(const ezHashedString::HashedData* pEntry, ezStringView sString, ezUInt64 uiHash)
+{
+  if (pEntry->m_sString != sString)
+  {
+    // TODO: I think this should be a more serious issue
+    ezLog::Error("Hash collision encountered: Strings \"{}\" and \"{}\" both hash to {}.", ezArgSensitive(pEntry->m_sString), ezArgSensitive(sString), uiHash);
+  }
+}
+#else
+EZ_ALWAYS_INLINE static void CheckHashCollision(const ezHashedString::HashedData*, ezStringView, ezUInt64)
+{
+}
+#endif
+
 EZ_MSVC_ANALYSIS_WARNING_PUSH
 EZ_MSVC_ANALYSIS_WARNING_DISABLE(6011) // Disable warning for null pointer dereference as InitHashedString() will ensure that s_pHSData is set
 
@@ -23,37 +160,73 @@ ezHashedString::HashedType ezHashedString::AddHashedString(ezStringView sString,
   if (s_pHSData == nullptr)
     InitHashedString();
 
-  EZ_LOCK(s_pHSData->m_Mutex);
-
-  // try to find the existing string
-  bool bExisted = false;
-  auto ret = s_pHSData->m_Storage.FindOrAdd(uiHash, &bExisted);
+  HashedStringShard& shard = GetHashedStringShard(s_pHSData->m_Shards, uiHash);
 
-  // if it already exists, just increase the refcount
-  if (bExisted)
+#if EZ_DISABLED(EZ_HASHED_STRING_REF_COUNTING)
+  // most strings exist already, those are found without taking the lock
+  // with ref counting this is not possible, as ClearUnusedStrings() may remove entries at any time
+  if (const HashedStringTable* pTable = shard.m_pTable.load(std::memory_order_acquire))
   {
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-    if (ret.Value().m_sString != sString)
+    if (HashedData* pEntry = FindHashedString(pTable, uiHash))
     {
-      // TODO: I think this should be a more serious issue
-      ezLog::Error("Hash collision encountered: Strings \"{}\" and \"{}\" both hash to {}.", ezArgSensitive(ret.Value().m_sString), ezArgSensitive(sString), uiHash);
+      CheckHashCollision(pEntry, sString, uiHash);
+      return pEntry;
     }
+  }
 #endif
 
+  EZ_LOCK(shard.m_Mutex);
+
+  HashedStringTable* pTable = shard.m_pTable.load(std::memory_order_relaxed);
+
+  if (pTable == nullptr)
+  {
+    pTable = CreateHashedStringTable(HASHED_STRING_INITIAL_TABLE_SIZE);
+    shard.m_pTable.store(pTable, std::memory_order_release);
+  }
+
+  // try to find the existing string, it may have been added by another thread in the mean time
+  if (HashedData* pEntry = FindHashedString(pTable, uiHash))
+  {
+    CheckHashCollision(pEntry, sString, uiHash);
+
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    ret.Value().m_iRefCount.Increment();
+    // if it already exists, just increase the refcount
+    pEntry->m_iRefCount.Increment();
 #endif
+
+    return pEntry;
   }
-  else
+
+  // keep the load factor at or below 50%, so that probe sequences stay short
+  if ((shard.m_uiNumEntries + 1) * 2 > pTable->m_uiCapacity)
   {
-    ezHashedString::HashedData& d = ret.Value();
+    HashedStringTable* pNewTable = CreateHashedStringTable(pTable->m_uiCapacity * 2);
+
+    for (ezUInt32 i = 0; i < pTable->m_uiCapacity; ++i)
+    {
+      if (HashedData* pEntry = pTable->m_pSlots[i].load(std::memory_order_relaxed))
+      {
+        InsertHashedString(pNewTable, pEntry);
+      }
+    }
+
+    pNewTable->m_pPreviousTable = pTable;
+    shard.m_pTable.store(pNewTable, std::memory_order_release);
+    pTable = pNewTable;
+  }
+
+  HashedData* pEntry = AllocateHashedStringEntry(shard);
+  pEntry->m_uiHash = uiHash;
+  pEntry->m_sString = sString;
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-    d.m_iRefCount = 1;
+  pEntry->m_iRefCount = 1;
 #endif
-    d.m_sString = sString;
-  }
 
-  return ret;
+  InsertHashedString(pTable, pEntry);
+  ++shard.m_uiNumEntries;
+
+  return pEntry;
 }
 
 EZ_MSVC_ANALYSIS_WARNING_POP
@@ -72,26 +245,54 @@ void ezHashedString::InitHashedString()
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
   // this one should never get deleted, so make sure its refcount is 2
-  s_pHSData->m_Empty.Value().m_iRefCount.Increment();
+  s_pHSData->m_Empty->m_iRefCount.Increment();
 #endif
 }
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
 ezUInt32 ezHashedString::ClearUnusedStrings()
 {
-  EZ_LOCK(s_pHSData->m_Mutex);
-
   ezUInt32 uiDeleted = 0;
 
-  for (auto it = s_pHSData->m_Storage.GetIterator(); it.IsValid();)
+  ezHybridArray<HashedData*, 64> remaining;
+
+  for (HashedStringShard& shard : s_pHSData->m_Shards)
   {
-    if (it.Value().m_iRefCount == 0)
+    EZ_LOCK(shard.m_Mutex);
+
+    HashedStringTable* pTable = shard.m_pTable.load(std::memory_order_relaxed);
+    if (pTable == nullptr)
+      continue;
+
+    remaining.Clear();
+
+    for (ezUInt32 i = 0; i < pTable->m_uiCapacity; ++i)
     {
-      it = s_pHSData->m_Storage.Remove(it);
-      ++uiDeleted;
+      HashedData* pEntry = pTable->m_pSlots[i].load(std::memory_order_relaxed);
+      if (pEntry == nullptr)
+        continue;
+
+      pTable->m_pSlots[i].store(nullptr, std::memory_order_relaxed);
+
+      if (pEntry->m_iRefCount == 0)
+      {
+        pEntry->~HashedData();
+        shard.m_FreeEntries.PushBack(pEntry);
+        ++uiDeleted;
+      }
+      else
+      {
+        remaining.PushBack(pEntry);
+      }
     }
-    else
-      ++it;
+
+    // with ref counting, all lookups hold the lock, so the table can simply be rebuilt in place
+    for (HashedData* pEntry : remaining)
+    {
+      InsertHashedString(pTable, pEntry);
+    }
+
+    shard.m_uiNumEntries = remaining.GetCount();
   }
 
   return uiDeleted;
@@ -112,7 +313,7 @@ ezHashedString::ezHashedString()
 
   m_Data = s_pHSData->m_Empty;
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-  m_Data.Value().m_iRefCount.Increment();
+  m_Data->m_iRefCount.Increment();
 #endif
 }
 
@@ -131,9 +332,9 @@ void ezHashedString::Clear()
     HashedType tmp = m_Data;
 
     m_Data = s_pHSData->m_Empty;
-    m_Data.Value().m_iRefCount.Increment();
+    m_Data->m_iRefCount.Increment();
 
-    tmp.Value().m_iRefCount.Decrement();
+    tmp->m_iRefCount.Decrement();
   }
 #else
   m_Data = s_pHSData->m_Empty;
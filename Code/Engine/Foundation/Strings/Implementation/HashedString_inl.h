@@ -9,24 +9,24 @@ inline ezHashedString::ezHashedString(const ezHashedString& rhs)
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
   // the string has a refcount of at least one (rhs holds a reference), thus it will definitely not get deleted on some other thread
   // therefore we can simply increase the refcount without locking
-  m_Data.Value().m_iRefCount.Increment();
+  m_Data->m_iRefCount.Increment();
 #endif
 }
 
 EZ_FORCE_INLINE ezHashedString::ezHashedString(ezHashedString&& rhs)
 {
   m_Data = rhs.m_Data;
-  rhs.m_Data = HashedType(); // This leaves the string in an invalid state, all operations will fail except the destructor
+  rhs.m_Data = nullptr; // This leaves the string in an invalid state, all operations will fail except the destructor
 }
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
 inline ezHashedString::~ezHashedString()
 {
   // Explicit check if data is still valid. It can be invalid if this string has been moved.
-  if (m_Data.IsValid())
+  if (m_Data != nullptr)
   {
     // just decrease the refcount of the object that we are set to, it might reach refcount zero, but we don't care about that here
-    m_Data.Value().m_iRefCount.Decrement();
+    m_Data->m_iRefCount.Decrement();
   }
 }
 #endif
@@ -37,9 +37,9 @@ inline void ezHashedString::operator=(const ezHashedString& rhs)
   HashedType tmp = rhs.m_Data;
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-  tmp.Value().m_iRefCount.Increment();
+  tmp->m_iRefCount.Increment();
 
-  m_Data.Value().m_iRefCount.Decrement();
+  m_Data->m_iRefCount.Decrement();
 #endif
 
   m_Data = tmp;
@@ -48,11 +48,11 @@ inline void ezHashedString::operator=(const ezHashedString& rhs)
 EZ_FORCE_INLINE void ezHashedString::operator=(ezHashedString&& rhs)
 {
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-  m_Data.Value().m_iRefCount.Decrement();
+  m_Data->m_iRefCount.Decrement();
 #endif
 
   m_Data = rhs.m_Data;
-  rhs.m_Data = HashedType();
+  rhs.m_Data = nullptr;
 }
 
 template <size_t N>
@@ -65,7 +65,7 @@ EZ_FORCE_INLINE void ezHashedString::Assign(const char (&string)[N])
   m_Data = AddHashedString(string, ezHashingUtils::StringHash(string));
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-  tmp.Value().m_iRefCount.Decrement();
+  tmp->m_iRefCount.Decrement();
 #endif
 }
 
@@ -78,7 +78,7 @@ EZ_FORCE_INLINE void ezHashedString::Assign(ezStringView sString)
   m_Data = AddHashedString(sString, ezHashingUtils::StringHash(sString));
 
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
-  tmp.Value().m_iRefCount.Decrement();
+  tmp->m_iRefCount.Decrement();
 #endif
 }
 
@@ -94,7 +94,7 @@ inline bool ezHashedString::operator!=(const ezHashedString& rhs) const
 
 inline bool ezHashedString::operator==(const ezTempHashedString& rhs) const
 {
-  return m_Data.Key() == rhs.m_uiHash;
+  return m_Data->m_uiHash == rhs.m_uiHash;
 }
 
 inline bool ezHashedString::operator!=(const ezTempHashedString& rhs) const
@@ -104,27 +104,27 @@ inline bool ezHashedString::operator!=(const ezTempHashedString& rhs) const
 
 inline bool ezHashedString::operator<(const ezHashedString& rhs) const
 {
-  return m_Data.Key() < rhs.m_Data.Key();
+  return m_Data->m_uiHash < rhs.m_Data->m_uiHash;
 }
 
 inline bool ezHashedString::operator<(const ezTempHashedString& rhs) const
 {
-  return m_Data.Key() < rhs.m_uiHash;
+  return m_Data->m_uiHash < rhs.m_uiHash;
 }
 
 EZ_ALWAYS_INLINE const ezString& ezHashedString::GetString() const
 {
-  return m_Data.Value().m_sString;
+  return m_Data->m_sString;
 }
 
 EZ_ALWAYS_INLINE const char* ezHashedString::GetData() const
 {
-  return m_Data.Value().m_sString.GetData();
+  return m_Data->m_sString.GetData();
 }
 
 EZ_ALWAYS_INLINE ezUInt64 ezHashedString::GetHash() const
 {
-  return m_Data.Key();
+  return m_Data->m_uiHash;
 }
 
 template <size_t N>
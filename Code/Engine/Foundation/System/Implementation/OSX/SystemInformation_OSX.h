@@ -47,6 +47,7 @@ void ezSystemInformation::Initialize()
 
   // Get system information via various APIs
   s_SystemInformation.m_uiCPUCoreCount = sysconf(_SC_NPROCESSORS_ONLN);
+  s_SystemInformation.m_CpuTopology.Detect(s_SystemInformation.m_uiCPUCoreCount);
 
   ezUInt64 uiPageSize = sysconf(_SC_PAGE_SIZE);
 
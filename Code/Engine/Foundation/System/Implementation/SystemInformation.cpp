@@ -16,6 +16,159 @@ ezSystemInformation ezSystemInformation::s_SystemInformation;
 #  error "System configuration functions are not implemented on current platform"
 #endif
 
+#if EZ_ENABLED(EZ_PLATFORM_LINUX) || EZ_ENABLED(EZ_PLATFORM_ANDROID)
+
+#  include <Foundation/IO/OSFile.h>
+#  include <Foundation/Strings/StringBuilder.h>
+#  include <Foundation/Utilities/ConversionUtils.h>
+#  include <sched.h>
+
+namespace
+{
+  /// \brief Reads a small text file from sysfs. Returns an empty string view, if the file does not exist.
+  ezStringView ReadSysFile(const char* szPath, char* pBuffer, ezUInt32 uiBufferSize)
+  {
+    ezOSFile file;
+    if (file.Open(szPath, ezFileOpenMode::Read).Failed())
+      return ezStringView();
+
+    const ezUInt64 uiRead = file.Read(pBuffer, uiBufferSize - 1);
+    file.Close();
+
+    pBuffer[uiRead] = '\0';
+    return ezStringView(pBuffer, pBuffer + uiRead);
+  }
+
+  ezUInt32 ReadSysFileUInt(const char* szPath, ezUInt32 uiDefault)
+  {
+    char buffer[64];
+    ezUInt32 uiValue = uiDefault;
+    if (ezConversionUtils::StringToUInt(ReadSysFile(szPath, buffer, EZ_ARRAY_SIZE(buffer)), uiValue).Failed())
+      return uiDefault;
+
+    return uiValue;
+  }
+} // namespace
+
+void ezCpuTopology::Detect(ezUInt32 uiNumLogicalCpus)
+{
+  m_uiNumLogicalCpus = ezMath::Min<ezUInt32>(ezMath::Max<ezUInt32>(uiNumLogicalCpus, (ezUInt32)sysconf(_SC_NPROCESSORS_CONF)), MaxLogicalCpus);
+  m_uiNumPhysicalCores = 0;
+  m_uiNumNumaNodes = 1;
+
+  cpu_set_t allowedCpus;
+  CPU_ZERO(&allowedCpus);
+  const bool bHasAffinity = sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus) == 0;
+
+  // the physical core of each logical CPU is identified by its package and its core ID within that package
+  ezUInt32 coreKeys[MaxLogicalCpus];
+  ezStringBuilder sPath;
+
+  for (ezUInt32 uiCpu = 0; uiCpu < m_uiNumLogicalCpus; ++uiCpu)
+  {
+    LogicalCpu& cpu = m_LogicalCpus[uiCpu];
+
+    sPath.Format("/sys/devices/system/cpu/cpu{}/online", uiCpu);
+    const bool bOnline = ReadSysFileUInt(sPath.GetData(), 1) != 0;
+
+    cpu.m_bIsAvailable = bOnline && (!bHasAffinity || CPU_ISSET(uiCpu, &allowedCpus));
+
+    sPath.Format("/sys/devices/system/cpu/cpu{}/topology/physical_package_id", uiCpu);
+    const ezUInt32 uiPackage = ReadSysFileUInt(sPath.GetData(), 0);
+
+    sPath.Format("/sys/devices/system/cpu/cpu{}/topology/core_id", uiCpu);
+    const ezUInt32 uiCoreId = ReadSysFileUInt(sPath.GetData(), uiCpu);
+
+    coreKeys[uiCpu] = (uiPackage << 16) | (uiCoreId & 0xFFFF);
+  }
+
+  // number the physical cores in order of appearance
+  ezUInt32 uiNumCores = 0;
+  for (ezUInt32 uiCpu = 0; uiCpu < m_uiNumLogicalCpus; ++uiCpu)
+  {
+    // find the first CPU on the same core, if there is any
+    ezUInt32 uiPrev = 0;
+    while (uiPrev < uiCpu && coreKeys[uiPrev] != coreKeys[uiCpu])
+      ++uiPrev;
+
+    m_LogicalCpus[uiCpu].m_uiPhysicalCore = (uiPrev < uiCpu) ? m_LogicalCpus[uiPrev].m_uiPhysicalCore : static_cast<ezUInt16>(uiNumCores++);
+  }
+
+  // the first available logical CPU of each physical core is its 'first sibling'
+  for (ezUInt32 uiCpu = 0; uiCpu < m_uiNumLogicalCpus; ++uiCpu)
+  {
+    LogicalCpu& cpu = m_LogicalCpus[uiCpu];
+    cpu.m_bIsFirstSibling = cpu.m_bIsAvailable;
+
+    for (ezUInt32 uiPrev = 0; uiPrev < uiCpu && cpu.m_bIsFirstSibling; ++uiPrev)
+    {
+      if (m_LogicalCpus[uiPrev].m_bIsAvailable && m_LogicalCpus[uiPrev].m_uiPhysicalCore == cpu.m_uiPhysicalCore)
+        cpu.m_bIsFirstSibling = false;
+    }
+
+    if (cpu.m_bIsFirstSibling)
+      ++m_uiNumPhysicalCores;
+  }
+
+  // the CPU list of each NUMA node, e.g. "0-7,16-23"
+  char buffer[1024];
+  for (ezUInt32 uiNode = 0; uiNode < MaxLogicalCpus; ++uiNode)
+  {
+    sPath.Format("/sys/devices/system/node/node{}/cpulist", uiNode);
+    ezStringView sCpuList = ReadSysFile(sPath.GetData(), buffer, EZ_ARRAY_SIZE(buffer));
+
+    if (sCpuList.IsEmpty())
+      break;
+
+    m_uiNumNumaNodes = uiNode + 1;
+
+    const char* szPos = sCpuList.GetStartPointer();
+    while (szPos < sCpuList.GetEndPointer())
+    {
+      ezUInt32 uiFirst = 0;
+      if (ezConversionUtils::StringToUInt(ezStringView(szPos, sCpuList.GetEndPointer()), uiFirst, &szPos).Failed())
+        break;
+
+      ezUInt32 uiLast = uiFirst;
+      if (*szPos == '-')
+      {
+        ++szPos;
+        if (ezConversionUtils::StringToUInt(ezStringView(szPos, sCpuList.GetEndPointer()), uiLast, &szPos).Failed())
+          break;
+      }
+
+      for (ezUInt32 uiCpu = uiFirst; uiCpu <= uiLast && uiCpu < m_uiNumLogicalCpus; ++uiCpu)
+      {
+        m_LogicalCpus[uiCpu].m_uiNumaNode = static_cast<ezUInt16>(uiNode);
+      }
+
+      if (*szPos == ',')
+        ++szPos;
+      else
+        break;
+    }
+  }
+}
+
+#else
+
+void ezCpuTopology::Detect(ezUInt32 uiNumLogicalCpus)
+{
+  m_uiNumLogicalCpus = ezMath::Min<ezUInt32>(uiNumLogicalCpus, MaxLogicalCpus);
+  m_uiNumPhysicalCores = m_uiNumLogicalCpus;
+  m_uiNumNumaNodes = 1;
+
+  for (ezUInt32 uiCpu = 0; uiCpu < m_uiNumLogicalCpus; ++uiCpu)
+  {
+    m_LogicalCpus[uiCpu].m_uiPhysicalCore = static_cast<ezUInt16>(uiCpu);
+    m_LogicalCpus[uiCpu].m_uiNumaNode = 0;
+    m_LogicalCpus[uiCpu].m_bIsFirstSibling = true;
+    m_LogicalCpus[uiCpu].m_bIsAvailable = true;
+  }
+}
+
+#endif
+
 /// CPU feature detection code copied from https://github.com/Mysticial/FeatureDetector
 
 #if EZ_ENABLED(EZ_PLATFORM_ARCH_X86)
@@ -52,6 +52,7 @@ void ezSystemInformation::Initialize()
   GetNativeSystemInfo(&sysInfo);
 
   s_SystemInformation.m_uiCPUCoreCount = sysInfo.dwNumberOfProcessors;
+  s_SystemInformation.m_CpuTopology.Detect(s_SystemInformation.m_uiCPUCoreCount);
   s_SystemInformation.m_uiMemoryPageSize = sysInfo.dwPageSize;
 
   MEMORYSTATUSEX memStatus;
@@ -89,6 +89,30 @@ struct ezCpuFeatures
   void Detect();
 };
 
+/// \brief Describes how the logical CPUs of the system map to physical cores and NUMA nodes.
+///
+/// Logical CPUs are indexed by their OS CPU number. Only CPUs that the process is allowed to run on are flagged as available.
+/// On platforms where the topology can't be detected, every logical CPU is treated as its own physical core on NUMA node 0.
+struct ezCpuTopology
+{
+  static constexpr ezUInt32 MaxLogicalCpus = 256;
+
+  struct LogicalCpu
+  {
+    ezUInt16 m_uiPhysicalCore = 0; ///< Index of the physical core, unique across all packages. Logical CPUs with the same index are SMT siblings.
+    ezUInt16 m_uiNumaNode = 0;     ///< The NUMA node that the CPU belongs to.
+    bool m_bIsFirstSibling = true; ///< True for the first (available) logical CPU of each physical core.
+    bool m_bIsAvailable = false;   ///< False, if the CPU is offline or if the process is not allowed to run on it.
+  };
+
+  ezUInt32 m_uiNumLogicalCpus = 0;   ///< Number of entries in m_LogicalCpus, including unavailable ones.
+  ezUInt32 m_uiNumPhysicalCores = 0; ///< Number of physical cores that have at least one available logical CPU.
+  ezUInt32 m_uiNumNumaNodes = 1;
+  LogicalCpu m_LogicalCpus[MaxLogicalCpus];
+
+  void Detect(ezUInt32 uiNumLogicalCpus);
+};
+
 /// \brief The system configuration class encapsulates information about the system the application is running on.
 ///
 /// Retrieve the system configuration by using ezSystemInformation::Get(). If you use the system configuration in startup code
@@ -123,6 +147,9 @@ public:
   /// \brief Returns a struct that contains detailed information about the available CPU features (SIMD support).
   const ezCpuFeatures& GetCpuFeatures() const { return m_CpuFeatures; }
 
+  /// \brief Returns how the logical CPUs map to physical cores and NUMA nodes.
+  const ezCpuTopology& GetCpuTopology() const { return m_CpuTopology; }
+
 public:
   /// \brief Returns whether a debugger is currently attached to this process.
   static bool IsDebuggerAttached();
@@ -146,6 +173,7 @@ private:
   bool m_bB64BitOS;
   bool m_bIsInitialized;
   ezCpuFeatures m_CpuFeatures;
+  ezCpuTopology m_CpuTopology;
 
   static void Initialize();
 
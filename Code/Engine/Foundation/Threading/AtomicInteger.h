@@ -25,7 +25,7 @@ struct ezAtomicStorageType<1>
 template <typename T>
 class ezAtomicInteger
 {
-  using UnderlyingType = typename ezAtomicStorageType<sizeof(T) / 32>::Type;
+  using UnderlyingType = typename ezAtomicStorageType<sizeof(T) / 8>::Type;
 
 public:
   EZ_DECLARE_POD_TYPE();
@@ -104,6 +104,12 @@ struct EZ_FOUNDATION_DLL ezAtomicUtils
   /// \brief If *dest* is equal to *expected*, this function sets *dest* to *value*. Otherwise *dest* will not be modified. Always returns the value
   /// of *dest* before the modification.
   static ezInt64 CompareAndSwap(volatile ezInt64& ref_iDest, ezInt64 iExpected, ezInt64 value); // [tested]
+
+  /// \brief Returns the value of src as an atomic operation with relaxed ordering, i.e. it does not synchronize any other memory accesses.
+  static ezUInt8 ReadRelaxed(volatile const ezUInt8& uiSrc); // [tested]
+
+  /// \brief Sets dest to value as an atomic operation with relaxed ordering, i.e. it does not synchronize any other memory accesses.
+  static void SetRelaxed(volatile ezUInt8& ref_uiDest, ezUInt8 value); // [tested]
 };
 
 // Include inline file
@@ -11,6 +11,20 @@
 #  error "Thread functions are not implemented on current platform"
 #endif
 
+void ezOSThread::SetCpuAffinity(ezArrayPtr<const ezUInt16> logicalCpus)
+{
+  for (ezUInt64& uiMask : m_CpuAffinityMask)
+  {
+    uiMask = 0;
+  }
 
+  for (ezUInt16 uiCpu : logicalCpus)
+  {
+    if (uiCpu < EZ_ARRAY_SIZE(m_CpuAffinityMask) * 64)
+    {
+      m_CpuAffinityMask[uiCpu / 64] |= ezUInt64(1) << (uiCpu % 64);
+    }
+  }
+}
 
 EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_OSThread);
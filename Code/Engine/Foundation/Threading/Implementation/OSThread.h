@@ -3,6 +3,7 @@
 #include <Foundation/Basics.h>
 
 #include <Foundation/Threading/Implementation/ThreadingDeclarations.h>
+#include <Foundation/Types/ArrayPtr.h>
 
 /// \brief Implementation of a thread.
 ///
@@ -26,6 +27,12 @@ public:
   /// \brief Waits in the calling thread until the thread has finished execution (e.g. returned from the thread function)
   void Join(); // [tested]
 
+  /// \brief Restricts the thread to the given logical CPUs (see ezCpuTopology). Must be called before Start(). An empty array removes all restrictions.
+  ///
+  /// Only has an effect on Linux and Windows, on Windows only the first 64 logical CPUs can be used.
+  /// Failing to apply the affinity (e.g. because the process may not use those CPUs) is not an error, the thread then just runs anywhere.
+  void SetCpuAffinity(ezArrayPtr<const ezUInt16> logicalCpus);
+
   /// \brief Returns the thread ID of the thread object, may be used in comparison operations with ezThreadUtils::GetCurrentThreadID() for
   /// example.
   const ezThreadID& GetThreadID() const { return m_ThreadID; }
@@ -45,6 +52,9 @@ protected:
 
   ezUInt32 m_uiStackSize;
 
+  // one bit per logical CPU, all zero means no restriction
+  ezUInt64 m_CpuAffinityMask[4] = {};
+
 
 private:
   /// Stores how many ezOSThread are currently active.
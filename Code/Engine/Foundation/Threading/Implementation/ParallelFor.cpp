@@ -2,6 +2,8 @@
 
 #include <Foundation/Threading/TaskSystem.h>
 
+#include <atomic>
+
 /// \brief This is a helper class that splits up task items via index ranges.
 template <typename IndexType, typename Callback>
 class IndexedTask final : public ezTask
@@ -39,6 +41,126 @@ private:
   Callback m_TaskCallback;
 };
 
+namespace
+{
+  /// \brief The state that all tasks of one adaptive ParallelFor share. Lives on the stack of the calling thread.
+  struct AdaptiveParallelForState
+  {
+    const ezParallelForIndexedFunction64* m_pTaskCallback = nullptr;
+    const char* m_szTaskName = nullptr;
+    ezTaskNesting m_NestingMode = ezTaskNesting::Never;
+    ezAllocatorBase* m_pAllocator = nullptr;
+
+    ezUInt64 m_uiMinChunkSize = 1;
+    ezUInt64 m_uiMaxChunkSize = 1;
+
+    // the number of items to process in one go, adjusted after every chunk
+    std::atomic<ezUInt64> m_uiChunkSize = 1;
+
+    // the number of ranges that are still being worked on, the calling thread waits for this to reach zero
+    std::atomic<ezUInt32> m_uiNumActiveRanges = 0;
+  };
+
+  // one chunk should take roughly this long, long enough to make the overhead of looking for idle threads negligible,
+  // short enough to be able to hand off work quickly, when another thread becomes idle
+  constexpr ezInt64 s_iTargetChunkNanoseconds = 20 * 1000;
+
+  void ProcessAdaptiveRange(AdaptiveParallelForState& ref_state, ezUInt64 uiStartIndex, ezUInt64 uiEndIndex);
+
+  /// \brief Processes one range of an adaptive ParallelFor, which may be split further.
+  class AdaptiveRangeTask final : public ezTask
+  {
+  public:
+    AdaptiveRangeTask(AdaptiveParallelForState* pState, ezUInt64 uiStartIndex, ezUInt64 uiEndIndex)
+      : m_pState(pState)
+      , m_uiStartIndex(uiStartIndex)
+      , m_uiEndIndex(uiEndIndex)
+    {
+    }
+
+  private:
+    virtual void Execute() override { ProcessAdaptiveRange(*m_pState, m_uiStartIndex, m_uiEndIndex); }
+
+    AdaptiveParallelForState* m_pState;
+    ezUInt64 m_uiStartIndex;
+    ezUInt64 m_uiEndIndex;
+  };
+
+  void ProcessAdaptiveRange(AdaptiveParallelForState& ref_state, ezUInt64 uiStartIndex, ezUInt64 uiEndIndex)
+  {
+    while (uiStartIndex < uiEndIndex)
+    {
+      const ezUInt64 uiChunkSize = ref_state.m_uiChunkSize.load(std::memory_order_relaxed);
+      const ezUInt64 uiRemainingItems = uiEndIndex - uiStartIndex;
+
+      // lazy splitting: only hand off work when someone is there to pick it up, then give away half of what is left
+      if (uiRemainingItems >= 2 * uiChunkSize && ezTaskSystem::HasIdleWorkerThreads(ezWorkerThreadType::ShortTasks))
+      {
+        const ezUInt64 uiSplitIndex = uiStartIndex + uiRemainingItems / 2;
+
+        ref_state.m_uiNumActiveRanges.fetch_add(1, std::memory_order_relaxed);
+
+        ezSharedPtr<AdaptiveRangeTask> pTask = EZ_NEW(ref_state.m_pAllocator, AdaptiveRangeTask, &ref_state, uiSplitIndex, uiEndIndex);
+        pTask->ConfigureTask(ref_state.m_szTaskName, ref_state.m_NestingMode);
+        ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::EarlyThisFrame);
+
+        uiEndIndex = uiSplitIndex;
+        continue;
+      }
+
+      const ezUInt64 uiChunkEndIndex = uiStartIndex + ezMath::Min(uiChunkSize, uiRemainingItems);
+
+      const ezTime tStart = ezTime::Now();
+      (*ref_state.m_pTaskCallback)(uiStartIndex, uiChunkEndIndex);
+      const ezInt64 iDurationNS = static_cast<ezInt64>((ezTime::Now() - tStart).GetNanoseconds());
+
+      // adjust the chunk size, such that the next chunk takes about the target time
+      // the new estimate is averaged with the previous one, so that a single outlier doesn't affect it too much
+      ezUInt64 uiIdealChunkSize = 2 * uiChunkSize;
+      if (iDurationNS > 0)
+      {
+        uiIdealChunkSize = static_cast<ezUInt64>((double)(uiChunkEndIndex - uiStartIndex) * s_iTargetChunkNanoseconds / iDurationNS);
+      }
+
+      const ezUInt64 uiNewChunkSize = ezMath::Clamp((uiChunkSize + uiIdealChunkSize) / 2, ref_state.m_uiMinChunkSize, ref_state.m_uiMaxChunkSize);
+      ref_state.m_uiChunkSize.store(uiNewChunkSize, std::memory_order_relaxed);
+
+      uiStartIndex = uiChunkEndIndex;
+    }
+
+    // this must be the very last access to the state, once it reaches zero, the calling thread may return
+    ref_state.m_uiNumActiveRanges.fetch_sub(1, std::memory_order_release);
+  }
+} // namespace
+
+void ezTaskSystem::ParallelForAdaptive(ezUInt64 uiStartIndex, ezUInt64 uiNumItems, const ezParallelForIndexedFunction64& taskCallback, const char* szTaskName, const ezParallelForParams& params)
+{
+  AdaptiveParallelForState state;
+  state.m_pTaskCallback = &taskCallback;
+  state.m_szTaskName = szTaskName;
+  state.m_NestingMode = params.m_NestingMode;
+  state.m_pAllocator = (params.m_pTaskAllocator != nullptr) ? params.m_pTaskAllocator : ezFoundation::GetDefaultAllocator();
+
+  // chunks must stay small enough, that every thread can get some part of the range
+  const ezUInt64 uiMaxRanges = (ezUInt64)(GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1) * ezMath::Max(1u, params.m_uiMaxTasksPerThread);
+  state.m_uiMinChunkSize = ezMath::Max(1u, params.m_uiBinSize);
+  state.m_uiMaxChunkSize = ezMath::Max(state.m_uiMinChunkSize, uiNumItems / (2 * uiMaxRanges));
+  state.m_uiChunkSize = state.m_uiMinChunkSize;
+
+  state.m_uiNumActiveRanges = 1;
+
+  {
+    EZ_PROFILE_SCOPE(szTaskName);
+    ProcessAdaptiveRange(state, uiStartIndex, uiStartIndex + uiNumItems);
+  }
+
+  if (state.m_uiNumActiveRanges.load(std::memory_order_acquire) != 0)
+  {
+    WaitForCondition([&state]()
+      { return state.m_uiNumActiveRanges.load(std::memory_order_acquire) == 0; });
+  }
+}
+
 template <typename IndexType, typename Callback>
 void ParallelForIndexedInternal(IndexType uiStartIndex, IndexType uiNumItems, Callback&& taskCallback, const char* szTaskName, const ezParallelForParams& params)
 {
@@ -129,13 +251,46 @@ void ezParallelForParams::DetermineThreading(ezUInt64 uiNumItemsToExecute, ezUIn
   }
 }
 
+ezUInt32 ezParallelForParams::DetermineNumBlocks(ezUInt64 uiNumItemsToExecute) const
+{
+  if (uiNumItemsToExecute <= m_uiBinSize)
+    return 1;
+
+  if (m_Mode == ezParallelForMode::Adaptive)
+  {
+    // use many small blocks, so that the blocks can be balanced across threads, even when their cost is very uneven
+    const ezUInt64 uiMaxBlocks = (ezUInt64)(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks) + 1) * ezMath::Max(1u, m_uiMaxTasksPerThread) * 8;
+    return static_cast<ezUInt32>(ezMath::Min(uiMaxBlocks, uiNumItemsToExecute / ezMath::Max(1u, m_uiBinSize)));
+  }
+
+  ezUInt32 uiNumBlocks;
+  ezUInt64 uiItemsPerBlock;
+  DetermineThreading(uiNumItemsToExecute, uiNumBlocks, uiItemsPerBlock);
+  return uiNumBlocks;
+}
+
 void ezTaskSystem::ParallelForIndexed(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction32 taskCallback, const char* szTaskName, const ezParallelForParams& params)
 {
+  if (params.m_Mode == ezParallelForMode::Adaptive && uiNumItems > params.m_uiBinSize)
+  {
+    ezParallelForIndexedFunction64 wrappedCallback = [&taskCallback](ezUInt64 uiRangeStartIndex, ezUInt64 uiRangeEndIndex)
+    { taskCallback(static_cast<ezUInt32>(uiRangeStartIndex), static_cast<ezUInt32>(uiRangeEndIndex)); };
+
+    ParallelForAdaptive(uiStartIndex, uiNumItems, wrappedCallback, szTaskName ? szTaskName : "Generic Indexed Task", params);
+    return;
+  }
+
   ParallelForIndexedInternal<ezUInt32, ezParallelForIndexedFunction32>(uiStartIndex, uiNumItems, std::move(taskCallback), szTaskName, params);
 }
 
 void ezTaskSystem::ParallelForIndexed(ezUInt64 uiStartIndex, ezUInt64 uiNumItems, ezParallelForIndexedFunction64 taskCallback, const char* szTaskName, const ezParallelForParams& params)
 {
+  if (params.m_Mode == ezParallelForMode::Adaptive && uiNumItems > params.m_uiBinSize)
+  {
+    ParallelForAdaptive(uiStartIndex, uiNumItems, taskCallback, szTaskName ? szTaskName : "Generic Indexed Task", params);
+    return;
+  }
+
   ParallelForIndexedInternal<ezUInt64, ezParallelForIndexedFunction64>(uiStartIndex, uiNumItems, std::move(taskCallback), szTaskName, params);
 }
 
@@ -52,6 +52,17 @@ void ezTaskSystem::ParallelForInternal(ezArrayPtr<ElemType> taskItems, ezParalle
     EZ_PROFILE_SCOPE(arrayPtrTask.m_sTaskName);
     arrayPtrTask.Execute();
   }
+  else if (params.m_Mode == ezParallelForMode::Adaptive)
+  {
+    const ezParallelForFunction<ElemType>& callback = taskCallback;
+    ezParallelForIndexedFunction64 wrappedCallback = [&callback, taskItems](ezUInt64 uiStartIndex, ezUInt64 uiEndIndex)
+    {
+      const ezUInt32 uiSliceStartIndex = static_cast<ezUInt32>(uiStartIndex);
+      callback(uiSliceStartIndex, taskItems.GetSubArray(uiSliceStartIndex, static_cast<ezUInt32>(uiEndIndex - uiStartIndex)));
+    };
+
+    ParallelForAdaptive(0, taskItems.GetCount(), wrappedCallback, taskName ? taskName : "Generic ArrayPtr Task", params);
+  }
   else
   {
     ezUInt32 uiMultiplicity;
@@ -109,3 +120,197 @@ void ezTaskSystem::ParallelForSingleIndex(
   ParallelForInternal<ElemType>(
     taskItems, ezParallelForFunction<ElemType>(std::move(wrappedCallback), ezFrameAllocator::GetCurrentAllocator()), szTaskName, params);
 }
+
+template <typename ResultType, typename MapCallback, typename ReduceCallback>
+ResultType ezTaskSystem::ParallelReduce(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, const ResultType& identity, MapCallback mapCallback,
+  ReduceCallback reduceCallback, const char* szTaskName, const ezParallelForParams& params)
+{
+  if (uiNumItems == 0)
+    return identity;
+
+  const ezUInt32 uiNumBlocks = params.DetermineNumBlocks(uiNumItems);
+
+  if (uiNumBlocks <= 1)
+  {
+    EZ_PROFILE_SCOPE(szTaskName ? szTaskName : "Generic Reduce Task");
+    return mapCallback(uiStartIndex, uiStartIndex + uiNumItems);
+  }
+
+  struct Context
+  {
+    MapCallback* m_pMapCallback;
+    ResultType* m_pPartialResults;
+    ezUInt32 m_uiStartIndex;
+    ezUInt32 m_uiEndIndex;
+    ezUInt32 m_uiItemsPerBlock;
+  };
+
+  ezHybridArray<ResultType, 16> partialResults;
+  partialResults.SetCount(uiNumBlocks, identity);
+
+  Context ctxt{&mapCallback, partialResults.GetData(), uiStartIndex, uiStartIndex + uiNumItems, (uiNumItems + uiNumBlocks - 1) / uiNumBlocks};
+
+  // the blocks are already as large as they should be, don't let the ParallelFor merge them any further
+  ezParallelForParams blockParams = params;
+  blockParams.m_uiBinSize = 1;
+
+  ParallelForIndexed(
+    0u, uiNumBlocks,
+    [pCtxt = &ctxt](ezUInt32 uiFirstBlock, ezUInt32 uiEndBlock)
+    {
+      for (ezUInt32 uiBlock = uiFirstBlock; uiBlock < uiEndBlock; ++uiBlock)
+      {
+        const ezUInt32 uiBlockStart = pCtxt->m_uiStartIndex + uiBlock * pCtxt->m_uiItemsPerBlock;
+        const ezUInt32 uiBlockEnd = ezMath::Min(uiBlockStart + pCtxt->m_uiItemsPerBlock, pCtxt->m_uiEndIndex);
+
+        if (uiBlockStart < uiBlockEnd)
+        {
+          pCtxt->m_pPartialResults[uiBlock] = (*pCtxt->m_pMapCallback)(uiBlockStart, uiBlockEnd);
+        }
+      }
+    },
+    szTaskName ? szTaskName : "Generic Reduce Task", blockParams);
+
+  // combine the partial results in order, so that the reduce operation does not need to be commutative
+  // blocks past the end (due to rounding) still hold 'identity', so they are simply skipped
+  const ezUInt32 uiNumUsedBlocks = (uiNumItems + ctxt.m_uiItemsPerBlock - 1) / ctxt.m_uiItemsPerBlock;
+
+  ResultType result = std::move(partialResults[0]);
+  for (ezUInt32 uiBlock = 1; uiBlock < uiNumUsedBlocks; ++uiBlock)
+  {
+    result = reduceCallback(result, partialResults[uiBlock]);
+  }
+
+  return result;
+}
+
+template <typename ElemType, typename Callback>
+void ezTaskSystem::ParallelInclusiveScan(ezArrayPtr<ElemType> taskItems, Callback op, const char* szTaskName, const ezParallelForParams& params)
+{
+  ParallelScanInternal<ElemType, Callback>(taskItems, nullptr, op, szTaskName ? szTaskName : "Generic Scan Task", params);
+}
+
+template <typename ElemType, typename Callback>
+void ezTaskSystem::ParallelExclusiveScan(ezArrayPtr<ElemType> taskItems, const ElemType& initialValue, Callback op, const char* szTaskName, const ezParallelForParams& params)
+{
+  ParallelScanInternal<ElemType, Callback>(taskItems, &initialValue, op, szTaskName ? szTaskName : "Generic Scan Task", params);
+}
+
+template <typename ElemType, typename Callback>
+void ezTaskSystem::ParallelScanInternal(ezArrayPtr<ElemType> taskItems, const ElemType* pInitialValue, Callback& op, const char* szTaskName, const ezParallelForParams& params)
+{
+  if (taskItems.IsEmpty())
+    return;
+
+  struct Context
+  {
+    Callback* m_pOp;
+    const ElemType* m_pInitialValue;
+    ElemType* m_pItems;
+    ElemType* m_pBlockTotals;
+    ezUInt32 m_uiNumItems;
+    ezUInt32 m_uiItemsPerBlock;
+
+    // scans the given range in place, starting with pInitial, if available
+    void ScanRange(ezUInt32 uiStart, ezUInt32 uiEnd, const ElemType* pInitial) const
+    {
+      if (m_pInitialValue != nullptr)
+      {
+        ElemType sum = pInitial ? *pInitial : *m_pInitialValue;
+        for (ezUInt32 i = uiStart; i < uiEnd; ++i)
+        {
+          ElemType next = (*m_pOp)(sum, m_pItems[i]);
+          m_pItems[i] = std::move(sum);
+          sum = std::move(next);
+        }
+      }
+      else
+      {
+        ezUInt32 i = uiStart;
+        if (pInitial == nullptr)
+        {
+          ++i; // the first item stays as it is
+        }
+        else
+        {
+          m_pItems[i] = (*m_pOp)(*pInitial, m_pItems[i]);
+          ++i;
+        }
+
+        for (; i < uiEnd; ++i)
+        {
+          m_pItems[i] = (*m_pOp)(m_pItems[i - 1], m_pItems[i]);
+        }
+      }
+    }
+  };
+
+  const ezUInt32 uiNumItems = taskItems.GetCount();
+  const ezUInt32 uiNumBlocks = params.DetermineNumBlocks(uiNumItems);
+
+  Context ctxt{&op, pInitialValue, taskItems.GetPtr(), nullptr, uiNumItems, (uiNumItems + uiNumBlocks - 1) / uiNumBlocks};
+
+  if (uiNumBlocks <= 1)
+  {
+    EZ_PROFILE_SCOPE(szTaskName);
+    ctxt.ScanRange(0, uiNumItems, nullptr);
+    return;
+  }
+
+  const ezUInt32 uiNumUsedBlocks = (uiNumItems + ctxt.m_uiItemsPerBlock - 1) / ctxt.m_uiItemsPerBlock;
+
+  // the totals of all blocks but the last, which is not needed
+  ezHybridArray<ElemType, 16> blockTotals;
+  blockTotals.SetCount(uiNumUsedBlocks - 1, taskItems[0]);
+  ctxt.m_pBlockTotals = blockTotals.GetData();
+
+  ezParallelForParams blockParams = params;
+  blockParams.m_uiBinSize = 1;
+
+  // first pass: compute the total of every block independently
+  ParallelForIndexed(
+    0u, uiNumUsedBlocks - 1,
+    [pCtxt = &ctxt](ezUInt32 uiFirstBlock, ezUInt32 uiEndBlock)
+    {
+      for (ezUInt32 uiBlock = uiFirstBlock; uiBlock < uiEndBlock; ++uiBlock)
+      {
+        const ezUInt32 uiBlockStart = uiBlock * pCtxt->m_uiItemsPerBlock;
+        const ezUInt32 uiBlockEnd = uiBlockStart + pCtxt->m_uiItemsPerBlock;
+
+        ElemType sum = pCtxt->m_pItems[uiBlockStart];
+        for (ezUInt32 i = uiBlockStart + 1; i < uiBlockEnd; ++i)
+        {
+          sum = (*pCtxt->m_pOp)(sum, pCtxt->m_pItems[i]);
+        }
+
+        pCtxt->m_pBlockTotals[uiBlock] = std::move(sum);
+      }
+    },
+    szTaskName, blockParams);
+
+  // turn the block totals into the running total of everything before the next block, the number of blocks is small, so this is done serially
+  if (pInitialValue != nullptr)
+  {
+    blockTotals[0] = op(*pInitialValue, blockTotals[0]);
+  }
+
+  for (ezUInt32 uiBlock = 1; uiBlock < blockTotals.GetCount(); ++uiBlock)
+  {
+    blockTotals[uiBlock] = op(blockTotals[uiBlock - 1], blockTotals[uiBlock]);
+  }
+
+  // second pass: scan every block, starting with the total of all previous blocks
+  ParallelForIndexed(
+    0u, uiNumUsedBlocks,
+    [pCtxt = &ctxt](ezUInt32 uiFirstBlock, ezUInt32 uiEndBlock)
+    {
+      for (ezUInt32 uiBlock = uiFirstBlock; uiBlock < uiEndBlock; ++uiBlock)
+      {
+        const ezUInt32 uiBlockStart = uiBlock * pCtxt->m_uiItemsPerBlock;
+        const ezUInt32 uiBlockEnd = ezMath::Min(uiBlockStart + pCtxt->m_uiItemsPerBlock, pCtxt->m_uiNumItems);
+
+        pCtxt->ScanRange(uiBlockStart, uiBlockEnd, uiBlock > 0 ? &pCtxt->m_pBlockTotals[uiBlock - 1] : nullptr);
+      }
+    },
+    szTaskName, blockParams);
+}
@@ -198,3 +198,13 @@ EZ_ALWAYS_INLINE ezInt64 ezAtomicUtils::CompareAndSwap(volatile ezInt64& dest, e
 {
   return __sync_val_compare_and_swap_8(&dest, expected, value);
 }
+
+EZ_ALWAYS_INLINE ezUInt8 ezAtomicUtils::ReadRelaxed(volatile const ezUInt8& src)
+{
+  return __atomic_load_n(&src, __ATOMIC_RELAXED);
+}
+
+EZ_ALWAYS_INLINE void ezAtomicUtils::SetRelaxed(volatile ezUInt8& dest, ezUInt8 value)
+{
+  __atomic_store_n(&dest, value, __ATOMIC_RELAXED);
+}
@@ -31,7 +31,42 @@ void ezOSThread::Start()
   pthread_attr_setdetachstate(&ThreadAttributes, PTHREAD_CREATE_JOINABLE);
   pthread_attr_setstacksize(&ThreadAttributes, m_uiStackSize);
 
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+  bool bAffinitySet = false;
+
+  if ((m_CpuAffinityMask[0] | m_CpuAffinityMask[1] | m_CpuAffinityMask[2] | m_CpuAffinityMask[3]) != 0)
+  {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    for (ezUInt32 uiCpu = 0; uiCpu < EZ_ARRAY_SIZE(m_CpuAffinityMask) * 64; ++uiCpu)
+    {
+      if ((m_CpuAffinityMask[uiCpu / 64] >> (uiCpu % 64)) & 1)
+      {
+        CPU_SET(uiCpu, &cpuSet);
+      }
+    }
+
+    // set on the attributes, so that the thread never runs on any other CPU, not even before it gets pinned
+    bAffinitySet = pthread_attr_setaffinity_np(&ThreadAttributes, sizeof(cpuSet), &cpuSet) == 0;
+  }
+#endif
+
   int iReturnCode = pthread_create(&m_hHandle, &ThreadAttributes, m_EntryPoint, m_pUserData);
+
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+  if (iReturnCode == EINVAL && bAffinitySet)
+  {
+    // the process is restricted to other CPUs, which is fine, the thread just isn't pinned then
+    pthread_attr_destroy(&ThreadAttributes);
+    pthread_attr_init(&ThreadAttributes);
+    pthread_attr_setdetachstate(&ThreadAttributes, PTHREAD_CREATE_JOINABLE);
+    pthread_attr_setstacksize(&ThreadAttributes, m_uiStackSize);
+
+    iReturnCode = pthread_create(&m_hHandle, &ThreadAttributes, m_EntryPoint, m_pUserData);
+  }
+#endif
+
   EZ_IGNORE_UNUSED(iReturnCode);
   EZ_ASSERT_RELEASE(iReturnCode == 0, "Thread creation failed!");
 
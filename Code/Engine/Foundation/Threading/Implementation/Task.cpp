@@ -9,6 +9,7 @@ ezTask::~ezTask() = default;
 void ezTask::Reset()
 {
   m_iRemainingRuns = (int)ezMath::Max(1u, m_uiMultiplicity);
+  m_iStartedRuns = 0;
   m_bCancelExecution = false;
   m_bTaskIsScheduled = false;
   m_bUsesMultiplicity = m_uiMultiplicity > 0;
@@ -31,7 +32,10 @@ void ezTask::SetMultiplicity(ezUInt32 uiMultiplicity)
 
 void ezTask::Run(ezUInt32 uiInvocation)
 {
-  // actually this should not be possible to happen
+  // this is a full memory barrier, so either CancelTask() sees this invocation as started, or we see the cancel flag below
+  m_iStartedRuns.Increment();
+
+  // happens for tasks that were canceled while they were stored in a work-stealing queue
   if (m_iRemainingRuns == 0 || m_bCancelExecution)
   {
     m_iRemainingRuns = 0;
@@ -87,6 +87,10 @@ private:
   /// \brief Decremented when a task is finished, set to zero when canceled.
   ezAtomicInteger32 m_iRemainingRuns;
 
+  /// \brief Incremented before an invocation checks the cancel flag. Used to determine whether a task that sits in a lock-free queue
+  /// (and thus cannot be removed from it) was prevented from running by CancelTask().
+  ezAtomicInteger32 m_iStartedRuns;
+
   /// \brief Set to true when the task is SUPPOSED to cancel. Whether the task is able to do that, depends on its implementation.
   bool m_bCancelExecution = false;
 
@@ -25,9 +25,10 @@ void ezTaskGroup::Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCall
   m_bInUse = true;
   m_bStartedByUser = false;
   m_uiGroupCounter += 2; // even if it wraps around, it will never be zero, thus zero stays an invalid group counter
+  m_uiDependentsHead = MakeDependentsHead(m_uiGroupCounter, InvalidDependentLink);
   m_Tasks.Clear();
   m_DependsOnGroups.Clear();
-  m_OthersDependingOnMe.Clear();
+  m_NextDependentLink.Clear();
   m_Priority = priority;
   m_OnFinishedCallback = callback;
 }
@@ -5,6 +5,8 @@
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
 #include <Foundation/Types/SharedPtr.h>
 
+#include <atomic>
+
 /// \internal Represents the state of a group of tasks that can be waited on
 class ezTaskGroup
 {
@@ -27,13 +29,31 @@ private:
   void WaitForFinish(ezTaskGroupID group) const;
   void Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback callback);
 
+  /// \brief Builds the value of m_uiDependentsHead from a group counter and the ID of the first link in the list of dependent groups.
+  static constexpr ezUInt64 MakeDependentsHead(ezUInt32 uiGroupCounter, ezUInt32 uiFirstLink) { return (static_cast<ezUInt64>(uiGroupCounter) << 32) | uiFirstLink; }
+
+  /// \brief Marks the end of the list of dependent groups.
+  static constexpr ezUInt32 InvalidDependentLink = 0xFFFFFFFFu;
+
   bool m_bInUse = true;
   bool m_bStartedByUser = false;
-  ezUInt16 m_uiTaskGroupIndex = 0xFFFF; // only there as a debugging aid
-  ezUInt32 m_uiGroupCounter = 1;
+  ezUInt16 m_uiTaskGroupIndex = 0xFFFF; // the slot in ezTaskSystemState's group storage
+  std::atomic<ezUInt32> m_uiGroupCounter = 1;
   ezHybridArray<ezSharedPtr<ezTask>, 16> m_Tasks;
   ezHybridArray<ezTaskGroupID, 4> m_DependsOnGroups;
-  ezHybridArray<ezTaskGroupID, 8> m_OthersDependingOnMe;
+
+  // For every entry in m_DependsOnGroups, the ID of the next link in the dependents list of that other group.
+  // A link ID is (m_uiTaskGroupIndex << 16 | dependency index), so it identifies the dependent group and the entry in here.
+  ezHybridArray<ezUInt32, 4> m_NextDependentLink;
+
+  // Lock-free list of all the groups that wait for this group to finish: upper 32 bit are the group counter, lower 32 bit the first link.
+  // Finishing the group swaps in the new group counter, which atomically closes the list, so a group that tries to add itself
+  // with an outdated counter knows that this dependency is already fulfilled.
+  std::atomic<ezUInt64> m_uiDependentsHead = MakeDependentsHead(1, InvalidDependentLink);
+
+  // Links this group into the free list of ezTaskSystemState, while it is not in use.
+  std::atomic<ezUInt32> m_uiNextFreeGroup = 0xFFFFFFFFu;
+
   ezAtomicInteger32 m_iNumActiveDependencies;
   ezAtomicInteger32 m_iNumRemainingTasks;
   ezOnTaskGroupFinishedCallback m_OnFinishedCallback;
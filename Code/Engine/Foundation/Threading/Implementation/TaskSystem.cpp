@@ -38,6 +38,7 @@ void ezTaskSystem::Startup()
 
   tl_TaskWorkerInfo.m_WorkerType = ezWorkerThreadType::MainThread;
   tl_TaskWorkerInfo.m_iWorkerIndex = 0;
+  tl_TaskWorkerInfo.m_pLocalQueues = &s_pThreadState->m_MainThreadQueues;
 
   // initialize with the default number of worker threads
   SetWorkerThreadCount();
@@ -12,6 +12,7 @@ class ezTaskGroup;
 class ezTaskWorkerThread;
 class ezTaskSystemState;
 class ezTaskSystemThreadState;
+struct ezTaskWorkStealingQueues;
 class ezDGMLGraph;
 class ezAllocatorBase;
 
@@ -82,6 +83,35 @@ struct ezOnTaskRunning
   };
 };
 
+/// \brief Selects how the ezTaskSystem distributes scheduled tasks onto the worker threads.
+struct ezTaskSchedulingMode
+{
+  enum Enum : ezUInt8
+  {
+    GlobalQueue,  ///< All scheduled tasks are stored in one global list per priority, which is protected by a single mutex.
+    WorkStealing, ///< Worker threads push the tasks that they schedule into thread local lock-free queues (one per priority) and idle
+                  ///< workers steal from the queues of other threads. Priorities that need special handling (e.g. 'next frame', file access and
+                  ///< main thread tasks) still go through the global lists. Scales better with many cores and many small tasks.
+
+    Default = GlobalQueue
+  };
+};
+
+/// \brief Selects on which CPUs the ezTaskSystem worker threads are allowed to run. See ezCpuTopology.
+struct ezTaskThreadAffinity
+{
+  enum Enum : ezUInt8
+  {
+    None,         ///< The OS decides where to run the worker threads and may migrate them at any time.
+    NumaNode,     ///< Every worker thread is restricted to the CPUs of one NUMA node. The workers of each type are spread evenly across the nodes,
+                  ///< consecutive workers share a node.
+    PhysicalCore, ///< Like 'NumaNode', but additionally every short task worker is pinned to the first hardware thread of its own physical core,
+                  ///< so that short task workers never compete for the same core through SMT. Long running and file workers only get the node affinity.
+
+    Default = None
+  };
+};
+
 /// \internal Enum that lists the different task worker thread types.
 struct ezWorkerThreadType
 {
@@ -162,6 +192,22 @@ enum class ezTaskNesting
   Never,
 };
 
+/// \brief Selects how ParallelFor and its variants split up the items into tasks.
+struct ezParallelForMode
+{
+  enum Enum : ezUInt8
+  {
+    Static,   ///< The items are split up front into equally sized ranges, according to ezParallelForParams::m_uiBinSize and m_uiMaxTasksPerThread.
+              ///< Works best when all items take about the same amount of time and that time is not tiny.
+    Adaptive, ///< The calling thread starts with the entire range and hands off the upper half of its remaining range whenever a worker thread is idle.
+              ///< The items are processed in chunks, whose size is adjusted at runtime, such that each chunk takes roughly the same amount of time.
+              ///< Works well both for very cheap items and for items with very uneven cost. m_uiBinSize is the minimum chunk size.
+              ///< The tasks that process the handed off ranges use m_NestingMode, so with ezTaskNesting::Maybe the callback may wait for other tasks.
+
+    Default = Static
+  };
+};
+
 /// \brief Settings for ezTaskSystem::ParallelFor invocations.
 struct EZ_FOUNDATION_DLL ezParallelForParams
 {
@@ -182,10 +228,17 @@ struct EZ_FOUNDATION_DLL ezParallelForParams
 
   ezTaskNesting m_NestingMode = ezTaskNesting::Never;
 
+  /// How the items are split up into tasks, see ezParallelForMode.
+  ezParallelForMode::Enum m_Mode = ezParallelForMode::Default;
+
   /// The allocator used to for the tasks that the parallel-for uses internally. If null, will use the default allocator.
   ezAllocatorBase* m_pTaskAllocator = nullptr;
 
   void DetermineThreading(ezUInt64 uiNumItemsToExecute, ezUInt32& out_uiNumTasksToRun, ezUInt64& out_uiNumItemsPerTask) const;
+
+  /// Returns into how many blocks ParallelReduce and the parallel scans split the given number of items.
+  /// Each block produces one partial result, the blocks are then distributed across tasks like any other ParallelFor.
+  ezUInt32 DetermineNumBlocks(ezUInt64 uiNumItemsToExecute) const;
 };
 
 using ezParallelForIndexedFunction32 = ezDelegate<void(ezUInt32, ezUInt32), 48>;
@@ -9,32 +9,93 @@
 #include <Foundation/Threading/TaskSystem.h>
 
 
-ezTaskGroupID ezTaskSystem::CreateTaskGroup(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback callback)
+ezTaskSystemState::~ezTaskSystemState()
 {
-  EZ_LOCK(s_TaskSystemMutex);
+  for (ezUInt32 i = 0; i < MaxTaskGroupChunks; ++i)
+  {
+    if (ezTaskGroup* pChunk = m_TaskGroupChunks[i].load())
+    {
+      ezArrayPtr<ezTaskGroup> chunk(pChunk, TaskGroupsPerChunk);
+      EZ_DEFAULT_DELETE_ARRAY(chunk);
+    }
+  }
+}
 
-  ezUInt32 i = 0;
+ezTaskGroup* ezTaskSystem::GetTaskGroupByIndex(ezUInt32 uiIndex)
+{
+  ezTaskGroup* pChunk = s_pState->m_TaskGroupChunks[uiIndex / ezTaskSystemState::TaskGroupsPerChunk].load(std::memory_order_acquire);
+  return &pChunk[uiIndex % ezTaskSystemState::TaskGroupsPerChunk];
+}
 
-  // this search could be speed up with a stack of free groups
-  for (; i < s_pState->m_TaskGroups.GetCount(); ++i)
+ezTaskGroup* ezTaskSystem::AllocateTaskGroup()
+{
+  // first try to recycle a group from the free list
+  ezUInt64 uiHead = s_pState->m_uiFreeTaskGroups.load(std::memory_order_acquire);
+
+  while ((uiHead & 0xFFFFFFFFu) != 0xFFFFFFFFu)
   {
-    if (!s_pState->m_TaskGroups[i].m_bInUse)
+    ezTaskGroup* pGroup = GetTaskGroupByIndex(static_cast<ezUInt32>(uiHead));
+
+    // if another thread takes this group in between, the tag in the upper bits has changed and the CAS fails
+    const ezUInt64 uiNewHead = ((uiHead >> 32) + 1) << 32 | pGroup->m_uiNextFreeGroup.load(std::memory_order_relaxed);
+
+    if (s_pState->m_uiFreeTaskGroups.compare_exchange_weak(uiHead, uiNewHead, std::memory_order_acquire, std::memory_order_acquire))
     {
-      goto foundtaskgroup;
+      return pGroup;
     }
   }
 
   // no free group found, create a new one
-  s_pState->m_TaskGroups.ExpandAndGetRef();
-  s_pState->m_TaskGroups[i].m_uiTaskGroupIndex = static_cast<ezUInt16>(i);
+  const ezUInt32 uiIndex = s_pState->m_uiNumTaskGroups.fetch_add(1);
+  EZ_ASSERT_ALWAYS(uiIndex < ezTaskSystemState::TaskGroupsPerChunk * ezTaskSystemState::MaxTaskGroupChunks, "Too many task groups are in use at the same time.");
+
+  std::atomic<ezTaskGroup*>& chunk = s_pState->m_TaskGroupChunks[uiIndex / ezTaskSystemState::TaskGroupsPerChunk];
+
+  if (chunk.load(std::memory_order_acquire) == nullptr)
+  {
+    EZ_LOCK(s_pState->m_TaskGroupChunkMutex);
+
+    if (chunk.load(std::memory_order_acquire) == nullptr)
+    {
+      ezArrayPtr<ezTaskGroup> groups = EZ_DEFAULT_NEW_ARRAY(ezTaskGroup, ezTaskSystemState::TaskGroupsPerChunk);
+
+      for (ezUInt32 i = 0; i < groups.GetCount(); ++i)
+      {
+        groups[i].m_uiTaskGroupIndex = static_cast<ezUInt16>((uiIndex / ezTaskSystemState::TaskGroupsPerChunk) * ezTaskSystemState::TaskGroupsPerChunk + i);
+      }
+
+      chunk.store(groups.GetPtr(), std::memory_order_release);
+    }
+  }
+
+  return GetTaskGroupByIndex(uiIndex);
+}
 
-foundtaskgroup:
+void ezTaskSystem::FreeTaskGroup(ezTaskGroup* pGroup)
+{
+  pGroup->m_bInUse = false;
+
+  ezUInt64 uiHead = s_pState->m_uiFreeTaskGroups.load(std::memory_order_relaxed);
+
+  while (true)
+  {
+    pGroup->m_uiNextFreeGroup.store(static_cast<ezUInt32>(uiHead), std::memory_order_relaxed);
+
+    const ezUInt64 uiNewHead = ((uiHead >> 32) + 1) << 32 | pGroup->m_uiTaskGroupIndex;
+
+    if (s_pState->m_uiFreeTaskGroups.compare_exchange_weak(uiHead, uiNewHead, std::memory_order_release, std::memory_order_relaxed))
+      return;
+  }
+}
 
-  s_pState->m_TaskGroups[i].Reuse(priority, callback);
+ezTaskGroupID ezTaskSystem::CreateTaskGroup(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback callback)
+{
+  ezTaskGroup* pGroup = AllocateTaskGroup();
+  pGroup->Reuse(priority, callback);
 
   ezTaskGroupID id;
-  id.m_pTaskGroup = &s_pState->m_TaskGroups[i];
-  id.m_uiGroupCounter = s_pState->m_TaskGroups[i].m_uiGroupCounter;
+  id.m_pTaskGroup = pGroup;
+  id.m_uiGroupCounter = pGroup->m_uiGroupCounter;
   return id;
 }
 
@@ -80,52 +141,96 @@ void ezTaskSystem::StartTaskGroup(ezTaskGroupID groupID)
 
   ezTaskGroup::DebugCheckTaskGroup(groupID, s_TaskSystemMutex);
 
-  ezInt32 iActiveDependencies = 0;
+  ezTaskGroup& tg = *groupID.m_pTaskGroup;
 
-  {
-    EZ_LOCK(s_TaskSystemMutex);
+  tg.m_bStartedByUser = true;
 
-    ezTaskGroup& tg = *groupID.m_pTaskGroup;
+  const ezUInt32 uiNumDependencies = tg.m_DependsOnGroups.GetCount();
 
-    tg.m_bStartedByUser = true;
+  if (uiNumDependencies == 0)
+  {
+    ScheduleGroupTasks(&tg, false);
+    return;
+  }
 
-    for (ezUInt32 i = 0; i < tg.m_DependsOnGroups.GetCount(); ++i)
-    {
-      if (!IsTaskGroupFinished(tg.m_DependsOnGroups[i]))
-      {
-        ezTaskGroup& Dependency = *tg.m_DependsOnGroups[i].m_pTaskGroup;
+  EZ_ASSERT_DEV(uiNumDependencies < 0xFFFF, "A task group can't have more than 65534 dependencies.");
 
-        // add this task group to the list of dependencies, such that when that group finishes, this task group can get woken up
-        Dependency.m_OthersDependingOnMe.PushBack(groupID);
+  // as soon as this group is linked into the first dependents list, that dependency may finish and decrement the counter
+  // therefore start with one more than the maximum, so that it can't reach zero before all dependencies are linked
+  tg.m_iNumActiveDependencies = static_cast<ezInt32>(uiNumDependencies) + 1;
+  tg.m_NextDependentLink.SetCountUninitialized(uiNumDependencies);
 
-        // count how many other groups need to finish before this task group can be executed
-        ++iActiveDependencies;
-      }
-    }
+  ezInt32 iFulfilledDependencies = 1;
 
-    if (iActiveDependencies != 0)
+  for (ezUInt32 i = 0; i < uiNumDependencies; ++i)
+  {
+    if (!AddDependentGroup(&tg, i))
     {
-      // atomic integers are quite slow, so do not use them in the loop, where they are not yet needed
-      tg.m_iNumActiveDependencies = iActiveDependencies;
+      ++iFulfilledDependencies;
     }
   }
 
-  if (iActiveDependencies == 0)
+  // the counter only reaches zero once, either here or in DependencyHasFinished()
+  bool bAllFulfilled = false;
+  for (ezInt32 i = 0; i < iFulfilledDependencies; ++i)
+  {
+    bAllFulfilled = (tg.m_iNumActiveDependencies.Decrement() == 0);
+  }
+
+  if (bAllFulfilled)
   {
-    ScheduleGroupTasks(groupID.m_pTaskGroup, false);
+    ScheduleGroupTasks(&tg, false);
   }
 }
 
 void ezTaskSystem::StartTaskGroupBatch(ezArrayPtr<const ezTaskGroupID> batch)
 {
-  EZ_LOCK(s_TaskSystemMutex);
-
   for (const ezTaskGroupID& group : batch)
   {
     StartTaskGroup(group);
   }
 }
 
+bool ezTaskSystem::AddDependentGroup(ezTaskGroup* pGroup, ezUInt32 uiDependency)
+{
+  const ezTaskGroupID& dependsOn = pGroup->m_DependsOnGroups[uiDependency];
+  ezTaskGroup* pDependency = dependsOn.m_pTaskGroup;
+
+  const ezUInt32 uiLink = (static_cast<ezUInt32>(pGroup->m_uiTaskGroupIndex) << 16) | uiDependency;
+
+  ezUInt64 uiHead = pDependency->m_uiDependentsHead.load(std::memory_order_acquire);
+
+  while (true)
+  {
+    // the group counter in the head changes atomically with closing the list, when the dependency finishes
+    if (static_cast<ezUInt32>(uiHead >> 32) != dependsOn.m_uiGroupCounter)
+      return false;
+
+    pGroup->m_NextDependentLink[uiDependency] = static_cast<ezUInt32>(uiHead);
+
+    if (pDependency->m_uiDependentsHead.compare_exchange_weak(uiHead, ezTaskGroup::MakeDependentsHead(dependsOn.m_uiGroupCounter, uiLink), std::memory_order_acq_rel, std::memory_order_acquire))
+      return true;
+  }
+}
+
+void ezTaskSystem::ReleaseDependentGroups(ezTaskGroup* pGroup, ezUInt32 uiNewGroupCounter)
+{
+  // close the list, no group can add itself after this
+  const ezUInt64 uiHead = pGroup->m_uiDependentsHead.exchange(ezTaskGroup::MakeDependentsHead(uiNewGroupCounter, ezTaskGroup::InvalidDependentLink), std::memory_order_acq_rel);
+
+  ezUInt32 uiLink = static_cast<ezUInt32>(uiHead);
+
+  while (uiLink != ezTaskGroup::InvalidDependentLink)
+  {
+    ezTaskGroup* pDependent = GetTaskGroupByIndex(uiLink >> 16);
+
+    // read the next link first, once the dependent group is notified it may get scheduled, finish and be reused
+    uiLink = pDependent->m_NextDependentLink[uiLink & 0xFFFF];
+
+    DependencyHasFinished(pDependent);
+  }
+}
+
 bool ezTaskSystem::IsTaskGroupFinished(ezTaskGroupID group)
 {
   // if the counters differ, the task group has been reused since the GroupID was created, so that group has finished
@@ -145,6 +250,67 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
 
   ezInt32 iRemainingTasks = 0;
 
+  if (s_pState->m_SchedulingMode == ezTaskSchedulingMode::WorkStealing)
+  {
+    // store how many tasks from this groups still need to be processed
+    // no lock needed, the group's tasks are not visible to any other thread yet
+    for (auto pTask : pGroup->m_Tasks)
+    {
+      iRemainingTasks += ezMath::Max(1u, pTask->m_uiMultiplicity);
+      pTask->m_iRemainingRuns = ezMath::Max(1u, pTask->m_uiMultiplicity);
+      pTask->m_bTaskIsScheduled = true;
+    }
+
+    // once the last task is pushed, other threads may execute all of them and finish the group before this loop ends
+    // the additional count keeps the group (and its task list) alive until we are done with it
+    pGroup->m_iNumRemainingTasks = iRemainingTasks + 1;
+
+    const ezInt32 iLocalQueue = ezTaskWorkStealingQueues::GetLocalQueueIndex(pGroup->m_Priority);
+    ezTaskWorkStealingQueue* pLocalQueue = (iLocalQueue >= 0 && tl_TaskWorkerInfo.m_pLocalQueues != nullptr) ? &tl_TaskWorkerInfo.m_pLocalQueues->m_Queues[iLocalQueue] : nullptr;
+
+    bool bLocked = false;
+
+    for (ezUInt32 task = 0; task < pGroup->m_Tasks.GetCount(); ++task)
+    {
+      const ezSharedPtr<ezTask>* pTask = &pGroup->m_Tasks[task];
+
+      for (ezUInt32 mult = 0; mult < ezMath::Max(1u, (*pTask)->m_uiMultiplicity); ++mult)
+      {
+        if (pLocalQueue != nullptr && pLocalQueue->Push(pTask, mult))
+          continue;
+
+        // priorities that need special handling, threads without local queues and full local queues use the global lists
+        if (!bLocked)
+        {
+          s_TaskSystemMutex.Lock();
+          bLocked = true;
+        }
+
+        TaskData td;
+        td.m_pBelongsToGroup = pGroup;
+        td.m_pTask = *pTask;
+        td.m_uiInvocation = mult;
+
+        if (bHighPriority)
+          s_pState->m_Tasks[pGroup->m_Priority].PushFront(td);
+        else
+          s_pState->m_Tasks[pGroup->m_Priority].PushBack(td);
+      }
+    }
+
+    if (bLocked)
+    {
+      UpdateGlobalTaskCount(pGroup->m_Priority);
+      s_TaskSystemMutex.Unlock();
+    }
+
+    WakeUpThreadsForPriority(pGroup->m_Priority, iRemainingTasks);
+
+    // remove the additional count, which may finish the group
+    TaskHasFinished(nullptr, pGroup);
+    return;
+  }
+
   // add all the tasks to the task list, so that they will be processed
   {
     EZ_LOCK(s_TaskSystemMutex);
@@ -180,48 +346,55 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
       }
     }
 
+    UpdateGlobalTaskCount(pGroup->m_Priority);
+
     // send the proper thread signal, to make sure one of the correct worker threads is awake
-    switch (pGroup->m_Priority)
-    {
-      case ezTaskPriority::EarlyThisFrame:
-      case ezTaskPriority::ThisFrame:
-      case ezTaskPriority::LateThisFrame:
-      case ezTaskPriority::EarlyNextFrame:
-      case ezTaskPriority::NextFrame:
-      case ezTaskPriority::LateNextFrame:
-      case ezTaskPriority::In2Frames:
-      case ezTaskPriority::In3Frames:
-      case ezTaskPriority::In4Frames:
-      case ezTaskPriority::In5Frames:
-      case ezTaskPriority::In6Frames:
-      case ezTaskPriority::In7Frames:
-      case ezTaskPriority::In8Frames:
-      case ezTaskPriority::In9Frames:
-      {
-        WakeUpThreads(ezWorkerThreadType::ShortTasks, iRemainingTasks);
-        break;
-      }
+    WakeUpThreadsForPriority(pGroup->m_Priority, iRemainingTasks);
+  }
+}
 
-      case ezTaskPriority::LongRunning:
-      case ezTaskPriority::LongRunningHighPriority:
-      {
-        WakeUpThreads(ezWorkerThreadType::LongTasks, iRemainingTasks);
-        break;
-      }
+void ezTaskSystem::WakeUpThreadsForPriority(ezTaskPriority::Enum priority, ezUInt32 uiNumThreads)
+{
+  switch (priority)
+  {
+    case ezTaskPriority::EarlyThisFrame:
+    case ezTaskPriority::ThisFrame:
+    case ezTaskPriority::LateThisFrame:
+    case ezTaskPriority::EarlyNextFrame:
+    case ezTaskPriority::NextFrame:
+    case ezTaskPriority::LateNextFrame:
+    case ezTaskPriority::In2Frames:
+    case ezTaskPriority::In3Frames:
+    case ezTaskPriority::In4Frames:
+    case ezTaskPriority::In5Frames:
+    case ezTaskPriority::In6Frames:
+    case ezTaskPriority::In7Frames:
+    case ezTaskPriority::In8Frames:
+    case ezTaskPriority::In9Frames:
+    {
+      WakeUpThreads(ezWorkerThreadType::ShortTasks, uiNumThreads);
+      break;
+    }
 
-      case ezTaskPriority::FileAccess:
-      case ezTaskPriority::FileAccessHighPriority:
-      {
-        WakeUpThreads(ezWorkerThreadType::FileAccess, iRemainingTasks);
-        break;
-      }
+    case ezTaskPriority::LongRunning:
+    case ezTaskPriority::LongRunningHighPriority:
+    {
+      WakeUpThreads(ezWorkerThreadType::LongTasks, uiNumThreads);
+      break;
+    }
 
-      case ezTaskPriority::SomeFrameMainThread:
-      case ezTaskPriority::ThisFrameMainThread:
-      case ezTaskPriority::ENUM_COUNT:
-        // nothing to do for these enum values
-        break;
+    case ezTaskPriority::FileAccess:
+    case ezTaskPriority::FileAccessHighPriority:
+    {
+      WakeUpThreads(ezWorkerThreadType::FileAccess, uiNumThreads);
+      break;
     }
+
+    case ezTaskPriority::SomeFrameMainThread:
+    case ezTaskPriority::ThisFrameMainThread:
+    case ezTaskPriority::ENUM_COUNT:
+      // nothing to do for these enum values
+      break;
   }
 }
 
@@ -246,7 +419,17 @@ ezResult ezTaskSystem::CancelGroup(ezTaskGroupID group, ezOnTaskRunning::Enum on
 
   ezResult res = EZ_SUCCESS;
 
-  auto TasksCopy = group.m_pTaskGroup->m_Tasks;
+  decltype(group.m_pTaskGroup->m_Tasks) TasksCopy;
+
+  {
+    // finishing the group clears its task list while holding this lock, it doesn't take the global one
+    EZ_LOCK(group.m_pTaskGroup->m_CondVarGroupFinished);
+
+    if (ezTaskSystem::IsTaskGroupFinished(group))
+      return EZ_SUCCESS;
+
+    TasksCopy = group.m_pTaskGroup->m_Tasks;
+  }
 
   // first cancel ALL the tasks in the group, without waiting for anything
   for (ezUInt32 task = 0; task < TasksCopy.GetCount(); ++task)
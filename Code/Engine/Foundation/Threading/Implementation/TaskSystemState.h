@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 class ezTaskSystemThreadState
@@ -14,21 +15,52 @@ private:
   // the number of allocated (non-null) worker threads in m_Workers
   ezAtomicInteger32 m_iAllocatedWorkers[ezWorkerThreadType::ENUM_COUNT];
 
+  // same as m_iAllocatedWorkers, but can be read without an atomic read-modify-write, which matters when many threads look for work to steal
+  std::atomic<ezUInt32> m_uiNumStealableWorkers[ezWorkerThreadType::ENUM_COUNT] = {};
+
   // the maximum number of worker threads that should be non-idle (and not blocked) at any time
   ezUInt32 m_uiMaxWorkersToUse[ezWorkerThreadType::ENUM_COUNT] = {};
+
+  // Only modified while no worker threads are running, see ezTaskSystem::SetWorkerThreadAffinity().
+  ezTaskThreadAffinity::Enum m_Affinity = ezTaskThreadAffinity::Default;
+
+  // The local queues of the main thread, used in ezTaskSchedulingMode::WorkStealing. Worker threads own their queues themselves.
+  ezTaskWorkStealingQueues m_MainThreadQueues;
 };
 
 class ezTaskSystemState
 {
+public:
+  ~ezTaskSystemState();
+
 private:
   friend class ezTaskSystem;
 
   // The target frame time used by FinishFrameTasks()
   ezTime m_TargetFrameTime = ezTime::MakeFromSeconds(1.0 / 40.0); // => 25 ms
 
-  // The deque can grow without relocating existing data, therefore the ezTaskGroupID's can store pointers directly to the data
-  ezDeque<ezTaskGroup> m_TaskGroups;
+  static constexpr ezUInt32 TaskGroupsPerChunk = 256;
+  static constexpr ezUInt32 MaxTaskGroupChunks = 256;
+
+  // Task groups are allocated in chunks that never move, therefore the ezTaskGroupID's can store pointers directly to the data.
+  // Chunks are only added, never removed while the task system is running, so groups can be looked up by index without a lock.
+  std::atomic<ezTaskGroup*> m_TaskGroupChunks[MaxTaskGroupChunks] = {};
+
+  // The number of group slots that have been handed out so far. Slots are never given back, but recycled through the free list.
+  std::atomic<ezUInt32> m_uiNumTaskGroups = 0;
+
+  // Head of the lock-free stack of unused groups: upper 32 bit are a tag against the ABA problem, lower 32 bit the index of the first free group.
+  std::atomic<ezUInt64> m_uiFreeTaskGroups = 0xFFFFFFFFu;
+
+  // Only used to allocate new chunks, which happens rarely.
+  ezMutex m_TaskGroupChunkMutex;
 
   // The lists of all scheduled tasks, for each priority.
   ezList<ezTaskSystem::TaskData> m_Tasks[ezTaskPriority::ENUM_COUNT];
+
+  // Mirrors m_Tasks[i].GetCount(), but can be read without holding the lock, to skip empty lists quickly.
+  std::atomic<ezUInt32> m_uiNumGlobalTasks[ezTaskPriority::ENUM_COUNT] = {};
+
+  // Only modified while no worker threads are running, see ezTaskSystem::SetSchedulingMode().
+  ezTaskSchedulingMode::Enum m_SchedulingMode = ezTaskSchedulingMode::Default;
 };
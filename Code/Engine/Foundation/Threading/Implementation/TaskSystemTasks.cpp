@@ -50,26 +50,22 @@ void ezTaskSystem::TaskHasFinished(ezSharedPtr<ezTask>&& pTask, ezTaskGroup* pGr
       // see ezTaskGroup::WaitForFinish() for why we need this lock here
       // without it, there would be a race condition between these two places, reading and writing m_uiGroupCounter and waiting/signaling
       // m_CondVarGroupFinished
+      // this lock is per group, so finishing groups never contends on a global lock
       EZ_LOCK(pGroup->m_CondVarGroupFinished);
 
       groupCounter = pGroup->m_uiGroupCounter;
 
-      // set this task group to be finished such that no one tries to append further dependencies
+      // set this task group to be finished, this is what IsTaskGroupFinished() checks
       pGroup->m_uiGroupCounter += 2;
-    }
-
-    {
-      EZ_LOCK(s_TaskSystemMutex);
 
       // unless an outside reference is held onto a task, this will deallocate the tasks
+      // CancelGroup() copies the task list while holding the same lock
       pGroup->m_Tasks.Clear();
-
-      for (ezUInt32 dep = 0; dep < pGroup->m_OthersDependingOnMe.GetCount(); ++dep)
-      {
-        DependencyHasFinished(pGroup->m_OthersDependingOnMe[dep].m_pTaskGroup);
-      }
     }
 
+    // kick off all the groups that only waited for this one
+    ReleaseDependentGroups(pGroup, groupCounter + 2);
+
     // wake up all threads that are waiting for this group
     pGroup->m_CondVarGroupFinished.SignalAll();
 
@@ -82,7 +78,7 @@ void ezTaskSystem::TaskHasFinished(ezSharedPtr<ezTask>&& pTask, ezTaskGroup* pGr
     }
 
     // set this task available for reuse
-    pGroup->m_bInUse = false;
+    FreeTaskGroup(pGroup);
   }
 }
 
@@ -94,6 +90,11 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
   EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}",
     FirstPriority, LastPriority);
 
+  if (s_pState->m_SchedulingMode == ezTaskSchedulingMode::WorkStealing)
+  {
+    return GetNextTaskWorkStealing(FirstPriority, LastPriority, bOnlyTasksThatNeverWait, WaitingForGroup, pWorkerState);
+  }
+
   EZ_LOCK(s_TaskSystemMutex);
 
   // go through all the task lists that this thread is willing to work on
@@ -106,6 +107,7 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
         TaskData td = *it;
 
         s_pState->m_Tasks[prio].Remove(it);
+        UpdateGlobalTaskCount((ezTaskPriority::Enum)prio);
         return td;
       }
     }
@@ -191,6 +193,7 @@ ezResult ezTaskSystem::CancelTask(const ezSharedPtr<ezTask>& pTask, ezOnTaskRunn
             TaskHasFinished(std::move(it->m_pTask), it->m_pBelongsToGroup);
 
             s_pState->m_Tasks[i].Remove(it);
+            UpdateGlobalTaskCount((ezTaskPriority::Enum)i);
             return EZ_SUCCESS;
           }
 
@@ -200,6 +203,17 @@ ezResult ezTaskSystem::CancelTask(const ezSharedPtr<ezTask>& pTask, ezOnTaskRunn
     }
   }
 
+  if (s_pState->m_SchedulingMode == ezTaskSchedulingMode::WorkStealing && pTask->m_bTaskIsScheduled)
+  {
+    // the task may sit in a lock-free queue, from which it cannot be removed
+    // however, since the cancel flag is set, it will be skipped once it is taken from the queue
+    // ezTask::Run() increments m_iStartedRuns before it checks the cancel flag, so if no invocation has started yet, none ever will
+    if (pTask->m_iStartedRuns == 0)
+    {
+      return EZ_SUCCESS;
+    }
+  }
+
   // if we made it here, the task was already running
   // thus we just wait for it to finish
 
@@ -277,6 +291,11 @@ void ezTaskSystem::ReprioritizeFrameTasks()
     // remove the tasks from their current queue
     s_pState->m_Tasks[i].Clear();
   }
+
+  for (ezUInt32 i = (ezUInt32)ezTaskPriority::EarlyThisFrame; i <= (ezUInt32)ezTaskPriority::In9Frames; ++i)
+  {
+    UpdateGlobalTaskCount((ezTaskPriority::Enum)i);
+  }
 }
 
 void ezTaskSystem::ExecuteSomeFrameTasks(ezTime smoothFrameTime)
@@ -90,9 +90,15 @@ void ezTaskSystem::StopWorkerThreads()
   {
     const ezUInt32 uiNumWorkers = s_pThreadState->m_iAllocatedWorkers[type];
 
+    s_pThreadState->m_uiNumStealableWorkers[type] = 0;
+
     for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
     {
       s_pThreadState->m_Workers[type][i]->Join();
+
+      // don't lose the tasks that were scheduled into the thread's local queues
+      MoveLocalTasksToGlobalQueue(s_pThreadState->m_Workers[type][i]->GetLocalQueues());
+
       EZ_DEFAULT_DELETE(s_pThreadState->m_Workers[type][i]);
     }
 
@@ -115,9 +121,15 @@ void ezTaskSystem::AllocateThreads(ezWorkerThreadType::Enum type, ezUInt32 uiAdd
     EZ_ASSERT_ALWAYS(uiNextThreadIdx + uiAddThreads <= s_pThreadState->m_Workers[type].GetCount(), "Max number of worker threads ({}) exceeded.",
       s_pThreadState->m_Workers[type].GetCount());
 
+    ezHybridArray<ezUInt16, 64> cpus;
+    ezUInt16 uiNumaNode = 0;
+
     for (ezUInt32 i = 0; i < uiAddThreads; ++i)
     {
+      DetermineWorkerAffinity(type, uiNextThreadIdx, cpus, uiNumaNode);
+
       s_pThreadState->m_Workers[type][uiNextThreadIdx] = EZ_DEFAULT_NEW(ezTaskWorkerThread, (ezWorkerThreadType::Enum)type, uiNextThreadIdx);
+      s_pThreadState->m_Workers[type][uiNextThreadIdx]->SetAffinity(cpus, uiNumaNode);
       s_pThreadState->m_Workers[type][uiNextThreadIdx]->Start();
 
       ++uiNextThreadIdx;
@@ -125,12 +137,150 @@ void ezTaskSystem::AllocateThreads(ezWorkerThreadType::Enum type, ezUInt32 uiAdd
 
     // let others access the new threads now
     s_pThreadState->m_iAllocatedWorkers[type] = uiNextThreadIdx;
+    s_pThreadState->m_uiNumStealableWorkers[type].store(uiNextThreadIdx, std::memory_order_release);
   }
 
   ezLog::Dev("Allocated {} additional '{}' worker threads ({} total)", uiAddThreads, ezWorkerThreadType::GetThreadTypeName(type),
     s_pThreadState->m_iAllocatedWorkers[type]);
 }
 
+void ezTaskSystem::SetWorkerThreadAffinity(ezTaskThreadAffinity::Enum affinity)
+{
+  EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "The worker thread affinity must be changed on the main thread.");
+
+  if (s_pThreadState->m_Affinity == affinity)
+    return;
+
+  const ezUInt32 uiShortTasks = s_pThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks];
+  const ezUInt32 uiLongTasks = s_pThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks];
+
+  StopWorkerThreads();
+
+  s_pThreadState->m_Affinity = affinity;
+
+  SetWorkerThreadCount(uiShortTasks, uiLongTasks);
+}
+
+ezTaskThreadAffinity::Enum ezTaskSystem::GetWorkerThreadAffinity()
+{
+  return s_pThreadState->m_Affinity;
+}
+
+void ezTaskSystem::DetermineWorkerAffinity(ezWorkerThreadType::Enum type, ezUInt32 uiThreadIndex, ezDynamicArray<ezUInt16>& out_cpus, ezUInt16& out_uiNumaNode)
+{
+  out_cpus.Clear();
+  out_uiNumaNode = 0;
+
+  const ezTaskThreadAffinity::Enum affinity = s_pThreadState->m_Affinity;
+  if (affinity == ezTaskThreadAffinity::None)
+    return;
+
+  const ezCpuTopology& topology = ezSystemInformation::Get().GetCpuTopology();
+
+  // only nodes on which the process may actually run are used
+  ezHybridArray<ezUInt16, 8> nodes;
+  for (ezUInt32 uiCpu = 0; uiCpu < topology.m_uiNumLogicalCpus; ++uiCpu)
+  {
+    const ezCpuTopology::LogicalCpu& cpu = topology.m_LogicalCpus[uiCpu];
+    if (cpu.m_bIsAvailable && !nodes.Contains(cpu.m_uiNumaNode))
+    {
+      nodes.PushBack(cpu.m_uiNumaNode);
+    }
+  }
+
+  if (nodes.IsEmpty())
+    return;
+
+  nodes.Sort();
+
+  const ezUInt32 uiNumNodes = nodes.GetCount();
+  const ezUInt32 uiMaxWorkers = ezMath::Max(1u, s_pThreadState->m_uiMaxWorkersToUse[type]);
+  const bool bIsReserve = uiThreadIndex >= uiMaxWorkers;
+
+  ezUInt32 uiNodeSlot = 0;
+  ezUInt32 uiIndexInNode = 0;
+
+  if (!bIsReserve)
+  {
+    // consecutive workers share a node, so that the workers are grouped by node
+    uiNodeSlot = uiThreadIndex * uiNumNodes / uiMaxWorkers;
+    uiIndexInNode = uiThreadIndex - (uiNodeSlot * uiMaxWorkers + uiNumNodes - 1) / uiNumNodes;
+  }
+  else
+  {
+    // reserve threads only jump in while other threads are blocked, just spread them across all nodes
+    uiNodeSlot = uiThreadIndex % uiNumNodes;
+  }
+
+  out_uiNumaNode = nodes[uiNodeSlot];
+
+  if (affinity == ezTaskThreadAffinity::PhysicalCore && type == ezWorkerThreadType::ShortTasks && !bIsReserve)
+  {
+    // use only the first hardware thread of each core, so that no two short task workers end up on SMT siblings
+    ezHybridArray<ezUInt16, 64> cores;
+    for (ezUInt32 uiCpu = 0; uiCpu < topology.m_uiNumLogicalCpus; ++uiCpu)
+    {
+      const ezCpuTopology::LogicalCpu& cpu = topology.m_LogicalCpus[uiCpu];
+      if (cpu.m_bIsAvailable && cpu.m_bIsFirstSibling && cpu.m_uiNumaNode == out_uiNumaNode)
+      {
+        cores.PushBack(static_cast<ezUInt16>(uiCpu));
+      }
+    }
+
+    if (!cores.IsEmpty())
+    {
+      out_cpus.PushBack(cores[uiIndexInNode % cores.GetCount()]);
+      return;
+    }
+  }
+
+  for (ezUInt32 uiCpu = 0; uiCpu < topology.m_uiNumLogicalCpus; ++uiCpu)
+  {
+    const ezCpuTopology::LogicalCpu& cpu = topology.m_LogicalCpus[uiCpu];
+    if (cpu.m_bIsAvailable && cpu.m_uiNumaNode == out_uiNumaNode)
+    {
+      out_cpus.PushBack(static_cast<ezUInt16>(uiCpu));
+    }
+  }
+}
+
+ezUInt32 ezTaskSystem::GetWorkerThreadNumaNode(ezWorkerThreadType::Enum type, ezUInt32 uiThreadIndex)
+{
+  return s_pThreadState->m_Workers[type][uiThreadIndex]->GetNumaNode();
+}
+
+double ezTaskSystem::GetNumaNodeUtilization(ezUInt32 uiNumaNode, ezUInt32* pNumTasksExecuted /*= nullptr*/)
+{
+  double fUtilization = 0.0;
+  ezUInt32 uiNumThreads = 0;
+  ezUInt32 uiNumTasksExecuted = 0;
+
+  for (ezWorkerThreadType::Enum type : {ezWorkerThreadType::ShortTasks, ezWorkerThreadType::LongTasks})
+  {
+    const ezUInt32 uiNumWorkers = s_pThreadState->m_iAllocatedWorkers[type];
+
+    for (ezUInt32 t = 0; t < uiNumWorkers; ++t)
+    {
+      ezTaskWorkerThread* pWorker = s_pThreadState->m_Workers[type][t];
+
+      if (pWorker->GetNumaNode() != uiNumaNode)
+        continue;
+
+      ezUInt32 uiNumTasks = 0;
+      fUtilization += pWorker->GetThreadUtilization(&uiNumTasks);
+      uiNumTasksExecuted += uiNumTasks;
+      ++uiNumThreads;
+    }
+  }
+
+  if (pNumTasksExecuted)
+  {
+    *pNumTasksExecuted = uiNumTasksExecuted;
+  }
+
+  return uiNumThreads > 0 ? fUtilization / uiNumThreads : 0.0;
+}
+
 void ezTaskSystem::WakeUpThreads(ezWorkerThreadType::Enum type, ezUInt32 uiNumThreadsToWakeUp)
 {
   // together with ezTaskWorkerThread::Run() this function will make sure to keep the number
@@ -180,6 +330,21 @@ void ezTaskSystem::WakeUpThreads(ezWorkerThreadType::Enum type, ezUInt32 uiNumTh
   }
 }
 
+bool ezTaskSystem::HasIdleWorkerThreads(ezWorkerThreadType::Enum type)
+{
+  const ezUInt32 uiMaxWorkers = s_pThreadState->m_uiMaxWorkersToUse[type];
+  const ezUInt32 uiNumWorkers = ezMath::Min(s_pThreadState->m_uiNumStealableWorkers[type].load(std::memory_order_acquire), uiMaxWorkers);
+
+  for (ezUInt32 threadIdx = 0; threadIdx < uiNumWorkers; ++threadIdx)
+  {
+    if (s_pThreadState->m_Workers[type][threadIdx]->IsIdle())
+      return true;
+  }
+
+  // threads that are not allocated yet, will be allocated by WakeUpThreads() on demand
+  return uiNumWorkers < uiMaxWorkers;
+}
+
 ezWorkerThreadType::Enum ezTaskSystem::GetCurrentThreadWorkerType()
 {
   return tl_TaskWorkerInfo.m_WorkerType;
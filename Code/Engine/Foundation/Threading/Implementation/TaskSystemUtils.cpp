@@ -73,9 +73,11 @@ void ezTaskSystem::WriteStateSnapshotToDGML(ezDGMLGraph& ref_graph)
   szTaskPriorityNames[ezTaskPriority::ThisFrameMainThread] = "ThisFrameMainThread";
   szTaskPriorityNames[ezTaskPriority::SomeFrameMainThread] = "SomeFrameMainThread";
 
-  for (ezUInt32 g = 0; g < s_pState->m_TaskGroups.GetCount(); ++g)
+  const ezUInt32 uiNumTaskGroups = s_pState->m_uiNumTaskGroups;
+
+  for (ezUInt32 g = 0; g < uiNumTaskGroups; ++g)
   {
-    const ezTaskGroup& tg = s_pState->m_TaskGroups[g];
+    const ezTaskGroup& tg = *GetTaskGroupByIndex(g);
 
     if (!tg.m_bInUse)
       continue;
@@ -107,9 +109,9 @@ void ezTaskSystem::WriteStateSnapshotToDGML(ezDGMLGraph& ref_graph)
     }
   }
 
-  for (ezUInt32 g = 0; g < s_pState->m_TaskGroups.GetCount(); ++g)
+  for (ezUInt32 g = 0; g < uiNumTaskGroups; ++g)
   {
-    const ezTaskGroup& tg = s_pState->m_TaskGroups[g];
+    const ezTaskGroup& tg = *GetTaskGroupByIndex(g);
 
     if (!tg.m_bInUse)
       continue;
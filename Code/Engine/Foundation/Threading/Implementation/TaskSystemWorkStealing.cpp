@@ -0,0 +1,244 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Threading/Implementation/TaskGroup.h>
+#include <Foundation/Threading/Implementation/TaskSystemState.h>
+#include <Foundation/Threading/Implementation/TaskWorkerThread.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+void ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::Enum mode)
+{
+  EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "The scheduling mode must be changed on the main thread.");
+
+  if (s_pState->m_SchedulingMode == mode)
+    return;
+
+  const ezUInt32 uiShortTasks = s_pThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks];
+  const ezUInt32 uiLongTasks = s_pThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks];
+
+  // this also moves all tasks from the worker's local queues into the global lists
+  StopWorkerThreads();
+
+  MoveLocalTasksToGlobalQueue(s_pThreadState->m_MainThreadQueues);
+
+  s_pState->m_SchedulingMode = mode;
+
+  SetWorkerThreadCount(uiShortTasks, uiLongTasks);
+}
+
+ezTaskSchedulingMode::Enum ezTaskSystem::GetSchedulingMode()
+{
+  return s_pState->m_SchedulingMode;
+}
+
+void ezTaskSystem::UpdateGlobalTaskCount(ezTaskPriority::Enum priority)
+{
+  s_pState->m_uiNumGlobalTasks[priority].store(s_pState->m_Tasks[priority].GetCount(), std::memory_order_relaxed);
+}
+
+void ezTaskSystem::MoveLocalTasksToGlobalQueue(ezTaskWorkStealingQueues& ref_queues)
+{
+  EZ_LOCK(s_TaskSystemMutex);
+
+  const ezTaskPriority::Enum localPriorities[] = {ezTaskPriority::EarlyThisFrame, ezTaskPriority::ThisFrame, ezTaskPriority::LateThisFrame, ezTaskPriority::LongRunningHighPriority, ezTaskPriority::LongRunning};
+
+  for (ezTaskPriority::Enum priority : localPriorities)
+  {
+    ezTaskWorkStealingQueue& queue = ref_queues.m_Queues[ezTaskWorkStealingQueues::GetLocalQueueIndex(priority)];
+
+    const ezSharedPtr<ezTask>* pTask = nullptr;
+    ezUInt32 uiInvocation = 0;
+
+    // steal from the top, to keep the original order
+    while (queue.Steal(pTask, uiInvocation))
+    {
+      TaskData td;
+      td.m_pTask = *pTask;
+      td.m_pBelongsToGroup = (*pTask)->m_BelongsToGroup.m_pTaskGroup;
+      td.m_uiInvocation = uiInvocation;
+
+      s_pState->m_Tasks[priority].PushBack(td);
+    }
+
+    UpdateGlobalTaskCount(priority);
+  }
+}
+
+bool ezTaskSystem::TakeTaskFromGlobalQueue(ezTaskPriority::Enum priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_task)
+{
+  // don't bother to lock the mutex, if the list is empty anyway
+  if (s_pState->m_uiNumGlobalTasks[priority].load(std::memory_order_relaxed) == 0)
+    return false;
+
+  EZ_LOCK(s_TaskSystemMutex);
+
+  for (auto it = s_pState->m_Tasks[priority].GetIterator(); it.IsValid(); ++it)
+  {
+    if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
+    {
+      out_task = *it;
+
+      s_pState->m_Tasks[priority].Remove(it);
+      UpdateGlobalTaskCount(priority);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ezTaskSystem::StealTask(ezUInt32 uiLocalQueueIndex, TaskData& out_task)
+{
+  // the potential victims are the main thread and all short and long task workers, in that order
+  const ezUInt32 uiNumShort = s_pThreadState->m_uiNumStealableWorkers[ezWorkerThreadType::ShortTasks].load(std::memory_order_acquire);
+  const ezUInt32 uiNumLong = s_pThreadState->m_uiNumStealableWorkers[ezWorkerThreadType::LongTasks].load(std::memory_order_acquire);
+  const ezUInt32 uiNumVictims = 1 + uiNumShort + uiNumLong;
+
+  // xorshift, to start at a random victim, which prevents all thieves from hammering the same queue
+  ezUInt32& uiRandom = tl_TaskWorkerInfo.m_uiStealRandomState;
+  if (uiRandom == 0)
+    uiRandom = static_cast<ezUInt32>(reinterpret_cast<ezUInt64>(&uiRandom) >> 4) | 1u;
+  uiRandom ^= uiRandom << 13;
+  uiRandom ^= uiRandom >> 17;
+  uiRandom ^= uiRandom << 5;
+
+  const ezUInt32 uiStart = uiRandom % uiNumVictims;
+
+  for (ezUInt32 i = 0; i < uiNumVictims; ++i)
+  {
+    const ezUInt32 uiVictim = (uiStart + i) % uiNumVictims;
+
+    ezTaskWorkStealingQueues* pQueues = nullptr;
+    if (uiVictim == 0)
+      pQueues = &s_pThreadState->m_MainThreadQueues;
+    else if (uiVictim <= uiNumShort)
+      pQueues = &s_pThreadState->m_Workers[ezWorkerThreadType::ShortTasks][uiVictim - 1]->GetLocalQueues();
+    else
+      pQueues = &s_pThreadState->m_Workers[ezWorkerThreadType::LongTasks][uiVictim - 1 - uiNumShort]->GetLocalQueues();
+
+    if (pQueues == tl_TaskWorkerInfo.m_pLocalQueues)
+      continue;
+
+    const ezSharedPtr<ezTask>* pTask = nullptr;
+    if (pQueues->m_Queues[uiLocalQueueIndex].Steal(pTask, out_task.m_uiInvocation))
+    {
+      out_task.m_pTask = *pTask;
+      out_task.m_pBelongsToGroup = (*pTask)->m_BelongsToGroup.m_pTaskGroup;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ezTaskSystem::HasPendingTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority)
+{
+  const ezUInt32 uiNumShort = s_pThreadState->m_uiNumStealableWorkers[ezWorkerThreadType::ShortTasks].load(std::memory_order_acquire);
+  const ezUInt32 uiNumLong = s_pThreadState->m_uiNumStealableWorkers[ezWorkerThreadType::LongTasks].load(std::memory_order_acquire);
+
+  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+  {
+    if (s_pState->m_uiNumGlobalTasks[prio].load(std::memory_order_seq_cst) > 0)
+      return true;
+
+    const ezInt32 iLocalQueue = ezTaskWorkStealingQueues::GetLocalQueueIndex((ezTaskPriority::Enum)prio);
+    if (iLocalQueue < 0)
+      continue;
+
+    if (!s_pThreadState->m_MainThreadQueues.m_Queues[iLocalQueue].IsEmpty())
+      return true;
+
+    for (ezUInt32 i = 0; i < uiNumShort; ++i)
+    {
+      if (!s_pThreadState->m_Workers[ezWorkerThreadType::ShortTasks][i]->GetLocalQueues().m_Queues[iLocalQueue].IsEmpty())
+        return true;
+    }
+
+    for (ezUInt32 i = 0; i < uiNumLong; ++i)
+    {
+      if (!s_pThreadState->m_Workers[ezWorkerThreadType::LongTasks][i]->GetLocalQueues().m_Queues[iLocalQueue].IsEmpty())
+        return true;
+    }
+  }
+
+  return false;
+}
+
+ezTaskSystem::TaskData ezTaskSystem::GetNextTaskWorkStealing(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority,
+  bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
+{
+  ezTaskWorkStealingQueues* pOwnQueues = tl_TaskWorkerInfo.m_pLocalQueues;
+
+  // tasks that were taken from a lock-free queue but that the calling thread is not allowed to execute,
+  // they are moved to the global list, where they can be filtered without removing them
+  auto IsAllowed = [&](const TaskData& td)
+  {
+    return !bOnlyTasksThatNeverWait || (td.m_pTask->m_NestingMode == ezTaskNesting::Never) || td.m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup;
+  };
+
+  auto MoveToGlobalQueue = [](ezTaskPriority::Enum priority, TaskData&& td)
+  {
+    {
+      EZ_LOCK(s_TaskSystemMutex);
+      s_pState->m_Tasks[priority].PushFront(std::move(td));
+      UpdateGlobalTaskCount(priority);
+    }
+
+    // the calling thread won't take it, so make sure someone else does
+    WakeUpThreadsForPriority(priority, 1);
+  };
+
+  // go through all the task lists that this thread is willing to work on, highest priority first
+  for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+  {
+    const ezTaskPriority::Enum priority = (ezTaskPriority::Enum)prio;
+    const ezInt32 iLocalQueue = ezTaskWorkStealingQueues::GetLocalQueueIndex(priority);
+
+    TaskData td;
+
+    if (iLocalQueue >= 0)
+    {
+      // first, work on our own tasks (LIFO, most likely to still be in the cache)
+      const ezSharedPtr<ezTask>* pTask = nullptr;
+      if (pOwnQueues != nullptr && pOwnQueues->m_Queues[iLocalQueue].Pop(pTask, td.m_uiInvocation))
+      {
+        td.m_pTask = *pTask;
+        td.m_pBelongsToGroup = (*pTask)->m_BelongsToGroup.m_pTaskGroup;
+
+        if (IsAllowed(td))
+          return td;
+
+        MoveToGlobalQueue(priority, std::move(td));
+      }
+
+      // then try to steal from other threads (FIFO, oldest and typically largest pieces of work)
+      if (StealTask(iLocalQueue, td))
+      {
+        if (IsAllowed(td))
+          return td;
+
+        MoveToGlobalQueue(priority, std::move(td));
+      }
+    }
+
+    if (TakeTaskFromGlobalQueue(priority, bOnlyTasksThatNeverWait, WaitingForGroup, td))
+      return td;
+  }
+
+  if (pWorkerState)
+  {
+    EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+
+    // Without the global lock, a task may have been pushed after we looked at the queues, but before we marked this thread as idle.
+    // The pushing thread only wakes up idle threads, so it may have missed us. Setting the worker state is a full memory barrier,
+    // so by checking the queues again now, we either see the new task or the other thread sees us as idle.
+    if (HasPendingTasks(FirstPriority, LastPriority))
+    {
+      WakeUpThreads(tl_TaskWorkerInfo.m_WorkerType, 1);
+    }
+  }
+
+  return TaskData();
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskSystemWorkStealing);
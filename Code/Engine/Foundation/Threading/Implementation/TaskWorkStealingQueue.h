@@ -0,0 +1,156 @@
+#pragma once
+
+#include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+
+#include <atomic>
+
+/// \internal A fixed capacity, lock-free work-stealing deque (Chase-Lev).
+///
+/// Only the owning thread may call Push() and Pop(), which operate on the 'bottom' end (LIFO).
+/// Any other thread may call Steal(), which takes the oldest item from the 'top' end (FIFO).
+/// The queue only stores a pointer to the ezSharedPtr that is kept alive by the task's group, plus the invocation index,
+/// so that items are trivially copyable and can be read speculatively by stealing threads.
+class ezTaskWorkStealingQueue
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskWorkStealingQueue);
+
+public:
+  /// \brief The number of items that fit into one queue. When the queue is full, Push() fails and the caller has to fall back to the global queue.
+  static constexpr ezInt64 Capacity = 1024;
+
+  ezTaskWorkStealingQueue() = default;
+
+  /// \brief Adds an item at the bottom. Only allowed on the owning thread. Returns false, if the queue is full.
+  bool Push(const ezSharedPtr<ezTask>* pTask, ezUInt32 uiInvocation)
+  {
+    const ezInt64 b = m_iBottom.load(std::memory_order_relaxed);
+    const ezInt64 t = m_iTop.load(std::memory_order_acquire);
+
+    if (b - t >= Capacity)
+      return false;
+
+    Slot& slot = m_Slots[b & (Capacity - 1)];
+    slot.m_pTask.store(pTask, std::memory_order_relaxed);
+    slot.m_uiInvocation.store(uiInvocation, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_release);
+    m_iBottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// \brief Removes the most recently pushed item. Only allowed on the owning thread (or when the owner is known to be inactive).
+  bool Pop(const ezSharedPtr<ezTask>*& out_pTask, ezUInt32& out_uiInvocation)
+  {
+    const ezInt64 b = m_iBottom.load(std::memory_order_relaxed) - 1;
+    m_iBottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    ezInt64 t = m_iTop.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+      // queue was empty
+      m_iBottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+
+    const Slot& slot = m_Slots[b & (Capacity - 1)];
+    out_pTask = slot.m_pTask.load(std::memory_order_relaxed);
+    out_uiInvocation = slot.m_uiInvocation.load(std::memory_order_relaxed);
+
+    if (t != b)
+    {
+      // more than one item left, no race with stealing threads possible
+      return true;
+    }
+
+    // this is the last item, race against thieves for it
+    const bool bWon = m_iTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    m_iBottom.store(b + 1, std::memory_order_relaxed);
+    return bWon;
+  }
+
+  /// \brief Removes the oldest item. May be called from any thread. Returns false if the queue is empty or another thread won the race for the item.
+  bool Steal(const ezSharedPtr<ezTask>*& out_pTask, ezUInt32& out_uiInvocation)
+  {
+    ezInt64 t = m_iTop.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const ezInt64 b = m_iBottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+      return false;
+
+    // the slot may get overwritten by the owner after we read it, but in that case 'top' has moved and the CAS below fails
+    const Slot& slot = m_Slots[t & (Capacity - 1)];
+    const ezSharedPtr<ezTask>* pTask = slot.m_pTask.load(std::memory_order_relaxed);
+    const ezUInt32 uiInvocation = slot.m_uiInvocation.load(std::memory_order_relaxed);
+
+    if (!m_iTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return false;
+
+    out_pTask = pTask;
+    out_uiInvocation = uiInvocation;
+    return true;
+  }
+
+  /// \brief Returns whether the queue currently appears to be empty. The result may be outdated immediately.
+  bool IsEmpty() const { return m_iBottom.load(std::memory_order_seq_cst) <= m_iTop.load(std::memory_order_seq_cst); }
+
+private:
+  struct Slot
+  {
+    std::atomic<const ezSharedPtr<ezTask>*> m_pTask = nullptr;
+    std::atomic<ezUInt32> m_uiInvocation = 0;
+  };
+
+  // top and bottom are modified by different threads, keep them on separate cache lines
+  // (padding instead of alignas, because the queues are allocated through allocators that only guarantee 8 byte alignment)
+  std::atomic<ezInt64> m_iTop = 0;
+  ezUInt8 m_TopPadding[64 - sizeof(std::atomic<ezInt64>)];
+  std::atomic<ezInt64> m_iBottom = 0;
+  ezUInt8 m_BottomPadding[64 - sizeof(std::atomic<ezInt64>)];
+  Slot m_Slots[Capacity];
+};
+
+/// \internal The set of work-stealing queues owned by one thread. Only some priorities are stored in thread local queues,
+/// all other priorities always go through the global queues of the ezTaskSystem.
+struct ezTaskWorkStealingQueues
+{
+  /// \brief Returns the index of the local queue that is used for the given priority, or -1 if that priority always uses the global queue.
+  ///
+  /// 'Next frame' priorities are excluded, because they need to be re-prioritized by FinishFrameTasks(),
+  /// main thread and file access priorities are excluded, because there is only a single thread that can execute them.
+  static ezInt32 GetLocalQueueIndex(ezTaskPriority::Enum priority)
+  {
+    switch (priority)
+    {
+      case ezTaskPriority::EarlyThisFrame:
+        return 0;
+      case ezTaskPriority::ThisFrame:
+        return 1;
+      case ezTaskPriority::LateThisFrame:
+        return 2;
+      case ezTaskPriority::LongRunningHighPriority:
+        return 3;
+      case ezTaskPriority::LongRunning:
+        return 4;
+      default:
+        return -1;
+    }
+  }
+
+  static constexpr ezUInt32 NumLocalQueues = 5;
+
+  /// \brief Returns true if any of the local queues contains an item.
+  bool HasWork() const
+  {
+    for (ezUInt32 i = 0; i < NumLocalQueues; ++i)
+    {
+      if (!m_Queues[i].IsEmpty())
+        return true;
+    }
+
+    return false;
+  }
+
+  ezTaskWorkStealingQueue m_Queues[NumLocalQueues];
+};
@@ -38,6 +38,12 @@ ezResult ezTaskWorkerThread::DeactivateWorker()
   return EZ_SUCCESS;
 }
 
+void ezTaskWorkerThread::SetAffinity(ezArrayPtr<const ezUInt16> cpus, ezUInt16 uiNumaNode)
+{
+  SetCpuAffinity(cpus);
+  m_uiNumaNode = uiNumaNode;
+}
+
 ezUInt32 ezTaskWorkerThread::Run()
 {
   EZ_ASSERT_DEBUG(
@@ -49,6 +55,8 @@ ezUInt32 ezTaskWorkerThread::Run()
   tl_TaskWorkerInfo.m_WorkerType = m_WorkerType;
   tl_TaskWorkerInfo.m_iWorkerIndex = m_uiWorkerThreadNumber;
   tl_TaskWorkerInfo.m_pWorkerState = &m_iWorkerState;
+  tl_TaskWorkerInfo.m_pLocalQueues = &m_LocalQueues;
+  tl_TaskWorkerInfo.m_uiStealRandomState = ((ezUInt32)m_WorkerType << 16) + m_uiWorkerThreadNumber + 1;
 
   const bool bIsReserve = m_uiWorkerThreadNumber >= ezTaskSystem::s_pThreadState->m_uiMaxWorkersToUse[m_WorkerType];
 
@@ -74,7 +82,8 @@ ezUInt32 ezTaskWorkerThread::Run()
     {
       ++m_uiNumTasksExecuted;
 
-      if (bIsReserve)
+      // a reserve thread must not go to sleep while tasks that it scheduled are still in its local queues
+      if (bIsReserve && !m_LocalQueues.HasWork())
       {
         EZ_VERIFY(m_iWorkerState.Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt worker state");
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingQueue.h>
 
 #include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadSignal.h>
@@ -21,6 +22,12 @@ public:
   /// \brief Deactivates the thread. Returns failure, if the thread is currently still running.
   ezResult DeactivateWorker();
 
+  /// \brief Restricts the thread to the given CPUs, which all belong to the given NUMA node. Must be called before the thread is started.
+  void SetAffinity(ezArrayPtr<const ezUInt16> cpus, ezUInt16 uiNumaNode);
+
+  /// \brief Returns the NUMA node that was passed to SetAffinity().
+  ezUInt16 GetNumaNode() const { return m_uiNumaNode; }
+
 private:
   // Which types of tasks this thread should work on.
   ezWorkerThreadType::Enum m_WorkerType;
@@ -31,6 +38,9 @@ private:
   // For display purposes.
   ezUInt16 m_uiWorkerThreadNumber = 0xFFFF;
 
+  // The NUMA node that this thread is bound to, see ezTaskThreadAffinity.
+  ezUInt16 m_uiNumaNode = 0;
+
   ///@}
 
   /// \name Thread Utilization
@@ -60,6 +70,9 @@ public:
   /// \brief If the thread is currently idle, this will wake it up and return EZ_SUCCESS.
   ezTaskWorkerState WakeUpIfIdle();
 
+  /// \brief Returns true if the thread is currently sleeping, because it didn't find any work.
+  bool IsIdle() const { return m_iWorkerState == (int)ezTaskWorkerState::Idle; }
+
 private:
   // Puts the thread to sleep (idle state)
   void WaitForWork();
@@ -75,6 +88,18 @@ private:
   ezAtomicInteger32 m_iWorkerState; // ezTaskWorkerState
 
   ///@}
+
+  /// \name Work Stealing
+  ///@{
+
+public:
+  /// \brief The queues into which this thread pushes the tasks that it schedules (ezTaskSchedulingMode::WorkStealing only).
+  ezTaskWorkStealingQueues& GetLocalQueues() { return m_LocalQueues; }
+
+private:
+  ezTaskWorkStealingQueues m_LocalQueues;
+
+  ///@}
 };
 
 /// \internal Thread local state used by the task system (and for better debugging)
@@ -85,6 +110,8 @@ struct ezTaskWorkerInfo
   ezInt32 m_iWorkerIndex = -1;
   const char* m_szTaskName = nullptr;
   ezAtomicInteger32* m_pWorkerState = nullptr;
+  ezTaskWorkStealingQueues* m_pLocalQueues = nullptr;
+  ezUInt32 m_uiStealRandomState = 0;
 };
 
 extern thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
@@ -274,3 +274,13 @@ EZ_ALWAYS_INLINE ezInt64 ezAtomicUtils::CompareAndSwap(volatile ezInt64& ref_iDe
 {
   return _InterlockedCompareExchange64(&ref_iDest, value, iExpected);
 }
+
+EZ_ALWAYS_INLINE ezUInt8 ezAtomicUtils::ReadRelaxed(volatile const ezUInt8& uiSrc)
+{
+  return static_cast<ezUInt8>(__iso_volatile_load8(reinterpret_cast<volatile const __int8*>(&uiSrc)));
+}
+
+EZ_ALWAYS_INLINE void ezAtomicUtils::SetRelaxed(volatile ezUInt8& ref_uiDest, ezUInt8 value)
+{
+  __iso_volatile_store8(reinterpret_cast<volatile __int8*>(&ref_uiDest), static_cast<__int8>(value));
+}
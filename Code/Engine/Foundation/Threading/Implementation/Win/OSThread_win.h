@@ -148,6 +148,11 @@ ezOSThread::~ezOSThread()
 /// Attempts to acquire an exclusive lock for this mutex object
 void ezOSThread::Start()
 {
+  if (m_CpuAffinityMask[0] != 0)
+  {
+    SetThreadAffinityMask(m_hHandle, static_cast<DWORD_PTR>(m_CpuAffinityMask[0]));
+  }
+
   ResumeThread(m_hHandle);
 }
 
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <Foundation/Threading/TaskSystem.h>
+
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L) && __has_include(<coroutine>)
+#  define EZ_TASKSYSTEM_COROUTINES EZ_ON
+#else
+#  define EZ_TASKSYSTEM_COROUTINES EZ_OFF
+#endif
+
+#if EZ_ENABLED(EZ_TASKSYSTEM_COROUTINES)
+
+#  include <coroutine>
+
+/// \brief The return type for coroutines that are executed by the ezTaskSystem.
+///
+/// Inside such a coroutine, use 'co_await' on an ezTaskGroupID (or on another ezTaskCoroutine) to wait for it to finish.
+/// Instead of blocking the worker thread, or executing unrelated tasks on top of its stack (as WaitForGroup() does),
+/// the coroutine gets suspended and the worker thread is free to do other work. Once the awaited group has finished,
+/// the coroutine is continued by a new task, potentially on a different thread.
+/// That way long chains of dependent work neither pin worker threads, nor make the task system spawn additional ones.
+///
+/// A coroutine does not run until Start() is called, which returns an ezTaskGroupID that finishes once the coroutine has run to completion.
+/// This group ID can be waited for, or used as a dependency, like any other.
+///
+/// The code of a coroutine is executed by tasks that are flagged with ezTaskNesting::Never, so it must not call WaitForGroup(), use co_await instead.
+///
+/// \code{.cpp}
+///   ezTaskCoroutine SetupWorld(ezTaskGroupID loadResources)
+///   {
+///     co_await loadResources;
+///     co_await UpdateContent(); // UpdateContent() returns another ezTaskCoroutine
+///     ...
+///   }
+///
+///   ezTaskGroupID worldReady = SetupWorld(loadingGroup).Start(ezTaskPriority::LongRunning);
+/// \endcode
+///
+/// Only available when the compiler supports C++20 coroutines, check EZ_ENABLED(EZ_TASKSYSTEM_COROUTINES).
+class ezTaskCoroutine
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskCoroutine);
+
+public:
+  struct promise_type;
+  using Handle = std::coroutine_handle<promise_type>;
+
+  ezTaskCoroutine(ezTaskCoroutine&& other)
+    : m_Handle(other.m_Handle)
+  {
+    other.m_Handle = nullptr;
+  }
+
+  /// \brief Destroys the coroutine, if it has never been started.
+  ~ezTaskCoroutine()
+  {
+    if (m_Handle)
+    {
+      m_Handle.destroy();
+    }
+  }
+
+  /// \brief Schedules the coroutine for execution with the given priority, once the optional dependency has finished.
+  ///
+  /// All tasks that continue the coroutine after a co_await use the same priority.
+  /// Returns a group ID that finishes once the coroutine has run to completion. Can only be called once.
+  ezTaskGroupID Start(ezTaskPriority::Enum priority = ezTaskPriority::ThisFrame, ezTaskGroupID dependency = ezTaskGroupID())
+  {
+    EZ_ASSERT_DEV(m_Handle, "The coroutine has already been started.");
+
+    Handle handle = m_Handle;
+    m_Handle = nullptr;
+
+    promise_type& promise = handle.promise();
+    promise.m_Priority = priority;
+
+    // this group never gets any tasks, it is only started once the coroutine has completed, which then finishes it right away
+    // until then, everyone that waits for it or depends on it has to wait for the coroutine
+    promise.m_FinishedGroup = ezTaskSystem::CreateTaskGroup(priority);
+
+    // the coroutine may run to completion before ScheduleResume() returns, so don't access the promise afterwards
+    const ezTaskGroupID finishedGroup = promise.m_FinishedGroup;
+    ScheduleResume(handle, priority, dependency);
+    return finishedGroup;
+  }
+
+  /// \internal Suspends the coroutine until a task group has finished.
+  struct GroupAwaiter
+  {
+    bool await_ready() const { return ezTaskSystem::IsTaskGroupFinished(m_Group); }
+    void await_suspend(std::coroutine_handle<> handle) const { ScheduleResume(handle, m_Priority, m_Group); }
+    void await_resume() const {}
+
+    ezTaskGroupID m_Group;
+    ezTaskPriority::Enum m_Priority;
+  };
+
+  /// \internal Destroys the coroutine frame after the coroutine has completed and signals its group as finished.
+  struct FinalAwaiter
+  {
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(Handle handle) const noexcept
+    {
+      const ezTaskGroupID finishedGroup = handle.promise().m_FinishedGroup;
+      handle.destroy();
+
+      // a group without tasks finishes immediately, which wakes up all waiting threads and starts all dependent groups
+      ezTaskSystem::StartTaskGroup(finishedGroup);
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  /// \internal The promise type, as required by the C++ coroutine machinery.
+  struct promise_type
+  {
+    ezTaskCoroutine get_return_object() { return ezTaskCoroutine(Handle::from_promise(*this)); }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { EZ_REPORT_FAILURE("Unhandled exception in an ezTaskCoroutine."); }
+
+    GroupAwaiter await_transform(ezTaskGroupID group) { return GroupAwaiter{group, m_Priority}; }
+    GroupAwaiter await_transform(ezTaskCoroutine&& coroutine) { return GroupAwaiter{coroutine.Start(m_Priority), m_Priority}; }
+
+    ezTaskPriority::Enum m_Priority = ezTaskPriority::ThisFrame;
+    ezTaskGroupID m_FinishedGroup;
+  };
+
+private:
+  explicit ezTaskCoroutine(Handle handle)
+    : m_Handle(handle)
+  {
+  }
+
+  /// \brief Continues a suspended coroutine in a new task.
+  class ResumeTask final : public ezTask
+  {
+  public:
+    ResumeTask(std::coroutine_handle<> handle)
+      : m_Handle(handle)
+    {
+      ConfigureTask("ezTaskCoroutine", ezTaskNesting::Never);
+    }
+
+  private:
+    virtual void Execute() override { m_Handle.resume(); }
+
+    std::coroutine_handle<> m_Handle;
+  };
+
+  static void ScheduleResume(std::coroutine_handle<> handle, ezTaskPriority::Enum priority, ezTaskGroupID dependency)
+  {
+    ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(priority);
+
+    if (dependency.IsValid())
+    {
+      ezTaskSystem::AddTaskGroupDependency(group, dependency);
+    }
+
+    ezTaskSystem::AddTaskToGroup(group, EZ_DEFAULT_NEW(ResumeTask, handle));
+    ezTaskSystem::StartTaskGroup(group);
+  }
+
+  Handle m_Handle;
+};
+
+#endif
@@ -103,6 +103,25 @@ private:
   /// \brief Helps executing tasks that are suitable for the calling thread. Returns true if a task was found and executed.
   static bool HelpExecutingTasks(const ezTaskGroupID& WaitingForGroup);
 
+  /// \brief GetNextTask() implementation for ezTaskSchedulingMode::WorkStealing.
+  static TaskData GetNextTaskWorkStealing(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait,
+    const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
+
+  /// \brief Takes a task of the given priority from the global list, if there is one that fulfills the given filter.
+  static bool TakeTaskFromGlobalQueue(ezTaskPriority::Enum priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_task);
+
+  /// \brief Tries to steal a task of the given local queue index from any other thread's local queues.
+  static bool StealTask(ezUInt32 uiLocalQueueIndex, TaskData& out_task);
+
+  /// \brief Returns true if any global list or local queue in the given priority range may still contain tasks.
+  static bool HasPendingTasks(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority);
+
+  /// \brief Moves all tasks from the given local queues into the global lists. Must only be called when the owner of the queues is not active.
+  static void MoveLocalTasksToGlobalQueue(ezTaskWorkStealingQueues& ref_queues);
+
+  /// \brief Updates ezTaskSystemState::m_uiNumGlobalTasks for the given priority. Must be called while holding the lock.
+  static void UpdateGlobalTaskCount(ezTaskPriority::Enum priority);
+
   ///@}
 
   /// \name Managing Task Groups
@@ -176,6 +195,24 @@ private:
   /// \brief Is called whenever a dependency of pGroup has finished. Once all dependencies are finished, the group's tasks will get scheduled.
   static void DependencyHasFinished(ezTaskGroup* pGroup);
 
+  /// \brief Wakes up threads of the type that is responsible for executing tasks of the given priority.
+  static void WakeUpThreadsForPriority(ezTaskPriority::Enum priority, ezUInt32 uiNumThreads);
+
+  /// \brief Returns the group stored in the given slot. Does not need a lock, the slot must have been allocated before.
+  static ezTaskGroup* GetTaskGroupByIndex(ezUInt32 uiIndex);
+
+  /// \brief Takes an unused group from the free list or allocates a new slot.
+  static ezTaskGroup* AllocateTaskGroup();
+
+  /// \brief Puts a finished group back onto the free list.
+  static void FreeTaskGroup(ezTaskGroup* pGroup);
+
+  /// \brief Links pGroup into the dependents list of its uiDependency-th dependency. Returns false, if that dependency has already finished.
+  static bool AddDependentGroup(ezTaskGroup* pGroup, ezUInt32 uiDependency);
+
+  /// \brief Closes the dependents list of the finished group pGroup and notifies all groups in it.
+  static void ReleaseDependentGroups(ezTaskGroup* pGroup, ezUInt32 uiNewGroupCounter);
+
   ///@}
 
   /// \name Thread Management
@@ -198,6 +235,26 @@ public:
   /// \brief Returns the maximum number of threads that should work on the given type of task at the same time.
   static ezUInt32 GetWorkerThreadCount(ezWorkerThreadType::Enum type);
 
+  /// \brief Selects how scheduled tasks are distributed onto the worker threads. See ezTaskSchedulingMode.
+  ///
+  /// This restarts all worker threads and should therefore be called at startup, before tasks are scheduled.
+  /// Tasks that are already queued are not lost, but the function must not be called while other threads are scheduling or waiting for tasks.
+  static void SetSchedulingMode(ezTaskSchedulingMode::Enum mode); // [tested]
+
+  /// \brief Returns the currently used scheduling mode.
+  static ezTaskSchedulingMode::Enum GetSchedulingMode(); // [tested]
+
+  /// \brief Selects on which CPUs the worker threads may run. See ezTaskThreadAffinity.
+  ///
+  /// Like SetSchedulingMode(), this restarts all worker threads and should therefore be called at startup.
+  static void SetWorkerThreadAffinity(ezTaskThreadAffinity::Enum affinity); // [tested]
+
+  /// \brief Returns the currently used worker thread affinity.
+  static ezTaskThreadAffinity::Enum GetWorkerThreadAffinity(); // [tested]
+
+  /// \brief Returns the NUMA node that the given worker thread is bound to. Threads without a node affinity report node 0.
+  static ezUInt32 GetWorkerThreadNumaNode(ezWorkerThreadType::Enum type, ezUInt32 uiThreadIndex);
+
   /// \brief Returns the number of threads that have been allocated to potentially work on the given type of task.
   ///
   /// CAREFUL! This is not the number of threads that will be active at the same time. Use GetWorkerThreadCount() for that.
@@ -205,6 +262,11 @@ public:
   /// at runtime to prevent deadlocks and it can grow very, very large.
   static ezUInt32 GetNumAllocatedWorkerThreads(ezWorkerThreadType::Enum type);
 
+  /// \brief Returns true if any of the worker threads of the given type is idle, or could still be allocated to take on more work.
+  ///
+  /// Useful to decide whether it is worth splitting up work any further.
+  static bool HasIdleWorkerThreads(ezWorkerThreadType::Enum type);
+
   /// \brief Returns the (thread local) type of tasks that would be executed on this thread
   static ezWorkerThreadType::Enum GetCurrentThreadWorkerType();
 
@@ -214,6 +276,12 @@ public:
   /// Also optionally returns the number of tasks that were finished during the last frame.
   static double GetThreadUtilization(ezWorkerThreadType::Enum type, ezUInt32 uiThreadIndex, ezUInt32* pNumTasksExecuted = nullptr);
 
+  /// \brief Returns the average utilization (0.0 to 1.0) of all short and long task workers that are bound to the given NUMA node.
+  ///
+  /// Same as GetThreadUtilization(), only valid if FinishFrameTasks() is called once per frame. Workers without a node affinity count towards node 0.
+  /// Also optionally returns the number of tasks that these workers finished during the last frame.
+  static double GetNumaNodeUtilization(ezUInt32 uiNumaNode, ezUInt32* pNumTasksExecuted = nullptr);
+
   /// \brief [internal] Wakes up or allocates up to \a uiNumThreads, unless enough threads are currently active and not blocked
   static void WakeUpThreads(ezWorkerThreadType::Enum type, ezUInt32 uiNumThreads);
 
@@ -223,6 +291,9 @@ private:
   /// \brief Allocates \a uiAddThreads additional threads of \a type
   static void AllocateThreads(ezWorkerThreadType::Enum type, ezUInt32 uiAddThreads);
 
+  /// \brief Computes on which CPUs the given worker thread should run, according to the current ezTaskThreadAffinity.
+  static void DetermineWorkerAffinity(ezWorkerThreadType::Enum type, ezUInt32 uiThreadIndex, ezDynamicArray<ezUInt16>& out_cpus, ezUInt16& out_uiNumaNode);
+
   /// \brief Shuts down all worker threads. Does NOT finish the remaining tasks that were not started yet. Does not clear them either, though.
   static void StopWorkerThreads();
 
@@ -270,11 +341,46 @@ public:
   static void ParallelForSingleIndex(
     ezArrayPtr<ElemType> taskItems, Callback taskCallback, const char* szTaskName = nullptr, const ezParallelForParams& params = ezParallelForParams());
 
+  /// Computes a single result from the index range [uiStartIndex; uiStartIndex + uiNumItems) in parallel.
+  ///
+  /// The range is split into blocks (see ezParallelForParams::DetermineNumBlocks()). For each block
+  /// 'ResultType mapCallback(ezUInt32 uiBlockStartIndex, ezUInt32 uiBlockEndIndex)' is called, potentially in parallel.
+  /// The partial results are then combined on the calling thread, always in the order of the blocks, via
+  /// 'ResultType reduceCallback(const ResultType& lhs, const ResultType& rhs)', so the reduce operation has to be associative, but not commutative.
+  /// Returns 'identity' when there are no items.
+  ///   - float sum = ParallelReduce(0, n, 0.0f, [&](ezUInt32 s, ezUInt32 e) { float r = 0; for (...) r += values[i]; return r; }, [](float a, float b) { return a + b; });
+  template <typename ResultType, typename MapCallback, typename ReduceCallback>
+  static ResultType ParallelReduce(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, const ResultType& identity, MapCallback mapCallback,
+    ReduceCallback reduceCallback, const char* szTaskName = nullptr, const ezParallelForParams& params = ezParallelForParams());
+
+  /// Replaces every item in 'taskItems' with the combination of itself and all items before it (inclusive prefix scan), in parallel.
+  ///
+  /// 'ElemType op(const ElemType& lhs, const ElemType& rhs)' has to be associative. E.g. with an addition { 1, 2, 3 } becomes { 1, 3, 6 }.
+  template <typename ElemType, typename Callback>
+  static void ParallelInclusiveScan(
+    ezArrayPtr<ElemType> taskItems, Callback op, const char* szTaskName = nullptr, const ezParallelForParams& params = ezParallelForParams());
+
+  /// Replaces every item in 'taskItems' with the combination of 'initialValue' and all items before it (exclusive prefix scan), in parallel.
+  ///
+  /// 'ElemType op(const ElemType& lhs, const ElemType& rhs)' has to be associative. E.g. with an addition and an initial value of 0,
+  /// { 1, 2, 3 } becomes { 0, 1, 3 }.
+  template <typename ElemType, typename Callback>
+  static void ParallelExclusiveScan(ezArrayPtr<ElemType> taskItems, const ElemType& initialValue, Callback op, const char* szTaskName = nullptr,
+    const ezParallelForParams& params = ezParallelForParams());
+
 private:
   template <typename ElemType>
   static void ParallelForInternal(
     ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& params);
 
+  template <typename ElemType, typename Callback>
+  static void ParallelScanInternal(
+    ezArrayPtr<ElemType> taskItems, const ElemType* pInitialValue, Callback& op, const char* szTaskName, const ezParallelForParams& params);
+
+  /// Implements ezParallelForMode::Adaptive for all ParallelFor variants. Blocks until all items have been processed.
+  static void ParallelForAdaptive(ezUInt64 uiStartIndex, ezUInt64 uiNumItems, const ezParallelForIndexedFunction64& taskCallback,
+    const char* szTaskName, const ezParallelForParams& params);
+
   ///@}
 
   /// \name Utilities
@@ -0,0 +1,694 @@
+#include <Foundation/FoundationPCH.h>
+
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/IO/JSONWriter.h>
+#include <Foundation/IO/Stream.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Memory/AllocatorWrapper.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Utilities/Metrics.h>
+
+namespace
+{
+  /// The values of all counters and histograms that one thread has recorded.
+  ///
+  /// Only the owning thread writes to these values, so it can update them with a plain load and store. The atomics only make sure that
+  /// TakeSnapshot() can read them from another thread at any time.
+  struct MetricsThreadSlots
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    std::atomic<ezUInt64> m_Values[ezMetrics::MAX_SLOTS];
+  };
+
+  struct MetricInfo
+  {
+    ezHashedString m_sName;
+    ezMetricType::Enum m_Type = ezMetricType::Counter;
+    ezUInt32 m_uiFirstSlot = ezInvalidIndex;
+    ezDynamicArray<double, ezStaticAllocatorWrapper> m_BucketUpperBounds;
+    std::atomic<double> m_GaugeValue = {0.0};
+  };
+
+  // The registry is never cleaned up, metrics stay valid until the process terminates. Therefore its memory isn't tracked.
+  // The deque never moves its elements, so handles can point directly to the gauge values and bucket bounds.
+  static ezDeque<MetricInfo, ezStaticAllocatorWrapper> s_MetricInfos;
+  static ezMutex s_MetricsMutex;
+  static ezUInt32 s_uiNumUsedSlots = 0;
+
+  /// Whether a slot stores the bit pattern of a double (the sum of a histogram) instead of an integer.
+  static bool s_SlotIsDouble[ezMetrics::MAX_SLOTS] = {};
+
+  static ezDynamicArray<MetricsThreadSlots*, ezStaticAllocatorWrapper> s_LiveThreadSlots;
+  static ezDynamicArray<MetricsThreadSlots*, ezStaticAllocatorWrapper> s_FreeThreadSlots;
+
+  /// The values of all threads that have terminated already.
+  static MetricsThreadSlots s_RetiredSlots;
+
+  /// The totals at the time of the last ResetValues() call, which are subtracted from all following snapshots.
+  static ezUInt64 s_ResetBaseline[ezMetrics::MAX_SLOTS] = {};
+
+  static thread_local std::atomic<ezUInt64>* s_pThreadSlots = nullptr;
+
+  EZ_ALWAYS_INLINE double BitsToDouble(ezUInt64 uiBits)
+  {
+    double fResult;
+    ezMemoryUtils::RawByteCopy(&fResult, &uiBits, sizeof(double));
+    return fResult;
+  }
+
+  EZ_ALWAYS_INLINE ezUInt64 DoubleToBits(double fValue)
+  {
+    ezUInt64 uiResult;
+    ezMemoryUtils::RawByteCopy(&uiResult, &fValue, sizeof(double));
+    return uiResult;
+  }
+
+  /// Adds the values of one thread to the values of all terminated threads. Must be called with s_MetricsMutex locked.
+  void RetireThreadSlots(MetricsThreadSlots* pSlots)
+  {
+    for (ezUInt32 i = 0; i < s_uiNumUsedSlots; ++i)
+    {
+      const ezUInt64 uiValue = pSlots->m_Values[i].load(std::memory_order_relaxed);
+      const ezUInt64 uiRetired = s_RetiredSlots.m_Values[i].load(std::memory_order_relaxed);
+
+      if (s_SlotIsDouble[i])
+        s_RetiredSlots.m_Values[i].store(DoubleToBits(BitsToDouble(uiRetired) + BitsToDouble(uiValue)), std::memory_order_relaxed);
+      else
+        s_RetiredSlots.m_Values[i].store(uiRetired + uiValue, std::memory_order_relaxed);
+
+      pSlots->m_Values[i].store(0, std::memory_order_relaxed);
+    }
+
+    s_LiveThreadSlots.RemoveAndSwap(pSlots);
+    s_FreeThreadSlots.PushBack(pSlots);
+  }
+
+  /// Hands the values of a thread over to s_RetiredSlots when the thread terminates.
+  struct MetricsThreadSlotsReleaser
+  {
+    MetricsThreadSlots* m_pSlots = nullptr;
+
+    ~MetricsThreadSlotsReleaser()
+    {
+      if (m_pSlots == nullptr)
+        return;
+
+      EZ_LOCK(s_MetricsMutex);
+      RetireThreadSlots(m_pSlots);
+      s_pThreadSlots = nullptr;
+    }
+  };
+
+  // separate from s_pThreadSlots, so that accessing the slots doesn't have to go through the initialization check for thread_local objects with destructors
+  static thread_local MetricsThreadSlotsReleaser s_ThreadSlotsReleaser;
+
+  ezUInt64 SumIntegerSlot(ezUInt32 uiSlot)
+  {
+    ezUInt64 uiSum = s_RetiredSlots.m_Values[uiSlot].load(std::memory_order_relaxed);
+
+    for (const MetricsThreadSlots* pSlots : s_LiveThreadSlots)
+    {
+      uiSum += pSlots->m_Values[uiSlot].load(std::memory_order_relaxed);
+    }
+
+    return uiSum - s_ResetBaseline[uiSlot];
+  }
+
+  double SumDoubleSlot(ezUInt32 uiSlot)
+  {
+    double fSum = BitsToDouble(s_RetiredSlots.m_Values[uiSlot].load(std::memory_order_relaxed));
+
+    for (const MetricsThreadSlots* pSlots : s_LiveThreadSlots)
+    {
+      fSum += BitsToDouble(pSlots->m_Values[uiSlot].load(std::memory_order_relaxed));
+    }
+
+    return fSum - BitsToDouble(s_ResetBaseline[uiSlot]);
+  }
+
+  MetricInfo* FindMetricInfo(ezStringView sName)
+  {
+    const ezTempHashedString sHashedName(sName);
+
+    for (MetricInfo& info : s_MetricInfos)
+    {
+      if (info.m_sName == sHashedName)
+        return &info;
+    }
+
+    return nullptr;
+  }
+
+  MetricInfo& AddMetricInfo(ezStringView sName, ezMetricType::Enum type)
+  {
+    MetricInfo& info = s_MetricInfos.ExpandAndGetRef();
+    info.m_sName.Assign(sName);
+    info.m_Type = type;
+    return info;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+EZ_ALWAYS_INLINE std::atomic<ezUInt64>* ezMetrics::GetThreadSlots()
+{
+  std::atomic<ezUInt64>* pSlots = s_pThreadSlots;
+
+  if (pSlots == nullptr)
+  {
+    pSlots = AllocateThreadSlots();
+  }
+
+  return pSlots;
+}
+
+std::atomic<ezUInt64>* ezMetrics::AllocateThreadSlots()
+{
+  MetricsThreadSlots* pSlots = nullptr;
+
+  {
+    EZ_LOCK(s_MetricsMutex);
+
+    if (!s_FreeThreadSlots.IsEmpty())
+    {
+      // values of recycled slots have already been reset in RetireThreadSlots()
+      pSlots = s_FreeThreadSlots.PeekBack();
+      s_FreeThreadSlots.PopBack();
+    }
+    else
+    {
+      pSlots = EZ_NEW(ezStaticAllocatorWrapper::GetAllocator(), MetricsThreadSlots);
+
+      for (auto& value : pSlots->m_Values)
+      {
+        value.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    s_LiveThreadSlots.PushBack(pSlots);
+  }
+
+  s_ThreadSlotsReleaser.m_pSlots = pSlots;
+  s_pThreadSlots = pSlots->m_Values;
+  return s_pThreadSlots;
+}
+
+ezMetricCounter ezMetrics::RegisterCounter(ezStringView sName)
+{
+  EZ_LOCK(s_MetricsMutex);
+
+  ezMetricCounter counter;
+
+  if (const MetricInfo* pInfo = FindMetricInfo(sName))
+  {
+    EZ_ASSERT_DEV(pInfo->m_Type == ezMetricType::Counter, "Metric '{}' is already registered with a different type.", sName);
+
+    if (pInfo->m_Type == ezMetricType::Counter)
+    {
+      counter.m_uiSlot = pInfo->m_uiFirstSlot;
+    }
+
+    return counter;
+  }
+
+  if (s_uiNumUsedSlots + 1 > MAX_SLOTS)
+  {
+    ezLog::Error("Can't register counter '{}', all {} metric slots are in use.", sName, MAX_SLOTS);
+    return counter;
+  }
+
+  MetricInfo& info = AddMetricInfo(sName, ezMetricType::Counter);
+  info.m_uiFirstSlot = s_uiNumUsedSlots;
+  s_uiNumUsedSlots += 1;
+
+  counter.m_uiSlot = info.m_uiFirstSlot;
+  return counter;
+}
+
+ezMetricGauge ezMetrics::RegisterGauge(ezStringView sName)
+{
+  EZ_LOCK(s_MetricsMutex);
+
+  ezMetricGauge gauge;
+
+  if (MetricInfo* pInfo = FindMetricInfo(sName))
+  {
+    EZ_ASSERT_DEV(pInfo->m_Type == ezMetricType::Gauge, "Metric '{}' is already registered with a different type.", sName);
+
+    if (pInfo->m_Type == ezMetricType::Gauge)
+    {
+      gauge.m_pValue = &pInfo->m_GaugeValue;
+    }
+
+    return gauge;
+  }
+
+  MetricInfo& info = AddMetricInfo(sName, ezMetricType::Gauge);
+  gauge.m_pValue = &info.m_GaugeValue;
+  return gauge;
+}
+
+ezMetricHistogram ezMetrics::RegisterHistogram(ezStringView sName, ezArrayPtr<const double> bucketUpperBounds)
+{
+  EZ_LOCK(s_MetricsMutex);
+
+  ezMetricHistogram histogram;
+
+  if (const MetricInfo* pInfo = FindMetricInfo(sName))
+  {
+    EZ_ASSERT_DEV(pInfo->m_Type == ezMetricType::Histogram, "Metric '{}' is already registered with a different type.", sName);
+
+    if (pInfo->m_Type == ezMetricType::Histogram)
+    {
+      histogram.m_uiFirstSlot = pInfo->m_uiFirstSlot;
+      histogram.m_BucketUpperBounds = pInfo->m_BucketUpperBounds;
+    }
+
+    return histogram;
+  }
+
+  for (ezUInt32 i = 1; i < bucketUpperBounds.GetCount(); ++i)
+  {
+    EZ_ASSERT_DEV(bucketUpperBounds[i - 1] < bucketUpperBounds[i], "The bucket bounds of histogram '{}' are not sorted in ascending order.", sName);
+  }
+
+  // one slot per bucket, one for the overflow bucket and one for the sum of all samples
+  const ezUInt32 uiNumSlots = bucketUpperBounds.GetCount() + 2;
+
+  if (s_uiNumUsedSlots + uiNumSlots > MAX_SLOTS)
+  {
+    ezLog::Error("Can't register histogram '{}', not enough metric slots are left.", sName);
+    return histogram;
+  }
+
+  MetricInfo& info = AddMetricInfo(sName, ezMetricType::Histogram);
+  info.m_uiFirstSlot = s_uiNumUsedSlots;
+  info.m_BucketUpperBounds = bucketUpperBounds;
+  s_uiNumUsedSlots += uiNumSlots;
+
+  s_SlotIsDouble[s_uiNumUsedSlots - 1] = true;
+
+  histogram.m_uiFirstSlot = info.m_uiFirstSlot;
+  histogram.m_BucketUpperBounds = info.m_BucketUpperBounds;
+  return histogram;
+}
+
+void ezMetrics::TakeSnapshot(ezMetricsSnapshot& out_snapshot)
+{
+  out_snapshot.Clear();
+  out_snapshot.m_Timestamp = ezTime::Now();
+
+  EZ_LOCK(s_MetricsMutex);
+
+  out_snapshot.m_Metrics.Reserve(s_MetricInfos.GetCount());
+
+  for (const MetricInfo& info : s_MetricInfos)
+  {
+    ezMetricsSnapshot::Metric& metric = out_snapshot.m_Metrics.ExpandAndGetRef();
+    metric.m_sName = info.m_sName;
+    metric.m_Type = info.m_Type;
+
+    switch (info.m_Type)
+    {
+      case ezMetricType::Counter:
+        metric.m_uiCount = SumIntegerSlot(info.m_uiFirstSlot);
+        break;
+
+      case ezMetricType::Gauge:
+        metric.m_fValue = info.m_GaugeValue.load(std::memory_order_relaxed);
+        break;
+
+      case ezMetricType::Histogram:
+      {
+        const ezUInt32 uiNumBuckets = info.m_BucketUpperBounds.GetCount() + 1;
+
+        metric.m_uiFirstBucket = out_snapshot.m_BucketCounts.GetCount();
+        metric.m_uiNumBuckets = uiNumBuckets;
+
+        for (ezUInt32 i = 0; i < uiNumBuckets; ++i)
+        {
+          const ezUInt64 uiBucketCount = SumIntegerSlot(info.m_uiFirstSlot + i);
+          out_snapshot.m_BucketCounts.PushBack(uiBucketCount);
+          metric.m_uiCount += uiBucketCount;
+        }
+
+        out_snapshot.m_BucketUpperBounds.PushBackRange(info.m_BucketUpperBounds);
+        out_snapshot.m_BucketUpperBounds.PushBack(ezMath::MaxValue<double>());
+
+        metric.m_fValue = SumDoubleSlot(info.m_uiFirstSlot + uiNumBuckets);
+      }
+      break;
+    }
+  }
+}
+
+void ezMetrics::ResetValues()
+{
+  EZ_LOCK(s_MetricsMutex);
+
+  // the slots of live threads must only be written by their owner, so instead of clearing them, remember the current totals
+  for (ezUInt32 i = 0; i < s_uiNumUsedSlots; ++i)
+  {
+    s_ResetBaseline[i] = 0;
+
+    if (s_SlotIsDouble[i])
+      s_ResetBaseline[i] = DoubleToBits(SumDoubleSlot(i));
+    else
+      s_ResetBaseline[i] = SumIntegerSlot(i);
+  }
+
+  for (MetricInfo& info : s_MetricInfos)
+  {
+    info.m_GaugeValue.store(0.0, std::memory_order_relaxed);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void ezMetricCounter::Add(ezUInt64 uiAmount) const
+{
+  if (m_uiSlot == ezInvalidIndex)
+    return;
+
+  std::atomic<ezUInt64>& value = ezMetrics::GetThreadSlots()[m_uiSlot];
+  value.store(value.load(std::memory_order_relaxed) + uiAmount, std::memory_order_relaxed);
+}
+
+void ezMetricGauge::Set(double fValue) const
+{
+  if (m_pValue == nullptr)
+    return;
+
+  m_pValue->store(fValue, std::memory_order_relaxed);
+}
+
+void ezMetricGauge::Add(double fAmount) const
+{
+  if (m_pValue == nullptr)
+    return;
+
+  double fExpected = m_pValue->load(std::memory_order_relaxed);
+  while (!m_pValue->compare_exchange_weak(fExpected, fExpected + fAmount, std::memory_order_relaxed))
+  {
+  }
+}
+
+double ezMetricGauge::Get() const
+{
+  if (m_pValue == nullptr)
+    return 0.0;
+
+  return m_pValue->load(std::memory_order_relaxed);
+}
+
+void ezMetricHistogram::AddSample(double fValue) const
+{
+  if (m_uiFirstSlot == ezInvalidIndex)
+    return;
+
+  // binary search for the first bucket that can hold the value, the overflow bucket is at index GetCount()
+  ezUInt32 uiLow = 0;
+  ezUInt32 uiHigh = m_BucketUpperBounds.GetCount();
+
+  while (uiLow < uiHigh)
+  {
+    const ezUInt32 uiMid = (uiLow + uiHigh) / 2;
+
+    if (fValue <= m_BucketUpperBounds[uiMid])
+      uiHigh = uiMid;
+    else
+      uiLow = uiMid + 1;
+  }
+
+  std::atomic<ezUInt64>* pSlots = ezMetrics::GetThreadSlots() + m_uiFirstSlot;
+
+  std::atomic<ezUInt64>& bucket = pSlots[uiLow];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  std::atomic<ezUInt64>& sum = pSlots[m_BucketUpperBounds.GetCount() + 1];
+  sum.store(DoubleToBits(BitsToDouble(sum.load(std::memory_order_relaxed)) + fValue), std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void ezMetricsSnapshot::Clear()
+{
+  m_Timestamp = ezTime::MakeZero();
+  m_Metrics.Clear();
+  m_BucketCounts.Clear();
+  m_BucketUpperBounds.Clear();
+}
+
+const ezMetricsSnapshot::Metric* ezMetricsSnapshot::FindMetric(ezStringView sName) const
+{
+  const ezTempHashedString sHashedName(sName);
+
+  for (const Metric& metric : m_Metrics)
+  {
+    if (metric.m_sName == sHashedName)
+      return &metric;
+  }
+
+  return nullptr;
+}
+
+ezArrayPtr<const ezUInt64> ezMetricsSnapshot::GetBucketCounts(const Metric& metric) const
+{
+  return m_BucketCounts.GetArrayPtr().GetSubArray(metric.m_uiFirstBucket, metric.m_uiNumBuckets);
+}
+
+ezArrayPtr<const double> ezMetricsSnapshot::GetBucketUpperBounds(const Metric& metric) const
+{
+  return m_BucketUpperBounds.GetArrayPtr().GetSubArray(metric.m_uiFirstBucket, metric.m_uiNumBuckets);
+}
+
+double ezMetricsSnapshot::GetMean(const Metric& metric) const
+{
+  if (metric.m_uiCount == 0)
+    return 0.0;
+
+  return metric.m_fValue / static_cast<double>(metric.m_uiCount);
+}
+
+double ezMetricsSnapshot::GetPercentile(const Metric& metric, double fPercentile) const
+{
+  if (metric.m_Type != ezMetricType::Histogram || metric.m_uiCount == 0)
+    return 0.0;
+
+  const ezArrayPtr<const ezUInt64> counts = GetBucketCounts(metric);
+  const ezArrayPtr<const double> bounds = GetBucketUpperBounds(metric);
+  const ezUInt32 uiOverflowBucket = metric.m_uiNumBuckets - 1;
+
+  const double fRank = ezMath::Clamp(fPercentile, 0.0, 100.0) / 100.0 * static_cast<double>(metric.m_uiCount);
+
+  ezUInt64 uiCumulative = 0;
+  for (ezUInt32 i = 0; i < uiOverflowBucket; ++i)
+  {
+    if (counts[i] == 0)
+      continue;
+
+    const ezUInt64 uiPrevCumulative = uiCumulative;
+    uiCumulative += counts[i];
+
+    if (static_cast<double>(uiCumulative) >= fRank)
+    {
+      // the first bucket starts at zero, unless its bound is negative
+      const double fLower = (i > 0) ? bounds[i - 1] : ezMath::Min(0.0, bounds[0]);
+      const double fUpper = bounds[i];
+      const double fFraction = (fRank - static_cast<double>(uiPrevCumulative)) / static_cast<double>(counts[i]);
+
+      return ezMath::Lerp(fLower, fUpper, fFraction);
+    }
+  }
+
+  return uiOverflowBucket > 0 ? bounds[uiOverflowBucket - 1] : 0.0;
+}
+
+void ezMetricsSnapshot::Serialize(ezStreamWriter& inout_stream) const
+{
+  const ezUInt8 uiVersion = 1;
+  inout_stream << uiVersion;
+
+  inout_stream << m_Timestamp;
+  inout_stream << m_Metrics.GetCount();
+
+  for (const Metric& metric : m_Metrics)
+  {
+    inout_stream << metric.m_sName.GetString();
+    inout_stream << static_cast<ezUInt8>(metric.m_Type.GetValue());
+    inout_stream << metric.m_uiCount;
+    inout_stream << metric.m_fValue;
+    inout_stream << metric.m_uiNumBuckets;
+
+    for (ezUInt32 i = 0; i < metric.m_uiNumBuckets; ++i)
+    {
+      inout_stream << m_BucketCounts[metric.m_uiFirstBucket + i];
+      inout_stream << m_BucketUpperBounds[metric.m_uiFirstBucket + i];
+    }
+  }
+}
+
+ezResult ezMetricsSnapshot::Deserialize(ezStreamReader& inout_stream)
+{
+  Clear();
+
+  ezUInt8 uiVersion = 0;
+  inout_stream >> uiVersion;
+
+  if (uiVersion != 1)
+    return EZ_FAILURE;
+
+  inout_stream >> m_Timestamp;
+
+  ezUInt32 uiNumMetrics = 0;
+  inout_stream >> uiNumMetrics;
+  m_Metrics.Reserve(uiNumMetrics);
+
+  ezStringBuilder sName;
+
+  for (ezUInt32 m = 0; m < uiNumMetrics; ++m)
+  {
+    Metric& metric = m_Metrics.ExpandAndGetRef();
+
+    inout_stream >> sName;
+    metric.m_sName.Assign(sName);
+
+    ezUInt8 uiType = 0;
+    inout_stream >> uiType;
+    metric.m_Type = static_cast<ezMetricType::Enum>(uiType);
+
+    inout_stream >> metric.m_uiCount;
+    inout_stream >> metric.m_fValue;
+    inout_stream >> metric.m_uiNumBuckets;
+
+    metric.m_uiFirstBucket = m_BucketCounts.GetCount();
+
+    for (ezUInt32 i = 0; i < metric.m_uiNumBuckets; ++i)
+    {
+      inout_stream >> m_BucketCounts.ExpandAndGetRef();
+      inout_stream >> m_BucketUpperBounds.ExpandAndGetRef();
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezMetricsSnapshot::WriteJSON(ezJSONWriter& inout_writer) const
+{
+  inout_writer.BeginObject();
+  inout_writer.AddVariableDouble("Timestamp", m_Timestamp.GetSeconds());
+
+  inout_writer.BeginObject("Counters");
+  for (const Metric& metric : m_Metrics)
+  {
+    if (metric.m_Type == ezMetricType::Counter)
+      inout_writer.AddVariableUInt64(metric.m_sName, metric.m_uiCount);
+  }
+  inout_writer.EndObject();
+
+  inout_writer.BeginObject("Gauges");
+  for (const Metric& metric : m_Metrics)
+  {
+    if (metric.m_Type == ezMetricType::Gauge)
+      inout_writer.AddVariableDouble(metric.m_sName, metric.m_fValue);
+  }
+  inout_writer.EndObject();
+
+  inout_writer.BeginObject("Histograms");
+  for (const Metric& metric : m_Metrics)
+  {
+    if (metric.m_Type != ezMetricType::Histogram)
+      continue;
+
+    inout_writer.BeginObject(metric.m_sName);
+    inout_writer.AddVariableUInt64("Count", metric.m_uiCount);
+    inout_writer.AddVariableDouble("Sum", metric.m_fValue);
+    inout_writer.AddVariableDouble("Mean", GetMean(metric));
+    inout_writer.AddVariableDouble("P50", GetPercentile(metric, 50.0));
+    inout_writer.AddVariableDouble("P90", GetPercentile(metric, 90.0));
+    inout_writer.AddVariableDouble("P99", GetPercentile(metric, 99.0));
+
+    // the overflow bucket has no real upper bound, so only its count is written
+    const ezArrayPtr<const double> bounds = GetBucketUpperBounds(metric);
+    inout_writer.BeginArray("UpperBounds");
+    for (ezUInt32 i = 0; i + 1 < bounds.GetCount(); ++i)
+    {
+      inout_writer.WriteDouble(bounds[i]);
+    }
+    inout_writer.EndArray();
+
+    inout_writer.BeginArray("Buckets");
+    for (ezUInt64 uiCount : GetBucketCounts(metric))
+    {
+      inout_writer.WriteUInt64(uiCount);
+    }
+    inout_writer.EndArray();
+
+    inout_writer.EndObject();
+  }
+  inout_writer.EndObject();
+
+  inout_writer.EndObject();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezResult ezMetricsFileWriter::Open(ezStringView sFilePath)
+{
+  Close();
+
+  EZ_SUCCEED_OR_RETURN(m_File.Open(sFilePath));
+
+  m_bIsOpen = true;
+  m_LastWrite = ezTime::MakeZero();
+  return EZ_SUCCESS;
+}
+
+void ezMetricsFileWriter::Close()
+{
+  if (!m_bIsOpen)
+    return;
+
+  m_File.Close();
+  m_bIsOpen = false;
+}
+
+ezResult ezMetricsFileWriter::WriteSnapshot(const ezMetricsSnapshot& snapshot)
+{
+  if (!m_bIsOpen)
+    return EZ_FAILURE;
+
+  {
+    ezStandardJSONWriter json;
+    json.SetWhitespaceMode(ezJSONWriter::WhitespaceMode::None);
+    json.SetOutputStream(&m_File);
+    snapshot.WriteJSON(json);
+
+    if (json.HadWriteError())
+      return EZ_FAILURE;
+  }
+
+  const char szNewLine = '\n';
+  EZ_SUCCEED_OR_RETURN(m_File.WriteBytes(&szNewLine, 1));
+
+  return m_File.Flush();
+}
+
+void ezMetricsFileWriter::Update(ezTime interval)
+{
+  if (!m_bIsOpen)
+    return;
+
+  const ezTime now = ezTime::Now();
+  if (!m_LastWrite.IsZero() && now - m_LastWrite < interval)
+    return;
+
+  m_LastWrite = now;
+
+  ezMetrics::TakeSnapshot(m_Snapshot);
+  WriteSnapshot(m_Snapshot).IgnoreResult();
+}
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Utilities_Implementation_Metrics);
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/Time/Time.h>
+
+#include <atomic>
+
+class ezStreamWriter;
+class ezStreamReader;
+class ezJSONWriter;
+
+/// \brief The different kinds of metrics that ezMetrics supports.
+struct ezMetricType
+{
+  using StorageType = ezUInt8;
+
+  enum Enum : ezUInt8
+  {
+    Counter,   ///< A monotonically increasing number, e.g. the number of loaded resources.
+    Gauge,     ///< A value that is set to its current state, e.g. the number of queued tasks.
+    Histogram, ///< A distribution of samples over fixed buckets, e.g. frame times or load latencies.
+
+    Default = Counter
+  };
+};
+
+/// \brief Handle to a counter metric. Obtained through ezMetrics::RegisterCounter().
+///
+/// Add() only touches memory that belongs to the calling thread, so it can be called from many threads at the same time
+/// without any contention.
+class EZ_FOUNDATION_DLL ezMetricCounter
+{
+public:
+  ezMetricCounter() = default;
+
+  bool IsValid() const { return m_uiSlot != ezInvalidIndex; }
+
+  /// \brief Increases the counter by the given amount.
+  void Add(ezUInt64 uiAmount = 1) const;
+
+private:
+  friend class ezMetrics;
+
+  ezUInt32 m_uiSlot = ezInvalidIndex;
+};
+
+/// \brief Handle to a gauge metric. Obtained through ezMetrics::RegisterGauge().
+///
+/// Gauges store a single value that is shared by all threads.
+class EZ_FOUNDATION_DLL ezMetricGauge
+{
+public:
+  ezMetricGauge() = default;
+
+  bool IsValid() const { return m_pValue != nullptr; }
+
+  /// \brief Replaces the value of the gauge.
+  void Set(double fValue) const;
+
+  /// \brief Adds the given (possibly negative) amount to the gauge.
+  void Add(double fAmount) const;
+
+  /// \brief Returns the current value of the gauge.
+  double Get() const;
+
+private:
+  friend class ezMetrics;
+
+  std::atomic<double>* m_pValue = nullptr;
+};
+
+/// \brief Handle to a histogram metric. Obtained through ezMetrics::RegisterHistogram().
+///
+/// Like counters, histograms accumulate their samples per thread, so AddSample() does not need any synchronization.
+class EZ_FOUNDATION_DLL ezMetricHistogram
+{
+public:
+  ezMetricHistogram() = default;
+
+  bool IsValid() const { return m_uiFirstSlot != ezInvalidIndex; }
+
+  /// \brief Adds the sample to the first bucket whose upper bound is larger or equal to the value.
+  ///
+  /// Values that are larger than the last upper bound end up in an additional overflow bucket.
+  void AddSample(double fValue) const;
+
+private:
+  friend class ezMetrics;
+
+  ezUInt32 m_uiFirstSlot = ezInvalidIndex;
+  ezArrayPtr<const double> m_BucketUpperBounds;
+};
+
+/// \brief The state of all metrics at one point in time, as returned by ezMetrics::TakeSnapshot().
+///
+/// A snapshot can be kept around and be refilled over and over. Once its arrays have grown large enough, taking a snapshot
+/// doesn't allocate any memory anymore.
+class EZ_FOUNDATION_DLL ezMetricsSnapshot
+{
+public:
+  struct Metric
+  {
+    ezHashedString m_sName;
+    ezEnum<ezMetricType> m_Type;
+    ezUInt64 m_uiCount = 0;      ///< The value of a counter, or the number of samples of a histogram.
+    double m_fValue = 0.0;       ///< The value of a gauge, or the sum of all samples of a histogram.
+    ezUInt32 m_uiFirstBucket = 0; ///< Histograms only: Index into m_BucketCounts and m_BucketUpperBounds.
+    ezUInt32 m_uiNumBuckets = 0;  ///< Histograms only: Number of buckets, including the overflow bucket.
+  };
+
+  ezTime m_Timestamp;
+  ezDynamicArray<Metric> m_Metrics;
+
+  /// \brief The sample counts of all histograms. Use GetBucketCounts() to access the buckets of one histogram.
+  ezDynamicArray<ezUInt64> m_BucketCounts;
+
+  /// \brief The upper bounds of all histogram buckets. The overflow bucket has no upper bound, but for simplicity
+  /// it is stored as the largest finite double.
+  ezDynamicArray<double> m_BucketUpperBounds;
+
+  void Clear();
+
+  /// \brief Returns the metric with the given name or nullptr, if it doesn't exist.
+  const Metric* FindMetric(ezStringView sName) const;
+
+  ezArrayPtr<const ezUInt64> GetBucketCounts(const Metric& metric) const;
+  ezArrayPtr<const double> GetBucketUpperBounds(const Metric& metric) const;
+
+  /// \brief Returns the average of all samples of a histogram.
+  double GetMean(const Metric& metric) const;
+
+  /// \brief Estimates the given percentile (0 to 100) of a histogram.
+  ///
+  /// The result is interpolated linearly within the bucket that contains the percentile. If that is the overflow bucket,
+  /// the upper bound of the last regular bucket is returned, as there is no better estimate.
+  double GetPercentile(const Metric& metric, double fPercentile) const;
+
+  /// \brief Writes the snapshot in a compact binary format, e.g. for sending it through ezTelemetry.
+  void Serialize(ezStreamWriter& inout_stream) const;
+
+  /// \brief Reads a snapshot that was written with Serialize().
+  ezResult Deserialize(ezStreamReader& inout_stream);
+
+  /// \brief Writes the snapshot as one JSON object. Histograms additionally contain the mean and the 50th, 90th and 99th percentile.
+  void WriteJSON(ezJSONWriter& inout_writer) const;
+};
+
+/// \brief A registry of typed, numeric metrics: counters, gauges and histograms.
+///
+/// In contrast to ezStats, metrics are registered once up front and are then updated through small handles, which doesn't involve any
+/// string formatting, locking or events. Counters and histograms are accumulated in memory that belongs to the updating thread,
+/// the totals are only computed when a snapshot is taken. This makes them cheap enough to be used in hot code paths,
+/// e.g. to track frame time percentiles, resource load latencies or task queue depths in shipped applications.
+///
+/// Snapshots can be sent through ezTelemetry (the InspectorPlugin does that every frame) or be written to a file with ezMetricsFileWriter.
+class EZ_FOUNDATION_DLL ezMetrics
+{
+public:
+  /// \brief The maximum number of values that counters and histograms can use per thread.
+  ///
+  /// Each counter uses one value, each histogram one value per bucket plus one for the sum of all samples.
+  static constexpr ezUInt32 MAX_SLOTS = 1024;
+
+  /// \brief Registers a counter with the given name. Registering the same name again returns the same counter.
+  ///
+  /// Metric names may contain slashes to define groups, similar to ezStats.
+  static ezMetricCounter RegisterCounter(ezStringView sName);
+
+  /// \brief Registers a gauge with the given name. Registering the same name again returns the same gauge.
+  static ezMetricGauge RegisterGauge(ezStringView sName);
+
+  /// \brief Registers a histogram with the given bucket upper bounds, which must be sorted in ascending order.
+  ///
+  /// An overflow bucket for all values above the last upper bound is added automatically.
+  /// Registering the same name again returns the same histogram, the bucket bounds of the first registration are kept.
+  static ezMetricHistogram RegisterHistogram(ezStringView sName, ezArrayPtr<const double> bucketUpperBounds);
+
+  /// \brief Fills out the snapshot with the current state of all registered metrics.
+  static void TakeSnapshot(ezMetricsSnapshot& out_snapshot);
+
+  /// \brief Resets all counters, gauges and histograms to zero. The metrics stay registered.
+  static void ResetValues();
+
+private:
+  friend class ezMetricCounter;
+  friend class ezMetricHistogram;
+
+  static std::atomic<ezUInt64>* GetThreadSlots();
+  static std::atomic<ezUInt64>* AllocateThreadSlots();
+};
+
+/// \brief Writes metrics snapshots to a file, one JSON object per line (the 'JSON Lines' format).
+///
+/// The file can be appended to as long as the application runs and can still be parsed line by line if the application
+/// terminates unexpectedly.
+class EZ_FOUNDATION_DLL ezMetricsFileWriter
+{
+public:
+  ezResult Open(ezStringView sFilePath);
+  void Close();
+  bool IsOpen() const { return m_bIsOpen; }
+
+  /// \brief Appends the snapshot as a single line to the file.
+  ezResult WriteSnapshot(const ezMetricsSnapshot& snapshot);
+
+  /// \brief Takes a snapshot and writes it, if at least the given interval has passed since the last call that wrote a snapshot.
+  ///
+  /// Meant to be called once per frame.
+  void Update(ezTime interval);
+
+private:
+  bool m_bIsOpen = false;
+  ezTime m_LastWrite;
+  ezFileWriter m_File;
+  ezMetricsSnapshot m_Snapshot;
+};
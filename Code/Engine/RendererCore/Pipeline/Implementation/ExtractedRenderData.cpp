@@ -1,5 +1,6 @@
 #include <RendererCore/RendererCorePCH.h>
 
+#include <Foundation/Algorithm/ParallelSorting.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
@@ -44,7 +45,18 @@ void ezExtractedRenderData::SortAndBatch()
     auto& data = dataPerCategory.m_SortableRenderData;
 
     // Sort
-    data.Sort(RenderDataComparer());
+    if (data.GetCount() < ezParallelSorting::PARALLEL_THRESHOLD)
+    {
+      data.Sort(RenderDataComparer());
+    }
+    else
+    {
+      // Large categories are sorted with two stable radix passes, first by the secondary key and then by the primary key,
+      // which results in the same order as the comparer.
+      ezArrayPtr<ezRenderDataBatch::SortableRenderData> dataPtr = data.GetArrayPtr();
+      ezParallelSorting::RadixSort(dataPtr, [](const ezRenderDataBatch::SortableRenderData& d) { return d.m_pRenderData->m_uiBatchId; });
+      ezParallelSorting::RadixSort(dataPtr, [](const ezRenderDataBatch::SortableRenderData& d) { return d.m_uiSortingKey; });
+    }
 
     // Find batches
     ezUInt32 uiCurrentBatchId = data[0].m_pRenderData->m_uiBatchId;
@@ -95,7 +95,7 @@ ezResourceLoadData ezTextureResourceLoader::OpenDataStream(const ezResource* pRe
   }
   else
   {
-    ezFileReader File;
+    ezFileReader& File = pData->m_File;
     if (File.Open(pResource->GetResourceID()).Failed())
       return res;
 
@@ -118,8 +118,19 @@ ezResourceLoadData ezTextureResourceLoader::OpenDataStream(const ezResource* pRe
 
     if (sAbsolutePath.HasExtension("ezTexture2D") || sAbsolutePath.HasExtension("ezTexture3D") || sAbsolutePath.HasExtension("ezTextureCube") || sAbsolutePath.HasExtension("ezRenderTarget") || sAbsolutePath.HasExtension("ezLUT"))
     {
-      if (LoadTexFile(File, *pData).Failed())
-        return res;
+      if (!File.GetMappedData().IsEmpty())
+      {
+        // upload the pixel data directly from the mapped file, the file is closed when the loader data is deleted
+        if (LoadTexFile(File.GetMappedData(), *pData).Failed())
+          return res;
+      }
+      else
+      {
+        if (LoadTexFile(File, *pData).Failed())
+          return res;
+
+        File.Close();
+      }
     }
     else
     {
@@ -208,6 +219,39 @@ ezResult ezTextureResourceLoader::LoadTexFile(ezStreamReader& inout_stream, Load
   }
 }
 
+ezResult ezTextureResourceLoader::LoadTexFile(ezArrayPtr<const ezUInt8> fileData, LoadedData& ref_data)
+{
+  ezRawMemoryStreamReader stream(fileData.GetPtr(), fileData.GetCount());
+
+  // read the hash, ignore it
+  ezAssetFileHeader AssetHash;
+  EZ_SUCCEED_OR_RETURN(AssetHash.Read(stream));
+
+  ref_data.m_TexFormat.ReadHeader(stream);
+
+  if (ref_data.m_TexFormat.m_iRenderTargetResolutionX != 0)
+    return EZ_SUCCESS;
+
+  ezDdsFileFormat fmt;
+  ezImageHeader header;
+  EZ_SUCCEED_OR_RETURN(fmt.ReadImageHeader(stream, header, "dds"));
+
+  const ezUInt64 uiDataOffset = stream.GetReadPosition();
+  const ezUInt64 uiDataSize = header.ComputeDataSize();
+
+  if (fileData.GetCount() - uiDataOffset < uiDataSize)
+  {
+    ezLog::Error("Failed to read image data.");
+    return EZ_FAILURE;
+  }
+
+  // the texture resources only read from the image, so it can reference the (read-only) file data without copying it
+  ezUInt8* pPixelData = const_cast<ezUInt8*>(fileData.GetPtr() + uiDataOffset);
+  ref_data.m_Image.ResetAndUseExternalStorage(header, ezByteBlobPtr(pPixelData, uiDataSize));
+
+  return EZ_SUCCESS;
+}
+
 void ezTextureResourceLoader::WriteTextureLoadStream(ezStreamWriter& w, const LoadedData& data)
 {
   const ezImage* pImage = &data.m_Image;
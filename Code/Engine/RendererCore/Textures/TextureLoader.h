@@ -2,6 +2,7 @@
 
 #include <Core/ResourceManager/Resource.h>
 #include <Core/ResourceManager/ResourceTypeLoader.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <RendererCore/RenderContext/Implementation/RenderContextStructs.h>
 #include <RendererCore/RendererCoreDLL.h>
 #include <RendererFoundation/RendererFoundationDLL.h>
@@ -22,6 +23,9 @@ public:
     ezMemoryStreamReader m_Reader;
     ezImage m_Image;
 
+    /// Stays open while m_Image references the file content directly, see LoadTexFile(ezArrayPtr<const ezUInt8>, LoadedData&).
+    ezFileReader m_File;
+
     bool m_bIsFallback = false;
     ezTexFormat m_TexFormat;
   };
@@ -31,5 +35,11 @@ public:
   virtual bool IsResourceOutdated(const ezResource* pResource) const override;
 
   static ezResult LoadTexFile(ezStreamReader& inout_stream, LoadedData& ref_data);
+
+  /// \brief Parses a texture file that is entirely accessible in memory, e.g. in a memory mapped archive.
+  ///
+  /// Instead of copying the pixel data, the image references it in \a fileData, so that memory has to stay valid as long as the image is used.
+  /// The image must only be read from.
+  static ezResult LoadTexFile(ezArrayPtr<const ezUInt8> fileData, LoadedData& ref_data);
   static void WriteTextureLoadStream(ezStreamWriter& inout_stream, const LoadedData& data);
 };
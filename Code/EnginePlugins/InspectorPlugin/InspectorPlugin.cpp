@@ -9,6 +9,9 @@ void RemoveLogWriter();
 void AddStatsEventHandler();
 void RemoveStatsEventHandler();
 
+void AddMetricsEventHandler();
+void RemoveMetricsEventHandler();
+
 void AddStartupEventHandler();
 void RemoveStartupEventHandler();
 
@@ -62,6 +65,7 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(InspectorPlugin, InspectorPluginMain)
     AddTelemetryAssertHandler();
     AddLogWriter();
     AddStatsEventHandler();
+    AddMetricsEventHandler();
     AddStartupEventHandler();
     AddCVarEventHandler();
     AddConsoleEventHandler();
@@ -92,6 +96,7 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(InspectorPlugin, InspectorPluginMain)
     RemoveCVarEventHandler();
     RemoveConsoleEventHandler();
     RemoveStartupEventHandler();
+    RemoveMetricsEventHandler();
     RemoveStatsEventHandler();
     RemoveLogWriter();
     RemoveTelemetryAssertHandler();
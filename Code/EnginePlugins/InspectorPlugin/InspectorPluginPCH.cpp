@@ -12,6 +12,7 @@ EZ_STATICLINK_LIBRARY(InspectorPlugin)
   EZ_STATICLINK_REFERENCE(InspectorPlugin_Log);
   EZ_STATICLINK_REFERENCE(InspectorPlugin_Main);
   EZ_STATICLINK_REFERENCE(InspectorPlugin_Memory);
+  EZ_STATICLINK_REFERENCE(InspectorPlugin_Metrics);
   EZ_STATICLINK_REFERENCE(InspectorPlugin_OSFile);
   EZ_STATICLINK_REFERENCE(InspectorPlugin_Plugins);
   EZ_STATICLINK_REFERENCE(InspectorPlugin_Startup);
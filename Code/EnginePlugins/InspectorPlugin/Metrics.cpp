@@ -0,0 +1,55 @@
+#include <InspectorPlugin/InspectorPluginPCH.h>
+
+#include <Core/GameApplication/GameApplicationBase.h>
+#include <Foundation/Communication/Telemetry.h>
+#include <Foundation/Utilities/Metrics.h>
+
+static ezMetricsSnapshot s_MetricsSnapshot;
+
+static void SendMetricsTelemetry()
+{
+  if (!ezTelemetry::IsConnectedToClient())
+    return;
+
+  ezMetrics::TakeSnapshot(s_MetricsSnapshot);
+
+  ezTelemetryMessage msg;
+  msg.SetMessageID('METR', ' SNP');
+  s_MetricsSnapshot.Serialize(msg.GetWriter());
+
+  // every message contains the full state, so losing one is not a problem
+  ezTelemetry::Broadcast(ezTelemetry::Unreliable, msg);
+}
+
+static void MetricsPerFrameUpdateHandler(const ezGameApplicationExecutionEvent& e)
+{
+  switch (e.m_Type)
+  {
+    case ezGameApplicationExecutionEvent::Type::AfterPresent:
+      SendMetricsTelemetry();
+      break;
+
+    default:
+      break;
+  }
+}
+
+void AddMetricsEventHandler()
+{
+  if (ezGameApplicationBase::GetGameApplicationBaseInstance() != nullptr)
+  {
+    ezGameApplicationBase::GetGameApplicationBaseInstance()->m_ExecutionEvents.AddEventHandler(MetricsPerFrameUpdateHandler);
+  }
+}
+
+void RemoveMetricsEventHandler()
+{
+  if (ezGameApplicationBase::GetGameApplicationBaseInstance() != nullptr)
+  {
+    ezGameApplicationBase::GetGameApplicationBaseInstance()->m_ExecutionEvents.RemoveEventHandler(MetricsPerFrameUpdateHandler);
+  }
+
+  s_MetricsSnapshot.Clear();
+}
+
+EZ_STATICLINK_FILE(InspectorPlugin, InspectorPlugin_Metrics);
@@ -525,3 +525,113 @@ EZ_CREATE_SIMPLE_TEST(World, Components)
     EZ_TEST_INT(TestComponent::s_iSimulationStartedCounter, 1);
   }
 }
+
+namespace
+{
+  class ScheduledComponent;
+  class ScheduledComponentManager : public ezComponentManager<ScheduledComponent, ezBlockStorageType::FreeList>
+  {
+  public:
+    enum Function
+    {
+      WriteA,
+      WriteB,
+      ReadAWriteB,
+      Exclusive,
+      Count
+    };
+
+    ScheduledComponentManager(ezWorld* pWorld)
+      : ezComponentManager<ScheduledComponent, ezBlockStorageType::FreeList>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      // WriteA and WriteB are independent, ReadAWriteB has to wait for both and Exclusive does not declare anything
+      auto descWriteA = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduledComponentManager::UpdateWriteA, this);
+      descWriteA.m_WritesComponentTypes.PushBack(ezGetStaticRTTI<ScheduledComponent>());
+      descWriteA.m_fPriority = 3.0f;
+
+      auto descWriteB = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduledComponentManager::UpdateWriteB, this);
+      descWriteB.m_WritesComponentTypes.PushBack(ezGetStaticRTTI<TestComponent2>());
+      descWriteB.m_fPriority = 3.0f;
+
+      auto descReadAWriteB = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduledComponentManager::UpdateReadAWriteB, this);
+      descReadAWriteB.m_ReadsComponentTypes.PushBack(ezGetStaticRTTI<ScheduledComponent>());
+      descReadAWriteB.m_WritesComponentTypes.PushBack(ezGetStaticRTTI<TestComponent2>());
+      descReadAWriteB.m_fPriority = 2.0f;
+
+      auto descExclusive = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduledComponentManager::UpdateExclusive, this);
+      descExclusive.m_fPriority = 1.0f;
+
+      for (UpdateFunctionDesc* pDesc : {&descWriteA, &descWriteB, &descReadAWriteB, &descExclusive})
+      {
+        pDesc->m_Phase = UpdateFunctionDesc::Phase::PostAsync;
+        RegisterUpdateFunction(*pDesc);
+      }
+    }
+
+    ezTime GetCriticalPath(ezDynamicArray<ezHashedString>& out_functionNames) const
+    {
+      return GetWorld()->GetCriticalUpdatePath(UpdateFunctionDesc::Phase::PostAsync, out_functionNames);
+    }
+
+    void UpdateWriteA(const ezWorldModule::UpdateContext& context) { Record(WriteA); }
+    void UpdateWriteB(const ezWorldModule::UpdateContext& context) { Record(WriteB); }
+    void UpdateReadAWriteB(const ezWorldModule::UpdateContext& context) { Record(ReadAWriteB); }
+    void UpdateExclusive(const ezWorldModule::UpdateContext& context) { Record(Exclusive); }
+
+    void Record(Function function)
+    {
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(10));
+      m_iOrder[function] = m_iCounter.Increment();
+    }
+
+    ezAtomicInteger32 m_iCounter;
+    ezInt32 m_iOrder[Count] = {};
+  };
+
+  class ScheduledComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ScheduledComponent, ezComponent, ScheduledComponentManager);
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(ScheduledComponent, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, UpdateFunctionScheduling)
+{
+  ezWorldDesc worldDesc("Test");
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  ScheduledComponentManager* pManager = world.GetOrCreateComponentManager<ScheduledComponentManager>();
+
+  world.Update();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Execution Order")
+  {
+    EZ_TEST_INT(pManager->m_iCounter, ScheduledComponentManager::Count);
+    EZ_TEST_BOOL(pManager->m_iOrder[ScheduledComponentManager::ReadAWriteB] > pManager->m_iOrder[ScheduledComponentManager::WriteA]);
+    EZ_TEST_BOOL(pManager->m_iOrder[ScheduledComponentManager::ReadAWriteB] > pManager->m_iOrder[ScheduledComponentManager::WriteB]);
+    EZ_TEST_INT(pManager->m_iOrder[ScheduledComponentManager::Exclusive], ScheduledComponentManager::Count);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Critical Path")
+  {
+    ezDynamicArray<ezHashedString> functionNames;
+    const ezTime duration = pManager->GetCriticalPath(functionNames);
+
+    // only one of the independent functions is on the critical path
+    if (EZ_TEST_INT(functionNames.GetCount(), 3))
+    {
+      EZ_TEST_BOOL(functionNames[0] == ezMakeHashedString("ScheduledComponentManager::UpdateWriteA") || functionNames[0] == ezMakeHashedString("ScheduledComponentManager::UpdateWriteB"));
+      EZ_TEST_STRING(functionNames[1], "ScheduledComponentManager::UpdateReadAWriteB");
+      EZ_TEST_STRING(functionNames[2], "ScheduledComponentManager::UpdateExclusive");
+    }
+
+    EZ_TEST_BOOL(duration >= ezTime::MakeFromMilliseconds(25));
+  }
+}
@@ -198,6 +198,59 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
     ezFrameAllocator::Reset();
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queuing from multiple threads")
+  {
+    ResetComponents(*pRoot);
+
+    ezDynamicArray<ezComponentHandle> receivers;
+    for (auto it = pManager->GetComponents(); it.IsValid(); ++it)
+    {
+      receivers.PushBack(it->GetHandle());
+    }
+
+    constexpr ezUInt32 uiNumMessages = 1000;
+
+    ezParallelForParams parallelForParams;
+    parallelForParams.m_uiBinSize = 10;
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, uiNumMessages, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          TestMessage1 msg;
+          msg.m_iValue = 1;
+          world.PostMessage(receivers[i % receivers.GetCount()], msg, ezTime::MakeZero(), ezObjectMsgQueueType::NextFrame);
+
+          TestMessage2 msg2;
+          msg2.m_iValue = i;
+          world.PostMessage(receivers[i % receivers.GetCount()], msg2, ezTime::MakeZero(), ezObjectMsgQueueType::NextFrame);
+        }
+      },
+      "PostMessages", parallelForParams);
+
+    world.Update();
+
+    // every message arrives exactly once, no matter which thread posted it
+    for (ezUInt32 uiReceiver = 0; uiReceiver < receivers.GetCount(); ++uiReceiver)
+    {
+      ezInt32 iExpectedCount = 0;
+      ezInt32 iExpectedSum = 0;
+      for (ezUInt32 i = uiReceiver; i < uiNumMessages; i += receivers.GetCount())
+      {
+        ++iExpectedCount;
+        iExpectedSum += i;
+      }
+
+      TestComponentMsg* pComponent2 = nullptr;
+      EZ_TEST_BOOL(world.TryGetComponent(receivers[uiReceiver], pComponent2));
+      EZ_TEST_INT(pComponent2->m_iSomeData, 1 + iExpectedCount);
+      EZ_TEST_INT(pComponent2->m_iSomeData2, 2 + 2 * iExpectedSum);
+    }
+
+    ezFrameAllocator::Reset();
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queuing with delay")
   {
     ResetComponents(*pRoot);
@@ -1,6 +1,8 @@
 #include <CoreTest/CoreTestPCH.h>
 
 #include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/SpatialSystem_BVH.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
@@ -8,6 +10,8 @@
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Profiling/ProfilingUtils.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Types/TagRegistry.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
 namespace
@@ -58,10 +62,11 @@ namespace
   // clang-format on
 } // namespace
 
-EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+static void TestSpatialSystem(ezSpatialSystemType::Enum spatialSystemType)
 {
   ezWorldDesc worldDesc("Test");
   worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  worldDesc.m_SpatialSystemType = spatialSystemType;
 
   ezWorld world(worldDesc);
   EZ_LOCK(world.GetWriteMarker());
@@ -317,3 +322,242 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     world.Update();
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+{
+  TestSpatialSystem(ezSpatialSystemType::RegularGrid);
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystemBVH)
+{
+  TestSpatialSystem(ezSpatialSystemType::BVH);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compare with RegularGrid")
+  {
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_bAutoCreateSpatialSystem = false;
+
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezSpatialSystem_RegularGrid grid;
+    ezSpatialSystem_BVH bvh;
+    ezSpatialSystem* spatialSystems[] = {&grid, &bvh};
+
+    const ezTag& testTag = ezTagRegistry::GetGlobalRegistry().RegisterTag("SpatialSystemBVHTestTag");
+
+    struct TestData
+    {
+      ezGameObject* m_pObject = nullptr;
+      ezSpatialDataHandle m_hData[2];
+      ezBoundingBox m_Box;
+    };
+
+    ezDynamicArray<TestData> testData;
+
+    // mostly tiny objects mixed with a few very large ones
+    auto createBounds = [&]()
+    {
+      const double fSizeClass = rng.DoubleZeroToOneInclusive();
+      const double fMaxSize = fSizeClass < 0.9 ? 2.0 : (fSizeClass < 0.99 ? 100.0 : 3000.0);
+
+      ezVec3 vCenter;
+      vCenter.x = (float)rng.DoubleMinMax(-5000.0, 5000.0);
+      vCenter.y = (float)rng.DoubleMinMax(-5000.0, 5000.0);
+      vCenter.z = (float)rng.DoubleMinMax(-500.0, 500.0);
+
+      ezVec3 vHalfExtents;
+      vHalfExtents.x = (float)rng.DoubleMinMax(0.1, fMaxSize);
+      vHalfExtents.y = (float)rng.DoubleMinMax(0.1, fMaxSize);
+      vHalfExtents.z = (float)rng.DoubleMinMax(0.1, fMaxSize);
+
+      return ezSimdConversion::ToBBoxSphere(ezBoundingBoxSphere::MakeFromBox(ezBoundingBox::MakeFromCenterAndHalfExtents(vCenter, vHalfExtents)));
+    };
+
+    auto addData = [&](ezUInt32 uiCount)
+    {
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        TestData& data = testData.ExpandAndGetRef();
+
+        ezGameObjectDesc desc;
+        world.CreateObject(desc, data.m_pObject);
+
+        const ezSimdBBoxSphere bounds = createBounds();
+        data.m_Box = ezSimdConversion::ToBBox(bounds.GetBox());
+
+        ezUInt32 uiCategoryBitmask = (i % 3 == 0) ? ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() : ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+        if (i % 7 == 0)
+        {
+          uiCategoryBitmask |= s_SpecialTestCategory.GetBitmask();
+        }
+
+        ezTagSet tags;
+        if (i % 2 == 0)
+        {
+          tags.Set(testTag);
+        }
+
+        for (ezUInt32 s = 0; s < 2; ++s)
+        {
+          if (i % 100 == 50)
+          {
+            data.m_hData[s] = spatialSystems[s]->CreateSpatialDataAlwaysVisible(data.m_pObject, uiCategoryBitmask, tags);
+          }
+          else
+          {
+            data.m_hData[s] = spatialSystems[s]->CreateSpatialData(bounds, data.m_pObject, uiCategoryBitmask, tags);
+          }
+        }
+      }
+    };
+
+    auto compareQueries = [&]()
+    {
+      ezSpatialSystem::QueryParams queryParams;
+
+      for (ezUInt32 uiQuery = 0; uiQuery < 50; ++uiQuery)
+      {
+        queryParams.m_uiCategoryBitmask = (uiQuery % 2 == 0) ? ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() : (ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask() | s_SpecialTestCategory.GetBitmask());
+        queryParams.m_IncludeTags.Clear();
+        queryParams.m_ExcludeTags.Clear();
+        if (uiQuery % 5 == 1)
+        {
+          queryParams.m_IncludeTags.Set(testTag);
+        }
+        else if (uiQuery % 5 == 2)
+        {
+          queryParams.m_ExcludeTags.Set(testTag);
+        }
+
+        const ezVec3 vCenter((float)rng.DoubleMinMax(-5000.0, 5000.0), (float)rng.DoubleMinMax(-5000.0, 5000.0), (float)rng.DoubleMinMax(-500.0, 500.0));
+        const float fSize = (float)rng.DoubleMinMax(10.0, 3000.0);
+
+        // The BVH culls by bounding box while the grid only tests the bounding sphere, so it might return fewer objects.
+        // Every object that is only found by the grid has to be outside of the query shape though.
+        auto compareResults = [&](auto& ref_objects, auto overlaps)
+        {
+          ezHashSet<const ezGameObject*> objectSets[2];
+          for (ezUInt32 s = 0; s < 2; ++s)
+          {
+            for (auto pObject : ref_objects[s])
+            {
+              objectSets[s].Insert(pObject);
+            }
+          }
+
+          for (auto pObject : ref_objects[1])
+          {
+            EZ_TEST_BOOL(objectSets[0].Contains(pObject));
+          }
+
+          for (const TestData& data : testData)
+          {
+            if (objectSets[0].Contains(data.m_pObject) && !objectSets[1].Contains(data.m_pObject))
+            {
+              // shrink the box a bit to not depend on floating point precision at the border
+              const ezSimdBBox box = ezSimdConversion::ToBBox(data.m_Box);
+              EZ_TEST_BOOL(!overlaps(ezSimdBBox::MakeFromCenterAndHalfExtents(box.GetCenter(), box.GetHalfExtents() * 0.9f)));
+            }
+          }
+        };
+
+        ezDynamicArray<ezGameObject*> objects[2];
+
+        const ezBoundingSphere testSphere = ezBoundingSphere::MakeFromCenterAndRadius(vCenter, fSize);
+        for (ezUInt32 s = 0; s < 2; ++s)
+        {
+          spatialSystems[s]->FindObjectsInSphere(testSphere, queryParams, objects[s]);
+        }
+        compareResults(objects, [&](const ezSimdBBox& box)
+          { return box.Overlaps(ezSimdConversion::ToBSphere(testSphere)); });
+
+        const ezBoundingBox testBox = ezBoundingBox::MakeFromCenterAndHalfExtents(vCenter, ezVec3(fSize, fSize * 0.5f, fSize * 0.1f));
+        for (ezUInt32 s = 0; s < 2; ++s)
+        {
+          spatialSystems[s]->FindObjectsInBox(testBox, queryParams, objects[s]);
+        }
+        compareResults(objects, [&](const ezSimdBBox& box)
+          { return box.Overlaps(ezSimdConversion::ToBBox(testBox)); });
+
+        const ezVec3 vDir = ezVec3((float)rng.DoubleMinMax(-1.0, 1.0), (float)rng.DoubleMinMax(-1.0, 1.0), 0.1f).GetNormalized();
+        ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(vCenter, vCenter + vDir, ezVec3::MakeAxisZ());
+        ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::MakeFromDegree(70.0f), 1.5f, 1.0f, fSize);
+        const ezFrustum testFrustum = ezFrustum::MakeFromMVP(projection * lookAt);
+
+        ezDynamicArray<const ezGameObject*> visibleObjects[2];
+        for (ezUInt32 s = 0; s < 2; ++s)
+        {
+          spatialSystems[s]->FindVisibleObjects(testFrustum, queryParams, visibleObjects[s], {}, ezVisibilityState::Direct);
+        }
+        compareResults(visibleObjects, [&](const ezSimdBBox& box)
+          { return testFrustum.Overlaps(box); });
+      }
+    };
+
+    addData(5000);
+    compareQueries();
+
+    // incremental changes without rebuild
+    for (ezUInt32 s = 0; s < 2; ++s)
+    {
+      spatialSystems[s]->StartNewFrame();
+    }
+    const ezUInt32 uiNumRebuilds = bvh.GetNumRebuilds();
+
+    for (ezUInt32 i = 0; i < testData.GetCount(); i += 2)
+    {
+      const ezSimdBBoxSphere bounds = createBounds();
+      testData[i].m_Box = ezSimdConversion::ToBBox(bounds.GetBox());
+
+      for (ezUInt32 s = 0; s < 2; ++s)
+      {
+        spatialSystems[s]->UpdateSpatialDataBounds(testData[i].m_hData[s], bounds);
+      }
+    }
+
+    for (ezUInt32 i = testData.GetCount(); i-- > 0;)
+    {
+      if (i % 50 == 1)
+      {
+        for (ezUInt32 s = 0; s < 2; ++s)
+        {
+          spatialSystems[s]->DeleteSpatialData(testData[i].m_hData[s]);
+        }
+        testData.RemoveAtAndSwap(i);
+      }
+    }
+
+    addData(50);
+    compareQueries();
+
+    EZ_TEST_INT(bvh.GetNumRebuilds(), uiNumRebuilds);
+
+    // half of the objects moved far away, which degrades the tree enough for a rebuild
+    for (ezUInt32 s = 0; s < 2; ++s)
+    {
+      spatialSystems[s]->StartNewFrame();
+    }
+
+    EZ_TEST_INT(bvh.GetNumRebuilds(), uiNumRebuilds + 1);
+
+    compareQueries();
+
+    for (auto& data : testData)
+    {
+      for (ezUInt32 s = 0; s < 2; ++s)
+      {
+        spatialSystems[s]->DeleteSpatialData(data.m_hData[s]);
+      }
+    }
+
+    ezDynamicArray<ezGameObject*> objects;
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = 0xFFFFFFFF;
+    spatialSystems[1]->FindObjectsInSphere(ezBoundingSphere::MakeFromCenterAndRadius(ezVec3::MakeZero(), 100000.0f), queryParams, objects);
+    EZ_TEST_BOOL(objects.IsEmpty());
+  }
+}
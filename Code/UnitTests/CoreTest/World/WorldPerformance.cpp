@@ -1,8 +1,12 @@
 #include <CoreTest/CoreTestPCH.h>
 
+#include <Core/World/SpatialSystem_BVH.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Utilities/GraphicsUtils.h>
 
 namespace
 {
@@ -114,6 +118,135 @@ namespace
     }
   }
 
+  void MeasureTransformUpdateModes(ezUInt32 uiNumObjects, ezUInt32 uiTreeLevelNumNodeDiv, ezUInt32 uiTreeDepth, ezInt32 iAttachCompsDepth)
+  {
+    const ezTransformUpdateMode::Enum modes[] = {ezTransformUpdateMode::HierarchyLevels, ezTransformUpdateMode::Subtrees, ezTransformUpdateMode::ChangedSubtrees};
+    const char* szModeNames[] = {"hierarchy levels", "subtrees", "changed subtrees"};
+
+    for (ezUInt32 uiMode = 0; uiMode < EZ_ARRAY_SIZE(modes); ++uiMode)
+    {
+      ezWorldDesc worldDesc("Test");
+      worldDesc.m_bAutoCreateSpatialSystem = false; // allows multi-threaded update
+      worldDesc.m_TransformUpdateMode = modes[uiMode];
+      ezWorld world(worldDesc);
+      MeasureCreationTime(true, uiNumObjects, uiTreeLevelNumNodeDiv, uiTreeDepth, iAttachCompsDepth, &world);
+
+      ezStopwatch sw;
+
+      // first round always has some overhead
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        EZ_LOCK(world.GetWriteMarker());
+        world.Update();
+
+        const ezTime tDiff = sw.Checkpoint();
+
+        ezTestFramework::Output(ezTestOutput::Duration, "Updating %u objects (MT, %s): %.2fms", world.GetObjectCount(), szModeNames[uiMode], tDiff.GetMilliseconds());
+      }
+    }
+  }
+
+  void MeasureSpatialSystem(ezSpatialSystem& ref_spatialSystem, const char* szName, ezArrayPtr<ezGameObject*> objects)
+  {
+    ezRandom rng;
+    rng.Initialize(42);
+
+    // mostly small objects mixed with a few very large ones, like debris next to terrain
+    auto createBounds = [&]()
+    {
+      const double fSizeClass = rng.DoubleZeroToOneInclusive();
+      const double fMaxSize = fSizeClass < 0.9 ? 2.0 : (fSizeClass < 0.99 ? 50.0 : 2000.0);
+
+      const ezVec3 vCenter((float)rng.DoubleMinMax(-4000.0, 4000.0), (float)rng.DoubleMinMax(-4000.0, 4000.0), (float)rng.DoubleMinMax(-100.0, 100.0));
+      const ezVec3 vHalfExtents((float)rng.DoubleMinMax(0.1, fMaxSize), (float)rng.DoubleMinMax(0.1, fMaxSize), (float)rng.DoubleMinMax(0.1, fMaxSize));
+
+      return ezSimdConversion::ToBBoxSphere(ezBoundingBoxSphere::MakeFromBox(ezBoundingBox::MakeFromCenterAndHalfExtents(vCenter, vHalfExtents)));
+    };
+
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezDynamicArray<ezSpatialDataHandle> spatialData;
+    spatialData.Reserve(objects.GetCount());
+
+    ezStopwatch sw;
+
+    for (ezGameObject* pObject : objects)
+    {
+      spatialData.PushBack(ref_spatialSystem.CreateSpatialData(createBounds(), pObject, uiCategoryBitmask, ezTagSet()));
+    }
+
+    ref_spatialSystem.StartNewFrame();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: Creating %u spatial data: %.2fms", szName, objects.GetCount(), sw.Checkpoint().GetMilliseconds());
+
+    ezSpatialSystem::QueryParams queryParams;
+    queryParams.m_uiCategoryBitmask = uiCategoryBitmask;
+
+    const ezMat4 projection = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovX(ezAngle::MakeFromDegree(80.0f), 1.5f, 1.0f, 2000.0f);
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezUInt32 uiNumVisibleObjects = 0;
+
+    for (ezUInt32 uiFrame = 0; uiFrame < 2; ++uiFrame)
+    {
+      // move every tenth object a bit, which has to be handled before the next query
+      for (ezUInt32 i = uiFrame; i < spatialData.GetCount(); i += 10)
+      {
+        ref_spatialSystem.UpdateSpatialDataBounds(spatialData[i], createBounds());
+      }
+
+      ref_spatialSystem.StartNewFrame();
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: Moving %u spatial data: %.2fms", szName, spatialData.GetCount() / 10, sw.Checkpoint().GetMilliseconds());
+
+      for (ezUInt32 uiQuery = 0; uiQuery < 100; ++uiQuery)
+      {
+        const ezAngle rotation = ezAngle::MakeFromDegree(uiQuery * 3.6f);
+        const ezVec3 vPos((float)rng.DoubleMinMax(-3000.0, 3000.0), (float)rng.DoubleMinMax(-3000.0, 3000.0), 2.0f);
+        const ezVec3 vDir(ezMath::Cos(rotation), ezMath::Sin(rotation), 0.0f);
+
+        const ezMat4 lookAt = ezGraphicsUtils::CreateLookAtViewMatrix(vPos, vPos + vDir, ezVec3::MakeAxisZ());
+
+        visibleObjects.Clear();
+        ref_spatialSystem.FindVisibleObjects(ezFrustum::MakeFromMVP(projection * lookAt), queryParams, visibleObjects, {}, ezVisibilityState::Direct);
+        uiNumVisibleObjects += visibleObjects.GetCount();
+      }
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: 100 frustum queries (%u objects visible): %.2fms", szName, uiNumVisibleObjects, sw.Checkpoint().GetMilliseconds());
+
+      ezUInt32 uiNumFoundObjects = 0;
+      for (ezUInt32 uiQuery = 0; uiQuery < 1000; ++uiQuery)
+      {
+        const ezVec3 vPos((float)rng.DoubleMinMax(-4000.0, 4000.0), (float)rng.DoubleMinMax(-4000.0, 4000.0), 0.0f);
+
+        ref_spatialSystem.FindObjectsInSphere(ezBoundingSphere::MakeFromCenterAndRadius(vPos, 20.0f), queryParams, [&](ezGameObject*)
+          {
+            ++uiNumFoundObjects;
+            return ezVisitorExecution::Continue; });
+      }
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: 1000 small sphere queries (%u objects found): %.2fms", szName, uiNumFoundObjects, sw.Checkpoint().GetMilliseconds());
+
+      uiNumFoundObjects = 0;
+      for (ezUInt32 uiQuery = 0; uiQuery < 100; ++uiQuery)
+      {
+        const ezVec3 vPos((float)rng.DoubleMinMax(-4000.0, 4000.0), (float)rng.DoubleMinMax(-4000.0, 4000.0), 0.0f);
+
+        ref_spatialSystem.FindObjectsInBox(ezBoundingBox::MakeFromCenterAndHalfExtents(vPos, ezVec3(300.0f, 300.0f, 50.0f)), queryParams, [&](ezGameObject*)
+          {
+            ++uiNumFoundObjects;
+            return ezVisitorExecution::Continue; });
+      }
+
+      ezTestFramework::Output(ezTestOutput::Duration, "%s: 100 large box queries (%u objects found): %.2fms", szName, uiNumFoundObjects, sw.Checkpoint().GetMilliseconds());
+    }
+
+    for (const ezSpatialDataHandle& hData : spatialData)
+    {
+      ref_spatialSystem.DeleteSpatialData(hData);
+    }
+  }
+
 } // namespace
 
 
@@ -267,6 +400,22 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 
+  EZ_TEST_BLOCK(EnableInRelease, "MT Update 250,000 dynamic objects, transform update modes")
+  {
+    // nothing moves after the first frames
+    MeasureTransformUpdateModes(200, 5, 6, 0);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "MT Update 250,000 dynamic objects with moving roots, transform update modes")
+  {
+    MeasureTransformUpdateModes(200, 5, 6, 1);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "MT Update 1,000,000 dynamic objects, transform update modes")
+  {
+    MeasureTransformUpdateModes(100, 1, 3, 1);
+  }
+
   EZ_TEST_BLOCK(EnableInRelease, "MT Update 1,000,000 dynamic objects")
   {
     ezWorldDesc worldDesc("Test");
@@ -288,3 +437,33 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystem)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "RegularGrid vs. BVH with 200,000 objects of mixed sizes")
+  {
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_bAutoCreateSpatialSystem = false;
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezDynamicArray<ezGameObject*> objects;
+    objects.SetCount(200000);
+
+    ezGameObjectDesc desc;
+    for (ezGameObject*& pObject : objects)
+    {
+      world.CreateObject(desc, pObject);
+    }
+
+    {
+      ezSpatialSystem_RegularGrid grid;
+      MeasureSpatialSystem(grid, "RegularGrid", objects);
+    }
+
+    {
+      ezSpatialSystem_BVH bvh;
+      MeasureSpatialSystem(bvh, "BVH", objects);
+    }
+  }
+}
@@ -198,6 +198,103 @@ namespace
   EZ_END_DYNAMIC_REFLECTED_TYPE;
   EZ_IMPLEMENT_WORLD_MODULE(VelocityTestModule);
   // clang-format on
+
+  void CreateTransformUpdateModeTestWorld(ezWorld& ref_world, ezDynamicArray<ezGameObjectHandle>& out_objects)
+  {
+    ezGameObjectDesc desc;
+    desc.m_LocalRotation = ezQuat::MakeFromAxisAndAngle(ezVec3(0.0f, 0.0f, 1.0f), ezAngle::MakeFromDegree(30.0f));
+    desc.m_LocalScaling = ezVec3(1.0f, 2.0f, 1.0f);
+
+    // dynamic subtrees below a static object
+    ezGameObject* pStatic = nullptr;
+    desc.m_bDynamic = false;
+    desc.m_LocalPosition = ezVec3(0.0f, 0.0f, 10.0f);
+    out_objects.PushBack(ref_world.CreateObject(desc, pStatic));
+
+    desc.m_bDynamic = true;
+    for (ezUInt32 uiRoot = 0; uiRoot < 40; ++uiRoot)
+    {
+      desc.m_hParent = uiRoot < 10 ? out_objects[0] : ezGameObjectHandle();
+      desc.m_LocalPosition = ezVec3(uiRoot * 3.0f, 1.0f, 0.0f);
+
+      ezGameObject* pRoot = nullptr;
+      const ezGameObjectHandle hRoot = ref_world.CreateObject(desc, pRoot);
+      out_objects.PushBack(hRoot);
+
+      for (ezUInt32 uiChild = 0; uiChild < 3; ++uiChild)
+      {
+        desc.m_hParent = hRoot;
+        desc.m_LocalPosition = ezVec3(1.0f, uiChild * 2.0f, 0.5f);
+
+        ezGameObject* pChild = nullptr;
+        const ezGameObjectHandle hChild = ref_world.CreateObject(desc, pChild);
+        out_objects.PushBack(hChild);
+
+        for (ezUInt32 uiGrandChild = 0; uiGrandChild < 2; ++uiGrandChild)
+        {
+          desc.m_hParent = hChild;
+          desc.m_LocalPosition = ezVec3(0.0f, 0.0f, uiGrandChild + 1.0f);
+
+          ezGameObject* pGrandChild = nullptr;
+          out_objects.PushBack(ref_world.CreateObject(desc, pGrandChild));
+        }
+      }
+    }
+  }
+
+  void ModifyTransformUpdateModeTestWorld(ezWorld& ref_world, ezDynamicArray<ezGameObjectHandle>& ref_objects, ezUInt32 uiFrame)
+  {
+    ezGameObject* pObject = nullptr;
+    ezGameObject* pOther = nullptr;
+
+    switch (uiFrame)
+    {
+      case 1:
+        // move a few objects in the middle of their subtrees
+        EZ_TEST_BOOL(ref_world.TryGetObject(ref_objects[3], pObject));
+        pObject->SetLocalPosition(ezVec3(5.0f, 6.0f, 7.0f));
+        EZ_TEST_BOOL(ref_world.TryGetObject(ref_objects[200], pObject));
+        pObject->SetLocalRotation(ezQuat::MakeFromAxisAndAngle(ezVec3(1.0f, 0.0f, 0.0f), ezAngle::MakeFromDegree(45.0f)));
+        EZ_TEST_BOOL(ref_world.TryGetObject(ref_objects[101], pObject));
+        pObject->SetGlobalPosition(ezVec3(-3.0f, 4.0f, 1.0f));
+        break;
+
+      case 2:
+        // re-parent into other subtrees and below the static object
+        EZ_TEST_BOOL(ref_world.TryGetObject(ref_objects[150], pObject));
+        EZ_TEST_BOOL(ref_world.TryGetObject(ref_objects[250], pOther));
+        pObject->SetParent(pOther->GetHandle());
+        EZ_TEST_BOOL(ref_world.TryGetObject(ref_objects[230], pObject));
+        pObject->SetParent(ref_objects[0], ezGameObject::TransformPreservation::PreserveGlobal);
+        break;
+
+      case 3:
+        // move the static parent and detach a dynamic subtree from it
+        EZ_TEST_BOOL(ref_world.TryGetObject(ref_objects[0], pObject));
+        pObject->SetLocalPosition(ezVec3(0.0f, 0.0f, 20.0f));
+        EZ_TEST_BOOL(ref_world.TryGetObject(ref_objects[1], pObject));
+        pObject->SetParent(ezGameObjectHandle());
+        break;
+
+      case 4:
+      {
+        // create new objects in existing subtrees and a dynamic object below the static one
+        ezGameObjectDesc desc;
+        desc.m_bDynamic = true;
+        desc.m_LocalPosition = ezVec3(1.0f, 2.0f, 3.0f);
+
+        desc.m_hParent = ref_objects[0];
+        ref_objects.PushBack(ref_world.CreateObject(desc, pObject));
+        desc.m_hParent = ref_objects[120];
+        ref_objects.PushBack(ref_world.CreateObject(desc, pObject));
+        break;
+      }
+
+      default:
+        // nothing changes in the remaining frames
+        break;
+    }
+  }
 } // namespace
 
 class ezGameObjectTest
@@ -216,6 +313,11 @@ public:
     EZ_TEST_BOOL(pObject->m_pTransformationData->m_pParentData == (pParent != nullptr ? pParent->m_pTransformationData : nullptr));
     EZ_TEST_BOOL(pObject->GetParent() == pParent);
   }
+
+  static void OverwriteGlobalTransform(ezGameObject* pObject, const ezTransform& transform)
+  {
+    pObject->m_pTransformationData->m_globalTransform = ezSimdConversion::ToTransform(transform);
+  }
 };
 
 EZ_CREATE_SIMPLE_TEST(World, World)
@@ -257,6 +359,120 @@ EZ_CREATE_SIMPLE_TEST(World, World)
     TestTransforms(o, offset);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transform update modes")
+  {
+    const ezTransformUpdateMode::Enum modes[] = {ezTransformUpdateMode::HierarchyLevels, ezTransformUpdateMode::Subtrees, ezTransformUpdateMode::ChangedSubtrees};
+
+    for (ezUInt32 uiSpatialSystem = 0; uiSpatialSystem < 2; ++uiSpatialSystem)
+    {
+      ezUniquePtr<ezWorld> worlds[EZ_ARRAY_SIZE(modes)];
+      ezDynamicArray<ezGameObjectHandle> objects[EZ_ARRAY_SIZE(modes)];
+
+      for (ezUInt32 uiMode = 0; uiMode < EZ_ARRAY_SIZE(modes); ++uiMode)
+      {
+        ezWorldDesc worldDesc("Test");
+        worldDesc.m_bReportErrorWhenStaticObjectMoves = false;
+        worldDesc.m_bAutoCreateSpatialSystem = uiSpatialSystem == 1;
+        worldDesc.m_TransformUpdateMode = uiMode == 1 ? modes[uiMode] : ezTransformUpdateMode::HierarchyLevels;
+
+        worlds[uiMode] = EZ_DEFAULT_NEW(ezWorld, worldDesc);
+
+        EZ_LOCK(worlds[uiMode]->GetWriteMarker());
+        worlds[uiMode]->GetClock().SetFixedTimeStep(ezTime::MakeFromMilliseconds(100));
+        CreateTransformUpdateModeTestWorld(*worlds[uiMode], objects[uiMode]);
+
+        // switching the mode after the objects were created has to find the existing subtrees
+        worlds[uiMode]->SetTransformUpdateMode(modes[uiMode]);
+        EZ_TEST_INT(worlds[uiMode]->GetTransformUpdateMode(), modes[uiMode]);
+      }
+
+      for (ezUInt32 uiFrame = 0; uiFrame < 8; ++uiFrame)
+      {
+        for (ezUInt32 uiMode = 0; uiMode < EZ_ARRAY_SIZE(modes); ++uiMode)
+        {
+          EZ_LOCK(worlds[uiMode]->GetWriteMarker());
+          ModifyTransformUpdateModeTestWorld(*worlds[uiMode], objects[uiMode], uiFrame);
+          worlds[uiMode]->Update();
+        }
+
+        // all modes have to produce the same results as updating by hierarchy levels
+        EZ_LOCK(worlds[0]->GetReadMarker());
+
+        for (ezUInt32 uiMode = 1; uiMode < EZ_ARRAY_SIZE(modes); ++uiMode)
+        {
+          EZ_LOCK(worlds[uiMode]->GetReadMarker());
+
+          for (ezUInt32 i = 0; i < objects[0].GetCount(); ++i)
+          {
+            const ezGameObject* pExpected = nullptr;
+            const ezGameObject* pObject = nullptr;
+            EZ_TEST_BOOL(worlds[0]->TryGetObject(objects[0][i], pExpected));
+            EZ_TEST_BOOL(worlds[uiMode]->TryGetObject(objects[uiMode][i], pObject));
+
+            EZ_TEST_BOOL(pObject->GetGlobalTransform().IsEqual(pExpected->GetGlobalTransform(), 0.0f));
+#if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
+            EZ_TEST_VEC3(pObject->GetLinearVelocity(), pExpected->GetLinearVelocity(), 0.0f);
+#endif
+          }
+        }
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Incremental transform update")
+  {
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_bAutoCreateSpatialSystem = false;
+    worldDesc.m_TransformUpdateMode = ezTransformUpdateMode::ChangedSubtrees;
+
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezGameObjectDesc desc;
+    desc.m_bDynamic = true;
+    desc.m_LocalPosition = ezVec3(1.0f, 0.0f, 0.0f);
+
+    ezGameObject* pRoot = nullptr;
+    ezGameObject* pA = nullptr;
+    ezGameObject* pA1 = nullptr;
+    ezGameObject* pB = nullptr;
+    ezGameObject* pB1 = nullptr;
+
+    desc.m_hParent = world.CreateObject(desc, pRoot);
+    world.CreateObject(desc, pB);
+    desc.m_hParent = world.CreateObject(desc, pA);
+    world.CreateObject(desc, pA1);
+    desc.m_hParent = pB->GetHandle();
+    world.CreateObject(desc, pB1);
+
+    // the first updates compute all transforms and the velocities
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      world.Update();
+    }
+
+    EZ_TEST_VEC3(pA1->GetGlobalPosition(), ezVec3(3.0f, 0.0f, 0.0f), 0.0f);
+    EZ_TEST_VEC3(pB1->GetGlobalPosition(), ezVec3(3.0f, 0.0f, 0.0f), 0.0f);
+
+    // objects that are not recomputed keep whatever global transform they had
+    const ezTransform sentinel(ezVec3(-100.0f, -100.0f, -100.0f));
+    ezGameObject* objects[] = {pRoot, pA, pA1, pB, pB1};
+    for (ezGameObject* pObject : objects)
+    {
+      ezGameObjectTest::OverwriteGlobalTransform(pObject, sentinel);
+    }
+
+    pA->SetLocalPosition(ezVec3(2.0f, 0.0f, 0.0f));
+    world.Update();
+
+    // only the moved object and its children are recomputed, not its parent or its siblings
+    EZ_TEST_VEC3(pA->GetGlobalPosition(), ezVec3(-98.0f, -100.0f, -100.0f), 0.0f);
+    EZ_TEST_VEC3(pA1->GetGlobalPosition(), ezVec3(-97.0f, -100.0f, -100.0f), 0.0f);
+    EZ_TEST_VEC3(pRoot->GetGlobalPosition(), sentinel.m_vPosition, 0.0f);
+    EZ_TEST_VEC3(pB->GetGlobalPosition(), sentinel.m_vPosition, 0.0f);
+    EZ_TEST_VEC3(pB1->GetGlobalPosition(), sentinel.m_vPosition, 0.0f);
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "GameObject parenting")
   {
     ezWorldDesc worldDesc("Test");
@@ -1,6 +1,8 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
+#include <Foundation/Algorithm/ParallelSorting.h>
 #include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Random.h>
 
 namespace
 {
@@ -11,6 +13,42 @@ namespace
     // Comparision via operator. Sorting algorithm should prefer Less operator
     bool operator()(ezInt32 a, ezInt32 b) const { return a < b; }
   };
+
+  struct KeyAndIndex
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiKey;
+    ezUInt32 m_uiIndex;
+  };
+
+  /// Checks that the elements are ordered by key and that equal keys kept their original order.
+  bool IsSortedStable(ezArrayPtr<const KeyAndIndex> data)
+  {
+    for (ezUInt32 i = 1; i < data.GetCount(); ++i)
+    {
+      if (data[i - 1].m_uiKey > data[i].m_uiKey)
+        return false;
+
+      if (data[i - 1].m_uiKey == data[i].m_uiKey && data[i - 1].m_uiIndex > data[i].m_uiIndex)
+        return false;
+    }
+
+    return true;
+  }
+
+  void CreateKeys(ezDynamicArray<KeyAndIndex>& out_data, ezUInt32 uiCount, ezUInt64 uiKeyMask)
+  {
+    ezRandom rnd;
+    rnd.Initialize(uiCount);
+
+    out_data.SetCount(uiCount);
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      out_data[i].m_uiKey = ((ezUInt64)rnd.UInt() << 32 | rnd.UInt()) & uiKeyMask;
+      out_data[i].m_uiIndex = i;
+    }
+  }
 } // namespace
 
 EZ_CREATE_SIMPLE_TEST(Algorithm, Sorting)
@@ -52,4 +90,106 @@ EZ_CREATE_SIMPLE_TEST(Algorithm, Sorting)
       EZ_TEST_BOOL(a2[i - 1] >= a2[i]);
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RadixSort")
+  {
+    ezDynamicArray<ezInt32> ints = a1;
+    ints.PushBack(-5);
+    ints.PushBack(-100000);
+    ezDynamicArray<ezInt32> temp;
+    temp.SetCount(ints.GetCount());
+
+    ezArrayPtr<ezInt32> intPtr = ints;
+    ezSorting::RadixSort(intPtr, temp.GetArrayPtr());
+
+    for (ezUInt32 i = 1; i < ints.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(ints[i - 1] <= ints[i]);
+    }
+
+    ezDynamicArray<float> floats;
+    for (ezUInt32 i = 0; i < 1000; ++i)
+    {
+      floats.PushBack((rand() % 20001 - 10000) * 0.125f);
+    }
+    floats.PushBack(-0.0f);
+    floats.PushBack(0.0f);
+    ezDynamicArray<float> floatTemp;
+    floatTemp.SetCount(floats.GetCount());
+
+    ezArrayPtr<float> floatPtr = floats;
+    ezSorting::RadixSort(floatPtr, floatTemp.GetArrayPtr());
+
+    for (ezUInt32 i = 1; i < floats.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(floats[i - 1] <= floats[i]);
+    }
+
+    // few distinct keys, to test stability
+    for (ezUInt64 uiKeyMask : {0x7ull, 0xFF00ull, 0xFFFFFFFFFFFFFFFFull})
+    {
+      ezDynamicArray<KeyAndIndex> data;
+      CreateKeys(data, 5000, uiKeyMask);
+      ezDynamicArray<KeyAndIndex> keyTemp;
+      keyTemp.SetCount(data.GetCount());
+
+      ezArrayPtr<KeyAndIndex> dataPtr = data;
+      ezSorting::RadixSort(dataPtr, keyTemp.GetArrayPtr(), [](const KeyAndIndex& e) { return e.m_uiKey; });
+      EZ_TEST_BOOL(IsSortedStable(data));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ParallelSorting::Sort")
+  {
+    for (ezUInt32 uiCount : {100u, 100000u, 1000003u})
+    {
+      ezDynamicArray<KeyAndIndex> data;
+      CreateKeys(data, uiCount, 0xFFFFFull);
+
+      ezArrayPtr<KeyAndIndex> dataPtr = data;
+      ezParallelSorting::Sort(dataPtr, [](const KeyAndIndex& a, const KeyAndIndex& b) {
+        return a.m_uiKey < b.m_uiKey || (a.m_uiKey == b.m_uiKey && a.m_uiIndex < b.m_uiIndex); });
+
+      EZ_TEST_BOOL(IsSortedStable(data));
+    }
+
+    ezDynamicArray<ezInt32> ints = a1;
+    ezArrayPtr<ezInt32> intPtr = ints;
+    ezParallelSorting::Sort(intPtr, CustomComparer());
+
+    for (ezUInt32 i = 1; i < ints.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(ints[i - 1] >= ints[i]);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ParallelSorting::RadixSort")
+  {
+    for (ezUInt32 uiCount : {100u, 100000u, 1000003u})
+    {
+      for (ezUInt64 uiKeyMask : {0xFFull, 0xFFFF0000ull, 0xFFFFFFFFFFFFFFFFull})
+      {
+        ezDynamicArray<KeyAndIndex> data;
+        CreateKeys(data, uiCount, uiKeyMask);
+
+        ezArrayPtr<KeyAndIndex> dataPtr = data;
+        ezParallelSorting::RadixSort(dataPtr, [](const KeyAndIndex& e) { return e.m_uiKey; });
+        EZ_TEST_BOOL(IsSortedStable(data));
+      }
+    }
+
+    ezDynamicArray<float> floats;
+    for (ezUInt32 i = 0; i < 100000; ++i)
+    {
+      floats.PushBack((rand() % 20001 - 10000) * 0.125f);
+    }
+
+    ezArrayPtr<float> floatPtr = floats;
+    ezParallelSorting::RadixSort(floatPtr);
+
+    for (ezUInt32 i = 1; i < floats.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(floats[i - 1] <= floats[i]);
+    }
+  }
 }
@@ -517,4 +517,55 @@ EZ_CREATE_SIMPLE_TEST(Containers, ArrayMap)
 
     EZ_TEST_INT(sa.UpperBound(60), ezInvalidIndex);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Incremental Sort")
+  {
+    ezArrayMap<ezInt32, ezInt32> sa;
+    ezMap<ezInt32, ezInt32> reference;
+
+    // insert several batches, each one gets merged into the already sorted data on the next lookup
+    for (ezInt32 iBatch = 0; iBatch < 20; ++iBatch)
+    {
+      for (ezInt32 i = 0; i < 100; ++i)
+      {
+        const ezInt32 iKey = ((i * 37) % 100) * 20 + iBatch;
+        sa.Insert(iKey, iBatch);
+        reference.Insert(iKey, iBatch);
+      }
+
+      sa.Sort();
+
+      // remove a few elements, both with and without keeping the order
+      reference.Remove(sa.GetKey(iBatch));
+      sa.RemoveAtAndCopy(iBatch, true);
+      reference.Remove(sa.GetKey(sa.GetCount() - 1 - iBatch));
+      sa.RemoveAtAndCopy(sa.GetCount() - 1 - iBatch, false);
+
+      EZ_TEST_INT(sa.GetCount(), reference.GetCount());
+
+      sa.Sort();
+      for (ezUInt32 i = 1; i < sa.GetCount(); ++i)
+      {
+        EZ_TEST_BOOL(!(sa.GetKey(i) < sa.GetKey(i - 1)));
+      }
+    }
+
+    ezUInt32 uiIndex = 0;
+    for (auto it : reference)
+    {
+      EZ_TEST_INT(sa.GetKey(uiIndex), it.Key());
+      EZ_TEST_INT(sa.GetValue(uiIndex), it.Value());
+      ++uiIndex;
+    }
+
+    // batch appended in order, no merge needed
+    const ezUInt32 uiCount = sa.GetCount();
+    for (ezInt32 i = 0; i < 100; ++i)
+    {
+      sa.Insert(20000 + i, i);
+    }
+
+    EZ_TEST_INT(sa.Find(20050), uiCount + 50);
+    EZ_TEST_INT(sa.GetValue(sa.Find(20050)), 50);
+  }
 }
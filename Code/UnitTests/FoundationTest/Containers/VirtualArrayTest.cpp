@@ -0,0 +1,97 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Containers/VirtualArray.h>
+
+EZ_CREATE_SIMPLE_TEST(Containers, VirtualArray)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Constructor")
+  {
+    ezVirtualArray<ezInt32> a1(1024 * 1024);
+
+    EZ_TEST_BOOL(a1.IsEmpty());
+    EZ_TEST_INT(a1.GetMaxCapacity(), 1024 * 1024);
+    EZ_TEST_INT(a1.GetCapacity(), 0);
+    EZ_TEST_INT(a1.GetHeapMemoryUsage(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "PushBack / Reserve")
+  {
+    ezVirtualArray<ezInt32> a1(4 * 1024 * 1024);
+
+    a1.PushBack(0);
+    const ezInt32* pFirst = &a1[0];
+
+    for (ezInt32 i = 1; i < 1000000; ++i)
+    {
+      a1.PushBack(i);
+    }
+
+    // growing never moves any elements
+    EZ_TEST_BOOL(&a1[0] == pFirst);
+    EZ_TEST_INT(a1.GetCount(), 1000000);
+    EZ_TEST_BOOL(a1.GetCapacity() >= a1.GetCount());
+    EZ_TEST_BOOL(a1.GetHeapMemoryUsage() >= a1.GetCount() * sizeof(ezInt32));
+    EZ_TEST_BOOL(a1.GetHeapMemoryUsage() < a1.GetMaxCapacity() * sizeof(ezInt32));
+
+    for (ezInt32 i = 0; i < 1000000; ++i)
+    {
+      EZ_TEST_INT(a1[i], i);
+    }
+
+    a1.Reserve(a1.GetMaxCapacity());
+    EZ_TEST_INT(a1.GetCapacity(), a1.GetMaxCapacity());
+    EZ_TEST_BOOL(&a1[0] == pFirst);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compact")
+  {
+    ezVirtualArray<ezInt32> a1(1024 * 1024);
+    a1.SetCount(1024 * 1024);
+
+    const ezUInt64 uiFullUsage = a1.GetHeapMemoryUsage();
+
+    a1.SetCount(10);
+    a1.Compact();
+
+    EZ_TEST_BOOL(a1.GetHeapMemoryUsage() < uiFullUsage);
+    EZ_TEST_BOOL(a1.GetCapacity() >= 10);
+    EZ_TEST_INT(a1[9], 0);
+
+    // decommitted memory is zero initialized again when it gets committed
+    a1.SetCountUninitialized(1024 * 1024);
+    EZ_TEST_INT(a1[1024 * 1024 - 1], 0);
+
+    a1.Clear();
+    a1.Compact();
+    EZ_TEST_INT(a1.GetHeapMemoryUsage(), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Construction / Destruction")
+  {
+    {
+      ezVirtualArray<ezConstructionCounter> a1(100000);
+
+      for (ezInt32 i = 0; i < 50000; ++i)
+      {
+        a1.PushBack(ezConstructionCounter(i));
+      }
+
+      a1.RemoveAtAndSwap(0);
+      EZ_TEST_INT(a1[0].m_iData, 49999);
+      EZ_TEST_INT(a1.GetCount(), 49999);
+    }
+
+    EZ_TEST_BOOL(ezConstructionCounter::HasAllDestructed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "operator=")
+  {
+    ezVirtualArray<ezInt32> a1(1000);
+
+    ezInt32 values[] = {1, 2, 3, 4};
+    a1 = ezMakeArrayPtr(values);
+
+    EZ_TEST_INT(a1.GetCount(), 4);
+    EZ_TEST_INT(a1[3], 4);
+  }
+}
@@ -1,12 +1,17 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
 #include <Foundation/IO/Archive/Archive.h>
+#include <Foundation/IO/Archive/ArchiveBlockCompressedReader.h>
+#include <Foundation/IO/Archive/ArchiveBuilder.h>
+#include <Foundation/IO/Archive/ArchiveReader.h>
+#include <Foundation/IO/Archive/ArchiveUtils.h>
 #include <Foundation/IO/Archive/DataDirTypeArchive.h>
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/System/Process.h>
+#include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/CommandLineUtils.h>
 
 #if (EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS) && defined(BUILDSYSTEM_HAS_ARCHIVE_TOOL))
@@ -157,3 +162,389 @@ EZ_CREATE_SIMPLE_TEST(IO, Archive)
 }
 
 #endif
+
+#if (EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS) && EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE) && defined(BUILDSYSTEM_ENABLE_ZSTD_SUPPORT))
+
+static ezUInt8 ReadArchiveVersion(ezStringView sFile)
+{
+  ezUInt8 uiVersion = 0;
+
+  ezFileReader file;
+  if (file.Open(sFile).Succeeded())
+  {
+    ezArchiveUtils::ReadHeader(file, uiVersion).IgnoreResult();
+  }
+
+  return uiVersion;
+}
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveBlockCompression)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveBlockTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+  ezOSFile::CreateDirectoryStructure(sOutputFolder).IgnoreResult();
+
+  if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "ArchiveBlocks", "output", ezFileSystem::AllowWrites).Succeeded()))
+    return;
+
+  EZ_SCOPE_EXIT(ezFileSystem::RemoveDataDirectoryGroup("ArchiveBlocks"));
+
+  // several blocks plus a partial one
+  const ezUInt32 uiLargeFileSize = ezArchiveBlockCompressedReader::DefaultBlockSize * 13 + 12345;
+  const ezUInt32 uiSmallFileSize = 50000;
+
+  ezDynamicArray<ezUInt8> largeData;
+  ezDynamicArray<ezUInt8> smallData;
+
+  const ezStringBuilder sLargeFile(sOutputFolder, "/Large.bin");
+  const ezStringBuilder sSmallFile(sOutputFolder, "/Small.bin");
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Blocks.ezArchive");
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    ezUInt32 uiValue = 0;
+    for (ezUInt32 i = 0; i < uiLargeFileSize; ++i)
+    {
+      // compressible, but different in every block
+      largeData.PushBack(static_cast<ezUInt8>((i / 7) ^ (i >> 16)));
+    }
+
+    for (ezUInt32 i = 0; i < uiSmallFileSize; ++i)
+    {
+      smallData.PushBack(static_cast<ezUInt8>((uiValue++ / 3) & 0x1F));
+    }
+
+    ezOSFile file;
+    EZ_TEST_BOOL(file.Open(sLargeFile, ezFileOpenMode::Write).Succeeded());
+    EZ_TEST_BOOL(file.Write(largeData.GetData(), largeData.GetCount()).Succeeded());
+    file.Close();
+
+    EZ_TEST_BOOL(file.Open(sSmallFile, ezFileOpenMode::Write).Succeeded());
+    EZ_TEST_BOOL(file.Write(smallData.GetData(), smallData.GetCount()).Succeeded());
+    file.Close();
+
+    ezArchiveBuilder builder;
+
+    auto& large = builder.m_Entries.ExpandAndGetRef();
+    large.m_sAbsSourcePath = sLargeFile;
+    large.m_sRelTargetPath = "Large.bin";
+    large.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd_blocks;
+    large.m_iCompressionLevel = 1;
+
+    auto& small = builder.m_Entries.ExpandAndGetRef();
+    small.m_sAbsSourcePath = sSmallFile;
+    small.m_sRelTargetPath = "Small.bin";
+    small.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd_blocks;
+    small.m_iCompressionLevel = 1;
+
+    if (!EZ_TEST_BOOL(builder.WriteArchive(":output/Blocks.ezArchive").Succeeded()))
+      return;
+  }
+
+  ezArchiveReader archive;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Open Archive")
+  {
+    if (!EZ_TEST_BOOL(archive.OpenArchive(sArchiveFile).Succeeded()))
+      return;
+
+    const ezArchiveTOC& toc = archive.GetArchiveTOC();
+    EZ_TEST_INT(toc.m_Entries.GetCount(), 2);
+    EZ_TEST_INT(ReadArchiveVersion(":output/Blocks.ezArchive"), 5);
+
+    for (const auto& entry : toc.m_Entries)
+    {
+      EZ_TEST_BOOL(entry.m_CompressionMode == ezArchiveCompressionMode::Compressed_zstd_blocks);
+      EZ_TEST_BOOL(entry.m_uiStoredDataSize < entry.m_uiUncompressedDataSize);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Random Access")
+  {
+    const ezUInt32 uiLargeEntry = archive.GetArchiveTOC().FindEntry("Large.bin");
+    EZ_TEST_BOOL(uiLargeEntry != ezInvalidIndex);
+
+    ezDynamicArray<ezUInt8> buffer;
+    buffer.SetCount(uiLargeFileSize);
+
+    struct Range
+    {
+      ezUInt32 m_uiStart;
+      ezUInt32 m_uiCount;
+    };
+
+    const ezUInt32 uiBlockSize = ezArchiveBlockCompressedReader::DefaultBlockSize;
+    const Range ranges[] = {
+      {uiLargeFileSize - 100, 100},                     // the tail
+      {uiBlockSize * 5, uiBlockSize},                   // exactly one block
+      {uiBlockSize * 2 + 17, 10},                       // inside a block
+      {uiBlockSize - 3, 6},                             // across a block border
+      {uiBlockSize * 3 + 5, uiBlockSize * 6},           // partial, full blocks in parallel, partial
+      {0, uiLargeFileSize},                             // everything
+      {uiBlockSize * 12, uiLargeFileSize - uiBlockSize * 12}, // the last full block and the partial one
+    };
+
+    for (const Range& range : ranges)
+    {
+      EZ_TEST_INT(archive.ReadEntryData(uiLargeEntry, range.m_uiStart, buffer.GetData(), range.m_uiCount), range.m_uiCount);
+      EZ_TEST_BOOL(ezMemoryUtils::IsEqual(buffer.GetData(), largeData.GetData() + range.m_uiStart, range.m_uiCount));
+    }
+
+    // reading beyond the end
+    EZ_TEST_INT(archive.ReadEntryData(uiLargeEntry, uiLargeFileSize - 10, buffer.GetData(), 100), 10);
+    EZ_TEST_INT(archive.ReadEntryData(uiLargeEntry, uiLargeFileSize, buffer.GetData(), 100), 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sequential Read and Skip")
+  {
+    ezArchiveBlockCompressedReader reader;
+    archive.ConfigureBlockCompressedReader(archive.GetArchiveTOC().FindEntry("Large.bin"), reader);
+
+    EZ_TEST_INT(reader.GetUncompressedSize(), uiLargeFileSize);
+    EZ_TEST_INT(reader.GetNumBlocks(), 14);
+
+    ezDynamicArray<ezUInt8> readData;
+    readData.SetCount(uiLargeFileSize);
+
+    ezUInt32 uiPos = 0;
+    ezUInt32 uiChunk = 1;
+    bool bSkip = false;
+
+    while (uiPos < uiLargeFileSize)
+    {
+      const ezUInt32 uiBytes = ezMath::Min(uiChunk, uiLargeFileSize - uiPos);
+
+      if (bSkip)
+      {
+        EZ_TEST_INT(reader.SkipBytes(uiBytes), uiBytes);
+        ezMemoryUtils::Copy(readData.GetData() + uiPos, largeData.GetData() + uiPos, uiBytes);
+      }
+      else
+      {
+        EZ_TEST_INT(reader.ReadBytes(readData.GetData() + uiPos, uiBytes), uiBytes);
+      }
+
+      uiPos += uiBytes;
+      uiChunk = uiChunk * 3 + 11;
+      bSkip = !bSkip;
+    }
+
+    EZ_TEST_INT(reader.GetReadPosition(), uiLargeFileSize);
+    EZ_TEST_BOOL(readData == largeData);
+
+    ezUInt8 uiTemp = 0;
+    EZ_TEST_INT(reader.ReadBytes(&uiTemp, 1), 0);
+
+    reader.SetReadPosition(7);
+    EZ_TEST_INT(reader.ReadBytes(&uiTemp, 1), 1);
+    EZ_TEST_INT(uiTemp, largeData[7]);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Invalid Data")
+  {
+    EZ_LOG_BLOCK_MUTE();
+
+    ezArchiveBlockCompressedReader reader;
+    EZ_TEST_BOOL(reader.SetInputData(largeData.GetData(), 4, 100).Failed());
+    EZ_TEST_BOOL(reader.SetInputData(largeData.GetData(), 1000, 100000).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mount as Data Dir")
+  {
+    if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sArchiveFile, "ArchiveBlocks", "blocks", ezFileSystem::ReadOnly) == EZ_SUCCESS))
+      return;
+
+    ezFileReader file;
+    EZ_TEST_BOOL(file.Open(":blocks/Small.bin").Succeeded());
+
+    ezDynamicArray<ezUInt8> readData;
+    readData.SetCount(uiSmallFileSize);
+    EZ_TEST_INT(file.ReadBytes(readData.GetData(), uiSmallFileSize), uiSmallFileSize);
+    EZ_TEST_BOOL(readData == smallData);
+    file.Close();
+
+    EZ_TEST_FILES(sLargeFile, ":blocks/Large.bin", "Block compressed file should be identical");
+
+    // skipping through the file reader is forwarded to the block reader, reads after it still have to return the right data
+    EZ_TEST_BOOL(file.Open(":blocks/Large.bin", 4096).Succeeded());
+
+    ezUInt8 uiBuffer[100];
+    EZ_TEST_INT(file.ReadBytes(uiBuffer, 100), 100);
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(uiBuffer, largeData.GetData(), 100));
+
+    const ezUInt64 uiSkip = ezArchiveBlockCompressedReader::DefaultBlockSize * 5 + 777;
+    EZ_TEST_INT(file.SkipBytes(uiSkip), uiSkip);
+    EZ_TEST_INT(file.ReadBytes(uiBuffer, 100), 100);
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(uiBuffer, largeData.GetData() + 100 + uiSkip, 100));
+
+    // skip within the cached bytes
+    EZ_TEST_INT(file.SkipBytes(50), 50);
+    EZ_TEST_INT(file.ReadBytes(uiBuffer, 10), 10);
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(uiBuffer, largeData.GetData() + 250 + uiSkip, 10));
+
+    // skip to the tail and past the end
+    const ezUInt64 uiPosition = 260 + uiSkip;
+    EZ_TEST_INT(file.SkipBytes(uiLargeFileSize - uiPosition - 100), uiLargeFileSize - uiPosition - 100);
+    EZ_TEST_INT(file.ReadBytes(uiBuffer, 50), 50);
+    EZ_TEST_BOOL(ezMemoryUtils::IsEqual(uiBuffer, largeData.GetData() + uiLargeFileSize - 100, 50));
+    EZ_TEST_INT(file.SkipBytes(1000), 50);
+    EZ_TEST_INT(file.ReadBytes(uiBuffer, 10), 0);
+    file.Close();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Incompressible Data")
+  {
+    const ezStringBuilder sRandomFile(sOutputFolder, "/Random.bin");
+
+    ezDynamicArray<ezUInt8> randomData;
+    randomData.SetCountUninitialized(ezArchiveBlockCompressedReader::DefaultBlockSize * 2);
+
+    ezUInt32 uiSeed = 12345;
+    for (ezUInt8& uiByte : randomData)
+    {
+      uiSeed = uiSeed * 1664525u + 1013904223u;
+      uiByte = static_cast<ezUInt8>(uiSeed >> 24);
+    }
+
+    ezOSFile file;
+    EZ_TEST_BOOL(file.Open(sRandomFile, ezFileOpenMode::Write).Succeeded());
+    EZ_TEST_BOOL(file.Write(randomData.GetData(), randomData.GetCount()).Succeeded());
+    file.Close();
+
+    ezArchiveBuilder builder;
+
+    auto& entry = builder.m_Entries.ExpandAndGetRef();
+    entry.m_sAbsSourcePath = sRandomFile;
+    entry.m_sRelTargetPath = "Random.bin";
+    entry.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd_blocks;
+    entry.m_iCompressionLevel = 1;
+
+    if (!EZ_TEST_BOOL(builder.WriteArchive(":output/Random.ezArchive").Succeeded()))
+      return;
+
+    // the entry was stored uncompressed, so older readers must still be able to open the archive
+    EZ_TEST_INT(ReadArchiveVersion(":output/Random.ezArchive"), 4);
+
+    ezArchiveReader randomArchive;
+    if (!EZ_TEST_BOOL(randomArchive.OpenArchive(ezStringBuilder(sOutputFolder, "/Random.ezArchive")).Succeeded()))
+      return;
+
+    const ezArchiveTOC& toc = randomArchive.GetArchiveTOC();
+    if (!EZ_TEST_BOOL(toc.m_Entries.GetCount() == 1))
+      return;
+
+    EZ_TEST_BOOL(toc.m_Entries[0].m_CompressionMode == ezArchiveCompressionMode::Uncompressed);
+    EZ_TEST_INT(toc.m_Entries[0].m_uiStoredDataSize, randomData.GetCount());
+  }
+}
+
+#endif
+
+#if (EZ_ENABLED(EZ_SUPPORTS_FILE_ITERATORS) && EZ_ENABLED(EZ_SUPPORTS_FILE_STATS) && EZ_ENABLED(EZ_SUPPORTS_MEMORY_MAPPED_FILE))
+
+EZ_CREATE_SIMPLE_TEST(IO, ArchiveMappedData)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("ArchiveMappedTest");
+  sOutputFolder.MakeCleanPath();
+
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+  ezOSFile::CreateDirectoryStructure(sOutputFolder).IgnoreResult();
+
+  if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "ArchiveMapped", "output", ezFileSystem::AllowWrites).Succeeded()))
+    return;
+
+  EZ_SCOPE_EXIT(ezFileSystem::RemoveDataDirectoryGroup("ArchiveMapped"));
+
+  const ezUInt32 uiFileSize = 300000;
+
+  ezDynamicArray<ezUInt8> fileData;
+  const ezStringBuilder sSourceFile(sOutputFolder, "/Raw.bin");
+  const ezStringBuilder sArchiveFile(sOutputFolder, "/Mapped.ezArchive");
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write Archive")
+  {
+    for (ezUInt32 i = 0; i < uiFileSize; ++i)
+    {
+      fileData.PushBack(static_cast<ezUInt8>(i * 13 + (i >> 8)));
+    }
+
+    ezOSFile file;
+    EZ_TEST_BOOL(file.Open(sSourceFile, ezFileOpenMode::Write).Succeeded());
+    EZ_TEST_BOOL(file.Write(fileData.GetData(), fileData.GetCount()).Succeeded());
+    file.Close();
+
+    ezArchiveBuilder builder;
+
+    auto& raw = builder.m_Entries.ExpandAndGetRef();
+    raw.m_sAbsSourcePath = sSourceFile;
+    raw.m_sRelTargetPath = "Raw.bin";
+    raw.m_CompressionMode = ezArchiveCompressionMode::Uncompressed;
+
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    auto& compressed = builder.m_Entries.ExpandAndGetRef();
+    compressed.m_sAbsSourcePath = sSourceFile;
+    compressed.m_sRelTargetPath = "Compressed.bin";
+    compressed.m_CompressionMode = ezArchiveCompressionMode::Compressed_zstd;
+#  endif
+
+    if (!EZ_TEST_BOOL(builder.WriteArchive(":output/Mapped.ezArchive").Succeeded()))
+      return;
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "GetUncompressedEntryData")
+  {
+    ezArchiveReader archive;
+    if (!EZ_TEST_BOOL(archive.OpenArchive(sArchiveFile).Succeeded()))
+      return;
+
+    const ezUInt32 uiRawEntry = archive.GetArchiveTOC().FindEntry("Raw.bin");
+    if (!EZ_TEST_BOOL(uiRawEntry != ezInvalidIndex))
+      return;
+
+    EZ_TEST_BOOL(archive.GetUncompressedEntryData(uiRawEntry) == fileData.GetArrayPtr());
+
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    EZ_TEST_BOOL(archive.GetUncompressedEntryData(archive.GetArchiveTOC().FindEntry("Compressed.bin")).IsEmpty());
+#  endif
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Mount as Data Dir")
+  {
+    if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sArchiveFile, "ArchiveMapped", "mapped", ezFileSystem::ReadOnly) == EZ_SUCCESS))
+      return;
+
+    ezFileReader file;
+    if (!EZ_TEST_BOOL(file.Open(":mapped/Raw.bin").Succeeded()))
+      return;
+
+    EZ_TEST_BOOL(file.GetMappedData() == fileData.GetArrayPtr());
+
+    ezUInt8 uiValues[16];
+    EZ_TEST_INT(file.ReadBytes(uiValues, 16), 16);
+    EZ_TEST_BOOL(fileData.GetArrayPtr().GetSubArray(0, 16) == ezArrayPtr<const ezUInt8>(uiValues));
+
+    EZ_TEST_INT(file.SkipBytes(uiFileSize - 32), uiFileSize - 32);
+    EZ_TEST_INT(file.ReadBytes(uiValues, 16), 16);
+    EZ_TEST_BOOL(fileData.GetArrayPtr().GetSubArray(uiFileSize - 16, 16) == ezArrayPtr<const ezUInt8>(uiValues));
+
+    EZ_TEST_INT(file.ReadBytes(uiValues, 16), 0);
+    EZ_TEST_INT(file.SkipBytes(16), 0);
+    file.Close();
+
+#  ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
+    if (!EZ_TEST_BOOL(file.Open(":mapped/Compressed.bin").Succeeded()))
+      return;
+
+    EZ_TEST_BOOL(file.GetMappedData().IsEmpty());
+    file.Close();
+#  endif
+
+    EZ_TEST_FILES(sSourceFile, ":mapped/Raw.bin", "Mapped file should be identical");
+  }
+}
+
+#endif
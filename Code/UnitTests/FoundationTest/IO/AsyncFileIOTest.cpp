@@ -0,0 +1,218 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/AsyncFileIO.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Threading/Mutex.h>
+
+namespace
+{
+  constexpr ezUInt32 s_uiNumTestFiles = 24;
+
+  ezUInt32 GetTestFileSize(ezUInt32 uiFile)
+  {
+    // includes an empty file and files that are larger than a page
+    return uiFile * uiFile * 311;
+  }
+
+  ezUInt8 GetTestFileByte(ezUInt32 uiFile, ezUInt32 uiByte)
+  {
+    return static_cast<ezUInt8>(uiFile * 7 + uiByte * 13 + (uiByte >> 8));
+  }
+
+  struct ReadResults
+  {
+    ezMutex m_Mutex;
+    ezUInt32 m_uiNumCallbacks = 0;
+    ezUInt32 m_uiNumCorrect = 0;
+    ezUInt32 m_uiNumFailed = 0;
+  };
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(IO, AsyncFileIO)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.MakeCleanPath();
+  sOutputFolder.AppendPath("IO", "AsyncFileIO");
+
+  ezStringBuilder sFile;
+  for (ezUInt32 uiFile = 0; uiFile < s_uiNumTestFiles; ++uiFile)
+  {
+    ezDynamicArray<ezUInt8> content;
+    content.SetCountUninitialized(GetTestFileSize(uiFile));
+    for (ezUInt32 i = 0; i < content.GetCount(); ++i)
+    {
+      content[i] = GetTestFileByte(uiFile, i);
+    }
+
+    sFile.Format("{}/File{}.dat", sOutputFolder, uiFile);
+
+    ezOSFile file;
+    if (!EZ_TEST_BOOL(file.Open(sFile, ezFileOpenMode::Write).Succeeded()))
+      return;
+
+    if (!content.IsEmpty())
+    {
+      EZ_TEST_BOOL(file.Write(content.GetData(), content.GetCount()).Succeeded());
+    }
+  }
+
+  EZ_SCOPE_EXIT(ezAsyncFileIO::SetBackend(ezAsyncFileIOBackend::Default));
+
+  const ezAsyncFileIOBackend::Enum backends[] = {ezAsyncFileIOBackend::ThreadPool, ezAsyncFileIOBackend::IoUring};
+
+  for (ezAsyncFileIOBackend::Enum backend : backends)
+  {
+    ezAsyncFileIO::SetBackend(backend);
+
+    // the io_uring backend is not available on all systems
+    if (backend == ezAsyncFileIOBackend::IoUring && ezAsyncFileIO::GetBackend() != ezAsyncFileIOBackend::IoUring)
+    {
+      ezLog::Info("The io_uring backend is not available.");
+      continue;
+    }
+
+    EZ_TEST_INT(ezAsyncFileIO::GetBackend(), backend);
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, backend == ezAsyncFileIOBackend::IoUring ? "ReadFile (io_uring)" : "ReadFile (thread pool)")
+    {
+      ReadResults results;
+
+      auto onFinished = [&results](ezAsyncFileReadResult& ref_result)
+      {
+        const ezUInt32 uiFile = static_cast<ezUInt32>(reinterpret_cast<ezUInt64>(ref_result.m_pUserData));
+
+        bool bCorrect = ref_result.m_Result.Succeeded() && ref_result.m_Data.GetCount() == GetTestFileSize(uiFile);
+        for (ezUInt32 i = 0; bCorrect && i < ref_result.m_Data.GetCount(); ++i)
+        {
+          bCorrect = ref_result.m_Data[i] == GetTestFileByte(uiFile, i);
+        }
+
+        EZ_LOCK(results.m_Mutex);
+        ++results.m_uiNumCallbacks;
+        results.m_uiNumCorrect += bCorrect ? 1 : 0;
+      };
+
+      // issue all reads at once, and every file twice
+      for (ezUInt32 uiRound = 0; uiRound < 2; ++uiRound)
+      {
+        for (ezUInt32 uiFile = 0; uiFile < s_uiNumTestFiles; ++uiFile)
+        {
+          sFile.Format("{}/File{}.dat", sOutputFolder, uiFile);
+          ezAsyncFileIO::ReadFile(sFile, onFinished, reinterpret_cast<void*>(static_cast<ezUInt64>(uiFile)));
+        }
+      }
+
+      ezAsyncFileIO::WaitForAllReads();
+
+      EZ_TEST_INT(ezAsyncFileIO::GetNumPendingReads(), 0);
+      EZ_TEST_INT(results.m_uiNumCallbacks, s_uiNumTestFiles * 2);
+      EZ_TEST_INT(results.m_uiNumCorrect, s_uiNumTestFiles * 2);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, backend == ezAsyncFileIOBackend::IoUring ? "Missing File (io_uring)" : "Missing File (thread pool)")
+    {
+      ReadResults results;
+
+      auto onFinished = [&results](ezAsyncFileReadResult& ref_result)
+      {
+        EZ_LOCK(results.m_Mutex);
+        ++results.m_uiNumCallbacks;
+        results.m_uiNumFailed += (ref_result.m_Result.Failed() && ref_result.m_Data.IsEmpty()) ? 1 : 0;
+      };
+
+      sFile.Format("{}/DoesNotExist.dat", sOutputFolder);
+      ezAsyncFileIO::ReadFile(sFile, onFinished);
+      ezAsyncFileIO::ReadFile(sOutputFolder, onFinished);
+
+      ezAsyncFileIO::WaitForAllReads();
+
+      EZ_TEST_INT(results.m_uiNumCallbacks, 2);
+      EZ_TEST_INT(results.m_uiNumFailed, 2);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SetBackend with pending reads")
+  {
+    ReadResults results;
+
+    auto onFinished = [&results](ezAsyncFileReadResult& ref_result)
+    {
+      EZ_LOCK(results.m_Mutex);
+      ++results.m_uiNumCallbacks;
+      results.m_uiNumCorrect += ref_result.m_Result.Succeeded() ? 1 : 0;
+    };
+
+    // switching the backend must not lose any of the reads that are still in flight
+    const ezAsyncFileIOBackend::Enum switchTo[] = {ezAsyncFileIOBackend::IoUring, ezAsyncFileIOBackend::ThreadPool, ezAsyncFileIOBackend::Default};
+
+    for (ezAsyncFileIOBackend::Enum backend : switchTo)
+    {
+      for (ezUInt32 uiFile = 0; uiFile < s_uiNumTestFiles; ++uiFile)
+      {
+        sFile.Format("{}/File{}.dat", sOutputFolder, uiFile);
+        ezAsyncFileIO::ReadFile(sFile, onFinished);
+      }
+
+      ezAsyncFileIO::SetBackend(backend);
+    }
+
+    ezAsyncFileIO::WaitForAllReads();
+
+    EZ_TEST_INT(results.m_uiNumCallbacks, s_uiNumTestFiles * EZ_ARRAY_SIZE(switchTo));
+    EZ_TEST_INT(results.m_uiNumCorrect, s_uiNumTestFiles * EZ_ARRAY_SIZE(switchTo));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ezFileSystem::PrefetchFile")
+  {
+    if (!EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder, "AsyncFileIOTest", "asyncio").Succeeded()))
+      return;
+
+    EZ_SCOPE_EXIT(ezFileSystem::RemoveDataDirectoryGroup("AsyncFileIOTest"));
+
+    EZ_TEST_BOOL(!ezFileSystem::PrefetchFile(":asyncio/DoesNotExist.dat"));
+
+    for (ezUInt32 uiFile = 0; uiFile < s_uiNumTestFiles; ++uiFile)
+    {
+      sFile.Format(":asyncio/File{}.dat", uiFile);
+      EZ_TEST_BOOL(ezFileSystem::PrefetchFile(sFile));
+    }
+
+    for (ezUInt32 uiFile = 0; uiFile < s_uiNumTestFiles; ++uiFile)
+    {
+      sFile.Format(":asyncio/File{}.dat", uiFile);
+
+      ezFileReader file;
+      if (!EZ_TEST_BOOL(file.Open(sFile).Succeeded()))
+        continue;
+
+      // the prefetched content is served from memory
+      const ezArrayPtr<const ezUInt8> data = file.GetMappedData();
+      EZ_TEST_INT(data.GetCount(), GetTestFileSize(uiFile));
+      EZ_TEST_INT(file.GetFileSize(), GetTestFileSize(uiFile));
+
+      bool bCorrect = true;
+      for (ezUInt32 i = 0; bCorrect && i < data.GetCount(); ++i)
+      {
+        bCorrect = data[i] == GetTestFileByte(uiFile, i);
+      }
+      EZ_TEST_BOOL(bCorrect);
+
+      ezDynamicArray<ezUInt8> content;
+      content.SetCountUninitialized(GetTestFileSize(uiFile));
+      EZ_TEST_INT(file.ReadBytes(content.GetData(), content.GetCount()), content.GetCount());
+      EZ_TEST_BOOL(ezMemoryUtils::IsEqual(content.GetData(), data.GetPtr(), content.GetCount()));
+    }
+
+    // the prefetched data was consumed, files that are opened again are read regularly
+    {
+      ezFileReader file;
+      if (EZ_TEST_BOOL(file.Open(":asyncio/File3.dat").Succeeded()))
+      {
+        EZ_TEST_BOOL(file.GetMappedData().IsEmpty());
+        EZ_TEST_INT(file.GetFileSize(), GetTestFileSize(3));
+      }
+    }
+  }
+}
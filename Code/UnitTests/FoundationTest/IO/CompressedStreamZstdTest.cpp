@@ -3,6 +3,7 @@
 #include <Foundation/IO/CompressedStreamZstd.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/Stream.h>
+#include <Foundation/Math/Random.h>
 
 #ifdef BUILDSYSTEM_ENABLE_ZSTD_SUPPORT
 
@@ -136,4 +137,165 @@ EZ_CREATE_SIMPLE_TEST(IO, CompressedStreamZstd)
   }
 }
 
+namespace
+{
+  void CreateSmallSample(ezDynamicArray<ezUInt8>& out_sample, ezUInt32 uiIndex)
+  {
+    ezStringBuilder sText;
+    sText.Format("<Node Name=\"Object{0}\"><Transform Position=\"{1}, {2}, 0.5\" Rotation=\"0, 0, 0, 1\"/>"
+                 "<MeshComponent Mesh=\"6b2fd5f4-c3a8-4d5e-9a61-{3}\" CastShadow=\"true\"/></Node>",
+      uiIndex, uiIndex * 3, uiIndex % 17, uiIndex * 7919);
+
+    out_sample.Clear();
+    out_sample.PushBackRange(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(sText.GetData()), sText.GetElementCount()));
+  }
+
+  ezUInt64 CompressAndVerify(ezArrayPtr<const ezUInt8> data, const ezCompressionDictionaryZstd* pDictionary)
+  {
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter memoryWriter(&storage);
+    ezMemoryStreamReader memoryReader(&storage);
+
+    ezCompressedStreamWriterZstd writer(&memoryWriter, 0);
+    writer.SetDictionary(pDictionary);
+    EZ_TEST_BOOL(writer.WriteBytes(data.GetPtr(), data.GetCount()).Succeeded());
+    EZ_TEST_BOOL(writer.FinishCompressedStream().Succeeded());
+
+    ezCompressedStreamReaderZstd reader(&memoryReader);
+    reader.SetDictionary(pDictionary);
+
+    ezDynamicArray<ezUInt8> readData;
+    readData.SetCount(data.GetCount());
+    EZ_TEST_INT(reader.ReadBytes(readData.GetData(), data.GetCount()), data.GetCount());
+    EZ_TEST_BOOL(readData.GetArrayPtr() == data);
+
+    return writer.GetCompressedSize();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(IO, CompressedStreamZstdDictionary)
+{
+  ezDynamicArray<ezDynamicArray<ezUInt8>> samples;
+  samples.SetCount(500);
+
+  ezDynamicArray<ezArrayPtr<const ezUInt8>> samplePtrs;
+  for (ezUInt32 i = 0; i < samples.GetCount(); ++i)
+  {
+    CreateSmallSample(samples[i], i);
+    samplePtrs.PushBack(samples[i]);
+  }
+
+  ezCompressionDictionaryZstd dictionary;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CreateFromSamples")
+  {
+    EZ_TEST_BOOL(!dictionary.IsValid());
+
+    dictionary.CreateFromSamples(samplePtrs, 4 * 1024);
+
+    EZ_TEST_BOOL(dictionary.IsValid());
+    EZ_TEST_BOOL(dictionary.GetData().GetCount() > 0);
+    EZ_TEST_BOOL(dictionary.GetData().GetCount() <= 4 * 1024);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compress with Dictionary")
+  {
+    ezUInt64 uiSizeWithoutDictionary = 0;
+    ezUInt64 uiSizeWithDictionary = 0;
+
+    ezDynamicArray<ezUInt8> sample;
+    for (ezUInt32 i = 1000; i < 1100; ++i)
+    {
+      CreateSmallSample(sample, i);
+
+      uiSizeWithoutDictionary += CompressAndVerify(sample, nullptr);
+      uiSizeWithDictionary += CompressAndVerify(sample, &dictionary);
+    }
+
+    EZ_TEST_BOOL(uiSizeWithDictionary * 2 < uiSizeWithoutDictionary);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "CreateFromData")
+  {
+    ezDynamicArray<ezUInt8> sample;
+    CreateSmallSample(sample, 12345);
+
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter memoryWriter(&storage);
+    ezMemoryStreamReader memoryReader(&storage);
+
+    {
+      ezCompressedStreamWriterZstd writer;
+      writer.SetDictionary(&dictionary);
+      writer.SetOutputStream(&memoryWriter, 0);
+      EZ_TEST_BOOL(writer.WriteBytes(sample.GetData(), sample.GetCount()).Succeeded());
+    }
+
+    // a dictionary that was restored from the stored data can decompress the stream
+    ezCompressionDictionaryZstd dictionary2;
+    dictionary2.CreateFromData(dictionary.GetData());
+    EZ_TEST_BOOL(dictionary2.IsValid());
+    EZ_TEST_BOOL(dictionary2.GetData() == dictionary.GetData());
+
+    ezCompressedStreamReaderZstd reader;
+    reader.SetDictionary(&dictionary2);
+    reader.SetInputStream(&memoryReader);
+
+    ezDynamicArray<ezUInt8> readData;
+    readData.SetCount(sample.GetCount());
+    EZ_TEST_INT(reader.ReadBytes(readData.GetData(), sample.GetCount()), sample.GetCount());
+    EZ_TEST_BOOL(readData == sample);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Small Samples")
+  {
+    // if all samples together are smaller than the dictionary, they are used as is
+    ezCompressionDictionaryZstd smallDictionary;
+    smallDictionary.CreateFromSamples(samplePtrs.GetArrayPtr().GetSubArray(0, 3), 16 * 1024);
+
+    EZ_TEST_INT(smallDictionary.GetData().GetCount(), samples[0].GetCount() + samples[1].GetCount() + samples[2].GetCount());
+    CompressAndVerify(samples[10], &smallDictionary);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(IO, CompressedStreamZstdMultiThreaded)
+{
+  ezDynamicArray<ezUInt32> TestData;
+  TestData.SetCountUninitialized(1024 * 1024 * 4);
+
+  ezRandom rnd;
+  rnd.Initialize(42);
+
+  for (ezUInt32 i = 0; i < TestData.GetCount(); ++i)
+  {
+    // compressible, but not trivially
+    TestData[i] = rnd.UIntInRange(256);
+  }
+
+  ezDefaultMemoryStreamStorage StreamStorage;
+  ezMemoryStreamWriter MemoryWriter(&StreamStorage);
+  ezMemoryStreamReader MemoryReader(&StreamStorage);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compress and Uncompress")
+  {
+    ezCompressedStreamWriterZstd CompressedWriter(&MemoryWriter, 4);
+
+    for (ezUInt32 i = 0; i < TestData.GetCount(); i += 1024 * 64)
+    {
+      EZ_TEST_BOOL(CompressedWriter.WriteBytes(&TestData[i], sizeof(ezUInt32) * 1024 * 64).Succeeded());
+    }
+
+    EZ_TEST_BOOL(CompressedWriter.FinishCompressedStream().Succeeded());
+    EZ_TEST_INT(CompressedWriter.GetUncompressedSize(), TestData.GetCount() * sizeof(ezUInt32));
+    EZ_TEST_BOOL(CompressedWriter.GetCompressedSize() < CompressedWriter.GetUncompressedSize() / 2);
+
+    ezCompressedStreamReaderZstd CompressedReader(&MemoryReader);
+
+    ezDynamicArray<ezUInt32> TestDataRead;
+    TestDataRead.SetCount(TestData.GetCount());
+    EZ_TEST_INT(CompressedReader.ReadBytes(TestDataRead.GetData(), TestDataRead.GetCount() * sizeof(ezUInt32)), TestData.GetCount() * sizeof(ezUInt32));
+    EZ_TEST_BOOL(TestData == TestDataRead);
+  }
+}
+
 #endif
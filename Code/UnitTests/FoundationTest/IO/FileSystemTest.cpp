@@ -4,6 +4,8 @@
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/Thread.h>
 
 #if EZ_ENABLED(EZ_SUPPORTS_LONG_PATHS)
 #  define LongPath                                                                                                                                   \
@@ -13,6 +15,69 @@
 #  define LongPath "AShortPathBecaueThisPlatformDoesntSupportLongOnes"
 #endif
 
+namespace
+{
+  ezAtomicBool s_bFileSystemTestReaderInside;
+  ezAtomicBool s_bFileSystemTestReleaseReader;
+  ezAtomicInteger32 s_iFileSystemTestRemovedDirs;
+  ezAtomicBool s_bFileSystemTestRemovedOnMainThread;
+
+  /// \brief Blocks every thread that checks for a file, until it gets released, so that it stays inside the file system.
+  class FileSystemTestBlockingFolderType : public ezDataDirectory::FolderType
+  {
+  public:
+    static ezDataDirectoryType* Factory(ezStringView sDataDirectory, ezStringView sGroup, ezStringView sRootName, ezFileSystem::DataDirUsage usage)
+    {
+      if (sGroup != "Blocking")
+        return nullptr;
+
+      FileSystemTestBlockingFolderType* pDataDir = EZ_DEFAULT_NEW(FileSystemTestBlockingFolderType);
+
+      if (pDataDir->InitializeDataDirectory(sDataDirectory) == EZ_SUCCESS)
+        return pDataDir;
+
+      EZ_DEFAULT_DELETE(pDataDir);
+      return nullptr;
+    }
+
+  protected:
+    virtual bool ExistsFile(ezStringView sFile, bool bOneSpecificDataDir) override
+    {
+      s_bFileSystemTestReaderInside = true;
+
+      while (!s_bFileSystemTestReleaseReader)
+      {
+        ezThreadUtils::YieldTimeSlice();
+      }
+
+      return FolderType::ExistsFile(sFile, bOneSpecificDataDir);
+    }
+
+    virtual void RemoveDataDirectory() override
+    {
+      s_bFileSystemTestRemovedOnMainThread = ezThreadUtils::IsMainThread();
+      s_iFileSystemTestRemovedDirs.Increment();
+
+      FolderType::RemoveDataDirectory();
+    }
+  };
+
+  class FileSystemTestReaderThread : public ezThread
+  {
+  public:
+    FileSystemTestReaderThread()
+      : ezThread("FileSystemTestReader")
+    {
+    }
+
+    virtual ezUInt32 Run() override
+    {
+      ezFileSystem::ExistsFile(":blocking/MultiThreaded.txt");
+      return 0;
+    }
+  };
+} // namespace
+
 EZ_CREATE_SIMPLE_TEST(IO, FileSystem)
 {
   ezStringBuilder sFileContent = "Lyrics to Taste The Cake:\n\
@@ -205,6 +270,127 @@ Only concrete and clocks.\n\
     }
   }
 
+#if EZ_ENABLED(EZ_SUPPORTS_DIRECTORY_WATCHER)
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Existence Cache")
+  {
+    ezDataDirectory::FolderType::s_bCacheFileExistence = true;
+    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder2, "Cached", "cached", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+    ezDataDirectory::FolderType::s_bCacheFileExistence = false;
+
+    const char* szCachedFile = ":cached/CachedFile.txt";
+
+    ezStringBuilder sAbs = sOutputFolder2Resolved;
+    sAbs.AppendPath("CachedFile.txt");
+
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(szCachedFile));
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(szCachedFile));
+
+    // files that are created or deleted without going through ezFileSystem are reported by the directory watcher
+    {
+      ezOSFile file;
+      EZ_TEST_BOOL(file.Open(sAbs, ezFileOpenMode::Write) == EZ_SUCCESS);
+    }
+
+    EZ_TEST_BOOL(ezFileSystem::ExistsFile(szCachedFile));
+
+    {
+      ezFileReader FileIn;
+      EZ_TEST_BOOL(FileIn.Open(szCachedFile) == EZ_SUCCESS);
+    }
+
+    EZ_TEST_BOOL(ezOSFile::DeleteFile(sAbs) == EZ_SUCCESS);
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(szCachedFile));
+
+    {
+      ezFileReader FileIn;
+      EZ_TEST_BOOL(FileIn.Open(szCachedFile) == EZ_FAILURE);
+    }
+
+    // files that are written through ezFileSystem are known right away
+    {
+      ezFileWriter FileOut;
+      EZ_TEST_BOOL(FileOut.Open(szCachedFile) == EZ_SUCCESS);
+    }
+
+    EZ_TEST_BOOL(ezFileSystem::ExistsFile(szCachedFile));
+    ezFileSystem::DeleteFile(szCachedFile);
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(szCachedFile));
+
+    EZ_TEST_INT(ezFileSystem::RemoveDataDirectoryGroup("Cached"), 1);
+  }
+#endif
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Add / Remove Data Dirs (Multi-Threaded)")
+  {
+    {
+      ezFileWriter FileOut;
+      EZ_TEST_BOOL(FileOut.Open(":output1/MultiThreaded.txt") == EZ_SUCCESS);
+      EZ_TEST_BOOL(FileOut.WriteBytes("Test", 4) == EZ_SUCCESS);
+    }
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 1;
+
+    // the first index keeps changing the data directories, while all others access files
+    ezTaskSystem::ParallelForIndexed(
+      0u, 4u, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 uiIndex = uiStartIndex; uiIndex < uiEndIndex; ++uiIndex)
+        {
+          for (ezUInt32 i = 0; i < 100; ++i)
+          {
+            if (uiIndex == 0)
+            {
+              EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder2, "MultiThreaded") == EZ_SUCCESS);
+              EZ_TEST_INT(ezFileSystem::RemoveDataDirectoryGroup("MultiThreaded"), 1);
+            }
+            else
+            {
+              EZ_TEST_BOOL(ezFileSystem::ExistsFile("MultiThreaded.txt"));
+
+              ezFileReader FileIn;
+              EZ_TEST_BOOL(FileIn.Open("MultiThreaded.txt") == EZ_SUCCESS);
+              EZ_TEST_INT(FileIn.GetFileSize(), 4);
+            }
+          }
+        } },
+      "FileSystemTestMultiThreaded", params);
+
+    ezFileSystem::DeleteFile(":output1/MultiThreaded.txt");
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Remove Data Dir While Reading")
+  {
+    s_bFileSystemTestReaderInside = false;
+    s_bFileSystemTestReleaseReader = false;
+    s_iFileSystemTestRemovedDirs = 0;
+
+    // only creates data directories for the 'Blocking' group, all others are still handled by the folder factory
+    ezFileSystem::RegisterDataDirectoryFactory(FileSystemTestBlockingFolderType::Factory, 100.0f);
+
+    EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputFolder2, "Blocking", "blocking") == EZ_SUCCESS);
+
+    FileSystemTestReaderThread reader;
+    reader.Start();
+
+    while (!s_bFileSystemTestReaderInside)
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    // the reader is inside the data directory, removing it must neither wait for the reader nor destroy it yet
+    EZ_TEST_INT(ezFileSystem::RemoveDataDirectoryGroup("Blocking"), 1);
+    EZ_TEST_BOOL(ezFileSystem::FindDataDirectoryWithRoot("blocking") == nullptr);
+    EZ_TEST_INT(s_iFileSystemTestRemovedDirs, 0);
+
+    s_bFileSystemTestReleaseReader = true;
+    reader.Join();
+
+    // the reader was the last one to leave the file system, so it destroyed the data directory on its own thread
+    EZ_TEST_INT(s_iFileSystemTestRemovedDirs, 1);
+    EZ_TEST_BOOL(!s_bFileSystemTestRemovedOnMainThread);
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "GetFileStats")
   {
     const char* szPath = ":output1/" LongPath "/FileSystemTest.txt";
@@ -3,6 +3,7 @@
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
 #include <Foundation/Memory/StackAllocator.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 struct alignas(EZ_ALIGNMENT_MINIMUM) NonAlignedVector
 {
@@ -240,4 +241,151 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
 
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ThreadCachingAllocator")
+  {
+    ezThreadCachingAllocator allocator("TestThreadCachingAllocator");
+
+    // every size class, some sizes that are passed through to the heap and alignments above the supported maximum
+    ezDynamicArray<ezUInt8*> allocations;
+    ezDynamicArray<size_t> sizes;
+
+    for (size_t uiSize = 1; uiSize <= 3 * ezMemoryPolicies::ezThreadCachingAllocation::MaxSmallSize; uiSize += (uiSize < 1024 ? 7 : 331))
+    {
+      const size_t uiAlign = (uiSize % 5 == 0) ? 64 : 16;
+
+      ezUInt8* pData = static_cast<ezUInt8*>(allocator.Allocate(uiSize, uiAlign));
+      EZ_TEST_BOOL(pData != nullptr);
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pData, uiAlign));
+
+      ezMemoryUtils::PatternFill(pData, static_cast<ezUInt8>(uiSize), uiSize);
+
+      allocations.PushBack(pData);
+      sizes.PushBack(uiSize);
+    }
+
+    for (ezUInt32 i = 0; i < allocations.GetCount(); ++i)
+    {
+      bool bIntact = true;
+      for (size_t b = 0; b < sizes[i]; ++b)
+      {
+        bIntact &= allocations[i][b] == static_cast<ezUInt8>(sizes[i]);
+      }
+
+      EZ_TEST_BOOL(bIntact);
+      allocator.Deallocate(allocations[i]);
+    }
+
+    // freed blocks are reused
+    void* pFirst = allocator.Allocate(48, 16);
+    allocator.Deallocate(pFirst);
+    void* pSecond = allocator.Allocate(48, 16);
+    EZ_TEST_BOOL(pFirst == pSecond);
+    allocator.Deallocate(pSecond);
+
+    // allocate on one thread, free on others
+    enum
+    {
+      NUM_CROSS_THREAD_ALLOCATIONS = 20000
+    };
+
+    allocations.SetCount(NUM_CROSS_THREAD_ALLOCATIONS);
+    for (ezUInt32 i = 0; i < NUM_CROSS_THREAD_ALLOCATIONS; ++i)
+    {
+      allocations[i] = static_cast<ezUInt8*>(allocator.Allocate(16 + (i % 64) * 16, 16));
+      allocations[i][0] = static_cast<ezUInt8>(i);
+    }
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 512;
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, NUM_CROSS_THREAD_ALLOCATIONS, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          EZ_TEST_INT(allocations[i][0], static_cast<ezUInt8>(i));
+          allocator.Deallocate(allocations[i]);
+
+          // and immediately reuse some of it on this thread
+          void* pTemp = allocator.Allocate(16 + (i % 64) * 16, 16);
+          allocator.Deallocate(pTemp);
+        } },
+      "TestThreadCachingAllocatorFree", params);
+
+    allocations.Clear();
+    ezMemoryPolicies::ezThreadCachingAllocation::FlushThreadCache();
+
+#if EZ_ENABLED(EZ_USE_ALLOCATION_TRACKING)
+    ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations - stats.m_uiNumDeallocations, 0);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+#endif
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "MemoryTracker")
+  {
+    using TrackedAllocator = ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking>;
+    TrackedAllocator allocator("TestMemoryTracker");
+
+    constexpr ezUInt32 NUM_ALLOCATIONS = 20000;
+    constexpr ezUInt32 ALLOCATION_SIZE = 64;
+
+    ezDynamicArray<void*> allocations;
+    allocations.SetCount(NUM_ALLOCATIONS);
+
+    // concurrent allocations are tracked exactly
+    ezTaskSystem::ParallelForIndexed(
+      0u, NUM_ALLOCATIONS, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          allocations[i] = allocator.Allocate(ALLOCATION_SIZE, 16);
+        } },
+      "TestMemoryTrackerAllocate");
+
+    ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations, NUM_ALLOCATIONS);
+    EZ_TEST_INT(stats.m_uiAllocationSize, NUM_ALLOCATIONS * ALLOCATION_SIZE);
+    EZ_TEST_INT(allocator.AllocatedSize(allocations[42]), ALLOCATION_SIZE);
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, NUM_ALLOCATIONS, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          allocator.Deallocate(allocations[i]);
+        } },
+      "TestMemoryTrackerDeallocate");
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumDeallocations, NUM_ALLOCATIONS);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+
+    // in sampling mode the stats are estimates
+    ezMemoryTracker::SetSamplingInterval(4096);
+    EZ_TEST_INT(ezMemoryTracker::GetSamplingInterval(), 4096);
+
+    for (ezUInt32 i = 0; i < NUM_ALLOCATIONS; ++i)
+    {
+      allocations[i] = allocator.Allocate(ALLOCATION_SIZE, 16);
+    }
+
+    stats = allocator.GetStats();
+    const double fExpectedSize = NUM_ALLOCATIONS * ALLOCATION_SIZE;
+    const double fExpectedCount = NUM_ALLOCATIONS;
+    EZ_TEST_DOUBLE(static_cast<double>(stats.m_uiAllocationSize), fExpectedSize, fExpectedSize * 0.25);
+    EZ_TEST_DOUBLE(static_cast<double>(stats.m_uiNumAllocations - NUM_ALLOCATIONS), fExpectedCount, fExpectedCount * 0.25);
+
+    for (ezUInt32 i = 0; i < NUM_ALLOCATIONS; ++i)
+    {
+      allocator.Deallocate(allocations[i]);
+    }
+
+    ezMemoryTracker::SetSamplingInterval(0);
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations, stats.m_uiNumDeallocations);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+  }
 }
@@ -0,0 +1,77 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Memory/VirtualPool.h>
+
+EZ_CREATE_SIMPLE_TEST(Memory, VirtualPool)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Create / Delete")
+  {
+    {
+      ezVirtualPool<ezConstructionCounter> pool(1000000);
+      EZ_TEST_INT(pool.GetCount(), 0);
+      EZ_TEST_INT(pool.GetMaxCount(), 1000000);
+      EZ_TEST_INT(pool.GetHeapMemoryUsage(), 0);
+
+      ezDynamicArray<ezConstructionCounter*> objects;
+      for (ezInt32 i = 0; i < 100000; ++i)
+      {
+        objects.PushBack(pool.Create(i));
+      }
+
+      EZ_TEST_INT(pool.GetCount(), 100000);
+      EZ_TEST_BOOL(ezConstructionCounter::HasConstructed(100000));
+
+      // objects never move
+      for (ezInt32 i = 0; i < 100000; ++i)
+      {
+        EZ_TEST_INT(objects[i]->m_iData, i);
+        EZ_TEST_INT(pool.GetIndex(objects[i]), i);
+        EZ_TEST_BOOL(pool.GetObject(i) == objects[i]);
+      }
+
+      for (ezInt32 i = 0; i < 100000; i += 2)
+      {
+        pool.Delete(objects[i]);
+      }
+
+      EZ_TEST_INT(pool.GetCount(), 50000);
+      EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50000));
+      EZ_TEST_BOOL(pool.GetObject(0) == nullptr);
+      EZ_TEST_BOOL(pool.GetObject(1) == objects[1]);
+
+      // deleted slots are reused without committing more memory
+      const ezUInt64 uiMemoryUsage = pool.GetHeapMemoryUsage();
+      ezConstructionCounter* pReused = pool.Create(42);
+      EZ_TEST_INT(pool.GetIndex(pReused) % 2, 0);
+      EZ_TEST_INT(pool.GetHeapMemoryUsage(), uiMemoryUsage);
+
+      ezUInt32 uiNumIterated = 0;
+      for (auto it = pool.GetIterator(); it.IsValid(); ++it)
+      {
+        EZ_TEST_BOOL(it->m_iData % 2 == 1 || it->m_iData == 42);
+        ++uiNumIterated;
+      }
+      EZ_TEST_INT(uiNumIterated, 50001);
+    }
+
+    EZ_TEST_BOOL(ezConstructionCounter::HasAllDestructed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Clear")
+  {
+    ezVirtualPool<ezUInt8> pool(100);
+
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      pool.Create(static_cast<ezUInt8>(i));
+    }
+
+    pool.Clear();
+    EZ_TEST_INT(pool.GetCount(), 0);
+    EZ_TEST_BOOL(!pool.GetIterator().IsValid());
+
+    ezUInt8* pObject = pool.Create(static_cast<ezUInt8>(7));
+    EZ_TEST_INT(pool.GetIndex(pObject), 0);
+    EZ_TEST_INT(*pObject, 7);
+  }
+}
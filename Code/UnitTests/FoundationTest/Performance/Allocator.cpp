@@ -0,0 +1,124 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum AllocatorPerfConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_PERF_ALLOCATIONS = 200000,
+#else
+    NUM_PERF_ALLOCATIONS = 2000000,
+#endif
+    NUM_PERF_LIVE_ALLOCATIONS_PER_TASK = 256,
+    NUM_PERF_CROSS_THREAD_ALLOCATIONS = 200000,
+  };
+
+  /// A cheap pseudo random allocation size between 8 and 512 bytes, biased towards small sizes like typical container and string allocations.
+  EZ_ALWAYS_INLINE size_t GetPerfAllocationSize(ezUInt32 i)
+  {
+    const ezUInt32 uiHash = i * 2654435761u;
+    return 8 + ((uiHash >> 8) & 0x1F) * (((uiHash >> 16) & 0x3) == 0 ? 16 : 1);
+  }
+
+  /// Allocates and frees memory from all worker threads, keeping a window of live allocations per task.
+  /// Returns the throughput in million allocations per second.
+  double MeasureAllocatorChurn(ezAllocatorBase* pAllocator)
+  {
+    ezParallelForParams params;
+    params.m_uiBinSize = 4096;
+    params.m_uiMaxTasksPerThread = 4;
+
+    ezTime t0 = ezTime::Now();
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, NUM_PERF_ALLOCATIONS, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        void* liveAllocations[NUM_PERF_LIVE_ALLOCATIONS_PER_TASK] = {};
+
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          void*& pSlot = liveAllocations[i % NUM_PERF_LIVE_ALLOCATIONS_PER_TASK];
+          pAllocator->Deallocate(pSlot);
+          pSlot = pAllocator->Allocate(GetPerfAllocationSize(i), EZ_ALIGNMENT_MINIMUM);
+        }
+
+        for (void* pPtr : liveAllocations)
+        {
+          pAllocator->Deallocate(pPtr);
+        } },
+      "PerfAllocatorChurn", params);
+
+    ezTime t1 = ezTime::Now();
+    return NUM_PERF_ALLOCATIONS / (t1 - t0).GetMicroseconds();
+  }
+
+  /// Allocates memory on all worker threads and frees it on different ones, like buffers that are handed from producers to consumers.
+  /// Returns the throughput in million allocation / deallocation pairs per second.
+  double MeasureAllocatorCrossThreadFree(ezAllocatorBase* pAllocator)
+  {
+    ezDynamicArray<void*> allocations;
+    allocations.SetCount(NUM_PERF_CROSS_THREAD_ALLOCATIONS);
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 1024;
+    params.m_uiMaxTasksPerThread = 4;
+
+    ezTime t0 = ezTime::Now();
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, NUM_PERF_CROSS_THREAD_ALLOCATIONS, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          allocations[i] = pAllocator->Allocate(GetPerfAllocationSize(i), EZ_ALIGNMENT_MINIMUM);
+        } },
+      "PerfAllocatorCrossThreadAllocate", params);
+
+    // free in a different order, so that most blocks end up on a different thread than the one that allocated them
+    ezTaskSystem::ParallelForIndexed(
+      0u, NUM_PERF_CROSS_THREAD_ALLOCATIONS, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          pAllocator->Deallocate(allocations[NUM_PERF_CROSS_THREAD_ALLOCATIONS - 1 - i]);
+        } },
+      "PerfAllocatorCrossThreadFree", params);
+
+    ezTime t1 = ezTime::Now();
+    return NUM_PERF_CROSS_THREAD_ALLOCATIONS / (t1 - t0).GetMicroseconds();
+  }
+
+  template <typename AllocationPolicy>
+  void MeasureAllocatorPolicy(const char* szPolicyName)
+  {
+    ezAllocator<AllocationPolicy, ezMemoryTrackingFlags::None> allocator(szPolicyName);
+
+    ezLog::Info("[test]Allocator {0} Churn {1} M/s", szPolicyName, ezArgF(MeasureAllocatorChurn(&allocator), 4));
+    ezLog::Info("[test]Allocator {0} Cross-Thread Free {1} M/s", szPolicyName, ezArgF(MeasureAllocatorCrossThreadFree(&allocator), 4));
+  }
+} // namespace
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, Allocator)
+{
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Heap (Multi-Threaded)")
+  {
+    MeasureAllocatorPolicy<ezMemoryPolicies::ezHeapAllocation>("Heap");
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Aligned Heap (Multi-Threaded)")
+  {
+    MeasureAllocatorPolicy<ezMemoryPolicies::ezAlignedHeapAllocation>("AlignedHeap");
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Thread Caching (Multi-Threaded)")
+  {
+    MeasureAllocatorPolicy<ezMemoryPolicies::ezThreadCachingAllocation>("ThreadCaching");
+  }
+}
@@ -1,6 +1,10 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
+#include <Foundation/Containers/ArrayMap.h>
+#include <Foundation/Containers/BTreeMap.h>
 #include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/Map.h>
+#include <Foundation/Containers/SwissHashTable.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Reflection/Reflection.h>
 #include <Foundation/Strings/String.h>
@@ -75,6 +79,159 @@ namespace
 
   ezUInt32 SomeBigObject::constructionCount = 0;
   ezUInt32 SomeBigObject::destructionCount = 0;
+
+  template <typename HashTableType>
+  void MeasureHashTable(const char* szName)
+  {
+    ezUInt32 sum = 0;
+
+    for (ezUInt32 size = 1024; size <= 1024 * 1024; size *= 4)
+    {
+      HashTableType table;
+
+      ezTime t0 = ezTime::Now();
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        table.Insert(i * 7, i);
+      }
+      ezTime t1 = ezTime::Now();
+
+      for (ezUInt32 n = 0; n < 4; ++n)
+      {
+        for (ezUInt32 i = 0; i < size; ++i)
+        {
+          sum += *table.GetValue(i * 7);
+        }
+      }
+      ezTime t2 = ezTime::Now();
+
+      for (ezUInt32 n = 0; n < 4; ++n)
+      {
+        for (ezUInt32 i = 0; i < size; ++i)
+        {
+          sum += table.Contains(i * 7 + 1) ? 1 : 0;
+        }
+      }
+      ezTime t3 = ezTime::Now();
+
+      for (auto it = table.GetIterator(); it.IsValid(); it.Next())
+      {
+        sum += it.Value();
+      }
+      ezTime t4 = ezTime::Now();
+
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        table.Remove(i * 7);
+      }
+      ezTime t5 = ezTime::Now();
+
+      const double fNsPerOp = 1000000.0 / size;
+      ezLog::Info("[test]{0} size = {1}: insert {2}ns, hit {3}ns, miss {4}ns, iterate {5}ns, remove {6}ns, memory {7}KB", szName, size,
+        ezArgF((t1 - t0).GetMilliseconds() * fNsPerOp, 2), ezArgF((t2 - t1).GetMilliseconds() * fNsPerOp / 4, 2),
+        ezArgF((t3 - t2).GetMilliseconds() * fNsPerOp / 4, 2), ezArgF((t4 - t3).GetMilliseconds() * fNsPerOp, 2),
+        ezArgF((t5 - t4).GetMilliseconds() * fNsPerOp, 2), table.GetHeapMemoryUsage() / 1024, sum);
+    }
+  }
+
+  /// Keys are inserted in a shuffled order, every second key is missing for the lookups that fail.
+  EZ_ALWAYS_INLINE ezUInt32 OrderedMapKey(ezUInt32 i, ezUInt32 uiSize) { return (ezUInt32)(((ezUInt64)i * 7919) % uiSize) * 2; }
+
+  template <typename MapType>
+  void MeasureOrderedMap(const char* szName)
+  {
+    ezUInt64 sum = 0;
+
+    for (ezUInt32 size = 1000; size <= 10000000; size *= 10)
+    {
+      MapType map;
+
+      ezTime t0 = ezTime::Now();
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        map.Insert(OrderedMapKey(i, size), i);
+      }
+      ezTime t1 = ezTime::Now();
+
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        sum += *map.GetValue(OrderedMapKey(i, size));
+      }
+      ezTime t2 = ezTime::Now();
+
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        sum += map.Contains(OrderedMapKey(i, size) + 1) ? 1 : 0;
+      }
+      ezTime t3 = ezTime::Now();
+
+      for (auto it = map.GetIterator(); it.IsValid(); it.Next())
+      {
+        sum += it.Value();
+      }
+      ezTime t4 = ezTime::Now();
+
+      const ezUInt64 uiMemory = map.GetHeapMemoryUsage();
+
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        map.Remove(OrderedMapKey(i, size));
+      }
+      ezTime t5 = ezTime::Now();
+
+      const double fNsPerOp = 1000000.0 / size;
+      ezLog::Info("[test]{0} size = {1}: insert {2}ns, hit {3}ns, miss {4}ns, iterate {5}ns, remove {6}ns, memory {7}KB", szName, size,
+        ezArgF((t1 - t0).GetMilliseconds() * fNsPerOp, 2), ezArgF((t2 - t1).GetMilliseconds() * fNsPerOp, 2),
+        ezArgF((t3 - t2).GetMilliseconds() * fNsPerOp, 2), ezArgF((t4 - t3).GetMilliseconds() * fNsPerOp, 2),
+        ezArgF((t5 - t4).GetMilliseconds() * fNsPerOp, 2), uiMemory / 1024, sum);
+    }
+  }
+
+  void MeasureArrayMap(const char* szName)
+  {
+    ezUInt64 sum = 0;
+
+    for (ezUInt32 size = 1000; size <= 10000000; size *= 10)
+    {
+      ezArrayMap<ezUInt32, ezUInt32> map;
+
+      // inserting in 10 batches, every batch gets merged into the sorted data
+      ezTime t0 = ezTime::Now();
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        map.Insert(OrderedMapKey(i, size), i);
+
+        if ((i + 1) % (size / 10) == 0)
+          map.Sort();
+      }
+      ezTime t1 = ezTime::Now();
+
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        sum += map.GetValue(map.Find(OrderedMapKey(i, size)));
+      }
+      ezTime t2 = ezTime::Now();
+
+      for (ezUInt32 i = 0; i < size; ++i)
+      {
+        sum += map.Contains(OrderedMapKey(i, size) + 1) ? 1 : 0;
+      }
+      ezTime t3 = ezTime::Now();
+
+      const ezArrayMap<ezUInt32, ezUInt32>& constMap = map;
+      for (const auto& pair : constMap)
+      {
+        sum += pair.value;
+      }
+      ezTime t4 = ezTime::Now();
+
+      const double fNsPerOp = 1000000.0 / size;
+      ezLog::Info("[test]{0} size = {1}: insert {2}ns, hit {3}ns, miss {4}ns, iterate {5}ns, memory {6}KB", szName, size,
+        ezArgF((t1 - t0).GetMilliseconds() * fNsPerOp, 2), ezArgF((t2 - t1).GetMilliseconds() * fNsPerOp, 2),
+        ezArgF((t3 - t2).GetMilliseconds() * fNsPerOp, 2), ezArgF((t4 - t3).GetMilliseconds() * fNsPerOp, 2), map.GetHeapMemoryUsage() / 1024,
+        sum);
+    }
+  }
 } // namespace
 
 // Enable when needed
@@ -423,4 +580,64 @@ EZ_CREATE_SIMPLE_TEST(Performance, Container)
         ezArgF((t1 - t0).GetMilliseconds() / static_cast<double>(NUM_SAMPLES), 4), sum);
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::DisabledNoWarning, "ezSwissHashTable<void*, ezUInt32>")
+  {
+    ezUInt32 sum = 0;
+
+    for (ezUInt32 size = 1024; size < 4096 * 32; size += 1024)
+    {
+      ezSwissHashTable<void*, ezUInt32> map;
+
+      for (ezUInt32 i = 0; i < size; i++)
+      {
+        map.Insert(malloc(64), 64);
+      }
+
+      void* ptrs[1024];
+
+      ezTime t0 = ezTime::Now();
+      for (ezUInt32 n = 0; n < NUM_SAMPLES; n++)
+      {
+
+        for (ezUInt32 i = 0; i < 1024; i++)
+        {
+          void* mem = malloc(64);
+          map.Insert(mem, 64);
+          map.Remove(mem);
+          ptrs[i] = mem;
+        }
+
+        for (ezUInt32 i = 0; i < 1024; i++)
+          free(ptrs[i]);
+
+        for (auto it = map.GetIterator(); it.IsValid(); it.Next())
+        {
+          sum += it.Value();
+        }
+      }
+      ezTime t1 = ezTime::Now();
+
+      for (auto it = map.GetIterator(); it.IsValid(); it.Next())
+      {
+        free(it.Key());
+      }
+
+      ezLog::Info("[test]ezSwissHashTable<void*, ezUInt32> size = {0} => {1}ms", size,
+        ezArgF((t1 - t0).GetMilliseconds() / static_cast<double>(NUM_SAMPLES), 4), sum);
+    }
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezHashTable vs. ezSwissHashTable")
+  {
+    MeasureHashTable<ezHashTable<ezUInt32, ezUInt32>>("ezHashTable<ezUInt32, ezUInt32>");
+    MeasureHashTable<ezSwissHashTable<ezUInt32, ezUInt32>>("ezSwissHashTable<ezUInt32, ezUInt32>");
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ezMap vs. ezBTreeMap vs. ezArrayMap")
+  {
+    MeasureOrderedMap<ezMap<ezUInt32, ezUInt32>>("ezMap<ezUInt32, ezUInt32>");
+    MeasureOrderedMap<ezBTreeMap<ezUInt32, ezUInt32>>("ezBTreeMap<ezUInt32, ezUInt32>");
+    MeasureArrayMap("ezArrayMap<ezUInt32, ezUInt32>");
+  }
 }
@@ -0,0 +1,123 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/OSFile.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum FileSystemPerfConstants
+  {
+    NUM_PERF_DATA_DIRS = 8,
+    NUM_PERF_FILES_PER_DATA_DIR = 64,
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_PERF_FILE_ACCESSES = 10000,
+#else
+    NUM_PERF_FILE_ACCESSES = 100000,
+#endif
+  };
+
+  /// Runs the given function for every file access on all worker threads and returns the throughput in thousand accesses per second.
+  template <typename Func>
+  double MeasureFileSystemAccess(Func func)
+  {
+    ezParallelForParams params;
+    params.m_uiBinSize = 256;
+    params.m_uiMaxTasksPerThread = 4;
+
+    ezTime t0 = ezTime::Now();
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, NUM_PERF_FILE_ACCESSES, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        ezStringBuilder sFile;
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          func(sFile, i);
+        } },
+      "PerfFileSystemAccess", params);
+
+    ezTime t1 = ezTime::Now();
+    return NUM_PERF_FILE_ACCESSES / (t1 - t0).GetMilliseconds();
+  }
+} // namespace
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, FileSystem)
+{
+  ezStringBuilder sOutputFolder = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  sOutputFolder.AppendPath("PerfFileSystem");
+  sOutputFolder.MakeCleanPath();
+
+  ezHybridArray<ezString, NUM_PERF_DATA_DIRS> dataDirs;
+
+  {
+    ezStringBuilder sDir, sFile;
+    for (ezUInt32 dd = 0; dd < NUM_PERF_DATA_DIRS; ++dd)
+    {
+      sDir.Format("{}/Dir{}", sOutputFolder, dd);
+      dataDirs.PushBack(sDir);
+
+      for (ezUInt32 f = 0; f < NUM_PERF_FILES_PER_DATA_DIR; ++f)
+      {
+        sFile.Format("{}/File_{}_{}.txt", sDir, dd, f);
+
+        ezOSFile file;
+        EZ_TEST_BOOL(file.Open(sFile, ezFileOpenMode::Write).Succeeded());
+        EZ_TEST_BOOL(file.Write(sFile.GetData(), sFile.GetElementCount()).Succeeded());
+      }
+    }
+  }
+
+  // every file only exists in one data directory, so most lookups go to data directories that don't have the file
+  auto openFile = [](ezStringBuilder& ref_sFile, ezUInt32 i)
+  {
+    ref_sFile.Format("File_{}_{}.txt", i % NUM_PERF_DATA_DIRS, (i / NUM_PERF_DATA_DIRS) % NUM_PERF_FILES_PER_DATA_DIR);
+
+    ezFileReader file;
+    EZ_TEST_BOOL(file.Open(ref_sFile).Succeeded());
+  };
+
+  auto existsMissingFile = [](ezStringBuilder& ref_sFile, ezUInt32 i)
+  {
+    ref_sFile.Format("Missing_{}.txt", i % NUM_PERF_FILES_PER_DATA_DIR);
+    EZ_TEST_BOOL(!ezFileSystem::ExistsFile(ref_sFile));
+  };
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Open Files (Multi-Threaded)")
+  {
+    for (const ezString& sDir : dataDirs)
+    {
+      EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sDir, "PerfFileSystem").Succeeded());
+    }
+
+    ezLog::Info("[test]FileSystem Open Files {0} K/s", ezArgF(MeasureFileSystemAccess(openFile), 4));
+    ezLog::Info("[test]FileSystem Exists Missing Files {0} K/s", ezArgF(MeasureFileSystemAccess(existsMissingFile), 4));
+
+    ezFileSystem::RemoveDataDirectoryGroup("PerfFileSystem");
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Open Files With Existence Cache (Multi-Threaded)")
+  {
+    ezDataDirectory::FolderType::s_bCacheFileExistence = true;
+
+    for (const ezString& sDir : dataDirs)
+    {
+      EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sDir, "PerfFileSystem").Succeeded());
+    }
+
+    ezDataDirectory::FolderType::s_bCacheFileExistence = false;
+
+    ezLog::Info("[test]FileSystem Open Files (Cached) {0} K/s", ezArgF(MeasureFileSystemAccess(openFile), 4));
+    ezLog::Info("[test]FileSystem Exists Missing Files (Cached) {0} K/s", ezArgF(MeasureFileSystemAccess(existsMissingFile), 4));
+
+    ezFileSystem::RemoveDataDirectoryGroup("PerfFileSystem");
+  }
+
+  ezOSFile::DeleteFolder(sOutputFolder).IgnoreResult();
+}
@@ -0,0 +1,71 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum HashedStringPerfConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_HASHED_STRINGS = 10000,
+    NUM_HASHED_STRING_ASSIGNS = 100000,
+#else
+    NUM_HASHED_STRINGS = 100000,
+    NUM_HASHED_STRING_ASSIGNS = 1000000,
+#endif
+  };
+
+  /// Assigns the given number of strings from all worker threads and returns the throughput in million assignments per second.
+  double MeasureHashedStringAssign(const ezDynamicArray<ezString>& strings, ezUInt32 uiNumAssigns)
+  {
+    ezParallelForParams params;
+    params.m_uiBinSize = 1024;
+    params.m_uiMaxTasksPerThread = 4;
+
+    ezTime t0 = ezTime::Now();
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, uiNumAssigns, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        ezHashedString sHashed;
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          sHashed.Assign(strings[i % strings.GetCount()]);
+        } },
+      "PerfHashedStringAssign", params);
+
+    ezTime t1 = ezTime::Now();
+    return uiNumAssigns / (t1 - t0).GetMicroseconds();
+  }
+} // namespace
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, HashedString)
+{
+  // a random prefix, so that repeated runs in the same process really insert new strings
+  const ezUInt32 uiRunId = static_cast<ezUInt32>(ezTime::Now().GetNanoseconds());
+
+  ezDynamicArray<ezString> strings;
+  strings.Reserve(NUM_HASHED_STRINGS);
+
+  ezStringBuilder sTemp;
+  for (ezUInt32 i = 0; i < NUM_HASHED_STRINGS; ++i)
+  {
+    sTemp.Format("PerfHashedString_{}_{}", uiRunId, i);
+    strings.PushBack(sTemp);
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Assign New Strings (Multi-Threaded)")
+  {
+    ezLog::Info("[test]HashedString Assign New Strings {0} M/s", ezArgF(MeasureHashedStringAssign(strings, NUM_HASHED_STRINGS), 4));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Assign Existing Strings (Multi-Threaded)")
+  {
+    ezLog::Info("[test]HashedString Assign Existing Strings {0} M/s", ezArgF(MeasureHashedStringAssign(strings, NUM_HASHED_STRING_ASSIGNS), 4));
+  }
+}
@@ -0,0 +1,75 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum ProfilingPerfConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_PROFILING_SCOPES = 100000,
+#else
+    NUM_PROFILING_SCOPES = 1000000,
+#endif
+  };
+
+  /// Returns the average cost of one profiling scope in nanoseconds.
+  double MeasureProfilingScopes()
+  {
+    const char* szNames[] = {"PerfScope A", "PerfScope B", "PerfScope C", "PerfScope with a name that is longer than forty characters"};
+
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 i = 0; i < NUM_PROFILING_SCOPES; ++i)
+    {
+      EZ_PROFILE_SCOPE(szNames[i & 3]);
+    }
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetNanoseconds() / NUM_PROFILING_SCOPES;
+  }
+
+  double MeasureParallelProfilingScopes()
+  {
+    ezParallelForParams params;
+    params.m_uiBinSize = NUM_PROFILING_SCOPES / 64;
+
+    ezTime t0 = ezTime::Now();
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, static_cast<ezUInt32>(NUM_PROFILING_SCOPES), [](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          EZ_PROFILE_SCOPE("PerfParallelScope");
+        } },
+      "PerfParallelProfiling", params);
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetNanoseconds() / NUM_PROFILING_SCOPES;
+  }
+} // namespace
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, Profiling)
+{
+  // record every scope, otherwise only the early out would be measured
+  ezProfilingSystem::SetDiscardThreshold(ezTime::MakeZero());
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Scopes")
+  {
+    ezLog::Info("[test]Profiling Scope {0}ns", ezArgF(MeasureProfilingScopes(), 4));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Scopes (Multi-Threaded)")
+  {
+    ezLog::Info("[test]Profiling Scope (Multi-Threaded) {0}ns", ezArgF(MeasureParallelProfilingScopes(), 4));
+  }
+
+  ezProfilingSystem::SetDiscardThreshold(ezTime::MakeFromMilliseconds(0.1));
+  ezProfilingSystem::Clear();
+}
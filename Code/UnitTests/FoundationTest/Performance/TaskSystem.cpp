@@ -0,0 +1,405 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Threading/TaskCoroutine.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum TaskSystemConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_TASK_SAMPLES = 8,
+    NUM_ROOT_TASKS = 64,
+    NUM_CHILD_TASKS = 64,
+    CHAIN_LENGTH = 128,
+#else
+    NUM_TASK_SAMPLES = 32,
+    NUM_ROOT_TASKS = 128,
+    NUM_CHILD_TASKS = 128,
+    CHAIN_LENGTH = 512,
+#endif
+  };
+
+  class ezPerfTestLeafTask final : public ezTask
+  {
+  public:
+    ezPerfTestLeafTask() { ConfigureTask("LeafTask", ezTaskNesting::Never); }
+
+    mutable ezUInt32 m_uiResult = 0;
+
+  private:
+    virtual void Execute() override { ExecuteWithMultiplicity(0); }
+
+    virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+    {
+      // a tiny amount of work, so that the scheduling overhead dominates
+      ezUInt32 x = uiInvocation + 1;
+      for (ezUInt32 i = 0; i < 64; ++i)
+      {
+        x = x * 1664525u + 1013904223u;
+      }
+
+      m_uiResult = x;
+    }
+  };
+
+  /// Schedules many small tasks from within a task and waits for them, the typical pattern of fine-grained parallel code.
+  class ezPerfTestSpawnTask final : public ezTask
+  {
+  public:
+    ezPerfTestSpawnTask() { ConfigureTask("SpawnTask", ezTaskNesting::Maybe); }
+
+  private:
+    virtual void Execute() override
+    {
+      ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+      for (ezUInt32 i = 0; i < NUM_CHILD_TASKS; ++i)
+      {
+        ezTaskSystem::AddTaskToGroup(group, EZ_DEFAULT_NEW(ezPerfTestLeafTask));
+      }
+
+      ezTaskSystem::StartTaskGroup(group);
+      ezTaskSystem::WaitForGroup(group);
+    }
+  };
+
+  double MeasureNestedTasks()
+  {
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 n = 0; n < NUM_TASK_SAMPLES; ++n)
+    {
+      ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+      for (ezUInt32 i = 0; i < NUM_ROOT_TASKS; ++i)
+      {
+        ezTaskSystem::AddTaskToGroup(group, EZ_DEFAULT_NEW(ezPerfTestSpawnTask));
+      }
+
+      ezTaskSystem::StartTaskGroup(group);
+      ezTaskSystem::WaitForGroup(group);
+    }
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetMilliseconds() / static_cast<double>(NUM_TASK_SAMPLES);
+  }
+
+  double MeasureParallelFor()
+  {
+    ezDynamicArray<ezUInt32> data;
+    data.SetCount(NUM_ROOT_TASKS * NUM_CHILD_TASKS * 16);
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 64;
+    params.m_uiMaxTasksPerThread = 8;
+
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 n = 0; n < NUM_TASK_SAMPLES; ++n)
+    {
+      ezTaskSystem::ParallelFor<ezUInt32>(
+        data.GetArrayPtr(), [](ezArrayPtr<ezUInt32> slice)
+        {
+          for (ezUInt32& value : slice)
+          {
+            value = value * 1664525u + 1013904223u;
+          } },
+        "PerfParallelFor", params);
+    }
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetMilliseconds() / static_cast<double>(NUM_TASK_SAMPLES);
+  }
+
+  double MeasureUnevenParallelFor(ezParallelForMode::Enum mode)
+  {
+    ezDynamicArray<ezUInt32> data;
+    data.SetCount(NUM_ROOT_TASKS * NUM_CHILD_TASKS * 4);
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 16;
+    params.m_Mode = mode;
+
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 n = 0; n < NUM_TASK_SAMPLES; ++n)
+    {
+      // most items are trivial, but the last few percent are very expensive
+      ezTaskSystem::ParallelForIndexed(
+        0u, data.GetCount(), [&data](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+        {
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            const ezUInt32 uiWork = (i * 32 >= data.GetCount() * 31) ? 256 : 1;
+            for (ezUInt32 w = 0; w < uiWork; ++w)
+            {
+              data[i] = data[i] * 1664525u + 1013904223u;
+            }
+          } },
+        "PerfUnevenParallelFor", params);
+    }
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetMilliseconds() / static_cast<double>(NUM_TASK_SAMPLES);
+  }
+
+  double MeasureParallelReduce(ezParallelForMode::Enum mode)
+  {
+    ezDynamicArray<float> data;
+    data.SetCount(NUM_ROOT_TASKS * NUM_CHILD_TASKS * 16);
+    for (ezUInt32 i = 0; i < data.GetCount(); ++i)
+    {
+      data[i] = static_cast<float>(i % 17);
+    }
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 256;
+    params.m_Mode = mode;
+
+    float fSum = 0.0f;
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 n = 0; n < NUM_TASK_SAMPLES; ++n)
+    {
+      fSum += ezTaskSystem::ParallelReduce(
+        0u, data.GetCount(), 0.0f, [&data](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+        {
+          float fPartialSum = 0.0f;
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            fPartialSum += data[i];
+          }
+          return fPartialSum; },
+        [](float a, float b)
+        { return a + b; },
+        "PerfParallelReduce", params);
+    }
+
+    ezTime t1 = ezTime::Now();
+    EZ_TEST_BOOL(fSum > 0.0f);
+    return (t1 - t0).GetMilliseconds() / static_cast<double>(NUM_TASK_SAMPLES);
+  }
+
+  ezUInt32 ChainWork(ezUInt32 uiValue)
+  {
+    for (ezUInt32 i = 0; i < 1024; ++i)
+    {
+      uiValue = uiValue * 1664525u + 1013904223u;
+    }
+
+    return uiValue;
+  }
+
+  /// One link of a dependency chain, that blocks its thread until the previous link has finished.
+  class ezPerfTestBlockingChainTask final : public ezTask
+  {
+  public:
+    ezPerfTestBlockingChainTask(ezTaskGroupID previous, ezUInt32* pResult)
+      : m_Previous(previous)
+      , m_pResult(pResult)
+    {
+      ConfigureTask("BlockingChainTask", ezTaskNesting::Maybe);
+    }
+
+  private:
+    virtual void Execute() override
+    {
+      if (m_Previous.IsValid())
+      {
+        ezTaskSystem::WaitForGroup(m_Previous);
+      }
+
+      *m_pResult = ChainWork(*m_pResult);
+    }
+
+    ezTaskGroupID m_Previous;
+    ezUInt32* m_pResult = nullptr;
+  };
+
+  /// One link of a dependency chain, that doesn't wait at all, the task system only schedules it once the previous link has finished.
+  class ezPerfTestChainTask final : public ezTask
+  {
+  public:
+    ezPerfTestChainTask(ezUInt32* pResult)
+      : m_pResult(pResult)
+    {
+      ConfigureTask("ChainTask", ezTaskNesting::Never);
+    }
+
+  private:
+    virtual void Execute() override { *m_pResult = ChainWork(*m_pResult); }
+
+    ezUInt32* m_pResult = nullptr;
+  };
+
+  double MeasureBlockingChain()
+  {
+    ezUInt32 uiResult = 0;
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 n = 0; n < NUM_TASK_SAMPLES; ++n)
+    {
+      // all links are started right away, each one blocks a thread until its predecessor is done
+      ezTaskGroupID previous;
+      for (ezUInt32 i = 0; i < CHAIN_LENGTH; ++i)
+      {
+        previous = ezTaskSystem::StartSingleTask(EZ_DEFAULT_NEW(ezPerfTestBlockingChainTask, previous, &uiResult), ezTaskPriority::LongRunning);
+      }
+
+      ezTaskSystem::WaitForGroup(previous);
+    }
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetMilliseconds() / static_cast<double>(NUM_TASK_SAMPLES);
+  }
+
+  double MeasureDependencyChain()
+  {
+    ezUInt32 uiResult = 0;
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 n = 0; n < NUM_TASK_SAMPLES; ++n)
+    {
+      ezTaskGroupID previous;
+      for (ezUInt32 i = 0; i < CHAIN_LENGTH; ++i)
+      {
+        if (previous.IsValid())
+          previous = ezTaskSystem::StartSingleTask(EZ_DEFAULT_NEW(ezPerfTestChainTask, &uiResult), ezTaskPriority::LongRunning, previous);
+        else
+          previous = ezTaskSystem::StartSingleTask(EZ_DEFAULT_NEW(ezPerfTestChainTask, &uiResult), ezTaskPriority::LongRunning);
+      }
+
+      ezTaskSystem::WaitForGroup(previous);
+    }
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetMilliseconds() / static_cast<double>(NUM_TASK_SAMPLES);
+  }
+
+#if EZ_ENABLED(EZ_TASKSYSTEM_COROUTINES)
+  ezTaskCoroutine CoroutineChainLink(ezTaskGroupID previous, ezUInt32* pResult)
+  {
+    co_await previous;
+    *pResult = ChainWork(*pResult);
+  }
+
+  ezTaskCoroutine CoroutineChain(ezUInt32 uiRemainingLinks, ezUInt32* pResult)
+  {
+    *pResult = ChainWork(*pResult);
+
+    if (uiRemainingLinks > 1)
+    {
+      co_await CoroutineChain(uiRemainingLinks - 1, pResult);
+    }
+  }
+
+  double MeasureCoroutineChain()
+  {
+    ezUInt32 uiResult = 0;
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 n = 0; n < NUM_TASK_SAMPLES; ++n)
+    {
+      // all links are started right away, but they only suspend while they wait for their predecessor
+      ezTaskGroupID previous;
+      for (ezUInt32 i = 0; i < CHAIN_LENGTH; ++i)
+      {
+        previous = CoroutineChainLink(previous, &uiResult).Start(ezTaskPriority::LongRunning);
+      }
+
+      ezTaskSystem::WaitForGroup(previous);
+    }
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetMilliseconds() / static_cast<double>(NUM_TASK_SAMPLES);
+  }
+
+  double MeasureNestedCoroutineChain()
+  {
+    ezUInt32 uiResult = 0;
+    ezTime t0 = ezTime::Now();
+
+    for (ezUInt32 n = 0; n < NUM_TASK_SAMPLES; ++n)
+    {
+      // each link awaits the next one, so the chain is as deep as the number of links
+      ezTaskSystem::WaitForGroup(CoroutineChain(CHAIN_LENGTH, &uiResult).Start(ezTaskPriority::LongRunning));
+    }
+
+    ezTime t1 = ezTime::Now();
+    return (t1 - t0).GetMilliseconds() / static_cast<double>(NUM_TASK_SAMPLES);
+  }
+#endif
+} // namespace
+
+#define EZ_PERFORMANCE_TESTS_STATE ezTestBlock::DisabledNoWarning
+
+EZ_CREATE_SIMPLE_TEST(Performance, TaskSystem)
+{
+  const ezTaskSchedulingMode::Enum previousMode = ezTaskSystem::GetSchedulingMode();
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Nested Tasks (Global Queue)")
+  {
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::GlobalQueue);
+    ezLog::Info("[test]Nested Tasks (Global Queue) {0}ms", ezArgF(MeasureNestedTasks(), 4));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Nested Tasks (Work-Stealing)")
+  {
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::WorkStealing);
+    ezLog::Info("[test]Nested Tasks (Work-Stealing) {0}ms", ezArgF(MeasureNestedTasks(), 4));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ParallelFor (Global Queue)")
+  {
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::GlobalQueue);
+    ezLog::Info("[test]ParallelFor (Global Queue) {0}ms", ezArgF(MeasureParallelFor(), 4));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ParallelFor (Work-Stealing)")
+  {
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::WorkStealing);
+    ezLog::Info("[test]ParallelFor (Work-Stealing) {0}ms", ezArgF(MeasureParallelFor(), 4));
+  }
+
+  ezTaskSystem::SetSchedulingMode(previousMode);
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Uneven ParallelFor (Static)")
+  {
+    ezLog::Info("[test]Uneven ParallelFor (Static) {0}ms", ezArgF(MeasureUnevenParallelFor(ezParallelForMode::Static), 4));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Uneven ParallelFor (Adaptive)")
+  {
+    ezLog::Info("[test]Uneven ParallelFor (Adaptive) {0}ms", ezArgF(MeasureUnevenParallelFor(ezParallelForMode::Adaptive), 4));
+  }
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "ParallelReduce")
+  {
+    ezLog::Info("[test]ParallelReduce (Static) {0}ms", ezArgF(MeasureParallelReduce(ezParallelForMode::Static), 4));
+    ezLog::Info("[test]ParallelReduce (Adaptive) {0}ms", ezArgF(MeasureParallelReduce(ezParallelForMode::Adaptive), 4));
+  }
+
+  // the blocking chain makes the task system allocate additional worker threads, so it runs last
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Deep Dependency Chain (Group Dependencies)")
+  {
+    ezLog::Info("[test]Deep Dependency Chain (Group Dependencies) {0}ms", ezArgF(MeasureDependencyChain(), 4));
+  }
+
+#if EZ_ENABLED(EZ_TASKSYSTEM_COROUTINES)
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Deep Dependency Chain (Coroutines)")
+  {
+    ezLog::Info("[test]Deep Dependency Chain (Coroutines) {0}ms", ezArgF(MeasureCoroutineChain(), 4));
+    ezLog::Info("[test]Deep Dependency Chain (Nested Coroutines) {0}ms", ezArgF(MeasureNestedCoroutineChain(), 4));
+    ezLog::Info("[test]Allocated long task workers: {0}", ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::LongTasks));
+  }
+#endif
+
+  EZ_TEST_BLOCK(EZ_PERFORMANCE_TESTS_STATE, "Deep Dependency Chain (Blocking Waits)")
+  {
+    ezLog::Info("[test]Deep Dependency Chain (Blocking Waits) {0}ms", ezArgF(MeasureBlockingChain(), 4));
+    ezLog::Info("[test]Allocated long task workers: {0}", ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::LongTasks));
+  }
+}
@@ -1,7 +1,9 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/JSONReader.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/ThreadUtils.h>
 
@@ -52,4 +54,158 @@ EZ_CREATE_SIMPLE_TEST(Profiling, Profiling)
 
     WriteOutProfilingCapture(":output/profilingScopes.json");
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Interned Names")
+  {
+    ezProfilingSystem::Clear();
+    ezProfilingSystem::SetDiscardThreshold(ezTime::MakeZero());
+
+    // the same memory is used for different names, which must not be mixed up
+    ezStringBuilder sName;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      sName.Format("Interned scope {} with a name that is longer than forty characters", i);
+      EZ_PROFILE_SCOPE(sName);
+    }
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      EZ_PROFILE_SCOPE("Interned scope");
+    }
+
+    ezProfilingSystem::SetDiscardThreshold(ezTime::MakeFromMilliseconds(0.1));
+
+    ezProfilingSystem::ProfilingData profilingData;
+    ezProfilingSystem::Capture(profilingData);
+
+    EZ_TEST_BOOL(!profilingData.m_ScopeNames.IsEmpty());
+    EZ_TEST_BOOL(profilingData.m_ScopeNames[0].IsEmpty());
+
+    ezUInt32 uiLongNameCounts[4] = {};
+    ezUInt32 uiShortNameCount = 0;
+    ezUInt32 uiShortNameId = 0;
+
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        if (!EZ_TEST_BOOL(scope.m_uiNameId < profilingData.m_ScopeNames.GetCount()))
+          continue;
+
+        const ezString& sScopeName = profilingData.m_ScopeNames[scope.m_uiNameId];
+
+        for (ezUInt32 i = 0; i < 4; ++i)
+        {
+          sName.Format("Interned scope {} with a name that is longer than forty characters", i);
+          if (sScopeName == sName)
+          {
+            ++uiLongNameCounts[i];
+          }
+        }
+
+        if (sScopeName == "Interned scope")
+        {
+          ++uiShortNameCount;
+          EZ_TEST_BOOL(uiShortNameId == 0 || uiShortNameId == scope.m_uiNameId);
+          uiShortNameId = scope.m_uiNameId;
+        }
+      }
+    }
+
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      EZ_TEST_INT(uiLongNameCounts[i], 1);
+    }
+
+    EZ_TEST_INT(uiShortNameCount, 4);
+
+    // merging remaps the name IDs
+    ezProfilingSystem::ProfilingData emptyData;
+    emptyData.m_ScopeNames.PushBack(ezString());
+    emptyData.m_ScopeNames.PushBack("Some other name");
+
+    const ezProfilingSystem::ProfilingData* inputs[] = {&emptyData, &profilingData};
+    ezProfilingSystem::ProfilingData mergedData;
+    ezProfilingSystem::ProfilingData::Merge(mergedData, ezMakeArrayPtr(inputs));
+
+    ezUInt32 uiMergedShortNameCount = 0;
+    for (const auto& eventBuffer : mergedData.m_AllEventBuffers)
+    {
+      for (const auto& scope : eventBuffer.m_Data)
+      {
+        if (mergedData.m_ScopeNames[scope.m_uiNameId] == "Interned scope")
+        {
+          ++uiMergedShortNameCount;
+        }
+      }
+    }
+
+    EZ_TEST_INT(uiMergedShortNameCount, 4);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Streaming")
+  {
+    if (ezFileSystem::FindDataDirectoryWithRoot("output") == nullptr)
+    {
+      ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+      EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(outputPath.GetData(), "test", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+    }
+
+    EZ_TEST_BOOL(!ezProfilingSystem::IsStreaming());
+    EZ_TEST_BOOL(ezProfilingSystem::StartStreaming(":output/profilingStream.json").Succeeded());
+    EZ_TEST_BOOL(ezProfilingSystem::IsStreaming());
+
+    const char* szLongName = "Streamed scope with a name that is a lot longer than forty characters";
+
+    ezProfilingSystem::StartNewFrame();
+
+    {
+      EZ_PROFILE_SCOPE(szLongName);
+      ezThreadUtils::Sleep(ezTime::MakeFromMilliseconds(1));
+    }
+
+    ezProfilingSystem::FlushStreaming();
+
+    ezProfilingSystem::InitializeGPUData(1);
+    ezProfilingSystem::AddGPUScope("Streamed GPU scope", ezTime::Now(), ezTime::Now() + ezTime::MakeFromMilliseconds(1));
+
+    ezProfilingSystem::StartNewFrame();
+    ezProfilingSystem::StopStreaming();
+    EZ_TEST_BOOL(!ezProfilingSystem::IsStreaming());
+
+    ezFileReader fileReader;
+    EZ_TEST_BOOL(fileReader.Open(":output/profilingStream.json").Succeeded());
+
+    ezJSONReader jsonReader;
+    EZ_TEST_BOOL(jsonReader.Parse(fileReader).Succeeded());
+    EZ_TEST_BOOL(jsonReader.GetTopLevelElementType() == ezJSONReader::ElementType::Array);
+
+    bool bFoundLongScope = false;
+    bool bFoundGpuScope = false;
+    bool bFoundFrame = false;
+    bool bFoundMainThread = false;
+
+    for (const ezVariant& event : jsonReader.GetTopLevelArray())
+    {
+      const ezVariantDictionary& values = event.Get<ezVariantDictionary>();
+      const ezString sName = values.GetValue("name")->Get<ezString>();
+      const ezString sPhase = values.GetValue("ph")->Get<ezString>();
+
+      if (sPhase == "X")
+      {
+        bFoundLongScope |= (sName == szLongName);
+        bFoundGpuScope |= (sName == "Streamed GPU scope" && values.GetValue("tid")->ConvertTo<ezUInt64>() == 1);
+        bFoundFrame |= sName.StartsWith("Frame ");
+      }
+      else if (sPhase == "M" && sName == "thread_name")
+      {
+        bFoundMainThread |= (values.GetValue("args")->Get<ezVariantDictionary>().GetValue("name")->Get<ezString>() == "Main Thread");
+      }
+    }
+
+    EZ_TEST_BOOL(bFoundLongScope);
+    EZ_TEST_BOOL(bFoundGpuScope);
+    EZ_TEST_BOOL(bFoundFrame);
+    EZ_TEST_BOOL(bFoundMainThread);
+  }
 }
@@ -344,6 +344,19 @@ EZ_CREATE_SIMPLE_TEST(Threading, Atomics)
     EZ_TEST_INT(g_iPostDecVariable64, -1);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Relaxed Byte Access")
+  {
+    ezUInt8 bytes[4] = {1, 2, 3, 4};
+
+    ezAtomicUtils::SetRelaxed(bytes[1], 0xFF);
+    EZ_TEST_INT(ezAtomicUtils::ReadRelaxed(bytes[1]), 0xFF);
+
+    // neighboring bytes are not touched
+    EZ_TEST_INT(ezAtomicUtils::ReadRelaxed(bytes[0]), 1);
+    EZ_TEST_INT(ezAtomicUtils::ReadRelaxed(bytes[2]), 3);
+    EZ_TEST_INT(bytes[3], 4);
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Post Increment Atomics")
   {
 
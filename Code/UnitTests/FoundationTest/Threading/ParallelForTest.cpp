@@ -1,5 +1,6 @@
 #include <FoundationTest/FoundationTestPCH.h>
 
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/StaticArray.h>
 #include <Foundation/Threading/TaskSystem.h>
 
@@ -212,4 +213,161 @@ EZ_CREATE_SIMPLE_TEST(Threading, ParallelFor)
     // check the resulting sum
     EZ_TEST_INT(uiNumbersSum, 4 * uiNumbersCheckSum);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Adaptive)")
+  {
+    ezParallelForParams adaptiveParams;
+    adaptiveParams.m_Mode = ezParallelForMode::Adaptive;
+
+    // items with very uneven cost, every index must be visited exactly once
+    ezDynamicArray<ezUInt32> visited;
+    visited.SetCount(20000);
+    ezDynamicArray<ezUInt32> results;
+    results.SetCount(visited.GetCount());
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, visited.GetCount(),
+      [&visited, &results](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 uiIndex = uiStartIndex; uiIndex < uiEndIndex; ++uiIndex)
+        {
+          ezUInt32 uiValue = uiIndex;
+          const ezUInt32 uiWork = (uiIndex % 1000 == 0) ? 20000 : 10;
+          for (ezUInt32 i = 0; i < uiWork; ++i)
+          {
+            uiValue = uiValue * 1664525u + 1013904223u;
+          }
+
+          results[uiIndex] = uiValue;
+          visited[uiIndex] += 1;
+        }
+      },
+      "ParallelForIndexed Adaptive Test", adaptiveParams);
+
+    ezUInt32 uiNumVisitedOnce = 0;
+    for (ezUInt32 uiVisited : visited)
+    {
+      uiNumVisitedOnce += (uiVisited == 1) ? 1 : 0;
+    }
+
+    EZ_TEST_INT(uiNumVisitedOnce, visited.GetCount());
+
+    ezTaskSystem::ParallelForSingleIndex(
+      visited.GetArrayPtr(),
+      [](ezUInt32 uiIndex, ezUInt32& ref_uiValue) { ref_uiValue = uiIndex; },
+      "ParallelFor Array Adaptive Test", adaptiveParams);
+
+    ezUInt32 uiNumCorrect = 0;
+    for (ezUInt32 i = 0; i < visited.GetCount(); ++i)
+    {
+      uiNumCorrect += (visited[i] == i) ? 1 : 0;
+    }
+
+    EZ_TEST_INT(uiNumCorrect, visited.GetCount());
+
+    // callbacks that wait for other tasks need the nesting mode that the caller requested
+    adaptiveParams.m_NestingMode = ezTaskNesting::Maybe;
+
+    ezAtomicInteger32 iNumInnerItems;
+    ezTaskSystem::ParallelFor(
+      visited.GetArrayPtr(),
+      [&iNumInnerItems](ezArrayPtr<ezUInt32> outerSlice) {
+        ezParallelForParams innerParams;
+        innerParams.m_Mode = ezParallelForMode::Adaptive;
+
+        ezTaskSystem::ParallelForIndexed(
+          0u, outerSlice.GetCount(),
+          [&iNumInnerItems](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { iNumInnerItems.Add(static_cast<ezInt32>(uiEndIndex - uiStartIndex)); },
+          "ParallelFor Adaptive Inner Test", innerParams);
+      },
+      "ParallelFor Adaptive Nested Test", adaptiveParams);
+
+    EZ_TEST_INT(iNumInnerItems, static_cast<ezInt32>(visited.GetCount()));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel Reduce")
+  {
+    ResetSharedVariables();
+
+    for (ezParallelForMode::Enum mode : {ezParallelForMode::Static, ezParallelForMode::Adaptive})
+    {
+      ezParallelForParams reduceParams;
+      reduceParams.m_uiBinSize = 7;
+      reduceParams.m_Mode = mode;
+
+      const ezUInt32 uiSum = ezTaskSystem::ParallelReduce(
+        0u, numbers.GetCount(), 0u,
+        [&numbers](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          ezUInt32 uiPartialSum = 0;
+          for (ezUInt32 uiIndex = uiStartIndex; uiIndex < uiEndIndex; ++uiIndex)
+          {
+            uiPartialSum += numbers[uiIndex];
+          }
+          return uiPartialSum;
+        },
+        [](ezUInt32 a, ezUInt32 b) { return a + b; }, "ParallelReduce Test", reduceParams);
+
+      EZ_TEST_INT(uiSum, uiNumbersCheckSum);
+
+      // not commutative: the partial results must be combined in order
+      const ezUInt32 uiNumbers = ezTaskSystem::ParallelReduce(
+        0u, numbers.GetCount(), ezUInt32(0),
+        [](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { return (uiStartIndex << 16) | uiEndIndex; },
+        [](ezUInt32 a, ezUInt32 b) {
+          EZ_TEST_INT(a & 0xFFFF, b >> 16);
+          return (a & 0xFFFF0000) | (b & 0xFFFF);
+        },
+        "ParallelReduce Order Test", reduceParams);
+
+      EZ_TEST_INT(uiNumbers, numbers.GetCount());
+
+      EZ_TEST_INT(ezTaskSystem::ParallelReduce(
+                    0u, 0u, 42u, [](ezUInt32, ezUInt32) { return 0u; }, [](ezUInt32 a, ezUInt32 b) { return a + b; }, nullptr, reduceParams),
+        42);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel Scan")
+  {
+    for (ezParallelForMode::Enum mode : {ezParallelForMode::Static, ezParallelForMode::Adaptive})
+    {
+      for (ezUInt32 uiNumItems : {1u, 2u, 7u, 100u, 1001u})
+      {
+        ezParallelForParams scanParams;
+        scanParams.m_uiBinSize = 3;
+        scanParams.m_Mode = mode;
+
+        ezDynamicArray<ezUInt32> values;
+        values.SetCount(uiNumItems);
+        for (ezUInt32 i = 0; i < uiNumItems; ++i)
+        {
+          values[i] = i + 1;
+        }
+
+        ezTaskSystem::ParallelInclusiveScan(values.GetArrayPtr(), [](ezUInt32 a, ezUInt32 b) { return a + b; }, "ParallelScan Test", scanParams);
+
+        ezUInt32 uiNumCorrect = 0;
+        for (ezUInt32 i = 0; i < uiNumItems; ++i)
+        {
+          uiNumCorrect += (values[i] == (i + 1) * (i + 2) / 2) ? 1 : 0;
+        }
+
+        EZ_TEST_INT(uiNumCorrect, uiNumItems);
+
+        for (ezUInt32 i = 0; i < uiNumItems; ++i)
+        {
+          values[i] = i + 1;
+        }
+
+        ezTaskSystem::ParallelExclusiveScan(values.GetArrayPtr(), 10u, [](ezUInt32 a, ezUInt32 b) { return a + b; }, "ParallelScan Test", scanParams);
+
+        uiNumCorrect = 0;
+        for (ezUInt32 i = 0; i < uiNumItems; ++i)
+        {
+          uiNumCorrect += (values[i] == 10 + i * (i + 1) / 2) ? 1 : 0;
+        }
+
+        EZ_TEST_INT(uiNumCorrect, uiNumItems);
+      }
+    }
+  }
 }
@@ -2,6 +2,8 @@
 
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/TaskCoroutine.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Utilities/DGMLWriter.h>
@@ -66,6 +68,42 @@ private:
   }
 };
 
+class ezCountingTestTask final : public ezTask
+{
+public:
+  ezAtomicInteger32* m_pCounter = nullptr;
+
+  ezCountingTestTask() { ConfigureTask("ezCountingTestTask", ezTaskNesting::Never); }
+
+private:
+  virtual void Execute() override { m_pCounter->Increment(); }
+};
+
+class ezSpawningTestTask final : public ezTask
+{
+public:
+  ezAtomicInteger32* m_pCounter = nullptr;
+  ezUInt32 m_uiNumChildTasks = 0;
+
+  ezSpawningTestTask() { ConfigureTask("ezSpawningTestTask", ezTaskNesting::Maybe); }
+
+private:
+  virtual void Execute() override
+  {
+    ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+    for (ezUInt32 i = 0; i < m_uiNumChildTasks; ++i)
+    {
+      ezSharedPtr<ezCountingTestTask> pTask = EZ_DEFAULT_NEW(ezCountingTestTask);
+      pTask->m_pCounter = m_pCounter;
+      ezTaskSystem::AddTaskToGroup(group, pTask);
+    }
+
+    ezTaskSystem::StartTaskGroup(group);
+    ezTaskSystem::WaitForGroup(group);
+  }
+};
+
 class TaskCallbacks
 {
 public:
@@ -76,6 +114,32 @@ public:
   ezAtomicInteger32* m_pInt;
 };
 
+#if EZ_ENABLED(EZ_TASKSYSTEM_COROUTINES)
+
+static ezTaskCoroutine ezTestCoroutineStep(ezAtomicInteger32* pCounter, ezInt32 iExpectedValue)
+{
+  // the steps of a chain must run strictly one after another
+  EZ_TEST_INT(pCounter->Increment(), iExpectedValue + 1);
+  co_return;
+}
+
+static ezTaskCoroutine ezTestCoroutine(ezTaskGroupID dependency, ezAtomicInteger32* pCounter)
+{
+  co_await dependency;
+
+  EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(dependency));
+
+  for (ezInt32 i = 0; i < 10; ++i)
+  {
+    co_await ezTestCoroutineStep(pCounter, i);
+  }
+
+  // awaiting a group that is already finished doesn't suspend
+  co_await dependency;
+}
+
+#endif
+
 EZ_CREATE_SIMPLE_TEST(Threading, TaskSystem)
 {
   ezInt8 iWorkersShort = 4;
@@ -550,6 +614,231 @@ EZ_CREATE_SIMPLE_TEST(Threading, TaskSystem)
     EZ_TEST_BOOL(t[2]->IsMultiplicityDone());
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Many Small Groups with Dependencies")
+  {
+    // diamond shaped graphs, the groups are started in reverse order, so most dependencies are still pending when they are added
+    ezAtomicInteger32 iExecuted = 0;
+    ezHybridArray<ezTaskGroupID, 64> finalGroups;
+
+    for (ezUInt32 iteration = 0; iteration < 200; ++iteration)
+    {
+      ezTaskGroupID root = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+      ezTaskGroupID middle[4];
+      ezTaskGroupID final = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(middle); ++i)
+      {
+        middle[i] = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+        ezTaskSystem::AddTaskGroupDependency(middle[i], root);
+        ezTaskSystem::AddTaskGroupDependency(final, middle[i]);
+      }
+
+      for (ezTaskGroupID group : {root, middle[0], middle[1], middle[2], middle[3], final})
+      {
+        ezSharedPtr<ezCountingTestTask> pTask = EZ_DEFAULT_NEW(ezCountingTestTask);
+        pTask->m_pCounter = &iExecuted;
+        ezTaskSystem::AddTaskToGroup(group, pTask);
+      }
+
+      ezTaskSystem::StartTaskGroup(final);
+      ezTaskSystem::StartTaskGroupBatch(ezMakeArrayPtr(middle));
+      ezTaskSystem::StartTaskGroup(root);
+
+      finalGroups.PushBack(final);
+
+      if (finalGroups.GetCount() == finalGroups.GetCapacity())
+      {
+        for (ezTaskGroupID group : finalGroups)
+        {
+          ezTaskSystem::WaitForGroup(group);
+        }
+
+        finalGroups.Clear();
+      }
+    }
+
+    for (ezTaskGroupID group : finalGroups)
+    {
+      ezTaskSystem::WaitForGroup(group);
+    }
+
+    EZ_TEST_INT(iExecuted, 200 * 6);
+  }
+
+#if EZ_ENABLED(EZ_TASKSYSTEM_COROUTINES)
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Coroutines")
+  {
+    ezSharedPtr<ezTestTask> pTask = EZ_DEFAULT_NEW(ezTestTask);
+    pTask->m_uiIterations = 10;
+
+    ezTaskGroupID taskGroup = ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::LongRunning);
+
+    ezAtomicInteger32 iCounter[4];
+    ezTaskGroupID coroutineGroups[4];
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(coroutineGroups); ++i)
+    {
+      coroutineGroups[i] = ezTestCoroutine(taskGroup, &iCounter[i]).Start(i < 2 ? ezTaskPriority::ThisFrame : ezTaskPriority::LongRunning);
+    }
+
+    // other groups can depend on a coroutine, like on any other group
+    ezSharedPtr<ezTestTask> pAfterTask = EZ_DEFAULT_NEW(ezTestTask);
+    pAfterTask->m_uiIterations = 1;
+    ezTaskGroupID afterGroup = ezTaskSystem::StartSingleTask(pAfterTask, ezTaskPriority::ThisFrame, coroutineGroups[0]);
+
+    ezTaskSystem::WaitForGroup(afterGroup);
+    EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(coroutineGroups[0]));
+    EZ_TEST_INT(iCounter[0], 10);
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(coroutineGroups); ++i)
+    {
+      ezTaskSystem::WaitForGroup(coroutineGroups[i]);
+      EZ_TEST_INT(iCounter[i], 10);
+    }
+
+    EZ_TEST_BOOL(pTask->IsDone());
+    EZ_TEST_BOOL(pAfterTask->IsDone());
+  }
+#endif
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Work-Stealing Scheduling")
+  {
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::WorkStealing);
+    EZ_TEST_BOOL(ezTaskSystem::GetSchedulingMode() == ezTaskSchedulingMode::WorkStealing);
+
+    // tasks that are started from within other tasks end up in the local queues of the worker threads
+    {
+      ezAtomicInteger32 iExecuted = 0;
+
+      ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+      for (ezUInt32 i = 0; i < 64; ++i)
+      {
+        ezSharedPtr<ezSpawningTestTask> pTask = EZ_DEFAULT_NEW(ezSpawningTestTask);
+        pTask->m_pCounter = &iExecuted;
+        pTask->m_uiNumChildTasks = 16;
+        ezTaskSystem::AddTaskToGroup(group, pTask);
+      }
+
+      ezTaskSystem::StartTaskGroup(group);
+      ezTaskSystem::WaitForGroup(group);
+
+      EZ_TEST_INT(iExecuted, 64 * 16);
+    }
+
+    // parallel for
+    {
+      ezDynamicArray<ezUInt32> values;
+      values.SetCount(10000);
+
+      ezParallelForParams params;
+      params.m_uiBinSize = 16;
+
+      ezTaskSystem::ParallelForSingleIndex(values.GetArrayPtr(), [](ezUInt32 uiIndex, ezUInt32& ref_uiValue)
+        { ref_uiValue = uiIndex; },
+        "WorkStealingParallelFor", params);
+
+      bool bAllCorrect = true;
+      for (ezUInt32 i = 0; i < values.GetCount(); ++i)
+      {
+        bAllCorrect &= (values[i] == i);
+      }
+
+      EZ_TEST_BOOL(bAllCorrect);
+    }
+
+    // dependencies and multiplicity
+    {
+      ezSharedPtr<ezTestTask> t[3];
+
+      for (ezUInt32 i = 0; i < 3; ++i)
+      {
+        t[i] = EZ_DEFAULT_NEW(ezTestTask);
+        t[i]->m_uiIterations = 5;
+        t[i]->SetMultiplicity(i * 100);
+      }
+
+      t[1]->m_pDependency = t[0].Borrow();
+      t[2]->m_pDependency = t[1].Borrow();
+
+      ezTaskGroupID g0 = ezTaskSystem::StartSingleTask(t[0], ezTaskPriority::EarlyThisFrame);
+      ezTaskGroupID g1 = ezTaskSystem::StartSingleTask(t[1], ezTaskPriority::ThisFrame, g0);
+      ezTaskGroupID g2 = ezTaskSystem::StartSingleTask(t[2], ezTaskPriority::LongRunning, g1);
+
+      ezTaskSystem::WaitForGroup(g2);
+
+      EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(g0));
+      EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(g1));
+      EZ_TEST_BOOL(t[0]->IsDone());
+      EZ_TEST_BOOL(t[1]->IsMultiplicityDone());
+      EZ_TEST_BOOL(t[2]->IsMultiplicityDone());
+    }
+
+    // canceling a group whose tasks may sit in local queues
+    {
+      ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::LongRunning);
+
+      ezSharedPtr<ezTestTask> t[8];
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(t); ++i)
+      {
+        t[i] = EZ_DEFAULT_NEW(ezTestTask);
+        t[i]->m_uiIterations = 50;
+        t[i]->m_bSupportCancel = true;
+        ezTaskSystem::AddTaskToGroup(group, t[i]);
+      }
+
+      ezTaskSystem::StartTaskGroup(group);
+      ezTaskSystem::CancelGroup(group, ezOnTaskRunning::WaitTillFinished).IgnoreResult();
+
+      EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(group));
+    }
+
+    ezTaskSystem::SetSchedulingMode(ezTaskSchedulingMode::GlobalQueue);
+    EZ_TEST_BOOL(ezTaskSystem::GetSchedulingMode() == ezTaskSchedulingMode::GlobalQueue);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Worker Thread Affinity")
+  {
+    const ezCpuTopology& topology = ezSystemInformation::Get().GetCpuTopology();
+    EZ_TEST_BOOL(topology.m_uiNumLogicalCpus >= 1);
+    EZ_TEST_BOOL(topology.m_uiNumPhysicalCores >= 1);
+    EZ_TEST_BOOL(topology.m_uiNumPhysicalCores <= topology.m_uiNumLogicalCpus);
+    EZ_TEST_BOOL(topology.m_uiNumNumaNodes >= 1);
+
+    for (ezTaskThreadAffinity::Enum affinity : {ezTaskThreadAffinity::PhysicalCore, ezTaskThreadAffinity::NumaNode, ezTaskThreadAffinity::None})
+    {
+      ezTaskSystem::SetWorkerThreadAffinity(affinity);
+      EZ_TEST_BOOL(ezTaskSystem::GetWorkerThreadAffinity() == affinity);
+
+      for (ezUInt32 i = 0; i < ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks); ++i)
+      {
+        EZ_TEST_BOOL(ezTaskSystem::GetWorkerThreadNumaNode(ezWorkerThreadType::ShortTasks, i) < topology.m_uiNumNumaNodes);
+      }
+
+      ezAtomicInteger32 iExecuted = 0;
+      ezTaskGroupID group = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+
+      for (ezUInt32 i = 0; i < 32; ++i)
+      {
+        ezSharedPtr<ezSpawningTestTask> pTask = EZ_DEFAULT_NEW(ezSpawningTestTask);
+        pTask->m_pCounter = &iExecuted;
+        pTask->m_uiNumChildTasks = 8;
+        ezTaskSystem::AddTaskToGroup(group, pTask);
+      }
+
+      ezTaskSystem::StartTaskGroup(group);
+      ezTaskSystem::WaitForGroup(group);
+      ezTaskSystem::FinishFrameTasks();
+
+      EZ_TEST_INT(iExecuted, 32 * 8);
+
+      for (ezUInt32 uiNode = 0; uiNode < topology.m_uiNumNumaNodes; ++uiNode)
+      {
+        EZ_TEST_BOOL(ezTaskSystem::GetNumaNodeUtilization(uiNode) >= 0.0);
+      }
+    }
+  }
+
   // capture profiling info for testing
   /*ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
 
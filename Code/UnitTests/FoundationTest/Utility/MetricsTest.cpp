@@ -0,0 +1,240 @@
+#include <FoundationTest/FoundationTestPCH.h>
+
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/JSONReader.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Utilities/Metrics.h>
+
+EZ_CREATE_SIMPLE_TEST(Utility, Metrics)
+{
+  const double bucketBounds[] = {1.0, 2.0, 4.0, 8.0};
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Register")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/Counter");
+    EZ_TEST_BOOL(counter.IsValid());
+
+    counter.Add(3);
+    ezMetrics::RegisterCounter("MetricsTest/Counter").Add(2);
+
+    ezMetricGauge gauge = ezMetrics::RegisterGauge("MetricsTest/Gauge");
+    EZ_TEST_BOOL(gauge.IsValid());
+
+    gauge.Set(10.0);
+    ezMetrics::RegisterGauge("MetricsTest/Gauge").Add(-2.5);
+    EZ_TEST_DOUBLE(gauge.Get(), 7.5, 0.0);
+
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("MetricsTest/Histogram", bucketBounds);
+    EZ_TEST_BOOL(histogram.IsValid());
+
+    ezMetricsSnapshot snapshot;
+    ezMetrics::TakeSnapshot(snapshot);
+
+    const ezMetricsSnapshot::Metric* pCounter = snapshot.FindMetric("MetricsTest/Counter");
+    if (EZ_TEST_BOOL(pCounter != nullptr))
+    {
+      EZ_TEST_BOOL(pCounter->m_Type == ezMetricType::Counter);
+      EZ_TEST_INT(pCounter->m_uiCount, 5);
+    }
+
+    const ezMetricsSnapshot::Metric* pGauge = snapshot.FindMetric("MetricsTest/Gauge");
+    if (EZ_TEST_BOOL(pGauge != nullptr))
+    {
+      EZ_TEST_BOOL(pGauge->m_Type == ezMetricType::Gauge);
+      EZ_TEST_DOUBLE(pGauge->m_fValue, 7.5, 0.0);
+    }
+
+    const ezMetricsSnapshot::Metric* pHistogram = snapshot.FindMetric("MetricsTest/Histogram");
+    if (EZ_TEST_BOOL(pHistogram != nullptr))
+    {
+      EZ_TEST_BOOL(pHistogram->m_Type == ezMetricType::Histogram);
+      EZ_TEST_INT(pHistogram->m_uiNumBuckets, 5);
+      EZ_TEST_INT(pHistogram->m_uiCount, 0);
+    }
+
+    EZ_TEST_BOOL(snapshot.FindMetric("MetricsTest/DoesNotExist") == nullptr);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Histogram")
+  {
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("MetricsTest/Histogram", bucketBounds);
+
+    // 10 samples in the first two buckets and in the overflow bucket, 20 in the third bucket, none in the fourth
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      histogram.AddSample(0.5);
+      histogram.AddSample(2.0);
+      histogram.AddSample(3.0);
+      histogram.AddSample(3.5);
+      histogram.AddSample(100.0);
+    }
+
+    ezMetricsSnapshot snapshot;
+    ezMetrics::TakeSnapshot(snapshot);
+
+    const ezMetricsSnapshot::Metric* pHistogram = snapshot.FindMetric("MetricsTest/Histogram");
+    if (EZ_TEST_BOOL(pHistogram != nullptr))
+    {
+      EZ_TEST_INT(pHistogram->m_uiCount, 50);
+      EZ_TEST_DOUBLE(pHistogram->m_fValue, 1090.0, 0.0001);
+      EZ_TEST_DOUBLE(snapshot.GetMean(*pHistogram), 21.8, 0.0001);
+
+      ezArrayPtr<const ezUInt64> counts = snapshot.GetBucketCounts(*pHistogram);
+      if (EZ_TEST_INT(counts.GetCount(), 5))
+      {
+        EZ_TEST_INT(counts[0], 10);
+        EZ_TEST_INT(counts[1], 10);
+        EZ_TEST_INT(counts[2], 20);
+        EZ_TEST_INT(counts[3], 0);
+        EZ_TEST_INT(counts[4], 10);
+      }
+
+      EZ_TEST_DOUBLE(snapshot.GetPercentile(*pHistogram, 0.0), 0.0, 0.0001);
+      EZ_TEST_DOUBLE(snapshot.GetPercentile(*pHistogram, 10.0), 0.5, 0.0001);
+      EZ_TEST_DOUBLE(snapshot.GetPercentile(*pHistogram, 20.0), 1.0, 0.0001);
+      EZ_TEST_DOUBLE(snapshot.GetPercentile(*pHistogram, 60.0), 3.0, 0.0001);
+      EZ_TEST_DOUBLE(snapshot.GetPercentile(*pHistogram, 80.0), 4.0, 0.0001);
+      EZ_TEST_DOUBLE(snapshot.GetPercentile(*pHistogram, 99.0), 8.0, 0.0001);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Multi-Threaded")
+  {
+    ezMetricCounter counter = ezMetrics::RegisterCounter("MetricsTest/ParallelCounter");
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("MetricsTest/ParallelHistogram", bucketBounds);
+
+    constexpr ezUInt32 uiNumItems = 100000;
+
+    ezParallelForParams params;
+    params.m_uiBinSize = 1000;
+
+    ezTaskSystem::ParallelForIndexed(
+      0u, uiNumItems, [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex)
+      {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          counter.Add();
+          histogram.AddSample(static_cast<double>(i % 10));
+        } },
+      "MetricsTest", params);
+
+    ezMetricsSnapshot snapshot;
+    ezMetrics::TakeSnapshot(snapshot);
+
+    const ezMetricsSnapshot::Metric* pCounter = snapshot.FindMetric("MetricsTest/ParallelCounter");
+    if (EZ_TEST_BOOL(pCounter != nullptr))
+    {
+      EZ_TEST_INT(pCounter->m_uiCount, uiNumItems);
+    }
+
+    const ezMetricsSnapshot::Metric* pHistogram = snapshot.FindMetric("MetricsTest/ParallelHistogram");
+    if (EZ_TEST_BOOL(pHistogram != nullptr))
+    {
+      EZ_TEST_INT(pHistogram->m_uiCount, uiNumItems);
+      EZ_TEST_DOUBLE(pHistogram->m_fValue, 4.5 * uiNumItems, 0.0001);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Serialize")
+  {
+    ezMetricsSnapshot snapshot;
+    ezMetrics::TakeSnapshot(snapshot);
+
+    ezDefaultMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+
+    snapshot.Serialize(writer);
+
+    ezMetricsSnapshot snapshot2;
+    EZ_TEST_BOOL(snapshot2.Deserialize(reader).Succeeded());
+
+    EZ_TEST_BOOL(snapshot2.m_Timestamp == snapshot.m_Timestamp);
+    EZ_TEST_INT(snapshot2.m_Metrics.GetCount(), snapshot.m_Metrics.GetCount());
+    EZ_TEST_BOOL(snapshot2.m_BucketCounts == snapshot.m_BucketCounts);
+    EZ_TEST_BOOL(snapshot2.m_BucketUpperBounds == snapshot.m_BucketUpperBounds);
+
+    for (ezUInt32 i = 0; i < ezMath::Min(snapshot.m_Metrics.GetCount(), snapshot2.m_Metrics.GetCount()); ++i)
+    {
+      EZ_TEST_BOOL(snapshot2.m_Metrics[i].m_sName == snapshot.m_Metrics[i].m_sName);
+      EZ_TEST_BOOL(snapshot2.m_Metrics[i].m_Type == snapshot.m_Metrics[i].m_Type);
+      EZ_TEST_INT(snapshot2.m_Metrics[i].m_uiCount, snapshot.m_Metrics[i].m_uiCount);
+      EZ_TEST_DOUBLE(snapshot2.m_Metrics[i].m_fValue, snapshot.m_Metrics[i].m_fValue, 0.0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ResetValues")
+  {
+    ezMetrics::ResetValues();
+
+    ezMetrics::RegisterCounter("MetricsTest/Counter").Add(1);
+
+    ezMetricsSnapshot snapshot;
+    ezMetrics::TakeSnapshot(snapshot);
+
+    EZ_TEST_INT(snapshot.FindMetric("MetricsTest/Counter")->m_uiCount, 1);
+    EZ_TEST_INT(snapshot.FindMetric("MetricsTest/ParallelCounter")->m_uiCount, 0);
+    EZ_TEST_INT(snapshot.FindMetric("MetricsTest/Histogram")->m_uiCount, 0);
+    EZ_TEST_DOUBLE(snapshot.FindMetric("MetricsTest/ParallelHistogram")->m_fValue, 0.0, 0.0);
+    EZ_TEST_DOUBLE(snapshot.FindMetric("MetricsTest/Gauge")->m_fValue, 0.0, 0.0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "File Export")
+  {
+    if (ezFileSystem::FindDataDirectoryWithRoot("output") == nullptr)
+    {
+      ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+      EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(outputPath.GetData(), "test", "output", ezFileSystem::AllowWrites) == EZ_SUCCESS);
+    }
+
+    ezMetricHistogram histogram = ezMetrics::RegisterHistogram("MetricsTest/Histogram", bucketBounds);
+    histogram.AddSample(3.0);
+
+    ezMetricsFileWriter fileWriter;
+    EZ_TEST_BOOL(fileWriter.Open(":output/Metrics.jsonl").Succeeded());
+
+    ezMetricsSnapshot snapshot;
+    ezMetrics::TakeSnapshot(snapshot);
+    EZ_TEST_BOOL(fileWriter.WriteSnapshot(snapshot).Succeeded());
+    EZ_TEST_BOOL(fileWriter.WriteSnapshot(snapshot).Succeeded());
+    fileWriter.Close();
+
+    ezFileReader fileReader;
+    if (EZ_TEST_BOOL(fileReader.Open(":output/Metrics.jsonl").Succeeded()))
+    {
+      ezStringBuilder sContent;
+      sContent.ReadAll(fileReader);
+
+      ezDynamicArray<ezStringView> lines;
+      sContent.Split(false, lines, "\n");
+      EZ_TEST_INT(lines.GetCount(), 2);
+
+      for (ezStringView sLine : lines)
+      {
+        ezRawMemoryStreamReader lineReader(sLine.GetStartPointer(), sLine.GetElementCount());
+
+        ezJSONReader json;
+        if (!EZ_TEST_BOOL(json.Parse(lineReader).Succeeded()))
+          continue;
+
+        const ezVariant* pHistograms = json.GetTopLevelObject().GetValue("Histograms");
+        if (!EZ_TEST_BOOL(pHistograms != nullptr && pHistograms->IsA<ezVariantDictionary>()))
+          continue;
+
+        const ezVariant* pData = pHistograms->Get<ezVariantDictionary>().GetValue("MetricsTest/Histogram");
+        if (!EZ_TEST_BOOL(pData != nullptr && pData->IsA<ezVariantDictionary>()))
+          continue;
+
+        const ezVariantDictionary& data = pData->Get<ezVariantDictionary>();
+        EZ_TEST_INT(data.GetValue("Count")->ConvertTo<ezUInt64>(), 1);
+        EZ_TEST_DOUBLE(data.GetValue("P50")->ConvertTo<double>(), 3.0, 0.0001);
+        EZ_TEST_INT(data.GetValue("Buckets")->Get<ezVariantArray>().GetCount(), 5);
+        EZ_TEST_INT(data.GetValue("UpperBounds")->Get<ezVariantArray>().GetCount(), 4);
+      }
+    }
+
+    ezFileSystem::DeleteFile(":output/Metrics.jsonl");
+  }
+}